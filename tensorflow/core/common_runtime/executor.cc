@@ -17,7 +17,9 @@ limitations under the License.
 
 #include <algorithm>
 #include <atomic>
+#include <deque>
 #include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -64,6 +66,7 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/manual_constructor.h"
 #include "tensorflow/core/lib/hash/hash.h"
 #include "tensorflow/core/platform/context.h"
+#include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/logging.h"
@@ -177,9 +180,133 @@ struct KernelTimer {
 typedef absl::InlinedVector<TensorValue, 4UL> TensorValueVec;
 typedef absl::InlinedVector<AllocatorAttributes, 4UL> AllocatorAttributeVec;
 
+// The ready queues of a step in the work-stealing scheduling mode, one per
+// worker. A worker pushes and pops items at the back of its own deque, and
+// steals from the front of the other deques when its own is empty.
+//
+// Queued items are outstanding ops of the step, so the step is alive while any
+// item is queued. Workers share ownership of the queues with the step, so that
+// after the last item of a step has been processed they can find the queues
+// empty and exit without touching the step.
+template <typename T>
+class WorkStealingQueues {
+ public:
+  explicit WorkStealingQueues(int num_queues) : queues_(num_queues) {}
+
+  // The maximum number of workers.
+  int num_queues() const { return queues_.size(); }
+
+  // The number of queued items. Items being pushed may not be counted yet.
+  int64_t size() const { return size_.load(); }
+
+  int num_workers() const { return num_workers_.load(); }
+
+  void Push(int queue, T item) {
+    Queue& q = queues_[queue];
+    {
+      mutex_lock l(q.mu);
+      q.items.push_back(std::move(item));
+    }
+    size_.fetch_add(1);
+  }
+
+  // Pops an item from the back of `queue`, or steals one from the front of
+  // another queue if `queue` is empty.
+  std::optional<T> Pop(int queue) {
+    if (size_.load() <= 0) {
+      return std::nullopt;
+    }
+    for (int i = 0; i < queues_.size(); ++i) {
+      Queue& q = queues_[(queue + i) % queues_.size()];
+      mutex_lock l(q.mu);
+      if (q.items.empty()) {
+        continue;
+      }
+      std::optional<T> item;
+      if (i == 0) {
+        item.emplace(std::move(q.items.back()));
+        q.items.pop_back();
+      } else {
+        item.emplace(std::move(q.items.front()));
+        q.items.pop_front();
+      }
+      size_.fetch_sub(1);
+      return item;
+    }
+    return std::nullopt;
+  }
+
+  // Returns a queue to push to from a thread that is not a worker.
+  int NextQueue() {
+    return next_queue_.fetch_add(1, std::memory_order_relaxed) %
+           queues_.size();
+  }
+
+  // Registers a new worker unless there are num_queues() workers already.
+  // Returns the queue of the new worker, or -1.
+  int TryAddWorker() {
+    int n = num_workers_.load();
+    while (n < queues_.size()) {
+      if (num_workers_.compare_exchange_weak(n, n + 1)) {
+        return NextQueue();
+      }
+    }
+    return -1;
+  }
+
+  // Unregisters a worker that found all queues empty. Returns false if items
+  // were pushed concurrently and the worker must keep running.
+  //
+  // Pushers increment size() before reading num_workers(), and workers
+  // decrement num_workers() before reading size(), so either the pusher adds a
+  // worker or the exiting worker sees the item.
+  bool RemoveWorker() {
+    num_workers_.fetch_sub(1);
+    if (size_.load() > 0) {
+      int n = num_workers_.load();
+      while (n < queues_.size()) {
+        if (num_workers_.compare_exchange_weak(n, n + 1)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+ private:
+  struct Queue {
+    mutex mu;
+    std::deque<T> items TF_GUARDED_BY(mu);
+  };
+
+  std::vector<Queue> queues_;
+  std::atomic<int64_t> size_{0};
+  std::atomic<int> num_workers_{0};
+  std::atomic<uint32_t> next_queue_{0};
+};
+
+// The work-stealing queues and queue index of the worker running on the
+// current thread, if any.
+struct WorkStealingWorker {
+  const void* queues = nullptr;
+  int queue = 0;
+};
+
+WorkStealingWorker& CurrentWorkStealingWorker() {
+  static thread_local WorkStealingWorker worker;
+  return worker;
+}
+
 class ExecutorImpl : public Executor {
  public:
-  explicit ExecutorImpl(const LocalExecutorParams& p) : immutable_state_(p) {}
+  // If `work_stealing` is true, steps schedule ready nodes on per-worker
+  // deques instead of dispatching each expensive node to the runner. See
+  // `ExecutorState::ScheduleReadyWorkStealing()`.
+  explicit ExecutorImpl(const LocalExecutorParams& p,
+                        bool work_stealing = false)
+      : immutable_state_(p),
+        num_work_stealing_workers_(work_stealing ? port::MaxParallelism()
+                                                 : 0) {}
 
   absl::Status Initialize(const Graph& graph) {
     TF_RETURN_IF_ERROR(immutable_state_.Initialize(graph));
@@ -225,6 +352,14 @@ class ExecutorImpl : public Executor {
       return is_expensive_[node.node_id];
     }
 
+    // Returns the estimated cost of the given node in CPU cycles. The cost of
+    // kernels without the expensive marker is not tracked and returns 0.
+    uint64_t CostEstimate(const NodeItem& node) const {
+      return is_expensive_[node.node_id]
+                 ? cost_estimates_[node.node_id].load(std::memory_order_relaxed)
+                 : 0;
+    }
+
     // Updates the dynamic cost estimate, which is used to determine whether the
     // given node is expensive. The new cost estimate is a weighted average of
     // the old cost estimate and the latest cost. We only update cost estimates
@@ -262,6 +397,9 @@ class ExecutorImpl : public Executor {
 
   ImmutableExecutorState immutable_state_;
   KernelStats kernel_stats_;
+  // The maximum number of workers per step in the work-stealing mode, or 0 if
+  // the mode is disabled.
+  const int num_work_stealing_workers_;
 
   ExecutorImpl(const ExecutorImpl&) = delete;
   void operator=(const ExecutorImpl&) = delete;
@@ -321,7 +459,8 @@ class ExecutorState {
  public:
   ExecutorState(const Executor::Args& args,
                 const ImmutableExecutorState& immutable_state_,
-                ExecutorImpl::KernelStats* kernel_stats_);
+                ExecutorImpl::KernelStats* kernel_stats_,
+                int num_work_stealing_workers = 0);
   ~ExecutorState();
 
   void RunAsync(Executor::DoneCallback done);
@@ -378,6 +517,30 @@ class ExecutorState {
   // REQUIRES: `!ready->empty()`.
   void ScheduleReady(TaggedNodeSeq* ready, TaggedNodeReadyQueue* inline_ready);
 
+  // ScheduleReady() in the work-stealing mode. Nodes that are dead or cheap
+  // according to their cost estimate are put into 'inline_ready', as are
+  // moderately expensive nodes when every worker has enough queued nodes
+  // already. The other nodes are pushed to the queue of the current worker,
+  // and new workers are started while there are more queued nodes than
+  // workers.
+  void ScheduleReadyWorkStealing(TaggedNodeSeq* ready,
+                                 TaggedNodeReadyQueue* inline_ready,
+                                 int64_t scheduled_nsec);
+
+  // A node queued in the work-stealing mode.
+  struct WorkItem {
+    ExecutorState* state;
+    TaggedNode node;
+    int64_t scheduled_nsec;
+  };
+  typedef WorkStealingQueues<WorkItem> WorkQueues;
+
+  // Processes queued nodes until all queues are empty. Only accesses the step
+  // through the items it pops, since the step may be deleted once its last
+  // node has been processed.
+  static void RunWorkStealingWorker(std::shared_ptr<WorkQueues> queues,
+                                    int queue);
+
   // A wrapper for runner_ to keep track of the pending queue length. Op
   // execution should dispatch work using this function instead of using runner_
   // directly.
@@ -408,6 +571,12 @@ class ExecutorState {
   // TODO(fishx): Make it configurable if necessary.
   static constexpr uint64_t kInlineScheduleReadyThreshold = 500;
 
+  // In the work-stealing mode, nodes estimated to be cheaper than this many
+  // cycles run inline instead of being queued once every worker has
+  // `kWorkStealingQueuedNodesPerWorker` queued nodes.
+  static constexpr uint64_t kWorkStealingInlineCostCycles = 200 * 1000;
+  static constexpr int64_t kWorkStealingQueuedNodesPerWorker = 4;
+
   // Not owned.
   RendezvousInterface* rendezvous_;
   CollectiveExecutor* collective_executor_ = nullptr;
@@ -437,6 +606,9 @@ class ExecutorState {
   bool sync_on_finish_;
   const bool run_all_kernels_inline_;
 
+  // Non-null in the work-stealing mode.
+  std::shared_ptr<WorkQueues> work_queues_;
+
   PropagatorStateType propagator_;
 
   // Invoked when the execution finishes.
@@ -457,7 +629,7 @@ class ExecutorState {
 template <class PropagatorStateType>
 ExecutorState<PropagatorStateType>::ExecutorState(
     const Executor::Args& args, const ImmutableExecutorState& immutable_state,
-    ExecutorImpl::KernelStats* kernel_stats)
+    ExecutorImpl::KernelStats* kernel_stats, int num_work_stealing_workers)
     : vlog_(VLOG_IS_ON(1)),
       log_memory_(LogMemory::IsEnabled()),
       step_id_(args.step_id),
@@ -493,6 +665,9 @@ ExecutorState<PropagatorStateType>::ExecutorState(
     user_device_ = RenamedDevice::NewRenamedDevice(
         device->name(), device, false, false, args.user_intra_op_threadpool);
   }
+  if (num_work_stealing_workers > 0 && !run_all_kernels_inline_) {
+    work_queues_ = std::make_shared<WorkQueues>(num_work_stealing_workers);
+  }
 }
 
 template <class PropagatorStateType>
@@ -1320,7 +1495,9 @@ void ExecutorState<PropagatorStateType>::ScheduleReady(
     scheduled_nsec = nodestats::NowInNsec();
   }
 
-  if (run_all_kernels_inline_) {
+  if (work_queues_ != nullptr) {
+    ScheduleReadyWorkStealing(ready, inline_ready, scheduled_nsec);
+  } else if (run_all_kernels_inline_) {
     if (inline_ready == nullptr) {
       // Schedule all ready kernels from a single closure. This ensure that,
       // regardless of the `runner_` implementation, all kernels will run
@@ -1413,6 +1590,77 @@ void ExecutorState<PropagatorStateType>::ScheduleReady(
   ready->clear();
 }
 
+template <class PropagatorStateType>
+void ExecutorState<PropagatorStateType>::ScheduleReadyWorkStealing(
+    TaggedNodeSeq* ready, TaggedNodeReadyQueue* inline_ready,
+    int64_t scheduled_nsec) {
+  WorkQueues& queues = *work_queues_;
+  const WorkStealingWorker& worker = CurrentWorkStealingWorker();
+  const int queue =
+      worker.queues == &queues ? worker.queue : queues.NextQueue();
+  // Queueing more nodes when every worker has enough to do only adds
+  // overhead for nodes that take about as long as the queue operations.
+  const bool queues_are_full =
+      queues.size() >= static_cast<int64_t>(queues.num_queues()) *
+                           kWorkStealingQueuedNodesPerWorker;
+
+  int64_t num_pushed = 0;
+  for (auto& tagged_node : *ready) {
+    if (inline_ready != nullptr) {
+      const NodeItem& item = *tagged_node.node_item;
+      const uint64_t cost = kernel_stats_->CostEstimate(item);
+      if (tagged_node.get_is_dead() || !kernel_stats_->IsExpensive(item) ||
+          (queues_are_full && cost < kWorkStealingInlineCostCycles)) {
+        inline_ready->push_back(tagged_node);
+        continue;
+      }
+      if (inline_ready->empty()) {
+        // Keep one expensive node on this thread, its inputs are likely hot in
+        // the cache.
+        inline_ready->push_back(tagged_node);
+        continue;
+      }
+    }
+    queues.Push(queue, WorkItem{this, tagged_node, scheduled_nsec});
+    ++num_pushed;
+  }
+  if (num_pushed == 0) {
+    return;
+  }
+
+  // Start a worker for every queued node that the running workers are not
+  // expected to pick up soon. A worker processes its own queue first, so the
+  // current worker accounts for the nodes it just pushed.
+  while (queues.num_workers() < queues.size()) {
+    const int new_queue = queues.TryAddWorker();
+    if (new_queue < 0) {
+      break;
+    }
+    RunTask(
+        [queues = work_queues_, new_queue]() {
+          RunWorkStealingWorker(queues, new_queue);
+        },
+        /*sample_rate=*/static_cast<int>(num_pushed));
+  }
+}
+
+template <class PropagatorStateType>
+void ExecutorState<PropagatorStateType>::RunWorkStealingWorker(
+    std::shared_ptr<WorkQueues> queues, int queue) {
+  tsl::profiler::TraceMe activity("ExecutorState::RunWorkStealingWorker",
+                                  tsl::profiler::GetTFTraceMeLevel(
+                                      /*is_expensive=*/false));
+  WorkStealingWorker& worker = CurrentWorkStealingWorker();
+  const WorkStealingWorker saved_worker = worker;
+  worker = WorkStealingWorker{queues.get(), queue};
+  do {
+    while (std::optional<WorkItem> item = queues->Pop(queue)) {
+      item->state->Process(item->node, item->scheduled_nsec);
+    }
+  } while (!queues->RemoveWorker());
+  worker = saved_worker;
+}
+
 template <class PropagatorStateType>
 void ExecutorState<PropagatorStateType>::ScheduleFinish() {
   // Checks condition to decide if needs to invoke Finish(). If there are
@@ -1556,11 +1804,13 @@ void ExecutorImpl::RunAsyncInternal(const Args& args, DoneCallback done) {
                                                &kernel_stats_))
         ->RunAsync(std::move(done));
   } else if (immutable_state_.requires_control_flow_support()) {
-    (new ExecutorState<PropagatorState>(args, immutable_state_, &kernel_stats_))
+    (new ExecutorState<PropagatorState>(args, immutable_state_, &kernel_stats_,
+                                        num_work_stealing_workers_))
         ->RunAsync(std::move(done));
   } else {
     (new ExecutorState<SimplePropagatorState>(args, immutable_state_,
-                                              &kernel_stats_))
+                                              &kernel_stats_,
+                                              num_work_stealing_workers_))
         ->RunAsync(std::move(done));
   }
 }
@@ -1616,6 +1866,30 @@ class DefaultExecutorRegistrar {
 };
 static DefaultExecutorRegistrar registrar;
 
+// Registers the executor with the work-stealing scheduling mode. It runs the
+// same graphs as the default executor, and can be selected with the
+// "WORK_STEALING" executor type.
+class WorkStealingExecutorRegistrar {
+ public:
+  WorkStealingExecutorRegistrar() {
+    ExecutorFactory::Register("WORK_STEALING", new Factory);
+  }
+
+ private:
+  class Factory : public ExecutorFactory {
+    absl::Status NewExecutor(const LocalExecutorParams& params,
+                             const Graph& graph,
+                             std::unique_ptr<Executor>* out_executor) override {
+      auto impl = std::make_unique<ExecutorImpl>(params,
+                                                 /*work_stealing=*/true);
+      TF_RETURN_IF_ERROR(impl->Initialize(graph));
+      *out_executor = std::move(impl);
+      return absl::OkStatus();
+    }
+  };
+};
+static WorkStealingExecutorRegistrar work_stealing_registrar;
+
 }  // namespace
 
 }  // namespace tensorflow
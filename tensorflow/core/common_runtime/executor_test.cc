@@ -25,6 +25,7 @@ limitations under the License.
 #include "tensorflow/cc/ops/standard_ops.h"
 #include "tensorflow/core/common_runtime/device.h"
 #include "tensorflow/core/common_runtime/device_factory.h"
+#include "tensorflow/core/common_runtime/executor_factory.h"
 #include "tensorflow/core/common_runtime/graph_constructor.h"
 #include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
 #include "tensorflow/core/common_runtime/lower_functional_ops.h"
@@ -76,8 +77,10 @@ class ExecutorTest : public ::testing::Test {
     delete exec_;
   }
 
-  // Resets executor_ with a new executor based on a graph 'gdef'.
-  void Create(std::unique_ptr<const Graph> graph) {
+  // Resets executor_ with a new executor based on a graph 'gdef'. Uses the
+  // default executor if 'executor_type' is empty.
+  void Create(std::unique_ptr<const Graph> graph,
+              const std::string& executor_type = "") {
     const int version = graph->versions().producer();
     LocalExecutorParams params;
     params.device = device_.get();
@@ -92,7 +95,13 @@ class ExecutorTest : public ::testing::Test {
     };
     rendez_ = NewLocalRendezvous();
     delete exec_;
-    TF_CHECK_OK(NewLocalExecutor(params, *graph, &exec_));
+    if (executor_type.empty()) {
+      TF_CHECK_OK(NewLocalExecutor(params, *graph, &exec_));
+    } else {
+      std::unique_ptr<Executor> executor;
+      TF_CHECK_OK(NewExecutor(executor_type, params, *graph, &executor));
+      exec_ = executor.release();
+    }
     runner_ = [this](std::function<void()> fn) { thread_pool_->Schedule(fn); };
   }
 
@@ -324,6 +333,21 @@ TEST_F(ExecutorTest, RandomTree) {
   EXPECT_EQ(4096.0, V(out));
 }
 
+TEST_F(ExecutorTest, RandomTreeWorkStealing) {
+  auto g = std::make_unique<Graph>(OpRegistry::Global());
+  BuildTree(4096, g.get());
+  Create(std::move(g), "WORK_STEALING");
+  Rendezvous::Args args;
+  TF_ASSERT_OK(
+      rendez_->Send(Key(ALICE, kIncarnation, BOB, "a"), args, V(1.0), false));
+  TF_ASSERT_OK(Run(rendez_));
+  Tensor out = V(-1);
+  bool is_dead = false;
+  TF_ASSERT_OK(
+      rendez_->Recv(Key(BOB, kIncarnation, ALICE, "b"), args, &out, &is_dead));
+  EXPECT_EQ(4096.0, V(out));
+}
+
 void BuildConcurrentAddAssign(Graph* g) {
   auto one = test::graph::Constant(g, V(1.0));
   // A variable holds one float.
@@ -552,6 +576,59 @@ BENCHMARK(BM_executor)->UseRealTime()->ArgPair(8192, 32);
 // Tall fat graph
 BENCHMARK(BM_executor)->UseRealTime()->ArgPair(1024, 1024);
 
+// Create a graph of 'width' chains of 'depth' additions of 1024-float tensors,
+// where each addition also reads the previous node of the neighboring chain.
+// The additions are too cheap to be worth a closure each but too expensive to
+// run all ready ones on one thread. Runs it with the default executor, or the
+// work-stealing executor if 'work_stealing' is set.
+static void BM_executor_scheduling(::testing::benchmark::State& state) {
+  const int width = state.range(0);
+  const int depth = state.range(1);
+  const bool work_stealing = state.range(2);
+
+  Graph* g = new Graph(OpRegistry::Global());
+  Tensor value(DT_FLOAT, TensorShape({1024}));
+  value.flat<float>().setConstant(1.0);
+  std::vector<Node*> layer;
+  for (int j = 0; j < width; ++j) {
+    layer.push_back(test::graph::Constant(g, value));
+  }
+  for (int i = 0; i < depth; ++i) {
+    std::vector<Node*> next_layer;
+    for (int j = 0; j < width; ++j) {
+      next_layer.push_back(
+          test::graph::Add(g, layer[j], layer[(j + 1) % width]));
+    }
+    layer = std::move(next_layer);
+  }
+
+  FixupSourceAndSinkEdges(g);
+  test::Benchmark("cpu", g, /*options=*/nullptr, /*init=*/nullptr,
+                  /*rendez=*/nullptr, work_stealing ? "WORK_STEALING" : "",
+                  /*old_benchmark_api=*/false)
+      .Run(state);
+
+  state.SetLabel(work_stealing ? "work_stealing" : "default");
+  state.SetItemsProcessed(static_cast<int64_t>(width) * depth *
+                          state.iterations());
+}
+
+// Wide graphs
+BENCHMARK(BM_executor_scheduling)
+    ->UseRealTime()
+    ->Args({256, 16, false})
+    ->Args({256, 16, true})
+    ->Args({4096, 4, false})
+    ->Args({4096, 4, true});
+
+// Deep graphs
+BENCHMARK(BM_executor_scheduling)
+    ->UseRealTime()
+    ->Args({4, 1024, false})
+    ->Args({4, 1024, true})
+    ->Args({16, 256, false})
+    ->Args({16, 256, true});
+
 static void BM_const_identity(::testing::benchmark::State& state) {
   const int width = state.range(0);
   const int outputs_per_const = state.range(1);
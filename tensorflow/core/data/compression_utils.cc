@@ -14,28 +14,41 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/data/compression_utils.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <limits>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "absl/log/log.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
 #include "tensorflow/core/common_runtime/dma_helper.h"
 #include "tensorflow/core/framework/dataset.pb.h"
+#include "tensorflow/core/framework/metrics.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/framework/variant_op_registry.h"
+#include "tensorflow/core/platform/env_time.h"
+#include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/snappy.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/tstring.h"
 #include "tensorflow/core/platform/types.h"
 
+// NOTE: The way zstd is packaged in TF, we cannot include it as <zstd.h>.
+#include "zstd.h"  // NOLINT(build/include)
+
 namespace tensorflow {
 namespace data {
 namespace {
@@ -43,7 +56,24 @@ namespace {
 // Increment this when making changes to the `CompressedElement` proto. The
 // `UncompressElement` function will determine what to read according to the
 // version.
-constexpr int kCompressedElementVersion = 0;
+constexpr int kCompressedElementVersion = 1;
+
+// Snappy compressed elements without uncompressed components don't use any
+// field added in version 1, and are still written as version 0 so that older
+// binaries can read them.
+constexpr int kSnappyOnlyCompressedElementVersion = 0;
+
+// Adaptive compression only estimates the compressibility of components of at
+// least this size. Smaller components are always compressed.
+constexpr size_t kMinAdaptiveComponentBytes = 64 * 1024;
+
+// The number of bytes of a component compressed to estimate its
+// compressibility.
+constexpr size_t kAdaptiveSampleBytes = 16 * 1024;
+
+// Components whose sample doesn't shrink by at least this factor are stored
+// uncompressed.
+constexpr double kMinAdaptiveCompressionRatio = 1.1;
 
 }  // namespace
 
@@ -62,7 +92,7 @@ class Iov {
 
   size_t NumBytes() const { return num_bytes_; }
 
-  size_t NumPieces() const { return iov_.size(); }
+  size_t NumPieces() const { return idx_; }
 
  private:
   std::vector<struct iovec> iov_;
@@ -70,8 +100,351 @@ class Iov {
   size_t num_bytes_;
 };
 
+namespace {
+
+absl::Status SnappyCompress(Iov& iov, std::string* out) {
+  if (iov.NumBytes() > std::numeric_limits<uint32_t>::max()) {
+    return absl::OutOfRangeError(
+        absl::StrCat("Encountered dataset element of size ", iov.NumBytes(),
+                     ", exceeding the 4GB Snappy limit."));
+  }
+  if (!port::Snappy_CompressFromIOVec(iov.Data(), iov.NumBytes(), out)) {
+    return absl::InternalError("Failed to compress using snappy.");
+  }
+  return absl::OkStatus();
+}
+
+absl::Status SnappyUncompress(absl::string_view data, Iov& iov) {
+  size_t uncompressed_size;
+  if (!port::Snappy_GetUncompressedLength(data.data(), data.size(),
+                                          &uncompressed_size)) {
+    return absl::InternalError(absl::StrCat(
+        "Could not get snappy uncompressed length. Compressed data size: ",
+        data.size()));
+  }
+  if (uncompressed_size != iov.NumBytes()) {
+    return absl::InternalError(absl::StrCat(
+        "Uncompressed size mismatch. Snappy expects ", uncompressed_size,
+        " whereas the tensor metadata suggests ", iov.NumBytes()));
+  }
+  if (!port::Snappy_UncompressToIOVec(data.data(), data.size(), iov.Data(),
+                                      iov.NumPieces())) {
+    return absl::InternalError("Failed to perform snappy decompression.");
+  }
+  return absl::OkStatus();
+}
+
+void CopyFromIov(Iov& iov, std::string* out) {
+  out->resize(iov.NumBytes());
+  char* pos = out->data();
+  for (size_t i = 0; i < iov.NumPieces(); ++i) {
+    const iovec& piece = iov.Data()[i];
+    if (piece.iov_len > 0) {
+      std::memcpy(pos, piece.iov_base, piece.iov_len);
+      pos += piece.iov_len;
+    }
+  }
+}
+
+absl::Status CopyToIov(absl::string_view data, Iov& iov) {
+  if (data.size() != iov.NumBytes()) {
+    return absl::InternalError(absl::StrCat(
+        "Uncompressed size mismatch. The element contains ", data.size(),
+        " uncompressed bytes whereas the tensor metadata suggests ",
+        iov.NumBytes()));
+  }
+  const char* pos = data.data();
+  for (size_t i = 0; i < iov.NumPieces(); ++i) {
+    const iovec& piece = iov.Data()[i];
+    if (piece.iov_len > 0) {
+      std::memcpy(piece.iov_base, pos, piece.iov_len);
+      pos += piece.iov_len;
+    }
+  }
+  return absl::OkStatus();
+}
+
+// zstd contexts are expensive to create, so each thread reuses its own.
+ZSTD_CCtx* ZstdCompressionContext() {
+  thread_local std::unique_ptr<ZSTD_CCtx, size_t (*)(ZSTD_CCtx*)> ctx(
+      ZSTD_createCCtx(), ZSTD_freeCCtx);
+  return ctx.get();
+}
+
+ZSTD_DCtx* ZstdDecompressionContext() {
+  thread_local std::unique_ptr<ZSTD_DCtx, size_t (*)(ZSTD_DCtx*)> ctx(
+      ZSTD_createDCtx(), ZSTD_freeDCtx);
+  return ctx.get();
+}
+
+absl::Status ZstdError(absl::string_view operation, size_t code) {
+  return absl::InternalError(absl::StrCat("Failed to perform zstd ", operation,
+                                          ": ", ZSTD_getErrorName(code)));
+}
+
+absl::Status ZstdCompress(Iov& iov, int level, std::string* out) {
+  ZSTD_CCtx* ctx = ZstdCompressionContext();
+  ZSTD_CCtx_reset(ctx, ZSTD_reset_session_and_parameters);
+  size_t result = ZSTD_CCtx_setParameter(ctx, ZSTD_c_compressionLevel, level);
+  if (ZSTD_isError(result)) {
+    return ZstdError("compression", result);
+  }
+  // Records the uncompressed size in the frame header.
+  result = ZSTD_CCtx_setPledgedSrcSize(ctx, iov.NumBytes());
+  if (ZSTD_isError(result)) {
+    return ZstdError("compression", result);
+  }
+
+  out->resize(ZSTD_compressBound(iov.NumBytes()));
+  ZSTD_outBuffer output = {out->data(), out->size(), 0};
+  for (size_t i = 0; i < iov.NumPieces(); ++i) {
+    ZSTD_inBuffer input = {iov.Data()[i].iov_base, iov.Data()[i].iov_len, 0};
+    while (input.pos < input.size) {
+      result = ZSTD_compressStream2(ctx, &output, &input, ZSTD_e_continue);
+      if (ZSTD_isError(result)) {
+        return ZstdError("compression", result);
+      }
+      if (output.pos == output.size && input.pos < input.size) {
+        return absl::InternalError("zstd compression output buffer is full.");
+      }
+    }
+  }
+  ZSTD_inBuffer end = {nullptr, 0, 0};
+  do {
+    result = ZSTD_compressStream2(ctx, &output, &end, ZSTD_e_end);
+    if (ZSTD_isError(result)) {
+      return ZstdError("compression", result);
+    }
+    if (output.pos == output.size && result != 0) {
+      return absl::InternalError("zstd compression output buffer is full.");
+    }
+  } while (result != 0);
+  out->resize(output.pos);
+  return absl::OkStatus();
+}
+
+absl::Status ZstdUncompress(absl::string_view data, Iov& iov) {
+  const uint64_t uncompressed_size =
+      ZSTD_getFrameContentSize(data.data(), data.size());
+  if (uncompressed_size == ZSTD_CONTENTSIZE_ERROR ||
+      uncompressed_size == ZSTD_CONTENTSIZE_UNKNOWN) {
+    return absl::InternalError(absl::StrCat(
+        "Could not get zstd uncompressed length. Compressed data size: ",
+        data.size()));
+  }
+  if (uncompressed_size != iov.NumBytes()) {
+    return absl::InternalError(absl::StrCat(
+        "Uncompressed size mismatch. zstd expects ", uncompressed_size,
+        " whereas the tensor metadata suggests ", iov.NumBytes()));
+  }
+
+  ZSTD_DCtx* ctx = ZstdDecompressionContext();
+  ZSTD_DCtx_reset(ctx, ZSTD_reset_session_only);
+  ZSTD_inBuffer input = {data.data(), data.size(), 0};
+  // Non-zero until the end of the frame has been decoded.
+  size_t result = 1;
+  for (size_t i = 0; i < iov.NumPieces(); ++i) {
+    ZSTD_outBuffer output = {iov.Data()[i].iov_base, iov.Data()[i].iov_len, 0};
+    while (output.pos < output.size) {
+      const size_t input_pos = input.pos;
+      const size_t output_pos = output.pos;
+      result = ZSTD_decompressStream(ctx, &output, &input);
+      if (ZSTD_isError(result)) {
+        return ZstdError("decompression", result);
+      }
+      if (input.pos == input_pos && output.pos == output_pos) {
+        return absl::InternalError("Truncated zstd compressed data.");
+      }
+    }
+  }
+  ZSTD_outBuffer end = {nullptr, 0, 0};
+  while (result != 0) {
+    const size_t input_pos = input.pos;
+    result = ZSTD_decompressStream(ctx, &end, &input);
+    if (ZSTD_isError(result)) {
+      return ZstdError("decompression", result);
+    }
+    if (result != 0 && input.pos == input_pos) {
+      return absl::InternalError("Truncated zstd compressed data.");
+    }
+  }
+  if (input.pos != input.size) {
+    return absl::InternalError(
+        absl::StrCat("Found ", input.size - input.pos,
+                     " unexpected bytes after the zstd compressed data."));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status CompressIov(const CompressionOptions& options, Iov& iov,
+                         std::string* out) {
+  switch (options.codec) {
+    case COMPRESSION_CODEC_SNAPPY:
+      return SnappyCompress(iov, out);
+    case COMPRESSION_CODEC_NONE:
+      CopyFromIov(iov, out);
+      return absl::OkStatus();
+    case COMPRESSION_CODEC_ZSTD:
+      return ZstdCompress(iov, options.level, out);
+    default:
+      return absl::InvalidArgumentError(
+          absl::StrCat("Unsupported compression codec: ", options.codec));
+  }
+}
+
+absl::Status UncompressIov(CompressionCodec codec, absl::string_view data,
+                           Iov& iov) {
+  switch (codec) {
+    case COMPRESSION_CODEC_SNAPPY:
+      return SnappyUncompress(data, iov);
+    case COMPRESSION_CODEC_NONE:
+      return CopyToIov(data, iov);
+    case COMPRESSION_CODEC_ZSTD:
+      return ZstdUncompress(data, iov);
+    default:
+      return absl::InternalError(
+          absl::StrCat("Unsupported compression codec: ", codec));
+  }
+}
+
+// Returns up to `max_bytes` from the middle of `data`, which skips headers
+// that tend to compress better than the rest of the data.
+absl::string_view MiddleSample(absl::string_view data, size_t max_bytes) {
+  if (data.size() <= max_bytes) {
+    return data;
+  }
+  return data.substr((data.size() - max_bytes) / 2, max_bytes);
+}
+
+// Returns true if compressing `sample` with `options` doesn't shrink it by at
+// least `kMinAdaptiveCompressionRatio`.
+bool IsIncompressible(const CompressionOptions& options,
+                      absl::string_view sample) {
+  Iov iov(1);
+  iov.Add(const_cast<char*>(sample.data()), sample.size());
+  std::string compressed;
+  if (!CompressIov(options, iov, &compressed).ok()) {
+    return false;
+  }
+  return compressed.size() * kMinAdaptiveCompressionRatio > sample.size();
+}
+
+bool ShouldStoreUncompressed(const CompressionOptions& options,
+                             const TensorBuffer& buffer) {
+  if (!options.adaptive || options.codec == COMPRESSION_CODEC_NONE ||
+      buffer.size() < kMinAdaptiveComponentBytes) {
+    return false;
+  }
+  return IsIncompressible(
+      options, MiddleSample(absl::string_view(static_cast<const char*>(
+                                                  buffer.data()),
+                                              buffer.size()),
+                            kAdaptiveSampleBytes));
+}
+
+bool ShouldStoreUncompressed(const CompressionOptions& options,
+                             const Tensor& string_component) {
+  if (!options.adaptive || options.codec == COMPRESSION_CODEC_NONE) {
+    return false;
+  }
+  const auto& flats = string_component.unaligned_flat<tstring>();
+  size_t num_bytes = 0;
+  for (int i = 0; i < flats.size(); ++i) {
+    num_bytes += flats.data()[i].size();
+  }
+  if (num_bytes < kMinAdaptiveComponentBytes) {
+    return false;
+  }
+  // Samples every string, e.g. every encoded image of a batch.
+  const size_t max_bytes_per_string =
+      std::max<size_t>(kAdaptiveSampleBytes / flats.size(), 1024);
+  std::string sample;
+  for (int i = 0; i < flats.size() && sample.size() < kAdaptiveSampleBytes;
+       ++i) {
+    absl::StrAppend(&sample,
+                    MiddleSample(absl::string_view(flats.data()[i].data(),
+                                                   flats.data()[i].size()),
+                                 max_bytes_per_string));
+  }
+  return IsIncompressible(options, sample);
+}
+
+}  // namespace
+
+absl::StatusOr<CompressionOptions> ParseCompressionOptions(
+    absl::string_view options) {
+  CompressionOptions result;
+  if (options.empty()) {
+    return result;
+  }
+  auto error = [&](absl::string_view reason) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Invalid compression options \"", options, "\": ", reason));
+  };
+  std::vector<absl::string_view> parts = absl::StrSplit(options, ':');
+  size_t i = 0;
+  if (parts[i] == "adaptive") {
+    result.adaptive = true;
+    ++i;
+  }
+  if (i == parts.size()) {
+    return error("missing codec.");
+  }
+  if (parts[i] == CompressionCodecName(COMPRESSION_CODEC_SNAPPY)) {
+    result.codec = COMPRESSION_CODEC_SNAPPY;
+  } else if (parts[i] == CompressionCodecName(COMPRESSION_CODEC_NONE)) {
+    result.codec = COMPRESSION_CODEC_NONE;
+  } else if (parts[i] == CompressionCodecName(COMPRESSION_CODEC_ZSTD)) {
+    result.codec = COMPRESSION_CODEC_ZSTD;
+  } else {
+    return error(absl::StrCat("unknown codec \"", parts[i],
+                              "\". Supported codecs are snappy, zstd and "
+                              "none."));
+  }
+  if (++i == parts.size()) {
+    return result;
+  }
+  if (result.codec != COMPRESSION_CODEC_ZSTD) {
+    return error("only zstd supports compression levels.");
+  }
+  if (!absl::SimpleAtoi(parts[i], &result.level) ||
+      result.level < ZSTD_minCLevel() || result.level > ZSTD_maxCLevel()) {
+    return error(absl::StrCat("zstd levels must be integers in [",
+                              ZSTD_minCLevel(), ", ", ZSTD_maxCLevel(), "]."));
+  }
+  if (++i != parts.size()) {
+    return error("expected [adaptive:]<codec>[:<level>].");
+  }
+  return result;
+}
+
+absl::string_view CompressionCodecName(CompressionCodec codec) {
+  switch (codec) {
+    case COMPRESSION_CODEC_SNAPPY:
+      return "snappy";
+    case COMPRESSION_CODEC_NONE:
+      return "none";
+    case COMPRESSION_CODEC_ZSTD:
+      return "zstd";
+    default:
+      return "unknown";
+  }
+}
+
+std::vector<CompressionCodec> SupportedCompressionCodecs() {
+  return {COMPRESSION_CODEC_SNAPPY, COMPRESSION_CODEC_NONE,
+          COMPRESSION_CODEC_ZSTD};
+}
+
+absl::Status CompressElement(const std::vector<Tensor>& element,
+                             CompressedElement* out) {
+  return CompressElement(element, CompressionOptions(), out);
+}
+
 absl::Status CompressElement(const std::vector<Tensor>& element,
+                             const CompressionOptions& options,
                              CompressedElement* out) {
+  const uint64_t start_time_us = EnvTime::NowMicros();
   // First pass: preprocess the non`memcpy`able tensors.
   size_t num_string_tensors = 0;
   size_t num_string_tensor_strings = 0;
@@ -95,7 +468,12 @@ absl::Status CompressElement(const std::vector<Tensor>& element,
   // string).
   // - All other tensors are serialized and copied into a string (a `tstring`
   // for access to `resize_unitialized`).
-  Iov iov{element.size() + num_string_tensor_strings - num_string_tensors};
+  // Components found to be incompressible by adaptive compression are pointed
+  // to from `uncompressed_iov` instead of `iov`.
+  const size_t num_pieces =
+      element.size() + num_string_tensor_strings - num_string_tensors;
+  Iov iov{num_pieces};
+  Iov uncompressed_iov{num_pieces};
   tstring nonmemcpyable;
   nonmemcpyable.resize_uninitialized(total_nonmemcpyable_size);
   char* nonmemcpyable_pos = nonmemcpyable.mdata();
@@ -109,14 +487,22 @@ absl::Status CompressElement(const std::vector<Tensor>& element,
     if (DataTypeCanUseMemcpy(component.dtype())) {
       const TensorBuffer* buffer = DMAHelper::buffer(&component);
       if (buffer) {
-        iov.Add(buffer->data(), buffer->size());
+        const bool store_uncompressed =
+            ShouldStoreUncompressed(options, *buffer);
+        metadata->set_stored_uncompressed(store_uncompressed);
+        (store_uncompressed ? uncompressed_iov : iov)
+            .Add(buffer->data(), buffer->size());
         metadata->add_uncompressed_bytes(buffer->size());
       }
     } else if (component.dtype() == DT_STRING) {
+      const bool store_uncompressed =
+          ShouldStoreUncompressed(options, component);
+      metadata->set_stored_uncompressed(store_uncompressed);
+      Iov& target = store_uncompressed ? uncompressed_iov : iov;
       const auto& flats = component.unaligned_flat<tstring>();
       for (int i = 0; i < flats.size(); ++i) {
-        iov.Add(const_cast<char*>(flats.data()[i].data()),
-                flats.data()[i].size());
+        target.Add(const_cast<char*>(flats.data()[i].data()),
+                   flats.data()[i].size());
         metadata->add_uncompressed_bytes(flats.data()[i].size());
       }
     } else {
@@ -129,24 +515,34 @@ absl::Status CompressElement(const std::vector<Tensor>& element,
     }
   }
 
-  if (iov.NumBytes() > std::numeric_limits<uint32_t>::max()) {
-    return absl::OutOfRangeError(
-        absl::StrCat("Encountered dataset element of size ", iov.NumBytes(),
-                     ", exceeding the 4GB Snappy limit."));
+  TF_RETURN_IF_ERROR(CompressIov(options, iov, out->mutable_data()));
+  if (uncompressed_iov.NumBytes() > 0) {
+    CopyFromIov(uncompressed_iov, out->mutable_uncompressed_data());
   }
-  if (!port::Snappy_CompressFromIOVec(iov.Data(), iov.NumBytes(),
-                                      out->mutable_data())) {
-    return absl::InternalError("Failed to compress using snappy.");
+  if (options.codec == COMPRESSION_CODEC_SNAPPY &&
+      uncompressed_iov.NumBytes() == 0) {
+    out->set_version(kSnappyOnlyCompressedElementVersion);
+  } else {
+    out->set_version(kCompressedElementVersion);
+    out->set_codec(options.codec);
   }
-  out->set_version(kCompressedElementVersion);
+  metrics::RecordTFDataCompression(
+      std::string(CompressionCodecName(options.codec)), /*compress=*/true,
+      iov.NumBytes(), out->data().size(), uncompressed_iov.NumBytes(),
+      EnvTime::NowMicros() - start_time_us);
   VLOG(3) << "Compressed element from " << iov.NumBytes() << " bytes to "
-          << out->data().size() << " bytes";
+          << out->data().size() << " bytes with "
+          << CompressionCodecName(options.codec) << ", and stored "
+          << uncompressed_iov.NumBytes() << " incompressible bytes";
   return absl::OkStatus();
 }
 
 absl::Status UncompressElement(const CompressedElement& compressed,
                                std::vector<Tensor>* out) {
-  if (compressed.version() != kCompressedElementVersion) {
+  // Version 0 elements don't set the fields added in version 1, whose defaults
+  // describe snappy compressed elements.
+  if (compressed.version() != kSnappyOnlyCompressedElementVersion &&
+      compressed.version() != kCompressedElementVersion) {
     return absl::InternalError(absl::StrCat(
         "Unsupported compressed element version: ", compressed.version()));
   }
@@ -181,11 +577,16 @@ absl::Status UncompressElement(const CompressedElement& compressed,
   // for each string).
   // - All other tensors are uncompressed into a string (a `tstring` for access
   // to `resize_unitialized`).
-  Iov iov{num_components + num_string_tensor_strings - num_string_tensors};
+  // Components stored uncompressed are copied into via `uncompressed_iov`.
+  const size_t num_pieces =
+      num_components + num_string_tensor_strings - num_string_tensors;
+  Iov iov{num_pieces};
+  Iov uncompressed_iov{num_pieces};
   tstring nonmemcpyable;
   nonmemcpyable.resize_uninitialized(total_nonmemcpyable_size);
   char* nonmemcpyable_pos = nonmemcpyable.mdata();
   for (const auto& metadata : compressed.component_metadata()) {
+    Iov& target = metadata.stored_uncompressed() ? uncompressed_iov : iov;
     if (DataTypeCanUseMemcpy(metadata.dtype())) {
       TensorShape shape(metadata.tensor_shape());
       int64_t num_elements = shape.num_elements();
@@ -197,7 +598,7 @@ absl::Status UncompressElement(const CompressedElement& compressed,
               "uncompressed_bytes (", metadata.uncompressed_bytes(0),
               ") exceeds allocated buffer size (", buffer->size(), ")"));
         }
-        iov.Add(buffer->data(), metadata.uncompressed_bytes(0));
+        target.Add(buffer->data(), metadata.uncompressed_bytes(0));
       }
     } else if (metadata.dtype() == DT_STRING) {
       out->emplace_back(metadata.dtype(), metadata.tensor_shape());
@@ -210,38 +611,28 @@ absl::Status UncompressElement(const CompressedElement& compressed,
       }
       for (int i = 0; i < metadata.uncompressed_bytes_size(); ++i) {
         flats.data()[i].resize(metadata.uncompressed_bytes(i));
-        iov.Add(flats.data()[i].mdata(), metadata.uncompressed_bytes(i));
+        target.Add(flats.data()[i].mdata(), metadata.uncompressed_bytes(i));
       }
     } else {
       TensorShape shape(metadata.tensor_shape());
       int64_t num_elements = shape.num_elements();
       out->emplace_back();
       if (num_elements > 0) {
-        iov.Add(nonmemcpyable_pos, metadata.uncompressed_bytes(0));
+        target.Add(nonmemcpyable_pos, metadata.uncompressed_bytes(0));
         nonmemcpyable_pos += metadata.uncompressed_bytes(0);
       }
     }
   }
 
-  // Step 2: Uncompress into the iovec.
-  const std::string& compressed_data = compressed.data();
-  size_t uncompressed_size;
-  if (!port::Snappy_GetUncompressedLength(
-          compressed_data.data(), compressed_data.size(), &uncompressed_size)) {
-    return absl::InternalError(absl::StrCat(
-        "Could not get snappy uncompressed length. Compressed data size: ",
-        compressed_data.size()));
-  }
-  if (uncompressed_size != static_cast<size_t>(iov.NumBytes())) {
-    return absl::InternalError(absl::StrCat(
-        "Uncompressed size mismatch. Snappy expects ", uncompressed_size,
-        " whereas the tensor metadata suggests ", iov.NumBytes()));
-  }
-  if (!port::Snappy_UncompressToIOVec(compressed_data.data(),
-                                      compressed_data.size(), iov.Data(),
-                                      iov.NumPieces())) {
-    return absl::InternalError("Failed to perform snappy decompression.");
-  }
+  // Step 2: Uncompress into the iovecs.
+  const uint64_t start_time_us = EnvTime::NowMicros();
+  TF_RETURN_IF_ERROR(UncompressIov(compressed.codec(), compressed.data(), iov));
+  TF_RETURN_IF_ERROR(
+      CopyToIov(compressed.uncompressed_data(), uncompressed_iov));
+  metrics::RecordTFDataCompression(
+      std::string(CompressionCodecName(compressed.codec())),
+      /*compress=*/false, iov.NumBytes(), compressed.data().size(),
+      uncompressed_iov.NumBytes(), EnvTime::NowMicros() - start_time_us);
 
   // Third pass: deserialize nonstring, non`memcpy`able tensors.
   nonmemcpyable_pos = nonmemcpyable.mdata();
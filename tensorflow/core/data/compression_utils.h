@@ -15,9 +15,12 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_DATA_COMPRESSION_UTILS_H_
 #define TENSORFLOW_CORE_DATA_COMPRESSION_UTILS_H_
 
+#include <string>
 #include <vector>
 
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
 #include "tensorflow/core/framework/dataset.pb.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/platform/status.h"
@@ -25,12 +28,43 @@ limitations under the License.
 namespace tensorflow {
 namespace data {
 
+// Options for `CompressElement`.
+struct CompressionOptions {
+  CompressionCodec codec = COMPRESSION_CODEC_SNAPPY;
+  // Compression level of codecs which support levels (zstd). 0 selects the
+  // codec's default level; negative zstd levels trade ratio for speed.
+  int level = 0;
+  // If true, a sample of each large component is compressed first, and
+  // components which don't compress well (e.g. encoded images) are stored
+  // uncompressed instead of spending time compressing them.
+  bool adaptive = false;
+};
+
+// Parses `CompressionOptions` from a string of the form
+// "[adaptive:]<codec>[:<level>]", where `<codec>` is one of "snappy", "zstd"
+// or "none", e.g. "zstd:3" or "adaptive:snappy". The empty string selects the
+// default options.
+absl::StatusOr<CompressionOptions> ParseCompressionOptions(
+    absl::string_view options);
+
+// Returns the name of `codec` used in options strings and metrics.
+absl::string_view CompressionCodecName(CompressionCodec codec);
+
+// Returns the codecs which `UncompressElement` can decode.
+std::vector<CompressionCodec> SupportedCompressionCodecs();
+
 // Compresses the components of `element` into the `CompressedElement` proto.
 //
 // In addition to writing the actual compressed bytes, `Compress` fills
 // out the per-component metadata for the `CompressedElement`.
 //
-// Returns an error if the uncompressed size of the element exceeds 4GB.
+// Returns an error if the element is snappy compressed and its uncompressed
+// size exceeds 4GB.
+absl::Status CompressElement(const std::vector<Tensor>& element,
+                             const CompressionOptions& options,
+                             CompressedElement* out);
+
+// Compresses `element` with the default (snappy) options.
 absl::Status CompressElement(const std::vector<Tensor>& element,
                              CompressedElement* out);
 
@@ -15,16 +15,23 @@ limitations under the License.
 #include "tensorflow/core/data/compression_utils.h"
 
 #include <cstdint>
+#include <random>
+#include <string>
+#include <tuple>
 #include <vector>
 
 #include <gmock/gmock.h>
+#include "absl/log/check.h"
 #include "absl/status/status_matchers.h"
 #include "xla/tsl/platform/status_matchers.h"
 #include "xla/tsl/protobuf/error_codes.pb.h"
 #include "tensorflow/core/data/dataset_test_base.h"
 #include "tensorflow/core/framework/dataset.pb.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow/core/platform/tstring.h"
 #include "tensorflow/core/protobuf/error_codes.pb.h"
 
 namespace tensorflow {
@@ -103,7 +110,7 @@ TEST_P(ParameterizedCompressionUtilsTest, VersionMismatch) {
   CompressedElement compressed;
   TF_ASSERT_OK(CompressElement(element, &compressed));
 
-  compressed.set_version(1);
+  compressed.set_version(2);
   std::vector<Tensor> round_trip_element;
   EXPECT_THAT(UncompressElement(compressed, &round_trip_element),
               absl_testing::StatusIs(error::INTERNAL));
@@ -112,6 +119,166 @@ TEST_P(ParameterizedCompressionUtilsTest, VersionMismatch) {
 INSTANTIATE_TEST_SUITE_P(Instantiation, ParameterizedCompressionUtilsTest,
                          ::testing::ValuesIn(TestCases()));
 
+class CompressionOptionsTest
+    : public DatasetOpsTestBase,
+      public ::testing::WithParamInterface<
+          std::tuple<std::vector<Tensor>, std::string>> {};
+
+TEST_P(CompressionOptionsTest, RoundTrip) {
+  const auto& [element, options_string] = GetParam();
+  TF_ASSERT_OK_AND_ASSIGN(CompressionOptions options,
+                          ParseCompressionOptions(options_string));
+  CompressedElement compressed;
+  TF_ASSERT_OK(CompressElement(element, options, &compressed));
+  std::vector<Tensor> round_trip_element;
+  TF_ASSERT_OK(UncompressElement(compressed, &round_trip_element));
+  TF_EXPECT_OK(
+      ExpectEqual(element, round_trip_element, /*compare_order=*/true));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Instantiation, CompressionOptionsTest,
+    ::testing::Combine(::testing::ValuesIn(TestCases()),
+                       ::testing::Values("snappy", "none", "zstd", "zstd:-5",
+                                         "adaptive:snappy",
+                                         "adaptive:zstd:1")));
+
+// Returns a string tensor of `num_strings` random strings, like a batch of
+// encoded images.
+Tensor RandomStrings(int64_t num_strings, int64_t string_size) {
+  std::mt19937 rng(0);
+  Tensor tensor(DT_STRING, TensorShape{num_strings});
+  for (int64_t i = 0; i < num_strings; ++i) {
+    std::string s(string_size, '\0');
+    for (char& c : s) {
+      c = static_cast<char>(rng());
+    }
+    tensor.flat<tstring>()(i) = s;
+  }
+  return tensor;
+}
+
+// Returns an element with incompressible components (random bytes) and a
+// compressible component (zeros).
+std::vector<Tensor> MixedCompressibilityElement() {
+  Tensor random_bytes(DT_UINT8, TensorShape{256, 1024});
+  random_bytes.flat<uint8_t>().setRandom();
+  Tensor zeros(DT_FLOAT, TensorShape{256, 256});
+  zeros.flat<float>().setZero();
+  return {random_bytes, zeros,
+          RandomStrings(/*num_strings=*/8, /*string_size=*/32 * 1024)};
+}
+
+TEST(CompressionUtilsTest, AdaptiveCompressionSkipsIncompressibleComponents) {
+  std::vector<Tensor> element = MixedCompressibilityElement();
+  CompressionOptions options;
+  options.codec = COMPRESSION_CODEC_ZSTD;
+  options.adaptive = true;
+  CompressedElement compressed;
+  TF_ASSERT_OK(CompressElement(element, options, &compressed));
+  EXPECT_EQ(compressed.version(), 1);
+  EXPECT_EQ(compressed.codec(), COMPRESSION_CODEC_ZSTD);
+  ASSERT_EQ(compressed.component_metadata_size(), 3);
+  EXPECT_TRUE(compressed.component_metadata(0).stored_uncompressed());
+  EXPECT_FALSE(compressed.component_metadata(1).stored_uncompressed());
+  EXPECT_TRUE(compressed.component_metadata(2).stored_uncompressed());
+  EXPECT_EQ(compressed.uncompressed_data().size(), 256 * 1024 + 8 * 32 * 1024);
+  EXPECT_LT(compressed.data().size(), 1024);
+
+  std::vector<Tensor> round_trip_element;
+  TF_ASSERT_OK(UncompressElement(compressed, &round_trip_element));
+  test::ExpectEqual(element[0], round_trip_element[0]);
+  test::ExpectEqual(element[1], round_trip_element[1]);
+  test::ExpectEqual(element[2], round_trip_element[2]);
+}
+
+TEST(CompressionUtilsTest, NonAdaptiveCompressionCompressesAllComponents) {
+  std::vector<Tensor> element = MixedCompressibilityElement();
+  CompressedElement compressed;
+  TF_ASSERT_OK(CompressElement(element, &compressed));
+  EXPECT_EQ(compressed.version(), 0);
+  EXPECT_TRUE(compressed.uncompressed_data().empty());
+  for (const auto& metadata : compressed.component_metadata()) {
+    EXPECT_FALSE(metadata.stored_uncompressed());
+  }
+}
+
+TEST(CompressionUtilsTest, CodecsOtherThanSnappyUseVersion1) {
+  std::vector<Tensor> element = {CreateTensor<int64_t>(TensorShape{128, 128})};
+  for (CompressionCodec codec :
+       {COMPRESSION_CODEC_NONE, COMPRESSION_CODEC_ZSTD}) {
+    CompressionOptions options;
+    options.codec = codec;
+    CompressedElement compressed;
+    TF_ASSERT_OK(CompressElement(element, options, &compressed));
+    EXPECT_EQ(compressed.version(), 1);
+    EXPECT_EQ(compressed.codec(), codec);
+  }
+}
+
+TEST(CompressionUtilsTest, CorruptedZstdData) {
+  std::vector<Tensor> element = {CreateTensor<int64_t>(TensorShape{128, 128})};
+  CompressionOptions options;
+  options.codec = COMPRESSION_CODEC_ZSTD;
+  CompressedElement compressed;
+  TF_ASSERT_OK(CompressElement(element, options, &compressed));
+  compressed.mutable_data()->resize(compressed.data().size() - 4);
+  std::vector<Tensor> round_trip_element;
+  EXPECT_THAT(UncompressElement(compressed, &round_trip_element),
+              absl_testing::StatusIs(error::INTERNAL));
+}
+
+TEST(CompressionUtilsTest, ParseCompressionOptions) {
+  TF_ASSERT_OK_AND_ASSIGN(CompressionOptions options,
+                          ParseCompressionOptions(""));
+  EXPECT_EQ(options.codec, COMPRESSION_CODEC_SNAPPY);
+  EXPECT_FALSE(options.adaptive);
+
+  TF_ASSERT_OK_AND_ASSIGN(options, ParseCompressionOptions("none"));
+  EXPECT_EQ(options.codec, COMPRESSION_CODEC_NONE);
+
+  TF_ASSERT_OK_AND_ASSIGN(options, ParseCompressionOptions("adaptive:zstd:-3"));
+  EXPECT_EQ(options.codec, COMPRESSION_CODEC_ZSTD);
+  EXPECT_EQ(options.level, -3);
+  EXPECT_TRUE(options.adaptive);
+}
+
+TEST(CompressionUtilsTest, InvalidCompressionOptions) {
+  for (const char* options :
+       {"lz4", "adaptive", "snappy:1", "zstd:100", "zstd:fast", "zstd:1:2"}) {
+    EXPECT_THAT(ParseCompressionOptions(options),
+                absl_testing::StatusIs(error::INVALID_ARGUMENT))
+        << options;
+  }
+}
+
+void BM_CompressElement(::testing::benchmark::State& state,
+                        const std::string& options_string) {
+  CompressionOptions options = ParseCompressionOptions(options_string).value();
+  std::vector<Tensor> element = MixedCompressibilityElement();
+  size_t num_bytes = 0;
+  for (const Tensor& component : element) {
+    num_bytes += component.dtype() == DT_STRING
+                     ? component.NumElements() * 32 * 1024
+                     : component.TotalBytes();
+  }
+  CompressedElement compressed;
+  std::vector<Tensor> round_trip_element;
+  for (auto s : state) {
+    compressed.Clear();
+    CHECK_OK(CompressElement(element, options, &compressed));
+    CHECK_OK(UncompressElement(compressed, &round_trip_element));
+  }
+  state.SetBytesProcessed(state.iterations() * num_bytes);
+}
+
+BENCHMARK_CAPTURE(BM_CompressElement, snappy, "snappy");
+BENCHMARK_CAPTURE(BM_CompressElement, none, "none");
+BENCHMARK_CAPTURE(BM_CompressElement, zstd_1, "zstd:1");
+BENCHMARK_CAPTURE(BM_CompressElement, zstd_neg_5, "zstd:-5");
+BENCHMARK_CAPTURE(BM_CompressElement, adaptive_snappy, "adaptive:snappy");
+BENCHMARK_CAPTURE(BM_CompressElement, adaptive_zstd_1, "adaptive:zstd:1");
+
 }  // namespace
 }  // namespace data
 }  // namespace tensorflow
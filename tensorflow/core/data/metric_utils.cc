@@ -15,6 +15,7 @@ limitations under the License.
 #include "tensorflow/core/data/metric_utils.h"
 
 #include <algorithm>
+#include <cstdlib>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -35,6 +36,33 @@ namespace {
 // Safely subtracts `y` from `x` avoiding underflow.
 uint64_t safe_sub(uint64_t x, uint64_t y) { return x >= y ? x - y : 0; }
 
+const char* TierName(TieredCacheMetricsCollector::Tier tier) {
+  return tier == TieredCacheMetricsCollector::kMemory ? "memory" : "disk";
+}
+
+// The bytes held in each tier by all caches of the process.
+struct ProcessResidentBytes {
+  mutex mu;
+  int64_t bytes[2] TF_GUARDED_BY(mu) = {0, 0};
+};
+
+ProcessResidentBytes& GetProcessResidentBytes() {
+  static ProcessResidentBytes* resident_bytes = new ProcessResidentBytes();
+  return *resident_bytes;
+}
+
+// Adds `delta` to the bytes held in `tier` by the caches of the process.
+void AddResidentBytes(TieredCacheMetricsCollector::Tier tier, int64_t delta) {
+  if (delta == 0) {
+    return;
+  }
+  ProcessResidentBytes& resident_bytes = GetProcessResidentBytes();
+  mutex_lock l(resident_bytes.mu);
+  resident_bytes.bytes[tier] += delta;
+  metrics::RecordTFDataCacheResidentBytes(TierName(tier),
+                                          resident_bytes.bytes[tier]);
+}
+
 }  // namespace
 
 IteratorMetricsCollector::IteratorMetricsCollector(
@@ -90,5 +118,38 @@ bool IteratorMetricsCollector::ShouldCollectMetrics() const {
   return device_type_ == DEVICE_CPU;
 }
 
+TieredCacheMetricsCollector::TieredCacheMetricsCollector(
+    int64_t resident_bytes_granularity)
+    : resident_bytes_granularity_(resident_bytes_granularity) {
+  for (int tier = 0; tier < kNumTiers; ++tier) {
+    for (bool hit : {false, true}) {
+      lookups_[tier][hit] = metrics::GetTFDataCacheLookupCounter(
+          TierName(static_cast<Tier>(tier)), hit);
+    }
+  }
+}
+
+TieredCacheMetricsCollector::~TieredCacheMetricsCollector() {
+  mutex_lock l(mu_);
+  for (int tier = 0; tier < kNumTiers; ++tier) {
+    AddResidentBytes(static_cast<Tier>(tier), -resident_bytes_[tier]);
+  }
+}
+
+void TieredCacheMetricsCollector::RecordLookup(Tier tier, bool hit) {
+  lookups_[tier][hit]->IncrementBy(1);
+}
+
+void TieredCacheMetricsCollector::RecordResidentBytes(Tier tier,
+                                                      int64_t bytes) {
+  mutex_lock l(mu_);
+  const int64_t delta = bytes - resident_bytes_[tier];
+  if (delta == 0 || std::abs(delta) < resident_bytes_granularity_) {
+    return;
+  }
+  AddResidentBytes(tier, delta);
+  resident_bytes_[tier] = bytes;
+}
+
 }  // namespace data
 }  // namespace tensorflow
@@ -21,6 +21,7 @@ limitations under the License.
 
 #include "absl/time/time.h"
 #include "tensorflow/core/data/tfdataz_metrics.h"
+#include "tensorflow/core/framework/metrics.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/mutex.h"
@@ -81,6 +82,51 @@ class IteratorMetricsCollector {
   uint64_t end_time_us_ TF_GUARDED_BY(mu_) = 0;
 };
 
+// Exports the metrics of a cache of dataset elements that keeps elements in
+// memory and on local disk: whether each tier held the looked up elements, and
+// the bytes of the elements held in each tier. The resident bytes are summed
+// over all caches of the process, and are only exported once they have changed
+// by `resident_bytes_granularity` since they were last exported, so that small
+// changes do not contend on the process-wide sums. This class is thread-safe.
+// Example usage:
+//
+//   ```
+//   TieredCacheMetricsCollector metrics_collector(
+//       /*resident_bytes_granularity=*/1 << 20);
+//   metrics_collector.RecordLookup(TieredCacheMetricsCollector::kMemory, hit);
+//   metrics_collector.RecordResidentBytes(TieredCacheMetricsCollector::kMemory,
+//                                         memory_bytes);
+//   ```
+class TieredCacheMetricsCollector {
+ public:
+  enum Tier { kMemory = 0, kDisk = 1 };
+
+  explicit TieredCacheMetricsCollector(int64_t resident_bytes_granularity);
+
+  // Removes the bytes of this cache from the exported resident bytes.
+  ~TieredCacheMetricsCollector();
+
+  TieredCacheMetricsCollector(const TieredCacheMetricsCollector&) = delete;
+  TieredCacheMetricsCollector& operator=(const TieredCacheMetricsCollector&) =
+      delete;
+
+  // Records a lookup of an element in `tier`, and whether `tier` held it.
+  void RecordLookup(Tier tier, bool hit);
+
+  // Records that this cache holds `bytes` of elements in `tier`.
+  void RecordResidentBytes(Tier tier, int64_t bytes);
+
+ private:
+  static constexpr int kNumTiers = 2;
+
+  const int64_t resident_bytes_granularity_;
+  // `lookups_[tier][hit]` counts the lookups in `tier` which hit or missed.
+  monitoring::CounterCell* lookups_[kNumTiers][2];
+
+  mutex mu_;
+  int64_t resident_bytes_[kNumTiers] TF_GUARDED_BY(mu_) = {0, 0};
+};
+
 }  // namespace data
 }  // namespace tensorflow
 
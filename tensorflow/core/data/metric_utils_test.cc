@@ -165,6 +165,49 @@ TEST(MetricUtilsTest, RecordBytesFetched) {
   EXPECT_EQ(bytes_fetched.Delta(), 80);
 }
 
+TEST(MetricUtilsTest, TieredCacheMetrics) {
+  CellReader<int64_t> lookups("/tensorflow/data/cache_lookups");
+  CellReader<int64_t> resident_bytes("/tensorflow/data/cache_resident_bytes");
+  {
+    TieredCacheMetricsCollector cache1(/*resident_bytes_granularity=*/0);
+    TieredCacheMetricsCollector cache2(/*resident_bytes_granularity=*/0);
+    cache1.RecordLookup(TieredCacheMetricsCollector::kMemory, /*hit=*/true);
+    cache1.RecordLookup(TieredCacheMetricsCollector::kMemory, /*hit=*/false);
+    cache2.RecordLookup(TieredCacheMetricsCollector::kDisk, /*hit=*/true);
+    EXPECT_EQ(lookups.Delta("memory", "hit"), 1);
+    EXPECT_EQ(lookups.Delta("memory", "miss"), 1);
+    EXPECT_EQ(lookups.Delta("disk", "hit"), 1);
+
+    cache1.RecordResidentBytes(TieredCacheMetricsCollector::kMemory, 100);
+    cache2.RecordResidentBytes(TieredCacheMetricsCollector::kMemory, 50);
+    cache2.RecordResidentBytes(TieredCacheMetricsCollector::kDisk, 200);
+    EXPECT_EQ(resident_bytes.Read("memory"), 150);
+    EXPECT_EQ(resident_bytes.Read("disk"), 200);
+
+    cache1.RecordResidentBytes(TieredCacheMetricsCollector::kMemory, 30);
+    EXPECT_EQ(resident_bytes.Read("memory"), 80);
+  }
+  // Destroyed caches no longer hold any bytes.
+  EXPECT_EQ(resident_bytes.Read("memory"), 0);
+  EXPECT_EQ(resident_bytes.Read("disk"), 0);
+}
+
+TEST(MetricUtilsTest, TieredCacheResidentBytesGranularity) {
+  CellReader<int64_t> resident_bytes("/tensorflow/data/cache_resident_bytes");
+  {
+    TieredCacheMetricsCollector cache(/*resident_bytes_granularity=*/100);
+    cache.RecordResidentBytes(TieredCacheMetricsCollector::kMemory, 60);
+    EXPECT_EQ(resident_bytes.Read("memory"), 0);
+    cache.RecordResidentBytes(TieredCacheMetricsCollector::kMemory, 120);
+    EXPECT_EQ(resident_bytes.Read("memory"), 120);
+    cache.RecordResidentBytes(TieredCacheMetricsCollector::kMemory, 30);
+    EXPECT_EQ(resident_bytes.Read("memory"), 120);
+    cache.RecordResidentBytes(TieredCacheMetricsCollector::kMemory, 0);
+    EXPECT_EQ(resident_bytes.Read("memory"), 0);
+  }
+  EXPECT_EQ(resident_bytes.Read("memory"), 0);
+}
+
 }  // namespace
 }  // namespace data
 }  // namespace tensorflow
@@ -110,6 +110,20 @@ absl::Status FindStatefulOps(const GraphDef& graph_def,
 absl::Status ReadElementsFromCheckpoint(
     IteratorContext* ctx, IteratorStateReader* reader,
     absl::string_view key_prefix, std::vector<std::vector<Tensor>>* elements) {
+  TF_ASSIGN_OR_RETURN(int64_t num_elements,
+                      ReadNumElementsFromCheckpoint(reader, key_prefix));
+  DCHECK(elements->empty());
+  elements->reserve(num_elements);
+  for (int i = 0; i < num_elements; ++i) {
+    elements->emplace_back();
+    TF_RETURN_IF_ERROR(ReadElementFromCheckpoint(ctx, reader, key_prefix, i,
+                                                 &elements->back()));
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<int64_t> ReadNumElementsFromCheckpoint(
+    IteratorStateReader* reader, absl::string_view key_prefix) {
   int64_t num_elements;
   TF_RETURN_IF_ERROR(
       reader->ReadScalar(key_prefix, kNumElements, &num_elements));
@@ -118,37 +132,45 @@ absl::Status ReadElementsFromCheckpoint(
         absl::StrCat("Num_elements in tf.data checkpoint must be >= 0, got: ",
                      num_elements));
   }
-  DCHECK(elements->empty());
-  elements->reserve(num_elements);
-  for (int i = 0; i < num_elements; ++i) {
-    std::string element_prefix = absl::StrCat(key_prefix, "::", i);
-    int64_t num_components;
-    TF_RETURN_IF_ERROR(
-        reader->ReadScalar(element_prefix, kNumComponents, &num_components));
-    if (num_components < 0) {
-      return absl::InternalError(
-          absl::StrCat("Num of Tensor size in tf.data checkpoint must be >= 0, "
-                       "got: ",
-                       num_components));
-    }
-    elements->emplace_back();
-    std::vector<Tensor>& element = elements->at(i);
-    element.reserve(num_components);
-    for (int j = 0; j < num_components; ++j) {
-      element.emplace_back();
-      TF_RETURN_IF_ERROR(reader->ReadTensor(
-          ctx->flr(), element_prefix, absl::StrCat(kComponent, "[", j, "]"),
-          &element.back()));
-    }
+  return num_elements;
+}
+
+absl::Status ReadElementFromCheckpoint(IteratorContext* ctx,
+                                       IteratorStateReader* reader,
+                                       absl::string_view key_prefix,
+                                       int64_t index,
+                                       std::vector<Tensor>* element) {
+  std::string element_prefix = absl::StrCat(key_prefix, "::", index);
+  int64_t num_components;
+  TF_RETURN_IF_ERROR(
+      reader->ReadScalar(element_prefix, kNumComponents, &num_components));
+  if (num_components < 0) {
+    return absl::InternalError(
+        absl::StrCat("Num of Tensor size in tf.data checkpoint must be >= 0, "
+                     "got: ",
+                     num_components));
+  }
+  element->clear();
+  element->reserve(num_components);
+  for (int j = 0; j < num_components; ++j) {
+    element->emplace_back();
+    TF_RETURN_IF_ERROR(reader->ReadTensor(
+        ctx->flr(), element_prefix, absl::StrCat(kComponent, "[", j, "]"),
+        &element->back()));
   }
   return absl::OkStatus();
 }
 
-absl::Status WriteElement(IteratorStateWriter* writer,
-                          absl::string_view key_prefix,
-                          const std::vector<std::vector<Tensor>>& elements,
-                          int64_t index) {
-  const std::vector<Tensor>& element = elements[index];
+absl::Status WriteNumElementsToCheckpoint(IteratorStateWriter* writer,
+                                          absl::string_view key_prefix,
+                                          int64_t num_elements) {
+  return writer->WriteScalar(key_prefix, kNumElements, num_elements);
+}
+
+absl::Status WriteElementToCheckpoint(IteratorStateWriter* writer,
+                                      absl::string_view key_prefix,
+                                      int64_t index,
+                                      const std::vector<Tensor>& element) {
   std::string element_prefix = absl::StrCat(key_prefix, "::", index);
   TF_RETURN_IF_ERROR(
       writer->WriteScalar(element_prefix, kNumComponents, element.size()));
@@ -163,9 +185,10 @@ absl::Status WriteElementsToCheckpoint(
     IteratorStateWriter* writer, absl::string_view key_prefix,
     const std::vector<std::vector<Tensor>>& elements) {
   TF_RETURN_IF_ERROR(
-      writer->WriteScalar(key_prefix, kNumElements, elements.size()));
+      WriteNumElementsToCheckpoint(writer, key_prefix, elements.size()));
   for (int i = 0; i < elements.size(); ++i) {
-    TF_RETURN_IF_ERROR(WriteElement(writer, key_prefix, elements, i));
+    TF_RETURN_IF_ERROR(
+        WriteElementToCheckpoint(writer, key_prefix, i, elements[i]));
   }
   return absl::OkStatus();
 }
@@ -175,9 +198,10 @@ absl::Status UpdateCheckpointElements(
     const std::vector<std::vector<Tensor>>& elements,
     const absl::flat_hash_set<int64_t>& checkpoint_indices) {
   TF_RETURN_IF_ERROR(
-      writer->WriteScalar(key_prefix, kNumElements, elements.size()));
+      WriteNumElementsToCheckpoint(writer, key_prefix, elements.size()));
   for (int64_t i : checkpoint_indices) {
-    TF_RETURN_IF_ERROR(WriteElement(writer, key_prefix, elements, i));
+    TF_RETURN_IF_ERROR(
+        WriteElementToCheckpoint(writer, key_prefix, i, elements[i]));
   }
   return absl::OkStatus();
 }
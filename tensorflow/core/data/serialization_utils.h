@@ -63,6 +63,25 @@ absl::Status UpdateCheckpointElements(
     const std::vector<std::vector<Tensor>>& elements,
     const absl::flat_hash_set<int64_t>& checkpoint_indices);
 
+// Variants of the functions above for callers that do not keep all elements in
+// memory. Writing the number of elements and then each element of [0,
+// num_elements) is equivalent to WriteElementsToCheckpoint; writing only some
+// of them is equivalent to UpdateCheckpointElements.
+absl::StatusOr<int64_t> ReadNumElementsFromCheckpoint(
+    IteratorStateReader* reader, absl::string_view key_prefix);
+absl::Status ReadElementFromCheckpoint(IteratorContext* ctx,
+                                       IteratorStateReader* reader,
+                                       absl::string_view key_prefix,
+                                       int64_t index,
+                                       std::vector<Tensor>* element);
+absl::Status WriteNumElementsToCheckpoint(IteratorStateWriter* writer,
+                                          absl::string_view key_prefix,
+                                          int64_t num_elements);
+absl::Status WriteElementToCheckpoint(IteratorStateWriter* writer,
+                                      absl::string_view key_prefix,
+                                      int64_t index,
+                                      const std::vector<Tensor>& element);
+
 // Helper class for reading data from a vector of VariantTensorData objects.
 class VariantTensorDataReader : public IteratorStateReader {
  public:
@@ -15,6 +15,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_DATA_SERVICE_CROSS_TRAINER_CACHE_H_
 #define TENSORFLOW_CORE_DATA_SERVICE_CROSS_TRAINER_CACHE_H_
 
+#include <algorithm>
 #include <cstddef>
 #include <deque>
 #include <functional>
@@ -22,9 +23,15 @@ limitations under the License.
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
 #include "tensorflow/core/data/service/byte_size.h"
+#include "tensorflow/core/data/service/cross_trainer_cache_disk_tier.h"
 #include "tensorflow/core/framework/metrics.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/mutex.h"
@@ -46,6 +53,12 @@ namespace data {
 // collected when the cache becomes full. Consequently, trainers read from a
 // sliding window through the dataset and may not read the full dataset.
 //
+// The cache can have a disk tier, which extends the sliding window with the
+// elements evicted from memory. Evicted elements are serialized and appended
+// to a log on local disk, and trainers that fall behind the elements in memory
+// read them back from the log instead of skipping them. Trainers still read
+// the elements in order.
+//
 // The `CrossTrainerCache` class is thread-safe.
 //
 // Example usage:
@@ -78,7 +91,8 @@ namespace data {
 // To use the cache, the user needs to define a `CachableSequence` to generate
 // an infinite sequence of data. It should implement a `GetNext` method to
 // produce elements, and a `GetElementSizeBytes` method to estimate the element
-// size in bytes.
+// size in bytes. To use the disk tier, it should also implement
+// `SerializeElement` and `DeserializeElement`.
 template <class ElementType>
 class CachableSequence {
  public:
@@ -89,6 +103,20 @@ class CachableSequence {
 
   // Returns the estimated size of the element in bytes.
   virtual size_t GetElementSizeBytes(const ElementType&) const = 0;
+
+  // Serializes the element to spill it to the disk tier.
+  virtual absl::StatusOr<std::string> SerializeElement(
+      const ElementType& element) const {
+    return absl::UnimplementedError(
+        "The cached sequence does not support serializing elements.");
+  }
+
+  // Parses an element serialized by `SerializeElement`.
+  virtual absl::StatusOr<ElementType> DeserializeElement(
+      absl::string_view serialized) const {
+    return absl::UnimplementedError(
+        "The cached sequence does not support deserializing elements.");
+  }
 };
 
 // Sliding-window cache shared across concurrent trainers.
@@ -101,6 +129,13 @@ class CrossTrainerCache {
   explicit CrossTrainerCache(
       size_t max_cache_size_bytes,
       std::unique_ptr<CachableSequence<ElementType>> cachable_sequence);
+
+  // Creates a `CrossTrainerCache` which spills the elements evicted from memory
+  // to `disk_tier`, if it is not null.
+  CrossTrainerCache(
+      size_t max_cache_size_bytes,
+      std::unique_ptr<CachableSequence<ElementType>> cachable_sequence,
+      std::unique_ptr<CrossTrainerCacheDiskTier> disk_tier);
   virtual ~CrossTrainerCache() = default;
   CrossTrainerCache(const CrossTrainerCache&) = delete;
   CrossTrainerCache& operator=(const CrossTrainerCache&) = delete;
@@ -124,6 +159,11 @@ class CrossTrainerCache {
   struct CacheQueryResult {
     std::shared_ptr<const ElementType> element;
     bool cache_hit;
+    // True if the element to read had been evicted from memory, and the disk
+    // tier was queried.
+    bool disk_lookup = false;
+    // True if the element was read from the disk tier.
+    bool disk_hit = false;
   };
 
   // Returns the next element and metrics about this query.
@@ -138,13 +178,25 @@ class CrossTrainerCache {
   // the cached elements).
   size_t GetElementIndex(const std::string& trainer_id);
 
+  // Returns the index of the first element in the cache, in memory or on disk.
+  size_t GetStartIndex();
+
   // Returns the next element for `trainer_id`.
   StatusOr<std::shared_ptr<const ElementType>> GetElement(
       const std::string& trainer_id);
 
+  // Reads the element at `element_index` from the disk tier.
+  StatusOr<std::shared_ptr<const ElementType>> ReadFromDisk(
+      size_t element_index);
+
   // Reads a new element and writes it into the cache.
   absl::Status ExtendCache();
 
+  // Spills the elements that `FreeSpace` is going to free to the disk tier.
+  // The elements are written without holding `mu_`, so that trainers keep
+  // reading from memory in the meantime.
+  void SpillToDisk(size_t new_element_size_bytes);
+
   // Frees old elements to keep the cache size below `max_cache_size_bytes_`.
   // `new_element_size_bytes` is the size of the new element being inserted.
   void FreeSpace(size_t new_element_size_bytes);
@@ -158,6 +210,11 @@ class CrossTrainerCache {
   // The element sequence over which the sliding window cache operates.
   std::unique_ptr<CachableSequence<ElementType>> cachable_sequence_;
 
+  // Holds the elements evicted from memory, if the cache has a disk tier. The
+  // disk tier holds elements up to at least `cache_start_index_`, so that the
+  // elements in the cache are consecutive.
+  const std::unique_ptr<CrossTrainerCacheDiskTier> disk_tier_;
+
   mutable mutex mu_;
   mutable condition_variable cv_;
 
@@ -175,7 +232,8 @@ class CrossTrainerCache {
 
   // Maps trainer IDs to element indices. The indices are absolute indices
   // within the dataset. The actual index to use with `cache_` would be
-  // `trainer_to_element_index_map_[trainer_id] - cache_start_index_`.
+  // `trainer_to_element_index_map_[trainer_id] - cache_start_index_`. Indices
+  // below `cache_start_index_` refer to elements on disk.
   absl::flat_hash_map<std::string, size_t> trainer_to_element_index_map_
       TF_GUARDED_BY(mu_);
 };
@@ -184,12 +242,22 @@ template <class ElementType>
 CrossTrainerCache<ElementType>::CrossTrainerCache(
     size_t max_cache_size_bytes,
     std::unique_ptr<CachableSequence<ElementType>> cachable_sequence)
+    : CrossTrainerCache(max_cache_size_bytes, std::move(cachable_sequence),
+                        /*disk_tier=*/nullptr) {}
+
+template <class ElementType>
+CrossTrainerCache<ElementType>::CrossTrainerCache(
+    size_t max_cache_size_bytes,
+    std::unique_ptr<CachableSequence<ElementType>> cachable_sequence,
+    std::unique_ptr<CrossTrainerCacheDiskTier> disk_tier)
     : max_cache_size_bytes_(max_cache_size_bytes),
-      cachable_sequence_(std::move(cachable_sequence)) {
+      cachable_sequence_(std::move(cachable_sequence)),
+      disk_tier_(std::move(disk_tier)) {
   DCHECK_GT(max_cache_size_bytes, 0)
       << "CrossTrainerCache size must be greater than 0.";
   VLOG(2) << "Initialized tf.data service cross-trainer cache with "
-          << ByteSize::Bytes(max_cache_size_bytes) << " of memory.";
+          << ByteSize::Bytes(max_cache_size_bytes) << " of memory"
+          << (disk_tier_ ? " and a disk tier." : ".");
 }
 
 template <class ElementType>
@@ -211,21 +279,30 @@ StatusOr<typename CrossTrainerCache<ElementType>::CacheQueryResult>
 CrossTrainerCache<ElementType>::GetCacheQueryResult(
     const std::string& trainer_id) {
   bool should_extend_cache = false;
+  bool disk_lookup = false;
   while (true) {
+    bool should_read_from_disk = false;
+    size_t element_index = 0;
     {
       mutex_lock l(mu_);
       TF_RETURN_IF_ERROR(status_);
       if (IsElementReady(trainer_id)) {
-        TF_ASSIGN_OR_RETURN(std::shared_ptr<const ElementType> element,
-                            GetElement(trainer_id));
-        return CacheQueryResult{element,
-                                /*is_cache_hit=*/!should_extend_cache};
-      }
-
-      // Extends the cache or waits for another thread to extend the cache. When
-      // concurrent trainers wait for the next element, only one of them should
-      // extend the cache.
-      if (extending_cache_) {
+        element_index = GetElementIndex(trainer_id);
+        if (element_index >= cache_start_index_) {
+          TF_ASSIGN_OR_RETURN(std::shared_ptr<const ElementType> element,
+                              GetElement(trainer_id));
+          return CacheQueryResult{element,
+                                  /*is_cache_hit=*/!should_extend_cache,
+                                  disk_lookup, /*disk_hit=*/false};
+        }
+        // The element has been evicted from memory. It is read from disk
+        // without holding `mu_`.
+        should_read_from_disk = true;
+        disk_lookup = true;
+      } else if (extending_cache_) {
+        // Waits for another thread to extend the cache. When concurrent
+        // trainers wait for the next element, only one of them should extend
+        // the cache.
         should_extend_cache = false;
         cv_.wait(l);
       } else {
@@ -234,6 +311,27 @@ CrossTrainerCache<ElementType>::GetCacheQueryResult(
       }
     }
 
+    if (should_read_from_disk) {
+      StatusOr<std::shared_ptr<const ElementType>> element =
+          ReadFromDisk(element_index);
+      if (!element.ok() && !absl::IsNotFound(element.status())) {
+        LOG_EVERY_N_SEC(WARNING, 60)
+            << "Failed to read element " << element_index
+            << " from the tf.data service cross-trainer cache disk tier: "
+            << element.status();
+      }
+      mutex_lock l(mu_);
+      TF_RETURN_IF_ERROR(status_);
+      // If the element is no longer on disk, or can't be read, the trainer
+      // skips it, like elements that slid out of the cache.
+      trainer_to_element_index_map_[trainer_id] = element_index + 1;
+      if (element.ok()) {
+        return CacheQueryResult{*std::move(element), /*is_cache_hit=*/true,
+                                disk_lookup, /*disk_hit=*/true};
+      }
+      continue;
+    }
+
     if (should_extend_cache) {
       absl::Status s = ExtendCache();
       mutex_lock l(mu_);
@@ -271,12 +369,34 @@ template <class ElementType>
 size_t CrossTrainerCache<ElementType>::GetElementIndex(
     const std::string& trainer_id) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
   size_t element_index = trainer_to_element_index_map_[trainer_id];
-  if (element_index < cache_start_index_) {
-    element_index = cache_start_index_;
+  size_t start_index = GetStartIndex();
+  if (element_index < start_index) {
+    element_index = start_index;
   }
   return element_index;
 }
 
+template <class ElementType>
+size_t CrossTrainerCache<ElementType>::GetStartIndex()
+    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  // The elements on disk are only part of the cache if they are followed by
+  // the elements in memory.
+  if (disk_tier_ == nullptr || disk_tier_->end_index() < cache_start_index_) {
+    return cache_start_index_;
+  }
+  return std::min(disk_tier_->start_index(), cache_start_index_);
+}
+
+template <class ElementType>
+StatusOr<std::shared_ptr<const ElementType>>
+CrossTrainerCache<ElementType>::ReadFromDisk(size_t element_index)
+    TF_LOCKS_EXCLUDED(mu_) {
+  TF_ASSIGN_OR_RETURN(std::string serialized, disk_tier_->Read(element_index));
+  TF_ASSIGN_OR_RETURN(ElementType element,
+                      cachable_sequence_->DeserializeElement(serialized));
+  return std::make_shared<const ElementType>(std::move(element));
+}
+
 template <class ElementType>
 absl::Status CrossTrainerCache<ElementType>::ExtendCache()
     TF_LOCKS_EXCLUDED(mu_) {
@@ -290,6 +410,10 @@ absl::Status CrossTrainerCache<ElementType>::ExtendCache()
         " and cache size: ", max_cache_size_bytes_));
   }
 
+  if (disk_tier_ != nullptr) {
+    SpillToDisk(new_element_size_bytes);
+  }
+
   mutex_lock l(mu_);
   TF_RETURN_IF_ERROR(status_);
   FreeSpace(new_element_size_bytes);
@@ -298,6 +422,46 @@ absl::Status CrossTrainerCache<ElementType>::ExtendCache()
   return absl::OkStatus();
 }
 
+template <class ElementType>
+void CrossTrainerCache<ElementType>::SpillToDisk(size_t new_element_size_bytes)
+    TF_LOCKS_EXCLUDED(mu_) {
+  // Only the thread extending the cache modifies `cache_`, so these are the
+  // elements `FreeSpace` frees next.
+  std::vector<std::shared_ptr<const ElementType>> elements;
+  size_t start_index = 0;
+  {
+    mutex_lock l(mu_);
+    start_index = cache_start_index_;
+    size_t cache_size_bytes = cache_size_bytes_;
+    for (const std::shared_ptr<const ElementType>& element : cache_) {
+      if (cache_size_bytes + new_element_size_bytes <= max_cache_size_bytes_) {
+        break;
+      }
+      cache_size_bytes -= cachable_sequence_->GetElementSizeBytes(*element);
+      elements.push_back(element);
+    }
+  }
+
+  for (size_t i = 0; i < elements.size(); ++i) {
+    StatusOr<std::string> serialized =
+        cachable_sequence_->SerializeElement(*elements[i]);
+    absl::Status status = serialized.status();
+    if (status.ok()) {
+      status = disk_tier_->Append(start_index + i, *serialized);
+    }
+    if (!status.ok()) {
+      // Drops the elements on disk, which are no longer followed by the
+      // elements in memory.
+      LOG_EVERY_N_SEC(WARNING, 60)
+          << "Failed to spill element " << start_index + i
+          << " to the tf.data service cross-trainer cache disk tier: "
+          << status;
+      disk_tier_->Clear();
+      return;
+    }
+  }
+}
+
 template <class ElementType>
 void CrossTrainerCache<ElementType>::FreeSpace(size_t new_element_size_bytes)
     TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
@@ -341,12 +505,22 @@ template <class ElementType>
 void CrossTrainerCache<ElementType>::RecordMetrics(
     const CacheQueryResult& result) {
   metrics::RecordTFDataServiceCrossTrainerCacheQuery(result.cache_hit);
+  metrics::RecordTFDataServiceCrossTrainerCacheTierQuery(
+      "memory", result.cache_hit && !result.disk_lookup);
+  if (result.disk_lookup) {
+    metrics::RecordTFDataServiceCrossTrainerCacheTierQuery("disk",
+                                                           result.disk_hit);
+  }
   size_t cache_size_bytes = 0;
   {
     mutex_lock l(mu_);
     cache_size_bytes = cache_size_bytes_;
   }
   metrics::RecordTFDataServiceCrossTrainerCacheSizeBytes(cache_size_bytes);
+  if (disk_tier_ != nullptr) {
+    metrics::RecordTFDataServiceCrossTrainerCacheDiskSizeBytes(
+        disk_tier_->size_bytes());
+  }
 }
 
 }  // namespace data
@@ -0,0 +1,309 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/service/cross_trainer_cache_disk_tier.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/log/log.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tensorflow/core/lib/hash/crc32c.h"
+#include "tensorflow/core/lib/random/random.h"
+#include "tensorflow/core/platform/coding.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/raw_coding.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+// A record is the length and the masked crc32c of the serialized element,
+// followed by the serialized element.
+constexpr size_t kRecordHeaderSize = 2 * sizeof(uint32_t);
+
+// The log is split into this many segments, so that dropping the oldest
+// segment frees a fraction of the log.
+constexpr uint64_t kNumSegments = 8;
+
+// The number of read-ahead buffers, so that a few trainers reading from
+// different parts of the log don't evict each other's buffers.
+constexpr size_t kNumReadAheadBuffers = 4;
+
+}  // namespace
+
+CrossTrainerCacheDiskTier::Segment::~Segment() {
+  if (writer) {
+    writer->Close().IgnoreError();
+  }
+  absl::Status s = env->DeleteFile(filename);
+  if (!s.ok()) {
+    LOG(WARNING) << "Failed to delete tf.data service cross-trainer cache "
+                 << "file " << filename << ": " << s;
+  }
+}
+
+uint64_t CrossTrainerCacheDiskTier::Segment::RecordEnd(size_t index) const {
+  const size_t i = index - start_index + 1;
+  return i < offsets.size() ? offsets[i] : size_bytes;
+}
+
+absl::StatusOr<std::unique_ptr<CrossTrainerCacheDiskTier>>
+CrossTrainerCacheDiskTier::Create(
+    Env* env, const CrossTrainerCacheDiskTierOptions& options) {
+  if (options.directory.empty()) {
+    return absl::InvalidArgumentError(
+        "tf.data service cross-trainer cache disk tier requires a directory.");
+  }
+  if (options.max_size_bytes == 0) {
+    return absl::InvalidArgumentError(
+        "tf.data service cross-trainer cache disk tier size must be greater "
+        "than 0.");
+  }
+  TF_RETURN_IF_ERROR(env->RecursivelyCreateDir(options.directory));
+  std::string file_prefix = io::JoinPath(
+      options.directory, absl::StrCat("cross_trainer_cache_", env->NowMicros(),
+                                      "_", random::New64()));
+  return absl::WrapUnique(
+      new CrossTrainerCacheDiskTier(env, options, std::move(file_prefix)));
+}
+
+CrossTrainerCacheDiskTier::CrossTrainerCacheDiskTier(
+    Env* env, const CrossTrainerCacheDiskTierOptions& options,
+    std::string file_prefix)
+    : env_(env),
+      options_(options),
+      file_prefix_(std::move(file_prefix)),
+      max_segment_size_bytes_(
+          std::max<uint64_t>(options.max_size_bytes / kNumSegments, 1)) {}
+
+absl::Status CrossTrainerCacheDiskTier::Append(size_t index,
+                                               absl::string_view record) {
+  std::shared_ptr<Segment> segment;
+  {
+    mutex_lock l(mu_);
+    // The element is already on disk, e.g. if extending the cache failed
+    // after spilling it, and the spill is retried.
+    if (index >= start_index_ && index < end_index_) {
+      return absl::OkStatus();
+    }
+    if (!segments_.empty() && index != end_index_) {
+      ClearLocked();
+    }
+    if (kRecordHeaderSize + record.size() > options_.max_size_bytes) {
+      ClearLocked();
+      start_index_ = end_index_ = index + 1;
+      return absl::OkStatus();
+    }
+    if (segments_.empty()) {
+      start_index_ = end_index_ = index;
+    }
+    if (!segments_.empty() &&
+        segments_.back()->size_bytes >= max_segment_size_bytes_) {
+      TF_RETURN_IF_ERROR(segments_.back()->writer->Close());
+      segments_.back()->writer.reset();
+    }
+    if (segments_.empty() || !segments_.back()->writer) {
+      TF_RETURN_IF_ERROR(AddSegment(index));
+    }
+    segment = segments_.back();
+  }
+
+  // Only the writer modifies the last segment, so the record is written
+  // without blocking readers.
+  char header[kRecordHeaderSize];
+  core::EncodeFixed32(header, static_cast<uint32_t>(record.size()));
+  core::EncodeFixed32(
+      header + sizeof(uint32_t),
+      crc32c::Mask(crc32c::Value(record.data(), record.size())));
+  absl::Status s =
+      segment->writer->Append(absl::string_view(header, kRecordHeaderSize));
+  if (s.ok()) s = segment->writer->Append(record);
+  // Readers read the file while it is being written.
+  if (s.ok()) s = segment->writer->Flush();
+
+  mutex_lock l(mu_);
+  if (!s.ok()) {
+    ClearLocked();
+    return s;
+  }
+  const uint64_t record_size_bytes = kRecordHeaderSize + record.size();
+  segment->offsets.push_back(segment->size_bytes);
+  segment->size_bytes += record_size_bytes;
+  size_bytes_ += record_size_bytes;
+  ++end_index_;
+
+  while (size_bytes_ > options_.max_size_bytes && segments_.size() > 1) {
+    size_bytes_ -= segments_.front()->size_bytes;
+    segments_.pop_front();
+    start_index_ = segments_.front()->start_index;
+  }
+  while (!read_ahead_buffers_.empty() &&
+         read_ahead_buffers_.front()->end_index <= start_index_) {
+    read_ahead_buffers_.pop_front();
+  }
+  return absl::OkStatus();
+}
+
+absl::Status CrossTrainerCacheDiskTier::AddSegment(size_t index)
+    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  auto segment = std::make_shared<Segment>();
+  segment->env = env_;
+  segment->filename = absl::StrCat(file_prefix_, "_", next_segment_id_++);
+  segment->start_index = index;
+  TF_RETURN_IF_ERROR(
+      env_->NewWritableFile(segment->filename, &segment->writer));
+  TF_RETURN_IF_ERROR(
+      env_->NewRandomAccessFile(segment->filename, &segment->reader));
+  segments_.push_back(std::move(segment));
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::string> CrossTrainerCacheDiskTier::Read(size_t index) {
+  auto buffer = std::make_shared<ReadAheadBuffer>();
+  uint64_t offset = 0;
+  std::vector<uint64_t> offsets;
+  {
+    mutex_lock l(mu_);
+    if (index < start_index_ || index >= end_index_) {
+      return absl::NotFoundError(absl::StrCat(
+          "Element ", index, " is not in the tf.data service cross-trainer "
+          "cache disk tier."));
+    }
+    for (const std::shared_ptr<const ReadAheadBuffer>& read_ahead_buffer :
+         read_ahead_buffers_) {
+      if (index >= read_ahead_buffer->start_index &&
+          index < read_ahead_buffer->end_index) {
+        return ReadRecord(*read_ahead_buffer, index);
+      }
+    }
+
+    // Reads the records following `index` in its segment, up to
+    // `read_ahead_bytes`, and at least the record of `index`.
+    const std::shared_ptr<Segment>& segment = FindSegment(index);
+    const size_t segment_end_index =
+        segment->start_index + segment->offsets.size();
+    offset = segment->offsets[index - segment->start_index];
+    buffer->segment = segment;
+    buffer->start_index = index;
+    buffer->end_index = index + 1;
+    while (buffer->end_index < segment_end_index &&
+           segment->RecordEnd(buffer->end_index) - offset <=
+               options_.read_ahead_bytes) {
+      ++buffer->end_index;
+    }
+    for (size_t i = index; i < buffer->end_index; ++i) {
+      offsets.push_back(segment->offsets[i - segment->start_index] - offset);
+    }
+    buffer->data.resize(segment->RecordEnd(buffer->end_index - 1) - offset);
+  }
+
+  absl::string_view data;
+  TF_RETURN_IF_ERROR(buffer->segment->reader->Read(
+      offset, data, absl::MakeSpan(buffer->data)));
+  if (data.size() != buffer->data.size()) {
+    return absl::DataLossError(absl::StrCat(
+        "Failed to read element ", index, " from tf.data service cross-trainer "
+        "cache file ", buffer->segment->filename, ": expected ",
+        buffer->data.size(), " bytes, got ", data.size(), "."));
+  }
+  if (data.data() != buffer->data.data()) {
+    buffer->data.assign(data.data(), data.size());
+  }
+  buffer->offsets = std::move(offsets);
+  absl::StatusOr<std::string> record = ReadRecord(*buffer, index);
+
+  mutex_lock l(mu_);
+  if (record.ok() && buffer->end_index > index + 1) {
+    if (read_ahead_buffers_.size() >= kNumReadAheadBuffers) {
+      read_ahead_buffers_.pop_front();
+    }
+    read_ahead_buffers_.push_back(std::move(buffer));
+  }
+  return record;
+}
+
+absl::StatusOr<std::string> CrossTrainerCacheDiskTier::ReadRecord(
+    const ReadAheadBuffer& buffer, size_t index) {
+  const size_t i = index - buffer.start_index;
+  const uint64_t begin = buffer.offsets[i];
+  const uint64_t end = i + 1 < buffer.offsets.size() ? buffer.offsets[i + 1]
+                                                     : buffer.data.size();
+  absl::string_view record =
+      absl::string_view(buffer.data).substr(begin, end - begin);
+  if (record.size() < kRecordHeaderSize ||
+      core::DecodeFixed32(record.data()) !=
+          record.size() - kRecordHeaderSize ||
+      crc32c::Unmask(core::DecodeFixed32(record.data() + sizeof(uint32_t))) !=
+          crc32c::Value(record.data() + kRecordHeaderSize,
+                        record.size() - kRecordHeaderSize)) {
+    return absl::DataLossError(absl::StrCat(
+        "Corrupted record of element ", index, " in tf.data service "
+        "cross-trainer cache file ", buffer.segment->filename, "."));
+  }
+  return std::string(record.substr(kRecordHeaderSize));
+}
+
+const std::shared_ptr<CrossTrainerCacheDiskTier::Segment>&
+CrossTrainerCacheDiskTier::FindSegment(size_t index) const
+    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  auto it = std::upper_bound(
+      segments_.begin(), segments_.end(), index,
+      [](size_t index, const std::shared_ptr<Segment>& segment) {
+        return index < segment->start_index;
+      });
+  return *std::prev(it);
+}
+
+void CrossTrainerCacheDiskTier::Clear() {
+  mutex_lock l(mu_);
+  ClearLocked();
+}
+
+void CrossTrainerCacheDiskTier::ClearLocked() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  segments_.clear();
+  read_ahead_buffers_.clear();
+  start_index_ = end_index_;
+  size_bytes_ = 0;
+}
+
+size_t CrossTrainerCacheDiskTier::start_index() const {
+  mutex_lock l(mu_);
+  return start_index_;
+}
+
+size_t CrossTrainerCacheDiskTier::end_index() const {
+  mutex_lock l(mu_);
+  return end_index_;
+}
+
+size_t CrossTrainerCacheDiskTier::size_bytes() const {
+  mutex_lock l(mu_);
+  return size_bytes_;
+}
+
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,167 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_SERVICE_CROSS_TRAINER_CACHE_DISK_TIER_H_
+#define TENSORFLOW_CORE_DATA_SERVICE_CROSS_TRAINER_CACHE_DISK_TIER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/file_system.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+namespace data {
+
+// Options of the disk tier of a `CrossTrainerCache`.
+struct CrossTrainerCacheDiskTierOptions {
+  // Directory of the log files, typically on a local SSD.
+  std::string directory;
+  // Approximate upper bound on the bytes of the log files. The oldest elements
+  // are dropped when the log grows larger.
+  size_t max_size_bytes = 0;
+  // Bytes read at once when an element is read from disk. Trainers read
+  // consecutive elements, so the following elements are usually served from
+  // the same read.
+  size_t read_ahead_bytes = size_t{4} << 20;  // 4MB
+};
+
+// The elements evicted from the memory of a `CrossTrainerCache`, stored in a
+// log on local disk.
+//
+// Elements are serialized into records and appended, in the order of their
+// indices, to the last of a sequence of segment files. When the log exceeds
+// `max_size_bytes`, the oldest segment is deleted, so the disk tier always
+// holds consecutive elements `[start_index(), end_index())`. Each record
+// carries a checksum, and corrupted records are reported as data loss.
+//
+// Reads fetch `read_ahead_bytes` of records following the requested one, and
+// keep them in a few read-ahead buffers, so that trainers reading the log
+// sequentially issue one read per `read_ahead_bytes`.
+//
+// Records are appended by a single writer, and can be read concurrently. The
+// segment files are deleted with the disk tier.
+class CrossTrainerCacheDiskTier {
+ public:
+  static absl::StatusOr<std::unique_ptr<CrossTrainerCacheDiskTier>> Create(
+      Env* env, const CrossTrainerCacheDiskTierOptions& options);
+
+  ~CrossTrainerCacheDiskTier() = default;
+
+  CrossTrainerCacheDiskTier(const CrossTrainerCacheDiskTier&) = delete;
+  CrossTrainerCacheDiskTier& operator=(const CrossTrainerCacheDiskTier&) =
+      delete;
+
+  // Appends the record of the element at `index`. Elements already on disk
+  // are not appended again. If `index` doesn't follow the last appended
+  // element, the disk tier is cleared first, so that it holds consecutive
+  // elements. Records larger than `max_size_bytes` are dropped.
+  absl::Status Append(size_t index, absl::string_view record);
+
+  // Returns the record of the element at `index`. Returns NotFound if the
+  // element isn't on disk.
+  absl::StatusOr<std::string> Read(size_t index);
+
+  // Drops all the elements.
+  void Clear();
+
+  // The disk tier holds the elements `[start_index(), end_index())`.
+  size_t start_index() const;
+  size_t end_index() const;
+
+  // The bytes of the segment files.
+  size_t size_bytes() const;
+
+ private:
+  // A segment file. The file is deleted with the last reference to the
+  // segment, so that it can be read while being dropped from the log.
+  struct Segment {
+    ~Segment();
+
+    Env* env = nullptr;
+    std::string filename;
+    // Set while records are appended to the segment.
+    std::unique_ptr<WritableFile> writer;
+    std::unique_ptr<RandomAccessFile> reader;
+    // The index of the first element of the segment.
+    size_t start_index = 0;
+    // `offsets[i]` is the offset of the record of element `start_index + i`.
+    std::vector<uint64_t> offsets;
+    uint64_t size_bytes = 0;
+
+    // Returns the offset at which the record following element `index` starts.
+    uint64_t RecordEnd(size_t index) const;
+  };
+
+  // Records read ahead from a segment.
+  struct ReadAheadBuffer {
+    std::shared_ptr<const Segment> segment;
+    // The buffer holds the records of the elements `[start_index, end_index)`.
+    size_t start_index = 0;
+    size_t end_index = 0;
+    // `offsets[i]` is the offset in `data` of the record of element
+    // `start_index + i`.
+    std::vector<uint64_t> offsets;
+    std::string data;
+  };
+
+  CrossTrainerCacheDiskTier(Env* env,
+                            const CrossTrainerCacheDiskTierOptions& options,
+                            std::string file_prefix);
+
+  // Adds a segment file starting at element `index`.
+  absl::Status AddSegment(size_t index) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Returns the segment holding element `index`.
+  // REQUIRES: start_index_ <= index < end_index_
+  const std::shared_ptr<Segment>& FindSegment(size_t index) const
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Returns the record of element `index` from `buffer`.
+  // REQUIRES: buffer.start_index <= index < buffer.end_index
+  static absl::StatusOr<std::string> ReadRecord(const ReadAheadBuffer& buffer,
+                                                size_t index);
+
+  void ClearLocked() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  Env* const env_;
+  const CrossTrainerCacheDiskTierOptions options_;
+  const std::string file_prefix_;
+  // Segments are sealed and a new one is started when they reach this size.
+  const uint64_t max_segment_size_bytes_;
+
+  mutable mutex mu_;
+  std::deque<std::shared_ptr<Segment>> segments_ TF_GUARDED_BY(mu_);
+  size_t start_index_ TF_GUARDED_BY(mu_) = 0;
+  size_t end_index_ TF_GUARDED_BY(mu_) = 0;
+  size_t size_bytes_ TF_GUARDED_BY(mu_) = 0;
+  int64_t next_segment_id_ TF_GUARDED_BY(mu_) = 0;
+  // The most recently filled read-ahead buffers.
+  std::deque<std::shared_ptr<const ReadAheadBuffer>> read_ahead_buffers_
+      TF_GUARDED_BY(mu_);
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_SERVICE_CROSS_TRAINER_CACHE_DISK_TIER_H_
@@ -0,0 +1,188 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/service/cross_trainer_cache_disk_tier.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "xla/tsl/platform/statusor.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/status_matchers.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+using ::testing::HasSubstr;
+using ::testing::SizeIs;
+
+std::string Record(size_t index) {
+  return absl::StrCat("Element ", index, std::string(index % 7, 'x'));
+}
+
+class CrossTrainerCacheDiskTierTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    directory_ = io::JoinPath(testing::TmpDir(),
+                              absl::StrCat("disk_tier_", random_id_++));
+  }
+
+  absl::StatusOr<std::unique_ptr<CrossTrainerCacheDiskTier>> CreateDiskTier(
+      size_t max_size_bytes, size_t read_ahead_bytes = 64) {
+    CrossTrainerCacheDiskTierOptions options;
+    options.directory = directory_;
+    options.max_size_bytes = max_size_bytes;
+    options.read_ahead_bytes = read_ahead_bytes;
+    return CrossTrainerCacheDiskTier::Create(Env::Default(), options);
+  }
+
+  std::vector<std::string> Files() {
+    std::vector<std::string> files;
+    EXPECT_TRUE(Env::Default()->GetChildren(directory_, &files).ok());
+    return files;
+  }
+
+  static inline int random_id_ = 0;
+  std::string directory_;
+};
+
+TEST_F(CrossTrainerCacheDiskTierTest, AppendAndRead) {
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<CrossTrainerCacheDiskTier> disk_tier,
+                          CreateDiskTier(/*max_size_bytes=*/1 << 20));
+  for (size_t i = 10; i < 100; ++i) {
+    TF_ASSERT_OK(disk_tier->Append(i, Record(i)));
+  }
+  EXPECT_EQ(disk_tier->start_index(), 10);
+  EXPECT_EQ(disk_tier->end_index(), 100);
+
+  // Sequential reads are served from the read-ahead buffers, random reads from
+  // the files.
+  for (size_t i = 10; i < 100; ++i) {
+    EXPECT_THAT(disk_tier->Read(i), absl_testing::IsOkAndHolds(Record(i)));
+  }
+  for (size_t i : {99, 10, 50, 51, 11}) {
+    EXPECT_THAT(disk_tier->Read(i), absl_testing::IsOkAndHolds(Record(i)));
+  }
+  EXPECT_THAT(disk_tier->Read(9),
+              absl_testing::StatusIs(absl::StatusCode::kNotFound));
+  EXPECT_THAT(disk_tier->Read(100),
+              absl_testing::StatusIs(absl::StatusCode::kNotFound));
+}
+
+TEST_F(CrossTrainerCacheDiskTierTest, DropsOldestElements) {
+  const size_t max_size_bytes = 2000;
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<CrossTrainerCacheDiskTier> disk_tier,
+                          CreateDiskTier(max_size_bytes));
+  for (size_t i = 0; i < 1000; ++i) {
+    TF_ASSERT_OK(disk_tier->Append(i, Record(i)));
+    EXPECT_LE(disk_tier->size_bytes(), max_size_bytes + max_size_bytes / 8);
+  }
+  EXPECT_GT(disk_tier->start_index(), 0);
+  EXPECT_EQ(disk_tier->end_index(), 1000);
+  EXPECT_THAT(Files(), SizeIs(testing::Le(9)));
+  for (size_t i = disk_tier->start_index(); i < 1000; ++i) {
+    EXPECT_THAT(disk_tier->Read(i), absl_testing::IsOkAndHolds(Record(i)));
+  }
+  EXPECT_THAT(disk_tier->Read(disk_tier->start_index() - 1),
+              absl_testing::StatusIs(absl::StatusCode::kNotFound));
+
+  disk_tier.reset();
+  EXPECT_THAT(Files(), SizeIs(0));
+}
+
+TEST_F(CrossTrainerCacheDiskTierTest, NonConsecutiveAppendClears) {
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<CrossTrainerCacheDiskTier> disk_tier,
+                          CreateDiskTier(/*max_size_bytes=*/1 << 20));
+  TF_ASSERT_OK(disk_tier->Append(0, Record(0)));
+  TF_ASSERT_OK(disk_tier->Append(1, Record(1)));
+  TF_ASSERT_OK(disk_tier->Append(5, Record(5)));
+  EXPECT_EQ(disk_tier->start_index(), 5);
+  EXPECT_EQ(disk_tier->end_index(), 6);
+  EXPECT_THAT(disk_tier->Read(1),
+              absl_testing::StatusIs(absl::StatusCode::kNotFound));
+  EXPECT_THAT(disk_tier->Read(5), absl_testing::IsOkAndHolds(Record(5)));
+
+  disk_tier->Clear();
+  EXPECT_EQ(disk_tier->size_bytes(), 0);
+  EXPECT_EQ(disk_tier->start_index(), disk_tier->end_index());
+  EXPECT_THAT(disk_tier->Read(5),
+              absl_testing::StatusIs(absl::StatusCode::kNotFound));
+}
+
+TEST_F(CrossTrainerCacheDiskTierTest, AppendingElementsOnDiskIsNoOp) {
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<CrossTrainerCacheDiskTier> disk_tier,
+                          CreateDiskTier(/*max_size_bytes=*/1 << 20));
+  for (size_t i = 0; i < 3; ++i) {
+    TF_ASSERT_OK(disk_tier->Append(i, Record(i)));
+  }
+  const size_t size_bytes = disk_tier->size_bytes();
+
+  // Retrying a spill appends elements that are already on disk.
+  TF_ASSERT_OK(disk_tier->Append(1, Record(1)));
+  TF_ASSERT_OK(disk_tier->Append(2, Record(2)));
+  EXPECT_EQ(disk_tier->size_bytes(), size_bytes);
+  TF_ASSERT_OK(disk_tier->Append(3, Record(3)));
+  EXPECT_EQ(disk_tier->start_index(), 0);
+  EXPECT_EQ(disk_tier->end_index(), 4);
+  for (size_t i = 0; i < 4; ++i) {
+    EXPECT_THAT(disk_tier->Read(i), absl_testing::IsOkAndHolds(Record(i)));
+  }
+}
+
+TEST_F(CrossTrainerCacheDiskTierTest, DropsRecordsLargerThanTheDiskTier) {
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<CrossTrainerCacheDiskTier> disk_tier,
+                          CreateDiskTier(/*max_size_bytes=*/100));
+  TF_ASSERT_OK(disk_tier->Append(0, Record(0)));
+  TF_ASSERT_OK(disk_tier->Append(1, std::string(200, 'x')));
+  EXPECT_EQ(disk_tier->start_index(), 2);
+  EXPECT_EQ(disk_tier->end_index(), 2);
+  TF_ASSERT_OK(disk_tier->Append(2, Record(2)));
+  EXPECT_THAT(disk_tier->Read(2), absl_testing::IsOkAndHolds(Record(2)));
+}
+
+TEST_F(CrossTrainerCacheDiskTierTest, CorruptedRecord) {
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<CrossTrainerCacheDiskTier> disk_tier,
+                          CreateDiskTier(/*max_size_bytes=*/1 << 20));
+  TF_ASSERT_OK(disk_tier->Append(0, Record(0)));
+  std::vector<std::string> files = Files();
+  ASSERT_THAT(files, SizeIs(1));
+  std::string path = io::JoinPath(directory_, files[0]);
+  std::string contents;
+  TF_ASSERT_OK(ReadFileToString(Env::Default(), path, &contents));
+  contents.back() ^= 1;
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), path, contents));
+  EXPECT_THAT(disk_tier->Read(0),
+              absl_testing::StatusIs(absl::StatusCode::kDataLoss,
+                                     HasSubstr("Corrupted record")));
+}
+
+TEST_F(CrossTrainerCacheDiskTierTest, InvalidOptions) {
+  EXPECT_THAT(CreateDiskTier(/*max_size_bytes=*/0),
+              absl_testing::StatusIs(absl::StatusCode::kInvalidArgument));
+  directory_ = "";
+  EXPECT_THAT(CreateDiskTier(/*max_size_bytes=*/1 << 20),
+              absl_testing::StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
@@ -22,14 +22,19 @@ limitations under the License.
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/memory/memory.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "absl/time/time.h"
+#include "tensorflow/core/data/service/cross_trainer_cache_disk_tier.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/lib/monitoring/cell_reader.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/path.h"
 #include "tensorflow/core/platform/random.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/status_matchers.h"
@@ -61,6 +66,35 @@ class InfiniteRange : public CachableSequence<int64_t> {
   int64_t next_ = 0;
 };
 
+class SpillableInfiniteRange : public InfiniteRange {
+ public:
+  absl::StatusOr<std::string> SerializeElement(
+      const int64_t& element) const override {
+    return absl::StrCat(element);
+  }
+
+  absl::StatusOr<int64_t> DeserializeElement(
+      absl::string_view serialized) const override {
+    int64_t element;
+    if (!absl::SimpleAtoi(serialized, &element)) {
+      return absl::DataLossError(absl::StrCat("Invalid element ", serialized));
+    }
+    return element;
+  }
+};
+
+std::unique_ptr<CrossTrainerCacheDiskTier> CreateDiskTier(
+    size_t max_size_bytes) {
+  CrossTrainerCacheDiskTierOptions options;
+  options.directory = io::JoinPath(testing::TmpDir(),
+                                   absl::StrCat("disk_tier_", random::New64()));
+  options.max_size_bytes = max_size_bytes;
+  options.read_ahead_bytes = 64;
+  auto disk_tier = CrossTrainerCacheDiskTier::Create(Env::Default(), options);
+  TF_CHECK_OK(disk_tier.status());
+  return *std::move(disk_tier);
+}
+
 class TensorDataset : public CachableSequence<Tensor> {
  public:
   absl::StatusOr<Tensor> GetNext() override { return Tensor("Test Tensor"); }
@@ -312,6 +346,74 @@ TEST(CrossTrainerCacheTest, CacheSizeMetrics) {
   }
 }
 
+TEST(CrossTrainerCacheTest, SlowTrainersReadFromDisk) {
+  CellReader<int64_t> cell_reader(
+      "/tensorflow/data/service/cross_trainer_cache_tier_queries");
+  CrossTrainerCache<int64_t> cache(
+      /*max_cache_size_bytes=*/5 * sizeof(int64_t),
+      std::make_unique<SpillableInfiniteRange>(),
+      CreateDiskTier(/*max_size_bytes=*/1 << 20));
+  for (size_t i = 0; i < 100; ++i) {
+    EXPECT_THAT(cache.Get("Fast trainer"),
+                absl_testing::IsOkAndHolds(Pointee(i)));
+  }
+  EXPECT_EQ(cell_reader.Delta("memory", "miss"), 100);
+  EXPECT_EQ(cell_reader.Delta("disk", "hit"), 0);
+
+  // The slow trainer reads the elements evicted from memory from disk, then
+  // the elements in memory.
+  for (size_t i = 0; i < 100; ++i) {
+    EXPECT_THAT(cache.Get("Slow trainer"),
+                absl_testing::IsOkAndHolds(Pointee(i)));
+  }
+  EXPECT_EQ(cell_reader.Delta("memory", "hit"), 5);
+  EXPECT_EQ(cell_reader.Delta("memory", "miss"), 95);
+  EXPECT_EQ(cell_reader.Delta("disk", "hit"), 95);
+  EXPECT_EQ(cell_reader.Delta("disk", "miss"), 0);
+}
+
+TEST(CrossTrainerCacheTest, SlowTrainersSkipDataDroppedFromDisk) {
+  CrossTrainerCache<int64_t> cache(
+      /*max_cache_size_bytes=*/5 * sizeof(int64_t),
+      std::make_unique<SpillableInfiniteRange>(),
+      CreateDiskTier(/*max_size_bytes=*/256));
+  for (size_t i = 0; i < 1000; ++i) {
+    EXPECT_THAT(cache.Get("Fast trainer"),
+                absl_testing::IsOkAndHolds(Pointee(i)));
+  }
+
+  // The slow trainer skips the elements dropped from disk, and reads the
+  // remaining elements in order.
+  std::vector<int64_t> elements;
+  for (size_t i = 0; i < 20; ++i) {
+    TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<const int64_t> element,
+                            cache.Get("Slow trainer"));
+    elements.push_back(*element);
+  }
+  EXPECT_GT(elements.front(), 0);
+  EXPECT_LT(elements.front(), 995);
+  for (size_t i = 1; i < elements.size(); ++i) {
+    EXPECT_EQ(elements[i], elements[i - 1] + 1);
+  }
+}
+
+TEST(CrossTrainerCacheTest, UnspillableElementsAreNotSpilled) {
+  CellReader<int64_t> cell_reader(
+      "/tensorflow/data/service/cross_trainer_cache_disk_size_bytes");
+  CrossTrainerCache<int64_t> cache(
+      /*max_cache_size_bytes=*/5 * sizeof(int64_t),
+      std::make_unique<InfiniteRange>(),
+      CreateDiskTier(/*max_size_bytes=*/1 << 20));
+  for (size_t i = 0; i < 100; ++i) {
+    EXPECT_THAT(cache.Get("Fast trainer"),
+                absl_testing::IsOkAndHolds(Pointee(i)));
+  }
+  EXPECT_EQ(cell_reader.Read(), 0);
+  // Like without a disk tier, the slow trainer skips the evicted elements.
+  EXPECT_THAT(cache.Get("Slow trainer"),
+              absl_testing::IsOkAndHolds(Pointee(95)));
+}
+
 TEST(CrossTrainerCacheTest, ConcurrentReaders) {
   size_t num_trainers = 10;
   size_t num_elements_to_read = 200;
@@ -22,6 +22,8 @@ limitations under the License.
 #include <vector>
 
 #include "absl/strings/str_join.h"
+#include "tensorflow/core/data/compression_utils.h"
+#include "tensorflow/core/framework/dataset.pb.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/framework/variant.h"
@@ -82,6 +84,11 @@ size_t GetElementResult::EstimatedMemoryUsageBytes() const {
   return size_bytes;
 }
 
+std::vector<CompressionCodec> DataTransferClient::SupportedCompressionCodecs()
+    const {
+  return data::SupportedCompressionCodecs();
+}
+
 void DataTransferServer::Register(std::string name, ServerFactoryT factory) {
   mutex_lock l(*get_lock());
   if (!transfer_server_factories().insert({name, factory}).second) {
@@ -105,6 +105,12 @@ class DataTransferClient {
     return absl::OkStatus();
   }
 
+  // Returns the codecs of compressed elements which the client can hand to its
+  // consumer. They are sent to the server with each request, and the server
+  // recompresses elements compressed with other codecs. By default, these are
+  // all codecs supported by `UncompressElement`.
+  virtual std::vector<CompressionCodec> SupportedCompressionCodecs() const;
+
  protected:
   Env* const env_ = Env::Default();
 };
@@ -29,11 +29,13 @@ limitations under the License.
 #include "absl/types/optional.h"
 #include "xla/tsl/platform/errors.h"
 #include "xla/tsl/platform/statusor.h"
+#include "tensorflow/core/data/compression_utils.h"
 #include "tensorflow/core/data/rewrite_utils.h"
 #include "tensorflow/core/data/service/common.h"
 #include "tensorflow/core/data/service/common.pb.h"
 #include "tensorflow/core/data/service/url.h"
 #include "tensorflow/core/framework/dataset_options.pb.h"
+#include "tensorflow/core/framework/function.pb.h"
 #include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/framework/types.pb.h"
@@ -64,6 +66,9 @@ using ::tensorflow::data::experimental::AutoShardDatasetOp;
 // optimizations to the same graph (see b/303524867).
 constexpr bool kApplyGeneralGrapplerOptimizations = false;
 
+constexpr char kCompressElementOp[] = "CompressElement";
+constexpr char kCompressionAttr[] = "compression";
+
 // A dynamic port has form %port% or %port_foo% that is to be replaced with the
 // actual port.
 bool HasDynamicPort(absl::string_view address) {
@@ -122,6 +127,28 @@ RemoveCompressionMapRewriter::GetRewriteConfig() const {
   return config;
 }
 
+absl::StatusOr<GraphDef> ApplyCompressionOptionsRewrite(
+    const GraphDef& graph_def, absl::string_view compression) {
+  TF_RETURN_IF_ERROR(ParseCompressionOptions(compression).status());
+  GraphDef rewritten_graph = graph_def;
+  auto rewrite_node = [compression](NodeDef& node) {
+    if (node.op() == kCompressElementOp) {
+      (*node.mutable_attr())[kCompressionAttr].set_s(std::string(compression));
+    }
+  };
+  for (NodeDef& node : *rewritten_graph.mutable_node()) {
+    rewrite_node(node);
+  }
+  // The compression map function is in the function library.
+  for (FunctionDef& function :
+       *rewritten_graph.mutable_library()->mutable_function()) {
+    for (NodeDef& node : *function.mutable_node_def()) {
+      rewrite_node(node);
+    }
+  }
+  return rewritten_graph;
+}
+
 absl::StatusOr<AutoShardRewriter> AutoShardRewriter::Create(
     const TaskDef& task_def) {
   TF_ASSIGN_OR_RETURN(
@@ -42,6 +42,12 @@ class RemoveCompressionMapRewriter {
   tensorflow::RewriterConfig::CustomGraphOptimizer GetRewriteConfig() const;
 };
 
+// Returns `graph_def` with its compression map compressing elements with the
+// `compression` options (see `ParseCompressionOptions`) instead of the default
+// snappy compression. Returns an error if `compression` is invalid.
+absl::StatusOr<GraphDef> ApplyCompressionOptionsRewrite(
+    const GraphDef& graph_def, absl::string_view compression);
+
 // Rewrites the dataset graph by applying an auto-shard policy.
 class AutoShardRewriter {
  public:
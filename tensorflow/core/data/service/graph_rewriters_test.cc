@@ -21,6 +21,7 @@ limitations under the License.
 #include "tensorflow/core/data/service/common.pb.h"
 #include "tensorflow/core/data/service/test_util.h"
 #include "tensorflow/core/framework/dataset_options.pb.h"
+#include "tensorflow/core/framework/function.pb.h"
 #include "tensorflow/core/framework/function_testlib.h"
 #include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/node_def.pb.h"
@@ -216,6 +217,30 @@ TEST(AutoShardRewriterTest, WorkerIndexOutOfRange) {
                              "index should be >= 0 and < 2, currently 5"));
 }
 
+GraphDef CompressionMapGraph() {
+  GraphDef graph_def;
+  FunctionDef* function = graph_def.mutable_library()->add_function();
+  function->mutable_signature()->set_name("compress");
+  NodeDef* node = function->add_node_def();
+  node->set_name("compress_element");
+  node->set_op("CompressElement");
+  return graph_def;
+}
+
+TEST(CompressionOptionsRewriteTest, SetsCompressionOptions) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      GraphDef rewritten_graph,
+      ApplyCompressionOptionsRewrite(CompressionMapGraph(), "adaptive:zstd:1"));
+  const NodeDef& node = rewritten_graph.library().function(0).node_def(0);
+  EXPECT_EQ(node.attr().at("compression").s(), "adaptive:zstd:1");
+}
+
+TEST(CompressionOptionsRewriteTest, InvalidCompressionOptions) {
+  EXPECT_THAT(ApplyCompressionOptionsRewrite(CompressionMapGraph(), "lz4"),
+              absl_testing::StatusIs(error::INVALID_ARGUMENT,
+                                     HasSubstr("unknown codec")));
+}
+
 TEST(WorkerIndexResolverTest, AddOneWorker) {
   WorkerIndexResolver resolver(std::vector<std::string>{"localhost"});
   EXPECT_THAT(resolver.GetWorkerIndex("localhost:12345"),
@@ -17,23 +17,33 @@ limitations under the License.
 #include <algorithm>
 #include <memory>
 #include <optional>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "tensorflow/core/data/metric_utils.h"
 #include "tensorflow/core/data/service/byte_size.h"
 #include "tensorflow/core/data/service/common.h"
 #include "tensorflow/core/data/service/cross_trainer_cache.h"
+#include "tensorflow/core/data/service/cross_trainer_cache_disk_tier.h"
 #include "tensorflow/core/data/service/data_transfer.h"
 #include "tensorflow/core/data/service/thread_safe_buffer.h"
 #include "tensorflow/core/data/service/worker.pb.h"
 #include "tensorflow/core/data/standalone.h"
 #include "tensorflow/core/framework/cancellation.h"
 #include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/framework/dataset.pb.h"
 #include "tensorflow/core/framework/model.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/tensor_util.h"
 #include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/framework/variant.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
@@ -50,6 +60,8 @@ namespace {
 constexpr int64_t kWaitBeforeSkipUs = 100 * 1000;  // 100ms.
 constexpr size_t kDefaultCrossTrainerCacheSizeBytes =
     10 * (size_t{1} << 30);  // 10GB
+constexpr size_t kDefaultCrossTrainerCacheDiskSizeBytes =
+    100 * (size_t{1} << 30);  // 100GB
 
 }  // namespace
 
@@ -116,8 +128,21 @@ absl::Status TaskRunner::Create(const experimental::WorkerConfig& worker_config,
         worker_config.cross_trainer_cache_size_bytes() > 0
             ? worker_config.cross_trainer_cache_size_bytes()
             : kDefaultCrossTrainerCacheSizeBytes;
-    out = std::make_unique<CachingTaskRunner>(std::move(iterator),
-                                              max_cache_size_bytes);
+    std::unique_ptr<CrossTrainerCacheDiskTier> disk_tier;
+    if (!worker_config.cross_trainer_cache_disk_directory().empty()) {
+      CrossTrainerCacheDiskTierOptions disk_tier_options;
+      disk_tier_options.directory =
+          worker_config.cross_trainer_cache_disk_directory();
+      disk_tier_options.max_size_bytes =
+          worker_config.cross_trainer_cache_disk_size_bytes() > 0
+              ? worker_config.cross_trainer_cache_disk_size_bytes()
+              : kDefaultCrossTrainerCacheDiskSizeBytes;
+      TF_ASSIGN_OR_RETURN(
+          disk_tier,
+          CrossTrainerCacheDiskTier::Create(Env::Default(), disk_tier_options));
+    }
+    out = std::make_unique<CachingTaskRunner>(
+        std::move(iterator), max_cache_size_bytes, std::move(disk_tier));
   } else {
     out = std::make_unique<FirstComeFirstServedTaskRunner>(std::move(iterator));
   }
@@ -200,9 +225,16 @@ std::shared_ptr<model::Model> FirstComeFirstServedTaskRunner::model() const {
 
 CachingTaskRunner::CachingTaskRunner(std::unique_ptr<TaskIterator> iterator,
                                      size_t max_cache_size_bytes)
+    : CachingTaskRunner(std::move(iterator), max_cache_size_bytes,
+                        /*disk_tier=*/nullptr) {}
+
+CachingTaskRunner::CachingTaskRunner(
+    std::unique_ptr<TaskIterator> iterator, size_t max_cache_size_bytes,
+    std::unique_ptr<CrossTrainerCacheDiskTier> disk_tier)
     : fcfs_task_runner_(std::move(iterator)),
       cache_(max_cache_size_bytes,
-             std::make_unique<GetElementResultSequence>(fcfs_task_runner_)) {
+             std::make_unique<GetElementResultSequence>(fcfs_task_runner_),
+             std::move(disk_tier)) {
   LOG(INFO) << "Initialized tf.data service cross-trainer cache with "
             << ByteSize::Bytes(max_cache_size_bytes) << " of memory.";
 }
@@ -238,6 +270,70 @@ size_t CachingTaskRunner::GetElementResultSequence::GetElementSizeBytes(
   return element.EstimatedMemoryUsageBytes();
 }
 
+absl::StatusOr<std::string>
+CachingTaskRunner::GetElementResultSequence::SerializeElement(
+    const GetElementResult& element) const {
+  // Elements are stored like in worker responses: compressed elements as is,
+  // and other elements as TensorProtos.
+  GetElementResponse response;
+  response.set_element_index(element.element_index);
+  response.set_end_of_sequence(element.end_of_sequence);
+  response.set_skip_task(element.skip);
+  const CompressedElement* compressed = nullptr;
+  if (element.components.size() == 1 &&
+      element.components[0].dtype() == DT_VARIANT &&
+      TensorShapeUtils::IsScalar(element.components[0].shape())) {
+    compressed =
+        element.components[0].scalar<Variant>()().get<CompressedElement>();
+  }
+  if (compressed != nullptr) {
+    *response.mutable_compressed() = *compressed;
+  } else {
+    UncompressedElement* uncompressed = response.mutable_uncompressed();
+    for (const Tensor& component : element.components) {
+      component.AsProtoTensorContent(uncompressed->add_components());
+    }
+  }
+  std::string serialized;
+  if (!response.SerializeToString(&serialized)) {
+    return absl::InternalError(absl::StrCat(
+        "Failed to serialize tf.data service element ", element.element_index,
+        " for the cross-trainer cache."));
+  }
+  return serialized;
+}
+
+absl::StatusOr<GetElementResult>
+CachingTaskRunner::GetElementResultSequence::DeserializeElement(
+    absl::string_view serialized) const {
+  GetElementResponse response;
+  if (!response.ParseFromString(serialized)) {
+    return absl::DataLossError(
+        "Failed to parse tf.data service element from the cross-trainer "
+        "cache.");
+  }
+  GetElementResult result;
+  result.element_index = response.element_index();
+  result.end_of_sequence = response.end_of_sequence();
+  result.skip = response.skip_task();
+  if (response.has_compressed()) {
+    Tensor tensor(DT_VARIANT, TensorShape{});
+    tensor.scalar<Variant>()() = std::move(*response.mutable_compressed());
+    result.components.push_back(std::move(tensor));
+    return result;
+  }
+  for (const TensorProto& proto : response.uncompressed().components()) {
+    Tensor tensor;
+    if (!tensor.FromProto(proto)) {
+      return absl::DataLossError(
+          "Failed to parse tf.data service element component from the "
+          "cross-trainer cache.");
+    }
+    result.components.push_back(std::move(tensor));
+  }
+  return result;
+}
+
 void CachingTaskRunner::Cancel() {
   VLOG(2) << "Cancelling tf.data service cross-trainer cache task.";
   if (!cache_.IsCancelled()) {
@@ -78,7 +78,16 @@ CreateDataServiceWorkerClient(
 absl::Status DataServiceWorkerClient::GetElement(const GetElementRequest& req,
                                                  GetElementResult& result) {
   TF_RETURN_IF_ERROR(EnsureInitialized());
-  return client_->GetElement(req, result);
+  if (!req.accepted_compression_codecs().empty()) {
+    return client_->GetElement(req, result);
+  }
+  // Lets the worker know which codecs the client supports, so that it can
+  // choose how to compress elements.
+  GetElementRequest request = req;
+  for (CompressionCodec codec : client_->SupportedCompressionCodecs()) {
+    request.add_accepted_compression_codecs(codec);
+  }
+  return client_->GetElement(request, result);
 }
 
 absl::Status DataServiceWorkerClient::EnsureInitialized() {
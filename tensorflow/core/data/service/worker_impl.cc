@@ -34,6 +34,7 @@ limitations under the License.
 #include "xla/tsl/platform/status_to_from_proto.h"
 #include "xla/tsl/platform/statusor.h"
 #include "xla/tsl/protobuf/status.pb.h"
+#include "tensorflow/core/data/compression_utils.h"
 #include "tensorflow/core/data/service/byte_size.h"
 #include "tensorflow/core/data/service/common.h"
 #include "tensorflow/core/data/service/common.pb.h"
@@ -56,6 +57,8 @@ limitations under the License.
 #include "tensorflow/core/framework/model.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/variant.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/env_time.h"
@@ -105,6 +108,45 @@ absl::Status MoveElementToResponse(std::vector<Tensor>&& element,
   return absl::OkStatus();
 }
 
+// Returns true if the client which sent `request` can uncompress `compressed`.
+// Clients which don't list the codecs they accept predate codecs other than
+// snappy, and can only uncompress version 0 elements.
+bool ClientCanUncompress(const GetElementRequest& request,
+                         const CompressedElement& compressed) {
+  if (request.accepted_compression_codecs().empty()) {
+    return compressed.version() == 0;
+  }
+  return absl::c_linear_search(request.accepted_compression_codecs(),
+                               compressed.codec());
+}
+
+// Recompresses the element in `result` with snappy if the client which sent
+// `request` can't uncompress it.
+absl::Status RecompressForClient(const GetElementRequest& request,
+                                 struct GetElementResult& result) {
+  if (result.components.size() != 1 ||
+      result.components[0].dtype() != DT_VARIANT ||
+      !TensorShapeUtils::IsScalar(result.components[0].shape())) {
+    return absl::OkStatus();
+  }
+  const CompressedElement* compressed =
+      result.components[0].scalar<Variant>()().get<CompressedElement>();
+  if (compressed == nullptr || ClientCanUncompress(request, *compressed)) {
+    return absl::OkStatus();
+  }
+  std::vector<Tensor> element;
+  TF_RETURN_IF_ERROR(UncompressElement(*compressed, &element));
+  CompressedElement recompressed;
+  TF_RETURN_IF_ERROR(CompressElement(element, &recompressed));
+  // The components may be shared with the cross-trainer cache, so they are
+  // replaced instead of modified.
+  Tensor tensor(DT_VARIANT, TensorShape{});
+  tensor.scalar<Variant>()() = std::move(recompressed);
+  result.components[0] = std::move(tensor);
+  metrics::RecordTFDataServiceCompressionAction("recompressed_for_client");
+  return absl::OkStatus();
+}
+
 WorkerConfig ApplyWorkerDefaults(const WorkerConfig& config) {
   WorkerConfig new_config(config);
   if (new_config.heartbeat_interval_ms() == 0) {
@@ -238,6 +280,9 @@ absl::Status DataServiceWorkerImpl::ValidateWorkerConfig() const {
                                    config_.worker_tags().end(), ", "),
                      "}"));
   }
+  TF_RETURN_WITH_CONTEXT_IF_ERROR(
+      ParseCompressionOptions(config_.data_transfer_compression()).status(),
+      "Invalid worker config data_transfer_compression");
   return absl::OkStatus();
 }
 
@@ -302,6 +347,9 @@ absl::Status DataServiceWorkerImpl::GetElementResult(
   });
   TF_RETURN_IF_ERROR(EnsureTaskInitialized(*task));
   TF_RETURN_IF_ERROR(task->task_runner->GetNext(*request, *result));
+  if (!result->end_of_sequence && !result->skip) {
+    TF_RETURN_IF_ERROR(RecompressForClient(*request, *result));
+  }
 
   if (result->end_of_sequence) {
     mutex_lock l(mu_);
@@ -426,6 +474,9 @@ DataServiceWorkerImpl::MakeDataset(const DatasetDef& dataset_def,
     TF_ASSIGN_OR_RETURN(
         graph, remove_compression_map_rewriter.ApplyRemoveCompressionMapRewrite(
                    graph));
+  } else if (!config_.data_transfer_compression().empty()) {
+    TF_ASSIGN_OR_RETURN(graph, ApplyCompressionOptionsRewrite(
+                                   graph, config_.data_transfer_compression()));
   }
   TF_ASSIGN_OR_RETURN(AutoShardRewriter auto_shard_rewriter,
                       AutoShardRewriter::Create(task_def));
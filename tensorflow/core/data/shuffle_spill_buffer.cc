@@ -0,0 +1,415 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/shuffle_spill_buffer.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/log/log.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/data/compression_utils.h"
+#include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/framework/dataset.pb.h"
+#include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/lib/core/coding.h"
+#include "tensorflow/core/lib/hash/crc32c.h"
+#include "tensorflow/core/lib/random/random.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+constexpr char kSpillDirEnvVar[] = "TF_DATA_SHUFFLE_SPILL_DIR";
+constexpr char kSpillMemoryMbEnvVar[] = "TF_DATA_SHUFFLE_SPILL_MEMORY_MB";
+constexpr char kSpillCompressEnvVar[] = "TF_DATA_SHUFFLE_SPILL_COMPRESS";
+
+// Each record ends with the masked CRC32C of the serialized element.
+constexpr int64_t kChecksumSize = sizeof(uint32_t);
+
+}  // namespace
+
+absl::StatusOr<ShuffleSpillOptions> ShuffleSpillOptions::FromEnvironment() {
+  ShuffleSpillOptions options;
+  TF_RETURN_IF_ERROR(
+      ReadStringFromEnvVar(kSpillDirEnvVar, "", &options.directory));
+  int64_t memory_mb;
+  TF_RETURN_IF_ERROR(ReadInt64FromEnvVar(
+      kSpillMemoryMbEnvVar, options.memory_budget_bytes >> 20, &memory_mb));
+  if (memory_mb < 0) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        kSpillMemoryMbEnvVar, " must be non-negative, got ", memory_mb));
+  }
+  options.memory_budget_bytes = memory_mb << 20;
+  TF_RETURN_IF_ERROR(
+      ReadBoolFromEnvVar(kSpillCompressEnvVar, false, &options.compress));
+  return options;
+}
+
+absl::StatusOr<std::unique_ptr<ShuffleSpillBuffer>> ShuffleSpillBuffer::Create(
+    Env* env, const ShuffleSpillOptions& options, int64_t size) {
+  TF_RETURN_IF_ERROR(env->RecursivelyCreateDir(options.directory));
+  std::string file_prefix =
+      io::JoinPath(options.directory, absl::StrCat("shuffle_spill_",
+                                                   env->NowMicros(), "_",
+                                                   random::New64()));
+  return absl::WrapUnique(
+      new ShuffleSpillBuffer(env, options, std::move(file_prefix), size));
+}
+
+ShuffleSpillBuffer::ShuffleSpillBuffer(Env* env,
+                                       const ShuffleSpillOptions& options,
+                                       std::string file_prefix, int64_t size)
+    : env_(env),
+      options_(options),
+      file_prefix_(std::move(file_prefix)),
+      slots_(size) {}
+
+ShuffleSpillBuffer::~ShuffleSpillBuffer() { Reset(0); }
+
+void ShuffleSpillBuffer::Reset(int64_t size) {
+  for (const auto& [id, run] : runs_) {
+    absl::Status s = env_->DeleteFile(run->filename);
+    if (!s.ok()) {
+      LOG(WARNING) << "Failed to delete shuffle spill file " << run->filename
+                   << ": " << s;
+    }
+  }
+  runs_.clear();
+  slots_.clear();
+  slots_.resize(size);
+  memory_bytes_ = 0;
+  spilled_in_memory_.clear();
+  unspilled_.clear();
+}
+
+void ShuffleSpillBuffer::Resize(int64_t size) {
+  for (int64_t i = size; i < slots_.size(); ++i) {
+    Clear(i);
+  }
+  slots_.resize(size);
+}
+
+absl::Status ShuffleSpillBuffer::Set(int64_t index,
+                                     std::vector<Tensor> element) {
+  Clear(index);
+  Slot& slot = slots_[index];
+  slot.bytes = GetTotalBytes(element);
+  slot.element = std::move(element);
+  slot.in_memory = true;
+  memory_bytes_ += slot.bytes;
+  unspilled_.push_back(index);
+  return EnforceBudget();
+}
+
+absl::Status ShuffleSpillBuffer::Append(std::vector<Tensor> element) {
+  slots_.emplace_back();
+  return Set(slots_.size() - 1, std::move(element));
+}
+
+absl::Status ShuffleSpillBuffer::Take(int64_t index,
+                                      std::vector<Tensor>* element) {
+  Slot& slot = slots_[index];
+  if (!slot.in_memory && slot.record.has_value()) {
+    TF_RETURN_IF_ERROR(Load(index));
+  }
+  // The elements read along with this one may exceed the budget. It is
+  // enforced while the slot looks empty, so that this element is neither
+  // spilled nor dropped, and the slot is restored if that fails.
+  const bool in_memory = slot.in_memory;
+  if (in_memory) {
+    memory_bytes_ -= slot.bytes;
+    slot.in_memory = false;
+  }
+  absl::Status status = EnforceBudget();
+  if (!status.ok()) {
+    if (in_memory) {
+      memory_bytes_ += slot.bytes;
+      slot.in_memory = true;
+      (slot.record.has_value() ? spilled_in_memory_ : unspilled_)
+          .push_back(index);
+    }
+    return status;
+  }
+  *element = std::move(slot.element);
+  Clear(index);
+  return absl::OkStatus();
+}
+
+absl::Status ShuffleSpillBuffer::Get(int64_t index,
+                                     std::vector<Tensor>* element) {
+  const Slot& slot = slots_[index];
+  if (slot.in_memory || !slot.record.has_value()) {
+    *element = slot.element;
+    return absl::OkStatus();
+  }
+  const Run& run = *runs_.at(slot.record->run);
+  std::string scratch;
+  absl::string_view data;
+  TF_RETURN_IF_ERROR(ReadRecords(run, slot.record->index,
+                                 slot.record->index + 1, &scratch, &data));
+  return ParseRecord(data, element);
+}
+
+void ShuffleSpillBuffer::Swap(int64_t i, int64_t j) {
+  if (i == j) {
+    return;
+  }
+  std::swap(slots_[i], slots_[j]);
+  for (int64_t index : {i, j}) {
+    const Slot& slot = slots_[index];
+    if (slot.record.has_value()) {
+      runs_.at(slot.record->run)->slots[slot.record->index] = index;
+    }
+    if (slot.in_memory) {
+      (slot.record.has_value() ? spilled_in_memory_ : unspilled_)
+          .push_back(index);
+    }
+  }
+  // The queues may contain stale and duplicate indices. Rebuild them before
+  // they outgrow the buffer.
+  if (spilled_in_memory_.size() + unspilled_.size() > 2 * slots_.size() + 64) {
+    spilled_in_memory_.clear();
+    unspilled_.clear();
+    for (int64_t index = 0; index < slots_.size(); ++index) {
+      const Slot& slot = slots_[index];
+      if (slot.in_memory) {
+        (slot.record.has_value() ? spilled_in_memory_ : unspilled_)
+            .push_back(index);
+      }
+    }
+  }
+}
+
+void ShuffleSpillBuffer::Clear(int64_t index) {
+  Slot& slot = slots_[index];
+  if (slot.in_memory) {
+    memory_bytes_ -= slot.bytes;
+  }
+  if (slot.record.has_value()) {
+    auto it = runs_.find(slot.record->run);
+    Run& run = *it->second;
+    run.slots[slot.record->index] = -1;
+    if (--run.num_live == 0) {
+      absl::Status s = env_->DeleteFile(run.filename);
+      if (!s.ok()) {
+        LOG(WARNING) << "Failed to delete shuffle spill file " << run.filename
+                     << ": " << s;
+      }
+      runs_.erase(it);
+    }
+  }
+  slot = Slot();
+}
+
+absl::Status ShuffleSpillBuffer::Load(int64_t index) {
+  const Record record = *slots_[index].record;
+  const Run& run = *runs_.at(record.run);
+  const uint64_t begin_offset = run.offsets[record.index];
+  int64_t end = record.index + 1;
+  while (end < run.slots.size() &&
+         run.offsets[end + 1] - begin_offset <= options_.read_batch_bytes) {
+    ++end;
+  }
+  std::string scratch;
+  absl::string_view data;
+  TF_RETURN_IF_ERROR(ReadRecords(run, record.index, end, &scratch, &data));
+
+  for (int64_t i = record.index; i < end; ++i) {
+    const int64_t slot_index = run.slots[i];
+    if (slot_index < 0 || slots_[slot_index].in_memory) {
+      continue;
+    }
+    const absl::string_view bytes =
+        data.substr(run.offsets[i] - begin_offset,
+                    run.offsets[i + 1] - run.offsets[i]);
+    if (i != record.index &&
+        memory_bytes_ + static_cast<int64_t>(bytes.size()) >
+            options_.memory_budget_bytes) {
+      break;
+    }
+    Slot& slot = slots_[slot_index];
+    TF_RETURN_IF_ERROR(ParseRecord(bytes, &slot.element));
+    slot.in_memory = true;
+    slot.bytes = GetTotalBytes(slot.element);
+    memory_bytes_ += slot.bytes;
+    if (i != record.index) {
+      spilled_in_memory_.push_back(slot_index);
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ShuffleSpillBuffer::EnforceBudget() {
+  while (memory_bytes_ > options_.memory_budget_bytes) {
+    if (!spilled_in_memory_.empty()) {
+      const int64_t index = spilled_in_memory_.front();
+      spilled_in_memory_.pop_front();
+      if (index >= slots_.size()) {
+        continue;
+      }
+      Slot& slot = slots_[index];
+      if (slot.in_memory && slot.record.has_value()) {
+        memory_bytes_ -= slot.bytes;
+        slot.element.clear();
+        slot.in_memory = false;
+      }
+      continue;
+    }
+    if (unspilled_.empty()) {
+      break;
+    }
+    TF_RETURN_IF_ERROR(WriteRun());
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ShuffleSpillBuffer::WriteRun() {
+  std::vector<int64_t> indices;
+  for (int64_t index : unspilled_) {
+    if (index < slots_.size() && slots_[index].in_memory &&
+        !slots_[index].record.has_value()) {
+      indices.push_back(index);
+      // Marks the slot so that duplicate indices are skipped.
+      slots_[index].record = Record();
+    }
+  }
+  for (int64_t index : indices) {
+    slots_[index].record.reset();
+  }
+  unspilled_.clear();
+  if (indices.empty()) {
+    return absl::OkStatus();
+  }
+
+  const int64_t run_id = next_run_++;
+  auto run = std::make_unique<Run>();
+  run->filename = absl::StrCat(file_prefix_, "_", run_id);
+  absl::Status status = [&]() -> absl::Status {
+    std::unique_ptr<WritableFile> file;
+    TF_RETURN_IF_ERROR(env_->NewWritableFile(run->filename, &file));
+    std::string record;
+    uint64_t offset = 0;
+    run->offsets.push_back(offset);
+    for (int64_t index : indices) {
+      TF_RETURN_IF_ERROR(SerializeRecord(slots_[index].element, &record));
+      TF_RETURN_IF_ERROR(file->Append(record));
+      offset += record.size();
+      run->offsets.push_back(offset);
+    }
+    TF_RETURN_IF_ERROR(file->Close());
+    return env_->NewRandomAccessFile(run->filename, &run->file);
+  }();
+  if (!status.ok()) {
+    // Keeps the elements in memory, so that a later run can retry.
+    unspilled_.assign(indices.begin(), indices.end());
+    env_->DeleteFile(run->filename).IgnoreError();
+    return status;
+  }
+
+  for (int64_t i = 0; i < indices.size(); ++i) {
+    slots_[indices[i]].record = Record{run_id, i};
+    run->slots.push_back(indices[i]);
+    spilled_in_memory_.push_back(indices[i]);
+  }
+  run->num_live = indices.size();
+  runs_[run_id] = std::move(run);
+  return absl::OkStatus();
+}
+
+absl::Status ShuffleSpillBuffer::ReadRecords(const Run& run, int64_t begin,
+                                             int64_t end, std::string* scratch,
+                                             absl::string_view* data) {
+  const uint64_t offset = run.offsets[begin];
+  const uint64_t n = run.offsets[end] - offset;
+  scratch->resize(n);
+  TF_RETURN_IF_ERROR(run.file->Read(offset, n, data, scratch->data()));
+  if (data->size() != n) {
+    return absl::DataLossError(absl::StrCat(
+        "Truncated shuffle spill file ", run.filename, ": read ", data->size(),
+        " bytes at ", offset, ", expected ", n));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ShuffleSpillBuffer::ParseRecord(
+    absl::string_view record, std::vector<Tensor>* element) const {
+  if (record.size() < kChecksumSize) {
+    return absl::DataLossError("Truncated shuffle spill record");
+  }
+  const absl::string_view payload =
+      record.substr(0, record.size() - kChecksumSize);
+  const uint32_t masked_crc =
+      core::DecodeFixed32(record.data() + payload.size());
+  if (crc32c::Unmask(masked_crc) !=
+      crc32c::Value(payload.data(), payload.size())) {
+    return absl::DataLossError("Corrupted shuffle spill record");
+  }
+  if (options_.compress) {
+    CompressedElement compressed;
+    if (!compressed.ParseFromArray(payload.data(), payload.size())) {
+      return absl::DataLossError("Failed to parse shuffle spill record");
+    }
+    element->clear();
+    return UncompressElement(compressed, element);
+  }
+  UncompressedElement uncompressed;
+  if (!uncompressed.ParseFromArray(payload.data(), payload.size())) {
+    return absl::DataLossError("Failed to parse shuffle spill record");
+  }
+  element->clear();
+  element->reserve(uncompressed.components_size());
+  for (const TensorProto& proto : uncompressed.components()) {
+    element->emplace_back();
+    if (!element->back().FromProto(proto)) {
+      return absl::DataLossError("Failed to parse shuffle spill tensor");
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ShuffleSpillBuffer::SerializeRecord(
+    const std::vector<Tensor>& element, std::string* out) const {
+  out->clear();
+  if (options_.compress) {
+    CompressedElement compressed;
+    TF_RETURN_IF_ERROR(CompressElement(element, &compressed));
+    if (!compressed.SerializeToString(out)) {
+      return absl::InternalError("Failed to serialize shuffle spill record");
+    }
+  } else {
+    UncompressedElement uncompressed;
+    for (const Tensor& tensor : element) {
+      tensor.AsProtoTensorContent(uncompressed.add_components());
+    }
+    if (!uncompressed.SerializeToString(out)) {
+      return absl::InternalError("Failed to serialize shuffle spill record");
+    }
+  }
+  core::PutFixed32(out, crc32c::Mask(crc32c::Value(out->data(), out->size())));
+  return absl::OkStatus();
+}
+
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,171 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_SHUFFLE_SPILL_BUFFER_H_
+#define TENSORFLOW_CORE_DATA_SHUFFLE_SPILL_BUFFER_H_
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/file_system.h"
+
+namespace tensorflow {
+namespace data {
+
+// Options of the spill mode of the shuffle dataset. Set through environment
+// variables, see `ShuffleSpillOptions::FromEnvironment()`.
+struct ShuffleSpillOptions {
+  // Directory for the spill files. The spill mode is disabled if empty.
+  std::string directory;
+  // Upper bound on the bytes of the elements kept in memory.
+  int64_t memory_budget_bytes = int64_t{1} << 30;
+  // Whether to compress spilled elements.
+  bool compress = false;
+  // Number of bytes read at once when reading spilled elements back. Elements
+  // that are stored next to the requested one are read with it.
+  int64_t read_batch_bytes = 4 << 20;
+
+  // Reads the options from TF_DATA_SHUFFLE_SPILL_DIR,
+  // TF_DATA_SHUFFLE_SPILL_MEMORY_MB and TF_DATA_SHUFFLE_SPILL_COMPRESS.
+  static absl::StatusOr<ShuffleSpillOptions> FromEnvironment();
+};
+
+// A shuffle buffer that keeps at most `memory_budget_bytes` of elements in
+// memory and spills the others to local disk.
+//
+// Elements are addressed by their index in the buffer, like the elements of
+// the `std::vector` used by the in-memory shuffle buffer. New elements stay in
+// memory until the budget is exceeded, at which point all elements that are
+// only held in memory are sealed into a run file, one record per element.
+// Elements read back from a run file stay backed by it, so they can be dropped
+// from memory again without being rewritten. A run file is deleted once all
+// of its elements have been taken out of the buffer.
+//
+// Not thread-safe.
+class ShuffleSpillBuffer {
+ public:
+  static absl::StatusOr<std::unique_ptr<ShuffleSpillBuffer>> Create(
+      Env* env, const ShuffleSpillOptions& options, int64_t size);
+
+  ~ShuffleSpillBuffer();
+
+  ShuffleSpillBuffer(const ShuffleSpillBuffer&) = delete;
+  ShuffleSpillBuffer& operator=(const ShuffleSpillBuffer&) = delete;
+
+  int64_t size() const { return slots_.size(); }
+
+  // Removes all elements and resizes the buffer to `size` empty slots.
+  void Reset(int64_t size);
+
+  // Resizes the buffer. Elements past the new size are dropped.
+  void Resize(int64_t size);
+
+  // Replaces the element at `index`.
+  absl::Status Set(int64_t index, std::vector<Tensor> element);
+
+  // Adds an element at the end of the buffer.
+  absl::Status Append(std::vector<Tensor> element);
+
+  // Moves the element at `index` into `element`, leaving the slot empty. The
+  // slot is left unchanged on failure.
+  absl::Status Take(int64_t index, std::vector<Tensor>* element);
+
+  // Copies the element at `index` into `element` without changing which
+  // elements are kept in memory.
+  absl::Status Get(int64_t index, std::vector<Tensor>* element);
+
+  // Swaps the elements at `i` and `j`.
+  void Swap(int64_t i, int64_t j);
+
+  // The bytes of the elements kept in memory.
+  int64_t memory_bytes() const { return memory_bytes_; }
+
+  // The number of run files on disk.
+  int64_t num_runs() const { return runs_.size(); }
+
+ private:
+  // The location of an element in a run file.
+  struct Record {
+    int64_t run = -1;
+    int64_t index = -1;
+  };
+
+  struct Slot {
+    std::vector<Tensor> element;
+    // Whether `element` holds the element. The element is empty otherwise,
+    // and `record` says where it is stored.
+    bool in_memory = false;
+    int64_t bytes = 0;
+    std::optional<Record> record;
+  };
+
+  struct Run {
+    std::string filename;
+    std::unique_ptr<RandomAccessFile> file;
+    // Record i is stored in [offsets[i], offsets[i + 1]).
+    std::vector<uint64_t> offsets;
+    // The slot holding record i, or -1 once the record has been taken out.
+    std::vector<int64_t> slots;
+    int64_t num_live = 0;
+  };
+
+  ShuffleSpillBuffer(Env* env, const ShuffleSpillOptions& options,
+                     std::string file_prefix, int64_t size);
+
+  // Drops the element at `index` and its record, if any.
+  void Clear(int64_t index);
+
+  // Reads the element at `index` into memory, together with the records
+  // stored after it in the same read batch that fit into the budget.
+  absl::Status Load(int64_t index);
+
+  // Spills or drops elements until the budget is met.
+  absl::Status EnforceBudget();
+
+  // Writes all elements that are only held in memory to a new run file.
+  absl::Status WriteRun();
+
+  absl::Status ReadRecords(const Run& run, int64_t begin, int64_t end,
+                           std::string* scratch, absl::string_view* data);
+  absl::Status ParseRecord(absl::string_view record,
+                           std::vector<Tensor>* element) const;
+  absl::Status SerializeRecord(const std::vector<Tensor>& element,
+                               std::string* out) const;
+
+  Env* const env_;
+  const ShuffleSpillOptions options_;
+  const std::string file_prefix_;
+  std::vector<Slot> slots_;
+  int64_t memory_bytes_ = 0;
+  // Candidates for dropping from memory and for writing to a run file. The
+  // slots are checked when popped, since elements move between slots.
+  std::deque<int64_t> spilled_in_memory_;
+  std::deque<int64_t> unspilled_;
+  absl::flat_hash_map<int64_t, std::unique_ptr<Run>> runs_;
+  int64_t next_run_ = 0;
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_SHUFFLE_SPILL_BUFFER_H_
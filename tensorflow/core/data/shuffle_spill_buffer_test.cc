@@ -0,0 +1,182 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/shuffle_spill_buffer.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "xla/tsl/platform/statusor.h"
+#include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+// An element of two components holding `value`, of about 4KB.
+std::vector<Tensor> MakeElement(int64_t value) {
+  Tensor values(DT_INT64, TensorShape({512}));
+  values.flat<int64_t>().setConstant(value);
+  return {values, test::AsScalar<tstring>(absl::StrCat("element ", value))};
+}
+
+void ExpectElement(const std::vector<Tensor>& element, int64_t value) {
+  ASSERT_EQ(element.size(), 2);
+  test::ExpectEqual(element[0], MakeElement(value)[0]);
+  test::ExpectEqual(element[1], MakeElement(value)[1]);
+}
+
+ShuffleSpillOptions TestOptions(const std::string& name, bool compress) {
+  ShuffleSpillOptions options;
+  options.directory = io::JoinPath(testing::TmpDir(), name);
+  options.memory_budget_bytes = 10 * GetTotalBytes(MakeElement(0));
+  options.compress = compress;
+  options.read_batch_bytes = 16 << 10;
+  return options;
+}
+
+int64_t NumFiles(const std::string& directory) {
+  std::vector<std::string> children;
+  TF_CHECK_OK(Env::Default()->GetChildren(directory, &children));
+  return children.size();
+}
+
+class ShuffleSpillBufferTest : public ::testing::TestWithParam<bool> {};
+
+TEST_P(ShuffleSpillBufferTest, SpillsAndReadsBack) {
+  const ShuffleSpillOptions options =
+      TestOptions(absl::StrCat("spills_", GetParam()), GetParam());
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ShuffleSpillBuffer> buffer,
+      ShuffleSpillBuffer::Create(Env::Default(), options, 100));
+  for (int64_t i = 0; i < 100; ++i) {
+    TF_ASSERT_OK(buffer->Set(i, MakeElement(i)));
+    EXPECT_LE(buffer->memory_bytes(), options.memory_budget_bytes);
+  }
+  EXPECT_GT(buffer->num_runs(), 0);
+  EXPECT_EQ(NumFiles(options.directory), buffer->num_runs());
+
+  // Takes the elements in a scattered order.
+  for (int64_t i = 0; i < 100; ++i) {
+    const int64_t index = (i * 37) % 100;
+    std::vector<Tensor> element;
+    TF_ASSERT_OK(buffer->Take(index, &element));
+    ExpectElement(element, index);
+    EXPECT_LE(buffer->memory_bytes(), options.memory_budget_bytes);
+  }
+  // Run files are deleted once all their elements have been taken.
+  EXPECT_EQ(buffer->num_runs(), 0);
+  EXPECT_EQ(NumFiles(options.directory), 0);
+}
+
+TEST_P(ShuffleSpillBufferTest, SwapAndGet) {
+  const ShuffleSpillOptions options =
+      TestOptions(absl::StrCat("swap_", GetParam()), GetParam());
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ShuffleSpillBuffer> buffer,
+      ShuffleSpillBuffer::Create(Env::Default(), options, 0));
+  for (int64_t i = 0; i < 50; ++i) {
+    TF_ASSERT_OK(buffer->Append(MakeElement(i)));
+  }
+  EXPECT_EQ(buffer->size(), 50);
+  for (int64_t i = 0; i < 25; ++i) {
+    buffer->Swap(i, 49 - i);
+  }
+  for (int64_t i = 0; i < 50; ++i) {
+    std::vector<Tensor> element;
+    TF_ASSERT_OK(buffer->Get(i, &element));
+    ExpectElement(element, 49 - i);
+  }
+
+  // Empty slots stay empty after a swap.
+  std::vector<Tensor> element;
+  TF_ASSERT_OK(buffer->Take(10, &element));
+  ExpectElement(element, 39);
+  buffer->Swap(10, 20);
+  TF_ASSERT_OK(buffer->Get(20, &element));
+  EXPECT_TRUE(element.empty());
+  TF_ASSERT_OK(buffer->Take(10, &element));
+  ExpectElement(element, 29);
+}
+
+TEST_P(ShuffleSpillBufferTest, ResizeAndReset) {
+  const ShuffleSpillOptions options =
+      TestOptions(absl::StrCat("resize_", GetParam()), GetParam());
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ShuffleSpillBuffer> buffer,
+      ShuffleSpillBuffer::Create(Env::Default(), options, 40));
+  for (int64_t i = 0; i < 40; ++i) {
+    TF_ASSERT_OK(buffer->Set(i, MakeElement(i)));
+  }
+  buffer->Resize(20);
+  for (int64_t i = 0; i < 20; ++i) {
+    std::vector<Tensor> element;
+    TF_ASSERT_OK(buffer->Take(i, &element));
+    ExpectElement(element, i);
+  }
+  EXPECT_EQ(NumFiles(options.directory), 0);
+
+  for (int64_t i = 0; i < 20; ++i) {
+    TF_ASSERT_OK(buffer->Set(i, MakeElement(i)));
+  }
+  buffer->Reset(5);
+  EXPECT_EQ(buffer->size(), 5);
+  EXPECT_EQ(buffer->memory_bytes(), 0);
+  EXPECT_EQ(NumFiles(options.directory), 0);
+}
+
+TEST_P(ShuffleSpillBufferTest, TakeKeepsElementIfSpillingFails) {
+  ShuffleSpillOptions options =
+      TestOptions(absl::StrCat("take_fails_", GetParam()), GetParam());
+  options.memory_budget_bytes = 0;
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ShuffleSpillBuffer> buffer,
+      ShuffleSpillBuffer::Create(Env::Default(), options, 2));
+  // Run files cannot be written without the directory, so the elements stay
+  // in memory.
+  int64_t undeleted_files, undeleted_dirs;
+  TF_ASSERT_OK(Env::Default()->DeleteRecursively(
+      options.directory, &undeleted_files, &undeleted_dirs));
+  EXPECT_FALSE(buffer->Set(0, MakeElement(0)).ok());
+  EXPECT_FALSE(buffer->Set(1, MakeElement(1)).ok());
+
+  std::vector<Tensor> element;
+  EXPECT_FALSE(buffer->Take(0, &element).ok());
+  TF_ASSERT_OK(buffer->Get(0, &element));
+  ExpectElement(element, 0);
+  EXPECT_EQ(buffer->memory_bytes(), 2 * GetTotalBytes(MakeElement(0)));
+
+  TF_ASSERT_OK(Env::Default()->RecursivelyCreateDir(options.directory));
+  TF_ASSERT_OK(buffer->Take(0, &element));
+  ExpectElement(element, 0);
+  TF_ASSERT_OK(buffer->Take(1, &element));
+  ExpectElement(element, 1);
+  EXPECT_EQ(buffer->memory_bytes(), 0);
+}
+
+INSTANTIATE_TEST_SUITE_P(Compression, ShuffleSpillBufferTest,
+                         ::testing::Bool());
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
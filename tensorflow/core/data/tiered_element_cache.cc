@@ -0,0 +1,412 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/tiered_element_cache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/functional/function_ref.h"
+#include "absl/log/log.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/random/random.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/refcount.h"
+#include "tensorflow/core/util/env_var.h"
+#include "tensorflow/core/util/tensor_bundle/mapped_tensor_buffer.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+constexpr char kDiskTierDirEnvVar[] = "TF_DATA_CACHE_DISK_TIER_DIR";
+constexpr char kMemoryBudgetMbEnvVar[] = "TF_DATA_CACHE_MEMORY_BUDGET_MB";
+
+// Components are stored at offsets aligned like the buffers of the CPU
+// allocator, so that the tensors aliasing mapped segments are aligned as well.
+constexpr uint64_t kAlignment = Allocator::kAllocatorAlignment;
+constexpr char kPadding[kAlignment] = {};
+
+// Holds the contents of a segment on file systems that cannot map files.
+class StringMemoryRegion : public ReadOnlyMemoryRegion {
+ public:
+  explicit StringMemoryRegion(std::string contents)
+      : contents_(std::move(contents)) {}
+
+  const void* data() override { return contents_.data(); }
+  uint64_t length() override { return contents_.size(); }
+
+ private:
+  const std::string contents_;
+};
+
+}  // namespace
+
+absl::StatusOr<TieredElementCacheOptions>
+TieredElementCacheOptions::FromEnvironment() {
+  TieredElementCacheOptions options;
+  TF_RETURN_IF_ERROR(
+      ReadStringFromEnvVar(kDiskTierDirEnvVar, "", &options.directory));
+  int64_t memory_mb;
+  TF_RETURN_IF_ERROR(ReadInt64FromEnvVar(
+      kMemoryBudgetMbEnvVar, options.memory_budget_bytes >> 20, &memory_mb));
+  if (memory_mb < 0) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        kMemoryBudgetMbEnvVar, " must be non-negative, got ", memory_mb));
+  }
+  options.memory_budget_bytes = memory_mb << 20;
+  return options;
+}
+
+absl::StatusOr<std::unique_ptr<TieredElementCache>> TieredElementCache::Create(
+    Env* env, const TieredElementCacheOptions& options) {
+  std::string file_prefix;
+  if (options.disk_tier_enabled()) {
+    TF_RETURN_IF_ERROR(env->RecursivelyCreateDir(options.directory));
+    file_prefix = io::JoinPath(
+        options.directory,
+        absl::StrCat("cache_", env->NowMicros(), "_", random::New64()));
+  }
+  return absl::WrapUnique(
+      new TieredElementCache(env, options, std::move(file_prefix)));
+}
+
+TieredElementCache::TieredElementCache(Env* env,
+                                       const TieredElementCacheOptions& options,
+                                       std::string file_prefix)
+    : env_(env),
+      options_(options),
+      file_prefix_(std::move(file_prefix)),
+      // Publishes the resident bytes in steps of a fraction of the budget
+      // rather than on every element.
+      metrics_(options.memory_budget_bytes / 64) {}
+
+TieredElementCache::~TieredElementCache() {
+  mutex_lock l(mu_);
+  for (const std::shared_ptr<Segment>& segment : segments_) {
+    // Tensors aliasing the segment keep its mapping alive after the file is
+    // deleted.
+    absl::Status s = env_->DeleteFile(segment->filename);
+    if (!s.ok()) {
+      LOG(WARNING) << "Failed to delete cache segment " << segment->filename
+                   << ": " << s;
+    }
+  }
+}
+
+int64_t TieredElementCache::size() const {
+  tf_shared_lock l(mu_);
+  return entries_.size();
+}
+
+void TieredElementCache::ForEachInMemory(
+    absl::FunctionRef<void(const std::vector<Tensor>&)> fn) const {
+  tf_shared_lock l(mu_);
+  for (const Entry& entry : entries_) {
+    if (entry.in_memory) {
+      fn(entry.element);
+    }
+  }
+}
+
+int64_t TieredElementCache::memory_bytes() const {
+  tf_shared_lock l(mu_);
+  return memory_bytes_;
+}
+
+int64_t TieredElementCache::disk_bytes() const {
+  tf_shared_lock l(mu_);
+  return disk_bytes_;
+}
+
+int64_t TieredElementCache::num_segments() const {
+  tf_shared_lock l(mu_);
+  return segments_.size();
+}
+
+absl::Status TieredElementCache::Append(std::vector<Tensor> element) {
+  mutex_lock l(mu_);
+  entries_.emplace_back();
+  entries_.back().bytes = GetTotalBytes(element);
+  AddToMemory(entries_.size() - 1, std::move(element));
+  return EnforceBudget();
+}
+
+absl::Status TieredElementCache::Get(int64_t index,
+                                     std::vector<Tensor>* element) {
+  {
+    tf_shared_lock l(mu_);
+    if (index < 0 || index >= entries_.size()) {
+      return absl::OutOfRangeError(absl::StrCat(
+          "Index out of range [0, ", entries_.size(), "): ", index));
+    }
+    Entry& entry = entries_[index];
+    if (entry.in_memory) {
+      *element = entry.element;
+      if (options_.disk_tier_enabled()) {
+        metrics_.RecordLookup(TieredCacheMetricsCollector::kMemory,
+                              /*hit=*/true);
+        entry.referenced.store(true, std::memory_order_relaxed);
+      }
+      return absl::OkStatus();
+    }
+  }
+
+  std::shared_ptr<Segment> segment;
+  std::shared_ptr<ReadOnlyMemoryRegion> region;
+  int64_t position;
+  {
+    mutex_lock l(mu_);
+    Entry& entry = entries_[index];
+    // The element may have been read from disk since the lock was released.
+    metrics_.RecordLookup(TieredCacheMetricsCollector::kMemory,
+                          entry.in_memory);
+    if (entry.in_memory) {
+      *element = entry.element;
+      entry.referenced.store(true, std::memory_order_relaxed);
+      return absl::OkStatus();
+    }
+    segment = segments_[entry.segment];
+    position = entry.position;
+    TF_RETURN_IF_ERROR(MapSegment(*segment));
+    region = segment->region;
+  }
+
+  // Segments are immutable, so they are read without holding the lock.
+  std::vector<Tensor> loaded;
+  absl::Status s = ReadCells(segment->cells[position], region, &loaded);
+  metrics_.RecordLookup(TieredCacheMetricsCollector::kDisk, s.ok());
+  TF_RETURN_IF_ERROR(s);
+
+  mutex_lock l(mu_);
+  if (!entries_[index].in_memory) {
+    AddToMemory(index, loaded);
+  }
+  *element = std::move(loaded);
+  return EnforceBudget();
+}
+
+void TieredElementCache::AddToMemory(int64_t index,
+                                     std::vector<Tensor> element) {
+  Entry& entry = entries_[index];
+  entry.element = std::move(element);
+  entry.in_memory = true;
+  memory_bytes_ += entry.bytes;
+  if (options_.disk_tier_enabled()) {
+    lru_.push_front(index);
+    entry.lru_position = lru_.begin();
+    entry.referenced.store(false, std::memory_order_relaxed);
+  }
+}
+
+void TieredElementCache::PromoteReferenced() {
+  std::list<int64_t> referenced;
+  for (auto it = lru_.begin(); it != lru_.end();) {
+    auto next = std::next(it);
+    if (entries_[*it].referenced.exchange(false, std::memory_order_relaxed)) {
+      // Splicing keeps `lru_position` valid.
+      referenced.splice(referenced.end(), lru_, it);
+    }
+    it = next;
+  }
+  lru_.splice(lru_.begin(), referenced);
+}
+
+absl::Status TieredElementCache::EnforceBudget() {
+  if (!options_.disk_tier_enabled()) {
+    return absl::OkStatus();
+  }
+  if (memory_bytes_ <= options_.memory_budget_bytes) {
+    RecordResidentBytes();
+    return absl::OkStatus();
+  }
+
+  PromoteReferenced();
+
+  const int64_t target_bytes =
+      options_.memory_budget_bytes - options_.memory_budget_bytes / 4;
+  std::vector<int64_t> unwritten;
+  int64_t bytes = memory_bytes_;
+  for (auto it = lru_.rbegin(); it != lru_.rend() && bytes > target_bytes;
+       ++it) {
+    bytes -= entries_[*it].bytes;
+    if (entries_[*it].segment < 0) {
+      unwritten.push_back(*it);
+    }
+  }
+  if (!unwritten.empty()) {
+    // Keeps the elements in memory if the segment cannot be written.
+    TF_RETURN_IF_ERROR(WriteSegment(unwritten));
+  }
+
+  while (memory_bytes_ > target_bytes && !lru_.empty()) {
+    Entry& entry = entries_[lru_.back()];
+    lru_.pop_back();
+    std::vector<Tensor>().swap(entry.element);
+    entry.in_memory = false;
+    memory_bytes_ -= entry.bytes;
+  }
+  RecordResidentBytes();
+  return absl::OkStatus();
+}
+
+absl::Status TieredElementCache::WriteSegment(
+    const std::vector<int64_t>& indices) {
+  auto segment = std::make_shared<Segment>();
+  segment->filename = absl::StrCat(file_prefix_, "_", segments_.size());
+  segment->cells.resize(indices.size());
+  size_t num_components = 0;
+  for (int64_t index : indices) {
+    num_components = std::max(num_components, entries_[index].element.size());
+  }
+
+  uint64_t offset = 0;
+  absl::Status status = [&]() -> absl::Status {
+    std::unique_ptr<WritableFile> file;
+    TF_RETURN_IF_ERROR(env_->NewWritableFile(segment->filename, &file));
+    std::string serialized;
+    for (size_t component = 0; component < num_components; ++component) {
+      for (size_t i = 0; i < indices.size(); ++i) {
+        const std::vector<Tensor>& element = entries_[indices[i]].element;
+        if (component >= element.size()) {
+          continue;
+        }
+        const Tensor& tensor = element[component];
+        const uint64_t padding =
+            (kAlignment - offset % kAlignment) % kAlignment;
+        TF_RETURN_IF_ERROR(file->Append(absl::string_view(kPadding, padding)));
+        offset += padding;
+
+        absl::string_view data;
+        if (DataTypeCanUseMemcpy(tensor.dtype())) {
+          data = tensor.tensor_data();
+        } else {
+          TensorProto proto;
+          tensor.AsProtoTensorContent(&proto);
+          if (!proto.SerializeToString(&serialized)) {
+            return absl::InternalError(absl::StrCat(
+                "Failed to serialize a tensor of type ",
+                DataTypeString(tensor.dtype()), " for the cache disk tier."));
+          }
+          data = serialized;
+        }
+        TF_RETURN_IF_ERROR(file->Append(data));
+        segment->cells[i].push_back(
+            Cell{tensor.dtype(), tensor.shape(), offset, data.size()});
+        offset += data.size();
+      }
+    }
+    return file->Close();
+  }();
+  if (!status.ok()) {
+    env_->DeleteFile(segment->filename).IgnoreError();
+    return status;
+  }
+
+  for (size_t i = 0; i < indices.size(); ++i) {
+    entries_[indices[i]].segment = segments_.size();
+    entries_[indices[i]].position = i;
+  }
+  segments_.push_back(std::move(segment));
+  disk_bytes_ += offset;
+  return absl::OkStatus();
+}
+
+absl::Status TieredElementCache::MapSegment(Segment& segment) {
+  if (segment.region != nullptr) {
+    return absl::OkStatus();
+  }
+  std::unique_ptr<ReadOnlyMemoryRegion> region;
+  absl::Status s =
+      env_->NewReadOnlyMemoryRegionFromFile(segment.filename, &region);
+  if (!s.ok()) {
+    // Not all file systems support memory mapping; such segments are read.
+    VLOG(1) << "Reading " << segment.filename
+            << " instead of memory mapping it: " << s;
+    std::string contents;
+    TF_RETURN_IF_ERROR(ReadFileToString(env_, segment.filename, &contents));
+    region = std::make_unique<StringMemoryRegion>(std::move(contents));
+  }
+  segment.region = std::move(region);
+  return absl::OkStatus();
+}
+
+absl::Status TieredElementCache::ReadCells(
+    const std::vector<Cell>& cells,
+    const std::shared_ptr<ReadOnlyMemoryRegion>& region,
+    std::vector<Tensor>* element) {
+  const char* base = static_cast<const char*>(region->data());
+  element->reserve(cells.size());
+  for (const Cell& cell : cells) {
+    if (cell.length > region->length() ||
+        cell.offset > region->length() - cell.length) {
+      return absl::DataLossError(absl::StrCat(
+          "Cache segment of ", region->length(),
+          " bytes is too short for a tensor of ", cell.length,
+          " bytes at offset ", cell.offset));
+    }
+    const char* data = base + cell.offset;
+    if (!DataTypeCanUseMemcpy(cell.dtype)) {
+      TensorProto proto;
+      Tensor tensor;
+      if (!proto.ParseFromArray(data, cell.length) ||
+          !tensor.FromProto(proto)) {
+        return absl::DataLossError(
+            absl::StrCat("Failed to parse a tensor of type ",
+                         DataTypeString(cell.dtype), " from a cache segment."));
+      }
+      element->push_back(std::move(tensor));
+    } else if (cell.length > 0 &&
+               reinterpret_cast<uintptr_t>(data) % kAlignment == 0) {
+      element->emplace_back(cell.dtype, cell.shape,
+                            core::RefCountPtr<TensorBuffer>(
+                                new MappedTensorBuffer(region, data,
+                                                       cell.length)));
+    } else {
+      Tensor tensor(cell.dtype, cell.shape);
+      if (cell.length > 0) {
+        std::memcpy(tensor.data(), data, cell.length);
+      }
+      element->push_back(std::move(tensor));
+    }
+  }
+  return absl::OkStatus();
+}
+
+void TieredElementCache::RecordResidentBytes() {
+  metrics_.RecordResidentBytes(TieredCacheMetricsCollector::kMemory,
+                               memory_bytes_);
+  metrics_.RecordResidentBytes(TieredCacheMetricsCollector::kDisk,
+                               disk_bytes_);
+}
+
+}  // namespace data
+}  // namespace tensorflow
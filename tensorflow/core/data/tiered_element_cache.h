@@ -0,0 +1,191 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_TIERED_ELEMENT_CACHE_H_
+#define TENSORFLOW_CORE_DATA_TIERED_ELEMENT_CACHE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "tensorflow/core/data/metric_utils.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/file_system.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+namespace data {
+
+// Options of the disk tier of the in-memory cache dataset. Set through
+// environment variables, see `TieredElementCacheOptions::FromEnvironment()`.
+struct TieredElementCacheOptions {
+  // Directory of the disk tier. The disk tier is disabled if empty, in which
+  // case all elements are kept in memory.
+  std::string directory;
+  // Upper bound on the bytes of the elements kept in memory when the disk tier
+  // is enabled.
+  int64_t memory_budget_bytes = int64_t{1} << 30;
+
+  bool disk_tier_enabled() const { return !directory.empty(); }
+
+  // Reads the options from TF_DATA_CACHE_DISK_TIER_DIR and
+  // TF_DATA_CACHE_MEMORY_BUDGET_MB.
+  static absl::StatusOr<TieredElementCacheOptions> FromEnvironment();
+};
+
+// An append-only cache of dataset elements that keeps the most recently used
+// elements in memory, within `memory_budget_bytes`, and evicts the others to
+// local disk.
+//
+// Evicted elements are written in batches to segment files. A segment stores
+// its elements column by column: component `c` of all elements of the segment
+// is stored contiguously, and every component starts at an offset aligned like
+// the buffers of the CPU allocator. Segments are memory mapped when read, so
+// that components of memcpy-able types are returned as tensors aliasing the
+// mapped pages instead of being copied. Elements read from disk are moved back
+// into the memory tier, which may evict others. Segment files are deleted with
+// the cache.
+//
+// Elements in memory are evicted in an approximate LRU order: reading them only
+// marks them as referenced, and the referenced elements are moved to the front
+// of the LRU list before evicting, so that reads of elements in memory share
+// the lock.
+//
+// Elements are appended by a single writer, and can be read concurrently.
+class TieredElementCache {
+ public:
+  static absl::StatusOr<std::unique_ptr<TieredElementCache>> Create(
+      Env* env, const TieredElementCacheOptions& options);
+
+  ~TieredElementCache();
+
+  TieredElementCache(const TieredElementCache&) = delete;
+  TieredElementCache& operator=(const TieredElementCache&) = delete;
+
+  // Returns the number of elements in the cache.
+  int64_t size() const;
+
+  // Adds an element at the end of the cache.
+  absl::Status Append(std::vector<Tensor> element);
+
+  // Copies the element at `index` into `element`.
+  absl::Status Get(int64_t index, std::vector<Tensor>* element);
+
+  // Calls `fn` with each element kept in memory, without changing which
+  // elements are kept in memory.
+  void ForEachInMemory(
+      absl::FunctionRef<void(const std::vector<Tensor>&)> fn) const;
+
+  // The bytes of the elements kept in memory.
+  int64_t memory_bytes() const;
+
+  // The bytes of the segment files on disk.
+  int64_t disk_bytes() const;
+
+  // The number of segment files on disk.
+  int64_t num_segments() const;
+
+ private:
+  // A component of an element stored in a segment file.
+  struct Cell {
+    DataType dtype;
+    TensorShape shape;
+    uint64_t offset = 0;
+    uint64_t length = 0;
+  };
+
+  struct Segment {
+    std::string filename;
+    // `cells[i]` holds the components of the i-th element of the segment.
+    std::vector<std::vector<Cell>> cells;
+    // Mapped on the first read of the segment.
+    std::shared_ptr<ReadOnlyMemoryRegion> region;
+  };
+
+  struct Entry {
+    // Holds the element if `in_memory` and is empty otherwise.
+    std::vector<Tensor> element;
+    bool in_memory = true;
+    int64_t bytes = 0;
+    // The location of the element on disk, if it has been evicted before.
+    int64_t segment = -1;
+    int64_t position = -1;
+    // The position of the element in `lru_` if `in_memory`.
+    std::list<int64_t>::iterator lru_position;
+    // Whether the element has been read in memory since it was last moved to
+    // the front of `lru_`. Set while holding `mu_` shared.
+    std::atomic<bool> referenced{false};
+  };
+
+  TieredElementCache(Env* env, const TieredElementCacheOptions& options,
+                     std::string file_prefix);
+
+  // Moves the element at `index` to memory as the most recently used element.
+  void AddToMemory(int64_t index, std::vector<Tensor> element)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Moves the referenced elements to the front of `lru_`, keeping their order.
+  void PromoteReferenced() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Evicts the least recently used elements until the budget is met. The
+  // memory tier is shrunk below the budget, so that elements are written in
+  // batches rather than one at a time.
+  absl::Status EnforceBudget() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Writes the elements at `indices` to a new segment file.
+  absl::Status WriteSegment(const std::vector<int64_t>& indices)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Maps the file of `segment` if it is not mapped yet.
+  absl::Status MapSegment(Segment& segment) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Reads the components stored in `cells` of `region`.
+  static absl::Status ReadCells(
+      const std::vector<Cell>& cells,
+      const std::shared_ptr<ReadOnlyMemoryRegion>& region,
+      std::vector<Tensor>* element);
+
+  void RecordResidentBytes() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  Env* const env_;
+  const TieredElementCacheOptions options_;
+  const std::string file_prefix_;
+  TieredCacheMetricsCollector metrics_;
+
+  mutable mutex mu_;
+  // A deque, as entries are not movable.
+  std::deque<Entry> entries_ TF_GUARDED_BY(mu_);
+  // Indices of the elements in memory, from the most to the least recently
+  // used.
+  std::list<int64_t> lru_ TF_GUARDED_BY(mu_);
+  int64_t memory_bytes_ TF_GUARDED_BY(mu_) = 0;
+  std::vector<std::shared_ptr<Segment>> segments_ TF_GUARDED_BY(mu_);
+  int64_t disk_bytes_ TF_GUARDED_BY(mu_) = 0;
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_TIERED_ELEMENT_CACHE_H_
@@ -0,0 +1,163 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/tiered_element_cache.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "xla/tsl/platform/statusor.h"
+#include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/monitoring/cell_reader.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+using ::tensorflow::monitoring::testing::CellReader;
+
+// An element of two components holding `value`, of about 4KB.
+std::vector<Tensor> MakeElement(int64_t value) {
+  Tensor values(DT_INT64, TensorShape({512}));
+  values.flat<int64_t>().setConstant(value);
+  return {values, test::AsScalar<tstring>(absl::StrCat("element ", value))};
+}
+
+void ExpectElement(const std::vector<Tensor>& element, int64_t value) {
+  ASSERT_EQ(element.size(), 2);
+  test::ExpectEqual(element[0], MakeElement(value)[0]);
+  test::ExpectEqual(element[1], MakeElement(value)[1]);
+}
+
+TieredElementCacheOptions TestOptions(const std::string& name) {
+  TieredElementCacheOptions options;
+  options.directory = io::JoinPath(testing::TmpDir(), name);
+  options.memory_budget_bytes = 10 * GetTotalBytes(MakeElement(0));
+  return options;
+}
+
+int64_t NumFiles(const std::string& directory) {
+  std::vector<std::string> children;
+  TF_CHECK_OK(Env::Default()->GetChildren(directory, &children));
+  return children.size();
+}
+
+TEST(TieredElementCacheTest, MemoryOnly) {
+  CellReader<int64_t> lookups("/tensorflow/data/cache_lookups");
+  TieredElementCacheOptions options;
+  options.memory_budget_bytes = 0;
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<TieredElementCache> cache,
+                          TieredElementCache::Create(Env::Default(), options));
+  int64_t total_bytes = 0;
+  for (int64_t i = 0; i < 20; ++i) {
+    total_bytes += GetTotalBytes(MakeElement(i));
+    TF_ASSERT_OK(cache->Append(MakeElement(i)));
+  }
+  // The budget only applies to caches with a disk tier.
+  EXPECT_EQ(cache->size(), 20);
+  EXPECT_EQ(cache->memory_bytes(), total_bytes);
+  EXPECT_EQ(cache->num_segments(), 0);
+  for (int64_t i = 0; i < 20; ++i) {
+    std::vector<Tensor> element;
+    TF_ASSERT_OK(cache->Get(i, &element));
+    ExpectElement(element, i);
+  }
+  std::vector<Tensor> element;
+  EXPECT_FALSE(cache->Get(20, &element).ok());
+  // Caches without a disk tier do not export metrics.
+  EXPECT_EQ(lookups.Delta("memory", "hit"), 0);
+}
+
+TEST(TieredElementCacheTest, EvictsToDisk) {
+  CellReader<int64_t> lookups("/tensorflow/data/cache_lookups");
+  const TieredElementCacheOptions options = TestOptions("evicts");
+  {
+    TF_ASSERT_OK_AND_ASSIGN(
+        std::unique_ptr<TieredElementCache> cache,
+        TieredElementCache::Create(Env::Default(), options));
+    for (int64_t i = 0; i < 100; ++i) {
+      TF_ASSERT_OK(cache->Append(MakeElement(i)));
+      EXPECT_LE(cache->memory_bytes(), options.memory_budget_bytes);
+    }
+    EXPECT_GT(cache->num_segments(), 0);
+    EXPECT_GT(cache->disk_bytes(), 0);
+    EXPECT_EQ(NumFiles(options.directory), cache->num_segments());
+
+    // Reads the elements twice, in a scattered order.
+    for (int64_t i = 0; i < 200; ++i) {
+      const int64_t index = (i * 37) % 100;
+      std::vector<Tensor> element;
+      TF_ASSERT_OK(cache->Get(index, &element));
+      ExpectElement(element, index);
+      EXPECT_LE(cache->memory_bytes(), options.memory_budget_bytes);
+    }
+    EXPECT_GT(lookups.Delta("disk", "hit"), 0);
+    EXPECT_EQ(lookups.Delta("disk", "miss"), 0);
+  }
+  // Segment files are deleted with the cache.
+  EXPECT_EQ(NumFiles(options.directory), 0);
+}
+
+TEST(TieredElementCacheTest, KeepsRecentlyUsedElementsInMemory) {
+  CellReader<int64_t> lookups("/tensorflow/data/cache_lookups");
+  const TieredElementCacheOptions options = TestOptions("recently_used");
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<TieredElementCache> cache,
+                          TieredElementCache::Create(Env::Default(), options));
+  for (int64_t i = 0; i < 50; ++i) {
+    TF_ASSERT_OK(cache->Append(MakeElement(i)));
+    // Keeps reading the first element, so it is never evicted.
+    std::vector<Tensor> element;
+    TF_ASSERT_OK(cache->Get(0, &element));
+    ExpectElement(element, 0);
+  }
+  EXPECT_EQ(lookups.Delta("memory", "hit"), 50);
+  EXPECT_EQ(lookups.Delta("memory", "miss"), 0);
+
+  // The oldest other element has been evicted.
+  std::vector<Tensor> element;
+  TF_ASSERT_OK(cache->Get(1, &element));
+  ExpectElement(element, 1);
+  EXPECT_EQ(lookups.Delta("memory", "miss"), 1);
+  EXPECT_EQ(lookups.Delta("disk", "hit"), 1);
+}
+
+TEST(TieredElementCacheTest, ResidentBytes) {
+  CellReader<int64_t> resident_bytes("/tensorflow/data/cache_resident_bytes");
+  const TieredElementCacheOptions options = TestOptions("resident_bytes");
+  {
+    TF_ASSERT_OK_AND_ASSIGN(
+        std::unique_ptr<TieredElementCache> cache,
+        TieredElementCache::Create(Env::Default(), options));
+    for (int64_t i = 0; i < 30; ++i) {
+      TF_ASSERT_OK(cache->Append(MakeElement(i)));
+    }
+    EXPECT_EQ(resident_bytes.Read("memory"), cache->memory_bytes());
+    EXPECT_EQ(resident_bytes.Read("disk"), cache->disk_bytes());
+  }
+  EXPECT_EQ(resident_bytes.Read("memory"), 0);
+  EXPECT_EQ(resident_bytes.Read("disk"), 0);
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
@@ -74,6 +74,12 @@ void EncodeRecvTensorResponseToByteBuffer(const RecvTensorResponse& proto,
 // copying the tensor data (and the grpc::Slice setup will be arrange so as
 // to dereference the underlying tensor data buffer when it is no longer
 // needed in the "*result" ByteBuffer).
+//
+// Sharing the tensor data costs a reference on the TensorBuffer and an
+// allocation for the gRPC slice refcount, so we only do it for tensors larger
+// than "kLargeTensorBytes".
+static constexpr size_t kLargeTensorBytes = 1024;
+
 static int VarLengthEncodingSize(uint32_t tag, size_t bytes) {
   return core::VarintLength(tag << 3) + core::VarintLength(bytes) + bytes;
 }
@@ -141,7 +147,6 @@ static void EncodeSkeleton(const Tensor& val, io::ProtoEncodeHelper* e) {
 absl::Status EncodeTensorToByteBuffer(bool is_dead, const Tensor& val,
                                       bool require_ack,
                                       ::grpc::ByteBuffer* result) {
-  const int kLargeTensorBytes = 1024;
   const int64_t kProtoBufLimitBytes = 1LL << 31;
 
   if (val.TotalBytes() > kProtoBufLimitBytes) {
@@ -178,11 +183,11 @@ absl::Status EncodeTensorToByteBuffer(bool is_dead, const Tensor& val,
         (e_skeleton.size() +
          VarLengthEncodingSize(TensorProto::kTensorContentFieldNumber,
                                tdata.size()));
-    std::string header;  // All of RecvTensorResponse except the tensor() field
-    response.AppendToString(&header);
+    // All of RecvTensorResponse except the tensor() field
+    size_t header_size = response.ByteSizeLong();
 
     size_t expected_size =
-        (header.size() +
+        (header_size +
          VarLengthEncodingSize(RecvTensorResponse::kTensorFieldNumber,
                                overall_tensor_proto_bytesize));
     // If "share_tensor_slice_memory == false", we copy the tensor data to
@@ -200,35 +205,34 @@ absl::Status EncodeTensorToByteBuffer(bool is_dead, const Tensor& val,
     size_t encoder_size = expected_size - tdata.size();
 
     // Encode all but the actual "tdata", but including the tag and
-    // varlength header for the "tdata"
-    absl::InlinedVector<char, 1024UL> space(encoder_size);
-    io::ProtoEncodeHelper e(space.data(), space.size());
-    // (A)
-    e.WriteRawBytes(header);
-
-    // (B1) & (B2)
-    e.WriteVarlengthBeginning(RecvTensorResponse::kTensorFieldNumber,
-                              overall_tensor_proto_bytesize);
-    // (C)
-    e.WriteRawBytes(absl::string_view(e_skeleton.data(), e_skeleton.size()));
-    // (D1) & (D2)
-    e.WriteVarlengthBeginning(TensorProto::kTensorContentFieldNumber,
-                              tdata.size());
-
-    // All but the tensor backing store are serialized now
-
-    // Now allocate memory and put into the ByteBuffer
+    // varlength header for the "tdata", directly into the first slice.
     ::grpc::Slice slices[2];
     int num_slices = 0;
     {
       size_t slice_len =
-          e.size() + (share_tensor_slice_memory ? 0 : tdata.size());
+          encoder_size + (share_tensor_slice_memory ? 0 : tdata.size());
       slices[0] = ::grpc::Slice(slice_len);
-      memcpy(const_cast<uint8_t*>(slices[0].begin()), e.data(), e.size());
+      char* base =
+          const_cast<char*>(reinterpret_cast<const char*>(slices[0].begin()));
+      // (A)
+      response.SerializeWithCachedSizesToArray(
+          reinterpret_cast<uint8_t*>(base));
+
+      io::ProtoEncodeHelper e(base + header_size, encoder_size - header_size);
+      // (B1) & (B2)
+      e.WriteVarlengthBeginning(RecvTensorResponse::kTensorFieldNumber,
+                                overall_tensor_proto_bytesize);
+      // (C)
+      e.WriteRawBytes(absl::string_view(e_skeleton.data(), e_skeleton.size()));
+      // (D1) & (D2)
+      e.WriteVarlengthBeginning(TensorProto::kTensorContentFieldNumber,
+                                tdata.size());
+      DCHECK_EQ(header_size + e.size(), encoder_size);
+
+      // All but the tensor backing store are serialized now
       if (!share_tensor_slice_memory) {
         // (E)
-        memcpy(const_cast<uint8_t*>(slices[0].begin()) + e.size(), tdata.data(),
-               tdata.size());
+        memcpy(base + encoder_size, tdata.data(), tdata.size());
       }
       num_slices += 1;
     }
@@ -15,10 +15,20 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/rpc/grpc_tensor_coding.h"
 
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
 #include "grpcpp/support/byte_buffer.h"
 #include "grpcpp/support/slice.h"
 #include "absl/status/status.h"
 #include "xla/tsl/lib/core/status_test_util.h"
+#include "tensorflow/core/distributed_runtime/rpc/grpc_util.h"
+#include "tensorflow/core/distributed_runtime/tensor_coding.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/device_attributes.pb.h"
+#include "tensorflow/core/framework/device_base.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
@@ -28,6 +38,22 @@ limitations under the License.
 
 namespace tensorflow {
 
+class CpuDevice : public DeviceBase {
+ public:
+  explicit CpuDevice(Env* env) : DeviceBase(env) {
+    attr_.set_device_type("CPU");
+  }
+
+  const DeviceAttributes& attributes() const override { return attr_; }
+
+  Allocator* GetAllocator(AllocatorAttributes attr) override {
+    return cpu_allocator();
+  }
+
+ private:
+  DeviceAttributes attr_;
+};
+
 class GrpcTensorCodingTest : public ::testing::Test {
  public:
   void Validate(const Tensor& t, bool is_dead) {
@@ -103,6 +129,85 @@ TEST_F(GrpcTensorCodingTest, Simple) {
 
 TEST_F(GrpcTensorCodingTest, StringTensor) { DoTestForStrings(DT_STRING); }
 
+TEST_F(GrpcTensorCodingTest, SharesLargeTensorData) {
+  for (int64_t num_elems : {16, 4096}) {
+    Tensor t(DT_FLOAT, TensorShape({num_elems}));
+    test::FillFn<float>(&t, [](int i) { return i; });
+    ::grpc::ByteBuffer buf;
+    TF_ASSERT_OK(grpc::EncodeTensorToByteBuffer(/*is_dead=*/false, t,
+                                                /*require_ack=*/false, &buf));
+    std::vector<::grpc::Slice> slices;
+    ASSERT_TRUE(buf.Dump(&slices).ok());
+
+    // Large tensor data is not copied but referenced by a second slice.
+    bool shared = t.TotalBytes() > 1024;
+    ASSERT_EQ(slices.size(), shared ? 2 : 1);
+    if (shared) {
+      EXPECT_EQ(static_cast<const void*>(slices[1].begin()),
+                t.tensor_data().data());
+      EXPECT_EQ(slices[1].size(), t.TotalBytes());
+    }
+  }
+}
+
+TEST_F(GrpcTensorCodingTest, ParseSharesEncodedTensorData) {
+  Tensor t(DT_FLOAT, TensorShape({4096}));
+  test::FillFn<float>(&t, [](int i) { return i; });
+  ::grpc::ByteBuffer buf;
+  TF_ASSERT_OK(grpc::EncodeTensorToByteBuffer(/*is_dead=*/false, t,
+                                              /*require_ack=*/false, &buf));
+
+  CpuDevice cpu_device(Env::Default());
+  TensorResponse response;
+  response.InitAlloc(&cpu_device, AllocatorAttributes());
+  ASSERT_TRUE(GrpcMaybeParseTensorResponse(&buf, &response));
+  test::ExpectTensorEqual<float>(response.tensor(), t);
+  // The parsed tensor aliases the slice that references the sent tensor.
+  EXPECT_EQ(response.tensor().tensor_data().data(), t.tensor_data().data());
+}
+
+TEST_F(GrpcTensorCodingTest, ParseSharesContiguousSlices) {
+  Tensor t(DT_FLOAT, TensorShape({4096}));
+  test::FillFn<float>(&t, [](int i) { return i; });
+  RecvTensorResponse proto;
+  t.AsProtoTensorContent(proto.mutable_tensor());
+  std::string encoded;
+  proto.AppendToString(&encoded);
+  const size_t content_offset = encoded.find(std::string(t.tensor_data()));
+  ASSERT_NE(content_offset, std::string::npos);
+
+  // Places the encoded response so that the tensor content is aligned.
+  constexpr size_t kAlignment = Allocator::kAllocatorAlignment;
+  Tensor storage(DT_INT8,
+                 TensorShape({static_cast<int64_t>(encoded.size() +
+                                                   kAlignment)}));
+  char* data = const_cast<char*>(storage.tensor_data().data()) +
+               (kAlignment - content_offset % kAlignment) % kAlignment;
+  std::memcpy(data, encoded.data(), encoded.size());
+
+  CpuDevice cpu_device(Env::Default());
+  for (bool contiguous : {true, false}) {
+    // Splits the response into slices which alias consecutive parts of
+    // `data`, or into slices of their own. The aliasing slices are refcounted
+    // so that gRPC does not merge them.
+    std::vector<::grpc::Slice> slices;
+    for (size_t pos = 0; pos < encoded.size(); pos += 1000) {
+      const size_t len = std::min<size_t>(1000, encoded.size() - pos);
+      slices.push_back(contiguous ? ::grpc::Slice(
+                                        data + pos, len, [](void*) {}, nullptr)
+                                  : ::grpc::Slice(data + pos, len));
+    }
+    ::grpc::ByteBuffer buf(slices.data(), slices.size());
+
+    TensorResponse response;
+    response.InitAlloc(&cpu_device, AllocatorAttributes());
+    ASSERT_TRUE(GrpcMaybeParseTensorResponse(&buf, &response));
+    test::ExpectTensorEqual<float>(response.tensor(), t);
+    EXPECT_EQ(response.tensor().tensor_data().data() == data + content_offset,
+              contiguous);
+  }
+}
+
 TEST_F(GrpcTensorCodingTest, LargeTensor) {
   Tensor t(DT_INT8, TensorShape({1, 1 + (1LL << 31)}));
   ::grpc::ByteBuffer buf;
@@ -15,9 +15,84 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/rpc/grpc_util.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "grpcpp/support/slice.h"
 #include "tensorflow/core/distributed_runtime/tensor_coding.h"
+#include "tensorflow/core/framework/allocation_description.pb.h"
+#include "tensorflow/core/framework/tensor.h"
 
 namespace tensorflow {
+namespace {
+
+// A TensorBuffer aliasing received gRPC slices that are contiguous in memory,
+// which it keeps alive.
+class GrpcSliceTensorBuffer : public TensorBuffer {
+ public:
+  GrpcSliceTensorBuffer(std::vector<::grpc::Slice> slices, const char* data,
+                        size_t size)
+      : TensorBuffer(const_cast<char*>(data)),
+        slices_(std::move(slices)),
+        size_(size) {}
+
+  size_t size() const override { return size_; }
+
+  TensorBuffer* root_buffer() override { return this; }
+
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(static_cast<int64_t>(size_));
+    proto->set_allocator_name("grpc");
+    proto->set_ptr(reinterpret_cast<uintptr_t>(data()));
+  }
+
+  // The slices may be shared with other gRPC buffers, so the buffer must
+  // never be forwarded to an op's output for in-place updates.
+  bool OwnsMemory() const override { return false; }
+
+ private:
+  const std::vector<::grpc::Slice> slices_;
+  const size_t size_;
+};
+
+const char* SliceBegin(const ::grpc::Slice& slice) {
+  return reinterpret_cast<const char*>(slice.begin());
+}
+
+const char* SliceEnd(const ::grpc::Slice& slice) {
+  return reinterpret_cast<const char*>(slice.end());
+}
+
+}  // namespace
+
+TensorBuffer* GrpcByteSource::ShareBuffer(const char* data, size_t size) {
+  if (!dumped_) {
+    dumped_ = true;
+    if (!buffer_->Dump(&slices_).ok()) slices_.clear();
+  }
+  for (size_t first = 0; first < slices_.size(); ++first) {
+    if (data < SliceBegin(slices_[first]) || data >= SliceEnd(slices_[first])) {
+      continue;
+    }
+    // The data continues in the following slices, which can only be shared
+    // if each of them starts where the previous one ends.
+    size_t last = first;
+    while (data + size > SliceEnd(slices_[last]) &&
+           last + 1 < slices_.size() &&
+           SliceBegin(slices_[last + 1]) == SliceEnd(slices_[last])) {
+      ++last;
+    }
+    if (data + size > SliceEnd(slices_[last])) return nullptr;
+    return new GrpcSliceTensorBuffer(
+        std::vector<::grpc::Slice>(slices_.begin() + first,
+                                   slices_.begin() + last + 1),
+        data, size);
+  }
+  // E.g. the reader decompressed the buffer into memory of its own.
+  return nullptr;
+}
 
 bool GrpcMaybeParseTensorResponse(::grpc::ByteBuffer* src,
                                   TensorResponse* dst) {
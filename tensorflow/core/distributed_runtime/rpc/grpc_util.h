@@ -18,10 +18,12 @@ limitations under the License.
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "grpcpp/grpcpp.h"
 #include "grpcpp/impl/codegen/proto_utils.h"
 #include "grpcpp/support/byte_buffer.h"
+#include "grpcpp/support/slice.h"
 #include "xla/tsl/distributed_runtime/rpc/grpc_util.h"
 #include "tensorflow/core/distributed_runtime/tensor_coding.h"
 #include "tensorflow/core/lib/core/status.h"
@@ -50,6 +52,10 @@ class GrpcByteSource : public TensorResponse::Source {
     return stream_;
   }
 
+  // Shares the memory of the received gRPC slices that contain `data`, if
+  // they are contiguous in memory.
+  TensorBuffer* ShareBuffer(const char* data, size_t size) override;
+
  private:
   void DeleteStream() {
     if (stream_) {
@@ -60,6 +66,11 @@ class GrpcByteSource : public TensorResponse::Source {
   ::grpc::ByteBuffer* buffer_;  // Not owned
   Reader* stream_ = nullptr;    // Points into space_ if non-nullptr
   char space_[sizeof(Reader)];
+
+  // The slices of `buffer_`, dumped by the first ShareBuffer() call so that
+  // the tensors of a response don't each dump and reference all of them.
+  bool dumped_ = false;
+  std::vector<::grpc::Slice> slices_;
 };
 
 inline std::string GrpcIdKey() { return "tf-rpc"; }
@@ -164,6 +164,16 @@ std::string DebugString(const Tensor& x, const Tensor& y, int tensor_size) {
                          x_flat(1), y_flat(0), y_flat(1));
 }
 
+// Returns the number of tensors sent between devices in each step of the
+// program created by CreateGraphDef.
+int64_t NumRemoteTensorsPerStep(int num_stages, int width,
+                                bool use_multiple_devices) {
+  if (!use_multiple_devices) return 0;
+  // "x" is sent to and "y" received from all but the first device, and every
+  // stage after the first receives the outputs of the previous one.
+  return 2 * (width - 1) + (num_stages - 1) * (width * width - width);
+}
+
 // TODO: Support sharding and depth.
 static void BM_Helper(::testing::benchmark::State& state, int width,
                       int num_stages, int tensor_size,
@@ -207,6 +217,9 @@ static void BM_Helper(::testing::benchmark::State& state, int width,
     TF_CHECK_OK(session->Run({{"x", x}}, {"y:0"}, {}, &outputs));
     CHECK_EQ(size_t{1}, outputs.size());
   }
+  state.SetBytesProcessed(
+      state.iterations() * tensor_size * sizeof(float) *
+      NumRemoteTensorsPerStep(num_stages, width, use_multiple_devices));
   TF_CHECK_OK(session->Close());
 }
 static void BM_ShardedProgram(::testing::benchmark::State& state) {
@@ -240,6 +253,22 @@ static void BM_RPC(::testing::benchmark::State& state) {
 }
 BENCHMARK(BM_RPC)->ArgPair(30, 2)->ArgPair(30, 1000)->ArgPair(30, 100000);
 
+// Sends large tensors between a few workers, where the cost of the RPCs is
+// dominated by the handling of the tensor data. The CPU time per processed
+// byte shows the cost of encoding and decoding the tensors.
+static void BM_RPCLargeTensors(::testing::benchmark::State& state) {
+  const int width = state.range(0);
+  const int tensor_size = state.range(1);
+
+  BM_Helper(state, width, 2 /*num_stages*/, tensor_size, true /*multi-device*/);
+}
+BENCHMARK(BM_RPCLargeTensors)
+    ->MeasureProcessCPUTime()
+    ->ArgPair(2, 1 << 18)
+    ->ArgPair(2, 1 << 22)
+    ->ArgPair(4, 1 << 18)
+    ->ArgPair(4, 1 << 22);
+
 static void BM_SingleDevice(::testing::benchmark::State& state) {
   const int width = state.range(0);
   const int num_stages = state.range(1);
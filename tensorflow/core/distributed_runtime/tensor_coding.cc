@@ -15,6 +15,10 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/tensor_coding.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
 #include "google/protobuf/any.pb.h"
 #include "absl/status/status.h"
 #include "xla/tsl/platform/errors.h"
@@ -29,8 +33,14 @@ namespace tensorflow {
 
 TensorResponse::Source::~Source() {}
 
+TensorBuffer* TensorResponse::Source::ShareBuffer(const char* data,
+                                                  size_t size) {
+  return nullptr;
+}
+
 void TensorResponse::Clear() {
   on_host_ = false;
+  share_buffers_ = false;
   device_ = nullptr;
   alloc_attrs_ = AllocatorAttributes();
   allocator_ = nullptr;
@@ -51,6 +61,9 @@ void TensorResponse::InitAlloc(DeviceBase* d, const AllocatorAttributes& aa) {
   if (alloc_attrs_.on_host() || da.device_type() == "CPU") {
     on_host_ = true;
   }
+  // Tensors that may be DMAed to a GPU must live in memory from the
+  // (pinned) host allocator.
+  share_buffers_ = on_host_ && !alloc_attrs_.gpu_compatible();
   allocator_ = device_->GetAllocator(alloc_attrs_);
 }
 
@@ -152,7 +165,8 @@ bool ReadNestedMessage(protobuf::io::CodedInputStream* input,
 }  // namespace
 
 bool TensorResponse::ParseTensorSubmessage(
-    protobuf::io::CodedInputStream* input, TensorProto* tensor_meta) {
+    Source* source, protobuf::io::CodedInputStream* input,
+    TensorProto* tensor_meta) {
   bool seen_tensor_content = false;
   while (true) {
     auto p = input->ReadTagWithCutoff(127);
@@ -211,12 +225,13 @@ bool TensorResponse::ParseTensorSubmessage(
                  .ok()) {
           return false;
         }
+        if (ShareTensorContent(source, input, tensor_meta->dtype(), shape,
+                               num_bytes)) {
+          break;
+        }
         Tensor t(allocator_, tensor_meta->dtype(), shape);
         absl::string_view buf = t.tensor_data();
         if (static_cast<size_t>(num_bytes) != buf.size()) return false;
-        // TODO(jeff,sanjay): Figure out a way to avoid this copy if
-        // the underlying ZeroCopyInputStream data is properly aligned
-        // and compatible with what allocator_ wants.
         if (!input->ReadRaw(const_cast<char*>(buf.data()), num_bytes))
           return false;
         tensor_ = std::move(t);
@@ -231,6 +246,41 @@ bool TensorResponse::ParseTensorSubmessage(
   }
 }
 
+bool TensorResponse::ShareTensorContent(Source* source,
+                                        protobuf::io::CodedInputStream* input,
+                                        DataType dtype,
+                                        const TensorShape& shape,
+                                        int num_bytes) {
+  // Small tensors are cheaper to copy than to share.
+  static constexpr int kMinSharedTensorBytes = 1024;
+  if (!share_buffers_ || num_bytes < kMinSharedTensorBytes ||
+      static_cast<size_t>(num_bytes) !=
+          shape.num_elements() * DataTypeSize(dtype)) {
+    return false;
+  }
+
+  // The tensor content only needs the alignment that Eigen expects of tensor
+  // data and that its elements need, not the one of allocator memory. It may
+  // span several chunks of the stream if the source can share them.
+  const void* data;
+  int size;
+  const size_t alignment =
+      std::max<size_t>({EIGEN_MAX_ALIGN_BYTES, DataTypeSize(dtype), 1});
+  if (!input->GetDirectBufferPointer(&data, &size) ||
+      reinterpret_cast<uintptr_t>(data) % alignment != 0) {
+    return false;
+  }
+
+  TensorBuffer* buf =
+      source->ShareBuffer(static_cast<const char*>(data), num_bytes);
+  if (buf == nullptr) return false;
+  Tensor t(dtype, shape, buf);
+  buf->Unref();
+  if (!input->Skip(num_bytes)) return false;
+  tensor_ = std::move(t);
+  return true;
+}
+
 bool TensorResponse::ParseFast(Source* source) {
   protobuf::io::CodedInputStream input(source->contents());
   while (true) {
@@ -249,7 +299,7 @@ bool TensorResponse::ParseFast(Source* source) {
         std::pair<protobuf::io::CodedInputStream::Limit, int> p =
             input.IncrementRecursionDepthAndPushLimit(length);
         if (p.second < 0 ||
-            !ParseTensorSubmessage(&input, meta_.mutable_tensor())) {
+            !ParseTensorSubmessage(source, &input, meta_.mutable_tensor())) {
           return false;
         }
         if (!input.DecrementRecursionDepthAndPopLimit(p.first)) {
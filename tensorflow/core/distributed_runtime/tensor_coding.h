@@ -63,6 +63,16 @@ class TensorResponse {
     // Ownership of the returned stream is retained by the Source and
     // should not be deleted by the caller.
     virtual ::tensorflow::protobuf::io::ZeroCopyInputStream* contents() = 0;
+
+    // Returns a buffer that aliases the `size` bytes at `data`, which point
+    // into the stream last returned by contents(), and keeps them alive for
+    // the lifetime of the buffer. The bytes may span several chunks of the
+    // stream. Returns nullptr if the source can't share its memory, e.g.
+    // because those chunks are not contiguous in memory, in which case the
+    // data is copied.
+    //
+    // The caller takes ownership of one reference to the returned buffer.
+    virtual TensorBuffer* ShareBuffer(const char* data, size_t size);
   };
 
   // Parse the RecvTensorResponse encoded in the data yielded by
@@ -91,12 +101,22 @@ class TensorResponse {
   DeviceBase* device() const { return device_; }
 
  private:
-  bool ParseTensorSubmessage(protobuf::io::CodedInputStream* input,
+  bool ParseTensorSubmessage(Source* source,
+                             protobuf::io::CodedInputStream* input,
                              TensorProto* tensor_meta);
+  // Initializes `tensor_` with the `num_bytes` of tensor content at the
+  // current position of `input` without copying them, if `source` can share
+  // its memory and it is aligned as Tensor::IsAligned() requires.
+  bool ShareTensorContent(Source* source, protobuf::io::CodedInputStream* input,
+                          DataType dtype, const TensorShape& shape,
+                          int num_bytes);
   bool ParseFast(Source* source);
   bool ParseSlow(Source* source);
 
   bool on_host_ = false;
+  // Whether received tensor contents may alias the RPC buffers instead of
+  // being copied into memory from `allocator_`.
+  bool share_buffers_ = false;
   DeviceBase* device_ = nullptr;
   AllocatorAttributes alloc_attrs_;
   Allocator* allocator_ = nullptr;
@@ -15,7 +15,15 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/tensor_coding.h"
 
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
 #include "absl/status/status.h"
+#include "tensorflow/core/framework/allocation_description.pb.h"
+#include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/device_attributes.pb.h"
 #include "tensorflow/core/framework/device_base.h"
 #include "tensorflow/core/framework/tensor.h"
@@ -180,6 +188,82 @@ TEST_F(TensorResponseTest, InitPartialOverflow) {
   EXPECT_TRUE(absl::IsInvalidArgument(s));
 }
 
+// A source reading from contiguous memory, which it shares with the parsed
+// tensors.
+class SharingSource : public TensorResponse::Source {
+ public:
+  SharingSource(const char* data, size_t size) : data_(data), size_(size) {}
+
+  protobuf::io::ZeroCopyInputStream* contents() override {
+    stream_.emplace(data_, size_);
+    return &*stream_;
+  }
+
+  TensorBuffer* ShareBuffer(const char* data, size_t size) override {
+    ++num_shared_buffers_;
+    return new SharedBuffer(data, size);
+  }
+
+  int num_shared_buffers() const { return num_shared_buffers_; }
+
+ private:
+  class SharedBuffer : public TensorBuffer {
+   public:
+    SharedBuffer(const char* data, size_t size)
+        : TensorBuffer(const_cast<char*>(data)), size_(size) {}
+    size_t size() const override { return size_; }
+    TensorBuffer* root_buffer() override { return this; }
+    void FillAllocationDescription(AllocationDescription*) const override {}
+    bool OwnsMemory() const override { return false; }
+
+   private:
+    size_t size_;
+  };
+
+  const char* data_;
+  size_t size_;
+  std::optional<protobuf::io::ArrayInputStream> stream_;
+  int num_shared_buffers_ = 0;
+};
+
+TEST_F(TensorResponseTest, SharesAlignedTensorContent) {
+  Tensor src(DT_FLOAT, TensorShape({4, 1024}));
+  test::FillFn<float>(&src, [](int i) { return i; });
+  RecvTensorResponse proto;
+  proto.set_send_start_micros(123456);
+  src.AsProtoTensorContent(proto.mutable_tensor());
+  std::string encoded;
+  proto.AppendToString(&encoded);
+  size_t content_offset = encoded.find(std::string(src.tensor_data()));
+  ASSERT_NE(content_offset, std::string::npos);
+
+  DummyDevice cpu_device(Env::Default());
+  constexpr size_t kAlignment = Allocator::kAllocatorAlignment;
+  std::vector<char> storage(encoded.size() + kAlignment + 1);
+  for (size_t misalignment : {0, 1}) {
+    // Place the encoded response so that the tensor content is at
+    // `misalignment` bytes from an aligned address.
+    uintptr_t content =
+        reinterpret_cast<uintptr_t>(storage.data()) + content_offset;
+    size_t padding =
+        (kAlignment - content % kAlignment) % kAlignment + misalignment;
+    char* data = storage.data() + padding;
+    std::memcpy(data, encoded.data(), encoded.size());
+
+    SharingSource source(data, encoded.size());
+    TensorResponse response;
+    response.InitAlloc(&cpu_device, AllocatorAttributes());
+    ASSERT_TRUE(response.ParseFrom(&source).ok());
+    test::ExpectTensorEqual<float>(response.tensor(), src);
+    EXPECT_EQ(response.metadata().send_start_micros(), 123456);
+
+    bool shared = misalignment == 0;
+    EXPECT_EQ(source.num_shared_buffers(), shared ? 1 : 0);
+    EXPECT_EQ(response.tensor().tensor_data().data() == data + content_offset,
+              shared);
+  }
+}
+
 std::string MakeFloatTensorTestCase(int num_elems) {
   std::vector<int8_t> v(num_elems);
   for (int i = 0; i < num_elems; i++) {
@@ -143,6 +143,19 @@ auto* tf_data_service_compression = tsl::monitoring::Counter<1>::New(
     "'not_disabled_at_runtime', 'not_eligible'}.",
     "action");
 
+auto* tf_data_compression_bytes_counter = tsl::monitoring::Counter<3>::New(
+    "/tensorflow/data/compression_bytes",
+    "The number of bytes processed by tf.data element compression, by codec, "
+    "operation {'compress', 'uncompress'} and kind {'uncompressed', "
+    "'compressed', 'stored_uncompressed'}.",
+    "codec", "operation", "kind");
+
+auto* tf_data_compression_usecs_counter = tsl::monitoring::Counter<2>::New(
+    "/tensorflow/data/compression_usecs",
+    "Microseconds spent in tf.data element compression, by codec and "
+    "operation {'compress', 'uncompress'}.",
+    "codec", "operation");
+
 auto* tf_data_service_get_element_duration_usecs_histogram =
     tsl::monitoring::Sampler<1>::New(
         {"/tensorflow/data/getelement_duration",
@@ -226,6 +239,30 @@ auto* tf_data_service_cross_trainer_cache_size_bytes =
         "/tensorflow/data/service/cross_trainer_cache_size_bytes",
         "tf.data service cross-trainer cache memory usage in bytes.");
 
+auto* tf_data_service_cross_trainer_cache_tier_queries_counter =
+    tsl::monitoring::Counter<2>::New(
+        "/tensorflow/data/service/cross_trainer_cache_tier_queries",
+        "tf.data service cross-trainer cache queries in each tier. The result "
+        "can be hit or miss.",
+        "tier", "result");
+
+auto* tf_data_service_cross_trainer_cache_disk_size_bytes =
+    tsl::monitoring::Gauge<int64_t, 0>::New(
+        "/tensorflow/data/service/cross_trainer_cache_disk_size_bytes",
+        "tf.data service cross-trainer cache disk usage in bytes.");
+
+auto* tf_data_cache_lookups_counter = tsl::monitoring::Counter<2>::New(
+    "/tensorflow/data/cache_lookups",
+    "The number of element lookups in each tier of the tf.data caches. The "
+    "result can be hit or miss.",
+    "tier", "result");
+
+auto* tf_data_cache_resident_bytes_gauge =
+    tsl::monitoring::Gauge<int64_t, 1>::New(
+        "/tensorflow/data/cache_resident_bytes",
+        "The bytes of the elements held in each tier of the tf.data caches.",
+        "tier");
+
 auto* tf_data_service_snapshot_bytes_committed =
     tsl::monitoring::Counter<0>::New(
         "/tensorflow/data/service/snapshot_bytes_committed",
@@ -590,6 +627,25 @@ void RecordTFDataServiceCompressionAction(const std::string& action) {
   tf_data_service_compression->GetCell(action)->IncrementBy(1);
 }
 
+void RecordTFDataCompression(const std::string& codec, bool compress,
+                             uint64_t uncompressed_bytes,
+                             uint64_t compressed_bytes,
+                             uint64_t stored_uncompressed_bytes,
+                             uint64_t duration_us) {
+  const std::string operation = compress ? "compress" : "uncompress";
+  tf_data_compression_bytes_counter->GetCell(codec, operation, "uncompressed")
+      ->IncrementBy(uncompressed_bytes);
+  tf_data_compression_bytes_counter->GetCell(codec, operation, "compressed")
+      ->IncrementBy(compressed_bytes);
+  if (stored_uncompressed_bytes > 0) {
+    tf_data_compression_bytes_counter
+        ->GetCell(codec, operation, "stored_uncompressed")
+        ->IncrementBy(stored_uncompressed_bytes);
+  }
+  tf_data_compression_usecs_counter->GetCell(codec, operation)
+      ->IncrementBy(duration_us);
+}
+
 void RecordTFDataServiceGetElementDuration(
     const std::string& data_transfer_protocol, uint64_t duration_us) {
   tf_data_service_get_element_duration_usecs_histogram
@@ -734,6 +790,27 @@ void RecordTFDataServiceCrossTrainerCacheSizeBytes(size_t bytes) {
       static_cast<int64_t>(bytes));
 }
 
+void RecordTFDataServiceCrossTrainerCacheTierQuery(const std::string& tier,
+                                                   bool hit) {
+  tf_data_service_cross_trainer_cache_tier_queries_counter
+      ->GetCell(tier, hit ? "hit" : "miss")
+      ->IncrementBy(1);
+}
+
+void RecordTFDataServiceCrossTrainerCacheDiskSizeBytes(size_t bytes) {
+  tf_data_service_cross_trainer_cache_disk_size_bytes->GetCell()->Set(
+      static_cast<int64_t>(bytes));
+}
+
+tsl::monitoring::CounterCell* GetTFDataCacheLookupCounter(
+    const std::string& tier, bool hit) {
+  return tf_data_cache_lookups_counter->GetCell(tier, hit ? "hit" : "miss");
+}
+
+void RecordTFDataCacheResidentBytes(const std::string& tier, int64_t bytes) {
+  tf_data_cache_resident_bytes_gauge->GetCell(tier)->Set(bytes);
+}
+
 void RecordTFDataServiceSnapshotBytesCommitted(int64_t bytes) {
   tf_data_service_snapshot_bytes_committed->GetCell()->IncrementBy(bytes);
 }
@@ -125,6 +125,18 @@ void RecordTFDataServiceRuntimeCompressionDecision(bool compression_decision);
 // related action.
 void RecordTFDataServiceCompressionAction(const std::string& action);
 
+// Records the compression (if `compress` is true) or uncompression of a
+// tf.data element with `codec`, which took `duration_us` microseconds.
+// `uncompressed_bytes` were compressed into `compressed_bytes`, and
+// `stored_uncompressed_bytes` were stored as-is because they were found to be
+// incompressible. Per-codec throughput and compression ratio are derived from
+// these counters.
+void RecordTFDataCompression(const std::string& codec, bool compress,
+                             uint64_t uncompressed_bytes,
+                             uint64_t compressed_bytes,
+                             uint64_t stored_uncompressed_bytes,
+                             uint64_t duration_us);
+
 // Records the time (in microseconds) during which `IteratorResource` was busy
 // processing at least one `GetNext()` request.
 void RecordTFDataIteratorBusy(uint64_t duration_us);
@@ -204,6 +216,22 @@ void RecordTFDataServiceCrossTrainerCacheQuery(bool cache_hit);
 // Records tf.data service cross-trainer cache memory usage in bytes.
 void RecordTFDataServiceCrossTrainerCacheSizeBytes(size_t bytes);
 
+// Records a query of `tier` of the tf.data service cross-trainer cache, and
+// whether the tier held the element.
+void RecordTFDataServiceCrossTrainerCacheTierQuery(const std::string& tier,
+                                                   bool hit);
+
+// Records tf.data service cross-trainer cache disk usage in bytes.
+void RecordTFDataServiceCrossTrainerCacheDiskSizeBytes(size_t bytes);
+
+// Returns a counter that can be used to record the lookups of elements in
+// `tier` of the tf.data caches which the tier held, if `hit`, or did not hold.
+monitoring::CounterCell* GetTFDataCacheLookupCounter(const std::string& tier,
+                                                     bool hit);
+
+// Records the bytes of the elements held in `tier` of the tf.data caches.
+void RecordTFDataCacheResidentBytes(const std::string& tier, int64_t bytes);
+
 // Records tf.data distributed snapshot bytes committed.
 void RecordTFDataServiceSnapshotBytesCommitted(int64_t bytes);
 
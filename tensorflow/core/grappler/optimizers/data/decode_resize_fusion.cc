@@ -0,0 +1,181 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/data/decode_resize_fusion.h"
+
+#include <cstdint>
+#include <string>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "tensorflow/core/framework/attr_value.pb.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/grappler/clusters/cluster.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/mutable_graph_view.h"
+#include "tensorflow/core/grappler/optimizers/custom_graph_optimizer_registry.h"
+#include "tensorflow/core/grappler/optimizers/data/graph_utils.h"
+#include "tensorflow/core/grappler/utils.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+constexpr char kFusedOpName[] = "_DecodeAndResizeJpeg";
+constexpr char kDecodeJpeg[] = "DecodeJpeg";
+constexpr char kDecodeAndCropJpeg[] = "DecodeAndCropJpeg";
+
+// Whether `node` is a Const node holding the axis 0.
+bool IsZeroAxis(const NodeDef& node) {
+  if (node.op() != "Const") return false;
+  Tensor axis;
+  if (!GetNodeAttr(node, "value", &axis).ok() || axis.NumElements() != 1) {
+    return false;
+  }
+  if (axis.dtype() == DT_INT32) return axis.flat<int32_t>()(0) == 0;
+  if (axis.dtype() == DT_INT64) return axis.flat<int64_t>()(0) == 0;
+  return false;
+}
+
+// Whether the only consumer of `node` is `consumer`, so that `node` can be
+// removed once `consumer` is fused.
+bool HasSingleConsumer(const NodeDef& node,
+                       const absl::flat_hash_set<std::string>& preserve,
+                       const MutableGraphView& graph) {
+  return !preserve.contains(node.name()) &&
+         graph.NumFanouts(node, /*include_controlled_nodes=*/true) == 1;
+}
+
+// Returns the decode node whose output the `resize` node resizes through
+// ExpandDims, or nullptr if the nodes do not match the pattern.
+NodeDef* GetDecodeNode(const NodeDef& resize,
+                       const absl::flat_hash_set<std::string>& preserve,
+                       const MutableGraphView& graph) {
+  DataType type;
+  if (!GetNodeAttr(resize, "T", &type).ok() || type != DT_UINT8) {
+    return nullptr;
+  }
+  NodeDef* expand_dims = graph_utils::GetInputNode(resize, graph, 0);
+  if (expand_dims == nullptr || expand_dims->op() != "ExpandDims" ||
+      !HasSingleConsumer(*expand_dims, preserve, graph)) {
+    return nullptr;
+  }
+  NodeDef* axis = graph_utils::GetInputNode(*expand_dims, graph, 1);
+  if (axis == nullptr || !IsZeroAxis(*axis)) return nullptr;
+  NodeDef* decode = graph_utils::GetInputNode(*expand_dims, graph, 0);
+  if (decode == nullptr ||
+      (decode->op() != kDecodeJpeg && decode->op() != kDecodeAndCropJpeg) ||
+      !HasSingleConsumer(*decode, preserve, graph)) {
+    return nullptr;
+  }
+  // The fused op chooses the DCT scale itself.
+  int ratio = 1;
+  if (GetNodeAttr(*decode, "ratio", &ratio).ok() && ratio != 1) {
+    return nullptr;
+  }
+  return decode;
+}
+
+NodeDef MakeDecodeAndResizeNode(const NodeDef& decode,
+                                const NodeDef& expand_dims,
+                                const NodeDef& resize,
+                                MutableGraphView* graph) {
+  NodeDef new_node;
+  new_node.set_op(kFusedOpName);
+  graph_utils::SetUniqueGraphNodeName(kFusedOpName, graph->graph(), &new_node);
+  new_node.set_device(resize.device());
+
+  // Set the `contents` input argument.
+  new_node.add_input(decode.input(0));
+
+  // Set the `crop_window` input argument.
+  if (decode.op() == kDecodeAndCropJpeg) {
+    new_node.add_input(decode.input(1));
+  } else {
+    AttrValue value;
+    Tensor(DT_INT32, TensorShape({0}))
+        .AsProtoTensorContent(value.mutable_tensor());
+    AttrValue dtype;
+    dtype.set_type(DT_INT32);
+    NodeDef* crop_window = graph_utils::AddNode(
+        /*name=*/"", "Const", /*inputs=*/{},
+        {{"dtype", dtype}, {"value", value}}, graph);
+    crop_window->set_device(resize.device());
+    new_node.add_input(crop_window->name());
+  }
+
+  // Set the `size` input argument.
+  new_node.add_input(resize.input(1));
+
+  // Keep the control dependencies of the fused nodes.
+  for (const NodeDef* node : {&decode, &expand_dims, &resize}) {
+    for (const std::string& input : node->input()) {
+      if (IsControlInput(input)) new_node.add_input(input);
+    }
+  }
+
+  for (auto key : {"channels", "fancy_upscaling", "try_recover_truncated",
+                   "acceptable_fraction", "dct_method"}) {
+    if (decode.attr().contains(key)) {
+      graph_utils::CopyAttribute(key, decode, &new_node);
+    }
+  }
+  for (auto key : {"align_corners", "half_pixel_centers"}) {
+    if (resize.attr().contains(key)) {
+      graph_utils::CopyAttribute(key, resize, &new_node);
+    }
+  }
+  return new_node;
+}
+
+}  // namespace
+
+absl::Status DecodeResizeFusion::OptimizeAndCollectStats(
+    Cluster* cluster, const GrapplerItem& item, GraphDef* output,
+    OptimizationStats* stats) {
+  *output = item.graph;
+  MutableGraphView graph(output);
+  const absl::flat_hash_set<std::string> preserve = item.NodesToPreserve();
+  absl::flat_hash_set<std::string> nodes_to_delete;
+  for (const NodeDef& node : item.graph.node()) {
+    if (node.op() != "ResizeBilinear" || preserve.contains(node.name())) {
+      continue;
+    }
+    NodeDef* decode = GetDecodeNode(node, preserve, graph);
+    if (decode == nullptr) continue;
+    NodeDef* expand_dims = graph_utils::GetInputNode(node, graph, 0);
+
+    auto* new_node = graph.AddNode(
+        MakeDecodeAndResizeNode(*decode, *expand_dims, node, &graph));
+    TF_RETURN_IF_ERROR(graph.UpdateFanouts(node.name(), new_node->name()));
+
+    // Mark the decode, ExpandDims and ResizeBilinear nodes for removal.
+    nodes_to_delete.insert(decode->name());
+    nodes_to_delete.insert(expand_dims->name());
+    nodes_to_delete.insert(node.name());
+    stats->num_changes++;
+  }
+
+  TF_RETURN_IF_ERROR(graph.DeleteNodes(nodes_to_delete));
+  return absl::OkStatus();
+}
+
+REGISTER_GRAPH_OPTIMIZER_AS(DecodeResizeFusion, "decode_resize_fusion");
+
+}  // namespace grappler
+}  // namespace tensorflow
@@ -0,0 +1,137 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/data/decode_resize_fusion.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "tensorflow/core/framework/attr_value_util.h"
+#include "tensorflow/core/framework/function_testlib.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/optimizers/data/graph_utils.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+using test::function::NDef;
+
+// Builds the graph of `image = tf.image.resize(tf.expand_dims(decode, 0),
+// size)`, where `decode` is the given decode node, followed by `extra_nodes`.
+GrapplerItem MakeItem(const NodeDef& decode,
+                      const std::vector<NodeDef>& extra_nodes = {}) {
+  GrapplerItem item;
+  std::vector<NodeDef> nodes = {
+      NDef("contents", "Placeholder", {}, {{"dtype", DT_STRING}}),
+      NDef("crop_window", "Const", {},
+           {{"value", test::AsTensor<int32_t>({0, 0, 64, 64})},
+            {"dtype", DT_INT32}}),
+      decode,
+      NDef("axis", "Const", {},
+           {{"value", test::AsScalar<int32_t>(0)}, {"dtype", DT_INT32}}),
+      NDef("expand_dims", "ExpandDims", {"decode", "axis"},
+           {{"T", DT_UINT8}, {"Tdim", DT_INT32}}),
+      NDef("size", "Const", {},
+           {{"value", test::AsTensor<int32_t>({32, 32})}, {"dtype", DT_INT32}}),
+      NDef("resize", "ResizeBilinear", {"expand_dims", "size"},
+           {{"T", DT_UINT8}, {"half_pixel_centers", true}}),
+      NDef("Sink", "Identity", {"resize"}, {{"T", DT_FLOAT}})};
+  nodes.insert(nodes.end(), extra_nodes.begin(), extra_nodes.end());
+  item.graph = test::function::GDef(nodes);
+  item.fetch.push_back("Sink");
+  return item;
+}
+
+const NodeDef& GetFusedNode(const GraphDef& output) {
+  return output.node(
+      graph_utils::FindGraphNodeWithOp("_DecodeAndResizeJpeg", output));
+}
+
+TEST(DecodeResizeFusionTest, FuseDecodeJpeg) {
+  GrapplerItem item = MakeItem(NDef("decode", "DecodeJpeg", {"contents"},
+                                    {{"channels", 3}, {"dct_method", ""}}));
+  DecodeResizeFusion optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  EXPECT_FALSE(graph_utils::ContainsGraphNodeWithName("decode", output));
+  EXPECT_FALSE(graph_utils::ContainsGraphNodeWithName("expand_dims", output));
+  EXPECT_FALSE(graph_utils::ContainsGraphNodeWithName("resize", output));
+  ASSERT_TRUE(graph_utils::ContainsNodeWithOp("_DecodeAndResizeJpeg", output));
+  const NodeDef& fused_node = GetFusedNode(output);
+  ASSERT_EQ(fused_node.input_size(), 3);
+  EXPECT_EQ(fused_node.input(0), "contents");
+  EXPECT_EQ(fused_node.input(2), "size");
+  const NodeDef& crop_window = output.node(
+      graph_utils::FindGraphNodeWithName(fused_node.input(1), output));
+  EXPECT_EQ(crop_window.op(), "Const");
+  EXPECT_EQ(
+      crop_window.attr().at("value").tensor().tensor_shape().dim(0).size(), 0);
+  EXPECT_EQ(fused_node.attr().at("channels").i(), 3);
+  EXPECT_TRUE(fused_node.attr().at("half_pixel_centers").b());
+  EXPECT_FALSE(fused_node.attr().contains("T"));
+  EXPECT_EQ(output.node(graph_utils::FindGraphNodeWithName("Sink", output))
+                .input(0),
+            fused_node.name());
+}
+
+TEST(DecodeResizeFusionTest, FuseDecodeAndCropJpeg) {
+  GrapplerItem item =
+      MakeItem(NDef("decode", "DecodeAndCropJpeg", {"contents", "crop_window"},
+                    {{"channels", 3}}));
+  DecodeResizeFusion optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  EXPECT_FALSE(graph_utils::ContainsGraphNodeWithName("decode", output));
+  ASSERT_TRUE(graph_utils::ContainsNodeWithOp("_DecodeAndResizeJpeg", output));
+  const NodeDef& fused_node = GetFusedNode(output);
+  ASSERT_EQ(fused_node.input_size(), 3);
+  EXPECT_EQ(fused_node.input(0), "contents");
+  EXPECT_EQ(fused_node.input(1), "crop_window");
+  EXPECT_EQ(fused_node.input(2), "size");
+}
+
+TEST(DecodeResizeFusionTest, DontFuseIfDecodedImageIsUsed) {
+  GrapplerItem item =
+      MakeItem(NDef("decode", "DecodeJpeg", {"contents"}, {{"channels", 3}}),
+               {NDef("Sink2", "Identity", {"decode"}, {{"T", DT_UINT8}})});
+  item.fetch.push_back("Sink2");
+  DecodeResizeFusion optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+  EXPECT_TRUE(graph_utils::ContainsGraphNodeWithName("decode", output));
+  EXPECT_TRUE(graph_utils::ContainsGraphNodeWithName("resize", output));
+  EXPECT_FALSE(graph_utils::ContainsNodeWithOp("_DecodeAndResizeJpeg", output));
+}
+
+TEST(DecodeResizeFusionTest, DontFuseDownscaledDecode) {
+  GrapplerItem item = MakeItem(NDef("decode", "DecodeJpeg", {"contents"},
+                                    {{"channels", 3}, {"ratio", 2}}));
+  DecodeResizeFusion optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+  EXPECT_TRUE(graph_utils::ContainsGraphNodeWithName("decode", output));
+  EXPECT_FALSE(graph_utils::ContainsNodeWithOp("_DecodeAndResizeJpeg", output));
+}
+
+}  // namespace
+}  // namespace grappler
+}  // namespace tensorflow
@@ -39,7 +39,7 @@ using ConfigMap =
 
 // tf.data optimizations, in the order we want to perform them.
 // clang-format off
-constexpr std::array<const char*, 22> kTFDataOptimizations = {
+constexpr std::array<const char*, 23> kTFDataOptimizations = {
     "noop_elimination",
     "disable_intra_op_parallelism",
     "use_private_thread_pool",
@@ -49,6 +49,7 @@ constexpr std::array<const char*, 22> kTFDataOptimizations = {
     "filter_fusion",
     "map_and_filter_fusion",
     "map_and_batch_fusion",
+    "decode_resize_fusion",
     "batch_parallelization",
     "filter_parallelization",
     "make_sloppy",
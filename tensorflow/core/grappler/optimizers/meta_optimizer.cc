@@ -18,6 +18,7 @@ limitations under the License.
 #include <algorithm>
 #include <cstdint>
 #include <functional>
+#include <list>
 #include <memory>
 #include <set>
 #include <string>
@@ -25,11 +26,13 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
@@ -82,8 +85,13 @@ limitations under the License.
 #include "tensorflow/core/grappler/verifiers/structure_verifier.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/gtl/map_util.h"
+#include "tensorflow/core/lib/strings/proto_serialization.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/fingerprint.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/statusor.h"
+#include "tensorflow/core/platform/threadpool.h"
 #include "tensorflow/core/util/device_name_utils.h"
 #include "tensorflow/core/util/dump_graph.h"
 #include "tensorflow/core/util/util.h"
@@ -156,6 +164,161 @@ uint64_t DeadlineMicroSeconds(const RewriterConfig& cfg) {
   return Env::Default()->NowMicros() + cfg.meta_optimizer_timeout_ms() * 1000;
 }
 
+// Returns the earlier of the meta optimizer deadline `deadline_usec` (0 if
+// none) and the end of the per-optimizer time budget starting now.
+uint64_t OptimizerDeadlineMicroSeconds(const RewriterConfig& cfg,
+                                       uint64_t deadline_usec) {
+  if (cfg.optimizer_timeout_ms() <= 0) return deadline_usec;
+  const uint64_t budget_deadline_usec =
+      Env::Default()->NowMicros() + cfg.optimizer_timeout_ms() * 1000;
+  if (deadline_usec == 0) return budget_deadline_usec;
+  return std::min(deadline_usec, budget_deadline_usec);
+}
+
+// A process-wide cache of optimized library functions. Models often have many
+// structurally identical functions (e.g. one per tf.function signature), and
+// the same functions are optimized again every time the model is loaded.
+class FunctionOptimizationCache {
+ public:
+  struct Entry {
+    // The optimized function. Its name is the name of the function that was
+    // optimized first.
+    FunctionDef optimized_func;
+    // Functions added to the library by the optimization, e.g. function
+    // specializations, which the optimized function might call.
+    std::vector<FunctionDef> new_funcs;
+  };
+
+  static FunctionOptimizationCache* Global() {
+    static FunctionOptimizationCache* cache = new FunctionOptimizationCache();
+    return cache;
+  }
+
+  std::shared_ptr<const Entry> Lookup(const Fprint128& key) {
+    mutex_lock l(mu_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) return nullptr;
+    lru_.splice(lru_.begin(), lru_, it->second.lru_position);
+    return it->second.entry;
+  }
+
+  // Inserts the optimized function, and evicts the least recently used
+  // functions while the cache is over its size budget.
+  void Insert(const Fprint128& key, Entry entry) {
+    size_t size_bytes = entry.optimized_func.ByteSizeLong();
+    for (const FunctionDef& func : entry.new_funcs) {
+      size_bytes += func.ByteSizeLong();
+    }
+    if (size_bytes > kMaxSizeBytes) return;
+
+    mutex_lock l(mu_);
+    EraseLocked(key);
+    while (size_bytes_ + size_bytes > kMaxSizeBytes) EraseLocked(lru_.back());
+    lru_.push_front(key);
+    entries_[key] = {std::make_shared<const Entry>(std::move(entry)),
+                     size_bytes, lru_.begin()};
+    size_bytes_ += size_bytes;
+  }
+
+  void Clear() {
+    mutex_lock l(mu_);
+    entries_.clear();
+    lru_.clear();
+    size_bytes_ = 0;
+  }
+
+ private:
+  // The budget of the serialized sizes of the cached functions.
+  static constexpr size_t kMaxSizeBytes = 256 << 20;
+
+  struct CachedEntry {
+    std::shared_ptr<const Entry> entry;
+    size_t size_bytes;
+    // The position of the key in `lru_`.
+    std::list<Fprint128>::iterator lru_position;
+  };
+
+  void EraseLocked(Fprint128 key) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    auto it = entries_.find(key);
+    if (it == entries_.end()) return;
+    size_bytes_ -= it->second.size_bytes;
+    lru_.erase(it->second.lru_position);
+    entries_.erase(it);
+  }
+
+  mutex mu_;
+  absl::flat_hash_map<Fprint128, CachedEntry, Fprint128Hasher> entries_
+      TF_GUARDED_BY(mu_);
+  // The keys of `entries_`, from the most to the least recently used.
+  std::list<Fprint128> lru_ TF_GUARDED_BY(mu_);
+  size_t size_bytes_ TF_GUARDED_BY(mu_) = 0;
+};
+
+// Returns the key of the optimized `func` in the FunctionOptimizationCache.
+// The key covers everything the function body optimization depends on: the
+// function itself, except for its name, the functions it calls, the options of
+// its GrapplerItem, the config of the meta optimizer and the devices of the
+// cluster.
+Fprint128 FunctionOptimizationCacheKey(
+    const FunctionDef& func, const GrapplerFunctionItem& func_item,
+    const RewriterConfig& cfg, const Cluster* cluster, int producer,
+    bool xla_auto_clustering_on,
+    const absl::flat_hash_set<std::string>& optimizer_filter) {
+  std::string serialized;
+  const auto fingerprint = [&serialized](const protobuf::MessageLite& proto) {
+    serialized.clear();
+    SerializeToStringDeterministic(proto, &serialized);
+    return Fingerprint128(serialized);
+  };
+
+  FunctionDef unnamed_func = func;
+  unnamed_func.mutable_signature()->clear_name();
+  Fprint128 key = fingerprint(unnamed_func);
+  key = tsl::FingerprintCat128(key, fingerprint(cfg));
+
+  // The library of the function item holds the functions reachable from it.
+  // The function itself is covered above without its name.
+  std::vector<const FunctionDef*> callees;
+  for (const FunctionDef& callee : func_item.graph.library().function()) {
+    if (callee.signature().name() == func.signature().name()) continue;
+    callees.push_back(&callee);
+  }
+  std::sort(callees.begin(), callees.end(),
+            [](const FunctionDef* a, const FunctionDef* b) {
+              return a->signature().name() < b->signature().name();
+            });
+  for (const FunctionDef* callee : callees) {
+    key = tsl::FingerprintCat128(key, fingerprint(*callee));
+  }
+  std::vector<std::string> gradients;
+  for (const GradientDef& gradient : func_item.graph.library().gradient()) {
+    gradients.push_back(
+        absl::StrCat(gradient.function_name(), ":", gradient.gradient_func()));
+  }
+  std::sort(gradients.begin(), gradients.end());
+
+  std::vector<std::string> devices;
+  if (cluster != nullptr) devices = cluster->GetDeviceNames();
+  std::sort(devices.begin(), devices.end());
+  std::vector<std::string> filter(optimizer_filter.begin(),
+                                  optimizer_filter.end());
+  std::sort(filter.begin(), filter.end());
+
+  const GrapplerItem::OptimizationOptions& options =
+      func_item.optimization_options();
+  return tsl::FingerprintCat128(
+      key,
+      Fingerprint128(absl::StrCat(
+          absl::StrJoin(gradients, ","), ";", absl::StrJoin(devices, ","), ";",
+          absl::StrJoin(filter, ","), ";", producer, ";",
+          static_cast<int>(xla_auto_clustering_on), ";",
+          static_cast<int>(options.allow_non_differentiable_rewrites), ";",
+          static_cast<int>(options.allow_pruning_stateful_and_dataset_ops),
+          ";", static_cast<int>(options.optimize_function_library), ";",
+          static_cast<int>(options.is_eager_mode), ";",
+          options.intra_op_parallelism_threads)));
+}
+
 // A helper function to decide whether to enable the automatic mixed precision
 // optimizer.
 bool AutoMixedPrecisionEnabled(RewriterConfig::Toggle opt_level) {
@@ -781,7 +944,8 @@ void MetaOptimizer::PrintUserAndPluginConfigs(
 
 absl::Status MetaOptimizer::OptimizeGraph(
     const std::vector<std::unique_ptr<GraphOptimizer>>& optimizers,
-    Cluster* cluster, GrapplerItem&& item, GraphDef* optimized_graph) {
+    Cluster* cluster, GrapplerItem&& item, GraphDef* optimized_graph,
+    GraphOptimizationResult* optimization_result_out) {
   int min_graph_nodes = cfg_.min_graph_nodes() == 0 ? kDefaultMinGraphNodes
                                                     : cfg_.min_graph_nodes();
   if (item.graph.node_size() < min_graph_nodes) {
@@ -913,7 +1077,13 @@ absl::Status MetaOptimizer::OptimizeGraph(
                                    }) != optimization_result.results.end();
 
   // Record graph optimization result.
-  optimization_results_.push_back(optimization_result);
+  if (optimization_result_out != nullptr) {
+    *optimization_result_out = optimization_result;
+  }
+  {
+    mutex_lock l(mu_);
+    optimization_results_.push_back(optimization_result);
+  }
 
   if (is_optimized) {
     TF_RETURN_IF_ERROR(TopologicalSort(optimized_graph));
@@ -927,7 +1097,8 @@ absl::Status MetaOptimizer::OptimizeGraph(
 
 absl::Status MetaOptimizer::OptimizeGraph(
     Cluster* cluster, GrapplerItem&& item, GraphDef* optimized_graph,
-    const absl::flat_hash_set<std::string>& optimizer_filter) {
+    const absl::flat_hash_set<std::string>& optimizer_filter,
+    GraphOptimizationResult* optimization_result) {
   std::vector<std::unique_ptr<GraphOptimizer>> optimizers;
   std::set<std::string> device_types;
   TF_RETURN_IF_ERROR(GetGraphDevice(item.graph, &device_types));
@@ -943,7 +1114,7 @@ absl::Status MetaOptimizer::OptimizeGraph(
   PrintUserAndPluginConfigs(device_types);
 
   return OptimizeGraph(std::move(optimizers), cluster, std::move(item),
-                       optimized_graph);
+                       optimized_graph, optimization_result);
 }
 
 absl::Status MetaOptimizer::RunOptimizer(
@@ -967,7 +1138,8 @@ absl::Status MetaOptimizer::RunOptimizer(
   // resets optimized_graph to an empty graph.
   optimized_item->graph = std::move(*optimized_graph);
   *optimized_graph = GraphDef();
-  optimizer->set_deadline_usec(this->deadline_usec());
+  optimizer->set_deadline_usec(
+      OptimizerDeadlineMicroSeconds(cfg_, this->deadline_usec()));
   tensorflow::metrics::ScopedCounter<2> timings(
       tensorflow::metrics::GetGraphOptimizationCounter(),
       {kGrapplerCategory, optimizer->name()});
@@ -976,6 +1148,18 @@ absl::Status MetaOptimizer::RunOptimizer(
   auto duration_ms = timings.DurationMicroSec().value() / 1000.0f;
   timings.ReportAndStop();
 
+  {
+    mutex_lock l(mu_);
+    OptimizerStats& stats = optimizer_stats_[optimizer->name()];
+    ++stats.num_runs;
+    if (absl::IsDeadlineExceeded(status)) ++stats.num_timeouts;
+    stats.total_ms += duration_ms;
+    if (duration_ms > stats.max_ms) {
+      stats.max_ms = duration_ms;
+      stats.slowest_item_id = optimization_result->id;
+    }
+  }
+
   std::string message;
   if (!status.ok()) {
     *optimized_graph = std::move(optimized_item->graph);
@@ -1086,7 +1270,11 @@ absl::Status MetaOptimizer::OptimizeConsumeItem(Cluster* cluster,
       {kGrapplerCategory, "*"});
 
   VLOG(1) << "Starting optimization for grappler item: " << item.id;
-  optimization_results_.clear();
+  {
+    mutex_lock l(mu_);
+    optimization_results_.clear();
+    optimizer_stats_.clear();
+  }
 
   // Constructs a FunctionLibraryDefinition with functions that are reachable
   // from the nodes of the graph.
@@ -1195,11 +1383,203 @@ absl::Status MetaOptimizer::OptimizeConsumeItem(Cluster* cluster,
   // True if this is a TPU graph using the old bridge.
   bool is_tpu_graph = IsLegacyTPUBridgeGraphDef(*optimized_graph);
 
+  absl::flat_hash_set<std::string> optimizer_filter;
+  if (is_tpu_graph) {
+    // Skip optimizing functions if this is a TPU graph. Currently, Grappler
+    // passes do not handle TPU functions correctly in a variety of ways
+    // (Note that due to the pre-placement TPU graph rewriting passes, the
+    // TPU-related ops are encapsulated away into functions). For example,
+    // TPU graphs contain TPUReplicateMetadata node that carries relevant
+    // TPU metadata and Grappler passes could prune that away. Grappler
+    // passes could also cause issues around shape inference. Since the
+    // desired and existing behavior is to not optimize TPU functions with
+    // Grappler, this check preserves that. The only exceptions are
+    // 1) implementation selector, which is required to swap in some TPU
+    //    specific lowering code and is verified the work correctly on TPUs
+    // 2) batch op rewriter, which rewrites batch op attributes and is
+    //    verified to work correctly on TPUs.
+    optimizer_filter = {"implementation_selector", "batch_op_rewriter"};
+  }
+
+  const bool cache_functions = cfg_.cache_function_optimizations();
+  std::unique_ptr<thread::ThreadPool> thread_pool;
+  if (cfg_.function_optimization_threads() > 1) {
+    thread_pool = std::make_unique<thread::ThreadPool>(
+        Env::Default(), "grappler_function_optimization",
+        cfg_.function_optimization_threads());
+  }
+
+  // The optimization of a single library function.
+  struct FunctionOptimization {
+    const FunctionDef* func = nullptr;
+    GrapplerFunctionItem item;
+    GraphDef optimized_graph;
+    absl::Status status;
+    Fprint128 cache_key;
+    // The cached optimization of an identical function, if any.
+    std::shared_ptr<const FunctionOptimizationCache::Entry> cached;
+    // True if an identical function earlier in the pass is optimized instead,
+    // so that this one reuses its cached optimization.
+    bool reuses_earlier = false;
+    // True if all optimizers succeeded, so that the result can be cached.
+    bool cacheable = false;
+  };
+
+  // Optimizes the function body graph. Doesn't modify `flib`.
+  const auto optimize_function_body =
+      [&](FunctionOptimization& function) -> absl::Status {
+    GRAPPLER_RETURN_IF_DEADLINE_EXCEEDED();
+    GraphOptimizationResult optimization_result(function.item.id);
+    GrapplerFunctionItem func_item_copy = function.item;
+    TF_RETURN_IF_ERROR(OptimizeGraph(cluster, std::move(func_item_copy),
+                                     &function.optimized_graph,
+                                     optimizer_filter, &optimization_result));
+    function.cacheable =
+        std::all_of(optimization_result.results.begin(),
+                    optimization_result.results.end(),
+                    [](const OptimizerResult& result) {
+                      return result.status.ok();
+                    });
+    return absl::OkStatus();
+  };
+
+  // Makes a GrapplerItem from the function and looks up the optimization of an
+  // identical function. Doesn't modify `flib`, so it is safe to run
+  // concurrently for the functions of a pass.
+  const auto prepare_function =
+      [&](FunctionOptimization& function) -> absl::Status {
+    GRAPPLER_RETURN_IF_DEADLINE_EXCEEDED();
+    const std::string& func_name = function.func->signature().name();
+
+    // Make a GrapplerItem from a FunctionDef.
+    GrapplerFunctionItem& func_item = function.item;
+    TF_RETURN_IF_ERROR(
+        MakeGrapplerFunctionItem(*function.func, flib, producer, &func_item));
+
+    // If we need to compute the gradient of optimized function at runtime, we
+    // can't perform non-differentiable rewrites.
+    func_item.optimization_options().allow_non_differentiable_rewrites =
+        !differentiable_functions.contains(func_name);
+
+    // Device set available to the function is defined only by the runtime,
+    // when we instantiate and execute the function. We can't use all devices
+    // available to the main graph, because after partitioning the function
+    // call node might execute on a remote worker.
+    if (!func_item.devices().empty()) {
+      return absl::InternalError("GrapplerFunctionItem devices must be empty.");
+    }
+
+    // We are not allowed to prune certain types of ops from the graph
+    // instantiated by the function definition, because we must guarantee
+    // function execution semantics wrt side effects (see
+    // function_optimizer.cc).
+    func_item.optimization_options().allow_pruning_stateful_and_dataset_ops =
+        false;
+
+    if (cache_functions) {
+      function.cache_key = FunctionOptimizationCacheKey(
+          *function.func, func_item, cfg_, cluster, producer,
+          xla_auto_clustering_on_, optimizer_filter);
+      function.cached =
+          FunctionOptimizationCache::Global()->Lookup(function.cache_key);
+    }
+    return absl::OkStatus();
+  };
+
+  // Optimizes the function, unless an identical function was optimized before.
+  const auto optimize_function =
+      [&](FunctionOptimization& function) -> absl::Status {
+    TF_RETURN_IF_ERROR(prepare_function(function));
+    if (function.cached != nullptr) return absl::OkStatus();
+    return optimize_function_body(function);
+  };
+
+  // Adds the functions created by a cached optimization to `flib`. Returns
+  // false, and leaves `flib` unchanged, if any of them conflicts with a
+  // different function of the same name.
+  const auto add_cached_functions =
+      [&](const FunctionOptimizationCache::Entry& cached)
+      -> absl::StatusOr<bool> {
+    for (const FunctionDef& func_def : cached.new_funcs) {
+      const FunctionDef* existing = flib.Find(func_def.signature().name());
+      if (existing != nullptr && !FunctionDefsEqual(*existing, func_def)) {
+        return false;
+      }
+    }
+    for (const FunctionDef& func_def : cached.new_funcs) {
+      if (flib.Find(func_def.signature().name()) == nullptr) {
+        TF_RETURN_IF_ERROR(flib.AddFunctionDef(func_def));
+      }
+    }
+    return true;
+  };
+
+  // Replaces the function in `flib` with its optimized version.
+  const auto replace_function =
+      [&](FunctionOptimization& function) -> absl::Status {
+    TF_RETURN_IF_ERROR(function.status);
+    const std::string& func_name = function.func->signature().name();
+
+    if (function.reuses_earlier) {
+      // The identical function is optimized and replaced first. Its
+      // optimization is missing from the cache if it was not cacheable.
+      function.cached =
+          FunctionOptimizationCache::Global()->Lookup(function.cache_key);
+      if (function.cached == nullptr) {
+        TF_RETURN_IF_ERROR(optimize_function_body(function));
+      }
+    }
+
+    if (function.cached != nullptr) {
+      TF_ASSIGN_OR_RETURN(bool added, add_cached_functions(*function.cached));
+      if (added) {
+        VLOG(3) << "Reuse cached optimization for function: " << func_name;
+        FunctionDef optimized_func = function.cached->optimized_func;
+        optimized_func.mutable_signature()->set_name(func_name);
+        return flib.ReplaceFunction(func_name, optimized_func);
+      }
+      TF_RETURN_IF_ERROR(optimize_function_body(function));
+    }
+
+    // Function body optimization might have created new specialized
+    // functions for each instantiation context. Add them to the library.
+    absl::flat_hash_set<std::string> input_funcs;
+    for (const FunctionDef& func_def :
+         function.item.graph.library().function()) {
+      input_funcs.insert(func_def.signature().name());
+    }
+    std::vector<FunctionDef> new_funcs;
+    for (const FunctionDef& func_def :
+         function.optimized_graph.library().function()) {
+      if (flib.Find(func_def.signature().name()) == nullptr) {
+        TF_RETURN_IF_ERROR(flib.AddFunctionDef(func_def));
+      }
+      if (cache_functions && function.cacheable &&
+          !input_funcs.contains(func_def.signature().name())) {
+        new_funcs.push_back(func_def);
+      }
+    }
+
+    // Convert optimized graph back to FunctionDef.
+    FunctionDef optimized_func;
+    function.item.SwapFunctionBody(std::move(function.optimized_graph));
+    TF_RETURN_IF_ERROR(MakeFunctionDef(function.item, flib, &optimized_func));
+
+    if (cache_functions && function.cacheable) {
+      FunctionOptimizationCache::Global()->Insert(
+          function.cache_key, {optimized_func, std::move(new_funcs)});
+    }
+
+    // Replace optimized function with a new FunctionDef.
+    return flib.ReplaceFunction(func_name, optimized_func);
+  };
+
   // Optimize each function only once.
   absl::flat_hash_set<std::string> optimized_funcs;
   while (optimize_function_library) {
     optimize_function_library = false;
 
+    std::vector<FunctionOptimization> functions;
     int function_idx = 0;
     for (const FunctionDef& func : optimized_graph->library().function()) {
       GRAPPLER_RETURN_IF_DEADLINE_EXCEEDED();
@@ -1232,72 +1612,47 @@ absl::Status MetaOptimizer::OptimizeConsumeItem(Cluster* cluster,
       optimize_function_library = true;
       optimized_funcs.insert(func_name);
 
-      // Make a GrapplerItem from a FunctionDef.
-      GrapplerFunctionItem func_item;
-      TF_RETURN_IF_ERROR(
-          MakeGrapplerFunctionItem(func, flib, producer, &func_item));
-
-      // If we need to compute the gradient of optimized function at runtime, we
-      // can't perform non-differentiable rewrites.
-      func_item.optimization_options().allow_non_differentiable_rewrites =
-          !differentiable_functions.contains(func_name);
-
-      // Device set available to the function is defined only by the runtime,
-      // when we instantiate and execute the function. We can't use all devices
-      // available to the main graph, because after partitioning the function
-      // call node might execute on a remote worker.
-      if (!func_item.devices().empty()) {
-        return absl::InternalError(
-            "GrapplerFunctionItem devices must be empty.");
-      }
+      functions.emplace_back().func = &func;
+    }
 
-      // We are not allowed to prune certain types of ops from the graph
-      // instantiated by the function definition, because we must guarantee
-      // function execution semantics wrt side effects (see
-      // function_optimizer.cc).
-      func_item.optimization_options().allow_pruning_stateful_and_dataset_ops =
-          false;
-
-      // Optimize function body graph.
-      GraphDef optimized_func_graph;
-      absl::flat_hash_set<std::string> optimizer_filter;
-      if (is_tpu_graph) {
-        // Skip optimizing functions if this is a TPU graph. Currently, Grappler
-        // passes do not handle TPU functions correctly in a variety of ways
-        // (Note that due to the pre-placement TPU graph rewriting passes, the
-        // TPU-related ops are encapsulated away into functions). For example,
-        // TPU graphs contain TPUReplicateMetadata node that carries relevant
-        // TPU metadata and Grappler passes could prune that away. Grappler
-        // passes could also cause issues around shape inference. Since the
-        // desired and existing behavior is to not optimize TPU functions with
-        // Grappler, this check preserves that. The only exceptions are
-        // 1) implementation selector, which is required to swap in some TPU
-        //    specific lowering code and is verified the work correctly on TPUs
-        // 2) batch op rewriter, which rewrites batch op attributes and is
-        //    verified to work correctly on TPUs.
-        optimizer_filter = {"implementation_selector", "batch_op_rewriter"};
-      }
-      GrapplerFunctionItem func_item_copy = func_item;
-      TF_RETURN_IF_ERROR(OptimizeGraph(cluster, std::move(func_item_copy),
-                                       &optimized_func_graph,
-                                       optimizer_filter));
-
-      // Function body optimization might have created new specialized
-      // functions for each instantiation context. Add them to the library.
-      for (const FunctionDef& func_def :
-           optimized_func_graph.library().function()) {
-        if (flib.Find(func_def.signature().name()) == nullptr) {
-          TF_RETURN_IF_ERROR(flib.AddFunctionDef(func_def));
+    if (thread_pool != nullptr && functions.size() > 1) {
+      // Optimize the functions of this pass concurrently against the library
+      // as it was at the start of the pass, then update the library in order.
+      thread_pool->ParallelFor(
+          functions.size(), thread::ThreadPool::SchedulingParams::Fixed(1),
+          [&](int64_t begin, int64_t end) {
+            for (int64_t i = begin; i < end; ++i) {
+              functions[i].status = prepare_function(functions[i]);
+            }
+          });
+      // Of the identical functions that are not cached yet, only the first
+      // one is optimized. The others reuse its optimization once it has been
+      // cached, when the library is updated.
+      std::vector<FunctionOptimization*> to_optimize;
+      absl::flat_hash_set<Fprint128, Fprint128Hasher> cache_keys;
+      for (FunctionOptimization& function : functions) {
+        if (!function.status.ok() || function.cached != nullptr) continue;
+        if (cache_functions && !cache_keys.insert(function.cache_key).second) {
+          function.reuses_earlier = true;
+          continue;
         }
+        to_optimize.push_back(&function);
+      }
+      thread_pool->ParallelFor(
+          to_optimize.size(), thread::ThreadPool::SchedulingParams::Fixed(1),
+          [&](int64_t begin, int64_t end) {
+            for (int64_t i = begin; i < end; ++i) {
+              to_optimize[i]->status = optimize_function_body(*to_optimize[i]);
+            }
+          });
+      for (FunctionOptimization& function : functions) {
+        TF_RETURN_IF_ERROR(replace_function(function));
+      }
+    } else {
+      for (FunctionOptimization& function : functions) {
+        function.status = optimize_function(function);
+        TF_RETURN_IF_ERROR(replace_function(function));
       }
-
-      // Convert optimized graph back to FunctionDef.
-      FunctionDef optimized_func;
-      func_item.SwapFunctionBody(std::move(optimized_func_graph));
-      TF_RETURN_IF_ERROR(MakeFunctionDef(func_item, flib, &optimized_func));
-
-      // Replace optimized function with a new FunctionDef.
-      TF_RETURN_IF_ERROR(flib.ReplaceFunction(func_name, optimized_func));
     }
 
     // If optimized at least one function, update the graph library.
@@ -1345,6 +1700,7 @@ absl::Status MetaOptimizer::OptimizeConsumeItem(Cluster* cluster,
 }
 
 std::string MetaOptimizer::GetResultString() const {
+  mutex_lock l(mu_);
   std::string result_string;
   for (const GraphOptimizationResult& graph_result : optimization_results_) {
     absl::StrAppend(&result_string,
@@ -1355,11 +1711,32 @@ std::string MetaOptimizer::GetResultString() const {
                       result.message, "\n");
     }
   }
+
+  // Summarize the time spent by each optimizer, the slowest first.
+  std::vector<std::pair<std::string, OptimizerStats>> optimizer_stats(
+      optimizer_stats_.begin(), optimizer_stats_.end());
+  std::sort(optimizer_stats.begin(), optimizer_stats.end(),
+            [](const auto& a, const auto& b) {
+              return a.second.total_ms > b.second.total_ms;
+            });
+  if (!optimizer_stats.empty()) {
+    absl::StrAppend(&result_string, "Optimizer time summary:\n");
+  }
+  for (const auto& [name, stats] : optimizer_stats) {
+    absl::StrAppend(&result_string, "  ", name, ": total = ", stats.total_ms,
+                    "ms, runs = ", stats.num_runs, ", timeouts = ",
+                    stats.num_timeouts, ", max = ", stats.max_ms, "ms (",
+                    stats.slowest_item_id, ")\n");
+  }
   return result_string;
 }
 
 void MetaOptimizer::PrintResult() { VLOG(1) << GetResultString(); }
 
+void ClearFunctionOptimizationCacheForTesting() {
+  FunctionOptimizationCache::Global()->Clear();
+}
+
 bool MetaOptimizerEnabled(const ConfigProto& cfg) {
   const auto& rewrite_cfg = cfg.graph_options().rewrite_options();
   if (rewrite_cfg.disable_meta_optimizer()) {
@@ -16,6 +16,14 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_META_OPTIMIZER_H_
 #define TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_META_OPTIMIZER_H_
 
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "tensorflow/core/common_runtime/device_set.h"
 #include "tensorflow/core/framework/device_base.h"
 #include "tensorflow/core/framework/function.h"
@@ -24,6 +32,8 @@ limitations under the License.
 #include "tensorflow/core/grappler/optimizers/graph_optimizer.h"
 #include "tensorflow/core/grappler/verifiers/graph_verifier.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
 #include "tensorflow/core/protobuf/config.pb.h"
 #include "tensorflow/core/protobuf/rewriter_config.pb.h"
 #include "tensorflow/core/protobuf/verifier_config.pb.h"
@@ -91,20 +101,6 @@ class MetaOptimizer : public GraphOptimizer {
   void PrintUserAndPluginConfigs(
       const std::set<std::string>& device_types) const;
 
-  // Run optimization pass over a single GrapplerItem. Meta optimizer might run
-  // multiple such passes: 1) for the main graph 2) for the function library
-  absl::Status OptimizeGraph(
-      const std::vector<std::unique_ptr<GraphOptimizer>>& optimizers,
-      Cluster* cluster, GrapplerItem&& item, GraphDef* optimized_graph);
-  absl::Status OptimizeGraph(
-      Cluster* cluster, GrapplerItem&& item, GraphDef* optimized_graph,
-      const absl::flat_hash_set<std::string>& optimizer_filter = {});
-
-  DeviceBase* const cpu_device_;  // may be NULL
-  ConfigProto config_proto_;
-  RewriterConfig& cfg_;
-  bool xla_auto_clustering_on_;
-
   struct OptimizerResult {
     std::string optimizer_name;
     std::string message;
@@ -117,16 +113,54 @@ class MetaOptimizer : public GraphOptimizer {
     std::vector<OptimizerResult> results;
   };
 
+  // Time spent by an optimizer across all the GrapplerItems it optimized.
+  struct OptimizerStats {
+    int64_t num_runs = 0;
+    int64_t num_timeouts = 0;
+    double total_ms = 0;
+    double max_ms = 0;
+    // Id of the GrapplerItem that took the optimizer the longest.
+    std::string slowest_item_id;
+  };
+
+  // Run optimization pass over a single GrapplerItem. Meta optimizer might run
+  // multiple such passes: 1) for the main graph 2) for the function library.
+  // If `optimization_result` is not null, the results of the optimizers are
+  // also copied to it.
+  absl::Status OptimizeGraph(
+      const std::vector<std::unique_ptr<GraphOptimizer>>& optimizers,
+      Cluster* cluster, GrapplerItem&& item, GraphDef* optimized_graph,
+      GraphOptimizationResult* optimization_result = nullptr);
+  absl::Status OptimizeGraph(
+      Cluster* cluster, GrapplerItem&& item, GraphDef* optimized_graph,
+      const absl::flat_hash_set<std::string>& optimizer_filter = {},
+      GraphOptimizationResult* optimization_result = nullptr);
+
+  DeviceBase* const cpu_device_;  // may be NULL
+  ConfigProto config_proto_;
+  RewriterConfig& cfg_;
+  bool xla_auto_clustering_on_;
+
   absl::Status RunOptimizer(GraphOptimizer* optimizer, Cluster* cluster,
                             GrapplerItem* optimized_item,
                             GraphDef* optimized_graph,
                             GraphOptimizationResult* optimization_result);
 
-  std::vector<GraphOptimizationResult> optimization_results_;
+  // Library functions are optimized concurrently if
+  // `function_optimization_threads` is greater than 1.
+  mutable mutex mu_;
+  std::vector<GraphOptimizationResult> optimization_results_
+      TF_GUARDED_BY(mu_);
+  absl::flat_hash_map<std::string, OptimizerStats> optimizer_stats_
+      TF_GUARDED_BY(mu_);
 };
 
 bool MetaOptimizerEnabled(const ConfigProto& cfg);
 
+// Clears the process-wide cache of optimized library functions, which is
+// filled if `cache_function_optimizations` is true.
+void ClearFunctionOptimizationCacheForTesting();
+
 // Run the meta optimizer.
 //
 // If <cpu_device> is non-null, it is the device to be used for executing ops
@@ -16,8 +16,11 @@ limitations under the License.
 #include "tensorflow/core/grappler/optimizers/meta_optimizer.h"
 
 #include <atomic>
+#include <string>
+#include <vector>
 
 #include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/substitute.h"
 #include "tensorflow/cc/ops/standard_ops.h"
 #include "tensorflow/core/framework/dataset.h"
@@ -32,6 +35,7 @@ limitations under the License.
 #include "tensorflow/core/grappler/utils/grappler_test.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/gtl/map_util.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/protobuf.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/protobuf/config.pb.h"
@@ -795,6 +799,198 @@ TEST_F(MetaOptimizerTest, OptimizerDoesNotTimeOut) {
   EXPECT_EQ(original_node_size + 2, output.node_size());
 }
 
+TEST_F(MetaOptimizerTest, OptimizerExceedsTimeBudget) {
+  TrivialTestGraphInputYielder fake_input(4, 1, 10, false, {kDevice});
+  GrapplerItem item;
+  ASSERT_TRUE(fake_input.NextItem(&item));
+
+  ConfigProto config;
+  RewriterConfig& rewriter_config =
+      *config.mutable_graph_options()->mutable_rewrite_options();
+  rewriter_config.add_optimizers("SleepingOptimizer");
+  rewriter_config.set_min_graph_nodes(-1);
+  rewriter_config.set_optimizer_timeout_ms(500);
+  rewriter_config.set_meta_optimizer_iterations(RewriterConfig::ONE);
+
+  MetaOptimizer optimizer(nullptr, config);
+  GraphDef output;
+  GraphDef original = item.graph;
+  // Unlike the meta optimizer timeout, the per-optimizer time budget only
+  // skips the optimizer that ran out of time.
+  TF_EXPECT_OK(
+      optimizer.OptimizeConsumeItem(nullptr, std::move(item), &output));
+  CompareGraphs(original, output);
+  EXPECT_THAT(optimizer.GetResultString(),
+              ::testing::HasSubstr("test_optimizer exceeded deadline."));
+  EXPECT_THAT(optimizer.GetResultString(),
+              ::testing::HasSubstr("runs = 1, timeouts = 1"));
+}
+
+// Records the ids of the GrapplerItems passed for optimization.
+class ItemIdAccumulator : public CustomGraphOptimizer {
+ public:
+  static std::vector<std::string> GetItemIds() {
+    mutex_lock l(mu_);
+    return item_ids_;
+  }
+  static void ClearItemIds() {
+    mutex_lock l(mu_);
+    item_ids_.clear();
+  }
+
+  ItemIdAccumulator() {}
+  std::string name() const override { return "item_id_accumulator"; }
+  bool UsesFunctionLibrary() const override { return false; }
+
+  absl::Status Init(
+      const tensorflow::RewriterConfig_CustomGraphOptimizer* config) override {
+    return absl::OkStatus();
+  }
+
+  absl::Status Optimize(Cluster* cluster, const GrapplerItem& item,
+                        GraphDef* optimized_graph) override {
+    *optimized_graph = item.graph;
+    mutex_lock l(mu_);
+    item_ids_.push_back(item.id);
+    return absl::OkStatus();
+  }
+
+ private:
+  static mutex mu_;
+  static std::vector<std::string> item_ids_ TF_GUARDED_BY(mu_);
+};
+
+mutex ItemIdAccumulator::mu_;
+std::vector<std::string> ItemIdAccumulator::item_ids_;
+
+REGISTER_GRAPH_OPTIMIZER(ItemIdAccumulator);
+
+// Returns a graph that calls `num_functions` functions with identical bodies,
+// MyMul0 to MyMul<num_functions - 1>.
+GrapplerItem MakeItemWithIdenticalFunctions(int num_functions) {
+  using test::function::NDef;
+
+  std::vector<NodeDef> nodes = {
+      NDef("x0", "Placeholder", {}, {{"dtype", DT_FLOAT}}, kDevice),
+      NDef("x1", "Placeholder", {}, {{"dtype", DT_FLOAT}}, kDevice)};
+  std::vector<FunctionDef> functions;
+  GrapplerItem item;
+  item.id = "main";
+  for (int i = 0; i < num_functions; ++i) {
+    const std::string func_name = absl::StrCat("MyMul", i);
+    functions.push_back(FunctionDefHelper::Create(
+        func_name, {"x:float", "y:float"}, {"z:float"}, {},
+        {{{"mul"}, "Mul", {"x", "y"}, {{"T", DT_FLOAT}}}},
+        /*ret_def=*/
+        {{"z", "mul:z:0"}}));
+    const std::string node_name = absl::StrCat("mul_", i);
+    nodes.push_back(NDef(node_name, func_name, {"x0", "x1"}, {}, kDevice));
+    item.fetch.push_back(node_name);
+  }
+  item.graph = test::function::GDef(nodes, functions);
+  return item;
+}
+
+TEST_F(MetaOptimizerTest, OptimizeFunctionLibraryInParallel) {
+  ConfigProto config_proto;
+  auto& rewriter_config =
+      *config_proto.mutable_graph_options()->mutable_rewrite_options();
+  rewriter_config.set_meta_optimizer_iterations(RewriterConfig::ONE);
+  rewriter_config.add_optimizers("ItemIdAccumulator");
+  rewriter_config.set_min_graph_nodes(-1);
+  rewriter_config.set_function_optimization_threads(4);
+
+  constexpr int kNumFunctions = 16;
+  ItemIdAccumulator::ClearItemIds();
+  MetaOptimizer optimizer(nullptr, config_proto);
+  GraphDef output;
+  TF_EXPECT_OK(optimizer.OptimizeConsumeItem(
+      nullptr, MakeItemWithIdenticalFunctions(kNumFunctions), &output));
+
+  // The main graph and every function are optimized exactly once.
+  std::vector<std::string> expected_item_ids = {"main"};
+  for (int i = 0; i < kNumFunctions; ++i) {
+    expected_item_ids.push_back(absl::StrCat("MyMul", i));
+  }
+  EXPECT_THAT(ItemIdAccumulator::GetItemIds(),
+              ::testing::UnorderedElementsAreArray(expected_item_ids));
+  EXPECT_EQ(output.library().function_size(), kNumFunctions);
+}
+
+TEST_F(MetaOptimizerTest, CacheFunctionOptimizations) {
+  ConfigProto config_proto;
+  auto& rewriter_config =
+      *config_proto.mutable_graph_options()->mutable_rewrite_options();
+  rewriter_config.set_meta_optimizer_iterations(RewriterConfig::ONE);
+  rewriter_config.add_optimizers("ItemIdAccumulator");
+  rewriter_config.set_min_graph_nodes(-1);
+  rewriter_config.set_cache_function_optimizations(true);
+
+  // Identical functions are optimized once.
+  ClearFunctionOptimizationCacheForTesting();
+  ItemIdAccumulator::ClearItemIds();
+  GraphDef output;
+  TF_EXPECT_OK(MetaOptimizer(nullptr, config_proto)
+                   .OptimizeConsumeItem(
+                       nullptr, MakeItemWithIdenticalFunctions(2), &output));
+  EXPECT_THAT(ItemIdAccumulator::GetItemIds(),
+              ::testing::ElementsAre("main", ::testing::AnyOf("MyMul0",
+                                                              "MyMul1")));
+  FunctionLibraryDefinition flib(OpRegistry::Global(), output.library());
+  ASSERT_EQ(flib.num_functions(), 2);
+  ASSERT_NE(flib.Find("MyMul0"), nullptr);
+  ASSERT_NE(flib.Find("MyMul1"), nullptr);
+
+  // And are not optimized again when the graph is optimized again.
+  ItemIdAccumulator::ClearItemIds();
+  GraphDef reoptimized_output;
+  TF_EXPECT_OK(MetaOptimizer(nullptr, config_proto)
+                   .OptimizeConsumeItem(nullptr,
+                                        MakeItemWithIdenticalFunctions(2),
+                                        &reoptimized_output));
+  EXPECT_THAT(ItemIdAccumulator::GetItemIds(), ::testing::ElementsAre("main"));
+  CompareGraphs(output, reoptimized_output);
+  FunctionLibraryDefinition reoptimized_flib(OpRegistry::Global(),
+                                             reoptimized_output.library());
+  for (const std::string& func_name : {"MyMul0", "MyMul1"}) {
+    const FunctionDef* reoptimized_func = reoptimized_flib.Find(func_name);
+    ASSERT_NE(reoptimized_func, nullptr);
+    EXPECT_TRUE(FunctionDefsEqual(*flib.Find(func_name), *reoptimized_func));
+  }
+}
+
+TEST_F(MetaOptimizerTest, CacheFunctionOptimizationsInParallel) {
+  ConfigProto config_proto;
+  auto& rewriter_config =
+      *config_proto.mutable_graph_options()->mutable_rewrite_options();
+  rewriter_config.set_meta_optimizer_iterations(RewriterConfig::ONE);
+  rewriter_config.add_optimizers("ItemIdAccumulator");
+  rewriter_config.set_min_graph_nodes(-1);
+  rewriter_config.set_function_optimization_threads(4);
+  rewriter_config.set_cache_function_optimizations(true);
+
+  // Identical functions of the same pass are optimized once, although the
+  // functions of the pass are optimized concurrently.
+  constexpr int kNumFunctions = 16;
+  ClearFunctionOptimizationCacheForTesting();
+  ItemIdAccumulator::ClearItemIds();
+  GraphDef output;
+  TF_EXPECT_OK(MetaOptimizer(nullptr, config_proto)
+                   .OptimizeConsumeItem(
+                       nullptr, MakeItemWithIdenticalFunctions(kNumFunctions),
+                       &output));
+  std::vector<std::string> item_ids = ItemIdAccumulator::GetItemIds();
+  ASSERT_EQ(item_ids.size(), 2);
+  EXPECT_THAT(item_ids, ::testing::Contains("main"));
+  EXPECT_THAT(item_ids, ::testing::Contains(::testing::StartsWith("MyMul")));
+
+  FunctionLibraryDefinition flib(OpRegistry::Global(), output.library());
+  ASSERT_EQ(flib.num_functions(), kNumFunctions);
+  for (int i = 0; i < kNumFunctions; ++i) {
+    EXPECT_NE(flib.Find(absl::StrCat("MyMul", i)), nullptr);
+  }
+}
+
 TEST_F(MetaOptimizerTest, RunPostOptimizationVerifiersOnValidGraph) {
   TrivialTestGraphInputYielder fake_input(4, 1, 10, false, {kDevice});
   GrapplerItem item;
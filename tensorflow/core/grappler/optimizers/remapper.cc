@@ -83,6 +83,8 @@ namespace grappler {
 //
 // _FusedConv2D/_FusedConv3D + <Activation> -> _FusedConv2D/_FusedConv3D
 // Supported Activations: LeakyRelu, Mish
+//
+// GatherV2 + SparseSegment{Sum,Mean,SqrtN} -> _FusedSparseSegmentReduction
 
 namespace {
 
@@ -93,6 +95,7 @@ constexpr char kFusedDepthwiseConv2dNative[] = "_FusedDepthwiseConv2dNative";
 constexpr char kFusedBatchNormEx[] = "_FusedBatchNormEx";
 constexpr char kFusedBatchNormGradEx[] = "_FusedBatchNormGradEx";
 constexpr char kTensorToHashBucket[] = "_TensorToHashBucketFast";
+constexpr char kFusedSparseSegmentReduction[] = "_FusedSparseSegmentReduction";
 constexpr char kLeakyRelu[] = "LeakyRelu";
 constexpr char kMklFusedMish[] = "_MklFusedMish";
 constexpr char kRelu[] = "Relu";
@@ -171,6 +174,22 @@ struct TensorToHashBucket {
   int string_to_hash_bucket = kMissingIndex;
 };
 
+// GatherV2 of rows of the params followed by a SparseSegmentSum,
+// SparseSegmentMean or SparseSegmentSqrtN of the gathered rows, that can be
+// replaced with a _FusedSparseSegmentReduction.
+struct GatherWithSparseSegmentReduction {
+  GatherWithSparseSegmentReduction() = default;
+  GatherWithSparseSegmentReduction(int gather, int sparse_segment_reduction,
+                                   std::string combiner)
+      : gather(gather),
+        sparse_segment_reduction(sparse_segment_reduction),
+        combiner(std::move(combiner)) {}
+
+  int gather = kMissingIndex;
+  int sparse_segment_reduction = kMissingIndex;
+  std::string combiner;
+};
+
 // Pad followed by Conv3D/FusedConv3D
 struct PadWithConv3D {
   PadWithConv3D() = default;
@@ -2803,6 +2822,82 @@ bool FindTensorToHashBucket(const RemapperContext& ctx, int node_index,
   return true;
 }
 
+// Returns the combiner of a _FusedSparseSegmentReduction fusing `node`, or an
+// empty string if `node` is not a sparse segment reduction that can be fused.
+std::string SparseSegmentReductionCombiner(const NodeDef& node) {
+  if (node.op() == "SparseSegmentSum") return "sum";
+  if (node.op() == "SparseSegmentMean") return "mean";
+  if (node.op() == "SparseSegmentSqrtN") return "sqrtn";
+  return "";
+}
+
+bool FindGatherWithSparseSegmentReduction(
+    const RemapperContext& ctx, int node_index,
+    GatherWithSparseSegmentReduction* matched) {
+  // Root of the pattern must be a SparseSegmentSum, SparseSegmentMean or
+  // SparseSegmentSqrtN on CPU.
+  const auto* node_view = ctx.graph_view.GetNode(node_index);
+  const auto* node_def = node_view->node();
+
+  std::string combiner = SparseSegmentReductionCombiner(*node_def);
+  if (combiner.empty() || !NodeIsOnCpu(node_def) ||
+      HasControlFaninOrFanout(*node_view) ||
+      node_view->NumRegularFanins() < 3) {
+    return false;
+  }
+
+  // The fused kernel is only registered for floating point types.
+  if (!HasDataType(node_def, DT_FLOAT) && !HasDataType(node_def, DT_DOUBLE) &&
+      !HasDataType(node_def, DT_HALF) && !HasDataType(node_def, DT_BFLOAT16)) {
+    return false;
+  }
+
+  // Input data of the reduction must be a GatherV2 used only by the reduction.
+  const auto& regular_fanin_0 = node_view->GetRegularFanin(0);
+  const auto* gather_node_view = regular_fanin_0.node_view();
+  const auto* gather_node_def = gather_node_view->node();
+  if (gather_node_def->op() != "GatherV2" || !NodeIsOnCpu(gather_node_def) ||
+      HasControlFaninOrFanout(*gather_node_view) ||
+      !HasAtMostOneFanoutAtPort0(*gather_node_view) ||
+      IsInPreserveSet(ctx, gather_node_def) ||
+      gather_node_view->NumRegularFanins() < 3) {
+    return false;
+  }
+
+  int batch_dims = 0;
+  if (TryGetNodeAttr(*gather_node_def, "batch_dims", &batch_dims) &&
+      batch_dims != 0) {
+    return false;
+  }
+
+  // The fused kernel is only registered for int32 and int64 ids.
+  const DataType ids_dtype = GetDataTypeFromAttr(*gather_node_def, "Tindices");
+  if (ids_dtype != DT_INT32 && ids_dtype != DT_INT64) return false;
+
+  // The GatherV2 must gather rows, i.e. a vector of ids along axis 0, so that
+  // the gathered row `i` is the row `ids[i]` of the params.
+  const auto& props =
+      ctx.graph_properties.GetInputProperties(gather_node_def->name());
+  if (props.size() < 3) return false;
+  const TensorShapeProto& ids_shape = props[1].shape();
+  if (ids_shape.unknown_rank() || ids_shape.dim_size() != 1) return false;
+  if (!props[2].has_value()) return false;
+  Tensor axis;
+  if (!axis.FromProto(props[2].value()) || axis.NumElements() != 1) {
+    return false;
+  }
+  const int64_t axis_value = axis.dtype() == DT_INT32
+                                 ? axis.flat<int32_t>()(0)
+                                 : axis.flat<int64_t>()(0);
+  if (axis_value != 0) return false;
+
+  // We successfully found a GatherV2 + SparseSegmentReduction pattern.
+  *matched = GatherWithSparseSegmentReduction(
+      gather_node_view->node_index(), node_index, std::move(combiner));
+
+  return true;
+}
+
 // clang-format off
 // HardSwish pattern
 //                        input     Const (value: 3)
@@ -4526,6 +4621,50 @@ absl::Status AddTensorToHashBucketNode(RemapperContext* ctx,
   return absl::OkStatus();
 }
 
+absl::Status AddFusedSparseSegmentReductionNode(
+    RemapperContext* ctx, const GatherWithSparseSegmentReduction& matched,
+    std::vector<bool>* invalidated_nodes, std::vector<bool>* nodes_to_delete) {
+  const GraphDef* graph = ctx->graph_view.graph();
+  const NodeDef& gather = graph->node(matched.gather);
+  const NodeDef& sparse_segment_reduction =
+      graph->node(matched.sparse_segment_reduction);
+  VLOG(2) << "Fuse GatherV2 with " << sparse_segment_reduction.op() << ":"
+          << " gather=" << gather.name()
+          << " sparse_segment_reduction=" << sparse_segment_reduction.name()
+          << " on device=" << sparse_segment_reduction.device();
+
+  NodeDef fused_op;
+  fused_op.set_name(sparse_segment_reduction.name());
+  fused_op.set_device(sparse_segment_reduction.device());
+  fused_op.add_input(gather.input(0));                    // 0: params
+  fused_op.add_input(gather.input(1));                    // 1: ids
+  fused_op.add_input(sparse_segment_reduction.input(1));  // 2: indices
+  fused_op.add_input(sparse_segment_reduction.input(2));  // 3: segment_ids
+  fused_op.set_op(kFusedSparseSegmentReduction);
+
+  auto* attr = fused_op.mutable_attr();
+  auto& src_attr = sparse_segment_reduction.attr();
+  (*attr)["T"] = src_attr.at("T");
+  SetAttrValue(GetDataTypeFromAttr(gather, "Tindices"), &(*attr)["Tids"]);
+  // The index types default to int32 if the attrs are missing.
+  for (const char* type_attr : {"Tidx", "Tsegmentids"}) {
+    DataType dtype = GetDataTypeFromAttr(sparse_segment_reduction, type_attr);
+    SetAttrValue(dtype == DT_INVALID ? DT_INT32 : dtype, &(*attr)[type_attr]);
+  }
+  SetAttrValue(matched.combiner, &(*attr)["combiner"]);
+
+  utils::Mutation* mutation = ctx->graph_view.GetMutationBuilder();
+  absl::Status status;
+  mutation->AddNode(std::move(fused_op), &status);
+  TF_RETURN_IF_ERROR(status);
+  TF_RETURN_IF_ERROR(mutation->Apply());
+
+  (*invalidated_nodes)[matched.sparse_segment_reduction] = true;
+  (*nodes_to_delete)[matched.gather] = true;
+
+  return absl::OkStatus();
+}
+
 absl::Status AddFusedBatchMatMul(
     RemapperContext* ctx, const std::map<std::string, int>& matched_nodes_map,
     const std::set<int>& remove_node_indices,
@@ -4996,17 +5135,26 @@ bool RequiresInferredShapes(const RemapperContext& ctx, int node_index,
     return true;
   };
 
+  // Candidate for a GatherV2 + SparseSegmentReduction fusion.
+  const auto is_sparse_segment_reduction_candidate = [&]() -> bool {
+    if (SparseSegmentReductionCombiner(*node_def).empty()) return false;
+    if (node_view->NumRegularFanins() < 1) return false;
+    const auto& regular_fanin_0 = node_view->GetRegularFanin(0);
+    return regular_fanin_0.node_view()->node()->op() == "GatherV2";
+  };
+
   if (IsMKLEnabled())
     return is_batch_norm_candidate() || is_batch_norm_fusion_candidate() ||
            IsContractionWithAdd(ctx, node_index) ||
            is_act_biasadd_conv_candidate() || IsBiasAdd(*node_def) ||
-           IsTranspose(*node_def);
+           IsTranspose(*node_def) || is_sparse_segment_reduction_candidate();
 
   return is_act_biasadd_conv_candidate() || is_batch_norm_candidate() ||
          is_batch_norm_fusion_candidate() ||
          is_batch_norm_grad_fusion_candidate() ||
          is_matmul_gelu_exact_fusion_candidate() ||
-         is_act_biasadd_matmul_candidate();
+         is_act_biasadd_matmul_candidate() ||
+         is_sparse_segment_reduction_candidate();
 }
 
 inline bool IsXlaCpuGlobalJitOn() {
@@ -5379,6 +5527,19 @@ absl::Status Remapper::Optimize(Cluster* cluster, const GrapplerItem& item,
       continue;
     }
 
+    // Remap GatherV2+SparseSegment{Sum,Mean,SqrtN} into the
+    // _FusedSparseSegmentReduction, so that the gathered rows are not
+    // materialized.
+    GatherWithSparseSegmentReduction gather_with_sparse_segment_reduction;
+    if (allow_non_differentiable_rewrites &&
+        FindGatherWithSparseSegmentReduction(
+            ctx, i, &gather_with_sparse_segment_reduction)) {
+      TF_RETURN_IF_ERROR(AddFusedSparseSegmentReductionNode(
+          &ctx, gather_with_sparse_segment_reduction, &invalidated_nodes,
+          &nodes_to_delete));
+      continue;
+    }
+
     // During inference, most of the inputs to FusedBatchNorm are constant, and
     // we can therefore replace the op with a much cheaper set of primitives.
     FusedBatchNorm fused_batch_norm;
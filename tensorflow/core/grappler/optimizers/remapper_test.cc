@@ -1769,6 +1769,170 @@ TEST_F(RemapperTensorToHashBucketTest, I32) { RunTest<DT_INT32>(); }
 
 TEST_F(RemapperTensorToHashBucketTest, I64) { RunTest<DT_INT64>(); }
 
+class RemapperFusedSparseSegmentReductionTest : public RemapperTest {
+ public:
+  template <typename SparseSegmentReduction>
+  void RunTest(const std::string& combiner) {
+    using ::tensorflow::ops::Placeholder;
+
+    tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+
+    auto params_shape = ops::Placeholder::Shape({100, 16});
+    auto ids_shape = ops::Placeholder::Shape({20});
+    auto indices_shape = ops::Placeholder::Shape({30});
+    auto params = Placeholder(s.WithOpName("params"), DT_FLOAT, params_shape);
+    auto ids = Placeholder(s.WithOpName("ids"), DT_INT32, ids_shape);
+    auto indices =
+        Placeholder(s.WithOpName("indices"), DT_INT32, indices_shape);
+    auto segment_ids =
+        Placeholder(s.WithOpName("segment_ids"), DT_INT32, indices_shape);
+
+    auto axis = ops::Const(s.WithOpName("axis"), 0);
+    auto gather = ops::GatherV2(s.WithOpName("gather"), params, ids, axis);
+    auto reduction = SparseSegmentReduction(s.WithOpName("reduction"), gather,
+                                            indices, segment_ids);
+    auto fetch = ops::Identity(s.WithOpName("fetch"), reduction);
+
+    auto params_t = GenerateRandomTensor<DT_FLOAT>({100, 16});
+    Tensor ids_t(DT_INT32, TensorShape({20}));
+    for (int i = 0; i < 20; ++i) ids_t.flat<int32_t>()(i) = (i * 37) % 100;
+    Tensor indices_t(DT_INT32, TensorShape({30}));
+    Tensor segment_ids_t(DT_INT32, TensorShape({30}));
+    for (int i = 0; i < 30; ++i) {
+      indices_t.flat<int32_t>()(i) = (i * 7) % 20;
+      // Leaves segments 1 and 2 empty.
+      segment_ids_t.flat<int32_t>()(i) = i < 3 ? 0 : i / 3 + 2;
+    }
+
+    GrapplerItem item;
+    item.fetch = {"fetch"};
+    item.feed = {{"params", params_t},
+                 {"ids", ids_t},
+                 {"indices", indices_t},
+                 {"segment_ids", segment_ids_t}};
+    TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+
+    // Place all nodes on CPU.
+    for (int i = 0; i < item.graph.node_size(); ++i) {
+      item.graph.mutable_node(i)->set_device("/device:CPU:0");
+    }
+
+    Remapper optimizer(RewriterConfig::ON);
+    GraphDef output;
+    TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+    int found = 0;
+    for (const NodeDef& node : output.node()) {
+      EXPECT_NE(node.name(), "gather");
+      if (node.name() == "reduction") {
+        EXPECT_EQ(node.op(), "_FusedSparseSegmentReduction");
+        ASSERT_GE(node.input_size(), 4);
+        EXPECT_EQ(node.input(0), "params");
+        EXPECT_EQ(node.input(1), "ids");
+        EXPECT_EQ(node.input(2), "indices");
+        EXPECT_EQ(node.input(3), "segment_ids");
+        EXPECT_EQ(node.attr().at("combiner").s(), combiner);
+        found++;
+      }
+    }
+    EXPECT_EQ(found, 1);
+
+    auto tensors_expected = EvaluateNodes(item.graph, item.fetch, item.feed);
+    ASSERT_EQ(tensors_expected.size(), 1);
+    auto tensors = EvaluateNodes(output, item.fetch, item.feed);
+    ASSERT_EQ(tensors.size(), 1);
+    test::ExpectTensorNear<float>(tensors[0], tensors_expected[0], 1e-6);
+  }
+};
+
+TEST_F(RemapperFusedSparseSegmentReductionTest, Sum) {
+  RunTest<ops::SparseSegmentSum>("sum");
+}
+
+TEST_F(RemapperFusedSparseSegmentReductionTest, Mean) {
+  RunTest<ops::SparseSegmentMean>("mean");
+}
+
+TEST_F(RemapperFusedSparseSegmentReductionTest, SqrtN) {
+  RunTest<ops::SparseSegmentSqrtN>("sqrtn");
+}
+
+TEST_F(RemapperFusedSparseSegmentReductionTest, GatherWithOtherConsumer) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+
+  auto params = ops::Placeholder(s.WithOpName("params"), DT_FLOAT,
+                                 ops::Placeholder::Shape({100, 16}));
+  auto ids = ops::Placeholder(s.WithOpName("ids"), DT_INT32,
+                              ops::Placeholder::Shape({20}));
+  auto indices = ops::Placeholder(s.WithOpName("indices"), DT_INT32,
+                                  ops::Placeholder::Shape({30}));
+  auto segment_ids = ops::Placeholder(s.WithOpName("segment_ids"), DT_INT32,
+                                      ops::Placeholder::Shape({30}));
+  auto axis = ops::Const(s.WithOpName("axis"), 0);
+  auto gather = ops::GatherV2(s.WithOpName("gather"), params, ids, axis);
+  auto reduction = ops::SparseSegmentMean(s.WithOpName("reduction"), gather,
+                                          indices, segment_ids);
+  auto fetch = ops::Identity(s.WithOpName("fetch"), reduction);
+  auto fetch_gather = ops::Identity(s.WithOpName("fetch_gather"), gather);
+
+  GrapplerItem item;
+  item.fetch = {"fetch", "fetch_gather"};
+  TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+  for (int i = 0; i < item.graph.node_size(); ++i) {
+    item.graph.mutable_node(i)->set_device("/device:CPU:0");
+  }
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  // The gathered rows are still needed, so the reduction is not fused.
+  for (const NodeDef& node : output.node()) {
+    if (node.name() == "reduction") {
+      EXPECT_EQ(node.op(), "SparseSegmentMean");
+    }
+  }
+}
+
+TEST_F(RemapperFusedSparseSegmentReductionTest, Int16Ids) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+
+  auto params = ops::Placeholder(s.WithOpName("params"), DT_FLOAT,
+                                 ops::Placeholder::Shape({100, 16}));
+  auto ids = ops::Placeholder(s.WithOpName("ids"), DT_INT16,
+                              ops::Placeholder::Shape({20}));
+  auto indices = ops::Placeholder(s.WithOpName("indices"), DT_INT32,
+                                  ops::Placeholder::Shape({30}));
+  auto segment_ids = ops::Placeholder(s.WithOpName("segment_ids"), DT_INT32,
+                                      ops::Placeholder::Shape({30}));
+  auto axis = ops::Const(s.WithOpName("axis"), 0);
+  auto gather = ops::GatherV2(s.WithOpName("gather"), params, ids, axis);
+  auto reduction = ops::SparseSegmentSum(s.WithOpName("reduction"), gather,
+                                         indices, segment_ids);
+  auto fetch = ops::Identity(s.WithOpName("fetch"), reduction);
+
+  GrapplerItem item;
+  item.fetch = {"fetch"};
+  TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+  for (int i = 0; i < item.graph.node_size(); ++i) {
+    item.graph.mutable_node(i)->set_device("/device:CPU:0");
+  }
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  // The fused kernel has no int16 ids, so the reduction is not fused.
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    if (node.name() == "reduction") {
+      EXPECT_EQ(node.op(), "SparseSegmentSum");
+      found++;
+    }
+  }
+  EXPECT_EQ(found, 1);
+}
+
 class RemapperFuseMatMulWithBiasTest : public RemapperTest {
  public:
   template <DataType DTYPE>
@@ -0,0 +1,286 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/batching_util/adaptive_batch_timeout_controller.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/kernels/batching_util/batch_stats.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mutex.h"
+
+namespace tensorflow {
+namespace serving {
+namespace {
+
+// The decisions are updated on every processed batch, and on arrivals at most
+// this often, so that they follow changes of the arrival rate between batches.
+constexpr uint64_t kArrivalUpdateIntervalMicros = 1000;
+
+// The latency budget is scaled every this many processed batches.
+constexpr int64_t kBudgetUpdateInterval = 16;
+
+// The budget shrinks by this factor while the p99 latency is above the
+// objective, and grows back by this step while it is below
+// `kBudgetGrowthThreshold` times the objective.
+constexpr double kBudgetDecreaseFactor = 0.8;
+constexpr double kBudgetIncreaseStep = 0.05;
+constexpr double kBudgetGrowthThreshold = 0.8;
+constexpr double kMinBudgetScale = 0.05;
+
+}  // namespace
+
+absl::Status ValidateAdaptiveBatchTimeoutOptions(
+    const AdaptiveBatchTimeoutOptions& options) {
+  if (options.latency_slo_micros <= 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("latency_slo_micros must be positive; was ",
+                     options.latency_slo_micros));
+  }
+  if (options.min_batch_timeout_micros < 0 ||
+      options.max_batch_timeout_micros < 0) {
+    return absl::InvalidArgumentError(
+        "The bounds of the batch timeout must be non-negative.");
+  }
+  // The timeout is capped by the latency objective if it has no upper bound.
+  const int64_t max_batch_timeout_micros =
+      options.max_batch_timeout_micros > 0 ? options.max_batch_timeout_micros
+                                           : options.latency_slo_micros;
+  if (max_batch_timeout_micros < options.min_batch_timeout_micros) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "min_batch_timeout_micros must not exceed max_batch_timeout_micros, "
+        "or latency_slo_micros if the former is unset; was ",
+        options.min_batch_timeout_micros, " > ", max_batch_timeout_micros));
+  }
+  if (options.arrival_rate_time_constant_micros <= 0) {
+    return absl::InvalidArgumentError(
+        "arrival_rate_time_constant_micros must be positive.");
+  }
+  if (!(options.cost_smoothing > 0 && options.cost_smoothing <= 1)) {
+    return absl::InvalidArgumentError("cost_smoothing must be in (0, 1].");
+  }
+  if (options.latency_window <= 0) {
+    return absl::InvalidArgumentError("latency_window must be positive.");
+  }
+  return absl::OkStatus();
+}
+
+AdaptiveBatchTimeoutController::AdaptiveBatchTimeoutController(
+    const AdaptiveBatchTimeoutOptions& options, int64_t max_batch_size,
+    const std::vector<int32_t>& allowed_batch_sizes,
+    int64_t initial_batch_timeout_micros, Env* env,
+    ModelBatchStats* model_batch_stats)
+    : options_(options),
+      max_batch_size_(max_batch_size),
+      max_batch_timeout_micros_(options.max_batch_timeout_micros > 0
+                                    ? options.max_batch_timeout_micros
+                                    : options.latency_slo_micros),
+      env_(env),
+      model_batch_stats_(model_batch_stats),
+      batch_timeout_micros_(initial_batch_timeout_micros),
+      target_batch_size_(max_batch_size) {
+  for (int32_t batch_size : allowed_batch_sizes) {
+    if (batch_size > 0 && batch_size <= max_batch_size) {
+      candidate_batch_sizes_.push_back(batch_size);
+    }
+  }
+  std::sort(candidate_batch_sizes_.begin(), candidate_batch_sizes_.end());
+  latencies_micros_.reserve(options_.latency_window);
+
+  if (model_batch_stats_ != nullptr) {
+    model_batch_stats_->SetBatchTimeoutMicros(initial_batch_timeout_micros);
+    model_batch_stats_->SetTargetBatchSize(max_batch_size);
+  }
+}
+
+void AdaptiveBatchTimeoutController::RecordArrival(int64_t size) {
+  const uint64_t now_micros = env_->NowMicros();
+  mutex_lock l(mu_);
+  DecayArrivalRate(now_micros);
+  arrival_rate_ += static_cast<double>(size) /
+                   options_.arrival_rate_time_constant_micros;
+  if (num_batches_ > 0 &&
+      now_micros >= last_update_time_micros_ + kArrivalUpdateIntervalMicros) {
+    UpdateDecisions();
+  }
+}
+
+void AdaptiveBatchTimeoutController::RecordBatchProcessed(
+    int64_t batch_size, uint64_t earliest_task_start_time_micros,
+    uint64_t processing_start_time_micros) {
+  const uint64_t now_micros = env_->NowMicros();
+  const double processing_micros =
+      now_micros > processing_start_time_micros
+          ? now_micros - processing_start_time_micros
+          : 0;
+  const int64_t latency_micros =
+      now_micros > earliest_task_start_time_micros
+          ? now_micros - earliest_task_start_time_micros
+          : 0;
+
+  mutex_lock l(mu_);
+  const double decay = 1 - options_.cost_smoothing;
+  const double size = batch_size;
+  sum_weights_ = sum_weights_ * decay + 1;
+  sum_sizes_ = sum_sizes_ * decay + size;
+  sum_micros_ = sum_micros_ * decay + processing_micros;
+  sum_squared_sizes_ = sum_squared_sizes_ * decay + size * size;
+  sum_sizes_micros_ = sum_sizes_micros_ * decay + size * processing_micros;
+
+  if (num_batches_ < options_.latency_window) {
+    latencies_micros_.push_back(latency_micros);
+  } else {
+    latencies_micros_[num_batches_ % options_.latency_window] = latency_micros;
+  }
+  ++num_batches_;
+  if (num_batches_ % kBudgetUpdateInterval == 0) {
+    UpdateBudget();
+  }
+
+  DecayArrivalRate(now_micros);
+  UpdateDecisions();
+}
+
+double AdaptiveBatchTimeoutController::arrival_rate() const {
+  const uint64_t now_micros = env_->NowMicros();
+  mutex_lock l(mu_);
+  double arrival_rate = arrival_rate_;
+  if (now_micros > last_arrival_time_micros_) {
+    arrival_rate *= std::exp(-static_cast<double>(now_micros -
+                                                  last_arrival_time_micros_) /
+                             options_.arrival_rate_time_constant_micros);
+  }
+  return arrival_rate * 1e6;
+}
+
+std::optional<int64_t> AdaptiveBatchTimeoutController::p99_latency_micros()
+    const {
+  mutex_lock l(mu_);
+  return P99LatencyMicrosLocked();
+}
+
+void AdaptiveBatchTimeoutController::DecayArrivalRate(uint64_t now_micros) {
+  if (now_micros <= last_arrival_time_micros_) return;
+  arrival_rate_ *=
+      std::exp(-static_cast<double>(now_micros - last_arrival_time_micros_) /
+               options_.arrival_rate_time_constant_micros);
+  last_arrival_time_micros_ = now_micros;
+}
+
+double AdaptiveBatchTimeoutController::ProcessingMicros(
+    int64_t batch_size) const {
+  if (sum_weights_ == 0) return 0;
+  const double mean_size = sum_sizes_ / sum_weights_;
+  const double mean_micros = sum_micros_ / sum_weights_;
+  const double size_variance =
+      sum_squared_sizes_ / sum_weights_ - mean_size * mean_size;
+  double fixed_micros = 0;
+  double micros_per_task;
+  if (size_variance > 1e-3 * mean_size * mean_size) {
+    const double covariance =
+        sum_sizes_micros_ / sum_weights_ - mean_size * mean_micros;
+    micros_per_task = std::max(0.0, covariance / size_variance);
+    fixed_micros = std::max(0.0, mean_micros - micros_per_task * mean_size);
+  } else {
+    // All recent batches had about the same size. Assumes the latency is
+    // proportional to the size, which overestimates the latency of larger
+    // batches rather than underestimating it.
+    micros_per_task = mean_micros / std::max(mean_size, 1.0);
+  }
+  return fixed_micros + micros_per_task * batch_size;
+}
+
+std::optional<int64_t> AdaptiveBatchTimeoutController::P99LatencyMicrosLocked()
+    const {
+  if (latencies_micros_.empty()) return std::nullopt;
+  std::vector<int64_t> latencies_micros = latencies_micros_;
+  const size_t index = static_cast<size_t>(
+      std::ceil(0.99 * latencies_micros.size()) - 1);
+  std::nth_element(latencies_micros.begin(), latencies_micros.begin() + index,
+                   latencies_micros.end());
+  return latencies_micros[index];
+}
+
+void AdaptiveBatchTimeoutController::UpdateBudget() {
+  const std::optional<int64_t> p99_latency_micros = P99LatencyMicrosLocked();
+  if (!p99_latency_micros.has_value()) return;
+  if (*p99_latency_micros > options_.latency_slo_micros) {
+    budget_scale_ =
+        std::max(kMinBudgetScale, budget_scale_ * kBudgetDecreaseFactor);
+  } else if (*p99_latency_micros <
+             kBudgetGrowthThreshold * options_.latency_slo_micros) {
+    budget_scale_ = std::min(1.0, budget_scale_ + kBudgetIncreaseStep);
+  }
+}
+
+void AdaptiveBatchTimeoutController::UpdateDecisions() {
+  last_update_time_micros_ = last_arrival_time_micros_;
+  const double budget_micros = budget_scale_ * options_.latency_slo_micros;
+  // The time to fill a batch of `batch_size`, after its first task arrived.
+  auto fill_micros = [this](int64_t batch_size) {
+    if (batch_size <= 1) return 0.0;
+    if (arrival_rate_ <= 0) return std::numeric_limits<double>::infinity();
+    return (batch_size - 1) / arrival_rate_;
+  };
+
+  // The modeled latency `(b - 1) / arrival_rate + fixed + per_task * b` is
+  // linear in the batch size `b`, so the batch sizes that fit in the budget
+  // are the ones up to `max_fitting_batch_size`.
+  const double fixed_micros = ProcessingMicros(0);
+  const double micros_per_task = ProcessingMicros(1) - fixed_micros;
+  double max_fitting_batch_size = 1;
+  if (arrival_rate_ > 0) {
+    max_fitting_batch_size =
+        (budget_micros - fixed_micros + 1 / arrival_rate_) /
+        (1 / arrival_rate_ + micros_per_task);
+  }
+
+  int64_t target_batch_size;
+  if (candidate_batch_sizes_.empty()) {
+    target_batch_size = static_cast<int64_t>(
+        std::clamp(std::floor(max_fitting_batch_size), 1.0,
+                   static_cast<double>(max_batch_size_)));
+  } else {
+    target_batch_size = candidate_batch_sizes_.front();
+    for (int64_t batch_size : candidate_batch_sizes_) {
+      if (batch_size > max_fitting_batch_size) break;
+      target_batch_size = batch_size;
+    }
+  }
+
+  const double timeout_micros =
+      std::min(fill_micros(target_batch_size),
+               budget_micros - ProcessingMicros(target_batch_size));
+  const int64_t batch_timeout_micros = static_cast<int64_t>(std::clamp(
+      timeout_micros, static_cast<double>(options_.min_batch_timeout_micros),
+      static_cast<double>(max_batch_timeout_micros_)));
+
+  batch_timeout_micros_.store(batch_timeout_micros, std::memory_order_relaxed);
+  target_batch_size_.store(target_batch_size, std::memory_order_relaxed);
+  if (model_batch_stats_ != nullptr) {
+    model_batch_stats_->SetBatchTimeoutMicros(batch_timeout_micros);
+    model_batch_stats_->SetTargetBatchSize(target_batch_size);
+  }
+}
+
+}  // namespace serving
+}  // namespace tensorflow
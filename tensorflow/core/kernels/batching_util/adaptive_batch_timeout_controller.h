@@ -0,0 +1,177 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_ADAPTIVE_BATCH_TIMEOUT_CONTROLLER_H_
+#define TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_ADAPTIVE_BATCH_TIMEOUT_CONTROLLER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "tensorflow/core/kernels/batching_util/batch_stats.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+namespace serving {
+
+// Options of AdaptiveBatchTimeoutController.
+struct AdaptiveBatchTimeoutOptions {
+  // The p99 latency objective of the tasks, from the time they are scheduled
+  // to the end of the processing of their batch. Must be positive.
+  int64_t latency_slo_micros = 0;
+
+  // Bounds of the batch timeout picked by the controller. If
+  // `max_batch_timeout_micros` is 0, the timeout is bounded by the latency
+  // objective. `min_batch_timeout_micros` must not exceed the upper bound.
+  int64_t min_batch_timeout_micros = 0;
+  int64_t max_batch_timeout_micros = 0;
+
+  // Time constant of the exponentially decaying estimate of the arrival rate.
+  int64_t arrival_rate_time_constant_micros = 1000 * 1000;
+
+  // Weight of the most recent batch in the exponentially weighted estimate of
+  // the processing latency as a function of the batch size.
+  double cost_smoothing = 0.05;
+
+  // The number of most recent batches whose latency is used to estimate the
+  // p99 latency.
+  int64_t latency_window = 512;
+};
+
+// Returns an error if `options` are invalid.
+absl::Status ValidateAdaptiveBatchTimeoutOptions(
+    const AdaptiveBatchTimeoutOptions& options);
+
+// Picks the batch timeout and the target batch size of a batch queue from its
+// observed arrival rate and processing latency.
+//
+// The controller models the latency of the earliest task of a batch of size
+// `b` as the time to fill the batch, `(b - 1) / arrival_rate`, plus the
+// processing latency of the batch, fitted as `fixed + per_task * b` on the
+// processed batches. It targets the largest candidate batch size whose
+// modeled latency fits in a latency budget, and waits at most the time to
+// fill such a batch. At low arrival rates, that is a small batch and a short
+// timeout; at high arrival rates, a large batch that fills before the
+// timeout.
+//
+// The loop is closed on the p99 of the observed latencies: the budget shrinks
+// multiplicatively while the p99 is above the objective, and grows back
+// additively while it is well below it.
+//
+// Until a batch has been processed, the controller returns the configured
+// timeout and the maximum batch size. The decisions are also reported to
+// `model_batch_stats`, if not null.
+//
+// Thread-safe.
+class AdaptiveBatchTimeoutController {
+ public:
+  // `allowed_batch_sizes` are the candidate target batch sizes. If empty, any
+  // batch size up to `max_batch_size` may be targeted.
+  AdaptiveBatchTimeoutController(
+      const AdaptiveBatchTimeoutOptions& options, int64_t max_batch_size,
+      const std::vector<int32_t>& allowed_batch_sizes,
+      int64_t initial_batch_timeout_micros, Env* env,
+      ModelBatchStats* model_batch_stats);
+
+  AdaptiveBatchTimeoutController(const AdaptiveBatchTimeoutController&) =
+      delete;
+  void operator=(const AdaptiveBatchTimeoutController&) = delete;
+
+  // Records the arrival of a task of `size`.
+  void RecordArrival(int64_t size);
+
+  // Records that a batch of `batch_size` whose earliest task was scheduled at
+  // `earliest_task_start_time_micros` started processing at
+  // `processing_start_time_micros`, and has just been processed.
+  void RecordBatchProcessed(int64_t batch_size,
+                            uint64_t earliest_task_start_time_micros,
+                            uint64_t processing_start_time_micros);
+
+  // The current decisions. Cheap enough to be called on every scheduling
+  // decision.
+  int64_t batch_timeout_micros() const {
+    return batch_timeout_micros_.load(std::memory_order_relaxed);
+  }
+  int64_t target_batch_size() const {
+    return target_batch_size_.load(std::memory_order_relaxed);
+  }
+
+  // The estimated arrival rate, in tasks per second.
+  double arrival_rate() const;
+
+  // The p99 of the latencies of the most recent batches, if any.
+  std::optional<int64_t> p99_latency_micros() const;
+
+ private:
+  // Decays the arrival rate estimate to `now_micros`.
+  void DecayArrivalRate(uint64_t now_micros) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Returns the modeled processing latency of a batch of `batch_size`, which is
+  // linear in `batch_size`.
+  double ProcessingMicros(int64_t batch_size) const
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  std::optional<int64_t> P99LatencyMicrosLocked() const
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Scales the latency budget according to the observed p99 latency.
+  void UpdateBudget() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Picks the target batch size and the timeout.
+  void UpdateDecisions() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const AdaptiveBatchTimeoutOptions options_;
+  const int64_t max_batch_size_;
+  const int64_t max_batch_timeout_micros_;
+  // The allowed batch sizes up to `max_batch_size_`, in increasing order.
+  std::vector<int64_t> candidate_batch_sizes_;
+  Env* const env_;
+  ModelBatchStats* const model_batch_stats_;
+
+  std::atomic<int64_t> batch_timeout_micros_;
+  std::atomic<int64_t> target_batch_size_;
+
+  mutable mutex mu_;
+
+  // Arrived tasks per microsecond, as of `last_arrival_time_micros_`.
+  double arrival_rate_ TF_GUARDED_BY(mu_) = 0;
+  uint64_t last_arrival_time_micros_ TF_GUARDED_BY(mu_) = 0;
+  uint64_t last_update_time_micros_ TF_GUARDED_BY(mu_) = 0;
+
+  // Exponentially weighted sums of the weights, batch sizes, processing
+  // latencies, squared batch sizes and products of both, for the least
+  // squares fit of the processing latency.
+  double sum_weights_ TF_GUARDED_BY(mu_) = 0;
+  double sum_sizes_ TF_GUARDED_BY(mu_) = 0;
+  double sum_micros_ TF_GUARDED_BY(mu_) = 0;
+  double sum_squared_sizes_ TF_GUARDED_BY(mu_) = 0;
+  double sum_sizes_micros_ TF_GUARDED_BY(mu_) = 0;
+
+  // Ring buffer of the latencies of the most recent batches.
+  std::vector<int64_t> latencies_micros_ TF_GUARDED_BY(mu_);
+  int64_t num_batches_ TF_GUARDED_BY(mu_) = 0;
+
+  // Fraction of the latency objective that the modeled latency may use.
+  double budget_scale_ TF_GUARDED_BY(mu_) = 1.0;
+};
+
+}  // namespace serving
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_ADAPTIVE_BATCH_TIMEOUT_CONTROLLER_H_
@@ -0,0 +1,373 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/batching_util/adaptive_batch_timeout_controller.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "tensorflow/core/kernels/batching_util/batch_stats.h"
+#include "tensorflow/core/kernels/batching_util/fake_clock_env.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+
+namespace tensorflow {
+namespace serving {
+namespace {
+
+constexpr int64_t kLatencySloMicros = 20 * 1000;
+constexpr int64_t kMaxBatchSize = 64;
+constexpr int64_t kFixedBatchTimeoutMicros = 10 * 1000;
+
+// The processing latency of a batch in the simulations.
+constexpr int64_t kFixedCostMicros = 2000;
+constexpr int64_t kCostPerTaskMicros = 100;
+
+AdaptiveBatchTimeoutOptions TestOptions() {
+  AdaptiveBatchTimeoutOptions options;
+  options.latency_slo_micros = kLatencySloMicros;
+  options.arrival_rate_time_constant_micros = 100 * 1000;
+  return options;
+}
+
+// Schedules tasks of size 1 every `interval_micros` for `duration_micros`,
+// and processes them in batches of `batch_size` as soon as they are complete,
+// concurrently with the next arrivals. The tasks of a batch wait
+// `queueing_delay_micros` before it is processed.
+void DriveConstantTraffic(test_util::FakeClockEnv& env,
+                          AdaptiveBatchTimeoutController& controller,
+                          int64_t interval_micros, int64_t batch_size,
+                          int64_t duration_micros,
+                          int64_t queueing_delay_micros = 0) {
+  struct InFlightBatch {
+    uint64_t earliest_task_start_time_micros;
+    uint64_t processing_start_time_micros;
+    uint64_t processing_end_time_micros;
+  };
+  std::deque<InFlightBatch> in_flight_batches;
+  const uint64_t end_micros = env.NowMicros() + duration_micros;
+  uint64_t earliest_task_start_time_micros = 0;
+  int64_t num_enqueued_tasks = 0;
+  while (env.NowMicros() < end_micros) {
+    while (!in_flight_batches.empty() &&
+           in_flight_batches.front().processing_end_time_micros <=
+               env.NowMicros()) {
+      const InFlightBatch& batch = in_flight_batches.front();
+      controller.RecordBatchProcessed(
+          batch_size, batch.earliest_task_start_time_micros,
+          batch.processing_start_time_micros);
+      in_flight_batches.pop_front();
+    }
+    if (num_enqueued_tasks == 0) {
+      earliest_task_start_time_micros = env.NowMicros();
+    }
+    controller.RecordArrival(1);
+    if (++num_enqueued_tasks == batch_size) {
+      const uint64_t processing_start_time_micros =
+          env.NowMicros() + queueing_delay_micros;
+      in_flight_batches.push_back(
+          {earliest_task_start_time_micros, processing_start_time_micros,
+           processing_start_time_micros + kFixedCostMicros +
+               kCostPerTaskMicros * batch_size});
+      num_enqueued_tasks = 0;
+    }
+    env.AdvanceByMicroseconds(interval_micros);
+  }
+}
+
+TEST(AdaptiveBatchTimeoutControllerTest, ValidatesOptions) {
+  EXPECT_TRUE(ValidateAdaptiveBatchTimeoutOptions(TestOptions()).ok());
+
+  AdaptiveBatchTimeoutOptions options = TestOptions();
+  options.latency_slo_micros = 0;
+  EXPECT_EQ(ValidateAdaptiveBatchTimeoutOptions(options).code(),
+            absl::StatusCode::kInvalidArgument);
+
+  options = TestOptions();
+  options.min_batch_timeout_micros = 100;
+  options.max_batch_timeout_micros = 10;
+  EXPECT_EQ(ValidateAdaptiveBatchTimeoutOptions(options).code(),
+            absl::StatusCode::kInvalidArgument);
+
+  // Without an upper bound, the timeout is bounded by the latency objective.
+  options = TestOptions();
+  options.min_batch_timeout_micros = kLatencySloMicros + 1;
+  EXPECT_EQ(ValidateAdaptiveBatchTimeoutOptions(options).code(),
+            absl::StatusCode::kInvalidArgument);
+  options.min_batch_timeout_micros = kLatencySloMicros;
+  EXPECT_TRUE(ValidateAdaptiveBatchTimeoutOptions(options).ok());
+
+  options = TestOptions();
+  options.cost_smoothing = 0;
+  EXPECT_EQ(ValidateAdaptiveBatchTimeoutOptions(options).code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+TEST(AdaptiveBatchTimeoutControllerTest, InitialDecisions) {
+  test_util::FakeClockEnv env(Env::Default());
+  ModelBatchStats model_batch_stats;
+  AdaptiveBatchTimeoutController controller(
+      TestOptions(), kMaxBatchSize, /*allowed_batch_sizes=*/{},
+      kFixedBatchTimeoutMicros, &env, &model_batch_stats);
+
+  EXPECT_EQ(controller.batch_timeout_micros(), kFixedBatchTimeoutMicros);
+  EXPECT_EQ(controller.target_batch_size(), kMaxBatchSize);
+  EXPECT_FALSE(controller.p99_latency_micros().has_value());
+  EXPECT_EQ(model_batch_stats.batch_timeout_micros(),
+            kFixedBatchTimeoutMicros);
+  EXPECT_EQ(model_batch_stats.target_batch_size(), kMaxBatchSize);
+
+  // Arrivals alone do not change the decisions.
+  for (int i = 0; i < 100; ++i) {
+    controller.RecordArrival(1);
+    env.AdvanceByMicroseconds(1000);
+  }
+  EXPECT_EQ(controller.batch_timeout_micros(), kFixedBatchTimeoutMicros);
+  EXPECT_EQ(controller.target_batch_size(), kMaxBatchSize);
+}
+
+TEST(AdaptiveBatchTimeoutControllerTest, EstimatesArrivalRate) {
+  test_util::FakeClockEnv env(Env::Default());
+  AdaptiveBatchTimeoutController controller(
+      TestOptions(), kMaxBatchSize, /*allowed_batch_sizes=*/{},
+      kFixedBatchTimeoutMicros, &env, /*model_batch_stats=*/nullptr);
+
+  // 1000 tasks per second for 10 time constants.
+  for (int i = 0; i < 1000; ++i) {
+    controller.RecordArrival(1);
+    env.AdvanceByMicroseconds(1000);
+  }
+  EXPECT_NEAR(controller.arrival_rate(), 1000, 50);
+}
+
+TEST(AdaptiveBatchTimeoutControllerTest, LowArrivalRateShortensTimeout) {
+  test_util::FakeClockEnv env(Env::Default());
+  ModelBatchStats model_batch_stats;
+  AdaptiveBatchTimeoutController controller(
+      TestOptions(), kMaxBatchSize, /*allowed_batch_sizes=*/{},
+      kFixedBatchTimeoutMicros, &env, &model_batch_stats);
+
+  // 250 tasks per second: a batch of 4 fills in 12ms. As all batches have the
+  // same size, its processing latency is modeled as 4 times the latency of a
+  // task, 4.4ms; a batch of 5 would not fit in the objective.
+  DriveConstantTraffic(env, controller, /*interval_micros=*/4000,
+                       /*batch_size=*/2, /*duration_micros=*/2 * 1000 * 1000);
+
+  EXPECT_EQ(controller.target_batch_size(), 4);
+  EXPECT_NEAR(controller.batch_timeout_micros(), 12000, 1000);
+  EXPECT_EQ(model_batch_stats.target_batch_size(),
+            controller.target_batch_size());
+  EXPECT_EQ(model_batch_stats.batch_timeout_micros(),
+            controller.batch_timeout_micros());
+}
+
+TEST(AdaptiveBatchTimeoutControllerTest, HighArrivalRateGrowsBatches) {
+  test_util::FakeClockEnv env(Env::Default());
+  AdaptiveBatchTimeoutController controller(
+      TestOptions(), kMaxBatchSize, /*allowed_batch_sizes=*/{},
+      kFixedBatchTimeoutMicros, &env, /*model_batch_stats=*/nullptr);
+
+  // 10000 tasks per second, processed in batches of various sizes.
+  for (int64_t batch_size : {8, 16, 32, 8, 16, 32, 8, 16, 32}) {
+    DriveConstantTraffic(env, controller, /*interval_micros=*/100, batch_size,
+                         /*duration_micros=*/100 * 1000);
+  }
+
+  // A batch of 64 fills in 6.3ms, and is processed in 8.4ms.
+  EXPECT_EQ(controller.target_batch_size(), kMaxBatchSize);
+  EXPECT_NEAR(controller.batch_timeout_micros(), 6300, 500);
+}
+
+TEST(AdaptiveBatchTimeoutControllerTest, PicksAllowedBatchSizes) {
+  test_util::FakeClockEnv env(Env::Default());
+  AdaptiveBatchTimeoutController controller(
+      TestOptions(), kMaxBatchSize, /*allowed_batch_sizes=*/{3, 12, 48, 96},
+      kFixedBatchTimeoutMicros, &env, /*model_batch_stats=*/nullptr);
+
+  // Batches of 12 fill in 5.5ms and are processed in about 9.2ms; batches of
+  // 48 would not fit in the objective. 96 is larger than the maximum batch
+  // size.
+  DriveConstantTraffic(env, controller, /*interval_micros=*/500,
+                       /*batch_size=*/3, /*duration_micros=*/1000 * 1000);
+
+  EXPECT_EQ(controller.target_batch_size(), 12);
+}
+
+TEST(AdaptiveBatchTimeoutControllerTest, LatencyAboveObjectiveShrinksBudget) {
+  test_util::FakeClockEnv env(Env::Default());
+  AdaptiveBatchTimeoutController controller(
+      TestOptions(), kMaxBatchSize, /*allowed_batch_sizes=*/{},
+      kFixedBatchTimeoutMicros, &env, /*model_batch_stats=*/nullptr);
+
+  DriveConstantTraffic(env, controller, /*interval_micros=*/500,
+                       /*batch_size=*/8, /*duration_micros=*/1000 * 1000);
+  ASSERT_TRUE(controller.p99_latency_micros().has_value());
+  EXPECT_LT(*controller.p99_latency_micros(), kLatencySloMicros);
+  const int64_t target_batch_size = controller.target_batch_size();
+  const int64_t batch_timeout_micros = controller.batch_timeout_micros();
+
+  // The same traffic, but the tasks wait 25ms in the queue before their batch
+  // is processed, e.g. because the batch threads are busy with other queues.
+  DriveConstantTraffic(env, controller, /*interval_micros=*/500,
+                       /*batch_size=*/8, /*duration_micros=*/1000 * 1000,
+                       /*queueing_delay_micros=*/25 * 1000);
+  ASSERT_TRUE(controller.p99_latency_micros().has_value());
+  EXPECT_GT(*controller.p99_latency_micros(), kLatencySloMicros);
+  EXPECT_LT(controller.target_batch_size(), target_batch_size);
+  EXPECT_LT(controller.batch_timeout_micros(), batch_timeout_micros);
+}
+
+struct SimulationResult {
+  int64_t p99_latency_micros = 0;
+  double mean_batch_size = 0;
+};
+
+// Simulates a queue with a single batch thread, whose arrival rate varies
+// like a sine wave between 10% and 100% of `peak_arrival_rate` tasks per
+// second over `duration_micros`. Batches start when the batch thread is idle
+// and the open batch is full or timed out, like in SharedBatchScheduler.
+SimulationResult SimulateDiurnalTraffic(bool adaptive,
+                                        double peak_arrival_rate,
+                                        int64_t duration_micros) {
+  test_util::FakeClockEnv env(Env::Default());
+  AdaptiveBatchTimeoutController controller(
+      TestOptions(), kMaxBatchSize, /*allowed_batch_sizes=*/{},
+      kFixedBatchTimeoutMicros, &env, /*model_batch_stats=*/nullptr);
+  auto next_arrival_micros = [&](uint64_t now_micros) -> uint64_t {
+    const double phase = 2 * M_PI * now_micros / duration_micros;
+    const double rate = peak_arrival_rate * (0.55 - 0.45 * std::cos(phase));
+    return now_micros + std::max<int64_t>(1, 1e6 / rate);
+  };
+
+  // The start times of the enqueued tasks and of the processed batch.
+  std::deque<uint64_t> enqueued_task_start_times_micros;
+  std::vector<uint64_t> processed_task_start_times_micros;
+  uint64_t processing_start_time_micros = 0;
+  uint64_t processing_end_time_micros = 0;
+  bool processing = false;
+
+  std::vector<int64_t> latencies_micros;
+  int64_t num_batches = 0;
+  uint64_t arrival_micros = next_arrival_micros(0);
+  while (true) {
+    const uint64_t now_micros = env.NowMicros();
+    if (processing && now_micros >= processing_end_time_micros) {
+      for (uint64_t start_time_micros : processed_task_start_times_micros) {
+        latencies_micros.push_back(now_micros - start_time_micros);
+      }
+      controller.RecordBatchProcessed(processed_task_start_times_micros.size(),
+                                      processed_task_start_times_micros[0],
+                                      processing_start_time_micros);
+      processing = false;
+    }
+    while (arrival_micros <= now_micros && arrival_micros < duration_micros) {
+      enqueued_task_start_times_micros.push_back(arrival_micros);
+      controller.RecordArrival(1);
+      arrival_micros = next_arrival_micros(arrival_micros);
+    }
+
+    const int64_t target_batch_size =
+        adaptive ? controller.target_batch_size() : kMaxBatchSize;
+    const int64_t batch_timeout_micros =
+        adaptive ? controller.batch_timeout_micros() : kFixedBatchTimeoutMicros;
+    if (!processing && !enqueued_task_start_times_micros.empty() &&
+        (enqueued_task_start_times_micros.size() >= target_batch_size ||
+         now_micros >=
+             enqueued_task_start_times_micros[0] + batch_timeout_micros)) {
+      const int64_t batch_size = std::min<int64_t>(
+          enqueued_task_start_times_micros.size(), kMaxBatchSize);
+      processed_task_start_times_micros.assign(
+          enqueued_task_start_times_micros.begin(),
+          enqueued_task_start_times_micros.begin() + batch_size);
+      enqueued_task_start_times_micros.erase(
+          enqueued_task_start_times_micros.begin(),
+          enqueued_task_start_times_micros.begin() + batch_size);
+      processing = true;
+      processing_start_time_micros = now_micros;
+      processing_end_time_micros =
+          now_micros + kFixedCostMicros + kCostPerTaskMicros * batch_size;
+      ++num_batches;
+    }
+
+    uint64_t next_event_micros = std::numeric_limits<uint64_t>::max();
+    if (arrival_micros < duration_micros) {
+      next_event_micros = arrival_micros;
+    }
+    if (processing) {
+      next_event_micros =
+          std::min(next_event_micros, processing_end_time_micros);
+    } else if (!enqueued_task_start_times_micros.empty()) {
+      next_event_micros =
+          std::min(next_event_micros,
+                   enqueued_task_start_times_micros[0] + batch_timeout_micros);
+    }
+    if (next_event_micros == std::numeric_limits<uint64_t>::max()) break;
+    env.AdvanceByMicroseconds(next_event_micros - now_micros);
+  }
+
+  SimulationResult result;
+  const size_t index = std::ceil(0.99 * latencies_micros.size()) - 1;
+  std::nth_element(latencies_micros.begin(), latencies_micros.begin() + index,
+                   latencies_micros.end());
+  result.p99_latency_micros = latencies_micros[index];
+  result.mean_batch_size =
+      static_cast<double>(latencies_micros.size()) / num_batches;
+  return result;
+}
+
+TEST(AdaptiveBatchTimeoutControllerTest, DiurnalTrafficMeetsLatencyObjective) {
+  const SimulationResult fixed = SimulateDiurnalTraffic(
+      /*adaptive=*/false, /*peak_arrival_rate=*/4000,
+      /*duration_micros=*/20 * 1000 * 1000);
+  const SimulationResult adaptive = SimulateDiurnalTraffic(
+      /*adaptive=*/true, /*peak_arrival_rate=*/4000,
+      /*duration_micros=*/20 * 1000 * 1000);
+
+  // The fixed timeout leaves some of the objective unused, which the adaptive
+  // timeout spends on larger batches.
+  EXPECT_LE(fixed.p99_latency_micros, kLatencySloMicros);
+  EXPECT_LE(adaptive.p99_latency_micros, kLatencySloMicros);
+  EXPECT_GT(adaptive.mean_batch_size, 1.2 * fixed.mean_batch_size);
+}
+
+void BM_SimulateDiurnalTraffic(::testing::benchmark::State& state) {
+  const bool adaptive = state.range(0);
+  const double peak_arrival_rate = state.range(1);
+  SimulationResult result;
+  for (auto s : state) {
+    result = SimulateDiurnalTraffic(adaptive, peak_arrival_rate,
+                                    /*duration_micros=*/60 * 1000 * 1000);
+  }
+  state.SetLabel(adaptive ? "adaptive" : "fixed");
+  state.counters["p99_latency_micros"] = result.p99_latency_micros;
+  state.counters["mean_batch_size"] = result.mean_batch_size;
+}
+BENCHMARK(BM_SimulateDiurnalTraffic)
+    ->ArgPair(0, 1000)
+    ->ArgPair(1, 1000)
+    ->ArgPair(0, 4000)
+    ->ArgPair(1, 4000)
+    ->ArgPair(0, 7000)
+    ->ArgPair(1, 7000);
+
+}  // namespace
+}  // namespace serving
+}  // namespace tensorflow
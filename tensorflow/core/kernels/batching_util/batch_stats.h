@@ -69,6 +69,7 @@ namespace tensorflow::serving {
 // Default values for when there is no recorded statistic in ModelBatchStats.
 constexpr int64_t kNumBatchThreadsUnknown = -1;
 constexpr int64_t kBatchTimeoutMicrosUnknown = -1;
+constexpr int64_t kTargetBatchSizeUnknown = -1;
 
 // Tracks the average cost of registered samples.
 //
@@ -188,6 +189,14 @@ class ModelBatchStats {
     return batch_timeout_micros_.load(std::memory_order_relaxed);
   }
 
+  void SetTargetBatchSize(int64_t target_batch_size) {
+    target_batch_size_.store(target_batch_size, std::memory_order_relaxed);
+  }
+
+  int64_t target_batch_size() const {
+    return target_batch_size_.load(std::memory_order_relaxed);
+  }
+
  private:
   mutable mutex mu_;
 
@@ -212,6 +221,10 @@ class ModelBatchStats {
   // The timeout in microseconds for this model (after which the current batch
   // is sent to be processed by the TPU).
   std::atomic<int64_t> batch_timeout_micros_ = kBatchTimeoutMicrosUnknown;
+
+  // The batch size that the batch queues of this model wait for, when it is
+  // picked by an adaptive batch timeout controller.
+  std::atomic<int64_t> target_batch_size_ = kTargetBatchSizeUnknown;
 };
 
 // Tracks batch statistics for all models.
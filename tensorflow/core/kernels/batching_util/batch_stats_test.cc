@@ -137,6 +137,17 @@ TEST(BatchStatsTest, BatchTimeoutIsCorrect) {
   ASSERT_EQ(stats.batch_timeout_micros(), 100);
 }
 
+TEST(BatchStatsTest, TargetBatchSizeIsCorrect) {
+  ModelBatchStats stats;
+
+  // Originally the target batch size is -1 if unassigned.
+  ASSERT_EQ(stats.target_batch_size(), -1);
+
+  // Assign a target batch size.
+  stats.SetTargetBatchSize(32);
+  ASSERT_EQ(stats.target_batch_size(), 32);
+}
+
 TEST(BatchStatsTest, NumBatchThreadsIsCorrect) {
   ModelBatchStats stats;
 
@@ -45,6 +45,7 @@ limitations under the License.
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "xla/tsl/platform/criticality.h"
+#include "tensorflow/core/kernels/batching_util/adaptive_batch_timeout_controller.h"
 #include "tensorflow/core/kernels/batching_util/batch_scheduler.h"
 #include "tensorflow/core/kernels/batching_util/batch_scheduler_utils.h"
 #include "tensorflow/core/kernels/batching_util/batch_stats.h"
@@ -340,6 +341,20 @@ class SharedBatchScheduler
     };
 
     PriorityAwareSchedulerOptions priority_aware_scheduler_options;
+
+    // If true, the batch timeout and the batch size that the queue waits for
+    // are picked by an AdaptiveBatchTimeoutController from the observed
+    // arrival rate and processing latency, to stay within the p99 latency
+    // objective of `adaptive_batch_timeout_options`. `batch_timeout_micros`
+    // is the timeout until the first batch has been processed.
+    //
+    // The decisions are reported to `model_batch_stats`, if not null. Not
+    // supported with `enable_priority_queue` or
+    // `enable_priority_aware_batch_scheduler`.
+    bool enable_adaptive_batch_timeout = false;
+
+    // Used iff `enable_adaptive_batch_timeout` is true.
+    AdaptiveBatchTimeoutOptions adaptive_batch_timeout_options;
   };
   // This method is marked virtual for testing purposes only.
   virtual absl::Status AddQueue(
@@ -1008,6 +1023,11 @@ class Queue {
   // `GetMaxExecutionBatchSize` for more details on what it means.
   const size_t max_execution_batch_size_;
 
+  // Picks the batch timeout and the target batch size of the queue if
+  // `enable_adaptive_batch_timeout` is true, and null otherwise.
+  std::unique_ptr<AdaptiveBatchTimeoutController>
+      adaptive_batch_timeout_controller_;
+
   // A callback invoked to processes a batch of work units. Always invoked
   // from a batch thread.
   ProcessBatchCallback process_batch_callback_;
@@ -1250,6 +1270,17 @@ absl::Status SharedBatchScheduler<TaskType>::AddQueueAfterRewritingOptions(
     }
   }
 
+  if (options.enable_adaptive_batch_timeout) {
+    if (options.enable_priority_queue ||
+        options.enable_priority_aware_batch_scheduler) {
+      return absl::InvalidArgumentError(
+          "enable_adaptive_batch_timeout is not supported with "
+          "enable_priority_queue or enable_priority_aware_batch_scheduler.");
+    }
+    TF_RETURN_IF_ERROR(ValidateAdaptiveBatchTimeoutOptions(
+        options.adaptive_batch_timeout_options));
+  }
+
   auto schedulable_batch_callback = [this] {
     mutex_lock l(mu_);
     schedulable_batch_cv_.notify_one();
@@ -1453,6 +1484,14 @@ Queue<TaskType>::Queue(
       env_(env),
       enable_warmup_queue_(enable_warmup_queue),
       max_execution_batch_size_(GetMaxExecutionBatchSize(options_)),
+      adaptive_batch_timeout_controller_(
+          options.enable_adaptive_batch_timeout
+              ? std::make_unique<AdaptiveBatchTimeoutController>(
+                    options.adaptive_batch_timeout_options,
+                    max_execution_batch_size_, options.allowed_batch_sizes,
+                    options.batch_timeout_micros, env,
+                    options.model_batch_stats)
+              : nullptr),
       process_batch_callback_(process_batch_callback),
       schedulable_batch_callback_(schedulable_batch_callback),
       schedulable_warmup_batch_callback_(schedulable_warmup_batch_callback) {
@@ -1665,7 +1704,11 @@ absl::Status Queue<TaskType>::Schedule(std::unique_ptr<TaskType>* task) {
         TF_RETURN_IF_ERROR(ValidateLowPriorityTaskQueueCapacity(**task));
         low_priority_tasks_.AddTask(std::move(*task), env_->NowMicros());
       } else {
+        const size_t task_size = (*task)->size();
         TF_RETURN_IF_ERROR(ScheduleWithoutOrEagerSplitImpl(task));
+        if (adaptive_batch_timeout_controller_ != nullptr) {
+          adaptive_batch_timeout_controller_->RecordArrival(task_size);
+        }
       }
 
       // Check if the batch queue has a schedulable batch and mark it
@@ -1969,6 +2012,11 @@ void Queue<TaskType>::ProcessBatch(
       tsl::profiler::ContextType::kSharedBatchScheduler,
       batch->traceme_context_id());
 
+  const size_t batch_size = batch->size();
+  const std::optional<uint64_t> earliest_task_start_time_micros =
+      batch->EarliestTaskStartTime();
+  const uint64_t processing_start_time_micros = env_->NowMicros();
+
   if (std::holds_alternative<ProcessBatchCallbackWithoutPaddingTasks>(
           process_batch_callback_)) {
     std::get<ProcessBatchCallbackWithoutPaddingTasks>(process_batch_callback_)(
@@ -1978,6 +2026,13 @@ void Queue<TaskType>::ProcessBatch(
         std::move(batch), std::move(padding_task));
   }
 
+  if (adaptive_batch_timeout_controller_ != nullptr &&
+      earliest_task_start_time_micros.has_value()) {
+    adaptive_batch_timeout_controller_->RecordBatchProcessed(
+        batch_size, *earliest_task_start_time_micros,
+        processing_start_time_micros);
+  }
+
   {
     mutex_lock l(mu_);
     --num_batches_being_processed_;
@@ -2115,8 +2170,14 @@ Queue<TaskType>::PeekBatchPriorityImpl() const {
     return std::nullopt;
   }
 
-  bool schedulable = closed_ ||
-                     effective_batch_size >= max_execution_batch_size() ||
+  size_t target_batch_size = max_execution_batch_size();
+  if (adaptive_batch_timeout_controller_ != nullptr) {
+    target_batch_size = adaptive_batch_timeout_controller_->target_batch_size();
+    effective_batch_timeout_micros =
+        adaptive_batch_timeout_controller_->batch_timeout_micros();
+  }
+
+  bool schedulable = closed_ || effective_batch_size >= target_batch_size ||
                      env_->NowMicros() >= effective_start_time_micros +
                                               effective_batch_timeout_micros;
 
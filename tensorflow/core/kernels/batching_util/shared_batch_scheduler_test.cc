@@ -1196,6 +1196,72 @@ TEST_P(SharedBatchSchedulerTest, BatchPaddingPolicyBatchDown) {
   stop_teardown.Notify();
 }
 
+TEST_P(SharedBatchSchedulerTest, AdaptiveBatchTimeoutInvalidOptions) {
+  TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<Scheduler> scheduler,
+                          CreateSharedBatchScheduler(/*num_batch_threads=*/1));
+  auto callback = [](std::unique_ptr<Batch<FakeTask>> batch) {};
+  std::unique_ptr<Queue> queue;
+
+  // Missing latency objective.
+  QueueOptions queue_options = CreateQueueOptions(
+      /*max_execution_batch_size=*/10, /*input_batch_size_limit=*/10,
+      /*batch_timeout_micros=*/1000, /*max_enqueued_batches=*/10);
+  queue_options.enable_adaptive_batch_timeout = true;
+  EXPECT_THAT(scheduler->AddQueue(queue_options, callback, &queue),
+              absl_testing::StatusIs(error::INVALID_ARGUMENT,
+                                     HasSubstr("latency_slo_micros")));
+
+  // Not supported with the priority queue.
+  queue_options = CreateQueueOptions(
+      /*max_execution_batch_size=*/10, /*input_batch_size_limit=*/10,
+      /*batch_timeout_micros=*/1000, /*max_enqueued_batches=*/10,
+      /*enable_priority_queue=*/true);
+  queue_options.enable_adaptive_batch_timeout = true;
+  queue_options.adaptive_batch_timeout_options.latency_slo_micros = 100 * 1000;
+  EXPECT_THAT(scheduler->AddQueue(queue_options, callback, &queue),
+              absl_testing::StatusIs(error::INVALID_ARGUMENT,
+                                     HasSubstr("enable_priority_queue")));
+}
+
+TEST_P(SharedBatchSchedulerTest, AdaptiveBatchTimeoutExportsDecisions) {
+  ModelBatchStats model_batch_stats;
+  absl::Mutex mu;
+  int processed_tasks = 0;
+  auto callback = [&mu, &processed_tasks](
+                      std::unique_ptr<Batch<FakeTask>> batch) {
+    ASSERT_TRUE(batch->IsClosed());
+    absl::MutexLock l(mu);
+    processed_tasks += batch->size();
+  };
+  {
+    TF_ASSERT_OK_AND_ASSIGN(
+        std::shared_ptr<Scheduler> scheduler,
+        CreateSharedBatchScheduler(/*num_batch_threads=*/1));
+    QueueOptions queue_options = CreateQueueOptions(
+        /*max_execution_batch_size=*/10, /*input_batch_size_limit=*/10,
+        /*batch_timeout_micros=*/1000, /*max_enqueued_batches=*/10);
+    queue_options.model_batch_stats = &model_batch_stats;
+    queue_options.enable_adaptive_batch_timeout = true;
+    queue_options.adaptive_batch_timeout_options.latency_slo_micros =
+        100 * 1000;
+    TF_ASSERT_OK_AND_ASSIGN(
+        std::unique_ptr<Queue> queue,
+        CreateQueue(scheduler, queue_options, callback));
+    EXPECT_EQ(model_batch_stats.target_batch_size(), 10);
+    EXPECT_EQ(model_batch_stats.batch_timeout_micros(), 1000);
+
+    for (int i = 0; i < 50; ++i) {
+      TF_ASSERT_OK(ScheduleTask(/*task_size=*/1, queue.get()));
+      Env::Default()->SleepForMicroseconds(100);
+    }
+  }
+  EXPECT_EQ(processed_tasks, 50);
+  EXPECT_GE(model_batch_stats.target_batch_size(), 1);
+  EXPECT_LE(model_batch_stats.target_batch_size(), 10);
+  EXPECT_GE(model_batch_stats.batch_timeout_micros(), 0);
+  EXPECT_LE(model_batch_stats.batch_timeout_micros(), 100 * 1000);
+}
+
 // TODO(b/161857471):
 // Add test coverage when input-split and no-split returns differently.
 INSTANTIATE_TEST_SUITE_P(Parameter, SharedBatchSchedulerTest,
@@ -17,17 +17,22 @@ limitations under the License.
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "xla/tsl/platform/statusor.h"
 #include "tensorflow/core/data/global_shuffle_utils.h"
 #include "tensorflow/core/data/name_utils.h"
 #include "tensorflow/core/data/serialization_utils.h"
+#include "tensorflow/core/data/tiered_element_cache.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/dataset_options.pb.h"
 #include "tensorflow/core/framework/partial_tensor_shape.h"
@@ -78,6 +83,49 @@ constexpr char kIncompleteCacheErrorMessage[] =
     "contents of the dataset  will be discarded. This can happen if you have "
     "an input pipeline similar to `dataset.cache().take(k).repeat()`. You "
     "should use `dataset.take(k).cache().repeat()` instead.";
+
+// Creates the storage for the elements of a memory cache. The disk tier of the
+// storage is configured through the environment.
+absl::StatusOr<std::unique_ptr<TieredElementCache>> NewCacheElements(
+    Env* env) {
+  TF_ASSIGN_OR_RETURN(TieredElementCacheOptions options,
+                      TieredElementCacheOptions::FromEnvironment());
+  return TieredElementCache::Create(env, options);
+}
+
+// Writes `elements` to the checkpoint like `WriteElementsToCheckpoint`, without
+// loading the elements kept on disk all at once.
+absl::Status WriteCacheElementsToCheckpoint(IteratorStateWriter* writer,
+                                            absl::string_view key_prefix,
+                                            TieredElementCache& elements) {
+  const int64_t num_elements = elements.size();
+  TF_RETURN_IF_ERROR(
+      WriteNumElementsToCheckpoint(writer, key_prefix, num_elements));
+  for (int64_t i = 0; i < num_elements; ++i) {
+    std::vector<Tensor> element;
+    TF_RETURN_IF_ERROR(elements.Get(i, &element));
+    TF_RETURN_IF_ERROR(
+        WriteElementToCheckpoint(writer, key_prefix, i, element));
+  }
+  return absl::OkStatus();
+}
+
+// Appends the elements written by `WriteCacheElementsToCheckpoint` or
+// `WriteElementsToCheckpoint` to `elements`.
+absl::Status ReadCacheElementsFromCheckpoint(IteratorContext* ctx,
+                                             IteratorStateReader* reader,
+                                             absl::string_view key_prefix,
+                                             TieredElementCache& elements) {
+  TF_ASSIGN_OR_RETURN(int64_t num_elements,
+                      ReadNumElementsFromCheckpoint(reader, key_prefix));
+  for (int64_t i = 0; i < num_elements; ++i) {
+    std::vector<Tensor> element;
+    TF_RETURN_IF_ERROR(
+        ReadElementFromCheckpoint(ctx, reader, key_prefix, i, &element));
+    TF_RETURN_IF_ERROR(elements.Append(std::move(element)));
+  }
+  return absl::OkStatus();
+}
 }  // namespace
 
 class DatasetRandomAccessCache {
@@ -894,8 +942,8 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
       mutex_lock l(mu_);
       if (cache_->IsCompleted()) {
         TF_RETURN_IF_ERROR(writer->WriteScalar(prefix(), kCacheCompleted, ""));
-        TF_RETURN_IF_ERROR(
-            WriteElementsToCheckpoint(writer, prefix(), cache_->data()));
+        TF_RETURN_IF_ERROR(WriteCacheElementsToCheckpoint(writer, prefix(),
+                                                          *cache_->elements()));
       }
       TF_RETURN_IF_ERROR(global_shuffle_iterator_.Save(prefix(), ctx, writer));
       return SaveInput(ctx, writer, iterator_);
@@ -910,9 +958,11 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
       iterator_.reset();
       cache_->Reset();
       if (reader->Contains(prefix(), kCacheCompleted)) {
-        std::vector<std::vector<Tensor>> temp_cache;
-        TF_RETURN_IF_ERROR(
-            ReadElementsFromCheckpoint(ctx, reader, prefix(), &temp_cache));
+        TF_ASSIGN_OR_RETURN(std::shared_ptr<TieredElementCache> temp_cache,
+                            NewCacheElements(ctx->env()));
+        TF_RETURN_IF_ERROR(ReadCacheElementsFromCheckpoint(ctx, reader,
+                                                           prefix(),
+                                                           *temp_cache));
         cache_->Complete(std::move(temp_cache));
       }
       TF_RETURN_IF_ERROR(InitializeIterator(ctx));
@@ -927,13 +977,16 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
 
       ~MemoryWriterIterator() override {
         mutex_lock l(mu_);
-        if (!temp_cache_.empty() && !cache_->IsCompleted()) {
+        if (temp_cache_ != nullptr && temp_cache_->size() > 0 &&
+            !cache_->IsCompleted()) {
           LOG(WARNING) << kIncompleteCacheErrorMessage;
           cache_->Reset();
         }
       }
 
       absl::Status Initialize(IteratorContext* ctx) override {
+        mutex_lock l(mu_);
+        TF_ASSIGN_OR_RETURN(temp_cache_, NewCacheElements(ctx->env()));
         return dataset()->input_->MakeIterator(ctx, this, prefix(),
                                                &input_impl_);
       }
@@ -951,9 +1004,13 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
           }
           return absl::OkStatus();
         }
+        if (temp_cache_ == nullptr) {
+          // The cache has been completed by an earlier element.
+          return absl::OkStatus();
+        }
         RecordBufferEnqueue(ctx, *out_tensors);
-        temp_cache_.emplace_back(*out_tensors);
-        if (temp_cache_.size() == dataset()->input_->Cardinality()) {
+        TF_RETURN_IF_ERROR(temp_cache_->Append(*out_tensors));
+        if (temp_cache_->size() == dataset()->input_->Cardinality()) {
           VLOG(2) << "Finalizing the cache because its size matches the "
                      "expected input cardinality.";
           cache_->Complete(std::move(temp_cache_));
@@ -971,9 +1028,9 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
       absl::Status SaveInternal(SerializationContext* ctx,
                                 IteratorStateWriter* writer) override {
         mutex_lock l(mu_);
-        if (!cache_->IsCompleted()) {
+        if (!cache_->IsCompleted() && temp_cache_ != nullptr) {
           TF_RETURN_IF_ERROR(
-              WriteElementsToCheckpoint(writer, prefix(), temp_cache_));
+              WriteCacheElementsToCheckpoint(writer, prefix(), *temp_cache_));
         }
         return SaveInput(ctx, writer, input_impl_);
       }
@@ -982,8 +1039,11 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
                                    IteratorStateReader* reader) override {
         mutex_lock l(mu_);
         if (!reader->Contains(prefix(), kCacheCompleted)) {
-          TF_RETURN_IF_ERROR(
-              ReadElementsFromCheckpoint(ctx, reader, prefix(), &temp_cache_));
+          // Replace, rather than append to, the elements cached so far. They
+          // are gone if the cache has been completed since.
+          TF_ASSIGN_OR_RETURN(temp_cache_, NewCacheElements(ctx->env()));
+          TF_RETURN_IF_ERROR(ReadCacheElementsFromCheckpoint(
+              ctx, reader, prefix(), *temp_cache_));
         }
         return RestoreInput(ctx, reader, input_impl_);
       }
@@ -992,7 +1052,7 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
       mutex mu_;
       std::unique_ptr<IteratorBase> input_impl_ TF_GUARDED_BY(mu_);
       MemoryCache* const cache_ TF_GUARDED_BY(mu_);  // not owned.
-      std::vector<std::vector<Tensor>> temp_cache_ TF_GUARDED_BY(mu_);
+      std::shared_ptr<TieredElementCache> temp_cache_ TF_GUARDED_BY(mu_);
     };  // MemoryWriterIterator
 
     class MemoryReaderIterator : public DatasetIterator<MemoryDatasetBase> {
@@ -1007,11 +1067,13 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
         // dataset but performance modeling uses the iterator abstraction and
         // thus we record the memory allocated for the cache here. The caveat
         // is that this is incorrect if there are concurrent instances of this
-        // iterator.
+        // iterator. Only the elements kept in memory are recorded when the
+        // cache has a disk tier.
         tf_shared_lock l(mu_);
-        for (size_t i = 0; i < cache_->size(); ++i) {
-          RecordBufferEnqueue(ctx, cache_->at(i));
-        }
+        cache_->elements()->ForEachInMemory(
+            [&](const std::vector<Tensor>& element) {
+              RecordBufferEnqueue(ctx, element);
+            });
         return absl::OkStatus();
       }
 
@@ -1020,9 +1082,11 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
                                    bool* end_of_sequence) override {
         mutex_lock l(mu_);
         if (index_ < cache_->size()) {
-          const std::vector<Tensor>& cache_tensors = cache_->at(index_);
-          out_tensors->insert(out_tensors->begin(), cache_tensors.begin(),
-                              cache_tensors.end());
+          std::vector<Tensor> cache_tensors;
+          TF_RETURN_IF_ERROR(cache_->Get(index_, &cache_tensors));
+          out_tensors->insert(out_tensors->begin(),
+                              std::make_move_iterator(cache_tensors.begin()),
+                              std::make_move_iterator(cache_tensors.end()));
           index_++;
           *end_of_sequence = false;
           return absl::OkStatus();
@@ -375,6 +375,58 @@ INSTANTIATE_TEST_CASE_P(CacheDatasetOpTest,
                         ParameterizedIteratorSaveAndRestoreTest,
                         ::testing::ValuesIn(IteratorSaveAndRestoreTestCases()));
 
+TEST_F(CacheDatasetOpTest, RestoreAfterEndOfSequence) {
+  auto dataset_params = CacheDatasetParams3();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  std::vector<Tensor> expected_outputs = CreateTensors<int64_t>(
+      TensorShape({3, 1}), {{0, 1, 2}, {3, 4, 5}, {6, 7, 8}});
+
+  // Save the iterator while it is filling the cache.
+  bool end_of_sequence = false;
+  std::vector<Tensor> out_tensors;
+  TF_ASSERT_OK(
+      iterator_->GetNext(iterator_ctx_.get(), &out_tensors, &end_of_sequence));
+  std::unique_ptr<SerializationContext> serialization_ctx;
+  TF_ASSERT_OK(CreateSerializationContext(&serialization_ctx));
+  VariantTensorDataWriter writer;
+  TF_ASSERT_OK(iterator_->Save(serialization_ctx.get(), &writer));
+  std::vector<const VariantTensorData*> data;
+  writer.GetData(&data);
+
+  // Complete the cache, then restore the same iterator.
+  while (!end_of_sequence) {
+    out_tensors.clear();
+    TF_ASSERT_OK(iterator_->GetNext(iterator_ctx_.get(), &out_tensors,
+                                    &end_of_sequence));
+  }
+  VariantTensorDataReader reader(data);
+  TF_ASSERT_OK(iterator_->Restore(iterator_ctx_.get(), &reader));
+  for (int i = 1; i < expected_outputs.size(); ++i) {
+    out_tensors.clear();
+    TF_ASSERT_OK(iterator_->GetNext(iterator_ctx_.get(), &out_tensors,
+                                    &end_of_sequence));
+    ASSERT_FALSE(end_of_sequence);
+    TF_EXPECT_OK(ExpectEqual(out_tensors.back(), expected_outputs[i]));
+  }
+  out_tensors.clear();
+  TF_ASSERT_OK(
+      iterator_->GetNext(iterator_ctx_.get(), &out_tensors, &end_of_sequence));
+  EXPECT_TRUE(end_of_sequence);
+
+  // The completed cache holds each element once.
+  TF_ASSERT_OK(dataset_->MakeIterator(iterator_ctx_.get(), /*parent=*/nullptr,
+                                      dataset_params.iterator_prefix(),
+                                      &iterator_));
+  end_of_sequence = false;
+  std::vector<Tensor> cached_outputs;
+  while (!end_of_sequence) {
+    TF_ASSERT_OK(iterator_->GetNext(iterator_ctx_.get(), &cached_outputs,
+                                    &end_of_sequence));
+  }
+  TF_EXPECT_OK(ExpectEqual(cached_outputs, expected_outputs,
+                           /*compare_order=*/true));
+}
+
 TEST_F(CacheDatasetOpTest, NegativeIndexTest) {
   auto params = CacheDatasetParams3();
   TF_ASSERT_OK(Initialize(params));
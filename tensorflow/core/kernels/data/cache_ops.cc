@@ -21,9 +21,9 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
-#include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "tensorflow/core/data/dataset_utils.h"
+#include "tensorflow/core/data/tiered_element_cache.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/partial_tensor_shape.h"
 #include "tensorflow/core/framework/resource_mgr.h"
@@ -42,10 +42,10 @@ constexpr char kMemoryCache[] = "MemoryCache";
 
 std::string MemoryCacheManager::DebugString() const { return kMemoryCache; }
 
-void MemoryCache::Complete(std::vector<std::vector<Tensor>>&& cache) {
+void MemoryCache::Complete(std::shared_ptr<TieredElementCache> elements) {
   mutex_lock l(mu_);
   if (!completed_) {
-    cache_ = std::move(cache);
+    elements_ = std::move(elements);
     completed_ = true;
   }
 }
@@ -58,23 +58,25 @@ bool MemoryCache::IsCompleted() {
 void MemoryCache::Reset() {
   mutex_lock l(mu_);
   completed_ = false;
-  cache_.clear();
+  elements_.reset();
 }
 
-const std::vector<Tensor>& MemoryCache::at(int64_t index) {
-  tf_shared_lock l(mu_);
-  DCHECK(index < cache_.size());
-  return cache_[index];
+absl::Status MemoryCache::Get(int64_t index, std::vector<Tensor>* element) {
+  std::shared_ptr<TieredElementCache> elements = this->elements();
+  if (elements == nullptr) {
+    return absl::FailedPreconditionError("The cache is not completed.");
+  }
+  return elements->Get(index, element);
 }
 
 size_t MemoryCache::size() {
   tf_shared_lock l(mu_);
-  return cache_.size();
+  return elements_ == nullptr ? 0 : elements_->size();
 }
 
-const std::vector<std::vector<Tensor>>& MemoryCache::data() {
+std::shared_ptr<TieredElementCache> MemoryCache::elements() {
   tf_shared_lock l(mu_);
-  return cache_;
+  return elements_;
 }
 
 AnonymousMemoryCacheHandleOp::AnonymousMemoryCacheHandleOp(
@@ -16,8 +16,14 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_DATA_CACHE_OPS_H_
 #define TENSORFLOW_CORE_KERNELS_DATA_CACHE_OPS_H_
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
 #include "absl/status/status.h"
 #include "tensorflow/core/data/dataset_utils.h"
+#include "tensorflow/core/data/tiered_element_cache.h"
 #include "tensorflow/core/framework/resource_mgr.h"
 
 namespace tensorflow {
@@ -27,13 +33,15 @@ namespace data {
 //
 // The expected use is that a single `MemoryWriterIterator` populates the
 // cache with dataset elements. Once all elements are cached, the cache can
-// be used by one or more `MemoryReaderIterator`s.
+// be used by one or more `MemoryReaderIterator`s. The elements are held by a
+// `TieredElementCache`, which evicts elements to disk beyond its memory budget
+// when a disk tier is configured.
 class MemoryCache {
  public:
   MemoryCache() = default;
 
   // Marks the cache as completed.
-  void Complete(std::vector<std::vector<Tensor>>&& cache);
+  void Complete(std::shared_ptr<TieredElementCache> elements);
 
   // Returns whether the cache is completed.
   bool IsCompleted();
@@ -41,21 +49,21 @@ class MemoryCache {
   // Resets the cache.
   void Reset();
 
-  // Returns the element at the given index.
-  const std::vector<Tensor>& at(int64_t index);
+  // Copies the element at the given index into `element`.
+  absl::Status Get(int64_t index, std::vector<Tensor>* element);
 
   // Returns the size of the cache.
   size_t size();
 
-  // Returns a reference to the cache's data. The returned reference will be
-  // invalidated by any call to Reset().
-  const std::vector<std::vector<Tensor>>& data();
+  // Returns the cache's elements, or nullptr if the cache is not completed.
+  // The returned elements stay valid after Reset().
+  std::shared_ptr<TieredElementCache> elements();
 
  private:
   mutex mu_;
   // Determines whether all elements of the dataset have been cached.
   bool completed_ TF_GUARDED_BY(mu_) = false;
-  std::vector<std::vector<Tensor>> cache_ TF_GUARDED_BY(mu_);
+  std::shared_ptr<TieredElementCache> elements_ TF_GUARDED_BY(mu_);
 };
 
 // A resource wrapping a shared instance of a memory cache.
@@ -27,10 +27,12 @@ limitations under the License.
 
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/data/name_utils.h"
 #include "tensorflow/core/data/serialization_utils.h"
+#include "tensorflow/core/data/shuffle_spill_buffer.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/partial_tensor_shape.h"
 #include "tensorflow/core/framework/resource_mgr.h"
@@ -103,6 +105,14 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
             {{"buffer_size",
               absl::StrFormat("%lld", static_cast<long long>(buffer_size))}}) {
     input_->Ref();
+    absl::StatusOr<ShuffleSpillOptions> spill_options =
+        ShuffleSpillOptions::FromEnvironment();
+    if (spill_options.ok()) {
+      spill_options_ = *std::move(spill_options);
+    } else {
+      LOG(WARNING) << "Ignoring the shuffle spill options: "
+                   << spill_options.status();
+    }
   }
 
   ~ShuffleDatasetBase() override { input_->Unref(); }
@@ -195,7 +205,9 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
           seed_generator_(seed_generator),
           parent_generator_(seed_generator->seed(), seed_generator->seed2()),
           generator_(&parent_generator_) {
-      if (params.dataset->buffer_size_ == kUnknownCardinality) {
+      if (params.dataset->buffer_size_ == kUnknownCardinality ||
+          !params.dataset->spill_options_.directory.empty()) {
+        // In the spill mode, `spill_buffer_` replaces `buffer_`.
         buffer_ = std::make_unique<std::vector<std::vector<Tensor>>>();
       } else {
         buffer_ = std::make_unique<std::vector<std::vector<Tensor>>>(
@@ -209,9 +221,16 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
       mutex_lock l(mu_);
       seed_generator_->GenerateSeeds(&seed_, &seed2_);
       ResetRngs();
+      if (!dataset()->spill_options_.directory.empty()) {
+        TF_ASSIGN_OR_RETURN(
+            spill_buffer_,
+            ShuffleSpillBuffer::Create(
+                ctx->env(), dataset()->spill_options_,
+                IsShuffleAll() ? 0 : dataset()->buffer_size_));
+      }
       // Initialize checkpoint_indices_ to the entire buffer.
       if (ctx->symbolic_checkpoint()) {
-        for (int64_t i = 0; i < buffer_->size(); ++i) {
+        for (int64_t i = 0; i < BufferSize(); ++i) {
           checkpoint_indices_.insert(i);
         }
       }
@@ -236,13 +255,18 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
       // slice, and then remove the element from the slice.
       int64_t offset =
           Random() % (slices_.front()->end - slices_.front()->start);
-      int64_t index = (slices_.front()->start + offset) % buffer_->size();
-      *out_tensors = std::move(buffer_->at(index));
+      int64_t index = (slices_.front()->start + offset) % BufferSize();
+      const int64_t start_index = slices_.front()->start % BufferSize();
+      if (spill_buffer_) {
+        TF_RETURN_IF_ERROR(spill_buffer_->Take(index, out_tensors));
+        spill_buffer_->Swap(index, start_index);
+      } else {
+        *out_tensors = std::move(buffer_->at(index));
+        std::swap(buffer_->at(index), buffer_->at(start_index));
+      }
       this->RecordBufferDequeue(ctx, *out_tensors);
-      std::swap(buffer_->at(index),
-                buffer_->at(slices_.front()->start % buffer_->size()));
       checkpoint_indices_.insert(index);
-      checkpoint_indices_.insert(slices_.front()->start % buffer_->size());
+      checkpoint_indices_.insert(start_index);
       slices_.front()->start++;
       num_elements_--;
       return absl::OkStatus();
@@ -288,7 +312,27 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
       TF_RETURN_IF_ERROR(
           writer->WriteScalar(prefix(), kNumElements, num_elements_));
       const std::string key_prefix = absl::StrCat(prefix(), kColon, "buffer");
-      if (ctx->symbolic_checkpoint()) {
+      if (spill_buffer_) {
+        // Writes the same keys as the branches below, reading the spilled
+        // elements back one at a time.
+        TF_RETURN_IF_ERROR(
+            WriteNumElementsToCheckpoint(writer, key_prefix, BufferSize()));
+        auto write_element = [&](int64_t index) -> absl::Status {
+          std::vector<Tensor> element;
+          TF_RETURN_IF_ERROR(spill_buffer_->Get(index, &element));
+          return WriteElementToCheckpoint(writer, key_prefix, index, element);
+        };
+        if (ctx->symbolic_checkpoint()) {
+          for (int64_t index : checkpoint_indices_) {
+            TF_RETURN_IF_ERROR(write_element(index));
+          }
+          checkpoint_indices_.clear();
+        } else {
+          for (int64_t index = 0; index < BufferSize(); ++index) {
+            TF_RETURN_IF_ERROR(write_element(index));
+          }
+        }
+      } else if (ctx->symbolic_checkpoint()) {
         // When symbolic checkpointing is turned on, `writer`
         // already contains checkpoint of the shuffle buffer created by the
         // previous invocation of this instance and the indices that need to be
@@ -366,21 +410,39 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
         }
         slices_size = static_cast<size_t>(temp);
       }
-      buffer_ = std::make_unique<std::vector<std::vector<Tensor>>>();
-      TF_RETURN_IF_ERROR(ReadElementsFromCheckpoint(
-          ctx, reader, absl::StrCat(prefix(), kColon, "buffer"),
-          buffer_.get()));
+      const std::string key_prefix = absl::StrCat(prefix(), kColon, "buffer");
+      if (spill_buffer_) {
+        TF_ASSIGN_OR_RETURN(int64_t num_elements,
+                            ReadNumElementsFromCheckpoint(reader, key_prefix));
+        spill_buffer_->Reset(0);
+        for (int64_t i = 0; i < num_elements; ++i) {
+          std::vector<Tensor> element;
+          TF_RETURN_IF_ERROR(
+              ReadElementFromCheckpoint(ctx, reader, key_prefix, i, &element));
+          RecordBufferEnqueue(ctx, element);
+          TF_RETURN_IF_ERROR(spill_buffer_->Append(std::move(element)));
+        }
+      } else {
+        buffer_ = std::make_unique<std::vector<std::vector<Tensor>>>();
+        TF_RETURN_IF_ERROR(
+            ReadElementsFromCheckpoint(ctx, reader, key_prefix, buffer_.get()));
+        for (const auto& element : *buffer_) {
+          RecordBufferEnqueue(ctx, element);
+        }
+      }
       if (ctx->symbolic_checkpoint()) {
-        DCHECK(checkpoint_indices_.empty());
-        for (size_t i = 0; i < buffer_->size(); ++i) {
+        // The restored buffer replaces the one marked by `Initialize()`.
+        checkpoint_indices_.clear();
+        for (size_t i = 0; i < BufferSize(); ++i) {
           checkpoint_indices_.insert(i);
         }
       }
-      for (const auto& element : *buffer_) {
-        RecordBufferEnqueue(ctx, element);
-      }
       if (!IsShuffleAll()) {
-        buffer_->resize(dataset()->buffer_size_);
+        if (spill_buffer_) {
+          spill_buffer_->Resize(dataset()->buffer_size_);
+        } else {
+          buffer_->resize(dataset()->buffer_size_);
+        }
       }
       slices_.clear();
       for (size_t i = 0; i < slices_size; ++i) {
@@ -453,6 +515,10 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
       return dataset()->buffer_size_ == kUnknownCardinality;
     }
 
+    int64_t BufferSize() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      return spill_buffer_ ? spill_buffer_->size() : buffer_->size();
+    }
+
     // Fills the shuffle buffer, preparing the buffer for sampling.
     absl::Status FillBuffer(IteratorContext* ctx)
         TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
@@ -478,7 +544,7 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
           slices_.back()->reached_end_of_sequence = true;
         }
         if (!end_of_input_sequence) {
-          AddToShuffleBuffer(ctx, std::move(input_element));
+          TF_RETURN_IF_ERROR(AddToShuffleBuffer(ctx, std::move(input_element)));
           continue;
         }
         input_impl_.reset();
@@ -515,7 +581,7 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
         // we need to add to the buffer.
         return true;
       }
-      return num_elements_ < buffer_->size();
+      return num_elements_ < BufferSize();
     }
 
     absl::Status PrepareNextEpoch(IteratorContext* ctx)
@@ -535,7 +601,8 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
       return absl::OkStatus();
     }
 
-    void AddToShuffleBuffer(IteratorContext* ctx, std::vector<Tensor>&& element)
+    absl::Status AddToShuffleBuffer(IteratorContext* ctx,
+                                    std::vector<Tensor>&& element)
         TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
       data_produced_ = true;
       if (num_elements_ == 0) {
@@ -543,17 +610,26 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
                 << BufferSizeString();
       }
       this->RecordBufferEnqueue(ctx, element);
-      if (num_elements_ == buffer_->size()) {
+      if (num_elements_ == BufferSize()) {
         DCHECK(IsShuffleAll());
-        checkpoint_indices_.insert(buffer_->size());
-        buffer_->push_back(element);
+        checkpoint_indices_.insert(BufferSize());
+        if (spill_buffer_) {
+          TF_RETURN_IF_ERROR(spill_buffer_->Append(std::move(element)));
+        } else {
+          buffer_->push_back(element);
+        }
       } else {
-        size_t index = slices_.back()->end % buffer_->size();
+        size_t index = slices_.back()->end % BufferSize();
         checkpoint_indices_.insert(index);
-        buffer_->at(index) = std::move(element);
+        if (spill_buffer_) {
+          TF_RETURN_IF_ERROR(spill_buffer_->Set(index, std::move(element)));
+        } else {
+          buffer_->at(index) = std::move(element);
+        }
       }
       num_elements_++;
       slices_.back()->end++;
+      return absl::OkStatus();
     }
 
     void ClearEmptySlices() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
@@ -575,6 +651,9 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
     SeedGenerator* const seed_generator_ TF_GUARDED_BY(mu_);  // Not owned.
     std::unique_ptr<std::vector<std::vector<Tensor>>> buffer_
         TF_GUARDED_BY(mu_);
+    // Replaces `buffer_` in the spill mode, i.e. if
+    // `ShuffleSpillOptions::directory` is set.
+    std::unique_ptr<ShuffleSpillBuffer> spill_buffer_ TF_GUARDED_BY(mu_);
     // Holds the indices of `buffer_` that have changed since the previous
     // `SaveInternal()` and need to be updated in the MemoryCheckpoint
     // (if symbolic checkpointing is used) in the next `SaveInternal()`.
@@ -604,6 +683,10 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
   // responsible for repeating as well.
   const int64_t count_;
   const TraceMeMetadata traceme_metadata_;
+  // If `spill_options_.directory` is set, iterators keep at most
+  // `spill_options_.memory_budget_bytes` of the shuffle buffer in memory and
+  // spill the rest to disk.
+  ShuffleSpillOptions spill_options_;
   mutable mutex mu_;
   mutable std::vector<std::int64_t> shuffled_indices_ TF_GUARDED_BY(mu_);
 };  // ShuffleDatasetBase
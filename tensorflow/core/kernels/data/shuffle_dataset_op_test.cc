@@ -11,12 +11,15 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/kernels/data/shuffle_dataset_op.h"
 
+#include <cstdlib>
 #include <string>
+#include <tuple>
 #include <utility>
 
 #include "tensorflow/core/data/dataset_test_base.h"
 #include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/data/serialization_utils.h"
+#include "tensorflow/core/platform/path.h"
 
 namespace tensorflow {
 namespace data {
@@ -99,7 +102,109 @@ class ShuffleDatasetParams : public DatasetParams {
   bool reshuffle_each_iteration_;
 };
 
-class ShuffleDatasetOpTest : public DatasetOpsTestBase {};
+class ShuffleDatasetOpTest : public DatasetOpsTestBase {
+ protected:
+  // Checks the outputs of an iterator, and of a second one reshuffling the
+  // dataset.
+  void TestGetNext(const GetNextTestCase<ShuffleDatasetParams>& test_case) {
+    TF_ASSERT_OK(Initialize(test_case.dataset_params));
+
+    bool end_of_sequence = false;
+    std::vector<Tensor> shuffled_out_tensors;
+    while (!end_of_sequence) {
+      std::vector<Tensor> next;
+      TF_EXPECT_OK(
+          iterator_->GetNext(iterator_ctx_.get(), &next, &end_of_sequence));
+      shuffled_out_tensors.insert(shuffled_out_tensors.end(), next.begin(),
+                                  next.end());
+      // For the forever-repeat case, we test only a finite number of steps of
+      // the infinite sequence.
+      if (test_case.dataset_params.count() == -1 &&
+          shuffled_out_tensors.size() ==
+              test_case.expected_shuffle_outputs.size()) {
+        break;
+      }
+    }
+
+    // Reshuffle the dataset.
+    end_of_sequence = false;
+    TF_ASSERT_OK(dataset_->MakeIterator(
+        iterator_ctx_.get(), /*parent=*/nullptr,
+        test_case.dataset_params.iterator_prefix(), &iterator_));
+    std::vector<Tensor> reshuffled_out_tensors;
+    while (!end_of_sequence) {
+      std::vector<Tensor> next;
+      TF_EXPECT_OK(
+          iterator_->GetNext(iterator_ctx_.get(), &next, &end_of_sequence));
+      reshuffled_out_tensors.insert(reshuffled_out_tensors.end(), next.begin(),
+                                    next.end());
+      // For the forever-repeat case, we test only a finite number of steps of
+      // the infinite sequence.
+      if (test_case.dataset_params.count() == -1 &&
+          reshuffled_out_tensors.size() ==
+              test_case.expected_shuffle_outputs.size()) {
+        break;
+      }
+    }
+
+    TF_EXPECT_OK(ExpectEqual(shuffled_out_tensors,
+                             test_case.expected_shuffle_outputs,
+                             /*compare_order=*/true));
+    TF_EXPECT_OK(ExpectEqual(reshuffled_out_tensors,
+                             test_case.expected_reshuffle_outputs,
+                             /*compare_order=*/true));
+  }
+
+  // Checks the outputs of an iterator that is saved and restored at each of
+  // the breakpoints.
+  void TestIteratorSaveAndRestore(
+      const IteratorSaveAndRestoreTestCase<ShuffleDatasetParams>& test_case,
+      bool symbolic_checkpoint) {
+    TF_ASSERT_OK(InitializeRuntime(test_case.dataset_params));
+    std::unique_ptr<TestDataset> dataset;
+    TF_ASSERT_OK(MakeDataset(test_case.dataset_params, &dataset));
+    std::unique_ptr<IteratorContext> iterator_ctx;
+    TF_ASSERT_OK(
+        CreateIteratorContext(dataset->op_kernel_context(), &iterator_ctx));
+    IteratorContext::Params params(iterator_ctx.get());
+    params.symbolic_checkpoint = symbolic_checkpoint;
+    iterator_ctx = std::make_unique<IteratorContext>(std::move(params));
+    std::unique_ptr<IteratorBase> iterator;
+    TF_ASSERT_OK(dataset->dataset()->MakeIterator(
+        iterator_ctx.get(), /*parent=*/nullptr,
+        test_case.dataset_params.iterator_prefix(), &iterator));
+
+    SerializationContext::Params serialization_params;
+    serialization_params.symbolic_checkpoint = symbolic_checkpoint;
+    SerializationContext serialization_ctx(serialization_params);
+
+    bool end_of_sequence = false;
+    std::vector<Tensor> out_tensors;
+    int cur_iteration = 0;
+    const std::vector<int>& breakpoints = test_case.breakpoints;
+    for (int breakpoint : breakpoints) {
+      VariantTensorDataWriter writer;
+      TF_EXPECT_OK(iterator->Save(&serialization_ctx, &writer));
+      std::vector<const VariantTensorData*> data;
+      writer.GetData(&data);
+      VariantTensorDataReader reader(data);
+      TF_EXPECT_OK(RestoreIterator(iterator_ctx.get(), &reader,
+                                   test_case.dataset_params.iterator_prefix(),
+                                   *dataset->dataset(), &iterator));
+
+      while (cur_iteration <= breakpoint) {
+        std::vector<Tensor> next;
+        TF_EXPECT_OK(
+            iterator->GetNext(iterator_ctx.get(), &next, &end_of_sequence));
+        out_tensors.insert(out_tensors.end(), next.begin(), next.end());
+        cur_iteration++;
+      }
+    }
+
+    TF_EXPECT_OK(ExpectEqual(out_tensors, test_case.expected_shuffle_outputs,
+                             /*compare_order=*/true));
+  }
+};
 
 // Test case 1: test shuffle_dataset with reshuffle_each_iteration = false.
 ShuffleDatasetParams ShuffleDatasetParams1() {
@@ -345,55 +450,7 @@ class ParameterizedGetNextTest : public ShuffleDatasetOpTest,
                                  public ::testing::WithParamInterface<
                                      GetNextTestCase<ShuffleDatasetParams>> {};
 
-TEST_P(ParameterizedGetNextTest, GetNext) {
-  auto test_case = GetParam();
-  TF_ASSERT_OK(Initialize(test_case.dataset_params));
-
-  bool end_of_sequence = false;
-  std::vector<Tensor> shuffled_out_tensors;
-  while (!end_of_sequence) {
-    std::vector<Tensor> next;
-    TF_EXPECT_OK(
-        iterator_->GetNext(iterator_ctx_.get(), &next, &end_of_sequence));
-    shuffled_out_tensors.insert(shuffled_out_tensors.end(), next.begin(),
-                                next.end());
-    // For the forever-repeat case, we test only a finite number of steps of
-    // the infinite sequence.
-    if (test_case.dataset_params.count() == -1 &&
-        shuffled_out_tensors.size() ==
-            test_case.expected_shuffle_outputs.size()) {
-      break;
-    }
-  }
-
-  // Reshuffle the dataset.
-  end_of_sequence = false;
-  TF_ASSERT_OK(dataset_->MakeIterator(
-      iterator_ctx_.get(), /*parent=*/nullptr,
-      test_case.dataset_params.iterator_prefix(), &iterator_));
-  std::vector<Tensor> reshuffled_out_tensors;
-  while (!end_of_sequence) {
-    std::vector<Tensor> next;
-    TF_EXPECT_OK(
-        iterator_->GetNext(iterator_ctx_.get(), &next, &end_of_sequence));
-    reshuffled_out_tensors.insert(reshuffled_out_tensors.end(), next.begin(),
-                                  next.end());
-    // For the forever-repeat case, we test only a finite number of steps of
-    // the infinite sequence.
-    if (test_case.dataset_params.count() == -1 &&
-        reshuffled_out_tensors.size() ==
-            test_case.expected_shuffle_outputs.size()) {
-      break;
-    }
-  }
-
-  TF_EXPECT_OK(ExpectEqual(shuffled_out_tensors,
-                           test_case.expected_shuffle_outputs,
-                           /*compare_order=*/true));
-  TF_EXPECT_OK(ExpectEqual(reshuffled_out_tensors,
-                           test_case.expected_reshuffle_outputs,
-                           /*compare_order=*/true));
-}
+TEST_P(ParameterizedGetNextTest, GetNext) { TestGetNext(GetParam()); }
 
 INSTANTIATE_TEST_CASE_P(ShuffleDatasetOpTest, ParameterizedGetNextTest,
                         ::testing::ValuesIn(GetNextTestCases()));
@@ -547,43 +604,61 @@ class ParameterizedIteratorSaveAndRestoreTest
           IteratorSaveAndRestoreTestCase<ShuffleDatasetParams>> {};
 
 TEST_P(ParameterizedIteratorSaveAndRestoreTest, IteratorSaveAndRestore) {
-  auto test_case = GetParam();
-  TF_ASSERT_OK(Initialize(test_case.dataset_params));
-
-  std::unique_ptr<SerializationContext> serialization_ctx;
-  TF_ASSERT_OK(CreateSerializationContext(&serialization_ctx));
-
-  bool end_of_sequence = false;
-  std::vector<Tensor> out_tensors;
-  int cur_iteration = 0;
-  const std::vector<int>& breakpoints = test_case.breakpoints;
-  for (int breakpoint : breakpoints) {
-    VariantTensorDataWriter writer;
-    TF_EXPECT_OK(iterator_->Save(serialization_ctx.get(), &writer));
-    std::vector<const VariantTensorData*> data;
-    writer.GetData(&data);
-    VariantTensorDataReader reader(data);
-    TF_EXPECT_OK(RestoreIterator(iterator_ctx_.get(), &reader,
-                                 test_case.dataset_params.iterator_prefix(),
-                                 *dataset_, &iterator_));
-
-    while (cur_iteration <= breakpoint) {
-      std::vector<Tensor> next;
-      TF_EXPECT_OK(
-          iterator_->GetNext(iterator_ctx_.get(), &next, &end_of_sequence));
-      out_tensors.insert(out_tensors.end(), next.begin(), next.end());
-      cur_iteration++;
-    }
-  }
-
-  TF_EXPECT_OK(ExpectEqual(out_tensors, test_case.expected_shuffle_outputs,
-                           /*compare_order=*/true));
+  TestIteratorSaveAndRestore(GetParam(), /*symbolic_checkpoint=*/false);
 }
 
 INSTANTIATE_TEST_CASE_P(ShuffleDatasetOpTest,
                         ParameterizedIteratorSaveAndRestoreTest,
                         ::testing::ValuesIn(IteratorSaveAndRestoreTestCases()));
 
+// Runs the tests above in the spill mode, which is enabled for the datasets
+// created while TF_DATA_SHUFFLE_SPILL_DIR is set. With a memory budget of 0 MB,
+// every element of the buffer is spilled and read back from disk.
+class ShuffleDatasetOpSpillTest : public ShuffleDatasetOpTest {
+ protected:
+  void SetUp() override {
+    ShuffleDatasetOpTest::SetUp();
+    setenv("TF_DATA_SHUFFLE_SPILL_DIR",
+           io::JoinPath(testing::TmpDir(), "shuffle_spill").c_str(),
+           /*overwrite=*/1);
+    setenv("TF_DATA_SHUFFLE_SPILL_MEMORY_MB", "0", /*overwrite=*/1);
+  }
+
+  void TearDown() override {
+    unsetenv("TF_DATA_SHUFFLE_SPILL_DIR");
+    unsetenv("TF_DATA_SHUFFLE_SPILL_MEMORY_MB");
+    ShuffleDatasetOpTest::TearDown();
+  }
+};
+
+class ParameterizedSpillGetNextTest
+    : public ShuffleDatasetOpSpillTest,
+      public ::testing::WithParamInterface<
+          GetNextTestCase<ShuffleDatasetParams>> {};
+
+TEST_P(ParameterizedSpillGetNextTest, GetNext) { TestGetNext(GetParam()); }
+
+INSTANTIATE_TEST_CASE_P(ShuffleDatasetOpSpillTest,
+                        ParameterizedSpillGetNextTest,
+                        ::testing::ValuesIn(GetNextTestCases()));
+
+// Saves the spilled buffer either explicitly, or symbolically, which only
+// writes the elements at `checkpoint_indices_`.
+class ParameterizedSpillIteratorSaveAndRestoreTest
+    : public ShuffleDatasetOpSpillTest,
+      public ::testing::WithParamInterface<std::tuple<
+          IteratorSaveAndRestoreTestCase<ShuffleDatasetParams>, bool>> {};
+
+TEST_P(ParameterizedSpillIteratorSaveAndRestoreTest, IteratorSaveAndRestore) {
+  TestIteratorSaveAndRestore(std::get<0>(GetParam()),
+                             /*symbolic_checkpoint=*/std::get<1>(GetParam()));
+}
+
+INSTANTIATE_TEST_CASE_P(
+    ShuffleDatasetOpSpillTest, ParameterizedSpillIteratorSaveAndRestoreTest,
+    ::testing::Combine(::testing::ValuesIn(IteratorSaveAndRestoreTestCases()),
+                       ::testing::Bool()));
+
 TEST_F(ShuffleDatasetOpTest, InvalidArguments) {
   std::vector<ShuffleDatasetParams> dataset_params_vec(
       {ShuffleDatasetParamsWithInvalidBufferSize(),
@@ -14,8 +14,16 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/kernels/data/tf_record_dataset_op.h"
 
+#include <algorithm>
 #include <cstdint>
-
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/data/name_utils.h"
 #include "tensorflow/core/data/utils.h"
 #include "tensorflow/core/framework/dataset.h"
@@ -31,6 +39,7 @@ limitations under the License.
 #include "tensorflow/core/lib/io/zlib_inputstream.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tsl/profiler/lib/traceme.h"
+#include "xla/tsl/lib/io/parallel_record_reader.h"
 
 namespace tensorflow {
 namespace data {
@@ -43,12 +52,15 @@ namespace data {
 /* static */ constexpr const char* const TFRecordDatasetOp::kCompressionType;
 /* static */ constexpr const char* const TFRecordDatasetOp::kBufferSize;
 /* static */ constexpr const char* const TFRecordDatasetOp::kByteOffsets;
+/* static */ constexpr const char* const TFRecordDatasetOp::kRecordReader;
 
 constexpr char kTFRecordDataset[] = "TFRecordDataset";
 constexpr char kCurrentFileIndex[] = "current_file_index";
 constexpr char kOffset[] = "offset";
 constexpr char kGcsFsPrefix[] = "gs://";
 constexpr char kS3FsPrefix[] = "s3://";
+constexpr char kAutoRecordReader[] = "auto";
+constexpr char kParallelRecordReader[] = "parallel";
 constexpr int64_t kUnspecifiedBufferSize = -1;
 constexpr int64_t kDefaultBufferSize = 256LL << 10;  // 256KB
 constexpr int64_t kCloudTpuBlockSize = 127LL << 20;  // 127MB.
@@ -68,14 +80,16 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
  public:
   explicit Dataset(OpKernelContext* ctx, std::vector<std::string> filenames,
                    const std::string& compression_type, int64_t buffer_size,
-                   std::vector<int64_t> byte_offsets, int op_version)
+                   std::vector<int64_t> byte_offsets, int op_version,
+                   const std::string& record_reader)
       : DatasetBase(DatasetContext(ctx)),
         filenames_(std::move(filenames)),
         compression_type_(compression_type),
         options_(io::RecordReaderOptions::CreateRecordReaderOptions(
             compression_type)),
         byte_offsets_(std::move(byte_offsets)),
-        op_version_(op_version) {
+        op_version_(op_version),
+        record_reader_(record_reader) {
     if (buffer_size > 0) {
       options_.buffer_size = buffer_size;
     }
@@ -123,8 +137,14 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
     TF_RETURN_IF_ERROR(b->AddScalar(compression_type_, &compression_type));
     Node* buffer_size = nullptr;
     TF_RETURN_IF_ERROR(b->AddScalar(options_.buffer_size, &buffer_size));
+    std::vector<std::pair<absl::string_view, AttrValue>> attrs;
+    if (op_version_ > 1) {
+      AttrValue record_reader_attr;
+      b->BuildAttrValue(record_reader_, &record_reader_attr);
+      attrs.emplace_back(kRecordReader, record_reader_attr);
+    }
     TF_RETURN_IF_ERROR(b->AddDataset(
-        this, {filenames, compression_type, buffer_size}, output));
+        this, {filenames, compression_type, buffer_size}, attrs, output));
     Node* byte_offsets = nullptr;
     TF_RETURN_IF_ERROR(b->AddVector(byte_offsets_, &byte_offsets));
     return absl::OkStatus();
@@ -141,6 +161,15 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
           .files = dataset()->filenames_,
           .data_service_address = ctx->data_service_address()};
       LogFilenames(log_filenames_options);
+      // The "parallel_tfrecord_reader" experiment only picks the reader when
+      // the op leaves it to the runtime.
+      use_parallel_reader_ =
+          dataset()->record_reader_ == kAutoRecordReader
+              ? GetExperiments().contains("parallel_tfrecord_reader")
+              : dataset()->record_reader_ == kParallelRecordReader;
+      if (use_parallel_reader_) {
+        runner_ = *ctx->runner();
+      }
       return absl::OkStatus();
     }
 
@@ -153,11 +182,12 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
       mutex_lock l(mu_);
       do {
         // We are currently processing a file, so try to read the next record.
-        if (reader_) {
+        if (reader_ || parallel_reader_) {
           out_tensors->emplace_back(ctx->allocator({}), DT_STRING,
                                     TensorShape({}));
-          absl::Status s =
-              reader_->ReadRecord(&out_tensors->back().scalar<tstring>()());
+          tstring* record = &out_tensors->back().scalar<tstring>()();
+          absl::Status s = reader_ ? reader_->ReadRecord(record)
+                                   : parallel_reader_->ReadRecord(record);
           if (s.ok()) {
             static monitoring::CounterCell* bytes_counter =
                 metrics::GetTFDataBytesReadCounter(kDatasetType);
@@ -200,10 +230,13 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
       do {
         // We are currently processing a file, so try to skip reading
         // the next (num_to_skip - *num_skipped) record.
-        if (reader_) {
+        if (reader_ || parallel_reader_) {
           int last_num_skipped;
-          absl::Status s = reader_->SkipRecords(num_to_skip - *num_skipped,
-                                                &last_num_skipped);
+          absl::Status s =
+              reader_ ? reader_->SkipRecords(num_to_skip - *num_skipped,
+                                             &last_num_skipped)
+                      : SkipParallelRecordsLocked(num_to_skip - *num_skipped,
+                                                  &last_num_skipped);
           *num_skipped += last_num_skipped;
           if (s.ok()) {
             *end_of_sequence = false;
@@ -246,9 +279,10 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
       TF_RETURN_IF_ERROR(writer->WriteScalar(prefix(), kCurrentFileIndex,
                                              current_file_index_));
 
-      if (reader_) {
-        TF_RETURN_IF_ERROR(
-            writer->WriteScalar(prefix(), kOffset, reader_->TellOffset()));
+      if (reader_ || parallel_reader_) {
+        const uint64_t offset = reader_ ? reader_->TellOffset()
+                                        : parallel_reader_->TellOffset();
+        TF_RETURN_IF_ERROR(writer->WriteScalar(prefix(), kOffset, offset));
       }
       return absl::OkStatus();
     }
@@ -256,7 +290,7 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
     absl::Status RestoreInternal(IteratorContext* ctx,
                                  IteratorStateReader* reader) override {
       mutex_lock l(mu_);
-      ResetStreamsLocked();
+      ResetStreamsLocked(/*reset_read_ahead=*/true);
       int64_t current_file_index;
       TF_RETURN_IF_ERROR(
           reader->ReadScalar(prefix(), kCurrentFileIndex, &current_file_index));
@@ -264,15 +298,16 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
       if (reader->Contains(prefix(), kOffset)) {
         int64_t offset;
         TF_RETURN_IF_ERROR(reader->ReadScalar(prefix(), kOffset, &offset));
-        TF_RETURN_IF_ERROR(SetupStreamsLocked(ctx->env()));
-        TF_RETURN_IF_ERROR(reader_->SeekOffset(offset));
+        TF_RETURN_IF_ERROR(SetupStreamsLocked(ctx->env(), offset));
       }
       return absl::OkStatus();
     }
 
    private:
-    // Sets up reader streams to read from the file at `current_file_index_`.
-    absl::Status SetupStreamsLocked(Env* env) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    // Sets up reader streams to read from the file at `current_file_index_`,
+    // starting at `offset` if it is non-negative.
+    absl::Status SetupStreamsLocked(Env* env, int64_t offset = -1)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
       if (current_file_index_ >= dataset()->filenames_.size()) {
         return absl::InvalidArgumentError(absl::StrCat(
             "current_file_index_:", current_file_index_,
@@ -288,22 +323,98 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
           },
           tsl::profiler::kInfo);
 
+      if (offset < 0 && !dataset()->byte_offsets_.empty()) {
+        offset = dataset()->byte_offsets_[current_file_index_];
+      }
+      if (use_parallel_reader_) {
+        return SetupParallelStreamsLocked(env, std::max<int64_t>(offset, 0));
+      }
       TF_RETURN_IF_ERROR(env->NewRandomAccessFile(
           TranslateFileName(dataset()->filenames_[current_file_index_]),
           &file_));
       reader_ = std::make_unique<io::SequentialRecordReader>(
           file_.get(), dataset()->options_);
-      if (!dataset()->byte_offsets_.empty()) {
-        TF_RETURN_IF_ERROR(
-            reader_->SeekOffset(dataset()->byte_offsets_[current_file_index_]));
+      if (offset >= 0) {
+        TF_RETURN_IF_ERROR(reader_->SeekOffset(offset));
+      }
+      return absl::OkStatus();
+    }
+
+    // Sets up a parallel reader for the file at `current_file_index_`, and
+    // starts reading ahead the next file so that its first records are ready
+    // when the current one ends.
+    absl::Status SetupParallelStreamsLocked(Env* env, int64_t offset)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      if (next_parallel_reader_ &&
+          next_file_index_ == current_file_index_ &&
+          next_parallel_reader_->TellOffset() == offset) {
+        file_ = std::move(next_file_);
+        parallel_reader_ = std::move(next_parallel_reader_);
+      } else {
+        next_parallel_reader_.reset();
+        next_file_.reset();
+        TF_RETURN_IF_ERROR(env->NewRandomAccessFile(
+            TranslateFileName(dataset()->filenames_[current_file_index_]),
+            &file_));
+        parallel_reader_ = std::make_unique<io::ParallelRecordReader>(
+            file_.get(), offset, ParallelReaderOptions(), env);
+      }
+
+      next_file_index_ = current_file_index_ + 1;
+      if (next_file_index_ < dataset()->filenames_.size()) {
+        const int64_t next_offset =
+            dataset()->byte_offsets_.empty()
+                ? 0
+                : dataset()->byte_offsets_[next_file_index_];
+        // Failing to open the next file early is not an error; it is
+        // reported when the file is opened in turn.
+        if (env->NewRandomAccessFile(
+                   TranslateFileName(dataset()->filenames_[next_file_index_]),
+                   &next_file_)
+                .ok()) {
+          next_parallel_reader_ = std::make_unique<io::ParallelRecordReader>(
+              next_file_.get(), next_offset, ParallelReaderOptions(), env);
+        }
       }
       return absl::OkStatus();
     }
 
-    // Resets all reader streams.
-    void ResetStreamsLocked() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    io::ParallelRecordReaderOptions ParallelReaderOptions() const {
+      io::ParallelRecordReaderOptions options;
+      options.record_options = dataset()->options_;
+      // The current and the next reader read on the iterator's threads
+      // instead of starting a pool each.
+      options.runner = runner_;
+      if (dataset()->options_.buffer_size > 0) {
+        options.extent_size =
+            std::max<int64_t>(options.extent_size,
+                              dataset()->options_.buffer_size);
+      }
+      return options;
+    }
+
+    absl::Status SkipParallelRecordsLocked(int num_to_skip, int* num_skipped)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      *num_skipped = 0;
+      absl::Cord record;
+      while (*num_skipped < num_to_skip) {
+        TF_RETURN_IF_ERROR(parallel_reader_->ReadRecord(&record));
+        ++*num_skipped;
+      }
+      return absl::OkStatus();
+    }
+
+    // Resets the reader streams of the current file. A reader reading ahead
+    // the next file is kept unless `reset_read_ahead` is true.
+    void ResetStreamsLocked(bool reset_read_ahead = false)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
       reader_.reset();
+      parallel_reader_.reset();
       file_.reset();
+      if (reset_read_ahead) {
+        next_parallel_reader_.reset();
+        next_file_.reset();
+      }
     }
 
     mutex mu_;
@@ -313,6 +424,19 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
     // we must destroy `reader_` before `file_`.
     std::unique_ptr<RandomAccessFile> file_ TF_GUARDED_BY(mu_);
     std::unique_ptr<io::SequentialRecordReader> reader_ TF_GUARDED_BY(mu_);
+
+    // Used instead of `reader_` with the "parallel" record reader or the
+    // "parallel_tfrecord_reader" experiment. `next_parallel_reader_` reads
+    // ahead the file at `next_file_index_`. The readers run their reads on
+    // `runner_`.
+    bool use_parallel_reader_ = false;
+    std::function<void(std::function<void()>)> runner_;
+    std::unique_ptr<io::ParallelRecordReader> parallel_reader_
+        TF_GUARDED_BY(mu_);
+    size_t next_file_index_ TF_GUARDED_BY(mu_) = 0;
+    std::unique_ptr<RandomAccessFile> next_file_ TF_GUARDED_BY(mu_);
+    std::unique_ptr<io::ParallelRecordReader> next_parallel_reader_
+        TF_GUARDED_BY(mu_);
   };
 
   const std::vector<std::string> filenames_;
@@ -320,11 +444,17 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
   io::RecordReaderOptions options_;
   const std::vector<int64_t> byte_offsets_;
   const int op_version_;
+  const std::string record_reader_;
 };
 
 TFRecordDatasetOp::TFRecordDatasetOp(OpKernelConstruction* ctx)
     : DatasetOpKernel(ctx),
-      op_version_(ctx->def().op() == kTFRecordDataset ? 1 : 2) {}
+      op_version_(ctx->def().op() == kTFRecordDataset ? 1 : 2),
+      record_reader_(kAutoRecordReader) {
+  if (op_version_ > 1) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr(kRecordReader, &record_reader_));
+  }
+}
 
 void TFRecordDatasetOp::MakeDataset(OpKernelContext* ctx,
                                     DatasetBase** output) {
@@ -402,7 +532,8 @@ void TFRecordDatasetOp::MakeDataset(OpKernelContext* ctx,
   }
 
   *output = new Dataset(ctx, std::move(filenames), compression_type,
-                        buffer_size, std::move(byte_offsets), op_version_);
+                        buffer_size, std::move(byte_offsets), op_version_,
+                        record_reader_);
 }
 
 namespace {
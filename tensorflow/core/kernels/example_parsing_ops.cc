@@ -15,11 +15,14 @@ limitations under the License.
 
 // See docs in ../ops/parsing_ops.cc.
 
+#include <memory>
 #include <numeric>
 #include <unordered_set>
 #include <vector>
 
 #include "absl/base/call_once.h"
+#include "absl/status/status.h"
+#include "xla/tsl/platform/statusor.h"
 #include "tensorflow/core/example/example.pb.h"
 #include "tensorflow/core/example/feature.pb.h"
 #include "tensorflow/core/framework/common_shape_fns.h"
@@ -30,7 +33,9 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/array_slice.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/protobuf.h"
+#include "tensorflow/core/platform/thread_annotations.h"
 #include "tensorflow/core/util/example_proto_fast_parsing.h"
 #include "tensorflow/core/util/example_proto_helper.h"
 #include "tensorflow/core/util/sparse/sparse_tensor.h"
@@ -89,6 +94,7 @@ class ParseExampleOp : public OpKernel {
 
     example::FastParseExampleConfig config =
         MakeConfig(dense_keys_t, sparse_keys_t, ragged_keys_t, dense_defaults);
+    OP_REQUIRES_OK(ctx, SetFeatureNameIndex(&config));
 
     example::Result result;
     if (TensorShapeUtils::IsVector(serialized->shape())) {
@@ -235,6 +241,22 @@ class ParseExampleOp : public OpKernel {
     return config;
   }
 
+  // Sets the index of the feature names of `config`. The keys are inputs of
+  // the op but rarely change between calls, so the index of the previous call
+  // is reused unless they do.
+  absl::Status SetFeatureNameIndex(example::FastParseExampleConfig* config) {
+    {
+      tf_shared_lock l(mu_);
+      config->feature_name_index = feature_name_index_;
+    }
+    if (example::HasValidFeatureNameIndex(*config)) return absl::OkStatus();
+    TF_ASSIGN_OR_RETURN(config->feature_name_index,
+                        example::CompileFeatureNameIndex(*config));
+    mutex_lock l(mu_);
+    feature_name_index_ = config->feature_name_index;
+    return absl::OkStatus();
+  }
+
   // Parses a single example.
   absl::Status ParseExampleScalar(const example::FastParseExampleConfig& config,
                                   const Tensor* serialized,
@@ -292,6 +314,9 @@ class ParseExampleOp : public OpKernel {
   ParseExampleAttrs attrs_;
   int op_version_;
   absl::once_flag flag_;
+  mutex mu_;
+  std::shared_ptr<const example::FeatureNameIndex> feature_name_index_
+      TF_GUARDED_BY(mu_);
 };
 
 REGISTER_KERNEL_BUILDER(Name("ParseExample").Device(DEVICE_CPU),
@@ -305,6 +330,19 @@ class ParseSingleExampleOp : public OpKernel {
     OP_REQUIRES_OK(ctx, attrs_.Init(ctx));
     metrics::RecordParseDenseFeature(attrs_.dense_keys.size());
     metrics::RecordParseSparseFeature(attrs_.sparse_keys.size());
+
+    // The keys are attributes, so the index of the feature names is compiled
+    // once for all calls.
+    example::FastParseExampleConfig config;
+    for (const tstring& key : attrs_.dense_keys) {
+      config.dense.emplace_back().feature_name = key;
+    }
+    for (const tstring& key : attrs_.sparse_keys) {
+      config.sparse.emplace_back().feature_name = key;
+    }
+    auto feature_name_index = example::CompileFeatureNameIndex(config);
+    OP_REQUIRES_OK(ctx, feature_name_index.status());
+    feature_name_index_ = *std::move(feature_name_index);
   }
 
   void Compute(OpKernelContext* ctx) override {
@@ -355,8 +393,8 @@ class ParseSingleExampleOp : public OpKernel {
 
     example::Result result;
 
-    // TODO(mrry): Build the configuration once and cache it.
     example::FastParseExampleConfig config;
+    config.feature_name_index = feature_name_index_;
     for (int d = 0; d < attrs_.dense_keys.size(); ++d) {
       config.dense.push_back({attrs_.dense_keys[d], attrs_.dense_types[d],
                               attrs_.dense_shapes[d], dense_defaults[d],
@@ -392,6 +430,7 @@ class ParseSingleExampleOp : public OpKernel {
 
  protected:
   ParseSingleExampleAttrs attrs_;
+  std::shared_ptr<const example::FeatureNameIndex> feature_name_index_;
 };
 
 REGISTER_KERNEL_BUILDER(Name("ParseSingleExample").Device(DEVICE_CPU),
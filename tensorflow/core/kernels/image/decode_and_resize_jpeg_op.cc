@@ -0,0 +1,253 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// See docs in ../ops/image_ops.cc
+
+#define EIGEN_USE_THREADS
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
+#include "tensorflow/core/framework/bounds_check.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/op_requires.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_types.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/image/resize_bilinear_op.h"
+#include "tensorflow/core/lib/jpeg/jpeg_mem.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/tstring.h"
+#include "tensorflow/core/util/image_resizer_state.h"
+#include "tsl/profiler/lib/traceme.h"
+
+namespace tensorflow {
+
+typedef Eigen::ThreadPoolDevice CPUDevice;
+
+namespace functor {
+// Instantiated in resize_bilinear_op.cc.
+extern template struct ResizeBilinear<CPUDevice, uint8_t>;
+}  // namespace functor
+
+namespace {
+
+// The 4th byte of JPEG is '\xe0' or '\xe1', so check just the first three.
+static const char kJpegMagicBytes[] = "\xff\xd8\xff";
+
+// The denominators of the DCT scales supported by `jpeg::UncompressFlags`,
+// from the smallest scale.
+constexpr int kRatios[] = {8, 4, 2, 1};
+
+// The size of `size` pixels decoded at 1/`ratio` scale by libjpeg.
+int64_t ScaledSize(int64_t size, int ratio) {
+  return (size + ratio - 1) / ratio;
+}
+
+// Whether the pixels [`begin`, `end`) of an image of `size` pixels are exactly
+// the pixels of the image decoded at 1/`ratio` scale covering them.
+bool IsAligned(int64_t begin, int64_t end, int64_t size, int ratio) {
+  return begin % ratio == 0 && (end % ratio == 0 || end == size);
+}
+
+// Decodes a JPEG image and resizes it with bilinear interpolation, as
+// DecodeJpeg (or DecodeAndCropJpeg), ExpandDims and ResizeBilinear do.
+//
+// libjpeg downscales images by 1/2, 1/4 or 1/8 in the DCT domain, skipping
+// most of the inverse DCT. The image is decoded at the smallest of these
+// scales at which it is at least the output size, so that the bilinear resize
+// downscales it by less than 2x, and at which the crop window, if any, is
+// aligned to the pixels of the downscaled image. Since the pixels of the
+// downscaled image average blocks of the image, the result is close to, but
+// not the same as, resizing the full-size image.
+class DecodeAndResizeJpegOp : public OpKernel {
+ public:
+  explicit DecodeAndResizeJpegOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("channels", &channels_));
+    OP_REQUIRES(context, channels_ == 0 || channels_ == 1 || channels_ == 3,
+                absl::InvalidArgumentError(absl::StrCat(
+                    "`channels` must be 0, 1 or 3 but got ", channels_)));
+    OP_REQUIRES_OK(context, context->GetAttr("fancy_upscaling",
+                                             &flags_.fancy_upscaling));
+    OP_REQUIRES_OK(context,
+                   context->GetAttr("try_recover_truncated",
+                                    &flags_.try_recover_truncated_jpeg));
+    OP_REQUIRES_OK(context, context->GetAttr("acceptable_fraction",
+                                             &flags_.min_acceptable_fraction));
+    std::string dct_method;
+    OP_REQUIRES_OK(context, context->GetAttr("dct_method", &dct_method));
+    OP_REQUIRES(
+        context,
+        (dct_method.empty() || dct_method == "INTEGER_FAST" ||
+         dct_method == "INTEGER_ACCURATE"),
+        absl::InvalidArgumentError("dct_method must be one of {'', "
+                                   "'INTEGER_FAST', 'INTEGER_ACCURATE'}"));
+    // The TensorFlow-chosen default for JPEG decoding is IFAST, sacrificing
+    // image quality for speed.
+    flags_.dct_method =
+        dct_method == "INTEGER_ACCURATE" ? JDCT_ISLOW : JDCT_IFAST;
+    flags_.components = channels_;
+    OP_REQUIRES_OK(context, context->GetAttr("align_corners", &align_corners_));
+    OP_REQUIRES_OK(
+        context, context->GetAttr("half_pixel_centers", &half_pixel_centers_));
+    OP_REQUIRES(context, !half_pixel_centers_ || !align_corners_,
+                absl::InvalidArgumentError("If half_pixel_centers is True, "
+                                           "align_corners must be False."));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    tsl::profiler::TraceMe trace_me("DecodeAndResizeJpegOp");
+
+    const Tensor& contents = context->input(0);
+    OP_REQUIRES(context, TensorShapeUtils::IsScalar(contents.shape()),
+                absl::InvalidArgumentError(
+                    absl::StrCat("`contents` must be scalar but got shape",
+                                 contents.shape().DebugString())));
+    const absl::string_view input = contents.scalar<tstring>()();
+    OP_REQUIRES(context, input.size() <= std::numeric_limits<int>::max(),
+                absl::InvalidArgumentError(absl::StrCat(
+                    "Input contents are too large for int: ", input.size())));
+    OP_REQUIRES(context, absl::StartsWith(input, kJpegMagicBytes),
+                absl::InvalidArgumentError(
+                    "_DecodeAndResizeJpeg can decode JPEG images only."));
+
+    const Tensor& crop_window = context->input(1);
+    OP_REQUIRES(context,
+                TensorShapeUtils::IsVector(crop_window.shape()) &&
+                    (crop_window.NumElements() == 0 ||
+                     crop_window.NumElements() == 4),
+                absl::InvalidArgumentError(absl::StrCat(
+                    "crop_window must be empty or have four elements, got "
+                    "shape ",
+                    crop_window.shape().DebugString())));
+
+    const Tensor& size = context->input(2);
+    OP_REQUIRES(context,
+                TensorShapeUtils::IsVector(size.shape()) &&
+                    size.NumElements() == 2,
+                absl::InvalidArgumentError(absl::StrCat(
+                    "shape_t must be 1-dimensional and have 2 elements ",
+                    size.shape().DebugString())));
+    auto size_vec = size.vec<int32_t>();
+    const int64_t out_height = internal::SubtleMustCopy(size_vec(0));
+    const int64_t out_width = internal::SubtleMustCopy(size_vec(1));
+    OP_REQUIRES(
+        context, out_height > 0 && out_width > 0,
+        absl::InvalidArgumentError("output dimensions must be positive"));
+
+    int height = 0;
+    int width = 0;
+    OP_REQUIRES(context,
+                jpeg::GetImageInfo(input.data(), input.size(), &width, &height,
+                                   /*components=*/nullptr),
+                absl::InvalidArgumentError("Invalid JPEG data."));
+
+    int64_t crop_y = 0;
+    int64_t crop_x = 0;
+    int64_t crop_height = height;
+    int64_t crop_width = width;
+    const bool crop = crop_window.NumElements() == 4;
+    if (crop) {
+      auto crop_window_vec = crop_window.vec<int32_t>();
+      crop_y = crop_window_vec(0);
+      crop_x = crop_window_vec(1);
+      crop_height = crop_window_vec(2);
+      crop_width = crop_window_vec(3);
+      OP_REQUIRES(context,
+                  crop_y >= 0 && crop_x >= 0 && crop_height > 0 &&
+                      crop_width > 0 && crop_y + crop_height <= height &&
+                      crop_x + crop_width <= width,
+                  absl::InvalidArgumentError(absl::StrCat(
+                      "Invalid crop window: y=", crop_y, ", x=", crop_x,
+                      ", h=", crop_height, ", w=", crop_width,
+                      " for image_height: ", height,
+                      " and image_width: ", width)));
+    }
+
+    // Use local copy of flags to avoid race condition as the class member is
+    // shared among different invocations.
+    jpeg::UncompressFlags flags = flags_;
+    for (const int ratio : kRatios) {
+      if (crop_height >= out_height * ratio &&
+          crop_width >= out_width * ratio &&
+          IsAligned(crop_y, crop_y + crop_height, height, ratio) &&
+          IsAligned(crop_x, crop_x + crop_width, width, ratio)) {
+        flags.ratio = ratio;
+        break;
+      }
+    }
+    if (crop) {
+      flags.crop = true;
+      flags.crop_y = crop_y / flags.ratio;
+      flags.crop_x = crop_x / flags.ratio;
+      flags.crop_height =
+          ScaledSize(crop_y + crop_height, flags.ratio) - flags.crop_y;
+      flags.crop_width =
+          ScaledSize(crop_x + crop_width, flags.ratio) - flags.crop_x;
+    }
+
+    Tensor image;
+    uint8_t* buffer = jpeg::Uncompress(
+        input.data(), input.size(), flags, nullptr /* nwarn */,
+        [&](int width, int height, int channels) -> uint8_t* {
+          absl::Status status = context->allocate_temp(
+              DT_UINT8, TensorShape({1, height, width, channels}), &image);
+          if (!status.ok()) {
+            VLOG(1) << status;
+            context->SetStatus(status);
+            return nullptr;
+          }
+          return image.flat<uint8_t>().data();
+        });
+    OP_REQUIRES(
+        context, buffer,
+        absl::InvalidArgumentError(
+            "jpeg::Uncompress failed. Invalid JPEG data or crop window."));
+
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(
+        context,
+        context->allocate_output(
+            0, TensorShape({1, out_height, out_width, image.dim_size(3)}),
+            &output));
+    const Tensor& decoded_image = image;
+    functor::ResizeBilinear<CPUDevice, uint8_t>()(
+        context->eigen_device<CPUDevice>(),
+        decoded_image.tensor<uint8_t, 4>(),
+        CalculateResizeScale(image.dim_size(1), out_height, align_corners_),
+        CalculateResizeScale(image.dim_size(2), out_width, align_corners_),
+        half_pixel_centers_, output->tensor<float, 4>());
+  }
+
+ private:
+  int channels_;
+  jpeg::UncompressFlags flags_;
+  bool align_corners_;
+  bool half_pixel_centers_;
+};
+
+REGISTER_KERNEL_BUILDER(Name("_DecodeAndResizeJpeg").Device(DEVICE_CPU),
+                        DecodeAndResizeJpegOp);
+
+}  // namespace
+}  // namespace tensorflow
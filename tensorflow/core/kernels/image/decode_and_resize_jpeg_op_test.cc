@@ -0,0 +1,225 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/jpeg/jpeg_mem.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/status_matchers.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/tstring.h"
+
+namespace tensorflow {
+namespace {
+
+constexpr int kImageSize = 256;
+constexpr int kChannels = 3;
+
+// A smooth RGB image, which JPEG compresses almost losslessly.
+tstring SmoothJpeg() {
+  std::vector<uint8_t> pixels(kImageSize * kImageSize * kChannels);
+  for (int y = 0; y < kImageSize; ++y) {
+    for (int x = 0; x < kImageSize; ++x) {
+      uint8_t* pixel = &pixels[(y * kImageSize + x) * kChannels];
+      pixel[0] = x;
+      pixel[1] = y;
+      pixel[2] = (x + y) / 2;
+    }
+  }
+  jpeg::CompressFlags flags;
+  flags.format = jpeg::FORMAT_RGB;
+  flags.quality = 95;
+  return jpeg::Compress(pixels.data(), kImageSize, kImageSize, flags);
+}
+
+// Decodes `jpeg` at full size as DecodeJpeg does, crops it to the window
+// (`crop_y`, `crop_x`, `crop_height`, `crop_width`) and resizes it to
+// `out_height` x `out_width` with half-pixel centered bilinear
+// interpolation, as ResizeBilinear does.
+std::vector<float> DecodeCropAndResize(const tstring& jpeg, int crop_y,
+                                       int crop_x, int crop_height,
+                                       int crop_width, int out_height,
+                                       int out_width) {
+  jpeg::UncompressFlags flags;
+  flags.components = kChannels;
+  flags.dct_method = JDCT_IFAST;
+  int width = 0;
+  int height = 0;
+  int components = 0;
+  std::unique_ptr<uint8_t[]> image(
+      jpeg::Uncompress(jpeg.data(), jpeg.size(), flags, &width, &height,
+                       &components, /*nwarn=*/nullptr));
+  CHECK(image != nullptr);
+  auto pixel = [&](int y, int x, int c) -> float {
+    return image[((crop_y + y) * width + crop_x + x) * kChannels + c];
+  };
+  auto interpolate = [](int out, int in_size, int out_size, int* lower,
+                        int* upper, float* lerp) {
+    const float scale = static_cast<float>(in_size) / out_size;
+    const float in = (out + 0.5f) * scale - 0.5f;
+    const float in_f = std::floor(in);
+    *lower = std::max(static_cast<int>(in_f), 0);
+    *upper = std::min(static_cast<int>(std::ceil(in)), in_size - 1);
+    *lerp = in - in_f;
+  };
+
+  std::vector<float> resized(out_height * out_width * kChannels);
+  for (int y = 0; y < out_height; ++y) {
+    int top, bottom;
+    float y_lerp;
+    interpolate(y, crop_height, out_height, &top, &bottom, &y_lerp);
+    for (int x = 0; x < out_width; ++x) {
+      int left, right;
+      float x_lerp;
+      interpolate(x, crop_width, out_width, &left, &right, &x_lerp);
+      for (int c = 0; c < kChannels; ++c) {
+        const float top_value =
+            pixel(top, left, c) +
+            (pixel(top, right, c) - pixel(top, left, c)) * x_lerp;
+        const float bottom_value =
+            pixel(bottom, left, c) +
+            (pixel(bottom, right, c) - pixel(bottom, left, c)) * x_lerp;
+        resized[(y * out_width + x) * kChannels + c] =
+            top_value + (bottom_value - top_value) * y_lerp;
+      }
+    }
+  }
+  return resized;
+}
+
+class DecodeAndResizeJpegOpTest : public OpsTestBase {
+ protected:
+  void MakeOp() {
+    TF_ASSERT_OK(NodeDefBuilder("decode_and_resize_op", "_DecodeAndResizeJpeg")
+                     .Input(FakeInput(DT_STRING))
+                     .Input(FakeInput(DT_INT32))
+                     .Input(FakeInput(DT_INT32))
+                     .Attr("channels", kChannels)
+                     .Attr("half_pixel_centers", true)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+
+  // Runs the op and returns the mean absolute difference of its output from
+  // `expected`.
+  float MeanAbsoluteDifference(const tstring& jpeg,
+                               const std::vector<int32_t>& crop_window,
+                               int out_height, int out_width,
+                               const std::vector<float>& expected) {
+    AddInputFromArray<tstring>(TensorShape({}), {jpeg});
+    AddInputFromArray<int32_t>(
+        TensorShape({static_cast<int64_t>(crop_window.size())}), crop_window);
+    AddInputFromArray<int32_t>(TensorShape({2}), {out_height, out_width});
+    TF_EXPECT_OK(RunOpKernel());
+    const Tensor& output = *GetOutput(0);
+    EXPECT_EQ(output.shape(),
+              TensorShape({1, out_height, out_width, kChannels}));
+    auto output_flat = output.flat<float>();
+    float sum = 0;
+    for (int64_t i = 0; i < output_flat.size(); ++i) {
+      sum += std::abs(output_flat(i) - expected[i]);
+    }
+    return sum / output_flat.size();
+  }
+};
+
+TEST_F(DecodeAndResizeJpegOpTest, MatchesDecodeAndResizeWithoutDownscaling) {
+  MakeOp();
+  const tstring jpeg = SmoothJpeg();
+  // The output is larger than half the image, so the image is decoded at full
+  // size.
+  std::vector<float> expected =
+      DecodeCropAndResize(jpeg, 0, 0, kImageSize, kImageSize, 200, 150);
+  EXPECT_LT(MeanAbsoluteDifference(jpeg, {}, 200, 150, expected), 1e-3);
+}
+
+TEST_F(DecodeAndResizeJpegOpTest, DownscalesInDctDomain) {
+  MakeOp();
+  const tstring jpeg = SmoothJpeg();
+  // Decoded at 1/8, 1/4 and 1/2 scale respectively.
+  for (const int out_size : {32, 40, 100}) {
+    std::vector<float> expected = DecodeCropAndResize(
+        jpeg, 0, 0, kImageSize, kImageSize, out_size, out_size);
+    EXPECT_LT(MeanAbsoluteDifference(jpeg, {}, out_size, out_size, expected),
+              2.0)
+        << "out_size: " << out_size;
+    inputs_.clear();
+  }
+}
+
+TEST_F(DecodeAndResizeJpegOpTest, CropsBeforeResizing) {
+  MakeOp();
+  const tstring jpeg = SmoothJpeg();
+  // Decoded at 1/8 scale, and at 1/4 scale since the second crop window is not
+  // aligned to the pixels of the image decoded at 1/8 scale.
+  for (const std::vector<int32_t>& crop_window :
+       {std::vector<int32_t>{16, 32, 128, 96},
+        std::vector<int32_t>{20, 36, 128, 96}}) {
+    std::vector<float> expected =
+        DecodeCropAndResize(jpeg, crop_window[0], crop_window[1],
+                            crop_window[2], crop_window[3], 16, 12);
+    EXPECT_LT(MeanAbsoluteDifference(jpeg, crop_window, 16, 12, expected), 2.0)
+        << "crop_window: " << crop_window[0] << ", " << crop_window[1];
+    inputs_.clear();
+  }
+}
+
+TEST_F(DecodeAndResizeJpegOpTest, InvalidCropWindow) {
+  MakeOp();
+  AddInputFromArray<tstring>(TensorShape({}), {SmoothJpeg()});
+  AddInputFromArray<int32_t>(TensorShape({4}), {200, 0, 100, 100});
+  AddInputFromArray<int32_t>(TensorShape({2}), {10, 10});
+  EXPECT_THAT(RunOpKernel(),
+              absl_testing::StatusIs(absl::StatusCode::kInvalidArgument,
+                                     ::testing::HasSubstr("crop window")));
+}
+
+TEST_F(DecodeAndResizeJpegOpTest, NonJpegContents) {
+  MakeOp();
+  AddInputFromArray<tstring>(TensorShape({}), {"\x89PNG\r\n\x1a\n"});
+  AddInputFromArray<int32_t>(TensorShape({0}), {});
+  AddInputFromArray<int32_t>(TensorShape({2}), {10, 10});
+  EXPECT_THAT(RunOpKernel(),
+              absl_testing::StatusIs(absl::StatusCode::kInvalidArgument,
+                                     ::testing::HasSubstr("JPEG images only")));
+}
+
+TEST_F(DecodeAndResizeJpegOpTest, AlignCornersWithHalfPixelCenters) {
+  TF_ASSERT_OK(NodeDefBuilder("decode_and_resize_op", "_DecodeAndResizeJpeg")
+                   .Input(FakeInput(DT_STRING))
+                   .Input(FakeInput(DT_INT32))
+                   .Input(FakeInput(DT_INT32))
+                   .Attr("align_corners", true)
+                   .Attr("half_pixel_centers", true)
+                   .Finalize(node_def()));
+  EXPECT_THAT(InitOp(), absl_testing::StatusIs(
+                            absl::StatusCode::kInvalidArgument,
+                            ::testing::HasSubstr("align_corners must be")));
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -22,11 +22,28 @@ limitations under the License.
 
 #include "tensorflow/core/kernels/image/resize_bilinear_op.h"
 
-#ifdef __SSE4_1__
-#include <xmmintrin.h>
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define RESIZE_BILINEAR_USE_NEON
+#include <arm_neon.h>
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#ifdef __AVX2__
+#define RESIZE_BILINEAR_USE_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+#if defined(RESIZE_BILINEAR_USE_NEON) || defined(__SSE4_1__)
+#define RESIZE_BILINEAR_USE_VECTORS
 #endif
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <memory>
+#include <type_traits>
+#include <vector>
 
 #include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
 #include "tensorflow/core/framework/op_kernel.h"
@@ -117,20 +134,6 @@ inline float compute_lerp(const float top_left, const float top_right,
   return top + (bottom - top) * y_lerp;
 }
 
-#ifdef __SSE4_1__
-/* Vector version of the above */
-inline __m128 compute_lerp_v(const __m128 top_left, const __m128 top_right,
-                             const __m128 bottom_left,
-                             const __m128 bottom_right, const __m128 x_lerp,
-                             const __m128 y_lerp) {
-  const __m128 top =
-      _mm_add_ps(top_left, _mm_mul_ps(_mm_sub_ps(top_right, top_left), x_lerp));
-  const __m128 bottom = _mm_add_ps(
-      bottom_left, _mm_mul_ps(_mm_sub_ps(bottom_right, bottom_left), x_lerp));
-  return _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(bottom, top), y_lerp));
-}
-#endif
-
 template <typename T>
 void ResizeLineChannels(const T* const ys_input_lower_ptr,
                         const T* const ys_input_upper_ptr,
@@ -154,63 +157,409 @@ void ResizeLineChannels(const T* const ys_input_lower_ptr,
   }
 }
 
-#ifdef __SSE4_1__
+#ifdef RESIZE_BILINEAR_USE_VECTORS
+
+#ifdef RESIZE_BILINEAR_USE_NEON
+typedef float32x4_t Float4;
+
+inline Float4 set1_v(const float value) { return vdupq_n_f32(value); }
+
+// Returns the vector {v0, v1, v2, v3}.
+inline Float4 set_4xfloat_v(const float v0, const float v1, const float v2,
+                            const float v3) {
+  const float values[4] = {v0, v1, v2, v3};
+  return vld1q_f32(values);
+}
+
+inline void store_v(float* out, const Float4 value) { vst1q_f32(out, value); }
+
+/* Vector version of compute_lerp */
+inline Float4 compute_lerp_v(const Float4 top_left, const Float4 top_right,
+                             const Float4 bottom_left,
+                             const Float4 bottom_right, const Float4 x_lerp,
+                             const Float4 y_lerp) {
+  const Float4 top =
+      vaddq_f32(top_left, vmulq_f32(vsubq_f32(top_right, top_left), x_lerp));
+  const Float4 bottom = vaddq_f32(
+      bottom_left, vmulq_f32(vsubq_f32(bottom_right, bottom_left), x_lerp));
+  return vaddq_f32(top, vmulq_f32(vsubq_f32(bottom, top), y_lerp));
+}
+#else
+typedef __m128 Float4;
 
-// Load 3 floats from the given buffer, which must be of size at least 4.
+inline Float4 set1_v(const float value) { return _mm_set1_ps(value); }
+
+// Returns the vector {v0, v1, v2, v3}.
+inline Float4 set_4xfloat_v(const float v0, const float v1, const float v2,
+                            const float v3) {
+  return _mm_set_ps(v3, v2, v1, v0);
+}
+
+inline void store_v(float* out, const Float4 value) {
+  _mm_storeu_ps(out, value);
+}
+
+/* Vector version of compute_lerp */
+inline Float4 compute_lerp_v(const Float4 top_left, const Float4 top_right,
+                             const Float4 bottom_left,
+                             const Float4 bottom_right, const Float4 x_lerp,
+                             const Float4 y_lerp) {
+  const Float4 top =
+      _mm_add_ps(top_left, _mm_mul_ps(_mm_sub_ps(top_right, top_left), x_lerp));
+  const Float4 bottom = _mm_add_ps(
+      bottom_left, _mm_mul_ps(_mm_sub_ps(bottom_right, bottom_left), x_lerp));
+  return _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(bottom, top), y_lerp));
+}
+#endif  // RESIZE_BILINEAR_USE_NEON
+
+// Load 4 values from the given buffer as floats.
 template <typename T>
-inline __m128 load_3xfloat_v(T* values) {
-  return _mm_set_ps(0.0f, static_cast<float>(values[2]),
-                    static_cast<float>(values[1]),
-                    static_cast<float>(values[0]));
+inline Float4 load_4xfloat_v(const T* values) {
+  return set_4xfloat_v(
+      static_cast<float>(values[0]), static_cast<float>(values[1]),
+      static_cast<float>(values[2]), static_cast<float>(values[3]));
 }
 
 // Specialize cases that can be done more efficiently.
+#ifdef RESIZE_BILINEAR_USE_NEON
+template <>
+inline Float4 load_4xfloat_v(const float* values) {
+  return vld1q_f32(values);
+}
+
+template <>
+inline Float4 load_4xfloat_v(const uint8* values) {
+  uint32_t packed;
+  std::memcpy(&packed, values, sizeof(packed));
+  const uint16x8_t widened = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(packed)));
+  return vcvtq_f32_u32(vmovl_u16(vget_low_u16(widened)));
+}
+
+template <>
+inline Float4 load_4xfloat_v(const int8* values) {
+  uint32_t packed;
+  std::memcpy(&packed, values, sizeof(packed));
+  const int16x8_t widened = vmovl_s8(vreinterpret_s8_u32(vdup_n_u32(packed)));
+  return vcvtq_f32_s32(vmovl_s16(vget_low_s16(widened)));
+}
+
+template <>
+inline Float4 load_4xfloat_v(const uint16* values) {
+  return vcvtq_f32_u32(vmovl_u16(vld1_u16(values)));
+}
+
+template <>
+inline Float4 load_4xfloat_v(const int16* values) {
+  return vcvtq_f32_s32(vmovl_s16(vld1_s16(values)));
+}
+
+template <>
+inline Float4 load_4xfloat_v(const int32* values) {
+  return vcvtq_f32_s32(vld1q_s32(values));
+}
+#else
 template <>
-inline __m128 load_3xfloat_v(float* values) {
+inline Float4 load_4xfloat_v(const float* values) {
   return _mm_loadu_ps(values);
 }
 
+template <>
+inline Float4 load_4xfloat_v(const uint8* values) {
+  int32_t packed;
+  std::memcpy(&packed, values, sizeof(packed));
+  return _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed)));
+}
+
+template <>
+inline Float4 load_4xfloat_v(const int8* values) {
+  int32_t packed;
+  std::memcpy(&packed, values, sizeof(packed));
+  return _mm_cvtepi32_ps(_mm_cvtepi8_epi32(_mm_cvtsi32_si128(packed)));
+}
+
+template <>
+inline Float4 load_4xfloat_v(const uint16* values) {
+  return _mm_cvtepi32_ps(_mm_cvtepu16_epi32(
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(values))));
+}
+
+template <>
+inline Float4 load_4xfloat_v(const int16* values) {
+  return _mm_cvtepi32_ps(_mm_cvtepi16_epi32(
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(values))));
+}
+
+template <>
+inline Float4 load_4xfloat_v(const int32* values) {
+  return _mm_cvtepi32_ps(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(values)));
+}
+#endif  // RESIZE_BILINEAR_USE_NEON
+
+// Load the values at the 4 given indices of the buffer as floats.
+template <typename T>
+inline Float4 gather_4xfloat_v(const T* values, const int32_t* indices) {
+  return set_4xfloat_v(static_cast<float>(values[indices[0]]),
+                       static_cast<float>(values[indices[1]]),
+                       static_cast<float>(values[indices[2]]),
+                       static_cast<float>(values[indices[3]]));
+}
+
+#ifdef RESIZE_BILINEAR_USE_AVX2
+/* 8-wide version of compute_lerp_v */
+inline __m256 compute_lerp_v8(const __m256 top_left, const __m256 top_right,
+                              const __m256 bottom_left,
+                              const __m256 bottom_right, const __m256 x_lerp,
+                              const __m256 y_lerp) {
+  const __m256 top = _mm256_add_ps(
+      top_left, _mm256_mul_ps(_mm256_sub_ps(top_right, top_left), x_lerp));
+  const __m256 bottom = _mm256_add_ps(
+      bottom_left,
+      _mm256_mul_ps(_mm256_sub_ps(bottom_right, bottom_left), x_lerp));
+  return _mm256_add_ps(top, _mm256_mul_ps(_mm256_sub_ps(bottom, top), y_lerp));
+}
+
+// Load 4 values from each of the given buffers as floats, those of `low` in
+// the low half of the result.
+template <typename T>
+inline __m256 load_2x4xfloat_v(const T* low, const T* high) {
+  return _mm256_set_m128(load_4xfloat_v(high), load_4xfloat_v(low));
+}
+
+template <>
+inline __m256 load_2x4xfloat_v(const uint8* low, const uint8* high) {
+  int32_t packed_low, packed_high;
+  std::memcpy(&packed_low, low, sizeof(packed_low));
+  std::memcpy(&packed_high, high, sizeof(packed_high));
+  return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(
+      _mm_unpacklo_epi32(_mm_cvtsi32_si128(packed_low),
+                         _mm_cvtsi32_si128(packed_high))));
+}
+
+// Load the values at the 8 given indices of the buffer as floats.
+template <typename T>
+inline __m256 gather_8xfloat_v(const T* values, const int32_t* indices) {
+  return _mm256_set_m128(gather_4xfloat_v(values, indices + 4),
+                         gather_4xfloat_v(values, indices));
+}
+
+// Specialize cases that can use gather instructions. The integer types
+// narrower than 32 bits gather 32-bit words and keep their first value, so
+// they read gather_overread<T>() values past each index.
+inline __m256i load_8xint32_v(const int32_t* values) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values));
+}
+
+template <>
+inline __m256 gather_8xfloat_v(const float* values, const int32_t* indices) {
+  return _mm256_i32gather_ps(values, load_8xint32_v(indices), 4);
+}
+
+template <>
+inline __m256 gather_8xfloat_v(const int32* values, const int32_t* indices) {
+  return _mm256_cvtepi32_ps(_mm256_i32gather_epi32(
+      reinterpret_cast<const int*>(values), load_8xint32_v(indices), 4));
+}
+
+template <>
+inline __m256 gather_8xfloat_v(const uint8* values, const int32_t* indices) {
+  const __m256i words = _mm256_i32gather_epi32(
+      reinterpret_cast<const int*>(values), load_8xint32_v(indices), 1);
+  return _mm256_cvtepi32_ps(_mm256_and_si256(words, _mm256_set1_epi32(0xff)));
+}
+
+template <>
+inline __m256 gather_8xfloat_v(const int8* values, const int32_t* indices) {
+  const __m256i words = _mm256_i32gather_epi32(
+      reinterpret_cast<const int*>(values), load_8xint32_v(indices), 1);
+  return _mm256_cvtepi32_ps(
+      _mm256_srai_epi32(_mm256_slli_epi32(words, 24), 24));
+}
+
+template <>
+inline __m256 gather_8xfloat_v(const uint16* values, const int32_t* indices) {
+  const __m256i words = _mm256_i32gather_epi32(
+      reinterpret_cast<const int*>(values), load_8xint32_v(indices), 2);
+  return _mm256_cvtepi32_ps(
+      _mm256_and_si256(words, _mm256_set1_epi32(0xffff)));
+}
+
+template <>
+inline __m256 gather_8xfloat_v(const int16* values, const int32_t* indices) {
+  const __m256i words = _mm256_i32gather_epi32(
+      reinterpret_cast<const int*>(values), load_8xint32_v(indices), 2);
+  return _mm256_cvtepi32_ps(
+      _mm256_srai_epi32(_mm256_slli_epi32(words, 16), 16));
+}
+#endif  // RESIZE_BILINEAR_USE_AVX2
+
+// The number of values past each index that the gathers of 1-channel rows
+// read.
 template <typename T>
-void ResizeLine3ChannelsVector(const T* const ys_input_lower_ptr,
-                               const T* const ys_input_upper_ptr,
-                               const CachedInterpolation* const xs,
-                               const float ys_lerp, const int64_t out_width,
-                               float* out_y) {
-  const __m128 ys_lerp_v = _mm_set1_ps(ys_lerp);
-  // All pixels but the last one can overflow, vectorize the inside of the
-  // row.
+constexpr int64_t gather_overread() {
+#ifdef RESIZE_BILINEAR_USE_AVX2
+  if (std::is_same<T, uint8>::value || std::is_same<T, int8>::value) return 3;
+  if (std::is_same<T, uint16>::value || std::is_same<T, int16>::value) {
+    return 1;
+  }
+#endif
+  return 0;
+}
+
+// Resizes the first `vector_width` pixels of the row with one vector per
+// pixel, or per two pixels with AVX2, and the rest of the row with
+// ResizeLineChannels. The vectors load and store 4 values per pixel, so the
+// vectorized pixels must be followed by at least 4 - kChannels values in the
+// input and output rows.
+template <int kChannels, typename T>
+void ResizeLineChannelsVector(const T* const ys_input_lower_ptr,
+                              const T* const ys_input_upper_ptr,
+                              const CachedInterpolation* const xs,
+                              const float ys_lerp, const int64_t out_width,
+                              const int64_t vector_width, float* out_y) {
+  static_assert(kChannels == 3 || kChannels == 4,
+                "Only 3 and 4 channels are vectorized per pixel.");
   int64_t x = 0;
-  for (x = 0; x < out_width - 1; ++x) {
+#ifdef RESIZE_BILINEAR_USE_AVX2
+  const __m256 ys_lerp_v8 = _mm256_set1_ps(ys_lerp);
+  for (; x + 1 < vector_width; x += 2) {
+    const CachedInterpolation& xs0 = xs[x];
+    const CachedInterpolation& xs1 = xs[x + 1];
+    const __m256 xs_lerp_v8 =
+        _mm256_set_m128(set1_v(xs1.lerp), set1_v(xs0.lerp));
+
+    const __m256 top_left_v = load_2x4xfloat_v(ys_input_lower_ptr + xs0.lower,
+                                               ys_input_lower_ptr + xs1.lower);
+    const __m256 top_right_v = load_2x4xfloat_v(
+        ys_input_lower_ptr + xs0.upper, ys_input_lower_ptr + xs1.upper);
+    const __m256 bottom_left_v = load_2x4xfloat_v(
+        ys_input_upper_ptr + xs0.lower, ys_input_upper_ptr + xs1.lower);
+    const __m256 bottom_right_v = load_2x4xfloat_v(
+        ys_input_upper_ptr + xs0.upper, ys_input_upper_ptr + xs1.upper);
+
+    const __m256 result =
+        compute_lerp_v8(top_left_v, top_right_v, bottom_left_v,
+                        bottom_right_v, xs_lerp_v8, ys_lerp_v8);
+    if (kChannels == 4) {
+      _mm256_storeu_ps(out_y + x * kChannels, result);
+    } else {
+      // The second pixel overwrites the 4th value stored for the first one.
+      store_v(out_y + x * kChannels, _mm256_castps256_ps128(result));
+      store_v(out_y + (x + 1) * kChannels, _mm256_extractf128_ps(result, 1));
+    }
+  }
+#endif
+  const Float4 ys_lerp_v = set1_v(ys_lerp);
+  for (; x < vector_width; ++x) {
     const int64_t xs_lower = xs[x].lower;
     const int64_t xs_upper = xs[x].upper;
-    const __m128 xs_lerp_v = _mm_set1_ps(xs[x].lerp);
+    const Float4 xs_lerp_v = set1_v(xs[x].lerp);
 
-    const __m128 top_left_v = load_3xfloat_v(ys_input_lower_ptr + xs_lower);
-    const __m128 top_right_v = load_3xfloat_v(ys_input_lower_ptr + xs_upper);
-    const __m128 bottom_left_v = load_3xfloat_v(ys_input_upper_ptr + xs_lower);
-    const __m128 bottom_right_v = load_3xfloat_v(ys_input_upper_ptr + xs_upper);
+    const Float4 top_left_v = load_4xfloat_v(ys_input_lower_ptr + xs_lower);
+    const Float4 top_right_v = load_4xfloat_v(ys_input_lower_ptr + xs_upper);
+    const Float4 bottom_left_v = load_4xfloat_v(ys_input_upper_ptr + xs_lower);
+    const Float4 bottom_right_v = load_4xfloat_v(ys_input_upper_ptr + xs_upper);
 
-    _mm_storeu_ps(out_y + x * 3,
-                  compute_lerp_v(top_left_v, top_right_v, bottom_left_v,
-                                 bottom_right_v, xs_lerp_v, ys_lerp_v));
+    store_v(out_y + x * kChannels,
+            compute_lerp_v(top_left_v, top_right_v, bottom_left_v,
+                           bottom_right_v, xs_lerp_v, ys_lerp_v));
   }
-  // The last pixel of each row must be done in a non-vectorized way
-  // because we cannot overflow.
-  ResizeLineChannels(ys_input_lower_ptr, ys_input_upper_ptr, xs + out_width - 1,
-                     ys_lerp, 1, out_y + (out_width - 1) * 3, 3);
+  ResizeLineChannels(ys_input_lower_ptr, ys_input_upper_ptr, xs + vector_width,
+                     ys_lerp, out_width - vector_width,
+                     out_y + vector_width * kChannels, kChannels);
 }
+
+// The interpolation of 1-channel rows, with the indices and weights in
+// separate arrays so that they can be loaded as vectors.
+struct CachedInterpolation1Channel {
+  std::vector<int32_t> lower;
+  std::vector<int32_t> upper;
+  std::vector<float> lerp;
+};
+
+// Resizes the first `vector_width` pixels of a 1-channel row with one vector
+// per 4 pixels, or per 8 pixels with AVX2, and the rest of the row with
+// ResizeLineChannels. The vectorized pixels must be followed by at least
+// gather_overread<T>() values in the input row.
+template <typename T>
+void ResizeLine1ChannelVector(const T* const ys_input_lower_ptr,
+                              const T* const ys_input_upper_ptr,
+                              const CachedInterpolation* const xs,
+                              const CachedInterpolation1Channel& xs_1c,
+                              const float ys_lerp, const int64_t out_width,
+                              const int64_t vector_width, float* out_y) {
+  const int32_t* const xs_lower = xs_1c.lower.data();
+  const int32_t* const xs_upper = xs_1c.upper.data();
+  const float* const xs_lerp = xs_1c.lerp.data();
+  int64_t x = 0;
+#ifdef RESIZE_BILINEAR_USE_AVX2
+  const __m256 ys_lerp_v8 = _mm256_set1_ps(ys_lerp);
+  for (; x + 8 <= vector_width; x += 8) {
+    const __m256 top_left_v =
+        gather_8xfloat_v(ys_input_lower_ptr, xs_lower + x);
+    const __m256 top_right_v =
+        gather_8xfloat_v(ys_input_lower_ptr, xs_upper + x);
+    const __m256 bottom_left_v =
+        gather_8xfloat_v(ys_input_upper_ptr, xs_lower + x);
+    const __m256 bottom_right_v =
+        gather_8xfloat_v(ys_input_upper_ptr, xs_upper + x);
+    const __m256 xs_lerp_v8 = _mm256_loadu_ps(xs_lerp + x);
+    _mm256_storeu_ps(out_y + x,
+                     compute_lerp_v8(top_left_v, top_right_v, bottom_left_v,
+                                     bottom_right_v, xs_lerp_v8, ys_lerp_v8));
+  }
 #endif
+  const Float4 ys_lerp_v = set1_v(ys_lerp);
+  for (; x + 4 <= vector_width; x += 4) {
+    const Float4 top_left_v =
+        gather_4xfloat_v(ys_input_lower_ptr, xs_lower + x);
+    const Float4 top_right_v =
+        gather_4xfloat_v(ys_input_lower_ptr, xs_upper + x);
+    const Float4 bottom_left_v =
+        gather_4xfloat_v(ys_input_upper_ptr, xs_lower + x);
+    const Float4 bottom_right_v =
+        gather_4xfloat_v(ys_input_upper_ptr, xs_upper + x);
+    const Float4 xs_lerp_v = load_4xfloat_v(xs_lerp + x);
+    store_v(out_y + x, compute_lerp_v(top_left_v, top_right_v, bottom_left_v,
+                                      bottom_right_v, xs_lerp_v, ys_lerp_v));
+  }
+  ResizeLineChannels(ys_input_lower_ptr, ys_input_upper_ptr, xs + x, ys_lerp,
+                     out_width - x, out_y + x, /*channels=*/1);
+}
+
+// Returns the number of pixels at the start of each output row which
+// ResizeLineChannelsVector or ResizeLine1ChannelVector can compute without
+// reading past the input row or writing past the output row.
+template <typename T>
+int64_t VectorizableWidth(const std::vector<CachedInterpolation>& xs,
+                          const int64_t in_width, const int64_t out_width,
+                          const int channels) {
+  if (channels == 4) return out_width;
+  // The interpolation indices are non-decreasing. Only the last pixels of the
+  // input row are not followed by enough values in the row.
+  const int64_t end_pixel =
+      channels == 1 ? in_width - gather_overread<T>() : in_width - 1;
+  const int64_t end = end_pixel * channels;
+  const int64_t width =
+      std::partition_point(
+          xs.begin(), xs.begin() + out_width,
+          [end](const CachedInterpolation& x) { return x.upper < end; }) -
+      xs.begin();
+  return channels == 1 ? width : std::min(width, out_width - 1);
+}
+#endif  // RESIZE_BILINEAR_USE_VECTORS
 
 template <typename T>
 void resize_image(
-    typename TTypes<T, 4>::ConstTensor images, const int batch_size,
-    const int64_t in_height, const int64_t in_width, const int64_t out_height,
-    const int64_t out_width, const int channels,
+    const CPUDevice& d, typename TTypes<T, 4>::ConstTensor images,
+    const int batch_size, const int64_t in_height, const int64_t in_width,
+    const int64_t out_height, const int64_t out_width, const int channels,
     const std::vector<CachedInterpolation>& xs,
     const std::vector<CachedInterpolation>& ys,
     typename TTypes<float, 4>::Tensor output) TF_ATTRIBUTE_NOINLINE;
 template <typename T>
-void resize_image(typename TTypes<T, 4>::ConstTensor images,
+void resize_image(const CPUDevice& d,
+                  typename TTypes<T, 4>::ConstTensor images,
                   const int batch_size, const int64_t in_height,
                   const int64_t in_width, const int64_t out_height,
                   const int64_t out_width, const int channels,
@@ -221,41 +570,70 @@ void resize_image(typename TTypes<T, 4>::ConstTensor images,
   const int64_t in_batch_num_values = in_height * in_row_size;
   const int64_t out_row_size = out_width * channels;
 
-  const T* input_b_ptr = images.data();
+  const T* input_ptr = images.data();
   const CachedInterpolation* xs = xs_vec.data();
-
-  if (channels == 3) {
-    float* output_y_ptr = output.data();
-    for (int b = 0; b < batch_size; ++b) {
-      for (int64_t y = 0; y < out_height; ++y) {
-        const T* ys_input_lower_ptr = input_b_ptr + ys[y].lower * in_row_size;
-        const T* ys_input_upper_ptr = input_b_ptr + ys[y].upper * in_row_size;
-#ifdef __SSE4_1__
-        ResizeLine3ChannelsVector(ys_input_lower_ptr, ys_input_upper_ptr, xs,
-                                  ys[y].lerp, out_width, output_y_ptr);
-#else
-        ResizeLineChannels(ys_input_lower_ptr, ys_input_upper_ptr, xs,
-                           ys[y].lerp, out_width, output_y_ptr, 3);
-#endif
-        output_y_ptr += out_row_size;
-      }
-      input_b_ptr += in_batch_num_values;
+  float* output_ptr = output.data();
+#ifdef RESIZE_BILINEAR_USE_VECTORS
+  // 1-channel rows are vectorized across pixels, which needs 32-bit indices.
+  const bool vectorize_1_channel =
+      channels == 1 && in_width <= std::numeric_limits<int32_t>::max();
+  const int64_t vector_width =
+      channels == 3 || channels == 4 || vectorize_1_channel
+          ? VectorizableWidth<T>(xs_vec, in_width, out_width, channels)
+          : 0;
+  CachedInterpolation1Channel xs_1c;
+  if (vectorize_1_channel) {
+    xs_1c.lower.resize(out_width);
+    xs_1c.upper.resize(out_width);
+    xs_1c.lerp.resize(out_width);
+    for (int64_t x = 0; x < out_width; ++x) {
+      xs_1c.lower[x] = static_cast<int32_t>(xs[x].lower);
+      xs_1c.upper[x] = static_cast<int32_t>(xs[x].upper);
+      xs_1c.lerp[x] = xs[x].lerp;
     }
-  } else {
-    float* output_y_ptr = output.data();
-    for (int b = 0; b < batch_size; ++b) {
-      for (int64_t y = 0; y < out_height; ++y) {
-        const T* ys_input_lower_ptr = input_b_ptr + ys[y].lower * in_row_size;
-        const T* ys_input_upper_ptr = input_b_ptr + ys[y].upper * in_row_size;
-
-        ResizeLineChannels(ys_input_lower_ptr, ys_input_upper_ptr, xs,
-                           ys[y].lerp, out_width, output_y_ptr, channels);
+  }
+#endif
 
-        output_y_ptr += out_row_size;
+  // Shard the output rows of all the images.
+  auto resize_rows = [&](int64_t start, int64_t end) {
+    for (int64_t row = start; row < end; ++row) {
+      const int64_t b = row / out_height;
+      const int64_t y = row % out_height;
+      const T* input_b_ptr = input_ptr + b * in_batch_num_values;
+      const T* ys_input_lower_ptr = input_b_ptr + ys[y].lower * in_row_size;
+      const T* ys_input_upper_ptr = input_b_ptr + ys[y].upper * in_row_size;
+      float* output_y_ptr = output_ptr + row * out_row_size;
+#ifdef RESIZE_BILINEAR_USE_VECTORS
+      if (vectorize_1_channel) {
+        ResizeLine1ChannelVector(ys_input_lower_ptr, ys_input_upper_ptr, xs,
+                                 xs_1c, ys[y].lerp, out_width, vector_width,
+                                 output_y_ptr);
+        continue;
+      }
+      if (channels == 3) {
+        ResizeLineChannelsVector<3>(ys_input_lower_ptr, ys_input_upper_ptr, xs,
+                                    ys[y].lerp, out_width, vector_width,
+                                    output_y_ptr);
+        continue;
+      }
+      if (channels == 4) {
+        ResizeLineChannelsVector<4>(ys_input_lower_ptr, ys_input_upper_ptr, xs,
+                                    ys[y].lerp, out_width, vector_width,
+                                    output_y_ptr);
+        continue;
       }
-      input_b_ptr += in_batch_num_values;
+#endif
+      ResizeLineChannels(ys_input_lower_ptr, ys_input_upper_ptr, xs,
+                         ys[y].lerp, out_width, output_y_ptr, channels);
     }
-  }
+  };
+  // Each output value interpolates 4 input values.
+  const Eigen::TensorOpCost cost(
+      4 * out_row_size * sizeof(T), out_row_size * sizeof(float),
+      out_row_size * 3 *
+          (Eigen::TensorOpCost::AddCost<float>() +
+           Eigen::TensorOpCost::MulCost<float>()));
+  d.parallelFor(batch_size * out_height, cost, resize_rows);
 }
 
 // Casts from float16 to T.
@@ -298,7 +676,7 @@ struct ResizeBilinear<CPUDevice, T> {
 
     // Handle no-op resizes efficiently.
     if (out_height == in_height && out_width == in_width) {
-      output = images.template cast<float>();
+      output.device(d) = images.template cast<float>();
       return;
     }
 
@@ -324,7 +702,7 @@ struct ResizeBilinear<CPUDevice, T> {
       xs[i].upper *= channels;
     }
 
-    resize_image<T>(images, batch_size, in_height, in_width, out_height,
+    resize_image<T>(d, images, batch_size, in_height, in_width, out_height,
                     out_width, channels, xs, ys, output);
   }
 };
@@ -460,6 +838,9 @@ struct ResizeBilinearGrad<CPUDevice, T> {
   }
 };
 
+// Used by the _DecodeAndResizeJpeg kernel.
+template struct ResizeBilinear<CPUDevice, uint8>;
+
 }  // namespace functor
 
 #define REGISTER_KERNEL(T)                            \
@@ -40,7 +40,7 @@ class ResizeBilinearOpTestBase
       public ::testing::WithParamInterface<TestDevice> {
  protected:
   explicit ResizeBilinearOpTestBase()
-      : align_corners_(false), half_pixel_centers_(false) {}
+      : align_corners_(false), half_pixel_centers_(false), dtype_(DT_FLOAT) {}
 
   void SetUp() override {
     if (GetParam() == TestDevice::GPU) {
@@ -50,7 +50,7 @@ class ResizeBilinearOpTestBase
     }
 
     TF_EXPECT_OK(NodeDefBuilder("resize_bilinear_op", "ResizeBilinear")
-                     .Input(FakeInput(DT_FLOAT))
+                     .Input(FakeInput(dtype_))
                      .Input(FakeInput(DT_INT32))
                      .Attr("align_corners", align_corners_)
                      .Attr("half_pixel_centers", half_pixel_centers_)
@@ -63,15 +63,24 @@ class ResizeBilinearOpTestBase
 
     CHECK_EQ(shape.dims(), 4) << "All images must have 4 dimensions.";
     bool is_ref = IsRefType(input_types_[inputs_.size()]);
-    Tensor* input = new Tensor(allocator(), DataTypeToEnum<float>::v(), shape);
-    input->flat<float>().setRandom();
+    Tensor* input = new Tensor(allocator(), dtype_, shape);
+    if (dtype_ == DT_UINT8) {
+      input->flat<uint8_t>().setRandom();
+    } else if (dtype_ == DT_INT16) {
+      // Keeps the values about as large as uint8 ones, so that rounding
+      // differences from the baseline stay within the tolerance.
+      input->flat<int16_t>().setRandom();
+      input->flat<int16_t>() =
+          input->flat<int16_t>() / static_cast<int16_t>(128);
+    } else {
+      input->flat<float>().setRandom();
+    }
     tensors_.push_back(input);
     if (is_ref) {
-      CHECK_EQ(RemoveRefType(input_types_[inputs_.size()]),
-               DataTypeToEnum<float>::v());
+      CHECK_EQ(RemoveRefType(input_types_[inputs_.size()]), dtype_);
       inputs_.push_back({&lock_for_refs_, input});
     } else {
-      CHECK_EQ(input_types_[inputs_.size()], DataTypeToEnum<float>::v());
+      CHECK_EQ(input_types_[inputs_.size()], dtype_);
       inputs_.push_back({nullptr, input});
     }
     return input;
@@ -140,10 +149,19 @@ class ResizeBilinearOpTestBase
     AddInputFromArray<int32_t>(TensorShape({2}), {output_width, output_height});
     TF_ASSERT_OK(RunOpKernel());
 
+    Tensor float_input(DT_FLOAT, shape);
+    if (dtype_ == DT_UINT8) {
+      float_input.flat<float>() = input->flat<uint8_t>().cast<float>();
+    } else if (dtype_ == DT_INT16) {
+      float_input.flat<float>() = input->flat<int16_t>().cast<float>();
+    } else {
+      float_input = *input;
+    }
+
     std::unique_ptr<Tensor> expected(new Tensor(
         allocator(), DataTypeToEnum<float>::v(),
         TensorShape({batch_size, output_width, output_height, channels})));
-    ResizeBilinearBaseline(input->tensor<float, 4>(),
+    ResizeBilinearBaseline(float_input.tensor<float, 4>(),
                            expected->tensor<float, 4>());
     test::ExpectClose(*expected, *GetOutput(0), /*atol=*/5e-5);
   }
@@ -165,6 +183,8 @@ class ResizeBilinearOpTestBase
 
   bool align_corners_;
   bool half_pixel_centers_;
+  // The type of the input images.
+  DataType dtype_;
 };
 
 class ResizeBilinearOpTest : public ResizeBilinearOpTestBase {
@@ -194,6 +214,44 @@ TEST_P(ResizeBilinearOpTest, TestResizeRandomDataSeveralInputsSizes4Channels) {
   RunManyRandomTests(4);
 }
 
+class ResizeBilinearUint8OpTest : public ResizeBilinearOpTestBase {
+ public:
+  ResizeBilinearUint8OpTest() { dtype_ = DT_UINT8; }
+};
+
+class ResizeBilinearUint8HalfPixelCentersOpTest
+    : public ResizeBilinearOpTestBase {
+ public:
+  ResizeBilinearUint8HalfPixelCentersOpTest() {
+    dtype_ = DT_UINT8;
+    half_pixel_centers_ = true;
+  }
+};
+
+class ResizeBilinearInt16OpTest : public ResizeBilinearOpTestBase {
+ public:
+  ResizeBilinearInt16OpTest() { dtype_ = DT_INT16; }
+};
+
+TEST_P(ResizeBilinearUint8OpTest, TestResizeRandomDataSeveralInputsSizes) {
+  for (int channels : {1, 3, 4}) {
+    RunManyRandomTests(channels);
+  }
+}
+
+TEST_P(ResizeBilinearUint8HalfPixelCentersOpTest,
+       TestResizeRandomDataSeveralInputsSizes) {
+  for (int channels : {1, 3, 4}) {
+    RunManyRandomTests(channels);
+  }
+}
+
+TEST_P(ResizeBilinearInt16OpTest, TestResizeRandomDataSeveralInputsSizes) {
+  for (int channels : {1, 3, 4}) {
+    RunManyRandomTests(channels);
+  }
+}
+
 TEST_P(ResizeBilinearOpTest, TestBilinear2x2To1x1) {
   // Input:
   //  1, 2
@@ -535,6 +593,15 @@ INSTANTIATE_TEST_SUITE_P(ResizeBilinearHalfPixelCentersOpTestCpu,
 INSTANTIATE_TEST_SUITE_P(ResizeBilinearOpAlignCornersTestCpu,
                          ResizeBilinearOpAlignCornersTest,
                          ::testing::Values(TestDevice::CPU));
+INSTANTIATE_TEST_SUITE_P(ResizeBilinearUint8OpTestCpu,
+                         ResizeBilinearUint8OpTest,
+                         ::testing::Values(TestDevice::CPU));
+INSTANTIATE_TEST_SUITE_P(ResizeBilinearUint8HalfPixelCentersOpTestCpu,
+                         ResizeBilinearUint8HalfPixelCentersOpTest,
+                         ::testing::Values(TestDevice::CPU));
+INSTANTIATE_TEST_SUITE_P(ResizeBilinearInt16OpTestCpu,
+                         ResizeBilinearInt16OpTest,
+                         ::testing::Values(TestDevice::CPU));
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 // Instantiate tests for GPU.
 INSTANTIATE_TEST_SUITE_P(ResizeBilinearOpTestGpu, ResizeBilinearOpTest,
@@ -22,10 +22,14 @@ limitations under the License.
 namespace tensorflow {
 
 static Graph* Resize(const char* algorithm, int batches, int width,
-                     int height) {
+                     int height, DataType dtype = DT_FLOAT, int channels = 3) {
   Graph* g = new Graph(OpRegistry::Global());
-  Tensor in(DT_FLOAT, TensorShape({batches, width, height, 3}));
-  in.flat<float>().setRandom();
+  Tensor in(dtype, TensorShape({batches, width, height, channels}));
+  if (dtype == DT_UINT8) {
+    in.flat<uint8_t>().setRandom();
+  } else {
+    in.flat<float>().setRandom();
+  }
 
   Tensor out_size(DT_INT32, TensorShape({2}));
   auto out_size_flat = out_size.flat<int32_t>();
@@ -54,6 +58,21 @@ static Graph* Resize(const char* algorithm, int batches, int width,
 BM_ResizeDev(cpu, ResizeNearestNeighbor, 10, 499, 499);
 BM_ResizeDev(cpu, ResizeBilinear, 10, 499, 499);
 
+// Augmentation pipelines resize batches of decoded uint8 images.
+#define BM_ResizeBilinearUint8(B, W, H, C)                                 \
+  static void BM_ResizeBilinear_uint8_##B##_##W##_##H##_##C(              \
+      ::testing::benchmark::State& state) {                               \
+    test::Benchmark("cpu", Resize("ResizeBilinear", B, W, H, DT_UINT8, C), \
+                    /*old_benchmark_api*/ false)                          \
+        .Run(state);                                                      \
+    state.SetItemsProcessed(state.iterations() * B * W * H * C);          \
+  }                                                                       \
+  BENCHMARK(BM_ResizeBilinear_uint8_##B##_##W##_##H##_##C)
+
+BM_ResizeBilinearUint8(10, 499, 499, 1);
+BM_ResizeBilinearUint8(10, 499, 499, 3);
+BM_ResizeBilinearUint8(10, 499, 499, 4);
+
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 BM_ResizeDev(gpu, ResizeNearestNeighbor, 10, 499, 499);
 BM_ResizeDev(gpu, ResizeBilinear, 10, 499, 499);
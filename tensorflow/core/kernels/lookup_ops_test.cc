@@ -15,16 +15,25 @@ limitations under the License.
 
 // Tests kernels of lookup ops.
 
+#include <cstdint>
+#include <memory>
+#include <string>
+
 #include "tensorflow/core/framework/fake_input.h"
 #include "tensorflow/core/framework/lookup_interface.h"
 #include "tensorflow/core/framework/node_def_builder.h"
 #include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/shape_inference_testutil.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/kernels/lookup_table_op.h"
 #include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/refcount.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/blocking_counter.h"
 #include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
 
 namespace tensorflow {
 namespace {
@@ -100,5 +109,152 @@ TEST_F(LookupOpsTest, AnonymousHashTable_RefCounting) {
   EXPECT_FALSE(alive);
 }
 
+class MutableHashTableOpsTest : public OpsTestBase {
+ public:
+  // Runs the `op` kernel selected by `label` and returns the table it creates,
+  // with a reference owned by the caller.
+  lookup::LookupInterface* CreateTable(const std::string& op,
+                                       const std::string& label,
+                                       DataType key_dtype,
+                                       DataType value_dtype) {
+    NodeDefBuilder builder("table", op);
+    builder.Attr("key_dtype", key_dtype).Attr("value_dtype", value_dtype);
+    if (op == "AnonymousMutableHashTableOfTensors") {
+      builder.Attr("value_shape", TensorShape({2}));
+    }
+    if (!label.empty()) {
+      builder.Attr("_kernel", label);
+    }
+    TF_CHECK_OK(builder.Finalize(node_def()));
+    TF_CHECK_OK(InitOp());
+    TF_CHECK_OK(RunOpKernel());
+    auto table = GetOutput(0)
+                     ->scalar<ResourceHandle>()()
+                     .GetResource<lookup::LookupInterface>();
+    TF_CHECK_OK(table.status());
+    table.value()->Ref();
+    return table.value();
+  }
+};
+
+TEST_F(MutableHashTableOpsTest, ShardedLabelSelectsShardedTable) {
+  core::ScopedUnref table(CreateTable("AnonymousMutableHashTable", "sharded",
+                                      DT_INT64, DT_FLOAT));
+  EXPECT_NE(dynamic_cast<lookup::ShardedMutableHashTableOfScalars<
+                int64_t, float>*>(table.get()),
+            nullptr);
+}
+
+TEST_F(MutableHashTableOpsTest, ShardedScalars) {
+  core::ScopedUnref table(CreateTable("AnonymousMutableHashTable", "sharded",
+                                      DT_STRING, DT_INT64));
+  lookup::LookupInterface* t = table.get();
+  TF_ASSERT_OK(t->Insert(nullptr,
+                         test::AsTensor<tstring>({"a", "b", "c", "a"}),
+                         test::AsTensor<int64_t>({1, 2, 3, 4})));
+  EXPECT_EQ(t->size(), 3);
+
+  Tensor values(DT_INT64, TensorShape({4}));
+  TF_ASSERT_OK(t->Find(nullptr, test::AsTensor<tstring>({"a", "b", "c", "d"}),
+                       &values, test::AsScalar<int64_t>(-1)));
+  // The last value inserted for a key wins.
+  test::ExpectTensorEqual<int64_t>(values,
+                                   test::AsTensor<int64_t>({4, 2, 3, -1}));
+
+  TF_ASSERT_OK(t->Remove(nullptr, test::AsTensor<tstring>({"b", "d"})));
+  EXPECT_EQ(t->size(), 2);
+  TF_ASSERT_OK(t->Find(nullptr, test::AsTensor<tstring>({"a", "b", "c", "d"}),
+                       &values, test::AsTensor<int64_t>({5, 6, 7, 8})));
+  test::ExpectTensorEqual<int64_t>(values,
+                                   test::AsTensor<int64_t>({4, 6, 3, 8}));
+
+  TF_ASSERT_OK(t->ImportValues(nullptr, test::AsTensor<tstring>({"d", "e"}),
+                               test::AsTensor<int64_t>({10, 11})));
+  EXPECT_EQ(t->size(), 2);
+  TF_ASSERT_OK(t->Find(nullptr, test::AsTensor<tstring>({"a", "b", "d", "e"}),
+                       &values, test::AsScalar<int64_t>(-1)));
+  test::ExpectTensorEqual<int64_t>(values,
+                                   test::AsTensor<int64_t>({-1, -1, 10, 11}));
+}
+
+TEST_F(MutableHashTableOpsTest, ShardedTensors) {
+  core::ScopedUnref table(CreateTable("AnonymousMutableHashTableOfTensors",
+                                      "sharded", DT_INT64, DT_FLOAT));
+  lookup::LookupInterface* t = table.get();
+  EXPECT_EQ(t->value_shape(), TensorShape({2}));
+  TF_ASSERT_OK(t->Insert(
+      nullptr, test::AsTensor<int64_t>({1, 2}),
+      test::AsTensor<float>({1.0, 1.5, 2.0, 2.5}, TensorShape({2, 2}))));
+  EXPECT_EQ(t->size(), 2);
+
+  Tensor values(DT_FLOAT, TensorShape({3, 2}));
+  TF_ASSERT_OK(t->Find(nullptr, test::AsTensor<int64_t>({2, 3, 1}), &values,
+                       test::AsTensor<float>({-1, -2}, TensorShape({1, 2}))));
+  test::ExpectTensorEqual<float>(
+      values, test::AsTensor<float>({2.0, 2.5, -1, -2, 1.0, 1.5},
+                                    TensorShape({3, 2})));
+}
+
+// Looks up batches of keys in a table from `num_threads` threads, inserting
+// one batch for every `kFindsPerInsert` lookups.
+void BM_MutableHashTableConcurrentAccess(::testing::benchmark::State& state) {
+  const bool sharded = state.range(0);
+  const int num_threads = state.range(1);
+  constexpr int kNumKeys = 1 << 20;
+  constexpr int kBatchSize = 256;
+  constexpr int kBatchesPerThread = 512;
+  constexpr int kFindsPerInsert = 8;
+
+  class TableFactory : public MutableHashTableOpsTest {
+    void TestBody() override {}
+  } factory;
+  core::ScopedUnref table(factory.CreateTable(
+      "AnonymousMutableHashTable", sharded ? "sharded" : "", DT_INT64,
+      DT_FLOAT));
+  Tensor all_keys(DT_INT64, TensorShape({kNumKeys}));
+  all_keys.flat<int64_t>().setRandom();
+  Tensor all_values(DT_FLOAT, TensorShape({kNumKeys}));
+  all_values.flat<float>().setRandom();
+  TF_CHECK_OK(table.get()->Insert(nullptr, all_keys, all_values));
+  const Tensor default_value = test::AsScalar<float>(0);
+
+  thread::ThreadPool pool(Env::Default(), "lookup_bench", num_threads);
+  for (auto s : state) {
+    BlockingCounter counter(num_threads);
+    for (int t = 0; t < num_threads; ++t) {
+      pool.Schedule([&, t]() {
+        Tensor values(DT_FLOAT, TensorShape({kBatchSize}));
+        for (int b = 0; b < kBatchesPerThread; ++b) {
+          const int64_t start =
+              ((t * kBatchesPerThread + b) * kBatchSize) % kNumKeys;
+          const Tensor keys = all_keys.Slice(start, start + kBatchSize);
+          if (b % kFindsPerInsert == 0) {
+            TF_CHECK_OK(table.get()->Insert(
+                nullptr, keys, all_values.Slice(start, start + kBatchSize)));
+          } else {
+            TF_CHECK_OK(
+                table.get()->Find(nullptr, keys, &values, default_value));
+          }
+        }
+        counter.DecrementCount();
+      });
+    }
+    counter.Wait();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          num_threads * kBatchesPerThread * kBatchSize);
+}
+
+BENCHMARK(BM_MutableHashTableConcurrentAccess)
+    ->UseRealTime()
+    ->ArgPair(0, 1)
+    ->ArgPair(1, 1)
+    ->ArgPair(0, 4)
+    ->ArgPair(1, 4)
+    ->ArgPair(0, 16)
+    ->ArgPair(1, 16)
+    ->ArgPair(0, 64)
+    ->ArgPair(1, 64);
+
 }  // namespace
 }  // namespace tensorflow
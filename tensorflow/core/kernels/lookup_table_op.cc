@@ -1211,6 +1211,88 @@ REGISTER_KERNEL(tstring, int64_t);
 
 #undef REGISTER_KERNEL
 
+// Register the lock-striped implementations of the MutableHashTable and
+// MutableHashTableOfTensors ops. They are selected by setting the "_kernel"
+// attr of the table node to "sharded", and scale better than the default
+// kernels when many threads look up or insert keys concurrently.
+#define REGISTER_SHARDED_KERNEL(op_name, table_class, key_dtype, value_dtype) \
+  REGISTER_KERNEL_BUILDER(                                                     \
+      Name(op_name)                                                            \
+          .Device(DEVICE_CPU)                                                  \
+          .TypeConstraint<key_dtype>("key_dtype")                              \
+          .TypeConstraint<value_dtype>("value_dtype")                          \
+          .Label("sharded"),                                                   \
+      LookupTableOp<lookup::table_class<key_dtype, value_dtype>, key_dtype,    \
+                    value_dtype>)
+
+#define REGISTER_SHARDED_ANONYMOUS_KERNEL(op_name, table_class, key_dtype,    \
+                                          value_dtype)                         \
+  REGISTER_KERNEL_BUILDER(                                                     \
+      Name(op_name)                                                            \
+          .Device(DEVICE_CPU)                                                  \
+          .TypeConstraint<key_dtype>("key_dtype")                              \
+          .TypeConstraint<value_dtype>("value_dtype")                          \
+          .Label("sharded"),                                                   \
+      AnonymousLookupTableOp<lookup::table_class<key_dtype, value_dtype>,      \
+                             key_dtype, value_dtype>)
+
+#define REGISTER_KERNEL(key_dtype, value_dtype)                               \
+  REGISTER_SHARDED_KERNEL("MutableHashTable",                                 \
+                          ShardedMutableHashTableOfScalars, key_dtype,        \
+                          value_dtype);                                       \
+  REGISTER_SHARDED_KERNEL("MutableHashTableV2",                               \
+                          ShardedMutableHashTableOfScalars, key_dtype,        \
+                          value_dtype);                                       \
+  REGISTER_SHARDED_ANONYMOUS_KERNEL("AnonymousMutableHashTable",              \
+                                    ShardedMutableHashTableOfScalars,         \
+                                    key_dtype, value_dtype)
+
+REGISTER_KERNEL(int32_t, double);
+REGISTER_KERNEL(int32_t, float);
+REGISTER_KERNEL(int32_t, int32_t);
+REGISTER_KERNEL(int64_t, double);
+REGISTER_KERNEL(int64_t, float);
+REGISTER_KERNEL(int64_t, int32_t);
+REGISTER_KERNEL(int64_t, int64_t);
+REGISTER_KERNEL(int64_t, tstring);
+REGISTER_KERNEL(int64_t, Variant);
+REGISTER_KERNEL(tstring, bool);
+REGISTER_KERNEL(tstring, double);
+REGISTER_KERNEL(tstring, float);
+REGISTER_KERNEL(tstring, int32_t);
+REGISTER_KERNEL(tstring, int64_t);
+
+#undef REGISTER_KERNEL
+
+#define REGISTER_KERNEL(key_dtype, value_dtype)                               \
+  REGISTER_SHARDED_KERNEL("MutableHashTableOfTensors",                        \
+                          ShardedMutableHashTableOfTensors, key_dtype,        \
+                          value_dtype);                                       \
+  REGISTER_SHARDED_KERNEL("MutableHashTableOfTensorsV2",                      \
+                          ShardedMutableHashTableOfTensors, key_dtype,        \
+                          value_dtype);                                       \
+  REGISTER_SHARDED_ANONYMOUS_KERNEL("AnonymousMutableHashTableOfTensors",     \
+                                    ShardedMutableHashTableOfTensors,         \
+                                    key_dtype, value_dtype)
+
+REGISTER_KERNEL(int32_t, double);
+REGISTER_KERNEL(int32_t, float);
+REGISTER_KERNEL(int32_t, int32_t);
+REGISTER_KERNEL(int64_t, double);
+REGISTER_KERNEL(int64_t, float);
+REGISTER_KERNEL(int64_t, int32_t);
+REGISTER_KERNEL(int64_t, int64_t);
+REGISTER_KERNEL(int64_t, tstring);
+REGISTER_KERNEL(tstring, bool);
+REGISTER_KERNEL(tstring, double);
+REGISTER_KERNEL(tstring, float);
+REGISTER_KERNEL(tstring, int32_t);
+REGISTER_KERNEL(tstring, int64_t);
+
+#undef REGISTER_KERNEL
+#undef REGISTER_SHARDED_ANONYMOUS_KERNEL
+#undef REGISTER_SHARDED_KERNEL
+
 // Register the MutableDenseHashTable op.
 #define REGISTER_KERNEL(key_dtype, value_dtype)                             \
   REGISTER_KERNEL_BUILDER(                                                  \
@@ -16,7 +16,14 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_LOOKUP_TABLE_OP_H_
 #define TENSORFLOW_CORE_KERNELS_LOOKUP_TABLE_OP_H_
 
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
 #include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
 #include "tensorflow/core/framework/bounds_check.h"
 #include "tensorflow/core/framework/lookup_interface.h"
 #include "tensorflow/core/framework/op_kernel.h"
@@ -27,9 +34,11 @@ limitations under the License.
 #include "tensorflow/core/kernels/lookup_util.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/gtl/map_util.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/thread_annotations.h"
 
 namespace tensorflow {
@@ -345,6 +354,480 @@ class HashTable : public InitializableLookupTable {
   absl::flat_hash_map<K, V> table_;
 };
 
+// A hash map split into kNumShards absl::flat_hash_maps, each guarded by its
+// own reader/writer lock, so that concurrent operations on different keys
+// rarely contend. Batched operations group their keys by shard and take each
+// shard's lock once.
+template <class K, class Value>
+class ShardedHashMap {
+ public:
+  static constexpr int kNumShards = 64;
+  using Map = absl::flat_hash_map<K, Value>;
+
+  size_t size() const {
+    size_t size = 0;
+    for (const Shard& shard : shards_) {
+      tf_shared_lock l(shard.mu);
+      size += shard.map.size();
+    }
+    return size;
+  }
+
+  int64_t MemoryUsed() const {
+    int64_t ret = 0;
+    for (const Shard& shard : shards_) {
+      tf_shared_lock l(shard.mu);
+      ret += shard.map.capacity() * (sizeof(K) + sizeof(Value) + 1);
+    }
+    return ret;
+  }
+
+  // Calls `fn(i, value)` for each i in [0, keys.size()), where `value` points
+  // to the value of keys[i] or is null if the key is absent. The shard of the
+  // key is locked for reading during the call.
+  template <typename Fn>
+  void FindEach(absl::Span<const K> keys, Fn fn) const {
+    VisitByShard(keys, [&](int s, absl::Span<const int64_t> idx) {
+      const Shard& shard = shards_[s];
+      tf_shared_lock l(shard.mu);
+      for (int64_t i : idx) {
+        auto it = shard.map.find(keys[i]);
+        fn(i, it == shard.map.end() ? nullptr : &it->second);
+      }
+    });
+  }
+
+  // Calls `fn(i, map)` for each i in [0, keys.size()), where `map` is the map
+  // of the shard of keys[i], locked for writing during the call. Keys of the
+  // same shard are visited in order.
+  template <typename Fn>
+  void UpdateEach(absl::Span<const K> keys, Fn fn) {
+    VisitByShard(keys, [&](int s, absl::Span<const int64_t> idx) {
+      Shard& shard = shards_[s];
+      mutex_lock l(shard.mu);
+      for (int64_t i : idx) {
+        fn(i, &shard.map);
+      }
+    });
+  }
+
+  // Like UpdateEach(), after clearing the map. Other operations observe
+  // either the old or the new contents.
+  template <typename Fn>
+  void ReplaceEach(absl::Span<const K> keys,
+                   Fn fn) TF_NO_THREAD_SAFETY_ANALYSIS {
+    for (Shard& shard : shards_) {
+      shard.mu.lock();
+      shard.map.clear();
+    }
+    for (int64_t i = 0; i < keys.size(); ++i) {
+      fn(i, &shards_[ShardOf(keys[i])].map);
+    }
+    for (Shard& shard : shards_) {
+      shard.mu.unlock();
+    }
+  }
+
+  // Calls `fn(size, for_each)` with all shards locked for reading, where
+  // `size` is the number of entries and `for_each(visit)` calls
+  // `visit(key, value)` for each entry.
+  template <typename Fn>
+  void Snapshot(Fn fn) const TF_NO_THREAD_SAFETY_ANALYSIS {
+    int64_t size = 0;
+    for (const Shard& shard : shards_) {
+      shard.mu.lock_shared();
+      size += shard.map.size();
+    }
+    fn(size, [this](auto visit) {
+      for (const Shard& shard : shards_) {
+        for (const auto& entry : shard.map) {
+          visit(entry.first, entry.second);
+        }
+      }
+    });
+    for (const Shard& shard : shards_) {
+      shard.mu.unlock_shared();
+    }
+  }
+
+ private:
+  struct Shard {
+    mutable mutex mu;
+    Map map TF_GUARDED_BY(mu);
+  };
+
+  static int ShardOf(const K& key) {
+    // The maps use the low bits of the same hash; shard by the high bits.
+    const uint64_t hash = typename Map::hasher()(key);
+    return (hash * 0x9E3779B97F4A7C15ull) >> 58;
+  }
+  static_assert(kNumShards == 64, "ShardOf() produces 6 bits");
+
+  // Calls `visit(s, indices)` for each shard s that keys map to, with the
+  // indices of those keys in increasing order.
+  template <typename Visit>
+  static void VisitByShard(absl::Span<const K> keys, Visit visit) {
+    if (keys.empty()) {
+      return;
+    }
+    if (keys.size() == 1) {
+      const int64_t index = 0;
+      visit(ShardOf(keys[0]), absl::MakeConstSpan(&index, 1));
+      return;
+    }
+    std::vector<uint8_t> shard_of(keys.size());
+    int64_t offsets[kNumShards + 1] = {0};
+    for (int64_t i = 0; i < keys.size(); ++i) {
+      shard_of[i] = ShardOf(keys[i]);
+      ++offsets[shard_of[i] + 1];
+    }
+    for (int s = 0; s < kNumShards; ++s) {
+      offsets[s + 1] += offsets[s];
+    }
+    std::vector<int64_t> order(keys.size());
+    int64_t next[kNumShards];
+    std::copy(offsets, offsets + kNumShards, next);
+    for (int64_t i = 0; i < keys.size(); ++i) {
+      order[next[shard_of[i]]++] = i;
+    }
+    for (int s = 0; s < kNumShards; ++s) {
+      if (offsets[s + 1] > offsets[s]) {
+        visit(s, absl::MakeConstSpan(order.data() + offsets[s],
+                                     offsets[s + 1] - offsets[s]));
+      }
+    }
+  }
+
+  Shard shards_[kNumShards];
+};
+
+// Returns the keys of "keys" as a span. Keys other than strings are copied into
+// "copy" so that each is read from the tensor exactly once, see
+// SubtleMustCopyIfIntegral().
+template <class K>
+absl::Span<const K> ReadKeysOnce(const Tensor& keys, std::vector<K>* copy) {
+  const auto key_values = keys.flat<K>();
+  if constexpr (std::is_same_v<K, tstring>) {
+    return absl::MakeConstSpan(key_values.data(), key_values.size());
+  } else {
+    copy->assign(key_values.data(), key_values.data() + key_values.size());
+    return *copy;
+  }
+}
+
+// Lookup table with the semantics of MutableHashTableOfScalars, backed by a
+// ShardedHashMap so that Find and Insert calls from many threads scale.
+// Registered for the MutableHashTable ops under the "sharded" kernel label.
+template <class K, class V>
+class ShardedMutableHashTableOfScalars final : public LookupInterface {
+ public:
+  ShardedMutableHashTableOfScalars(OpKernelContext* ctx, OpKernel* kernel) {}
+
+  size_t size() const override { return map_.size(); }
+
+  absl::Status Find(OpKernelContext* ctx, const Tensor& key, Tensor* value,
+                    const Tensor& default_value) override {
+    auto value_values = value->flat<V>();
+    const auto default_flat = default_value.flat<V>();
+    const bool is_full_size_default =
+        (value_values.size() == default_flat.size());
+
+    std::vector<K> keys_copy;
+    map_.FindEach(ReadKeysOnce<K>(key, &keys_copy),
+                  [&](int64_t i, const V* found) {
+                    if (found != nullptr) {
+                      value_values(i) = *found;
+                    } else {
+                      value_values(i) = is_full_size_default ? default_flat(i)
+                                                             : default_flat(0);
+                    }
+                  });
+    return absl::OkStatus();
+  }
+
+  absl::Status Insert(OpKernelContext* ctx, const Tensor& keys,
+                      const Tensor& values) override {
+    std::vector<K> keys_copy;
+    const absl::Span<const K> key_span = ReadKeysOnce<K>(keys, &keys_copy);
+    const auto value_values = values.flat<V>();
+    map_.UpdateEach(key_span, [&](int64_t i, auto* map) {
+      map->insert_or_assign(key_span[i],
+                            SubtleMustCopyIfIntegral(value_values(i)));
+    });
+    return absl::OkStatus();
+  }
+
+  absl::Status Remove(OpKernelContext* ctx, const Tensor& keys) override {
+    std::vector<K> keys_copy;
+    const absl::Span<const K> key_span = ReadKeysOnce<K>(keys, &keys_copy);
+    map_.UpdateEach(key_span,
+                    [&](int64_t i, auto* map) { map->erase(key_span[i]); });
+    return absl::OkStatus();
+  }
+
+  absl::Status ImportValues(OpKernelContext* ctx, const Tensor& keys,
+                            const Tensor& values) override {
+    std::vector<K> keys_copy;
+    const absl::Span<const K> key_span = ReadKeysOnce<K>(keys, &keys_copy);
+    const auto value_values = values.flat<V>();
+    map_.ReplaceEach(key_span, [&](int64_t i, auto* map) {
+      map->insert_or_assign(key_span[i],
+                            SubtleMustCopyIfIntegral(value_values(i)));
+    });
+    return absl::OkStatus();
+  }
+
+  absl::Status ExportValues(OpKernelContext* ctx) override {
+    absl::Status status;
+    map_.Snapshot([&](int64_t size, auto for_each) {
+      Tensor* keys;
+      Tensor* values;
+      status = ctx->allocate_output("keys", TensorShape({size}), &keys);
+      if (status.ok()) {
+        status = ctx->allocate_output("values", TensorShape({size}), &values);
+      }
+      if (status.ok()) {
+        ExportKeysAndValues(for_each, keys, values);
+      }
+    });
+    return status;
+  }
+
+  DataType key_dtype() const override { return DataTypeToEnum<K>::v(); }
+
+  DataType value_dtype() const override { return DataTypeToEnum<V>::v(); }
+
+  TensorShape key_shape() const final { return TensorShape(); }
+
+  TensorShape value_shape() const override { return TensorShape(); }
+
+  int64_t MemoryUsed() const override {
+    return sizeof(ShardedMutableHashTableOfScalars) + map_.MemoryUsed();
+  }
+
+  absl::Status AsGraphDef(GraphDefBuilder* builder, Node** out) const override {
+    Tensor keys;
+    Tensor values;
+    map_.Snapshot([&](int64_t size, auto for_each) {
+      keys = Tensor(key_dtype(), TensorShape({size}));
+      values = Tensor(value_dtype(), TensorShape({size}));
+      ExportKeysAndValues(for_each, &keys, &values);
+    });
+
+    // See MutableHashTableOfScalars::AsGraphDef(). The "_kernel" attr keeps
+    // the sharded implementation when the graph is loaded again.
+    Node* table = ops::SourceOp(
+        "MutableHashTableV2",
+        builder->opts()
+            .WithName(UniqueNodeName("MutableHashTableFromGraphDef"))
+            .WithAttr("use_node_name_sharing", true)
+            .WithAttr("key_dtype", key_dtype())
+            .WithAttr("value_dtype", value_dtype())
+            .WithAttr("_kernel", "sharded"));
+    Node* keys_node = ops::SourceOp(
+        "Const",
+        builder->opts().WithAttr("dtype", key_dtype()).WithAttr("value", keys));
+    Node* values_node =
+        ops::SourceOp("Const", builder->opts()
+                                   .WithAttr("dtype", value_dtype())
+                                   .WithAttr("value", values));
+    Node* import_table =
+        ops::TernaryOp("LookupTableImportV2", table, keys_node, values_node,
+                       builder->opts()
+                           .WithAttr("Tin", key_dtype())
+                           .WithAttr("Tout", value_dtype()));
+    *out = ops::UnaryOp("Identity", table,
+                        builder->opts().WithControlInput(import_table));
+    return absl::OkStatus();
+  }
+
+ private:
+  template <typename ForEach>
+  static void ExportKeysAndValues(ForEach for_each, Tensor* keys,
+                                  Tensor* values) {
+    auto keys_data = keys->flat<K>();
+    auto values_data = values->flat<V>();
+    int64_t i = 0;
+    for_each([&](const K& key, const V& value) {
+      keys_data(i) = key;
+      values_data(i) = value;
+      ++i;
+    });
+  }
+
+  ShardedHashMap<K, V> map_;
+};
+
+// Lookup table with the semantics of MutableHashTableOfTensors, backed by a
+// ShardedHashMap. Registered for the MutableHashTableOfTensors ops under the
+// "sharded" kernel label.
+template <class K, class V>
+class ShardedMutableHashTableOfTensors final : public LookupInterface {
+ public:
+  ShardedMutableHashTableOfTensors(OpKernelContext* ctx, OpKernel* kernel) {
+    OP_REQUIRES_OK(ctx,
+                   GetNodeAttr(kernel->def(), "value_shape", &value_shape_));
+    OP_REQUIRES(ctx, TensorShapeUtils::IsVector(value_shape_),
+                absl::InvalidArgumentError(
+                    absl::StrCat("Default value must be a vector, got shape ",
+                                 value_shape_.DebugString())));
+  }
+
+  size_t size() const override { return map_.size(); }
+
+  absl::Status Find(OpKernelContext* ctx, const Tensor& key, Tensor* value,
+                    const Tensor& default_value) override {
+    const auto default_flat = default_value.flat_inner_dims<V, 2>();
+    auto value_values = value->flat_inner_dims<V, 2>();
+    const int64_t value_dim = value_shape_.dim_size(0);
+    const bool is_full_size_default =
+        (value_values.size() == default_flat.size());
+
+    std::vector<K> keys_copy;
+    map_.FindEach(ReadKeysOnce<K>(key, &keys_copy),
+                  [&](int64_t i, const ValueArray* found) {
+                    for (int64_t j = 0; j < value_dim; j++) {
+                      if (found != nullptr) {
+                        value_values(i, j) = (*found)[j];
+                      } else {
+                        value_values(i, j) = is_full_size_default
+                                                 ? default_flat(i, j)
+                                                 : default_flat(0, j);
+                      }
+                    }
+                  });
+    return absl::OkStatus();
+  }
+
+  absl::Status Insert(OpKernelContext* ctx, const Tensor& keys,
+                      const Tensor& values) override {
+    return DoInsert(/*clear=*/false, keys, values);
+  }
+
+  absl::Status Remove(OpKernelContext* ctx, const Tensor& keys) override {
+    std::vector<K> keys_copy;
+    const absl::Span<const K> key_span = ReadKeysOnce<K>(keys, &keys_copy);
+    map_.UpdateEach(key_span,
+                    [&](int64_t i, auto* map) { map->erase(key_span[i]); });
+    return absl::OkStatus();
+  }
+
+  absl::Status ImportValues(OpKernelContext* ctx, const Tensor& keys,
+                            const Tensor& values) override {
+    return DoInsert(/*clear=*/true, keys, values);
+  }
+
+  absl::Status ExportValues(OpKernelContext* ctx) override {
+    const int64_t value_dim = value_shape_.dim_size(0);
+    absl::Status status;
+    map_.Snapshot([&](int64_t size, auto for_each) {
+      Tensor* keys;
+      Tensor* values;
+      status = ctx->allocate_output("keys", TensorShape({size}), &keys);
+      if (status.ok()) {
+        status = ctx->allocate_output(
+            "values", TensorShape({size, value_dim}), &values);
+      }
+      if (status.ok()) {
+        ExportKeysAndValues(for_each, keys, values);
+      }
+    });
+    return status;
+  }
+
+  DataType key_dtype() const override { return DataTypeToEnum<K>::v(); }
+
+  DataType value_dtype() const override { return DataTypeToEnum<V>::v(); }
+
+  TensorShape key_shape() const final { return TensorShape(); }
+
+  TensorShape value_shape() const override { return value_shape_; }
+
+  int64_t MemoryUsed() const override {
+    return sizeof(ShardedMutableHashTableOfTensors) + map_.MemoryUsed();
+  }
+
+  absl::Status AsGraphDef(GraphDefBuilder* builder, Node** out) const override {
+    Tensor keys;
+    Tensor values;
+    map_.Snapshot([&](int64_t size, auto for_each) {
+      keys = Tensor(key_dtype(), TensorShape({size}));
+      values =
+          Tensor(value_dtype(), TensorShape({size, value_shape_.dim_size(0)}));
+      ExportKeysAndValues(for_each, &keys, &values);
+    });
+
+    // See MutableHashTableOfTensors::AsGraphDef(). The "_kernel" attr keeps
+    // the sharded implementation when the graph is loaded again.
+    Node* table =
+        ops::SourceOp("MutableHashTableOfTensorsV2",
+                      builder->opts()
+                          .WithName(UniqueNodeName("MutableHashTableOfTensors"))
+                          .WithAttr("use_node_name_sharing", true)
+                          .WithAttr("key_dtype", key_dtype())
+                          .WithAttr("value_dtype", value_dtype())
+                          .WithAttr("value_shape", value_shape_)
+                          .WithAttr("_kernel", "sharded"));
+    Node* keys_node = ops::SourceOp(
+        "Const",
+        builder->opts().WithAttr("dtype", key_dtype()).WithAttr("value", keys));
+    Node* values_node =
+        ops::SourceOp("Const", builder->opts()
+                                   .WithAttr("dtype", value_dtype())
+                                   .WithAttr("value", values));
+    Node* import_table =
+        ops::TernaryOp("LookupTableImportV2", table, keys_node, values_node,
+                       builder->opts()
+                           .WithAttr("Tin", key_dtype())
+                           .WithAttr("Tout", value_dtype()));
+    *out = ops::UnaryOp("Identity", table,
+                        builder->opts().WithControlInput(import_table));
+    return absl::OkStatus();
+  }
+
+ private:
+  typedef gtl::InlinedVector<V, 4> ValueArray;
+
+  absl::Status DoInsert(bool clear, const Tensor& keys, const Tensor& values) {
+    std::vector<K> keys_copy;
+    const absl::Span<const K> key_span = ReadKeysOnce<K>(keys, &keys_copy);
+    const auto value_values = values.flat_inner_dims<V, 2>();
+    const int64_t value_dim = value_shape_.dim_size(0);
+    auto insert = [&](int64_t i, auto* map) {
+      ValueArray value_vec;
+      for (int64_t j = 0; j < value_dim; j++) {
+        value_vec.push_back(value_values(i, j));
+      }
+      map->insert_or_assign(key_span[i], std::move(value_vec));
+    };
+    if (clear) {
+      map_.ReplaceEach(key_span, insert);
+    } else {
+      map_.UpdateEach(key_span, insert);
+    }
+    return absl::OkStatus();
+  }
+
+  template <typename ForEach>
+  void ExportKeysAndValues(ForEach for_each, Tensor* keys,
+                           Tensor* values) const {
+    const int64_t value_dim = value_shape_.dim_size(0);
+    auto keys_data = keys->flat<K>();
+    auto values_data = values->matrix<V>();
+    int64_t i = 0;
+    for_each([&](const K& key, const ValueArray& value) {
+      keys_data(i) = key;
+      for (int64_t j = 0; j < value_dim; j++) {
+        values_data(i, j) = value[j];
+      }
+      ++i;
+    });
+  }
+
+  TensorShape value_shape_;
+  ShardedHashMap<K, ValueArray> map_;
+};
+
 }  // namespace lookup
 
 }  // namespace tensorflow
@@ -23,12 +23,14 @@ limitations under the License.
 #include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <string>
 #include <type_traits>
 #include <vector>
 
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "tensorflow/core/framework/op_requires.h"
 #include "tensorflow/core/platform/types.h"
 #define EIGEN_USE_THREADS
@@ -52,6 +54,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/bfloat16.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/util/determinism.h"
 #include "tensorflow/core/util/util.h"
 
@@ -567,10 +570,15 @@ class SparseSegmentReductionOpBase : public OpKernel {
         default_value_(default_value) {}
 
   void Compute(OpKernelContext* context) override {
-    const Tensor& input = context->input(0);
-    const Tensor& indices = context->input(1);
-    const Tensor& segment_ids = context->input(2);
+    ComputeWithInputs(context, context->input(0), context->input(1),
+                      context->input(2));
+  }
 
+ protected:
+  // Reduces the rows of `input` selected by `indices` into the segments of
+  // `segment_ids`, and sets the result as the output of the kernel.
+  void ComputeWithInputs(OpKernelContext* context, const Tensor& input,
+                         const Tensor& indices, const Tensor& segment_ids) {
     OP_REQUIRES_OK(
         context, internal::ValidateSparseSegmentReduction(
                      context, input, indices, segment_ids, has_num_segments_));
@@ -634,73 +642,114 @@ class SparseSegmentReductionOpBase : public OpKernel {
                 absl::InvalidArgumentError("segment ids must be >= 0"));
     auto output_flat = output->flat_outer_dims<T>();
 
-    // If we use DT_BFLOAT16 or DT_HALF, we need to use DT_FLOAT for
-    // accumulation. We create a temp tensor to perform this accumulation for
-    // every segment.
-    Tensor temp;
-    if (input.dtype() == DT_BFLOAT16 || input.dtype() == DT_HALF) {
-      TensorShape temp_shape = output_shape;
-      OP_REQUIRES_OK(context, temp_shape.SetDimWithStatus(/*d=*/0, /*size=*/1));
-      temp = tensorflow::Tensor(DT_FLOAT, temp_shape);
-    }
-    auto temp_flat = temp.flat_outer_dims<float>();
-
-    int64_t start = 0, end = 1;
-    // Index from which the output is not initialized.
-    SegmentId uninitialized_index = 0;
+    // Find the segments first, so that they can be reduced in parallel.
+    // `segment_starts[k]` is the position in `indices` of the first row of the
+    // k-th segment. Errors are reported as a sequential reduction would report
+    // them: the segments are only reduced up to the first invalid segment id.
+    std::vector<SegmentId> segment_out_indices;
+    std::vector<int64_t> segment_starts;
+    absl::Status segments_status;
+    int64_t start = 0;
     SegmentId out_index = internal::SubtleMustCopy(segment_vec(start));
-
-    while (true) {
+    for (int64_t end = 1; end <= num_indices; ++end) {
       // We initialize next_index to 0 to avoid "warning: 'next_index' may be
       // used uninitialized in this function" in the Mac build (since the
       // compiler isn't smart enough to realize the code is safe).
       SegmentId next_index = 0;
       if (end < num_indices) {
         next_index = internal::SubtleMustCopy(segment_vec(end));
-        if (out_index == next_index) {
-          ++end;
-          continue;
-        }
+        if (out_index == next_index) continue;
         // We have a new segment here.  Verify that the segment ids are growing.
-        OP_REQUIRES(
-            context, out_index < next_index,
-            absl::InvalidArgumentError("segment ids are not increasing"));
+        if (out_index > next_index) {
+          segments_status =
+              absl::InvalidArgumentError("segment ids are not increasing");
+          break;
+        }
       }
-
-      OP_REQUIRES(
-          context, FastBoundsCheck(out_index, output_rows),
-          errors::InvalidArgument(
-              "Segment id ", out_index, " out of range [0, ", output_rows,
-              "), possibly because 'segment_ids' input is not sorted."));
-
-      // If there is a gap between two indices, we need to set that gap to the
-      // default value.
-      if (out_index > uninitialized_index) {
-        Eigen::DSizes<Eigen::DenseIndex, 2> gap_slice_shape(
-            out_index - uninitialized_index, num_col);
-        Eigen::TensorMap<Eigen::Tensor<T, 2, Eigen::RowMajor>, Eigen::Unaligned>
-            gap_slice(&output_flat(uninitialized_index, 0), gap_slice_shape);
-        gap_slice.setConstant(default_value_);
+      if (!FastBoundsCheck(out_index, output_rows)) {
+        segments_status = errors::InvalidArgument(
+            "Segment id ", out_index, " out of range [0, ", output_rows,
+            "), possibly because 'segment_ids' input is not sorted.");
+        break;
       }
-
-      auto out = output_flat.template chip<0>(out_index);
-      auto temp = temp_flat.template chip<0>(0);
-      const int bad_offset = Reduce<T, Index>(input_flat, indices_vec, start,
-                                              end - start, out, temp);
-      OP_REQUIRES(context, bad_offset < 0,
-                  errors::InvalidArgument(
-                      "Bad: indices[", start + bad_offset,
-                      "] == ", indices_vec(start + bad_offset),
-                      " out of range [0, ", input_flat.dimension(0), ")"));
-
+      segment_out_indices.push_back(out_index);
+      segment_starts.push_back(start);
       start = end;
-      ++end;
-      uninitialized_index = out_index + 1;
       out_index = next_index;
-      if (end > num_indices) break;
     }
+    segment_starts.push_back(start);
+    const int64_t num_segments = segment_out_indices.size();
+    // The rows of the valid segments.
+    const int64_t num_rows = segment_starts.back();
+
+    // The smallest position in `indices` of an out of range index.
+    mutex bad_position_mu;
+    int64_t bad_position = num_indices;
+
+    // Reduces the segments starting in rows [begin, end), so that work is
+    // sharded by output segment, and balanced by the rows of the segments.
+    auto reduce_segments = [&](int64_t begin, int64_t end) {
+      // If we use DT_BFLOAT16 or DT_HALF, we need to use DT_FLOAT for
+      // accumulation. We create a temp tensor to perform this accumulation for
+      // every segment.
+      Tensor temp;
+      if (input.dtype() == DT_BFLOAT16 || input.dtype() == DT_HALF) {
+        temp = tensorflow::Tensor(DT_FLOAT, TensorShape({1, num_col}));
+      }
+      auto temp_flat = temp.flat_outer_dims<float>();
+
+      const auto first_segment = std::lower_bound(
+          segment_starts.begin(), segment_starts.end() - 1, begin);
+      const auto last_segment = std::lower_bound(
+          first_segment, segment_starts.end() - 1, end);
+      for (int64_t k = first_segment - segment_starts.begin();
+           k < last_segment - segment_starts.begin(); ++k) {
+        const SegmentId out_index = segment_out_indices[k];
+        // If there is a gap between two indices, we need to set that gap to
+        // the default value.
+        const SegmentId uninitialized_index =
+            k == 0 ? 0 : segment_out_indices[k - 1] + 1;
+        if (out_index > uninitialized_index) {
+          Eigen::DSizes<Eigen::DenseIndex, 2> gap_slice_shape(
+              out_index - uninitialized_index, num_col);
+          Eigen::TensorMap<Eigen::Tensor<T, 2, Eigen::RowMajor>,
+                           Eigen::Unaligned>
+              gap_slice(&output_flat(uninitialized_index, 0), gap_slice_shape);
+          gap_slice.setConstant(default_value_);
+        }
+
+        auto out = output_flat.template chip<0>(out_index);
+        auto temp = temp_flat.template chip<0>(0);
+        const int64_t segment_start = segment_starts[k];
+        const int bad_offset = Reduce<T, Index>(
+            input_flat, indices_vec, segment_start,
+            segment_starts[k + 1] - segment_start, out, temp);
+        if (bad_offset >= 0) {
+          mutex_lock l(bad_position_mu);
+          bad_position = std::min(bad_position, segment_start + bad_offset);
+          return;
+        }
+      }
+    };
+
+    // Each row costs a load of the row and an addition per column.
+    const Eigen::TensorOpCost cost_per_row(
+        /*bytes_loaded=*/sizeof(T) * num_col + sizeof(Index),
+        /*bytes_stored=*/sizeof(T) * num_col * num_segments /
+            std::max<int64_t>(num_rows, 1),
+        /*compute_cycles=*/num_col * Eigen::TensorOpCost::AddCost<T>());
+    context->eigen_device<CPUDevice>().parallelFor(num_rows, cost_per_row,
+                                                   reduce_segments);
+
+    OP_REQUIRES(context, bad_position == num_indices,
+                errors::InvalidArgument(
+                    "Bad: indices[", bad_position,
+                    "] == ", indices_vec(bad_position), " out of range [0, ",
+                    input_flat.dimension(0), ")"));
+    OP_REQUIRES_OK(context, segments_status);
 
     // Fill the gap at the end with the default value.
+    const SegmentId uninitialized_index = segment_out_indices.back() + 1;
     if (uninitialized_index < output_rows) {
       Eigen::DSizes<Eigen::DenseIndex, 2> gap_slice_shape(
           output_rows - uninitialized_index, num_col);
@@ -1078,6 +1127,59 @@ class SparseSegmentReductionSumWithNumSegmentsOp
             true /* has_num_segments */, T(0) /* default_value */) {}
 };
 
+// Fusion of a Gather of the rows `ids` of `params` and of a sparse segment
+// reduction of the gathered rows, created by the remapper. The rows
+// `ids[indices]` of `params` are reduced directly, so that the gathered rows
+// are never materialized. Unlike the Gather, only the ids selected by `indices`
+// are checked to be in range.
+template <class T, typename Tids, typename Index, typename SegmentId>
+class FusedSparseSegmentReductionOp
+    : public SparseSegmentReductionOpBase<CPUDevice, T, int64_t, SegmentId> {
+ public:
+  explicit FusedSparseSegmentReductionOp(OpKernelConstruction* context)
+      : SparseSegmentReductionOpBase<CPUDevice, T, int64_t, SegmentId>(
+            context, HasCombiner(context, "mean") /*is_mean*/,
+            HasCombiner(context, "sqrtn") /*is_sqrtn*/,
+            false /* has_num_segments */, T(0) /* default_value */) {}
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& params = context->input(0);
+    const Tensor& ids = context->input(1);
+    const Tensor& indices = context->input(2);
+    const Tensor& segment_ids = context->input(3);
+
+    OP_REQUIRES(context, TensorShapeUtils::IsVector(ids.shape()),
+                absl::InvalidArgumentError("ids should be a vector."));
+    OP_REQUIRES(context, TensorShapeUtils::IsVector(indices.shape()),
+                absl::InvalidArgumentError("indices should be a vector."));
+
+    // The rows of `params` to reduce, i.e. `ids[indices]`.
+    Tensor params_indices;
+    OP_REQUIRES_OK(context, context->allocate_temp(DT_INT64, indices.shape(),
+                                                   &params_indices));
+    const auto ids_vec = ids.vec<Tids>();
+    const auto indices_vec = indices.vec<Index>();
+    auto params_indices_vec = params_indices.vec<int64_t>();
+    const int64_t num_ids = ids_vec.dimension(0);
+    for (int64_t i = 0; i < indices_vec.dimension(0); ++i) {
+      const Index index = internal::SubtleMustCopy(indices_vec(i));
+      OP_REQUIRES(context, FastBoundsCheck(index, num_ids),
+                  errors::InvalidArgument("indices[", i, "] == ", index,
+                                          " out of range [0, ", num_ids, ")"));
+      params_indices_vec(i) = internal::SubtleMustCopy(ids_vec(index));
+    }
+
+    this->ComputeWithInputs(context, params, params_indices, segment_ids);
+  }
+
+ private:
+  static bool HasCombiner(OpKernelConstruction* context,
+                          absl::string_view combiner) {
+    std::string value;
+    return context->GetAttr("combiner", &value).ok() && value == combiner;
+  }
+};
+
 namespace functor {
 
 template <typename T, typename Index, typename SegmentId>
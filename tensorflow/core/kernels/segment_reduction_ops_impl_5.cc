@@ -87,6 +87,35 @@ TF_CALL_FLOAT_TYPES(REGISTER_CPU_SPARSE_KERNELS_FOR_EACH_INDEX_TYPE);
 TF_CALL_FLOAT_TYPES(REGISTER_CPU_SPARSE_KERNELS_FOR_EACH_INDEX_TYPE);
 #undef REGISTER_CPU_SPARSE_KERNELS
 
+#define REGISTER_CPU_FUSED_SPARSE_KERNELS(type, ids_type, index_type,  \
+                                          segment_ids_type)            \
+  REGISTER_KERNEL_BUILDER(                                             \
+      Name("_FusedSparseSegmentReduction")                             \
+          .Device(DEVICE_CPU)                                          \
+          .TypeConstraint<type>("T")                                   \
+          .TypeConstraint<ids_type>("Tids")                            \
+          .TypeConstraint<index_type>("Tidx")                          \
+          .TypeConstraint<segment_ids_type>("Tsegmentids"),            \
+      FusedSparseSegmentReductionOp<type, ids_type, index_type,        \
+                                    segment_ids_type>);
+#define REGISTER_CPU_FUSED_SPARSE_KERNELS_FOR_EACH_SEGMENT_ID_TYPE(    \
+    type, ids_type, index_type)                                        \
+  REGISTER_CPU_FUSED_SPARSE_KERNELS(type, ids_type, index_type, int32) \
+  REGISTER_CPU_FUSED_SPARSE_KERNELS(type, ids_type, index_type, int64_t)
+#define REGISTER_CPU_FUSED_SPARSE_KERNELS_FOR_EACH_INDEX_TYPE(type, ids_type) \
+  REGISTER_CPU_FUSED_SPARSE_KERNELS_FOR_EACH_SEGMENT_ID_TYPE(type, ids_type,  \
+                                                             int32)           \
+  REGISTER_CPU_FUSED_SPARSE_KERNELS_FOR_EACH_SEGMENT_ID_TYPE(type, ids_type,  \
+                                                             int64_t)
+#define REGISTER_CPU_FUSED_SPARSE_KERNELS_FOR_EACH_IDS_TYPE(type)      \
+  REGISTER_CPU_FUSED_SPARSE_KERNELS_FOR_EACH_INDEX_TYPE(type, int32) \
+  REGISTER_CPU_FUSED_SPARSE_KERNELS_FOR_EACH_INDEX_TYPE(type, int64_t)
+TF_CALL_FLOAT_TYPES(REGISTER_CPU_FUSED_SPARSE_KERNELS_FOR_EACH_IDS_TYPE);
+#undef REGISTER_CPU_FUSED_SPARSE_KERNELS_FOR_EACH_IDS_TYPE
+#undef REGISTER_CPU_FUSED_SPARSE_KERNELS_FOR_EACH_INDEX_TYPE
+#undef REGISTER_CPU_FUSED_SPARSE_KERNELS_FOR_EACH_SEGMENT_ID_TYPE
+#undef REGISTER_CPU_FUSED_SPARSE_KERNELS
+
 #if GOOGLE_CUDA
 
 #define REGISTER_GPU_SPARSE_KERNELS_FOR_EACH_SEGMENT_ID_TYPE(type, index_type) \
@@ -13,9 +13,12 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <cstdint>
 #include <functional>
 #include <vector>
 
+#include "absl/status/status.h"
+#include "absl/strings/match.h"
 #include "tensorflow/core/common_runtime/device.h"
 #include "tensorflow/core/common_runtime/device_factory.h"
 #include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
@@ -38,6 +41,104 @@ limitations under the License.
 
 namespace tensorflow {
 
+class SparseSegmentReductionOpTest : public OpsTestBase {
+ protected:
+  void MakeSparseSegmentSumOp() {
+    TF_ASSERT_OK(NodeDefBuilder("sparse_segment_sum", "SparseSegmentSum")
+                     .Input(FakeInput(DT_FLOAT))
+                     .Input(FakeInput(DT_INT32))
+                     .Input(FakeInput(DT_INT32))
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+
+  void MakeFusedSparseSegmentReductionOp() {
+    TF_ASSERT_OK(NodeDefBuilder("fused", "_FusedSparseSegmentReduction")
+                     .Input(FakeInput(DT_FLOAT))
+                     .Input(FakeInput(DT_INT32))
+                     .Input(FakeInput(DT_INT32))
+                     .Input(FakeInput(DT_INT32))
+                     .Attr("combiner", "sum")
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+};
+
+TEST_F(SparseSegmentReductionOpTest, BadIndexBeforeInvalidSegmentId) {
+  MakeSparseSegmentSumOp();
+  // Many segments of two rows, so that they are reduced in parallel. Two out
+  // of range indices are in segments before the first decreasing segment id.
+  constexpr int kNumIndices = 1000;
+  std::vector<int32_t> indices(kNumIndices);
+  std::vector<int32_t> segment_ids(kNumIndices);
+  for (int i = 0; i < kNumIndices; ++i) {
+    indices[i] = i % 4;
+    segment_ids[i] = i < 900 ? i / 2 : 100;
+  }
+  segment_ids[kNumIndices - 1] = 1000;
+  indices[700] = 10;
+  indices[500] = 20;
+  AddInputFromArray<float>(TensorShape({4, 2}), {0, 1, 2, 3, 4, 5, 6, 7});
+  AddInputFromArray<int32_t>(TensorShape({kNumIndices}), indices);
+  AddInputFromArray<int32_t>(TensorShape({kNumIndices}), segment_ids);
+  absl::Status s = RunOpKernel();
+  EXPECT_EQ(s.code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_TRUE(absl::StrContains(s.message(),
+                                "Bad: indices[500] == 20 out of range [0, 4)"))
+      << s;
+}
+
+TEST_F(SparseSegmentReductionOpTest, InvalidSegmentIdBeforeBadIndex) {
+  MakeSparseSegmentSumOp();
+  AddInputFromArray<float>(TensorShape({4, 2}), {0, 1, 2, 3, 4, 5, 6, 7});
+  AddInputFromArray<int32_t>(TensorShape({4}), {0, 1, 2, 10});
+  AddInputFromArray<int32_t>(TensorShape({4}), {0, 2, 1, 3});
+  absl::Status s = RunOpKernel();
+  EXPECT_EQ(s.code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_TRUE(absl::StrContains(s.message(), "segment ids are not increasing"))
+      << s;
+}
+
+TEST_F(SparseSegmentReductionOpTest, FusedSparseSegmentReduction) {
+  MakeFusedSparseSegmentReductionOp();
+  AddInputFromArray<float>(TensorShape({4, 2}), {0, 1, 2, 3, 4, 5, 6, 7});
+  AddInputFromArray<int32_t>(TensorShape({3}), {3, 0, 2});
+  AddInputFromArray<int32_t>(TensorShape({4}), {0, 2, 1, 0});
+  AddInputFromArray<int32_t>(TensorShape({4}), {0, 0, 2, 2});
+  TF_ASSERT_OK(RunOpKernel());
+
+  // Rows 3 + 2, nothing, and rows 0 + 3 of the params.
+  Tensor expected(allocator(), DT_FLOAT, TensorShape({3, 2}));
+  test::FillValues<float>(&expected, {10, 12, 0, 0, 6, 8});
+  test::ExpectTensorEqual<float>(expected, *GetOutput(0));
+}
+
+TEST_F(SparseSegmentReductionOpTest, FusedSparseSegmentReductionBadIndex) {
+  MakeFusedSparseSegmentReductionOp();
+  AddInputFromArray<float>(TensorShape({4, 2}), {0, 1, 2, 3, 4, 5, 6, 7});
+  AddInputFromArray<int32_t>(TensorShape({3}), {3, 0, 2});
+  AddInputFromArray<int32_t>(TensorShape({2}), {0, 3});
+  AddInputFromArray<int32_t>(TensorShape({2}), {0, 1});
+  absl::Status s = RunOpKernel();
+  EXPECT_EQ(s.code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_TRUE(
+      absl::StrContains(s.message(), "indices[1] == 3 out of range [0, 3)"))
+      << s;
+}
+
+TEST_F(SparseSegmentReductionOpTest, FusedSparseSegmentReductionBadId) {
+  MakeFusedSparseSegmentReductionOp();
+  AddInputFromArray<float>(TensorShape({4, 2}), {0, 1, 2, 3, 4, 5, 6, 7});
+  AddInputFromArray<int32_t>(TensorShape({3}), {3, 9, 2});
+  AddInputFromArray<int32_t>(TensorShape({2}), {0, 1});
+  AddInputFromArray<int32_t>(TensorShape({2}), {0, 1});
+  absl::Status s = RunOpKernel();
+  EXPECT_EQ(s.code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_TRUE(absl::StrContains(s.message(),
+                                "Bad: indices[1] == 9 out of range [0, 4)"))
+      << s;
+}
+
 static void BM_UnsortedSegmentReduction(::testing::benchmark::State& state,
                                         const std::string& reduction,
                                         int num_rows, int num_cols,
@@ -291,4 +392,80 @@ BENCHMARK(BM_SparseSegmentMeanGrad_High_FP16)
     ->Arg(1000)
     ->Arg(100000);
 
+// Embedding-bag lookup: bags of `kBagSize` rows of a `kVocabSize` x `kDim`
+// embedding table are gathered and averaged, with or without materializing the
+// gathered rows.
+static void EmbeddingBagHelper(::testing::benchmark::State& state, bool fused,
+                               int num_bags) {
+  Graph* g = new Graph(OpRegistry::Global());
+
+  const int kVocabSize = 100000;
+  const int kDim = 64;
+  const int kBagSize = 16;
+  const int kNumIndices = num_bags * kBagSize;
+
+  Tensor params(DT_FLOAT, TensorShape({kVocabSize, kDim}));
+  params.flat<float>().setRandom();
+  // The unique ids of the bags, and the index of the id of each bag entry.
+  Tensor ids(DT_INT32, TensorShape({kNumIndices / 2}));
+  auto ids_flat = ids.flat<int32_t>();
+  for (int i = 0; i < ids_flat.size(); ++i) {
+    ids_flat(i) = (i * 7919) % kVocabSize;
+  }
+  Tensor indices(DT_INT32, TensorShape({kNumIndices}));
+  auto indices_flat = indices.flat<int32_t>();
+  Tensor segments(DT_INT32, TensorShape({kNumIndices}));
+  auto segments_flat = segments.flat<int32_t>();
+  for (int i = 0; i < kNumIndices; ++i) {
+    indices_flat(i) = (i * 31) % ids_flat.size();
+    segments_flat(i) = i / kBagSize;
+  }
+
+  Node* node;
+  if (fused) {
+    TF_CHECK_OK(NodeBuilder(g->NewName("n"), "_FusedSparseSegmentReduction")
+                    .Input(test::graph::Constant(g, params))
+                    .Input(test::graph::Constant(g, ids))
+                    .Input(test::graph::Constant(g, indices))
+                    .Input(test::graph::Constant(g, segments))
+                    .Attr("T", DT_FLOAT)
+                    .Attr("combiner", "mean")
+                    .Finalize(g, &node));
+  } else {
+    Tensor axis(DT_INT32, TensorShape({}));
+    axis.scalar<int32_t>()() = 0;
+    Node* gather;
+    TF_CHECK_OK(NodeBuilder(g->NewName("n"), "GatherV2")
+                    .Input(test::graph::Constant(g, params))
+                    .Input(test::graph::Constant(g, ids))
+                    .Input(test::graph::Constant(g, axis))
+                    .Finalize(g, &gather));
+    TF_CHECK_OK(NodeBuilder(g->NewName("n"), "SparseSegmentMean")
+                    .Input(gather)
+                    .Input(test::graph::Constant(g, indices))
+                    .Input(test::graph::Constant(g, segments))
+                    .Attr("T", DT_FLOAT)
+                    .Finalize(g, &node));
+  }
+
+  test::Benchmark("cpu", g, /*old_benchmark_api*/ false).Run(state);
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          kNumIndices * kDim * sizeof(float));
+}
+
+static void BM_EmbeddingBag(::testing::benchmark::State& state) {
+  const int num_bags = state.range(0);
+
+  return EmbeddingBagHelper(state, /*fused=*/false, num_bags);
+}
+
+static void BM_EmbeddingBag_Fused(::testing::benchmark::State& state) {
+  const int num_bags = state.range(0);
+
+  return EmbeddingBagHelper(state, /*fused=*/true, num_bags);
+}
+
+BENCHMARK(BM_EmbeddingBag)->UseRealTime()->Arg(64)->Arg(1024)->Arg(16384);
+BENCHMARK(BM_EmbeddingBag_Fused)->UseRealTime()->Arg(64)->Arg(1024)->Arg(16384);
+
 }  // namespace tensorflow
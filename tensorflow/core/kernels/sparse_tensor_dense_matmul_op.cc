@@ -19,6 +19,10 @@ limitations under the License.
 
 #include "tensorflow/core/kernels/sparse_tensor_dense_matmul_op.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
 #include "Eigen/Core"  // from @eigen_archive
 #include "tensorflow/core/framework/bounds_check.h"
 #include "tensorflow/core/framework/op.h"
@@ -270,9 +274,10 @@ absl::Status SparseTensorDenseMatMulImpl(
   const int lhs_index_a = ADJ_A ? 1 : 0;
   const int rhs_index_a = ADJ_A ? 0 : 1;
 
-  // TODO(ebrevdo): After many failed experiments, can't find a multi-threaded
-  // approach that achieves the performance of the single threaded
-  // one.  Perhaps Eigen threadpool implementation is just too slow?
+  // Scattering the nonzeros into the output rows from several threads is
+  // slower than this single threaded loop, see
+  // SparseTensorDenseMatMulParallelImpl for the multi-threaded implementation
+  // used for large products.
 
   if (rhs_right < kNumVectorize) {
     // Disable vectorization if the RHS of output is too small
@@ -327,6 +332,128 @@ absl::Status SparseTensorDenseMatMulImpl(
   }
   return absl::OkStatus();
 }
+
+// Below this number of multiply-adds, bucketing the nonzeros by output row
+// costs more than the parallelism gains.
+constexpr int64_t kMinParallelMultiplyAdds = 1 << 16;
+
+// Returns whether to use SparseTensorDenseMatMulParallelImpl rather than
+// SparseTensorDenseMatMulImpl.
+bool UseParallelImpl(const CPUDevice& d, int64_t nnz, int64_t out_rows,
+                     int64_t out_cols) {
+  return d.numThreads() > 1 && out_rows > 1 &&
+         nnz * out_cols >= kMinParallelMultiplyAdds;
+}
+
+// Multi-threaded SparseTensorDenseMatMulImpl. The nonzeros of `a` are bucketed
+// by output row into a CSR layout, and the output rows are partitioned across
+// the threads, so that each output row is written by a single thread. The
+// partitions are balanced by nonzeros rather than by rows, since the nonzeros
+// of `a` are often concentrated in a few rows. Within an output row, the
+// nonzeros are accumulated in their order in `a_indices`, as by the single
+// threaded implementation, and the rows of `b` are accumulated with vectorized
+// Eigen expressions.
+template <typename T, typename Tsum, typename Tindices, bool ADJ_A, bool ADJ_B>
+absl::Status SparseTensorDenseMatMulParallelImpl(
+    const CPUDevice& d, typename TTypes<Tsum>::Matrix out,
+    typename TTypes<Tindices>::ConstMatrix a_indices,
+    typename TTypes<T>::ConstVec a_values, typename TTypes<T>::ConstMatrix b) {
+  const int64_t nnz = a_values.size();
+  const int64_t out_rows = out.dimension(0);
+  const int64_t rhs_right = (ADJ_B ? b.dimension(0) : b.dimension(1));
+  const int64_t lhs_right = (ADJ_B ? b.dimension(1) : b.dimension(0));
+  const int lhs_index_a = ADJ_A ? 1 : 0;
+  const int rhs_index_a = ADJ_A ? 0 : 1;
+
+  // Count the nonzeros of each output row. The indices are copied once, so
+  // that they are only validated once.
+  std::vector<int64_t> row_starts(out_rows + 1, 0);
+  std::vector<Tindices> rows(nnz);
+  std::vector<Tindices> cols(nnz);
+  for (int64_t i = 0; i < nnz; ++i) {
+    const Tindices m = internal::SubtleMustCopy(a_indices(i, lhs_index_a));
+    const Tindices k = internal::SubtleMustCopy(a_indices(i, rhs_index_a));
+    if (!FastBoundsCheck(k, lhs_right)) {
+      return KOutOfBoundsError(k, i, rhs_index_a, lhs_right);
+    }
+    if (!FastBoundsCheck(m, out_rows)) {
+      return MOutOfBoundsError(m, i, lhs_index_a, out_rows);
+    }
+    rows[i] = m;
+    cols[i] = k;
+    ++row_starts[m + 1];
+  }
+  for (int64_t m = 0; m < out_rows; ++m) {
+    row_starts[m + 1] += row_starts[m];
+  }
+
+  // `order[row_starts[m]:row_starts[m + 1]]` are the nonzeros of output row
+  // `m`, in increasing order.
+  std::vector<int64_t> order(nnz);
+  {
+    std::vector<int64_t> next(row_starts.begin(), row_starts.end() - 1);
+    for (int64_t i = 0; i < nnz; ++i) {
+      order[next[rows[i]]++] = i;
+    }
+  }
+
+  // The rows of `b` are accumulated into the output rows, so the adjoint of
+  // `b` is computed once.
+  Eigen::Tensor<T, 2, Eigen::RowMajor> adjoint_b;
+  const T* b_data = b.data();
+  if (ADJ_B) {
+    adjoint_b.resize(lhs_right, rhs_right);
+    Eigen::array<int, 2> shuffle{1, 0};
+    adjoint_b.device(d) = b.shuffle(shuffle).conjugate();
+    b_data = adjoint_b.data();
+  }
+
+  using ConstRow = Eigen::Map<const Eigen::Array<T, Eigen::Dynamic, 1>>;
+  using Row = Eigen::Map<Eigen::Array<Tsum, Eigen::Dynamic, 1>>;
+  // Computes the output rows whose first nonzero is in [begin, end).
+  auto compute_rows = [&](int64_t begin, int64_t end) {
+    const auto first_row = std::lower_bound(row_starts.begin(),
+                                            row_starts.end() - 1, begin);
+    const auto last_row =
+        std::lower_bound(first_row, row_starts.end() - 1, end);
+    for (int64_t m = first_row - row_starts.begin();
+         m < last_row - row_starts.begin(); ++m) {
+      Row out_row(&out(m, 0), rhs_right);
+      for (int64_t j = row_starts[m]; j < row_starts[m + 1]; ++j) {
+        const int64_t i = order[j];
+        const T a_value = ADJ_A ? MaybeConj(a_values(i)) : a_values(i);
+        out_row += ConstRow(b_data + cols[i] * rhs_right, rhs_right)
+                       .template cast<Tsum>() *
+                   static_cast<Tsum>(a_value);
+      }
+    }
+  };
+
+  const Eigen::TensorOpCost cost_per_nonzero(
+      /*bytes_loaded=*/rhs_right * sizeof(T) + sizeof(int64_t) +
+          sizeof(Tindices) + sizeof(T),
+      /*bytes_stored=*/rhs_right * sizeof(Tsum),
+      /*compute_cycles=*/rhs_right *
+          (Eigen::TensorOpCost::MulCost<Tsum>() +
+           Eigen::TensorOpCost::AddCost<Tsum>()));
+  d.parallelFor(nnz, cost_per_nonzero, compute_rows);
+  return absl::OkStatus();
+}
+
+template <typename T, typename Tsum, typename Tindices, bool ADJ_A, bool ADJ_B>
+absl::Status SparseTensorDenseMatMulCpuImpl(
+    const CPUDevice& d, typename TTypes<Tsum>::Matrix out,
+    typename TTypes<Tindices>::ConstMatrix a_indices,
+    typename TTypes<T>::ConstVec a_values, typename TTypes<T>::ConstMatrix b) {
+  if (UseParallelImpl(d, a_values.size(), out.dimension(0),
+                      out.dimension(1))) {
+    return SparseTensorDenseMatMulParallelImpl<T, Tsum, Tindices, ADJ_A,
+                                               ADJ_B>(d, out, a_indices,
+                                                      a_values, b);
+  }
+  return SparseTensorDenseMatMulImpl<T, Tsum, Tindices, ADJ_A, ADJ_B>(
+      out, a_indices, a_values, b);
+}
 }  // namespace
 
 template <typename T, typename Tindices, bool ADJ_A, bool ADJ_B>
@@ -337,6 +464,7 @@ struct SparseTensorDenseMatMulFunctor<CPUDevice, T, Tindices, ADJ_A, ADJ_B> {
                               typename TTypes<T>::ConstVec a_values,
                               typename TTypes<T>::ConstMatrix b) {
     using Tsum = typename SumType<T>::type;
+    const CPUDevice& d = ctx->eigen_device<CPUDevice>();
     Tensor temp_out_t;
     if (!std::is_same<T, Tsum>::value) {
       TF_RETURN_IF_ERROR(ctx->allocate_temp(
@@ -345,8 +473,8 @@ struct SparseTensorDenseMatMulFunctor<CPUDevice, T, Tindices, ADJ_A, ADJ_B> {
       auto temp_out = temp_out_t.matrix<Tsum>();
       temp_out.setZero();
       TF_RETURN_IF_ERROR(
-          SparseTensorDenseMatMulImpl<T, Tsum, Tindices, ADJ_A, ADJ_B>(
-              temp_out, a_indices, a_values, b));
+          SparseTensorDenseMatMulCpuImpl<T, Tsum, Tindices, ADJ_A, ADJ_B>(
+              d, temp_out, a_indices, a_values, b));
       out = temp_out.template cast<T>();
     } else {
       out.setZero();
@@ -355,8 +483,8 @@ struct SparseTensorDenseMatMulFunctor<CPUDevice, T, Tindices, ADJ_A, ADJ_B> {
       auto out_workaround =
           *reinterpret_cast<typename TTypes<Tsum>::Matrix*>(&out);
       TF_RETURN_IF_ERROR(
-          SparseTensorDenseMatMulImpl<T, Tsum, Tindices, ADJ_A, ADJ_B>(
-              out_workaround, a_indices, a_values, b));
+          SparseTensorDenseMatMulCpuImpl<T, Tsum, Tindices, ADJ_A, ADJ_B>(
+              d, out_workaround, a_indices, a_values, b));
     }
     return absl::OkStatus();
   }
@@ -13,16 +13,127 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
 
+#include "absl/status/status.h"
 #include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/graph/node_builder.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/status_matchers.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/test_benchmark.h"
 
 namespace tensorflow {
 
+class SparseTensorDenseMatMulOpTest
+    : public OpsTestBase,
+      public ::testing::WithParamInterface<std::tuple<bool, bool>> {
+ protected:
+  void MakeOp(bool adjoint_a, bool adjoint_b) {
+    TF_ASSERT_OK(NodeDefBuilder("sparse_tensor_dense_matmul",
+                                "SparseTensorDenseMatMul")
+                     .Input(FakeInput(DT_INT64))
+                     .Input(FakeInput(DT_FLOAT))
+                     .Input(FakeInput(DT_INT64))
+                     .Input(FakeInput(DT_FLOAT))
+                     .Attr("adjoint_a", adjoint_a)
+                     .Attr("adjoint_b", adjoint_b)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+};
+
+// Large enough to use the multi-threaded implementation, with most nonzeros in
+// a few rows of the output.
+TEST_P(SparseTensorDenseMatMulOpTest, MatchesDenseMatMul) {
+  const auto [adjoint_a, adjoint_b] = GetParam();
+  MakeOp(adjoint_a, adjoint_b);
+  const int m = 67, k = 129, n = 65, nnz = 3000;
+
+  std::mt19937 gen(42);
+  std::vector<float> a(m * k, 0.0f);
+  std::vector<int64_t> a_indices;
+  std::vector<float> a_values;
+  for (int i = 0; i < nnz; ++i) {
+    const int row = gen() % 4 == 0 ? gen() % m : gen() % 5;
+    const int col = gen() % k;
+    const float value = static_cast<float>(gen() % 11) - 5.0f;
+    // Duplicates are summed, as by the kernel.
+    a[row * k + col] += value;
+    a_indices.push_back(adjoint_a ? col : row);
+    a_indices.push_back(adjoint_a ? row : col);
+    a_values.push_back(value);
+  }
+  std::vector<float> b(k * n);
+  for (float& value : b) value = static_cast<float>(gen() % 7) - 3.0f;
+
+  AddInputFromArray<int64_t>(TensorShape({nnz, 2}), a_indices);
+  AddInputFromArray<float>(TensorShape({nnz}), a_values);
+  AddInputFromArray<int64_t>(TensorShape({2}),
+                             {adjoint_a ? k : m, adjoint_a ? m : k});
+  std::vector<float> b_input(k * n);
+  for (int i = 0; i < k; ++i) {
+    for (int j = 0; j < n; ++j) {
+      b_input[adjoint_b ? j * k + i : i * n + j] = b[i * n + j];
+    }
+  }
+  AddInputFromArray<float>(
+      adjoint_b ? TensorShape({n, k}) : TensorShape({k, n}), b_input);
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected(DT_FLOAT, TensorShape({m, n}));
+  auto expected_matrix = expected.matrix<float>();
+  for (int i = 0; i < m; ++i) {
+    for (int j = 0; j < n; ++j) {
+      float sum = 0.0f;
+      for (int l = 0; l < k; ++l) sum += a[i * k + l] * b[l * n + j];
+      expected_matrix(i, j) = sum;
+    }
+  }
+  test::ExpectTensorEqual<float>(expected, *GetOutput(0));
+}
+
+TEST_P(SparseTensorDenseMatMulOpTest, IndexOutOfBounds) {
+  const auto [adjoint_a, adjoint_b] = GetParam();
+  MakeOp(adjoint_a, adjoint_b);
+  const int m = 64, k = 64, n = 64, nnz = 2048;
+
+  std::vector<int64_t> a_indices;
+  for (int i = 0; i < nnz; ++i) {
+    a_indices.push_back(i % m);
+    a_indices.push_back(i == nnz / 2 ? k : i % k);
+  }
+  if (adjoint_a) {
+    for (int i = 0; i < nnz; ++i) {
+      std::swap(a_indices[2 * i], a_indices[2 * i + 1]);
+    }
+  }
+  AddInputFromArray<int64_t>(TensorShape({nnz, 2}), a_indices);
+  AddInputFromArray<float>(TensorShape({nnz}), std::vector<float>(nnz, 1.0f));
+  AddInputFromArray<int64_t>(TensorShape({2}), {m, k});
+  AddInputFromArray<float>(TensorShape({k, n}),
+                           std::vector<float>(k * n, 1.0f));
+  EXPECT_THAT(RunOpKernel(),
+              absl_testing::StatusIs(absl::StatusCode::kInvalidArgument,
+                                     ::testing::HasSubstr("out of bounds")));
+}
+
+INSTANTIATE_TEST_SUITE_P(SparseTensorDenseMatMulOpTests,
+                         SparseTensorDenseMatMulOpTest,
+                         ::testing::Combine(::testing::Bool(),
+                                            ::testing::Bool()));
+
 Node* SparseTensorDenseMatMulNode(Graph* g, Node* a_indices, Node* a_values,
                                   Node* a_shape, Node* b, bool adjoint_a,
                                   bool adjoint_b) {
@@ -120,4 +231,94 @@ BM_SparseTensorDenseMatmul(16384, 4096, 4096, 4096, false, true);
 BM_SparseTensorDenseMatmul(16384, 4096, 4096, 4096, true, false);
 BM_SparseTensorDenseMatmul(16384, 4096, 4096, 4096, true, true);
 
+// Sparsity patterns of the sparse operand of the benchmarks below.
+enum class SparsityPattern {
+  // A wide-and-deep style batch of multi-hot features: every row has the same
+  // number of nonzeros, in sorted order, and the columns follow a power law.
+  kMultiHot,
+  // Power law rows, e.g. the transposed multi-hot batch of a gradient.
+  kSkewedRows,
+};
+
+static Graph* SparseTensorDenseMatmulWithPattern(SparsityPattern pattern,
+                                                 int nnz, int m, int k,
+                                                 int n) {
+  Graph* g = new Graph(OpRegistry::Global());
+  Tensor a_values(DT_FLOAT, TensorShape({nnz}));
+  a_values.flat<float>().setRandom();
+  Tensor a_indices(DT_INT64, TensorShape({nnz, 2}));
+  auto a_indices_t = a_indices.matrix<int64_t>();
+  Tensor a_shape(DT_INT64, TensorShape({2}));
+  a_shape.vec<int64_t>()(0) = m;
+  a_shape.vec<int64_t>()(1) = k;
+
+  std::mt19937 gen(0);
+  // Draws from [0, size) with a density proportional to 1 / (x + 1).
+  auto power_law = [&gen](int size) {
+    std::uniform_real_distribution<double> uniform(0.0, std::log(size + 1.0));
+    return std::min(static_cast<int>(std::exp(uniform(gen)) - 1.0), size - 1);
+  };
+  std::vector<std::pair<int64_t, int64_t>> indices(nnz);
+  for (int i = 0; i < nnz; ++i) {
+    if (pattern == SparsityPattern::kMultiHot) {
+      indices[i] = {static_cast<int64_t>(i) * m / nnz, power_law(k)};
+    } else {
+      indices[i] = {power_law(m), gen() % k};
+    }
+  }
+  std::sort(indices.begin(), indices.end());
+  for (int i = 0; i < nnz; ++i) {
+    a_indices_t(i, 0) = indices[i].first;
+    a_indices_t(i, 1) = indices[i].second;
+  }
+  Tensor b(DT_FLOAT, TensorShape({k, n}));
+  b.flat<float>().setRandom();
+
+  SparseTensorDenseMatMulNode(
+      g, test::graph::Constant(g, a_indices),
+      test::graph::Constant(g, a_values), test::graph::HostConstant(g, a_shape),
+      test::graph::Constant(g, b), /*adjoint_a=*/false, /*adjoint_b=*/false);
+  return g;
+}
+
+// Args: batch size, nonzeros per row, embedding dimension.
+static void BM_SparseTensorDenseMatmul_MultiHot(
+    ::testing::benchmark::State& state) {
+  const int m = state.range(0);
+  const int nnz = m * state.range(1);
+  const int n = state.range(2);
+  test::Benchmark("cpu",
+                  SparseTensorDenseMatmulWithPattern(
+                      SparsityPattern::kMultiHot, nnz, m, /*k=*/100000, n),
+                  /*old_benchmark_api*/ false)
+      .Run(state);
+  state.SetItemsProcessed(state.iterations() * nnz * n);
+}
+BENCHMARK(BM_SparseTensorDenseMatmul_MultiHot)
+    ->UseRealTime()
+    ->Args({256, 8, 16})
+    ->Args({256, 32, 64})
+    ->Args({4096, 8, 16})
+    ->Args({4096, 32, 64})
+    ->Args({4096, 32, 256});
+
+// Args: nonzeros, output rows, output columns.
+static void BM_SparseTensorDenseMatmul_SkewedRows(
+    ::testing::benchmark::State& state) {
+  const int nnz = state.range(0);
+  const int m = state.range(1);
+  const int n = state.range(2);
+  test::Benchmark("cpu",
+                  SparseTensorDenseMatmulWithPattern(
+                      SparsityPattern::kSkewedRows, nnz, m, /*k=*/4096, n),
+                  /*old_benchmark_api*/ false)
+      .Run(state);
+  state.SetItemsProcessed(state.iterations() * nnz * n);
+}
+BENCHMARK(BM_SparseTensorDenseMatmul_SkewedRows)
+    ->UseRealTime()
+    ->Args({16384, 4096, 16})
+    ->Args({16384, 4096, 128})
+    ->Args({131072, 100000, 64});
+
 }  // end namespace tensorflow
@@ -524,6 +524,37 @@ REGISTER_OP("DecodeAndCropJpeg")
       return absl::OkStatus();
     });
 
+REGISTER_OP("_DecodeAndResizeJpeg")
+    .Input("contents: string")
+    .Input("crop_window: int32")
+    .Input("size: int32")
+    .Attr("channels: int = 0")
+    .Attr("fancy_upscaling: bool = true")
+    .Attr("try_recover_truncated: bool = false")
+    .Attr("acceptable_fraction: float = 1.0")
+    .Attr("dct_method: string = ''")
+    .Attr("align_corners: bool = false")
+    .Attr("half_pixel_centers: bool = false")
+    .Output("resized_images: float")
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle unused;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 0, &unused));
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 1, &unused));
+      TF_ASSIGN_OR_RETURN(DimensionHandle channels_dim, GetChannelsDim(c));
+      return SetOutputToSizedImage(c, c->MakeDim(1), 2 /* size_input_idx */,
+                                   channels_dim);
+    })
+    .Doc(R"doc(
+Internal operation which is a composition of decoding a JPEG image (DecodeJpeg
+or DecodeAndCropJpeg), adding a batch dimension, and resizing it
+(ResizeBilinear): reserved for internal use. The image is decoded at the
+smallest DCT scale that is at least the output size, and only the
+`crop_window`, if not empty, is decoded.
+
+Do not invoke this operator directly in Python. A fusion optimization is
+expected to create these operators.
+)doc");
+
 // --------------------------------------------------------------------------
 REGISTER_OP("EncodeJpeg")
     .Input("image: uint8")
@@ -18,11 +18,15 @@ limitations under the License.
 #include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <optional>
 #include <string>
+#include <utility>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
+#include "absl/strings/string_view.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/status.h"
@@ -34,8 +38,13 @@ namespace tfrt_stub {
 
 void CostRecorder::RecordCost(int64_t op_key, uint64_t execution_time) {
   mutex_lock l(op_cost_map_mutex_);
-  op_cost_map_[op_key].first += execution_time;
-  op_cost_map_[op_key].second += 1;
+  OpCost& op_cost = op_cost_map_[op_key];
+  op_cost.total_cost += execution_time;
+  op_cost.num_ops += 1;
+}
+
+uint64_t CostRecorder::AverageCost(const OpCost& op_cost) {
+  return static_cast<uint64_t>(op_cost.total_cost / op_cost.num_ops);
 }
 
 uint64_t CostRecorder::GetCost(int64_t op_key) const {
@@ -44,27 +53,48 @@ uint64_t CostRecorder::GetCost(int64_t op_key) const {
   const auto iter = op_cost_map_.find(op_key);
   if (iter == op_cost_map_.end()) return std::numeric_limits<uint32_t>::max();
 
-  const auto total_cost = iter->second.first;
-  const auto num_ops = iter->second.second;
-
-  auto r =
-      std::max(static_cast<uint64_t>(1),
-               static_cast<uint64_t>(total_cost / num_ops));
+  auto r = std::max(static_cast<uint64_t>(1), AverageCost(iter->second));
 
   VLOG(2) << "Get cost for op_key=" << op_key << ", cost=" << r;
 
   return r;
 }
 
-absl::Status CostRecorder::WriteToFile() const {
+void CostRecorder::Decay(double decay) {
+  DCHECK(decay >= 0.0 && decay <= 1.0) << decay;
+  mutex_lock l(op_cost_map_mutex_);
+  if (decay <= 0.0) {
+    op_cost_map_.clear();
+    return;
+  }
+  for (auto& [op_key, op_cost] : op_cost_map_) {
+    op_cost.total_cost *= decay;
+    op_cost.num_ops *= decay;
+  }
+}
+
+OpCostMapProto CostRecorder::ToProto() const {
   OpCostMapProto op_cost_map_proto;
-  {
-    tf_shared_lock l(op_cost_map_mutex_);
-    for (const auto& [op_key, op_cost] : op_cost_map_) {
-      const uint64_t avg_op_cost = op_cost.first / op_cost.second;
-      (*op_cost_map_proto.mutable_op_cost_map())[op_key] = avg_op_cost;
-    }
+  tf_shared_lock l(op_cost_map_mutex_);
+  for (const auto& [op_key, op_cost] : op_cost_map_) {
+    (*op_cost_map_proto.mutable_op_cost_map())[op_key] = AverageCost(op_cost);
   }
+  return op_cost_map_proto;
+}
+
+void CostRecorder::MergeFrom(const OpCostMapProto& op_cost_map_proto,
+                             double weight) {
+  if (weight <= 0.0) return;
+  mutex_lock l(op_cost_map_mutex_);
+  for (const auto& [op_key, avg_op_cost] : op_cost_map_proto.op_cost_map()) {
+    OpCost& op_cost = op_cost_map_[op_key];
+    op_cost.total_cost += weight * avg_op_cost;
+    op_cost.num_ops += weight;
+  }
+}
+
+absl::Status CostRecorder::WriteToFile() const {
+  OpCostMapProto op_cost_map_proto = ToProto();
 
   std::string measured_cost_path;
   TF_RETURN_IF_ERROR(ReadStringFromEnvVar(MesuredCostPathEnvVarName(), "",
@@ -78,5 +108,37 @@ size_t CostRecorder::size() const {
   return op_cost_map_.size();
 }
 
+OpCostMapStore& OpCostMapStore::Global() {
+  static auto* const store = new OpCostMapStore();
+  return *store;
+}
+
+void OpCostMapStore::Save(absl::string_view model_name, int64_t version,
+                          absl::string_view graph_name,
+                          OpCostMapProto op_cost_map_proto) {
+  mutex_lock l(mu_);
+  ModelOpCostMaps& model = models_[model_name];
+  if (model.op_cost_maps.empty() || model.version < version) {
+    model.version = version;
+    model.op_cost_maps.clear();
+  } else if (version < model.version) {
+    return;
+  }
+  model.op_cost_maps[graph_name] = std::move(op_cost_map_proto);
+}
+
+std::optional<OpCostMapProto> OpCostMapStore::Load(
+    absl::string_view model_name, int64_t version,
+    absl::string_view graph_name) const {
+  tf_shared_lock l(mu_);
+  const auto model_iter = models_.find(model_name);
+  if (model_iter == models_.end() || model_iter->second.version != version) {
+    return std::nullopt;
+  }
+  const auto iter = model_iter->second.op_cost_maps.find(graph_name);
+  if (iter == model_iter->second.op_cost_maps.end()) return std::nullopt;
+  return iter->second;
+}
+
 }  // namespace tfrt_stub
 }  // namespace tensorflow
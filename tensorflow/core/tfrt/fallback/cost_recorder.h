@@ -20,13 +20,16 @@ limitations under the License.
 
 #include <cstddef>
 #include <cstdint>
-#include <utility>
+#include <optional>
+#include <string>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
+#include "absl/strings/string_view.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/tfrt/fallback/op_cost_map.pb.h"
 
 namespace tensorflow {
 namespace tfrt_stub {
@@ -45,6 +48,19 @@ class CostRecorder {
   // otherwise adding op costs would cause overflow.
   uint64_t GetCost(int64_t op_key) const;
 
+  // Scales the weight of the existing records by `decay`, which is in [0, 1],
+  // so that the average execution durations become exponentially decayed
+  // averages following the durations recorded afterwards. A `decay` of 0 drops
+  // all the records.
+  void Decay(double decay);
+
+  // Returns the average execution durations by op key.
+  OpCostMapProto ToProto() const;
+
+  // Records the average execution durations in `op_cost_map_proto`, e.g. of a
+  // previous instance of the model, each weighing as `weight` executions.
+  void MergeFrom(const OpCostMapProto& op_cost_map_proto, double weight = 1.0);
+
   // Writes the op cost map (in format of `OpCostMapProto`) to a file specified
   // by the env var name `MesuredCostPathEnvVarName()`.
   // TODO(b/263837451): Fix the op_key unstableness during serialization.
@@ -57,12 +73,53 @@ class CostRecorder {
   }
 
  private:
+  struct OpCost {
+    // The decayed sum of op execution durations.
+    double total_cost = 0;
+    // The decayed number of occurrences of the op.
+    double num_ops = 0;
+  };
+
+  static uint64_t AverageCost(const OpCost& op_cost);
+
   mutable tensorflow::mutex op_cost_map_mutex_;
-  // Map op key to {sum of op execution duration, #occurences of the op}.
-  absl::flat_hash_map<int64_t, std::pair<uint64_t, uint64_t>> op_cost_map_
+  absl::flat_hash_map<int64_t, OpCost> op_cost_map_
       TF_GUARDED_BY(op_cost_map_mutex_);
 };
 
+// Thread-safe.
+// Keeps the op costs of the models in this process across model reloads, so
+// that a reloaded model starts from the costs measured by its previous
+// instance. As `op_key` is only unique within a model, the costs are keyed by
+// model name, version and graph name. Only the costs of the latest version of
+// each model are kept.
+class OpCostMapStore {
+ public:
+  static OpCostMapStore& Global();
+
+  // Saves the op costs of graph `graph_name` of the model. Drops the costs of
+  // the older versions of the model, and ignores the costs of an older
+  // version than the latest one saved.
+  void Save(absl::string_view model_name, int64_t version,
+            absl::string_view graph_name, OpCostMapProto op_cost_map_proto);
+
+  // Returns the op costs saved for graph `graph_name` of the model, if any.
+  std::optional<OpCostMapProto> Load(absl::string_view model_name,
+                                     int64_t version,
+                                     absl::string_view graph_name) const;
+
+ private:
+  struct ModelOpCostMaps {
+    int64_t version = 0;
+    // Keyed by graph name.
+    absl::flat_hash_map<std::string, OpCostMapProto> op_cost_maps;
+  };
+
+  mutable tensorflow::mutex mu_;
+  // Keyed by model name.
+  absl::flat_hash_map<std::string, ModelOpCostMaps> models_ TF_GUARDED_BY(mu_);
+};
+
 }  // namespace tfrt_stub
 }  // namespace tensorflow
 
@@ -16,6 +16,7 @@ limitations under the License.
 
 #include <cstdint>
 #include <limits>
+#include <optional>
 #include <string>
 
 #include <gtest/gtest.h>
@@ -99,6 +100,75 @@ TEST(CostRecorderTest, ProtoRecordsTest) {
             kTestAvgCost);
 }
 
+TEST(CostRecorderTest, DecayTest) {
+  CostRecorder recorder;
+
+  // Each record weighs as one execution of the op.
+  recorder.RecordCost(kTestOpKey, kTestCost);
+  recorder.RecordCost(kTestOpKey, kTestCost);
+  recorder.RecordCost(kTestOpKey, kTestCost);
+  recorder.RecordCost(kTestOpKey, kTestCost);
+
+  // After the decay, the previous records weigh as much as one new record.
+  recorder.Decay(0.25);
+  EXPECT_EQ(recorder.GetCost(kTestOpKey), kTestCost);
+  recorder.RecordCost(kTestOpKey, 3 * kTestCost);
+  EXPECT_EQ(recorder.GetCost(kTestOpKey), 2 * kTestCost);
+
+  recorder.Decay(0);
+  EXPECT_EQ(recorder.size(), 0);
+}
+
+TEST(CostRecorderTest, MergeFromTest) {
+  CostRecorder recorder;
+  recorder.RecordCost(kTestOpKey, kTestCost);
+  recorder.RecordCost(kTestOpKey, 2 * kTestCost);
+  OpCostMapProto op_cost_map_proto = recorder.ToProto();
+  EXPECT_EQ(op_cost_map_proto.op_cost_map().at(kTestOpKey), kTestAvgCost);
+
+  CostRecorder restored_recorder;
+  restored_recorder.MergeFrom(op_cost_map_proto, /*weight=*/3);
+  EXPECT_EQ(restored_recorder.GetCost(kTestOpKey), kTestAvgCost);
+  restored_recorder.RecordCost(kTestOpKey, kTestAvgCost + 4000);
+  EXPECT_EQ(restored_recorder.GetCost(kTestOpKey), kTestAvgCost + 1000);
+}
+
+TEST(OpCostMapStoreTest, SaveAndLoadTest) {
+  OpCostMapStore store;
+  EXPECT_FALSE(store.Load("model", 1, "graph").has_value());
+
+  OpCostMapProto op_cost_map_proto;
+  (*op_cost_map_proto.mutable_op_cost_map())[kTestOpKey] = kTestCost;
+  store.Save("model", 1, "graph", op_cost_map_proto);
+
+  std::optional<OpCostMapProto> loaded = store.Load("model", 1, "graph");
+  ASSERT_TRUE(loaded.has_value());
+  EXPECT_EQ(loaded->op_cost_map().at(kTestOpKey), kTestCost);
+  EXPECT_FALSE(store.Load("model", 2, "graph").has_value());
+  EXPECT_FALSE(store.Load("model", 1, "other_graph").has_value());
+}
+
+TEST(OpCostMapStoreTest, KeepsLatestVersionTest) {
+  OpCostMapStore store;
+  OpCostMapProto op_cost_map_proto;
+  (*op_cost_map_proto.mutable_op_cost_map())[kTestOpKey] = kTestCost;
+  store.Save("model", 1, "graph", op_cost_map_proto);
+  store.Save("model", 1, "other_graph", op_cost_map_proto);
+  store.Save("other_model", 1, "graph", op_cost_map_proto);
+
+  // Saving a newer version drops the costs of the older one.
+  store.Save("model", 2, "graph", op_cost_map_proto);
+  EXPECT_TRUE(store.Load("model", 2, "graph").has_value());
+  EXPECT_FALSE(store.Load("model", 1, "graph").has_value());
+  EXPECT_FALSE(store.Load("model", 1, "other_graph").has_value());
+  EXPECT_TRUE(store.Load("other_model", 1, "graph").has_value());
+
+  // The costs of an older version are not saved.
+  store.Save("model", 1, "graph", op_cost_map_proto);
+  EXPECT_FALSE(store.Load("model", 1, "graph").has_value());
+  EXPECT_TRUE(store.Load("model", 2, "graph").has_value());
+}
+
 }  // namespace
 }  // namespace tfrt_stub
 }  // namespace tensorflow
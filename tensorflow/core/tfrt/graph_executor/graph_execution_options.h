@@ -96,6 +96,14 @@ struct GraphExecutionOptions {
     // Number of times to record costs before resetting Op cost estimates.
     // However, a reset always occurs after the first execution.
     int updates_per_interval = 1;
+
+    // Weight, in [0, 1], of the Op cost estimates upon the resets after the
+    // first one. Instead of starting over, the estimates become exponentially
+    // decayed averages of the recorded costs, so that noisy recordings are
+    // smoothed out while the estimates still follow changes of the workload.
+    // A weight of 0 drops the estimates upon reset. The estimates are always
+    // dropped upon the reset after the first execution.
+    double cost_decay = 0.5;
   };
 
   CostAnalysisOptions cost_analysis_options;
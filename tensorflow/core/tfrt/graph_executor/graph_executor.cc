@@ -78,6 +78,7 @@ limitations under the License.
 #include "tensorflow/core/tfrt/common/metrics.h"
 #include "tensorflow/core/tfrt/fallback/cost_recorder.h"
 #include "tensorflow/core/tfrt/fallback/fallback_state.h"
+#include "tensorflow/core/tfrt/fallback/op_cost_map.pb.h"
 #include "tensorflow/core/tfrt/fallback/op_kernel_runner.h"
 #include "tensorflow/core/tfrt/graph_executor/executable_context.h"
 #include "tensorflow/core/tfrt/graph_executor/export_mlir.h"
@@ -1142,6 +1143,16 @@ GraphExecutor::LoadedClientGraph::LoadedClientGraph(
     cost_analysis_data_.is_available = true;
     cost_analysis_data_.num_cost_updates = options.updates_per_interval - 1;
     cost_analysis_data_.cost_recorder = std::make_unique<CostRecorder>();
+    // Start from the costs measured by a previous instance of the model, if it
+    // has been reloaded.
+    if (KeepsCostsAcrossReloads()) {
+      const auto& model_metadata = graph_executor_->options().model_metadata;
+      if (std::optional<OpCostMapProto> op_cost_map =
+              OpCostMapStore::Global().Load(model_metadata.name(),
+                                            model_metadata.version(), name_)) {
+        cost_analysis_data_.cost_recorder->MergeFrom(*op_cost_map);
+      }
+    }
     if (executable_context_->IsForMlrt()) {
       cost_analysis_data_.tf_mlir_with_op_keys =
           std::move(tf_mlir_with_op_keys);
@@ -1159,22 +1170,37 @@ void GraphExecutor::LoadedClientGraph::UpdateCostAnalysisData(
     cost_analysis_data_.is_available = true;
     return;
   }
-  if (graph_executor_->options().cost_analysis_options.version ==
-      Options::CostAnalysisOptions::kOnce) {
+  const auto& options = graph_executor_->options().cost_analysis_options;
+  if (KeepsCostsAcrossReloads()) {
+    const auto& model_metadata = graph_executor_->options().model_metadata;
+    OpCostMapStore::Global().Save(model_metadata.name(),
+                                  model_metadata.version(), name_,
+                                  cost_analysis_data_.cost_recorder->ToProto());
+  }
+  if (options.version == Options::CostAnalysisOptions::kOnce) {
     // Free the cost analysis data if it will not be used again.
     cost_analysis_data_.is_available = false;
     cost_analysis_data_.tfrt_mlir = nullptr;
     cost_analysis_data_.tf_mlir_with_op_keys = nullptr;
     cost_analysis_data_.cost_recorder = nullptr;
   } else {
-    // Update cost analysis data.
-    cost_analysis_data_.cost_recorder = std::make_unique<CostRecorder>();
+    // Update cost analysis data. The costs recorded after the first execution
+    // are dropped, as they include warm-up. Later, they are decayed rather
+    // than dropped, so that the estimates of the next interval build on them.
+    cost_analysis_data_.cost_recorder->Decay(
+        cost_analysis_data_.is_first_interval ? 0.0 : options.cost_decay);
+    cost_analysis_data_.is_first_interval = false;
     cost_analysis_data_.is_available = true;
     cost_analysis_data_.start_time = now;
     cost_analysis_data_.num_cost_updates = 0;
   }
 }
 
+bool GraphExecutor::LoadedClientGraph::KeepsCostsAcrossReloads() const {
+  // Unnamed models can't be told apart across reloads.
+  return !graph_executor_->options().model_metadata.name().empty();
+}
+
 absl::Status GraphExecutor::CompileGraph(
     const std::string& graph_name,
     absl::Span<const std::string> input_tensor_names,
@@ -196,6 +196,10 @@ class GraphExecutor {
     tsl::monitoring::SamplerCell* latency_sampler() { return latency_sampler_; }
 
    private:
+    // Returns true if the op costs of this graph are kept in `OpCostMapStore`
+    // across model reloads.
+    bool KeepsCostsAcrossReloads() const;
+
     std::string name_;
     SymbolUids symbol_uids_;
     GraphExecutor* graph_executor_ = nullptr;
@@ -217,6 +221,8 @@ class GraphExecutor {
       absl::Time start_time TF_GUARDED_BY(mu) = absl::Now();
       // Cost recordings within the current measurement cycle.
       int num_cost_updates TF_GUARDED_BY(mu) = 0;
+      // Whether the current measurement cycle is the first execution.
+      bool is_first_interval TF_GUARDED_BY(mu) = true;
     };
     CostAnalysisData cost_analysis_data_;
 
@@ -16,6 +16,7 @@ limitations under the License.
 
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -25,6 +26,7 @@ limitations under the License.
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "absl/types/span.h"
@@ -47,7 +49,9 @@ limitations under the License.
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/protobuf/rewriter_config.pb.h"
 #include "tensorflow/core/runtime_fallback/kernel/kernel_fallback_compat_request_state.h"
+#include "tensorflow/core/tfrt/fallback/cost_recorder.h"
 #include "tensorflow/core/tfrt/fallback/fallback_state.h"
+#include "tensorflow/core/tfrt/fallback/op_cost_map.pb.h"
 #include "tensorflow/core/tfrt/fallback/op_kernel_runner.h"
 #include "tensorflow/core/tfrt/graph_executor/config.h"
 #include "tensorflow/core/tfrt/graph_executor/graph_execution_options.h"
@@ -352,6 +356,75 @@ TEST_P(GraphExecutorTest, OnlineCostAnalysisPeriodic) {
   EXPECT_EQ(graph_executor->num_recompilations(), 3);
 }
 
+TEST_P(GraphExecutorTest, OnlineCostAnalysisKeepsCostsAcrossReloads) {
+  GraphDef graph_def;
+  TF_ASSERT_OK(GetSimpleGraphDef(graph_def));
+
+  auto runtime = DefaultTfrtRuntime(/*num_threads=*/1);
+  GraphExecutor::Options options(runtime.get());
+  const std::string model_name =
+      absl::StrCat("cost_analysis_reload_test_", GetParam());
+  options.model_metadata.set_name(model_name);
+  options.model_metadata.set_version(1);
+  options.cost_analysis_options.version =
+      GraphExecutionOptions::CostAnalysisOptions::kPeriodic;
+  options.cost_analysis_options.reset_interval = absl::Minutes(10);
+  options.cost_analysis_options.updates_per_interval = 1;
+  options.enable_mlrt = GetParam();
+
+  // The costs saved by a previous instance of the model. The graph is named
+  // after its inputs, outputs and targets.
+  constexpr char kGraphName[] = "input^rank^";
+  constexpr int64_t kSavedOpKey = 1 << 30;
+  OpCostMapProto saved_op_cost_map;
+  (*saved_op_cost_map.mutable_op_cost_map())[kSavedOpKey] = 1000;
+  OpCostMapStore::Global().Save(model_name, /*version=*/1, kGraphName,
+                                saved_op_cost_map);
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto fallback_state,
+      tensorflow::tfrt_stub::FallbackState::Create(
+          CreateDefaultSessionOptions(options), graph_def.library()));
+  auto resource_context = std::make_unique<tfrt::ResourceContext>();
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto graph_executor_base,
+      GraphExecutor::Create(std::move(options), std::move(fallback_state),
+                            std::move(resource_context), graph_def,
+                            GetKernelRegistry()));
+  auto graph_executor = std::unique_ptr<GraphExecutorForTestingCostAnalysis>(
+      static_cast<GraphExecutorForTestingCostAnalysis*>(
+          graph_executor_base.release()));
+
+  // Set input 'x' to [[1, 1, 1]]
+  std::vector<std::pair<std::string, tensorflow::Tensor>> inputs;
+  inputs.push_back({"input", CreateTfTensor<int32_t>(
+                                 /*shape=*/{1, 3}, /*data=*/{1, 1, 1})});
+
+  // The first recompilation uses, and saves, the costs of the previous
+  // instance.
+  std::vector<tensorflow::Tensor> outputs;
+  TF_ASSERT_OK(graph_executor->Run(/*run_options=*/{}, inputs,
+                                   /*output_tensor_names=*/{"rank"},
+                                   /*target_tensor_names=*/{}, &outputs));
+  EXPECT_EQ(graph_executor->num_recompilations(), 1);
+  std::optional<OpCostMapProto> op_cost_map =
+      OpCostMapStore::Global().Load(model_name, /*version=*/1, kGraphName);
+  ASSERT_TRUE(op_cost_map.has_value());
+  EXPECT_TRUE(op_cost_map->op_cost_map().contains(kSavedOpKey));
+
+  // The costs are dropped, not decayed, upon the reset after the first
+  // execution.
+  graph_executor->AdvanceTime(absl::Minutes(10));
+  TF_ASSERT_OK(graph_executor->Run(/*run_options=*/{}, inputs,
+                                   /*output_tensor_names=*/{"rank"},
+                                   /*target_tensor_names=*/{}, &outputs));
+  EXPECT_EQ(graph_executor->num_recompilations(), 2);
+  op_cost_map =
+      OpCostMapStore::Global().Load(model_name, /*version=*/1, kGraphName);
+  ASSERT_TRUE(op_cost_map.has_value());
+  EXPECT_FALSE(op_cost_map->op_cost_map().contains(kSavedOpKey));
+}
+
 REGISTER_OP("TestCancel")
     .Input("x: T")
     .Output("z: T")
@@ -15,15 +15,22 @@ limitations under the License.
 #include "tensorflow/core/util/example_proto_fast_parsing.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <functional>
+#include <memory>
 #include <optional>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "absl/base/casts.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/numeric/bits.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/substitute.h"
+#include "xla/tsl/platform/statusor.h"
 #include "tensorflow/core/example/example.pb.h"
 #include "tensorflow/core/example/feature.pb.h"
 #include "tensorflow/core/framework/allocator.h"
@@ -42,6 +49,10 @@ limitations under the License.
 #include "tensorflow/core/util/presized_cuckoo_map.h"
 #include "tensorflow/core/util/sparse/sparse_tensor.h"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 namespace tensorflow {
 namespace example {
 
@@ -119,6 +130,117 @@ constexpr uint8_t kVarintTag(uint32_t tag) { return (tag << 3) | 0; }
 constexpr uint8_t kDelimitedTag(uint32_t tag) { return (tag << 3) | 2; }
 constexpr uint8_t kFixed32Tag(uint32_t tag) { return (tag << 3) | 5; }
 
+// Returns a pointer to the next `length` bytes of `stream`, or nullptr if they
+// are not all in its current buffer. Streams over a flat array, like the ones
+// created in this file, always have the whole input in their buffer.
+const uint8_t* PeekBytes(protobuf::io::CodedInputStream* stream,
+                         uint32_t length) {
+  DCHECK(stream != nullptr);
+  const void* ptr;
+  int size;
+  if (length == 0 || !stream->GetDirectBufferPointer(&ptr, &size) ||
+      static_cast<uint32_t>(size) < length) {
+    return nullptr;
+  }
+  return static_cast<const uint8_t*>(ptr);
+}
+
+// Packed int64 lists are decoded straight from the input buffer instead of one
+// `ReadVarint64()` call per value. The values of most features (ids, counts,
+// small enums) fit in one byte, so runs of one-byte varints are detected and
+// widened a block at a time: with AVX2 or AVX-512 when the target supports
+// them, and 8 bytes at a time in a 64-bit word otherwise.
+constexpr uint64_t kVarintContinuationBits = 0x8080808080808080ULL;
+
+// Returns the number of varints that end in [begin, end), that is the number
+// of bytes without the continuation bit.
+size_t CountVarints(const uint8_t* begin, const uint8_t* end) {
+  size_t count = 0;
+  const uint8_t* p = begin;
+#if defined(__AVX512BW__)
+  for (; end - p >= 64; p += 64) {
+    const __m512i bytes = _mm512_loadu_si512(p);
+    count += 64 - absl::popcount(
+                      static_cast<uint64_t>(_mm512_movepi8_mask(bytes)));
+  }
+#endif
+#if defined(__AVX2__)
+  for (; end - p >= 32; p += 32) {
+    const __m256i bytes =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    count += 32 - absl::popcount(
+                      static_cast<uint32_t>(_mm256_movemask_epi8(bytes)));
+  }
+#endif
+  for (; end - p >= 8; p += 8) {
+    uint64_t word;
+    std::memcpy(&word, p, sizeof(word));
+    count += 8 - absl::popcount(word & kVarintContinuationBits);
+  }
+  for (; p < end; ++p) {
+    count += (*p & 0x80) == 0;
+  }
+  return count;
+}
+
+// Decodes the varints in [begin, end) into `out`, which must have room for
+// `CountVarints(begin, end)` values. Returns false if the last varint is
+// truncated or if a varint is longer than 10 bytes.
+bool DecodePackedVarints(const uint8_t* begin, const uint8_t* end,
+                         int64_t* out) {
+  const uint8_t* p = begin;
+  while (p < end) {
+#if defined(__AVX2__)
+    if (end - p >= 16) {
+      const __m128i bytes =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+      if (_mm_movemask_epi8(bytes) == 0) {
+#if defined(__AVX512F__)
+        _mm512_storeu_si512(out, _mm512_cvtepu8_epi64(bytes));
+        _mm512_storeu_si512(out + 8,
+                            _mm512_cvtepu8_epi64(_mm_srli_si128(bytes, 8)));
+#else
+        __m256i* out256 = reinterpret_cast<__m256i*>(out);
+        _mm256_storeu_si256(out256, _mm256_cvtepu8_epi64(bytes));
+        _mm256_storeu_si256(out256 + 1,
+                            _mm256_cvtepu8_epi64(_mm_srli_si128(bytes, 4)));
+        _mm256_storeu_si256(out256 + 2,
+                            _mm256_cvtepu8_epi64(_mm_srli_si128(bytes, 8)));
+        _mm256_storeu_si256(out256 + 3,
+                            _mm256_cvtepu8_epi64(_mm_srli_si128(bytes, 12)));
+#endif
+        p += 16;
+        out += 16;
+        continue;
+      }
+    }
+#endif
+    if (end - p >= 8) {
+      uint64_t word;
+      std::memcpy(&word, p, sizeof(word));
+      if ((word & kVarintContinuationBits) == 0) {
+        for (int i = 0; i < 8; ++i) {
+          out[i] = p[i];
+        }
+        p += 8;
+        out += 8;
+        continue;
+      }
+    }
+    uint64_t value = 0;
+    int shift = 0;
+    uint8_t byte;
+    do {
+      if (p == end || shift > 63) return false;
+      byte = *p++;
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      shift += 7;
+    } while (byte & 0x80);
+    *out++ = static_cast<int64_t>(value);
+  }
+  return true;
+}
+
 namespace parsed {
 
 // ParseDataType has to be called first, then appropriate ParseZzzzList.
@@ -313,10 +435,35 @@ class Feature {
         if (!stream.ReadVarint32(&packed_length)) return false;
         auto packed_limit = stream.PushLimit(packed_length);
 
-        while (!stream.ExpectAtEnd()) {
-          protobuf_uint64 n;  // There is no API for int64
-          if (!stream.ReadVarint64(&n)) return false;
-          int64_list->push_back(static_cast<int64_t>(n));
+        // Resizes the output once and decodes all the values in place, unless
+        // they don't fit in a LimitedArraySlice, which is an error that the
+        // caller detects with `EndDistance()`.
+        const uint8_t* packed = PeekBytes(&stream, packed_length);
+        const size_t initial_size = int64_list->size();
+        const size_t num_values =
+            packed != nullptr ? CountVarints(packed, packed + packed_length)
+                              : 0;
+        if (num_values > 0) {
+          int64_list->resize(initial_size + num_values);
+        }
+        if (num_values > 0 &&
+            int64_list->size() == initial_size + num_values) {
+          if (!DecodePackedVarints(packed, packed + packed_length,
+                                   int64_list->data() + initial_size)) {
+            return false;
+          }
+          stream.Skip(packed_length);
+        } else {
+          size_t index = initial_size;
+          while (!stream.ExpectAtEnd()) {
+            protobuf_uint64 n;  // There is no API for int64
+            if (!stream.ReadVarint64(&n)) return false;
+            if (num_values == 0) {
+              int64_list->push_back(static_cast<int64_t>(n));
+            } else if (index < int64_list->size()) {
+              int64_list->data()[index++] = static_cast<int64_t>(n);
+            }
+          }
         }
 
         stream.PopLimit(packed_limit);
@@ -574,6 +721,122 @@ struct SeededHasher {
   uint64_t seed{0xDECAFCAFFE};
 };
 
+}  // namespace
+
+// Maps the feature names of a config to their type and position in the config.
+class FeatureNameIndex {
+ public:
+  static absl::StatusOr<std::shared_ptr<const FeatureNameIndex>> Create(
+      const FastParseExampleConfig& config) {
+    auto index = std::make_shared<FeatureNameIndex>();
+    index->AddNames(Type::Dense, config.dense);
+    index->AddNames(Type::Sparse, config.sparse);
+    index->AddNames(Type::Ragged, config.ragged);
+    TF_RETURN_IF_ERROR(index->Build());
+    return index;
+  }
+
+  // Returns true if `config` has the features the index was created from.
+  bool Matches(const FastParseExampleConfig& config) const {
+    return NamesMatch(Type::Dense, config.dense) &&
+           NamesMatch(Type::Sparse, config.sparse) &&
+           NamesMatch(Type::Ragged, config.ragged);
+  }
+
+  // Looks up the type of `feature_name` and its position `d` in the config.
+  // Returns false if the config has no such feature.
+  bool Find(absl::string_view feature_name, size_t* d, Type* type) const {
+    std::pair<size_t, Type> d_and_type;
+    if (!index_.Find(hasher_(feature_name), &d_and_type)) return false;
+    // Testing for PresizedCuckooMap collision.
+    if (feature_name != names(d_and_type.second)[d_and_type.first]) {
+      return false;
+    }
+    *d = d_and_type.first;
+    *type = d_and_type.second;
+    return true;
+  }
+
+ private:
+  const std::vector<std::string>& names(Type type) const {
+    return names_[static_cast<int>(type)];
+  }
+
+  template <typename Features>
+  void AddNames(Type type, const Features& features) {
+    std::vector<std::string>& names = names_[static_cast<int>(type)];
+    names.reserve(features.size());
+    for (const auto& feature : features) {
+      names.emplace_back(feature.feature_name);
+    }
+  }
+
+  template <typename Features>
+  bool NamesMatch(Type type, const Features& features) const {
+    const std::vector<std::string>& names = this->names(type);
+    if (names.size() != features.size()) return false;
+    for (size_t d = 0; d < names.size(); ++d) {
+      if (absl::string_view(names[d]) !=
+          absl::string_view(features[d].feature_name)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  absl::Status Build() {
+    const size_t size = names(Type::Dense).size() +
+                        names(Type::Sparse).size() +
+                        names(Type::Ragged).size();
+    for (size_t i = 0; i < 1000; ++i) {
+      index_.Clear(size);
+      bool ok = true;
+      for (Type type : {Type::Dense, Type::Sparse, Type::Ragged}) {
+        const std::vector<std::string>& names = this->names(type);
+        for (size_t d = 0; d < names.size(); ++d) {
+          ok &= index_.InsertUnique(hasher_(names[d]), {d, type});
+        }
+      }
+      if (ok) return absl::OkStatus();
+      LOG(WARNING) << "Collision found. This should happen only if you have "
+                      "around 2^32 entries in your config.";
+      hasher_.seed++;
+    }
+    return absl::InternalError(
+        "Could not avoid collision. This should not happen.");
+  }
+
+  std::vector<std::string> names_[3];
+  SeededHasher hasher_;
+  PresizedCuckooMap<std::pair<size_t, Type>> index_{0};
+};
+
+absl::StatusOr<std::shared_ptr<const FeatureNameIndex>> CompileFeatureNameIndex(
+    const FastParseExampleConfig& config) {
+  return FeatureNameIndex::Create(config);
+}
+
+bool HasValidFeatureNameIndex(const FastParseExampleConfig& config) {
+  return config.feature_name_index != nullptr &&
+         config.feature_name_index->Matches(config);
+}
+
+namespace {
+
+// Returns the precompiled index of `config`, or compiles one if it has none.
+absl::StatusOr<std::shared_ptr<const FeatureNameIndex>> GetFeatureNameIndex(
+    const Config& config) {
+  if (config.feature_name_index == nullptr) {
+    return FeatureNameIndex::Create(config);
+  }
+  if (!config.feature_name_index->Matches(config)) {
+    return absl::InvalidArgumentError(
+        "The feature_name_index of the config was compiled for a config with "
+        "different features.");
+  }
+  return config.feature_name_index;
+}
+
 void LogDenseFeatureDataLoss(absl::string_view feature_name) {
   LOG(WARNING) << "Data loss! Feature '" << feature_name
                << "' is present in multiple concatenated "
@@ -599,8 +862,7 @@ void LogSparseFeatureDataLoss(absl::string_view feature_name) {
 absl::Status FastParseSerializedExample(
     const tstring& serialized_example, const tstring& example_name,
     const size_t example_index, const Config& config,
-    const PresizedCuckooMap<std::pair<size_t, Type>>& config_index,
-    SeededHasher hasher, std::vector<Tensor>* output_dense,
+    const FeatureNameIndex& feature_index, std::vector<Tensor>* output_dense,
     std::vector<SparseBuffer>* output_varlen_dense,
     std::vector<SparseBuffer>* output_sparse,
     std::vector<SparseBuffer>* output_ragged,
@@ -636,23 +898,12 @@ absl::Status FastParseSerializedExample(
     const absl::string_view feature_name = name_and_feature.first;
     parsed::Feature& feature = name_and_feature.second;
 
-    std::pair<size_t, Type> d_and_type;
-    uint64_t h = hasher(feature_name);
-    if (!config_index.Find(h, &d_and_type)) continue;
+    size_t d;
+    Type type;
+    if (!feature_index.Find(feature_name, &d, &type)) continue;
 
-    size_t d = d_and_type.first;
-    bool is_dense = d_and_type.second == Type::Dense;
-    bool is_ragged = d_and_type.second == Type::Ragged;
-
-    {
-      // Testing for PresizedCuckooMap collision.
-      // TODO(lew): Use dense_hash_map and avoid this and hasher creation.
-      const tstring& config_feature_name =
-          is_dense ? config.dense[d].feature_name
-                   : (is_ragged ? config.ragged[d].feature_name
-                                : config.sparse[d].feature_name);
-      if (feature_name != config_feature_name) continue;
-    }
+    bool is_dense = type == Type::Dense;
+    bool is_ragged = type == Type::Ragged;
 
     auto example_error = [&](absl::string_view suffix) {
       return absl::InvalidArgumentError(
@@ -1152,36 +1403,8 @@ absl::Status FastParseExample(const Config& config,
     result->feature_stats.resize(serialized.size());
   }
 
-  size_t config_size =
-      config.dense.size() + config.sparse.size() + config.ragged.size();
-  SeededHasher hasher;
-  // Build config index.
-  PresizedCuckooMap<std::pair<size_t, Type>> config_index(config_size);
-  bool ok = true;
-  for (size_t i = 0; i < 1000; ++i) {
-    for (size_t d = 0; d < config.dense.size(); ++d) {
-      ok &= config_index.InsertUnique(hasher(config.dense[d].feature_name),
-                                      {d, Type::Dense});
-    }
-    for (size_t d = 0; d < config.sparse.size(); ++d) {
-      ok &= config_index.InsertUnique(hasher(config.sparse[d].feature_name),
-                                      {d, Type::Sparse});
-    }
-    for (size_t d = 0; d < config.ragged.size(); ++d) {
-      ok &= config_index.InsertUnique(hasher(config.ragged[d].feature_name),
-                                      {d, Type::Ragged});
-    }
-    if (ok) break;
-    LOG(WARNING) << "Collision found. This should happen only if you have "
-                    "around 2^32 entries in your config.";
-    hasher.seed++;
-    config_index.Clear(config_size);
-    ok = true;
-  }
-  if (!ok) {
-    return absl::InternalError(
-        "Could not avoid collision. This should not happen.");
-  }
+  TF_ASSIGN_OR_RETURN(std::shared_ptr<const FeatureNameIndex> feature_index,
+                      GetFeatureNameIndex(config));
 
   // Allocate dense output for fixed length dense values
   // (variable-length dense and sparse and ragged have to be buffered).
@@ -1252,9 +1475,8 @@ absl::Status FastParseExample(const Config& config,
       status_of_minibatch[minibatch] = FastParseSerializedExample(
           serialized[e],
           (!example_names.empty() ? example_names[e] : "<unknown>"), e, config,
-          config_index, hasher, &fixed_dense_values,
-          &varlen_dense_buffers[minibatch], &sparse_buffers[minibatch],
-          &ragged_buffers[minibatch], stats);
+          *feature_index, &fixed_dense_values, &varlen_dense_buffers[minibatch],
+          &sparse_buffers[minibatch], &ragged_buffers[minibatch], stats);
       if (!status_of_minibatch[minibatch].ok()) break;
     }
   };
@@ -1467,37 +1689,8 @@ absl::Status FastParseSingleExample(const Config& config,
     stats = &result->feature_stats.back();
   }
 
-  // TODO(mrry): Cache the construction of this map at Op construction time.
-  size_t config_size =
-      config.dense.size() + config.sparse.size() + config.ragged.size();
-  SeededHasher hasher;
-  // Build config index.
-  PresizedCuckooMap<std::pair<size_t, Type>> config_index(config_size);
-  bool ok = true;
-  for (size_t i = 0; i < 1000; ++i) {
-    for (size_t d = 0; d < config.dense.size(); ++d) {
-      ok &= config_index.InsertUnique(hasher(config.dense[d].feature_name),
-                                      {d, Type::Dense});
-    }
-    for (size_t d = 0; d < config.sparse.size(); ++d) {
-      ok &= config_index.InsertUnique(hasher(config.sparse[d].feature_name),
-                                      {d, Type::Sparse});
-    }
-    for (size_t d = 0; d < config.ragged.size(); ++d) {
-      ok &= config_index.InsertUnique(hasher(config.ragged[d].feature_name),
-                                      {d, Type::Ragged});
-    }
-    if (ok) break;
-    LOG(WARNING) << "Collision found. This should happen only if you have "
-                    "around 2^32 entries in your config.";
-    hasher.seed++;
-    config_index.Clear(config_size);
-    ok = true;
-  }
-  if (!ok) {
-    return absl::InternalError(
-        "Could not avoid collision. This should not happen.");
-  }
+  TF_ASSIGN_OR_RETURN(std::shared_ptr<const FeatureNameIndex> feature_index,
+                      GetFeatureNameIndex(config));
 
   result->sparse_indices.reserve(config.sparse.size());
   result->sparse_values.reserve(config.sparse.size());
@@ -1566,23 +1759,12 @@ absl::Status FastParseSingleExample(const Config& config,
     const absl::string_view feature_name = name_and_feature.first;
     parsed::Feature& feature = name_and_feature.second;
 
-    std::pair<size_t, Type> d_and_type;
-    uint64_t h = hasher(feature_name);
-    if (!config_index.Find(h, &d_and_type)) continue;
-
-    size_t d = d_and_type.first;
-    bool is_dense = d_and_type.second == Type::Dense;
-    bool is_sparse = d_and_type.second == Type::Sparse;
+    size_t d;
+    Type type;
+    if (!feature_index->Find(feature_name, &d, &type)) continue;
 
-    {
-      // Testing for PresizedCuckooMap collision.
-      // TODO(lew): Use dense_hash_map and avoid this and hasher creation.
-      const tstring& config_feature_name =
-          is_dense ? config.dense[d].feature_name
-                   : (is_sparse ? config.sparse[d].feature_name
-                                : config.ragged[d].feature_name);
-      if (feature_name != config_feature_name) continue;
-    }
+    bool is_dense = type == Type::Dense;
+    bool is_sparse = type == Type::Sparse;
 
     auto example_error = [feature_name](absl::string_view suffix) {
       return absl::InvalidArgumentError(
@@ -1953,6 +2135,15 @@ inline int ParseFloatFeature(protobuf::io::CodedInputStream* stream,
         return -1;
       }
       auto packed_limit = stream->PushLimit(packed_length);
+      const uint8_t* packed = PeekBytes(stream, packed_length);
+      if (port::kLittleEndian && packed != nullptr) {
+        if (packed_length % sizeof(float) != 0) return -1;
+        num_elements = packed_length / sizeof(float);
+        if (out != nullptr) {
+          std::memcpy(out, packed, packed_length);
+        }
+        stream->Skip(packed_length);
+      }
       while (!stream->ExpectAtEnd()) {
         uint32_t buffer32;
         if (!stream->ReadLittleEndian32(&buffer32)) {
@@ -2004,6 +2195,17 @@ inline int ParseInt64Feature(protobuf::io::CodedInputStream* stream,
         return -1;
       }
       auto packed_limit = stream->PushLimit(packed_length);
+      const uint8_t* packed = PeekBytes(stream, packed_length);
+      if (packed != nullptr) {
+        const uint8_t* packed_end = packed + packed_length;
+        // A truncated last varint is not counted by `CountVarints()`.
+        if (packed_end[-1] & 0x80) return -1;
+        num_elements = CountVarints(packed, packed_end);
+        if (out != nullptr && !DecodePackedVarints(packed, packed_end, out)) {
+          return -1;
+        }
+        stream->Skip(packed_length);
+      }
       while (!stream->ExpectAtEnd()) {
         protobuf_uint64 n;  // There is no API for int64
         if (!stream->ReadVarint64(&n)) {
@@ -16,11 +16,13 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_UTIL_EXAMPLE_PROTO_FAST_PARSING_H_
 #define TENSORFLOW_CORE_UTIL_EXAMPLE_PROTO_FAST_PARSING_H_
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "absl/status/statusor.h"
 #include "tensorflow/core/example/example.pb.h"
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/graph.pb.h"
@@ -35,6 +37,10 @@ limitations under the License.
 namespace tensorflow {
 namespace example {
 
+// An index of the feature names of a FastParseExampleConfig, used to look up
+// the features of each parsed Example. See `CompileFeatureNameIndex()`.
+class FeatureNameIndex;
+
 // FastParseExampleConfig defines how to parse features in Example.
 // Each sub-config is responsible for one feature identified with feature_name.
 // FastParseExampleConfig can't have two sub-configs with the same feature_name.
@@ -97,8 +103,24 @@ struct FastParseExampleConfig {
   // If `true`, `Result::feature_stats` will contain one
   // `PerExampleFeatureStats` for each serialized example in the input.
   bool collect_feature_stats = false;
+
+  // Optional index of the features above, from `CompileFeatureNameIndex()`.
+  // If null, the index is compiled by every call to `FastParse[Single]Example`.
+  std::shared_ptr<const FeatureNameIndex> feature_name_index;
 };
 
+// Compiles the index of the feature names of `config`. Setting it as the
+// `feature_name_index` of the config lets callers that parse many batches with
+// the same config, like the parsing kernels, hash the feature names once. The
+// index has to be compiled again if features of `config` are added, removed or
+// renamed: parsing with a stale index fails.
+absl::StatusOr<std::shared_ptr<const FeatureNameIndex>> CompileFeatureNameIndex(
+    const FastParseExampleConfig& config);
+
+// Returns true if `config` has a `feature_name_index` compiled from its
+// features.
+bool HasValidFeatureNameIndex(const FastParseExampleConfig& config);
+
 // Statistics about the features in each example passed to
 // `FastParse[Single]Example()`.
 //
@@ -140,7 +162,6 @@ absl::Status FastParseExample(const FastParseExampleConfig& config,
                               absl::Span<const tstring> example_names,
                               thread::ThreadPool* thread_pool, Result* result);
 
-// TODO(mrry): Move the hash table construction into the config object.
 typedef FastParseExampleConfig FastParseSingleExampleConfig;
 
 absl::Status FastParseSingleExample(const FastParseSingleExampleConfig& config,
@@ -16,16 +16,22 @@ limitations under the License.
 #include "tensorflow/core/util/example_proto_fast_parsing.h"
 
 #include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
+#include "xla/tsl/platform/statusor.h"
 #include "tensorflow/core/example/example.pb.h"
 #include "tensorflow/core/example/feature.pb.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/lib/random/philox_random.h"
 #include "tensorflow/core/lib/random/simple_philox.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/platform/protobuf.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/test_benchmark.h"
@@ -619,6 +625,221 @@ TEST(FastParse, OobWriteVulnerabilityMalformedSparseSequenceExample) {
   EXPECT_TRUE(absl::IsInvalidArgument(status));
 }
 
+// Values encoded as varints of every length, with runs of one-byte varints
+// long enough for the vectorized decoding.
+std::vector<int64_t> Int64ValuesOfAllLengths() {
+  std::vector<int64_t> values;
+  for (int64_t i = 0; i < 100; ++i) {
+    values.push_back(i);
+  }
+  for (int shift = 0; shift < 63; shift += 7) {
+    values.push_back(int64_t{1} << shift);
+    values.push_back((int64_t{1} << shift) - 1);
+    values.push_back(-(int64_t{1} << shift));
+  }
+  values.push_back(std::numeric_limits<int64_t>::max());
+  values.push_back(std::numeric_limits<int64_t>::min());
+  for (int64_t i = 0; i < 37; ++i) {
+    values.push_back(i % 2 == 0 ? i : 1000 * i);
+  }
+  return values;
+}
+
+TEST(FastParse, PackedInt64OfAllLengths) {
+  const std::vector<int64_t> values = Int64ValuesOfAllLengths();
+  Example example;
+  auto& features = *example.mutable_features()->mutable_feature();
+  for (int64_t size : {1, 7, 8, 9, 16, 17, 64, 100}) {
+    auto* list = features[absl::StrCat("ids_", size)].mutable_int64_list();
+    for (int64_t i = 0; i < size; ++i) {
+      list->add_value(i);
+    }
+  }
+  for (int64_t value : values) {
+    features["values"].mutable_int64_list()->add_value(value);
+  }
+  TestCorrectness(Serialize(example));
+
+  FastParseExampleConfig config;
+  AddDenseFeature("values", DT_INT64, {-1}, true, 1, &config);
+  AddSparseFeature("ids_17", DT_INT64, &config);
+  const std::vector<tstring> serialized(3, Serialize(example));
+  Result result;
+  TF_ASSERT_OK(FastParseExample(config, serialized, {}, nullptr, &result));
+  for (size_t e = 0; e < serialized.size(); ++e) {
+    for (size_t i = 0; i < values.size(); ++i) {
+      EXPECT_EQ(result.dense_values[0].matrix<int64_t>()(e, i), values[i]);
+    }
+  }
+  ASSERT_EQ(result.sparse_values[0].NumElements(), 3 * 17);
+  for (int64_t i = 0; i < 3 * 17; ++i) {
+    EXPECT_EQ(result.sparse_values[0].vec<int64_t>()(i), i % 17);
+  }
+}
+
+// Returns an Example with an int64 feature "i" whose packed values are
+// `packed`.
+std::string ExampleWithPackedInt64(const std::string& packed) {
+  auto length_delimited = [](char tag, const std::string& value) {
+    return absl::StrCat(std::string(1, tag),
+                        std::string(1, static_cast<char>(value.size())),
+                        value);
+  };
+  const std::string feature =
+      length_delimited('\x1a', length_delimited('\x0a', packed));
+  const std::string map_entry =
+      absl::StrCat("\x0a\x01i", length_delimited('\x12', feature));
+  return length_delimited('\x0a', length_delimited('\x0a', map_entry));
+}
+
+TEST(FastParse, MalformedPackedInt64ReportsError) {
+  FastParseExampleConfig config;
+  AddSparseFeature("i", DT_INT64, &config);
+  const std::string valid(16, '\x01');
+  // The last varint is truncated, or longer than 10 bytes.
+  const std::string truncated = absl::StrCat(valid, "\x81");
+  const std::string too_long =
+      absl::StrCat(valid, std::string(10, '\xff'), "\x01");
+  for (const std::string& packed : {valid, truncated, too_long}) {
+    Example example;
+    EXPECT_EQ(example.ParseFromString(ExampleWithPackedInt64(packed)),
+              packed == valid);
+    const std::vector<tstring> serialized = {ExampleWithPackedInt64(packed)};
+    Result result;
+    EXPECT_EQ(FastParseExample(config, serialized, {}, nullptr, &result).ok(),
+              packed == valid);
+  }
+}
+
+TEST(FastParse, PrecompiledFeatureNameIndex) {
+  const std::vector<tstring> serialized(5, ExampleWithSomeFeatures());
+  FastParseExampleConfig config;
+  AddDenseFeature("float_list", DT_FLOAT, {-1}, true, 1, &config);
+  AddSparseFeature("int64_list", DT_INT64, &config);
+  AddSparseFeature("bytes_list", DT_STRING, &config);
+  EXPECT_FALSE(HasValidFeatureNameIndex(config));
+
+  Result expected;
+  TF_ASSERT_OK(FastParseExample(config, serialized, {}, nullptr, &expected));
+
+  TF_ASSERT_OK_AND_ASSIGN(config.feature_name_index,
+                          CompileFeatureNameIndex(config));
+  EXPECT_TRUE(HasValidFeatureNameIndex(config));
+  for (int i = 0; i < 2; ++i) {
+    Result result;
+    TF_ASSERT_OK(FastParseExample(config, serialized, {}, nullptr, &result));
+    test::ExpectEqual(result.dense_values[0], expected.dense_values[0]);
+    for (int d = 0; d < 2; ++d) {
+      test::ExpectEqual(result.sparse_indices[d], expected.sparse_indices[d]);
+    }
+    test::ExpectEqual(result.sparse_values[0], expected.sparse_values[0]);
+    test::ExpectEqual(result.sparse_values[1], expected.sparse_values[1]);
+  }
+
+  Result single_result;
+  TF_ASSERT_OK(FastParseSingleExample(config, serialized[0], &single_result));
+  test::ExpectEqual(single_result.sparse_values[0],
+                    expected.sparse_values[0].Slice(0, 3));
+
+  // The index is stale once a feature is renamed.
+  config.sparse[1].feature_name = "renamed";
+  EXPECT_FALSE(HasValidFeatureNameIndex(config));
+  Result result;
+  EXPECT_TRUE(absl::IsInvalidArgument(
+      FastParseExample(config, serialized, {}, nullptr, &result)));
+}
+
+// An Example shaped like the ones of ranking and recommendation models: many
+// id features of a few mostly small values, a few dense float features and a
+// few string features.
+std::string RealisticExample(random::SimplePhilox* rng) {
+  Example example;
+  auto& features = *example.mutable_features()->mutable_feature();
+  for (int i = 0; i < 32; ++i) {
+    auto* list = features[absl::StrCat("id_", i)].mutable_int64_list();
+    const int64_t num_values = 1 + rng->Uniform(24);
+    const int64_t max_value = i % 4 == 0 ? int64_t{1} << 40 : 128;
+    for (int64_t v = 0; v < num_values; ++v) {
+      list->add_value(rng->Uniform64(max_value));
+    }
+  }
+  for (int i = 0; i < 8; ++i) {
+    auto* list = features[absl::StrCat("dense_", i)].mutable_float_list();
+    for (int v = 0; v < 16; ++v) {
+      list->add_value(rng->RandFloat());
+    }
+  }
+  for (int i = 0; i < 4; ++i) {
+    features[absl::StrCat("string_", i)].mutable_bytes_list()->add_value(
+        RandStr(rng));
+  }
+  return Serialize(example);
+}
+
+void BM_FastParseRealisticExample(::testing::benchmark::State& state) {
+  const bool precompile_index = state.range(0);
+  random::PhiloxRandom philox(42);
+  random::SimplePhilox rng(&philox);
+  std::vector<tstring> serialized;
+  for (int i = 0; i < 128; ++i) {
+    serialized.emplace_back(RealisticExample(&rng));
+  }
+
+  FastParseExampleConfig config;
+  for (int i = 0; i < 32; ++i) {
+    config.sparse.emplace_back(absl::StrCat("id_", i), DT_INT64);
+  }
+  for (int i = 0; i < 8; ++i) {
+    config.dense.emplace_back(absl::StrCat("dense_", i), DT_FLOAT,
+                              PartialTensorShape({16}),
+                              Tensor(DT_FLOAT, TensorShape({})), false, 16);
+  }
+  for (int i = 0; i < 4; ++i) {
+    config.sparse.emplace_back(absl::StrCat("string_", i), DT_STRING);
+  }
+  if (precompile_index) {
+    auto feature_name_index = CompileFeatureNameIndex(config);
+    TF_CHECK_OK(feature_name_index.status());
+    config.feature_name_index = *std::move(feature_name_index);
+  }
+
+  for (auto s : state) {
+    Result result;
+    TF_CHECK_OK(FastParseExample(config, serialized, {}, nullptr, &result));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          serialized.size());
+}
+BENCHMARK(BM_FastParseRealisticExample)->Arg(0)->Arg(1);
+
+void BM_FastParsePackedInt64(::testing::benchmark::State& state) {
+  const int64_t num_values = state.range(0);
+  const int64_t max_value = state.range(1);
+  random::PhiloxRandom philox(42);
+  random::SimplePhilox rng(&philox);
+  Example example;
+  auto* list = (*example.mutable_features()->mutable_feature())["ids"]
+                   .mutable_int64_list();
+  for (int64_t v = 0; v < num_values; ++v) {
+    list->add_value(rng.Uniform64(max_value));
+  }
+  const std::vector<tstring> serialized(64, Serialize(example));
+  FastParseExampleConfig config;
+  AddSparseFeature("ids", DT_INT64, &config);
+
+  for (auto s : state) {
+    Result result;
+    TF_CHECK_OK(FastParseExample(config, serialized, {}, nullptr, &result));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          serialized.size() * num_values);
+}
+BENCHMARK(BM_FastParsePackedInt64)
+    ->ArgPair(16, 128)
+    ->ArgPair(256, 128)
+    ->ArgPair(256, int64_t{1} << 20)
+    ->ArgPair(256, int64_t{1} << 40);
+
 }  // namespace
 }  // namespace example
 }  // namespace tensorflow
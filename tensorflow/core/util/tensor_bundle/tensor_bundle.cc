@@ -53,6 +53,7 @@ limitations under the License.
 #include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/saved_tensor_slice_util.h"
 #include "tensorflow/core/util/tensor_bundle/byte_swap_tensor.h"
+#include "tensorflow/core/util/tensor_bundle/mapped_tensor_buffer.h"
 #include "tensorflow/core/util/tensor_bundle/naming.h"
 #include "tensorflow/core/util/tensor_slice_util.h"
 
@@ -407,6 +408,16 @@ absl::Status CorruptFileError(const absl::Status& in_status,
                       detail, "): ", in_status.message()));
 }
 
+absl::Status ChecksumMismatchError(absl::string_view prefix,
+                                   const BundleEntryProto& entry,
+                                   uint32_t actual_crc32c) {
+  return absl::DataLossError(absl::StrCat(
+      "TensorBundle at ", prefix, " shard ", entry.shard_id(), " (",
+      entry.size(), " bytes): Checksum does not match: stored ",
+      absl::StrFormat("%08u", crc32c::Unmask(entry.crc32c())),
+      " vs. calculated on the restored bytes ", actual_crc32c));
+}
+
 table::Options TableBuilderOptions() {
   table::Options o;
   // Compressed tables cannot be read by TensorFlow releases prior to 1.1.
@@ -438,14 +449,17 @@ absl::Status PadAlignment(tsl::BufferedWritableFile* out, int alignment,
 
 BundleWriter::BundleWriter(Env* env, absl::string_view prefix,
                            const Options& options)
-    : env_(env), options_(options), prefix_(prefix), out_(nullptr), size_(0) {
+    : env_(env), options_(options), prefix_(prefix) {
+  if (options_.num_shards < 1) {
+    status_ = absl::InvalidArgumentError(absl::StrCat(
+        "BundleWriter num_shards must be >= 1, got ", options_.num_shards));
+    return;
+  }
   status_ = env_->HasAtomicMove(prefix_, &use_temp_file_);
   if (!status_.ok()) return;
 
-  data_path_ = DataFilename(prefix_, 0, 1);
   metadata_path_ = MetaFilename(prefix_);
   if (use_temp_file_) {
-    data_path_ = absl::StrCat(data_path_, ".tempstate", random::New64());
     metadata_path_ =
         absl::StrCat(metadata_path_, ".tempstate", random::New64());
   }
@@ -454,14 +468,27 @@ BundleWriter::BundleWriter(Env* env, absl::string_view prefix,
   if (!status_.ok() && !absl::IsAlreadyExists(status_)) {
     return;
   }
-
-  std::unique_ptr<WritableFile> wrapper;
-  status_ = env_->NewWritableFile(data_path_, &wrapper);
-  if (!status_.ok()) return;
-  out_ = std::make_unique<tsl::BufferedWritableFile>(
-      std::move(wrapper), 8 << 20 /* 8MB write buffer */);
-
-  VLOG(1) << "Writing to file " << data_path_;
+  status_ = absl::OkStatus();
+
+  for (int i = 0; i < options_.num_shards; ++i) {
+    auto shard = std::make_unique<Shard>();
+    shard->data_path = DataFilename(prefix_, i, options_.num_shards);
+    if (use_temp_file_) {
+      shard->data_path =
+          absl::StrCat(shard->data_path, ".tempstate", random::New64());
+    }
+    std::unique_ptr<WritableFile> wrapper;
+    status_ = env_->NewWritableFile(shard->data_path, &wrapper);
+    if (!status_.ok()) return;
+    shard->out = std::make_unique<tsl::BufferedWritableFile>(
+        std::move(wrapper), 8 << 20 /* 8MB write buffer */);
+    if (options_.num_shards > 1) {
+      shard->writer = std::make_unique<thread::ThreadPool>(
+          env_, "bundle_writer_shard", /*num_threads=*/1);
+    }
+    VLOG(1) << "Writing to file " << shard->data_path;
+    shards_.push_back(std::move(shard));
+  }
 }
 
 absl::Status BundleWriter::Add(absl::string_view key, const Tensor& val) {
@@ -477,29 +504,54 @@ absl::Status BundleWriter::Add(absl::string_view key, const Tensor& val) {
   BundleEntryProto* entry = &entries_[key_string];
   entry->set_dtype(val.dtype());
   val.shape().AsProto(entry->mutable_shape());
-  entry->set_shard_id(0);
-  entry->set_offset(size_);
+
+  // Picks the shard with the fewest bytes added so far.
+  int shard_id = 0;
+  for (int i = 1; i < shards_.size(); ++i) {
+    if (shards_[i]->added_bytes < shards_[shard_id]->added_bytes) {
+      shard_id = i;
+    }
+  }
+  Shard* shard = shards_[shard_id].get();
+  shard->added_bytes += val.TotalBytes();
+  entry->set_shard_id(shard_id);
+
+  if (shard->writer == nullptr) {
+    status_ = WriteToShard(val, shard, entry);
+    return status_;
+  }
+  shard->writer->Schedule([this, val, shard, entry] {
+    if (shard->status.ok()) {
+      shard->status = WriteToShard(val, shard, entry);
+    }
+  });
+  return absl::OkStatus();
+}
+
+absl::Status BundleWriter::WriteToShard(const Tensor& val, Shard* shard,
+                                        BundleEntryProto* entry) {
+  entry->set_offset(shard->size);
 
   // Updates the data file.
   size_t data_bytes_written = 0;
   uint32_t crc32c = 0;
-  out_->reset_crc32();
+  tsl::BufferedWritableFile* out = shard->out.get();
+  out->reset_crc32();
   if (val.dtype() == DT_STRING) {
-    status_ = WriteStringTensor(val, out_.get(), &data_bytes_written, &crc32c);
+    TF_RETURN_IF_ERROR(
+        WriteStringTensor(val, out, &data_bytes_written, &crc32c));
   } else if (val.dtype() == DT_VARIANT) {
-    status_ = WriteVariantTensor(val, out_.get(), &data_bytes_written, &crc32c);
+    TF_RETURN_IF_ERROR(
+        WriteVariantTensor(val, out, &data_bytes_written, &crc32c));
   } else {
-    status_ = WriteTensor(val, out_.get(), &data_bytes_written);
-    crc32c = out_->crc32();
+    TF_RETURN_IF_ERROR(WriteTensor(val, out, &data_bytes_written));
+    crc32c = out->crc32();
   }
 
-  if (status_.ok()) {
-    entry->set_size(data_bytes_written);
-    entry->set_crc32c(crc32c::Mask(crc32c));
-    size_ += data_bytes_written;
-    status_ = PadAlignment(out_.get(), options_.data_alignment, &size_);
-  }
-  return status_;
+  entry->set_size(data_bytes_written);
+  entry->set_crc32c(crc32c::Mask(crc32c));
+  shard->size += data_bytes_written;
+  return PadAlignment(out, options_.data_alignment, &shard->size);
 }
 
 absl::Status BundleWriter::AddSlice(absl::string_view full_tensor_key,
@@ -546,18 +598,29 @@ absl::Status BundleWriter::AddSlice(absl::string_view full_tensor_key,
 // TODO(zongheng): on metadata write failure or !status_.ok(), consider removing
 // the orphaned data file.
 absl::Status BundleWriter::Finish() {
-  if (out_) {
-    status_.Update(out_->Close());
-    out_ = nullptr;
+  // Waits for the pending writes of all shards before closing any of them.
+  for (auto& shard : shards_) {
+    shard->writer.reset();
+  }
+  for (auto& shard : shards_) {
+    if (shard->out) {
+      status_.Update(shard->status);
+      status_.Update(shard->out->Close());
+      shard->out = nullptr;
+    }
+  }
+  for (int i = 0; i < shards_.size(); ++i) {
+    const std::string& data_path = shards_[i]->data_path;
     if (status_.ok()) {
       if (use_temp_file_) {
-        status_ =
-            Env::Default()->RenameFile(data_path_, DataFilename(prefix_, 0, 1));
+        status_ = Env::Default()->RenameFile(
+            data_path, DataFilename(prefix_, i, shards_.size()));
       }
     } else {
-      Env::Default()->DeleteFile(data_path_).IgnoreError();
+      Env::Default()->DeleteFile(data_path).IgnoreError();
     }
   }
+  shards_.clear();
   if (!status_.ok()) return status_;
   // Build key -> BundleEntryProto table.
   std::unique_ptr<WritableFile> file;
@@ -571,7 +634,7 @@ absl::Status BundleWriter::Finish() {
     table::TableBuilder builder(options, file.get());
     // Header entry.
     BundleHeaderProto header;
-    header.set_num_shards(1);
+    header.set_num_shards(options_.num_shards);
     header.set_endianness(BundleHeaderProto::LITTLE);
     if (!port::kLittleEndian) header.set_endianness(BundleHeaderProto::BIG);
     VersionDef* version = header.mutable_version();
@@ -796,6 +859,7 @@ BundleReader::BundleReader(Env* env, absl::string_view prefix, Options options)
       table_(nullptr),
       index_cache_(nullptr),
       iter_(nullptr),
+      use_mmap_(options.use_mmap),
       need_to_swap_bytes_(false),
       enable_multi_threading_for_testing_(
           options.enable_multi_threading_for_testing) {
@@ -804,6 +868,12 @@ BundleReader::BundleReader(Env* env, absl::string_view prefix, Options options)
     owned_cache_ = std::make_unique<BundleCache>(env);
     cache_ = owned_cache_.get();
   }
+  if (!use_mmap_) {
+    bool use_mmap = false;
+    absl::Status s =
+        ReadBoolFromEnvVar("TF_BUNDLE_READER_USE_MMAP", false, &use_mmap);
+    use_mmap_ = s.ok() && use_mmap;
+  }
 
   const std::string filename = MetaFilename(prefix_);
   uint64_t file_size;
@@ -892,8 +962,80 @@ absl::Status BundleReader::GetBundleEntryProto(absl::string_view key,
   return absl::OkStatus();
 }
 
+std::shared_ptr<ReadOnlyMemoryRegion> BundleReader::GetMappedDataFile(
+    int32_t shard_id) {
+  auto it = mapped_data_.find(shard_id);
+  if (it == mapped_data_.end()) {
+    const std::string filename = DataFilename(prefix_, shard_id, num_shards_);
+    std::unique_ptr<ReadOnlyMemoryRegion> region;
+    absl::Status s = env_->NewReadOnlyMemoryRegionFromFile(filename, &region);
+    if (!s.ok()) {
+      // Not all file systems support memory mapping; such shards are read.
+      VLOG(1) << "Reading " << filename << " instead of memory mapping it: "
+              << s;
+      region = nullptr;
+    }
+    it = mapped_data_.emplace(shard_id, std::move(region)).first;
+  }
+  return it->second;
+}
+
+absl::Status BundleReader::GetMappedValue(
+    const BundleEntryProto& entry, std::shared_ptr<ReadOnlyMemoryRegion> region,
+    Tensor* val) {
+  const TensorShape shape =
+      val->NumElements() == 0 ? TensorShape(entry.shape()) : val->shape();
+  const int64_t expected_size =
+      shape.num_elements() * DataTypeSize(entry.dtype());
+  if (entry.size() != expected_size) {
+    return absl::DataLossError(absl::StrCat(
+        "Invalid size in bundle entry: key ", key(), "; stored size ",
+        entry.size(), "; expected size ", expected_size));
+  }
+  if (entry.offset() < 0 || entry.size() > region->length() ||
+      entry.offset() > region->length() - entry.size()) {
+    return absl::DataLossError(absl::StrCat(
+        "TensorBundle at ", prefix_, " shard ", entry.shard_id(), " (",
+        region->length(), " bytes) is too short for a tensor of ",
+        entry.size(), " bytes at offset ", entry.offset()));
+  }
+
+  const char* data =
+      static_cast<const char*>(region->data()) + entry.offset();
+  const uint32_t actual_crc32c = crc32c::Value(data, entry.size());
+  if (crc32c::Unmask(entry.crc32c()) != actual_crc32c) {
+    return ChecksumMismatchError(prefix_, entry, actual_crc32c);
+  }
+
+  if (!need_to_swap_bytes_ && entry.size() > 0 &&
+      reinterpret_cast<uintptr_t>(data) % EIGEN_MAX_ALIGN_BYTES == 0) {
+    *val = Tensor(entry.dtype(), shape,
+                  core::RefCountPtr<TensorBuffer>(new MappedTensorBuffer(
+                      std::move(region), data, entry.size())));
+    return absl::OkStatus();
+  }
+
+  Tensor ret = val->NumElements() == 0 ? Tensor(entry.dtype(), shape) : *val;
+  if (entry.size() > 0) {
+    memcpy(GetBackingBuffer(ret), data, entry.size());
+  }
+  if (need_to_swap_bytes_) {
+    TF_RETURN_IF_ERROR(ByteSwapTensor(&ret));
+  }
+  *val = std::move(ret);
+  return absl::OkStatus();
+}
+
 absl::Status BundleReader::GetValue(const BundleEntryProto& entry,
                                     Tensor* val) {
+  if (use_mmap_ && DataTypeCanUseMemcpy(entry.dtype())) {
+    std::shared_ptr<ReadOnlyMemoryRegion> region =
+        GetMappedDataFile(entry.shard_id());
+    if (region != nullptr) {
+      return GetMappedValue(entry, std::move(region), val);
+    }
+  }
+
   Tensor* ret = val;
   const TensorShape stored_shape(TensorShape(entry.shape()));
   if (val->NumElements() == 0) {
@@ -1024,11 +1166,7 @@ absl::Status BundleReader::GetValue(const BundleEntryProto& entry,
         GetStringBackingBuffer(*ret), &actual_crc32c, need_to_swap_bytes_));
   }
   if (crc32c::Unmask(entry.crc32c()) != actual_crc32c) {
-    return absl::DataLossError(absl::StrCat(
-        "TensorBundle at ", prefix_, " shard ", entry.shard_id(), " (",
-        entry.size(), " bytes): Checksum does not match: stored ",
-        absl::StrFormat("%08u", crc32c::Unmask(entry.crc32c())),
-        " vs. calculated on the restored bytes ", actual_crc32c));
+    return ChecksumMismatchError(prefix_, entry, actual_crc32c);
   }
 
   *val = *ret;
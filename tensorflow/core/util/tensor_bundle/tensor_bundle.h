@@ -81,6 +81,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/tensor_slice.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/array_slice.h"
 #include "tensorflow/core/lib/io/cache.h"
 #include "tensorflow/core/lib/io/inputbuffer.h"
@@ -123,12 +124,22 @@ class BundleWriter {
     // Alignment, in bytes, for tensor data.
     // Must be >= 1. The default size of 1 densely packs tensors.
     int data_alignment{1};
+
+    // Number of data files the tensors are spread over, balancing their
+    // sizes. Must be >= 1.
+    //
+    // With more than one data file, each file is written and checksummed by
+    // its own thread, and Add() returns before the tensor is written: the
+    // tensor's buffer must not be modified until Finish() returns, and write
+    // errors are reported by Finish().
+    int num_shards{1};
   };
   BundleWriter(Env* env, absl::string_view prefix,
                const Options& options = Options());
 
   // Adds the tensor "val" under key "key".
   // Across calls "key" must be unique but can be added in any order.
+  // See Options::num_shards for when "val" is written.
   absl::Status Add(absl::string_view key, const Tensor& val);
 
   // Partitioned variables support.
@@ -158,15 +169,36 @@ class BundleWriter {
   absl::Status status() const { return status_; }
 
  private:
+  // A data file being written.
+  struct Shard {
+    std::string data_path;
+    std::unique_ptr<tsl::BufferedWritableFile> out;
+    int64_t size = 0;  // Number of bytes written into out.
+    absl::Status status;
+
+    // Bytes of the tensors added to this shard, for balancing.
+    int64_t added_bytes = 0;
+
+    // Writes the tensors added to this shard in order, or null if they are
+    // written by Add() itself. Accesses to the fields above happen on this
+    // thread only until Finish() joins it.
+    std::unique_ptr<thread::ThreadPool> writer;
+  };
+
+  // Appends "val" to "shard", aligned, and fills in the offset, size and
+  // checksum of "entry".
+  absl::Status WriteToShard(const Tensor& val, Shard* shard,
+                            BundleEntryProto* entry);
+
   Env* const env_;  // Not owned.
   const Options options_;
   const std::string prefix_;
   std::string metadata_path_;
-  std::string data_path_;
   bool use_temp_file_;
-  std::unique_ptr<tsl::BufferedWritableFile> out_;
-  int64_t size_;  // Number of bytes written into out_.
   std::map<std::string, BundleEntryProto> entries_;
+  // Declared after entries_, which the shard writers update, so that they are
+  // joined first.
+  std::vector<std::unique_ptr<Shard>> shards_;
   absl::Status status_;
 
   BundleWriter(const BundleWriter&) = delete;
@@ -215,6 +247,20 @@ class BundleReader {
     // supplied, a BundleCache private to the BundleReader is used.
     BundleCache* cache = nullptr;
 
+    // If true, data files that the Env can memory map (e.g. local files) are
+    // mapped instead of read. Numeric tensors whose data is aligned to
+    // EIGEN_MAX_ALIGN_BYTES in the mapping are then restored without a copy:
+    // the returned Tensor aliases the mapped pages and keeps the mapping alive.
+    // Other tensors are copied out of the mapping. Write the bundle with
+    // BundleWriter::Options::data_alignment set to a multiple of
+    // EIGEN_MAX_ALIGN_BYTES to make all numeric tensors aliasable.
+    //
+    // Aliased tensors are backed by a read-only mapping and must not be
+    // mutated in place, so this is meant for restoring models for inference.
+    // Can also be enabled with the TF_BUNDLE_READER_USE_MMAP environment
+    // variable.
+    bool use_mmap = false;
+
     // For tests only.
     bool enable_multi_threading_for_testing = false;
   };
@@ -264,6 +310,9 @@ class BundleReader {
   // On error, "val" may contain nonsense data.  Returns a NotFound error if
   // tensor keyed by "key" does not exist in this bundle.
   //
+  // With Options::use_mmap, "val" may instead be replaced by a tensor of the
+  // same shape that aliases the memory mapped data file.
+  //
   // Validates the stored crc32c checksum against the restored bytes.
   // REQUIRES: status().ok()
   absl::Status Lookup(absl::string_view key, Tensor* val);
@@ -323,6 +372,15 @@ class BundleReader {
   // Usage for "val" follows the comment of "Lookup()".
   absl::Status GetValue(const BundleEntryProto& entry, Tensor* val);
 
+  // Returns the memory mapped data file of shard "shard_id", or nullptr if
+  // the file system does not support memory mapping it.
+  std::shared_ptr<ReadOnlyMemoryRegion> GetMappedDataFile(int32_t shard_id);
+
+  // Like GetValue(), for a tensor that can be memcpy'd stored in "region".
+  absl::Status GetMappedValue(const BundleEntryProto& entry,
+                              std::shared_ptr<ReadOnlyMemoryRegion> region,
+                              Tensor* val);
+
   // Reads the slice described by "slice_spec".  The corresponding full tensor
   // has key "ful_tensor_key" and metadata proto "full_tensor_entry".
   // REQUIRES: full_tensor_entry.slices_size() > 0
@@ -344,6 +402,12 @@ class BundleReader {
   // Owned InputBuffer objects. cache_ owns the underlying RandomAccessFiles.
   std::unordered_map<int32_t, io::InputBuffer*> data_;
 
+  // Memory mapped data files, or nullptr for shards that cannot be mapped.
+  // Shared with the tensors aliasing them. Only used with Options::use_mmap.
+  bool use_mmap_;
+  std::unordered_map<int32_t, std::shared_ptr<ReadOnlyMemoryRegion>>
+      mapped_data_;
+
   // Maps each partitioned tensor's key to its stored slices (represented in a
   // TensorSliceSet).  Populated on-demand.
   std::unordered_map<std::string, checkpoint::TensorSliceSet*> tensor_slices_;
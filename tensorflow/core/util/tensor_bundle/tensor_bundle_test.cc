@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
 
+#include <algorithm>
 #include <random>
 #include <string>
 #include <vector>
@@ -23,9 +24,16 @@ limitations under the License.
 #include <windows.h>
 #endif  // _WIN32
 
+#if defined(__linux__)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif  // __linux__
+
 #include "absl/status/status.h"
+#include "absl/strings/numbers.h"
 #include "xla/tsl/platform/errors.h"
 #include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/framework/tensor_description.pb.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/framework/tensor_util.h"
 #include "tensorflow/core/framework/types.pb.h"
@@ -1026,6 +1034,63 @@ TEST(TensorBundleTest, DirectoryStructure) {
                           "merged.data-00001-of-00002"});
 }
 
+TEST(TensorBundleTest, ShardedWriter) {
+  Env* env = Env::Default();
+  BundleWriter::Options opts;
+  opts.num_shards = 3;
+  opts.data_alignment = 8;
+  {
+    BundleWriter writer(env, Prefix("sharded"), opts);
+    for (int i = 0; i < 10; ++i) {
+      TF_EXPECT_OK(writer.Add(absl::StrCat("float", i),
+                              Constant_100x100<float>(i)));
+    }
+    TF_EXPECT_OK(writer.Add("string", test::AsTensor<tstring>({"a", "bc"})));
+    TF_EXPECT_OK(writer.AddSlice("part", TensorShape({4, 3}),
+                                 TensorSlice::ParseOrDie("0,2:-"),
+                                 Constant_2x3<double>(1.0)));
+    TF_EXPECT_OK(writer.AddSlice("part", TensorShape({4, 3}),
+                                 TensorSlice::ParseOrDie("2,2:-"),
+                                 Constant_2x3<double>(2.0)));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  for (int i = 0; i < opts.num_shards; ++i) {
+    TF_EXPECT_OK(env->FileExists(DataFilename(Prefix("sharded"), i, 3)));
+  }
+
+  auto ExpectContents = [](const std::string& prefix) {
+    BundleReader reader(Env::Default(), prefix);
+    TF_ASSERT_OK(reader.status());
+    for (int i = 0; i < 10; ++i) {
+      Expect<float>(&reader, absl::StrCat("float", i),
+                    Constant_100x100<float>(i));
+    }
+    Expect<tstring>(&reader, "string", test::AsTensor<tstring>({"a", "bc"}));
+    Tensor part(DT_DOUBLE, TensorShape({4, 3}));
+    TF_ASSERT_OK(reader.Lookup("part", &part));
+    test::ExpectTensorEqual<double>(
+        part, test::AsTensor<double>({1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2},
+                                     TensorShape({4, 3})));
+  };
+  ExpectContents(Prefix("sharded"));
+
+  // Merging renames the shards along with those of the other bundle.
+  {
+    BundleWriter writer(env, Prefix("sharded_other"));
+    TF_EXPECT_OK(writer.Add("other", Constant_2x3<float>(5)));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  TF_ASSERT_OK(MergeBundles(
+      env, {Prefix("sharded"), Prefix("sharded_other")}, Prefix("merged")));
+  for (int i = 0; i < 4; ++i) {
+    TF_EXPECT_OK(env->FileExists(DataFilename(Prefix("merged"), i, 4)));
+  }
+  ExpectContents(Prefix("merged"));
+  BundleReader reader(env, Prefix("merged"));
+  TF_ASSERT_OK(reader.status());
+  Expect<float>(&reader, "other", Constant_2x3<float>(5));
+}
+
 TEST(TensorBundleTest, SortForSequentialAccess) {
   Env* env = Env::Default();
   const std::vector<std::string> kBundlePrefixes = {Prefix("worker0"),
@@ -1267,6 +1332,88 @@ absl::Status CreateFile(Env* env, const std::string& fname) {
   return file->Close();
 }
 
+static bool IsMemoryMapped(const Tensor& t) {
+  TensorDescription description;
+  t.FillDescription(&description);
+  return description.allocation_description().allocator_name() == "mmap";
+}
+
+TEST(TensorBundleTest, MmapAliasesAlignedTensors) {
+  {
+    BundleWriter::Options opts;
+    opts.data_alignment = EIGEN_MAX_ALIGN_BYTES;
+    BundleWriter writer(Env::Default(), Prefix("mmap_aligned"), opts);
+    TF_EXPECT_OK(writer.Add("bool", Constant(true, TensorShape({3}))));
+    TF_EXPECT_OK(writer.Add("float", Constant_100x100<float>(1.5)));
+    TF_EXPECT_OK(writer.Add("int64", Constant_2x3<int64_t>(7)));
+    TF_EXPECT_OK(writer.Add("string", test::AsTensor<tstring>({"a", "bc"})));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  Tensor float_val;
+  {
+    BundleReader::Options options;
+    options.use_mmap = true;
+    BundleReader reader(Env::Default(), Prefix("mmap_aligned"), options);
+    TF_ASSERT_OK(reader.status());
+    Expect<bool>(&reader, "bool", Constant(true, TensorShape({3})));
+    Expect<int64_t>(&reader, "int64", Constant_2x3<int64_t>(7));
+    Expect<tstring>(&reader, "string", test::AsTensor<tstring>({"a", "bc"}));
+
+    TF_ASSERT_OK(reader.Lookup("float", &float_val));
+    EXPECT_TRUE(IsMemoryMapped(float_val));
+    Tensor int64_val;
+    TF_ASSERT_OK(reader.Lookup("int64", &int64_val));
+    EXPECT_TRUE(IsMemoryMapped(int64_val));
+    Tensor string_val;
+    TF_ASSERT_OK(reader.Lookup("string", &string_val));
+    EXPECT_FALSE(IsMemoryMapped(string_val));
+  }
+  // The mapping outlives the reader.
+  test::ExpectTensorEqual<float>(float_val, Constant_100x100<float>(1.5));
+}
+
+TEST(TensorBundleTest, MmapCopiesUnalignedTensors) {
+  {
+    BundleWriter writer(Env::Default(), Prefix("mmap_unaligned"));
+    TF_EXPECT_OK(writer.Add("a_bool", Constant(true, TensorShape({1}))));
+    TF_EXPECT_OK(writer.Add("b_float", Constant_2x3<float>(2.5)));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  BundleReader::Options options;
+  options.use_mmap = true;
+  BundleReader reader(Env::Default(), Prefix("mmap_unaligned"), options);
+  TF_ASSERT_OK(reader.status());
+  Expect<float>(&reader, "b_float", Constant_2x3<float>(2.5));
+  Tensor val;
+  TF_ASSERT_OK(reader.Lookup("b_float", &val));
+  EXPECT_FALSE(IsMemoryMapped(val));
+  test::ExpectTensorEqual<float>(val, Constant_2x3<float>(2.5));
+}
+
+TEST(TensorBundleTest, MmapChecksum) {
+  {
+    BundleWriter::Options opts;
+    opts.data_alignment = EIGEN_MAX_ALIGN_BYTES;
+    BundleWriter writer(Env::Default(), Prefix("mmap_checksum"), opts);
+    TF_EXPECT_OK(writer.Add("foo", Constant_2x3<float>(1.f)));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  const std::string datafile = DataFilename(Prefix("mmap_checksum"), 0, 1);
+  std::string data;
+  TF_ASSERT_OK(ReadFileToString(Env::Default(), datafile, &data));
+  data[1] = ~data[1];
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), datafile, data));
+
+  BundleReader::Options options;
+  options.use_mmap = true;
+  BundleReader reader(Env::Default(), Prefix("mmap_checksum"), options);
+  TF_ASSERT_OK(reader.status());
+  Tensor val;
+  absl::Status status = reader.Lookup("foo", &val);
+  EXPECT_TRUE(absl::IsDataLoss(status));
+  EXPECT_TRUE(absl::StrContains(status.ToString(), "Checksum does not match"));
+}
+
 TEST(BundleCacheTest, SameFile) {
   Env* env = Env::Default();
   BundleCache cache(env);
@@ -1432,4 +1579,102 @@ static void BM_BundleWriterLargeTensor(::testing::benchmark::State& state) {
 BENCHMARK(BM_BundleWriterLargeTensor)->Arg(1 << 10);
 BENCHMARK(BM_BundleWriterLargeTensor)->Arg(4 << 10);
 
+static void BM_BundleWriterShardedLargeTensors(
+    ::testing::benchmark::State& state) {
+  const int num_shards = state.range(0);
+  // 32 tensors of 32 MiB.
+  std::vector<Tensor> tensors(32, Constant(static_cast<int8_t>('a'),
+                                           TensorShape{32 << 20}));
+  BundleWriter::Options opts;
+  opts.num_shards = num_shards;
+  for (auto s : state) {
+    BundleWriter writer(Env::Default(), Prefix("sharded_bench"), opts);
+    for (int i = 0; i < tensors.size(); ++i) {
+      TF_CHECK_OK(writer.Add(absl::StrCat("big", i), tensors[i]));
+    }
+    TF_CHECK_OK(writer.Finish());
+  }
+  state.SetBytesProcessed(state.iterations() * tensors.size() * (32 << 20));
+}
+
+BENCHMARK(BM_BundleWriterShardedLargeTensors)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime();
+
+// Anonymous (not file backed) resident memory of the process, in bytes.
+static int64_t AnonymousRssBytes() {
+#if defined(__linux__)
+  std::string statm;
+  if (!ReadFileToString(Env::Default(), "/proc/self/statm", &statm).ok()) {
+    return 0;
+  }
+  std::vector<std::string> fields = str_util::Split(statm, ' ');
+  int64_t resident = 0, shared = 0;
+  if (fields.size() < 3 || !absl::SimpleAtoi(fields[1], &resident) ||
+      !absl::SimpleAtoi(fields[2], &shared)) {
+    return 0;
+  }
+  return (resident - shared) * getpagesize();
+#else
+  return 0;
+#endif  // __linux__
+}
+
+// Restores a bundle of state.range(1) MiB in 16 MiB tensors and runs a
+// stand-in for the first inference on it, with (state.range(0) == 1) or
+// without memory mapping.
+static void BM_BundleRestoreToFirstInference(
+    ::testing::benchmark::State& state) {
+  const bool use_mmap = state.range(0);
+  const int num_tensors = state.range(1) / 16;
+  {
+    BundleWriter::Options opts;
+    opts.data_alignment = EIGEN_MAX_ALIGN_BYTES;
+    BundleWriter writer(Env::Default(), Prefix("restore"), opts);
+    for (int i = 0; i < num_tensors; ++i) {
+      TF_CHECK_OK(writer.Add(absl::StrCat("weights_", i),
+                             Constant(1.0f, TensorShape({4 << 20}))));
+    }
+    TF_CHECK_OK(writer.Finish());
+  }
+
+  int64_t max_rss_growth = 0;
+  for (auto s : state) {
+    const int64_t rss_before = AnonymousRssBytes();
+    BundleReader::Options options;
+    options.use_mmap = use_mmap;
+    BundleReader reader(Env::Default(), Prefix("restore"), options);
+    TF_CHECK_OK(reader.status());
+    std::vector<Tensor> weights(num_tensors);
+    for (int i = 0; i < num_tensors; ++i) {
+      TF_CHECK_OK(reader.Lookup(absl::StrCat("weights_", i), &weights[i]));
+    }
+    float sum = 0;
+    for (const Tensor& t : weights) {
+      sum += t.flat<float>()(0);
+    }
+    testing::DoNotOptimize(sum);
+    max_rss_growth =
+        std::max(max_rss_growth, AnonymousRssBytes() - rss_before);
+  }
+  state.counters["anon_rss_growth_mb"] =
+      static_cast<double>(max_rss_growth) / (1 << 20);
+#if defined(__linux__)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    // ru_maxrss is in KiB, and is the peak of the whole process.
+    state.counters["peak_rss_mb"] = usage.ru_maxrss / 1024.0;
+  }
+#endif  // __linux__
+}
+
+BENCHMARK(BM_BundleRestoreToFirstInference)
+    ->ArgPair(0, 256)
+    ->ArgPair(1, 256)
+    ->ArgPair(0, 1024)
+    ->ArgPair(1, 1024);
+
 }  // namespace tensorflow
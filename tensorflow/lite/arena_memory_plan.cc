@@ -0,0 +1,152 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/arena_memory_plan.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tflite {
+namespace {
+
+// We serialize unsigneds as protobuf varints, i.e., in chunks of 7 bits each.
+constexpr int kMod = (1 << 7);
+
+void Serialize(std::string* out, uint64_t value) {
+  for (; value >= kMod; value /= kMod) {
+    out->push_back(value % kMod + kMod);
+  }
+  out->push_back(value);
+}
+
+bool Parse(const char** data, size_t* size, uint64_t* out) {
+  *out = 0;
+  for (int shift = 0;; shift += 7) {
+    if (*size == 0 || shift >= 64) {
+      return false;
+    }
+    const unsigned char byte = static_cast<unsigned char>(**data);
+    ++*data;
+    --*size;
+    *out |= static_cast<uint64_t>(byte % kMod) << shift;
+    if (!(byte & kMod)) {
+      return true;
+    }
+  }
+}
+
+// Signed ints are zigzag-encoded as unsigned varints, [..., -2, -1, 0, 1, 2,
+// ...] -> [..., 3, 1, 0, 2, 4, ...].
+void Serialize(std::string* out, int32_t value) {
+  Serialize(out, static_cast<uint64_t>(
+                     value < 0 ? static_cast<uint32_t>(-(value + 1)) * 2ULL + 1
+                               : static_cast<uint32_t>(value) * 2ULL));
+}
+
+bool Parse(const char** data, size_t* size, int32_t* out) {
+  uint64_t value = 0;
+  if (!Parse(data, size, &value) || value > UINT32_MAX) {
+    return false;
+  }
+  const int32_t magnitude = static_cast<int32_t>(value / 2);
+  *out = (value % 2) ? (-magnitude - 1) : magnitude;
+  return true;
+}
+
+void Serialize(std::string* out, const ArenaTensorAllocation& in) {
+  Serialize(out, in.tensor);
+  Serialize(out, in.offset);
+  Serialize(out, in.size);
+  Serialize(out, in.first_node);
+  Serialize(out, in.last_node);
+}
+
+bool Parse(const char** data, size_t* size, ArenaTensorAllocation* out) {
+  return Parse(data, size, &out->tensor) && Parse(data, size, &out->offset) &&
+         Parse(data, size, &out->size) && Parse(data, size, &out->first_node) &&
+         Parse(data, size, &out->last_node);
+}
+
+void Serialize(std::string* out, const ArenaMemoryPlan& in);
+bool Parse(const char** data, size_t* size, ArenaMemoryPlan* out);
+
+// Vectors are serialized as the concatenation of the serialization of their
+// size and the serializations of their elements.
+template <class Value>
+void Serialize(std::string* out, const std::vector<Value>& in) {
+  Serialize(out, static_cast<uint64_t>(in.size()));
+  for (const auto& val : in) {
+    Serialize(out, val);
+  }
+}
+
+template <class T>
+bool Parse(const char** data, size_t* size, std::vector<T>* out) {
+  uint64_t num_elems = 0;
+  // Every element takes at least one byte, which bounds the allocation below.
+  if (!Parse(data, size, &num_elems) || num_elems > *size) {
+    return false;
+  }
+  out->assign(num_elems, T{});
+  for (auto& elem : *out) {
+    if (!Parse(data, size, &elem)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void Serialize(std::string* out, const ArenaMemoryPlan& in) {
+  Serialize(out, in.subgraph_index);
+  Serialize(out, in.input_shapes);
+  Serialize(out, in.allocations);
+}
+
+bool Parse(const char** data, size_t* size, ArenaMemoryPlan* out) {
+  return Parse(data, size, &out->subgraph_index) &&
+         Parse(data, size, &out->input_shapes) &&
+         Parse(data, size, &out->allocations);
+}
+
+}  // namespace
+
+size_t GetArenaSize(const ArenaMemoryPlan& plan) {
+  size_t arena_size = 0;
+  for (const ArenaTensorAllocation& allocation : plan.allocations) {
+    arena_size = std::max<size_t>(arena_size,
+                                  allocation.offset + allocation.size);
+  }
+  return arena_size;
+}
+
+std::string SerializeArenaMemoryPlans(const ModelArenaMemoryPlans& in) {
+  std::string out;
+  Serialize(&out, static_cast<uint64_t>(kArenaMemoryPlanMetadataVersion));
+  Serialize(&out, in);
+  return out;
+}
+
+bool ParseArenaMemoryPlans(const char* data, size_t size,
+                           ModelArenaMemoryPlans* out) {
+  out->clear();
+  uint64_t version = 0;
+  return Parse(&data, &size, &version) &&
+         (version == kArenaMemoryPlanMetadataVersion) &&
+         Parse(&data, &size, out) && (size == 0);
+}
+
+}  // namespace tflite
@@ -0,0 +1,75 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_ARENA_MEMORY_PLAN_H_
+#define TENSORFLOW_LITE_ARENA_MEMORY_PLAN_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tflite {
+
+/// The placement of a tensor in the non-persistent arena of a subgraph, and
+/// the interval of execution plan indices in which the tensor is live.
+struct ArenaTensorAllocation {
+  int32_t tensor = -1;
+  uint64_t offset = 0;
+  uint64_t size = 0;
+  int32_t first_node = 0;
+  int32_t last_node = 0;
+};
+
+/// The placement of the tensors in the non-persistent arena of a subgraph,
+/// computed ahead of time for the given shapes of the subgraph inputs.
+///
+/// The `ArenaPlanner` adopts the placement of a tensor instead of searching
+/// for one when the tensor fits in it and is live in a sub-interval of its
+/// planned interval. Tensors that don't are placed by the greedy search.
+struct ArenaMemoryPlan {
+  int32_t subgraph_index = 0;
+  /// The shapes of the subgraph inputs, in order, for which the plan holds.
+  std::vector<std::vector<int32_t>> input_shapes;
+  std::vector<ArenaTensorAllocation> allocations;
+};
+
+/// The memory plans of the subgraphs of a model, for any number of input
+/// shapes per subgraph.
+using ModelArenaMemoryPlans = std::vector<ArenaMemoryPlan>;
+
+/// Returns the size of the arena needed by `plan`.
+size_t GetArenaSize(const ArenaMemoryPlan& plan);
+
+/// Serializes `in` into the returned string. The result is parseable with
+/// ParseArenaMemoryPlans.
+std::string SerializeArenaMemoryPlans(const ModelArenaMemoryPlans& in);
+
+/// Deserializes `*out` from a character buffer of size `size` at `data`.
+/// Returns true iff successful. When returning false, `*out`'s state is
+/// undefined.
+bool ParseArenaMemoryPlans(const char* data, size_t size,
+                           ModelArenaMemoryPlans* out);
+
+/// The key under which to store the serialized memory plans in the model's
+/// metadata.
+constexpr char kArenaMemoryPlanMetadataKey[] = "arena_memory_plan";
+
+/// To allow future changes to the format, serialized memory plans contain a
+/// version; this constant is the version that will be used for serialization.
+constexpr uint32_t kArenaMemoryPlanMetadataVersion = 1;
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_ARENA_MEMORY_PLAN_H_
@@ -0,0 +1,104 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/arena_memory_plan.h"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace tflite {
+namespace {
+
+ModelArenaMemoryPlans MakePlans() {
+  ArenaMemoryPlan first;
+  first.subgraph_index = 0;
+  first.input_shapes = {{1, 224, 224, 3}, {}};
+  first.allocations = {{/*tensor=*/0, /*offset=*/0, /*size=*/602112, 0, 3},
+                       {/*tensor=*/7, /*offset=*/602112, /*size=*/64, 1,
+                        std::numeric_limits<int32_t>::max()}};
+  ArenaMemoryPlan second;
+  second.subgraph_index = 2;
+  second.input_shapes = {{-1, 5}};
+  second.allocations = {
+      {/*tensor=*/3, /*offset=*/uint64_t{1} << 40, /*size=*/128, 0, 0}};
+  return {first, second, ArenaMemoryPlan()};
+}
+
+void ExpectEqual(const ModelArenaMemoryPlans& a,
+                 const ModelArenaMemoryPlans& b) {
+  ASSERT_EQ(a.size(), b.size());
+  for (int i = 0; i < a.size(); ++i) {
+    EXPECT_EQ(a[i].subgraph_index, b[i].subgraph_index);
+    EXPECT_EQ(a[i].input_shapes, b[i].input_shapes);
+    ASSERT_EQ(a[i].allocations.size(), b[i].allocations.size());
+    for (int j = 0; j < a[i].allocations.size(); ++j) {
+      const ArenaTensorAllocation& x = a[i].allocations[j];
+      const ArenaTensorAllocation& y = b[i].allocations[j];
+      EXPECT_EQ(x.tensor, y.tensor);
+      EXPECT_EQ(x.offset, y.offset);
+      EXPECT_EQ(x.size, y.size);
+      EXPECT_EQ(x.first_node, y.first_node);
+      EXPECT_EQ(x.last_node, y.last_node);
+    }
+  }
+}
+
+TEST(ArenaMemoryPlanTest, SerializesAndParses) {
+  const ModelArenaMemoryPlans plans = MakePlans();
+  const std::string serialized = SerializeArenaMemoryPlans(plans);
+  ModelArenaMemoryPlans parsed;
+  ASSERT_TRUE(
+      ParseArenaMemoryPlans(serialized.data(), serialized.size(), &parsed));
+  ExpectEqual(plans, parsed);
+}
+
+TEST(ArenaMemoryPlanTest, RejectsTruncatedOrTrailingData) {
+  const std::string serialized = SerializeArenaMemoryPlans(MakePlans());
+  ModelArenaMemoryPlans parsed;
+  for (int size = 0; size < serialized.size(); ++size) {
+    EXPECT_FALSE(ParseArenaMemoryPlans(serialized.data(), size, &parsed))
+        << size;
+  }
+  const std::string trailing = serialized + '\0';
+  EXPECT_FALSE(
+      ParseArenaMemoryPlans(trailing.data(), trailing.size(), &parsed));
+}
+
+TEST(ArenaMemoryPlanTest, RejectsOtherVersions) {
+  std::string serialized = SerializeArenaMemoryPlans(MakePlans());
+  serialized[0] = kArenaMemoryPlanMetadataVersion + 1;
+  ModelArenaMemoryPlans parsed;
+  EXPECT_FALSE(
+      ParseArenaMemoryPlans(serialized.data(), serialized.size(), &parsed));
+}
+
+TEST(ArenaMemoryPlanTest, RejectsHugeCounts) {
+  // A version followed by a plan count that exceeds the data.
+  const std::string serialized = {'\x01', '\xff', '\xff', '\xff', '\x0f'};
+  ModelArenaMemoryPlans parsed;
+  EXPECT_FALSE(
+      ParseArenaMemoryPlans(serialized.data(), serialized.size(), &parsed));
+}
+
+TEST(ArenaMemoryPlanTest, GetArenaSize) {
+  const ModelArenaMemoryPlans plans = MakePlans();
+  EXPECT_EQ(GetArenaSize(plans[0]), 602112 + 64);
+  EXPECT_EQ(GetArenaSize(plans[2]), 0);
+}
+
+}  // namespace
+}  // namespace tflite
@@ -71,9 +71,66 @@ TfLiteStatus ArenaPlanner::ResetAllocations() {
   // all allocs to be cleared. if this is not set, the slow path is taken
   // (Purge) which inspects each alloc. Both paths give the exact same result.
   last_active_node_ = kLastActiveNodeUndefined;
+  SelectArenaMemoryPlan();
   return kTfLiteOk;
 }
 
+void ArenaPlanner::SelectArenaMemoryPlan() {
+  planned_allocs_.clear();
+  if (memory_plans_.empty()) {
+    return;
+  }
+  const std::vector<int>& inputs = graph_info_->inputs();
+  const TfLiteTensor* tensors = graph_info_->tensors();
+  auto shapes_match = [&](const ArenaMemoryPlan& plan) {
+    if (plan.input_shapes.size() != inputs.size()) {
+      return false;
+    }
+    for (int i = 0; i < static_cast<int>(inputs.size()); ++i) {
+      const TfLiteIntArray* dims =
+          inputs[i] < 0 ? nullptr : tensors[inputs[i]].dims;
+      const std::vector<int32_t>& shape = plan.input_shapes[i];
+      if (dims == nullptr ? !shape.empty()
+                          : !TfLiteIntArrayEqualsArray(
+                                dims, static_cast<int>(shape.size()),
+                                shape.data())) {
+        return false;
+      }
+    }
+    return true;
+  };
+  for (const ArenaMemoryPlan& plan : memory_plans_) {
+    if (!shapes_match(plan)) {
+      continue;
+    }
+    planned_allocs_.assign(graph_info_->num_tensors(), nullptr);
+    for (const ArenaTensorAllocation& allocation : plan.allocations) {
+      if (allocation.tensor >= 0 &&
+          allocation.tensor < static_cast<int32_t>(planned_allocs_.size())) {
+        planned_allocs_[allocation.tensor] = &allocation;
+      }
+    }
+    return;
+  }
+}
+
+const ArenaTensorAllocation* ArenaPlanner::GetPlannedAllocation(
+    int32_t tensor_index) const {
+  if (tensor_index >= static_cast<int32_t>(planned_allocs_.size())) {
+    return nullptr;
+  }
+  const ArenaTensorAllocation* allocation = planned_allocs_[tensor_index];
+  // The planned placement is only known to be free of conflicts within the
+  // planned usage interval.
+  if (allocation == nullptr ||
+      allocation->size < graph_info_->tensors()[tensor_index].bytes ||
+      allocation->first_node > alloc_node_[tensor_index] ||
+      allocation->last_node < dealloc_node_[tensor_index]) {
+    return nullptr;
+  }
+  return allocation;
+}
+
 TfLiteStatus ArenaPlanner::ResetAllocationsAfter(int node) {
   TfLiteTensor* tensors = graph_info_->tensors();
   for (int i = 0; i < static_cast<int>(allocs_.size()); ++i) {
@@ -428,6 +485,35 @@ void ArenaPlanner::GetAllocInfo(size_t* arena_size,
   *arena_persist_size = persistent_arena_.GetBufferSize();
 }
 
+TfLiteStatus ArenaPlanner::GetArenaMemoryPlan(ArenaMemoryPlan* plan) const {
+  TF_LITE_ENSURE(context_, plan != nullptr);
+  plan->input_shapes.clear();
+  plan->allocations.clear();
+  const TfLiteTensor* tensors = graph_info_->tensors();
+  for (int input : graph_info_->inputs()) {
+    const TfLiteIntArray* dims = input < 0 ? nullptr : tensors[input].dims;
+    plan->input_shapes.emplace_back();
+    if (dims != nullptr) {
+      plan->input_shapes.back().assign(dims->data, dims->data + dims->size);
+    }
+  }
+  for (int i = 0; i < static_cast<int>(allocs_.size()); ++i) {
+    const ArenaAllocWithUsageInterval& alloc = allocs_[i];
+    if (tensors[i].allocation_type != kTfLiteArenaRw || alloc.size == 0 ||
+        alloc.tensor != i) {
+      continue;
+    }
+    ArenaTensorAllocation allocation;
+    allocation.tensor = i;
+    allocation.offset = alloc.offset;
+    allocation.size = alloc.size;
+    allocation.first_node = alloc.first_node;
+    allocation.last_node = alloc.last_node;
+    plan->allocations.push_back(allocation);
+  }
+  return kTfLiteOk;
+}
+
 TfLiteStatus ArenaPlanner::Commit(bool* reallocated) {
   bool arena_reallocated, persistent_arena_reallocated;
   TF_LITE_ENSURE_STATUS(arena_.Commit(&arena_reallocated));
@@ -518,6 +604,15 @@ TfLiteStatus ArenaPlanner::CalculateAllocations(
     arena_.PurgeActiveAllocs(first_node);
   }
   CreateTensorAllocationVector(tensors_allocated);
+  if (!planned_allocs_.empty()) {
+    // Place the planned tensors first, so that the greedy search for the
+    // others works around them.
+    std::stable_partition(tensors_allocated->begin(), tensors_allocated->end(),
+                          [&](int32_t tensor_index) {
+                            return GetPlannedAllocation(tensor_index) !=
+                                   nullptr;
+                          });
+  }
   // Vector of ids of already allocated tensors, ordered by offset.
   for (const auto& tensor_index : *tensors_allocated) {
     TfLiteTensor& tensor = tensors[tensor_index];
@@ -541,6 +636,17 @@ TfLiteStatus ArenaPlanner::CalculateAllocations(
       }
     }
     if (tensor.allocation_type == kTfLiteArenaRw) {
+      const ArenaTensorAllocation* planned =
+          GetPlannedAllocation(tensor_index);
+      // The planned offset may be taken if an earlier allocation fell back to
+      // the greedy search, in which case this one does too.
+      if (planned != nullptr &&
+          arena_.AllocateAt(tensor_alignment_, planned->offset, tensor.bytes,
+                            tensor_index, alloc_node_[tensor_index],
+                            dealloc_node_[tensor_index],
+                            &allocs_[tensor_index])) {
+        continue;
+      }
       TF_LITE_ENSURE_STATUS(
           arena_.Allocate(context_, tensor_alignment_, tensor.bytes,
                           tensor_index, alloc_node_[tensor_index],
@@ -20,8 +20,10 @@ limitations under the License.
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
+#include "tensorflow/lite/arena_memory_plan.h"
 #include "tensorflow/lite/core/c/common.h"
 #include "tensorflow/lite/graph_info.h"
 #include "tensorflow/lite/memory_planner.h"
@@ -68,6 +70,15 @@ class ArenaPlanner : public MemoryPlanner {
   void DumpDebugInfo(const std::vector<int>& execution_plan) const override;
   void GetAllocInfo(size_t* arena_size,
                     size_t* arena_persist_size) const override;
+  TfLiteStatus GetArenaMemoryPlan(ArenaMemoryPlan* plan) const override;
+
+  // Sets the memory plans computed ahead of time for this subgraph. On every
+  // ResetAllocations(), the plan whose input shapes match the current shapes
+  // of the graph inputs, if any, is used to place the non-persistent tensors.
+  void SetArenaMemoryPlans(std::vector<ArenaMemoryPlan> plans) {
+    memory_plans_ = std::move(plans);
+    planned_allocs_.clear();
+  }
 
   // Returns the base arena location for a given allocation type.
   std::intptr_t BasePointer(TfLiteAllocationType type);
@@ -120,6 +131,14 @@ class ArenaPlanner : public MemoryPlanner {
   // Return the index of the tensor owing `tensor_index's` buffer.
   int FindSharedTensor(int tensor_index);
 
+  // Selects the memory plan matching the current shapes of the graph inputs
+  // and indexes its allocations by tensor in `planned_allocs_`.
+  void SelectArenaMemoryPlan();
+
+  // Returns the planned allocation for `tensor_index` if the tensor can be
+  // placed as planned, otherwise nullptr.
+  const ArenaTensorAllocation* GetPlannedAllocation(int32_t tensor_index) const;
+
   TfLiteContext* context_;
   std::unique_ptr<GraphInfo> graph_info_;
 
@@ -166,6 +185,12 @@ class ArenaPlanner : public MemoryPlanner {
 
   // Store number of references to each tensor.
   std::vector<int> refcounts_;
+
+  // Memory plans computed ahead of time, see SetArenaMemoryPlans().
+  std::vector<ArenaMemoryPlan> memory_plans_;
+
+  // Planned allocation of each tensor in the selected plan, or nullptr.
+  std::vector<const ArenaTensorAllocation*> planned_allocs_;
 };
 
 }  // namespace tflite
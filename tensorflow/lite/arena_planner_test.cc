@@ -247,6 +247,17 @@ class ArenaPlannerTest : public ::testing::Test {
 
   void Destroy() { planner_.reset(); }
 
+  void SetArenaMemoryPlans(std::vector<ArenaMemoryPlan> plans) {
+    planner_->SetArenaMemoryPlans(std::move(plans));
+    CHECK(planner_->ResetAllocations() == kTfLiteOk);
+  }
+
+  ArenaMemoryPlan GetArenaMemoryPlan() {
+    ArenaMemoryPlan plan;
+    CHECK(planner_->GetArenaMemoryPlan(&plan) == kTfLiteOk);
+    return plan;
+  }
+
   // Returns the actual offset of a given tensor, relative to the start of its
   // arena.
   std::ptrdiff_t GetOffset(int tensor_index) {
@@ -1101,6 +1112,93 @@ TEST_F(ArenaPlannerTest, DebugTensorsInputReuse) {
   EXPECT_NE(GetOffset(4), GetOffset(5));
 }
 
+TEST_F(ArenaPlannerTest, ExportsArenaMemoryPlan) {
+  TestGraph graph({0, 1},
+                  {
+                      /* in, out, tmp */
+                      {{0, 1}, {2}, {}},     // First op
+                      {{2, 0}, {4, 5}, {}},  // Second op
+                      {{4, 5}, {3}, {}}      // Third op
+                  },
+                  {3});
+  SetGraph(&graph);
+  Execute(0, graph.nodes().size() - 1);
+
+  const ArenaMemoryPlan plan = GetArenaMemoryPlan();
+  EXPECT_EQ(plan.input_shapes.size(), 2);
+  ASSERT_EQ(plan.allocations.size(), 6);
+  for (const ArenaTensorAllocation& allocation : plan.allocations) {
+    EXPECT_EQ(allocation.offset, GetOffset(allocation.tensor));
+    EXPECT_EQ(allocation.size, (*graph.tensors())[allocation.tensor].bytes);
+  }
+}
+
+TEST_F(ArenaPlannerTest, AdoptsArenaMemoryPlan) {
+  TestGraph graph({0, 1},
+                  {
+                      /* in, out, tmp */
+                      {{0, 1}, {2}, {}},     // First op
+                      {{2, 0}, {4, 5}, {}},  // Second op
+                      {{4, 5}, {3}, {}}      // Third op
+                  },
+                  {3});
+  SetGraph(&graph);
+  Execute(0, graph.nodes().size() - 1);
+
+  // Give every tensor its own region of the arena, which the greedy search
+  // wouldn't do.
+  ArenaMemoryPlan plan = GetArenaMemoryPlan();
+  size_t offset = 0;
+  for (ArenaTensorAllocation& allocation : plan.allocations) {
+    allocation.offset = offset;
+    offset += allocation.size + kTensorAlignment - 1;
+    offset -= offset % kTensorAlignment;
+  }
+
+  SetGraph(&graph);
+  SetArenaMemoryPlans({plan});
+  Execute(0, graph.nodes().size() - 1);
+  for (const ArenaTensorAllocation& allocation : plan.allocations) {
+    EXPECT_EQ(GetOffset(allocation.tensor), allocation.offset);
+  }
+}
+
+TEST_F(ArenaPlannerTest, IgnoresArenaMemoryPlanForOtherInputShapes) {
+  TestGraph graph({0, 1}, {{{0, 1}, {2}, {}}}, {2});
+  SetGraph(&graph);
+  Execute(0, graph.nodes().size() - 1);
+  const std::ptrdiff_t offset = GetOffset(2);
+
+  ArenaMemoryPlan plan = GetArenaMemoryPlan();
+  plan.input_shapes = {{1}, {2}};
+  for (ArenaTensorAllocation& allocation : plan.allocations) {
+    allocation.offset += 64;
+  }
+  SetGraph(&graph);
+  SetArenaMemoryPlans({plan});
+  Execute(0, graph.nodes().size() - 1);
+  EXPECT_EQ(GetOffset(2), offset);
+}
+
+TEST_F(ArenaPlannerTest, ConflictingArenaMemoryPlanFallsBackToGreedy) {
+  TestGraph graph({0, 1}, {{{0, 1}, {2}, {}}}, {2});
+  SetGraph(&graph);
+  Execute(0, graph.nodes().size() - 1);
+
+  // Place all tensors at the start of the arena, although they are live at
+  // the same time.
+  ArenaMemoryPlan plan = GetArenaMemoryPlan();
+  for (ArenaTensorAllocation& allocation : plan.allocations) {
+    allocation.offset = 0;
+  }
+  SetGraph(&graph);
+  SetArenaMemoryPlans({plan});
+  Execute(0, graph.nodes().size() - 1);
+  EXPECT_EQ(GetOffset(0), 0);
+  EXPECT_GE(GetOffset(1), GetOffsetAfter(0));
+  EXPECT_GE(GetOffset(2), GetOffsetAfter(1));
+}
+
 TEST_F(ArenaPlannerTest, SimpleProfilerTest) {
   gNumAlloc = 0;
   gNumDealloc = 0;
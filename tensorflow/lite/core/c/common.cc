@@ -192,18 +192,6 @@ TfLiteSparsity TfLiteSparsityClone(const TfLiteSparsity& src) {
   return dst;
 }
 
-// Clones the source sparsity to a newly allocated object.
-TfLiteSparsity* TfLiteSparsityClone(const TfLiteSparsity* const src) {
-  if (!src) {
-    return nullptr;
-  }
-  TfLiteSparsity* dst =
-      reinterpret_cast<TfLiteSparsity*>(calloc(1, sizeof(TfLiteSparsity)));
-  if (!dst) return nullptr;
-  *dst = TfLiteSparsityClone(*src);
-  return dst;
-}
-
 #endif  // TF_LITE_STATIC_MEMORY
 
 }  // namespace
@@ -233,6 +221,18 @@ TfLiteAllocator* SetCurrentTfLiteAllocator(TfLiteAllocator* allocator) {
 
 #ifndef TF_LITE_STATIC_MEMORY
 
+// Clones the source sparsity to a newly allocated object.
+TfLiteSparsity* TfLiteSparsityClone(const TfLiteSparsity* const src) {
+  if (!src) {
+    return nullptr;
+  }
+  TfLiteSparsity* dst =
+      reinterpret_cast<TfLiteSparsity*>(calloc(1, sizeof(TfLiteSparsity)));
+  if (!dst) return nullptr;
+  *dst = TfLiteSparsityClone(*src);
+  return dst;
+}
+
 TfLiteQuantization TfLiteQuantizationClone(const TfLiteQuantization& src) {
   TfLiteQuantization dst;
   dst.type = src.type;
@@ -1729,5 +1729,9 @@ TfLiteStatus TfLiteTensorVariantRealloc(TfLiteTensor* t,
 // Returns a copy of the quantization parameters of the tensor.
 TfLiteQuantization TfLiteQuantizationClone(const TfLiteQuantization& src);
 
+// Returns a newly allocated copy of the sparsity parameters of the tensor, or
+// null if `src` is null. The copy is freed with `TfLiteSparsityFree`.
+TfLiteSparsity* TfLiteSparsityClone(const TfLiteSparsity* src);
+
 #endif  // __cplusplus
 #endif  // TENSORFLOW_LITE_CORE_C_COMMON_H_
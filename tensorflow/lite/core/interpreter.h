@@ -871,6 +871,29 @@ class Interpreter {
   /// \brief Apply InterpreterOptions which tunes behavior of the interpreter.
   TfLiteStatus ApplyOptions(InterpreterOptions* options);
 
+  /// \warning This is an experimental API and subject to change. \n
+  /// \brief Creates an execution context of this interpreter: an interpreter
+  /// that runs the same model and can be invoked concurrently with this one
+  /// and with the other execution contexts, each from a single thread.
+  ///
+  /// The execution context shares the read-only state of the model with this
+  /// interpreter: the model allocation, the constant tensor buffers and the
+  /// custom op init data. It owns the rest: its tensors, the state of its
+  /// kernels and its memory arena, which is planned when `AllocateTensors` is
+  /// called on it. This interpreter must outlive its execution contexts.
+  ///
+  /// The execution context has the subgraphs, signatures, metadata, options
+  /// and number of threads of this interpreter, and the current shapes of its
+  /// tensors. Delegates applied to this interpreter, including the default
+  /// ones, are not applied to the execution context: apply them with
+  /// `ModifyGraphWithDelegate` on each context. Delegate instances can not be
+  /// shared between contexts, but their caches can: e.g. XNNPack delegates
+  /// created with the same `weight_cache_provider` pack the weights of the
+  /// model once, since the contexts keep the buffer identifiers of the
+  /// constant tensors.
+  TfLiteStatus CreateExecutionContext(
+      std::unique_ptr<Interpreter>* execution_context) const;
+
 #ifndef DOXYGEN_SKIP
   /// \warning This is an experimental API and subject to change. \n
   /// \brief Return the number of subgraphs in the model.
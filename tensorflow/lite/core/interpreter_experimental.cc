@@ -158,6 +158,30 @@ TfLiteStatus Interpreter::ApplyOptions(InterpreterOptions* options) {
   return ApplyOptionsImpl(options);
 }
 
+TfLiteStatus Interpreter::CreateExecutionContext(
+    std::unique_ptr<Interpreter>* execution_context) const {
+  TF_LITE_ENSURE(context_, execution_context != nullptr);
+  auto interpreter = std::make_unique<Interpreter>(error_reporter_);
+  if (allocator_ != nullptr) {
+    TF_LITE_ENSURE_STATUS(interpreter->SetAllocator(allocator_));
+  }
+  interpreter->AddSubgraphs(subgraphs_.size() - 1);
+  TF_LITE_ENSURE_STATUS(interpreter->ApplyOptionsImpl(options_.get()));
+  for (size_t i = 0; i < subgraphs_.size(); ++i) {
+    TF_LITE_ENSURE_STATUS(
+        interpreter->subgraphs_[i]->CopyGraphFrom(*subgraphs_[i]));
+  }
+  interpreter->signature_defs_ = signature_defs_;
+  TF_LITE_ENSURE_STATUS(interpreter->SetMetadata(metadata_));
+  TF_LITE_ENSURE_STATUS(
+      interpreter->SetNumThreads(context_->recommended_num_threads));
+  if (cancellation_enabled_) {
+    TF_LITE_ENSURE_STATUS(interpreter->EnableCancellation());
+  }
+  *execution_context = std::move(interpreter);
+  return kTfLiteOk;
+}
+
 async::AsyncSignatureRunner* Interpreter::GetAsyncSignatureRunner(
     const char* signature_key_) {
   auto [signature_key, empty_signature_fallback] =
@@ -1602,9 +1602,11 @@ TfLiteStatus Subgraph::PrepareOpsAndTensors() {
 #ifdef TFLITE_USE_SIMPLE_MEMORY_PLANNER
     memory_planner_.reset(new SimplePlanner(&context_, CreateGraphInfo()));
 #else
-    memory_planner_ = std::make_unique<ArenaPlanner>(
+    auto arena_planner = std::make_unique<ArenaPlanner>(
         &context_, CreateGraphInfo(), ShouldPreserveAllTensors(),
         kDefaultTensorAlignment, subgraph_index_, allocator_);
+    arena_planner->SetArenaMemoryPlans(GetArenaMemoryPlansFromMetadata());
+    memory_planner_ = std::move(arena_planner);
 #endif
     memory_planner_->PlanAllocations();
   }
@@ -2457,6 +2459,88 @@ TfLiteStatus Subgraph::InlineCompositeNodes(CompositeFilter filter) {
   return kTfLiteOk;
 }
 
+TfLiteStatus Subgraph::CopyGraphFrom(const Subgraph& source) {
+  TF_LITE_ENSURE(&context_,
+                 tensors_.empty() && nodes_and_registration_.empty());
+  allocation_ = source.allocation_;
+  // The registrations of the copied nodes may point to operators owned by the
+  // cache of `source`.
+  registration_externals_ = source.registration_externals_;
+
+  auto FindIdentifier = [](const std::unordered_map<size_t, size_t>& map,
+                           const int tensor_index) -> size_t {
+    auto it = map.find(tensor_index);
+    return it == map.end() ? kTfLiteNoBufferIdentifier : it->second;
+  };
+  const int tensors_count = source.tensors_.size();
+  TF_LITE_ENSURE_STATUS(AddTensors(tensors_count));
+  for (int i = 0; i < tensors_count; ++i) {
+    const TfLiteTensor& tensor = source.tensors_[i];
+    const size_t ndims = tensor.dims ? tensor.dims->size : 0;
+    const int* dims = tensor.dims ? tensor.dims->data : nullptr;
+    const size_t external_buffer_id =
+        FindIdentifier(source.tensor_external_buffer_ids_, i);
+    if (tensor.allocation_type == kTfLiteMmapRo) {
+      // Constant buffers are shared. Keeping their buffer identifiers lets
+      // delegate weight caches match them with the ones of `source`.
+      TF_LITE_ENSURE_STATUS(SetTensorParametersReadOnly(
+          i, tensor.type, tensor.name, ndims, dims,
+          TfLiteQuantizationClone(tensor.quantization), tensor.data.raw_const,
+          tensor.bytes, static_cast<const Allocation*>(tensor.allocation),
+          TfLiteSparsityClone(tensor.sparsity),
+          FindIdentifier(source.tensor_buffer_identifiers_, i),
+          external_buffer_id));
+    } else {
+      // Kernels set the allocation type of the tensors they compute, e.g.
+      // dynamic or persistent read-only, again when they are prepared.
+      const TfLiteIntArray* dims_signature = tensor.dims_signature;
+      TF_LITE_ENSURE_STATUS(SetTensorParametersReadWrite(
+          i, tensor.type, tensor.name, ndims, dims,
+          TfLiteQuantizationClone(tensor.quantization), tensor.is_variable,
+          dims_signature ? dims_signature->size : 0,
+          dims_signature ? dims_signature->data : nullptr,
+          external_buffer_id));
+    }
+  }
+
+  // Copy the nodes in execution order. We use the pre-delegation execution
+  // plan if it exists to ignore delegated nodes.
+  const std::vector<int>& source_execution_plan =
+      source.pre_delegation_execution_plan_.empty()
+          ? source.execution_plan_
+          : source.pre_delegation_execution_plan_;
+  for (const int node_index : source_execution_plan) {
+    const auto& [node, registration] =
+        source.nodes_and_registration_[node_index];
+    void* builtin_data = nullptr;
+    if (const int builtin_data_size = GetBuiltinDataSize(
+            static_cast<BuiltinOperator>(registration.builtin_code));
+        builtin_data_size > 0 && node.builtin_data) {
+      builtin_data = calloc(1, builtin_data_size);
+      TF_LITE_ENSURE(&context_, builtin_data != nullptr);
+      // The builtin params are populated from the flatbuffer, so the pointers
+      // they hold stay valid as long as `source` does.
+      std::memcpy(builtin_data, node.builtin_data, builtin_data_size);
+    }
+    const TfLiteIntArrayView inputs(node.inputs);
+    const TfLiteIntArrayView outputs(node.outputs);
+    const TfLiteIntArrayView intermediates(node.intermediates);
+    // Note: the registration is copied into the new node.
+    TF_LITE_ENSURE_STATUS(AddNodeWithParameters(
+        std::vector<int>(inputs.begin(), inputs.end()),
+        std::vector<int>(outputs.begin(), outputs.end()),
+        std::vector<int>(intermediates.begin(), intermediates.end()),
+        static_cast<const char*>(node.custom_initial_data),
+        node.custom_initial_data_size, builtin_data, &registration));
+  }
+
+  TF_LITE_ENSURE_STATUS(SetInputs(source.inputs_));
+  TF_LITE_ENSURE_STATUS(SetOutputs(source.outputs_));
+  TF_LITE_ENSURE_STATUS(SetVariables(source.variables_));
+  SetName(source.name_.c_str());
+  return kTfLiteOk;
+}
+
 bool Subgraph::HasDelegates() { return !delegates_applied_.empty(); }
 
 bool Subgraph::IsFullyDelegated() const {
@@ -2682,6 +2766,35 @@ void Subgraph::DumpMemoryPlannerDebugInfo() const {
   memory_planner_->DumpDebugInfo(execution_plan());
 }
 
+std::vector<ArenaMemoryPlan> Subgraph::GetArenaMemoryPlansFromMetadata()
+    const {
+  std::vector<ArenaMemoryPlan> plans;
+  if (metadata_ == nullptr) return plans;
+  auto it = metadata_->find(kArenaMemoryPlanMetadataKey);
+  if (it == metadata_->end()) return plans;
+  ModelArenaMemoryPlans model_plans;
+  if (!ParseArenaMemoryPlans(it->second.data(), it->second.size(),
+                             &model_plans)) {
+    TFLITE_LOG_PROD(tflite::TFLITE_LOG_WARNING,
+                    "Ignoring invalid arena memory plans in the model "
+                    "metadata.");
+    return plans;
+  }
+  for (ArenaMemoryPlan& plan : model_plans) {
+    if (plan.subgraph_index == subgraph_index_) {
+      plans.push_back(std::move(plan));
+    }
+  }
+  return plans;
+}
+
+TfLiteStatus Subgraph::GetArenaMemoryPlan(ArenaMemoryPlan* plan) const {
+  if (plan == nullptr || memory_planner_ == nullptr) return kTfLiteError;
+  TF_LITE_ENSURE_STATUS(memory_planner_->GetArenaMemoryPlan(plan));
+  plan->subgraph_index = subgraph_index_;
+  return kTfLiteOk;
+}
+
 void Subgraph::GetMemoryAllocInfo(SubgraphAllocInfo* alloc_info) const {
   memset(alloc_info, 0, sizeof(SubgraphAllocInfo));
   if (memory_planner_ == nullptr) return;
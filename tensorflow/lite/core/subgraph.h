@@ -31,6 +31,7 @@ limitations under the License.
 
 #include "tensorflow/compiler/mlir/lite/allocation.h"
 #include "tensorflow/lite/allocation.h"
+#include "tensorflow/lite/arena_memory_plan.h"
 #include "tensorflow/lite/array.h"
 #include "tensorflow/lite/c/common_internal.h"
 #include "tensorflow/lite/core/api/error_reporter.h"
@@ -485,6 +486,13 @@ class Subgraph {
   // Returns memory allocation status.
   void GetMemoryAllocInfo(SubgraphAllocInfo* alloc_info) const;
 
+  // WARNING: This is an experimental API and subject to change.
+  // Exports the placement of the tensors in the non-persistent arena for the
+  // current input shapes. Should be called after AllocateTensors(). The plan
+  // can be stored in the model metadata under `kArenaMemoryPlanMetadataKey`,
+  // in which case later interpreters adopt it when the input shapes match.
+  TfLiteStatus GetArenaMemoryPlan(ArenaMemoryPlan* plan) const;
+
   // WARNING: This is an experimental API and subject to change.
   // Set the given `InterpreterOptions` object.
   void SetOptions(InterpreterOptions* options) {
@@ -687,6 +695,12 @@ class Subgraph {
   friend class tflite::async::AsyncSubgraph;
   friend class TestDelegate;
 #endif  // DOXYGEN_SKIP
+  // Sets up this empty subgraph as a copy of the tensors and the
+  // non-delegated nodes of `source`, for `Interpreter::CreateExecutionContext`.
+  // Constant tensors share their buffer with `source`, which must outlive this
+  // subgraph. The other tensors, the kernels and the arena are not shared.
+  TfLiteStatus CopyGraphFrom(const Subgraph& source);
+
   // SubgraphAwareProfiler wraps an actual TFLite profiler, such as a
   // BufferedProfiler instance, and takes care of event profiling/tracing in a
   // certain subgraph.
@@ -1017,6 +1031,10 @@ class Subgraph {
   // Returns new GraphInfo object based on the current Subgraph.
   std::unique_ptr<GraphInfo> CreateGraphInfo();
 
+  // Returns the memory plans for this subgraph stored in the model metadata
+  // under `kArenaMemoryPlanMetadataKey`, if any.
+  std::vector<ArenaMemoryPlan> GetArenaMemoryPlansFromMetadata() const;
+
   // Store a ptr to the model metadata owned by the Interpreter.
   // Since the lifetime of the Interpreter exceeds the Subgraph, metadata
   // remains valid for the latter's lifetime.
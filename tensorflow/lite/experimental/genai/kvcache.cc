@@ -17,11 +17,15 @@ limitations under the License.
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
 
 #include "flatbuffers/flexbuffers.h"
 #include "tensorflow/lite/core/c/common.h"
 #include "tensorflow/lite/core/subgraph.h"
 #include "tensorflow/lite/experimental/resource/cache_buffer.h"
+#include "tensorflow/lite/experimental/resource/paged_cache_buffer.h"
 #include "tensorflow/lite/experimental/resource/resource_base.h"
 #include "tensorflow/lite/kernels/internal/runtime_shape.h"
 #include "tensorflow/lite/kernels/internal/tensor_ctypes.h"
@@ -44,6 +48,8 @@ static const int kDefaultTransformerLayerId = 0;
 
 static const int KVCACHE_KEY_RESOURCE = 42;
 static const int KVCACHE_VALUE_RESOURCE = 43;
+static const int KVCACHE_PAGED_KEY_RESOURCE = 44;
+static const int KVCACHE_PAGED_VALUE_RESOURCE = 45;
 
 struct OpData {
   int num_layers;
@@ -57,6 +63,16 @@ struct OpData {
   bool is_initialized;
   uint8_t* key_cache_ptr;
   uint8_t* value_cache_ptr;
+  // The number of entries of the blocks of the paged caches, or 0 if the
+  // caches are contiguous. When paged, the outputs are handles to the paged
+  // caches instead of views of the layer's contiguous caches.
+  int block_size;
+  resource::PagedCacheBuffer::StorageType storage_type;
+  resource::PagedCacheBuffer* paged_key_cache;
+  resource::PagedCacheBuffer* paged_value_cache;
+  // {resource id, layer index} of the paged caches, pointed to by the outputs.
+  int32_t key_handle[2];
+  int32_t value_handle[2];
 };
 
 void* KVCacheInit(TfLiteContext* context, const char* buffer, size_t length) {
@@ -72,9 +88,112 @@ void* KVCacheInit(TfLiteContext* context, const char* buffer, size_t length) {
   op_data->is_initialized = false;
   op_data->key_cache_ptr = nullptr;
   op_data->value_cache_ptr = nullptr;
+  op_data->block_size = 0;
+  op_data->storage_type = resource::PagedCacheBuffer::StorageType::kFloat32;
+  op_data->paged_key_cache = nullptr;
+  op_data->paged_value_cache = nullptr;
   return op_data;
 }
 
+TfLiteStatus ParseStorageType(TfLiteContext* context, const std::string& dtype,
+                              resource::PagedCacheBuffer::StorageType* type) {
+  if (dtype.empty() || dtype == "float32") {
+    *type = resource::PagedCacheBuffer::StorageType::kFloat32;
+  } else if (dtype == "float16") {
+    *type = resource::PagedCacheBuffer::StorageType::kFloat16;
+  } else if (dtype == "int8") {
+    *type = resource::PagedCacheBuffer::StorageType::kInt8;
+  } else {
+    TF_LITE_KERNEL_LOG(context, "Unsupported kv_cache_dtype: %s",
+                       dtype.c_str());
+    return kTfLiteError;
+  }
+  return kTfLiteOk;
+}
+
+// Creates the paged cache `resource_id` shared by all layers, or checks that
+// the existing one matches the configuration of this layer.
+TfLiteStatus GetOrCreatePagedCache(TfLiteContext* context, int resource_id,
+                                   const OpData& op_data, int num_heads,
+                                   int head_dim,
+                                   resource::PagedCacheBuffer** cache) {
+  Subgraph* subgraph = reinterpret_cast<Subgraph*>(context->impl_);
+  auto& resources = subgraph->resources();
+  auto it = resources.find(resource_id);
+  if (it == resources.end()) {
+    auto paged_cache = std::make_unique<resource::PagedCacheBuffer>();
+    TF_LITE_ENSURE_OK(context,
+                      paged_cache->Initialize(
+                          op_data.num_layers, op_data.max_num_entries,
+                          op_data.block_size, num_heads, head_dim,
+                          op_data.storage_type));
+    *cache = paged_cache.get();
+    resources.emplace(resource_id, std::move(paged_cache));
+    return kTfLiteOk;
+  }
+  TF_LITE_ENSURE(context,
+                 it->second->GetResourceType() ==
+                     resource::ResourceBase::ResourceType::kPagedCacheBuffer);
+  auto* paged_cache =
+      static_cast<resource::PagedCacheBuffer*>(it->second.get());
+  TF_LITE_ENSURE_EQ(context, paged_cache->num_layers(), op_data.num_layers);
+  TF_LITE_ENSURE_EQ(context, paged_cache->max_num_entries(),
+                    op_data.max_num_entries);
+  TF_LITE_ENSURE_EQ(context, paged_cache->num_heads(), num_heads);
+  TF_LITE_ENSURE_EQ(context, paged_cache->head_dim(), head_dim);
+  TF_LITE_ENSURE(context, paged_cache->storage_type() == op_data.storage_type);
+  *cache = paged_cache;
+  return kTfLiteOk;
+}
+
+// Makes `output` a resource tensor holding `handle`.
+TfLiteStatus PrepareHandleOutput(TfLiteContext* context, TfLiteTensor* output,
+                                 int32_t* handle) {
+  output->type = kTfLiteResource;
+  output->allocation_type = kTfLiteCustom;
+  output->data.data = handle;
+  TfLiteIntArray* dims = TfLiteIntArrayCreate(1);
+  dims->data[0] = 2;
+  TF_LITE_ENSURE_OK(context, context->ResizeTensor(context, output, dims));
+  // The size of resource tensors is not computed on resize.
+  output->bytes = 2 * sizeof(int32_t);
+  return kTfLiteOk;
+}
+
+TfLiteStatus PagedKVCachePrepare(TfLiteContext* context, TfLiteNode* node,
+                                 const TfLiteTensor* key) {
+  OpData* op_data = reinterpret_cast<OpData*>(node->user_data);
+  const int num_heads = key->dims->data[2];
+  const int head_dim = key->dims->data[3];
+  TF_LITE_ENSURE_OK(context, GetOrCreatePagedCache(
+                                 context, KVCACHE_PAGED_KEY_RESOURCE, *op_data,
+                                 num_heads, head_dim,
+                                 &op_data->paged_key_cache));
+  TF_LITE_ENSURE_OK(context, GetOrCreatePagedCache(
+                                 context, KVCACHE_PAGED_VALUE_RESOURCE,
+                                 *op_data, num_heads, head_dim,
+                                 &op_data->paged_value_cache));
+  TF_LITE_ENSURE(context,
+                 op_data->layer_index < op_data->paged_key_cache->num_layers());
+
+  op_data->key_handle[0] = KVCACHE_PAGED_KEY_RESOURCE;
+  op_data->key_handle[1] = op_data->layer_index;
+  op_data->value_handle[0] = KVCACHE_PAGED_VALUE_RESOURCE;
+  op_data->value_handle[1] = op_data->layer_index;
+
+  TfLiteTensor* kfull;
+  TfLiteTensor* vfull;
+  TF_LITE_ENSURE_OK(context,
+                    GetOutputSafe(context, node, kFullKeyTensor, &kfull));
+  TF_LITE_ENSURE_OK(context,
+                    GetOutputSafe(context, node, kFullValueTensor, &vfull));
+  TF_LITE_ENSURE_OK(context,
+                    PrepareHandleOutput(context, kfull, op_data->key_handle));
+  TF_LITE_ENSURE_OK(context,
+                    PrepareHandleOutput(context, vfull, op_data->value_handle));
+  return kTfLiteOk;
+}
+
 TfLiteStatus KVCachePrepare(TfLiteContext* context, TfLiteNode* node) {
   TF_LITE_ENSURE_EQ(context, NumInputs(node), 3);
   TF_LITE_ENSURE_EQ(context, NumOutputs(node), 2);
@@ -89,6 +208,11 @@ TfLiteStatus KVCachePrepare(TfLiteContext* context, TfLiteNode* node) {
     int32_t max_num_entries = flexbuffer_map["kv_cache_max"].AsInt32();
     int32_t num_layers = flexbuffer_map["num_layers"].AsInt32();
     int32_t layer_index = flexbuffer_map["layer_index"].AsInt32();
+    int32_t block_size = flexbuffer_map["kv_cache_block_size"].AsInt32();
+    const std::string dtype = flexbuffer_map["kv_cache_dtype"].AsString().str();
+    TF_LITE_ENSURE_OK(context,
+                      ParseStorageType(context, dtype, &op_data->storage_type));
+    op_data->block_size = block_size > 0 ? block_size : 0;
     op_data->max_num_entries =
         max_num_entries > 0 ? max_num_entries : kDefaultMaxNumCacheEntries;
     op_data->num_layers =
@@ -121,6 +245,14 @@ TfLiteStatus KVCachePrepare(TfLiteContext* context, TfLiteNode* node) {
   TF_LITE_ENSURE(context, GetTensorShape(key).Dims(0) == 1);
   TF_LITE_ENSURE(context, HaveSameShapes(key, value));
 
+  if (op_data->block_size > 0) {
+    return PagedKVCachePrepare(context, node, key);
+  }
+  // Only paged caches support other storage types.
+  TF_LITE_ENSURE(context,
+                 op_data->storage_type ==
+                     resource::PagedCacheBuffer::StorageType::kFloat32);
+
   // Create the key and value caches. Currently statically sized.
   TfLiteTensor* kfull;
   TfLiteTensor* vfull;
@@ -227,6 +359,39 @@ void KVCacheFree(TfLiteContext* context, void* buffer) {
   delete static_cast<OpData*>(buffer);
 }
 
+TfLiteStatus PagedKVCacheEval(TfLiteContext* context, TfLiteNode* node) {
+  const TfLiteTensor* position;
+  TF_LITE_ENSURE_OK(context,
+                    GetInputSafe(context, node, kPositionTensor, &position));
+  const TfLiteTensor* key;
+  TF_LITE_ENSURE_OK(context, GetInputSafe(context, node, kKeyTensor, &key));
+  const TfLiteTensor* value;
+  TF_LITE_ENSURE_OK(context, GetInputSafe(context, node, kValueTensor, &value));
+  OpData* op_data = reinterpret_cast<OpData*>(node->user_data);
+
+  // Entries are written to their slots in the circular caches: appending to
+  // a full cache overwrites its oldest entries rather than shifting the others.
+  const int64_t input_first_idx = position->data.i64[0];
+  const int num_entries = key->dims->data[1];
+  const int layer_index = op_data->layer_index;
+  if (input_first_idx <
+      op_data->paged_key_cache->GetFirstPosition(layer_index)) {
+    TF_LITE_KERNEL_LOG(
+        context,
+        "Can not specify a position before this cache's first position of %lld",
+        static_cast<long long>(  // NOLINT
+            op_data->paged_key_cache->GetFirstPosition(layer_index)));
+    return kTfLiteError;
+  }
+  TF_LITE_ENSURE_OK(context, op_data->paged_key_cache->Write(
+                                 layer_index, input_first_idx, num_entries,
+                                 GetTensorData<float>(key)));
+  TF_LITE_ENSURE_OK(context, op_data->paged_value_cache->Write(
+                                 layer_index, input_first_idx, num_entries,
+                                 GetTensorData<float>(value)));
+  return kTfLiteOk;
+}
+
 TfLiteStatus KVCacheEval(TfLiteContext* context, TfLiteNode* node) {
   const TfLiteTensor* position;
   TF_LITE_ENSURE_OK(context,
@@ -244,6 +409,9 @@ TfLiteStatus KVCacheEval(TfLiteContext* context, TfLiteNode* node) {
   TF_LITE_ENSURE_OK(context,
                     GetOutputSafe(context, node, kFullValueTensor, &vfull));
   OpData* op_data = reinterpret_cast<OpData*>(node->user_data);
+  if (op_data->block_size > 0) {
+    return PagedKVCacheEval(context, node);
+  }
 
   float* key_cache_ptr = op_data->key_cache_buffer->GetBuffer();
   float* value_cache_ptr = op_data->value_cache_buffer->GetBuffer();
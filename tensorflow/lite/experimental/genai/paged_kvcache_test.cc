@@ -0,0 +1,402 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "benchmark/benchmark.h"  // from @com_google_benchmark
+#include "flatbuffers/flexbuffers.h"
+#include "tensorflow/lite/c/c_api_types.h"
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/core/interpreter.h"
+#include "tensorflow/lite/experimental/genai/genai_ops.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+namespace tflite {
+
+// A KV_Cache op feeding an SDPA op, with a contiguous or a paged cache.
+class AttentionModel {
+ public:
+  struct Options {
+    int max_num_entries = 16;
+    // 0 for a contiguous cache.
+    int block_size = 0;
+    std::string dtype;
+    int num_heads = 4;
+    int num_kv_heads = 4;
+    int head_dim = 8;
+    int seq_len = 1;
+    // If false, the model only holds the KV_Cache op.
+    bool with_attention = true;
+  };
+
+  explicit AttentionModel(const Options& options) : options_(options) {
+    {
+      flexbuffers::Builder fbb;
+      fbb.Map([&]() {
+        fbb.Int("kv_cache_max", options.max_num_entries);
+        fbb.Int("num_layers", 1);
+        fbb.Int("layer_index", 0);
+        if (options.block_size > 0) {
+          fbb.Int("kv_cache_block_size", options.block_size);
+          fbb.String("kv_cache_dtype", options.dtype);
+        }
+      });
+      fbb.Finish();
+      kv_cache_options_ = fbb.GetBuffer();
+    }
+    {
+      flexbuffers::Builder fbb;
+      fbb.Map([&]() {});
+      fbb.Finish();
+      sdpa_options_ = fbb.GetBuffer();
+    }
+    kv_cache_registration_ = *ops::custom::Register_KV_CACHE();
+    kv_cache_registration_.builtin_code = BuiltinOperator_CUSTOM;
+    kv_cache_registration_.custom_name = "odml.update_kv_cache";
+    sdpa_registration_ = *ops::custom::Register_SDPA();
+    sdpa_registration_.builtin_code = BuiltinOperator_CUSTOM;
+    sdpa_registration_.custom_name = "odml.scaled_dot_product_attention";
+
+    interpreter_.AddTensors(kNumTensors);
+    interpreter_.SetInputs(
+        {kPositionTensor, kKeyTensor, kValueTensor, kQueryTensor, kMaskTensor});
+    interpreter_.SetOutputs({options.with_attention ? kOutputTensor
+                                                    : kFullKeyTensor});
+    const int s = options.seq_len;
+    SetTensor(kPositionTensor, kTfLiteInt64, {s});
+    SetTensor(kKeyTensor, kTfLiteFloat32,
+              {1, s, options.num_kv_heads, options.head_dim});
+    SetTensor(kValueTensor, kTfLiteFloat32,
+              {1, s, options.num_kv_heads, options.head_dim});
+    SetTensor(kQueryTensor, kTfLiteFloat32,
+              {1, s, options.num_heads, options.head_dim});
+    SetTensor(kMaskTensor, kTfLiteFloat32, {1, 1, s, options.max_num_entries});
+    SetTensor(kFullKeyTensor, kTfLiteFloat32, {});
+    SetTensor(kFullValueTensor, kTfLiteFloat32, {});
+    SetTensor(kOutputTensor, kTfLiteFloat32,
+              {1, s, options.num_heads, options.head_dim});
+    interpreter_.AddNodeWithParameters(
+        {kPositionTensor, kKeyTensor, kValueTensor},
+        {kFullKeyTensor, kFullValueTensor},
+        reinterpret_cast<const char*>(kv_cache_options_.data()),
+        kv_cache_options_.size(), nullptr, &kv_cache_registration_);
+    if (options.with_attention) {
+      interpreter_.AddNodeWithParameters(
+          {kQueryTensor, kFullKeyTensor, kFullValueTensor, kMaskTensor},
+          {kOutputTensor},
+          reinterpret_cast<const char*>(sdpa_options_.data()),
+          sdpa_options_.size(), nullptr, &sdpa_registration_);
+    }
+  }
+
+  TfLiteStatus AllocateTensors() { return interpreter_.AllocateTensors(); }
+
+  // Resizes the inputs to hold `seq_len` entries.
+  TfLiteStatus Resize(int seq_len) {
+    options_.seq_len = seq_len;
+    const Options& o = options_;
+    TF_LITE_ENSURE_STATUS(
+        interpreter_.ResizeInputTensor(kPositionTensor, {seq_len}));
+    for (int tensor : {kKeyTensor, kValueTensor}) {
+      TF_LITE_ENSURE_STATUS(interpreter_.ResizeInputTensor(
+          tensor, {1, seq_len, o.num_kv_heads, o.head_dim}));
+    }
+    TF_LITE_ENSURE_STATUS(interpreter_.ResizeInputTensor(
+        kQueryTensor, {1, seq_len, o.num_heads, o.head_dim}));
+    TF_LITE_ENSURE_STATUS(interpreter_.ResizeInputTensor(
+        kMaskTensor, {1, 1, seq_len, o.max_num_entries}));
+    TF_LITE_ENSURE_STATUS(interpreter_.ResizeInputTensor(
+        kOutputTensor, {1, seq_len, o.num_heads, o.head_dim}));
+    return interpreter_.AllocateTensors();
+  }
+
+  // Writes the keys and values of the `seq_len` positions starting at
+  // `position`, and attends to the cache with causal masking.
+  TfLiteStatus Invoke(int64_t position, const std::vector<float>& key,
+                      const std::vector<float>& value,
+                      const std::vector<float>& query) {
+    const int s = options_.seq_len;
+    for (int i = 0; i < s; ++i) {
+      interpreter_.typed_tensor<int64_t>(kPositionTensor)[i] = position + i;
+    }
+    Copy(key, kKeyTensor);
+    Copy(value, kValueTensor);
+    Copy(query, kQueryTensor);
+
+    // Tracks the positions held by the cache after the write, like the cache.
+    end_position_ = std::max(end_position_, position + s);
+    first_position_ =
+        std::max(first_position_, end_position_ - options_.max_num_entries);
+    float* mask = interpreter_.typed_tensor<float>(kMaskTensor);
+    for (int i = 0; i < s; ++i) {
+      for (int j = 0; j < options_.max_num_entries; ++j) {
+        mask[i * options_.max_num_entries + j] =
+            first_position_ + j <= position + i
+                ? 0.0f
+                : -std::numeric_limits<float>::infinity();
+      }
+    }
+    return interpreter_.Invoke();
+  }
+
+  std::vector<float> GetOutput() {
+    const TfLiteTensor* output = interpreter_.tensor(kOutputTensor);
+    return std::vector<float>(output->data.f,
+                              output->data.f + output->bytes / sizeof(float));
+  }
+
+  int64_t first_position() const { return first_position_; }
+
+ private:
+  static constexpr int kPositionTensor = 0;
+  static constexpr int kKeyTensor = 1;
+  static constexpr int kValueTensor = 2;
+  static constexpr int kQueryTensor = 3;
+  static constexpr int kMaskTensor = 4;
+  static constexpr int kFullKeyTensor = 5;
+  static constexpr int kFullValueTensor = 6;
+  static constexpr int kOutputTensor = 7;
+  static constexpr int kNumTensors = 8;
+
+  void SetTensor(int tensor, TfLiteType type, const std::vector<int>& dims) {
+    interpreter_.SetTensorParametersReadWrite(tensor, type, "", dims,
+                                              TfLiteQuantizationParams());
+  }
+
+  void Copy(const std::vector<float>& data, int tensor) {
+    TfLiteTensor* t = interpreter_.tensor(tensor);
+    ASSERT_EQ(data.size() * sizeof(float), t->bytes);
+    std::memcpy(t->data.f, data.data(), t->bytes);
+  }
+
+  Options options_;
+  std::vector<uint8_t> kv_cache_options_;
+  std::vector<uint8_t> sdpa_options_;
+  TfLiteRegistration kv_cache_registration_;
+  TfLiteRegistration sdpa_registration_;
+  Interpreter interpreter_;
+  int64_t first_position_ = 0;
+  int64_t end_position_ = 0;
+};
+
+namespace {
+
+// Returns `size` pseudo-random values in [-1, 1).
+std::vector<float> RandomValues(int size, uint32_t* seed) {
+  std::vector<float> values(size);
+  for (float& value : values) {
+    *seed = *seed * 1664525u + 1013904223u;
+    value = static_cast<float>(*seed >> 8) / (1 << 23) - 1.0f;
+  }
+  return values;
+}
+
+// Computes the attention over the entries of the positions in
+// [first_position, position] of `keys` and `values`, which hold the entries of
+// all positions.
+std::vector<float> ReferenceAttention(const AttentionModel::Options& o,
+                                      int64_t position, int64_t first_position,
+                                      const std::vector<float>& keys,
+                                      const std::vector<float>& values,
+                                      const std::vector<float>& query) {
+  const int entry_size = o.num_kv_heads * o.head_dim;
+  const float scale = 1.0f / std::sqrt(static_cast<float>(o.head_dim));
+  std::vector<float> output(query.size(), 0.0f);
+  for (int s = 0; s < o.seq_len; ++s) {
+    const int64_t last_position = position + s;
+    for (int h = 0; h < o.num_heads; ++h) {
+      const int kv_head = h / (o.num_heads / o.num_kv_heads);
+      const float* q = query.data() + (s * o.num_heads + h) * o.head_dim;
+      std::vector<float> scores;
+      for (int64_t p = first_position; p <= last_position; ++p) {
+        const float* k = keys.data() + p * entry_size + kv_head * o.head_dim;
+        float score = 0.0f;
+        for (int i = 0; i < o.head_dim; ++i) score += q[i] * k[i];
+        scores.push_back(scale * score);
+      }
+      const float max_score = *std::max_element(scores.begin(), scores.end());
+      float sum = 0.0f;
+      for (float& score : scores) {
+        score = std::exp(score - max_score);
+        sum += score;
+      }
+      float* out = output.data() + (s * o.num_heads + h) * o.head_dim;
+      for (int64_t p = first_position; p <= last_position; ++p) {
+        const float* v = values.data() + p * entry_size + kv_head * o.head_dim;
+        const float weight = scores[p - first_position] / sum;
+        for (int i = 0; i < o.head_dim; ++i) out[i] += weight * v[i];
+      }
+    }
+  }
+  return output;
+}
+
+struct PagedKVCacheTestParam {
+  int block_size;
+  std::string dtype;
+  int num_kv_heads;
+  int seq_len;
+  float tolerance;
+};
+
+class PagedKVCacheAttentionTest
+    : public ::testing::TestWithParam<PagedKVCacheTestParam> {};
+
+TEST_P(PagedKVCacheAttentionTest, MatchesReferenceAttention) {
+  const PagedKVCacheTestParam& param = GetParam();
+  AttentionModel::Options options;
+  options.max_num_entries = 12;
+  options.block_size = param.block_size;
+  options.dtype = param.dtype;
+  options.num_kv_heads = param.num_kv_heads;
+  options.seq_len = param.seq_len;
+  AttentionModel model(options);
+  ASSERT_EQ(model.AllocateTensors(), kTfLiteOk);
+
+  const int entry_size = options.num_kv_heads * options.head_dim;
+  const int query_size = options.num_heads * options.head_dim;
+  uint32_t seed = 1;
+  std::vector<float> keys;
+  std::vector<float> values;
+  // Writes past the capacity of the cache a few times.
+  for (int64_t position = 0; position < 40; position += options.seq_len) {
+    const std::vector<float> key =
+        RandomValues(options.seq_len * entry_size, &seed);
+    const std::vector<float> value =
+        RandomValues(options.seq_len * entry_size, &seed);
+    const std::vector<float> query =
+        RandomValues(options.seq_len * query_size, &seed);
+    keys.insert(keys.end(), key.begin(), key.end());
+    values.insert(values.end(), value.begin(), value.end());
+    ASSERT_EQ(model.Invoke(position, key, value, query), kTfLiteOk);
+
+    const std::vector<float> expected = ReferenceAttention(
+        options, position, model.first_position(), keys, values, query);
+    const std::vector<float> output = model.GetOutput();
+    ASSERT_EQ(output.size(), expected.size());
+    for (size_t i = 0; i < output.size(); ++i) {
+      EXPECT_NEAR(output[i], expected[i], param.tolerance)
+          << "position " << position << " element " << i;
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    PagedKVCacheAttentionTest, PagedKVCacheAttentionTest,
+    ::testing::Values(
+        // Contiguous cache.
+        PagedKVCacheTestParam{0, "", 4, 1, 1e-5f},
+        PagedKVCacheTestParam{0, "", 4, 3, 1e-5f},
+        // Multi-head, grouped-query and multi-query attention.
+        PagedKVCacheTestParam{4, "float32", 4, 1, 1e-5f},
+        PagedKVCacheTestParam{4, "float32", 2, 1, 1e-5f},
+        PagedKVCacheTestParam{4, "float32", 1, 1, 1e-5f},
+        // Writes of several entries, straddling blocks.
+        PagedKVCacheTestParam{5, "float32", 2, 3, 1e-5f},
+        PagedKVCacheTestParam{4, "float16", 2, 1, 5e-3f},
+        PagedKVCacheTestParam{4, "int8", 2, 1, 2e-2f}));
+
+TEST(PagedKVCacheTest, RejectsPositionsBeforeTheCache) {
+  AttentionModel::Options options;
+  options.max_num_entries = 4;
+  options.block_size = 2;
+  options.dtype = "float32";
+  AttentionModel model(options);
+  ASSERT_EQ(model.AllocateTensors(), kTfLiteOk);
+  uint32_t seed = 1;
+  const int entry_size = options.num_kv_heads * options.head_dim;
+  const std::vector<float> entry = RandomValues(entry_size, &seed);
+  const std::vector<float> query =
+      RandomValues(options.num_heads * options.head_dim, &seed);
+  for (int64_t position = 0; position < 6; ++position) {
+    ASSERT_EQ(model.Invoke(position, entry, entry, query), kTfLiteOk);
+  }
+  EXPECT_EQ(model.Invoke(1, entry, entry, query), kTfLiteError);
+}
+
+TEST(PagedKVCacheTest, RejectsUnsupportedStorageType) {
+  AttentionModel::Options options;
+  options.block_size = 4;
+  options.dtype = "bfloat16";
+  AttentionModel model(options);
+  EXPECT_EQ(model.AllocateTensors(), kTfLiteError);
+}
+
+}  // namespace
+}  // namespace tflite
+
+// Measures the latency of decoding a token once the cache is full, so that
+// every write evicts the oldest entry. The contiguous cache shifts all its
+// entries on each write, which grows with the size of the cache, while the
+// paged cache overwrites a single slot. With attention, both also attend to
+// the whole cache.
+void BM_DecodeStep(benchmark::State& state) {
+  constexpr int kPrefillChunkSize = 128;
+  tflite::AttentionModel::Options options;
+  options.max_num_entries = state.range(0);
+  options.block_size = state.range(1);
+  options.dtype = "float32";
+  options.with_attention = state.range(2) != 0;
+  options.num_heads = 8;
+  options.num_kv_heads = 8;
+  options.head_dim = 64;
+  options.seq_len = kPrefillChunkSize;
+  tflite::AttentionModel model(options);
+  if (model.AllocateTensors() != kTfLiteOk) {
+    state.SkipWithError("Failed to allocate tensors");
+    return;
+  }
+
+  // Fills the cache.
+  const int entry_size = options.num_kv_heads * options.head_dim;
+  const int query_size = options.num_heads * options.head_dim;
+  uint32_t seed = 1;
+  const std::vector<float> prefill_entries =
+      tflite::RandomValues(kPrefillChunkSize * entry_size, &seed);
+  const std::vector<float> prefill_queries =
+      tflite::RandomValues(kPrefillChunkSize * query_size, &seed);
+  for (int64_t position = 0; position < options.max_num_entries;
+       position += kPrefillChunkSize) {
+    if (model.Invoke(position, prefill_entries, prefill_entries,
+                     prefill_queries) != kTfLiteOk) {
+      state.SkipWithError("Failed to fill the cache");
+      return;
+    }
+  }
+  if (model.Resize(1) != kTfLiteOk) {
+    state.SkipWithError("Failed to resize the inputs");
+    return;
+  }
+
+  const std::vector<float> entry = tflite::RandomValues(entry_size, &seed);
+  const std::vector<float> query = tflite::RandomValues(query_size, &seed);
+  int64_t position = options.max_num_entries;
+  for (auto _ : state) {
+    if (model.Invoke(position++, entry, entry, query) != kTfLiteOk) {
+      state.SkipWithError("Failed to decode");
+      return;
+    }
+  }
+}
+// Args: max number of cache entries, block size (0 for a contiguous cache),
+// whether to attend to the cache.
+BENCHMARK(BM_DecodeStep)
+    ->ArgsProduct({{512, 2048, 8192}, {0, 64}, {0, 1}});
@@ -15,14 +15,20 @@ limitations under the License.
 
 #include <math.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <limits>
+#include <vector>
 
 #include "flatbuffers/flexbuffers.h"
 #include "tensorflow/lite/c/c_api_types.h"
 #include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/subgraph.h"
+#include "tensorflow/lite/experimental/resource/paged_cache_buffer.h"
+#include "tensorflow/lite/experimental/resource/resource_base.h"
 #include "tensorflow/lite/kernels/internal/common.h"
 #include "tensorflow/lite/kernels/internal/reference/add.h"
 #include "tensorflow/lite/kernels/internal/reference/batch_matmul.h"
@@ -60,15 +66,114 @@ static const int kBroadcastVTempTensorIndex = 9;
 struct OpData {
   float scale;
   int scratch_tensor_index;
+  // Set if the keys and values are handles to paged caches, written by
+  // KV_Cache ops with a block size, rather than tensors.
+  const resource::PagedCacheBuffer* paged_key_cache;
+  const resource::PagedCacheBuffer* paged_value_cache;
+  int layer_index;
+  // The attention scores of a query head over the cache slots.
+  std::vector<float> scores;
 };
 
 void* SDPAInit(TfLiteContext* context, const char* buffer, size_t length) {
   OpData* op_data = new OpData();
   op_data->scale = 0.0f;
+  op_data->paged_key_cache = nullptr;
+  op_data->paged_value_cache = nullptr;
+  op_data->layer_index = -1;
   context->AddTensors(context, kNumTempTensors, &op_data->scratch_tensor_index);
   return op_data;
 }
 
+// Returns the "scale" attribute, or 1 / sqrt(head_dim) if it is not set.
+float GetScale(const TfLiteNode* node, const TfLiteTensor* q_tensor) {
+  const uint8_t* buffer =
+      reinterpret_cast<const uint8_t*>(node->custom_initial_data);
+  const size_t length = node->custom_initial_data_size;
+  auto flexbuffer_map = flexbuffers::GetRoot(buffer, length).AsMap();
+  float scale = flexbuffer_map["scale"].AsFloat();
+  if (scale > 0.0f) return scale;
+  return 1 / sqrt(q_tensor->dims->data[3]);
+}
+
+// Gets the paged cache and the layer pointed to by the {resource id, layer
+// index} `handle`.
+TfLiteStatus GetPagedCache(TfLiteContext* context, const TfLiteTensor* handle,
+                           const resource::PagedCacheBuffer** cache,
+                           int* layer_index) {
+  TF_LITE_ENSURE_EQ(context, NumElements(handle), 2);
+  TF_LITE_ENSURE(context, handle->data.data != nullptr);
+  const int32_t* ids = reinterpret_cast<const int32_t*>(handle->data.data);
+  Subgraph* subgraph = reinterpret_cast<Subgraph*>(context->impl_);
+  auto& resources = subgraph->resources();
+  auto it = resources.find(ids[0]);
+  TF_LITE_ENSURE(context, it != resources.end());
+  TF_LITE_ENSURE(context,
+                 it->second->GetResourceType() ==
+                     resource::ResourceBase::ResourceType::kPagedCacheBuffer);
+  *cache = static_cast<const resource::PagedCacheBuffer*>(it->second.get());
+  *layer_index = ids[1];
+  TF_LITE_ENSURE(context,
+                 *layer_index >= 0 && *layer_index < (*cache)->num_layers());
+  return kTfLiteOk;
+}
+
+TfLiteStatus PagedSDPAPrepare(TfLiteContext* context, TfLiteNode* node,
+                              const TfLiteTensor* q_tensor,
+                              const TfLiteTensor* k_tensor,
+                              const TfLiteTensor* v_tensor,
+                              const TfLiteTensor* mask_tensor) {
+  OpData* op_data = reinterpret_cast<OpData*>(node->user_data);
+  TF_LITE_ENSURE_EQ(context, v_tensor->type, kTfLiteResource);
+  int value_layer_index;
+  TF_LITE_ENSURE_OK(context,
+                    GetPagedCache(context, k_tensor, &op_data->paged_key_cache,
+                                  &op_data->layer_index));
+  TF_LITE_ENSURE_OK(context,
+                    GetPagedCache(context, v_tensor,
+                                  &op_data->paged_value_cache,
+                                  &value_layer_index));
+  const resource::PagedCacheBuffer* key_cache = op_data->paged_key_cache;
+  const resource::PagedCacheBuffer* value_cache = op_data->paged_value_cache;
+  TF_LITE_ENSURE_EQ(context, op_data->layer_index, value_layer_index);
+  TF_LITE_ENSURE_EQ(context, key_cache->num_heads(), value_cache->num_heads());
+  TF_LITE_ENSURE_EQ(context, key_cache->head_dim(), value_cache->head_dim());
+  TF_LITE_ENSURE_EQ(context, key_cache->max_num_entries(),
+                    value_cache->max_num_entries());
+
+  // q: (1, S, N, H), mask: (1, 1 or N, 1 or S, max number of cache entries).
+  TF_LITE_ENSURE_EQ(context, q_tensor->type, kTfLiteFloat32);
+  TF_LITE_ENSURE_EQ(context, mask_tensor->type, kTfLiteFloat32);
+  TF_LITE_ENSURE_EQ(context, NumDimensions(q_tensor), 4);
+  TF_LITE_ENSURE_EQ(context, NumDimensions(mask_tensor), 4);
+  const int seq_len = q_tensor->dims->data[1];
+  const int num_heads = q_tensor->dims->data[2];
+  TF_LITE_ENSURE_EQ(context, q_tensor->dims->data[0], 1);
+  TF_LITE_ENSURE_EQ(context, q_tensor->dims->data[3], key_cache->head_dim());
+  TF_LITE_ENSURE_EQ(context, num_heads % key_cache->num_heads(), 0);
+  TF_LITE_ENSURE_EQ(context, mask_tensor->dims->data[0], 1);
+  TF_LITE_ENSURE(context, mask_tensor->dims->data[1] == 1 ||
+                              mask_tensor->dims->data[1] == num_heads);
+  TF_LITE_ENSURE(context, mask_tensor->dims->data[2] == 1 ||
+                              mask_tensor->dims->data[2] == seq_len);
+  TF_LITE_ENSURE_EQ(context, mask_tensor->dims->data[3],
+                    key_cache->max_num_entries());
+
+  op_data->scale = GetScale(node, q_tensor);
+  op_data->scores.resize(key_cache->max_num_entries());
+
+  // The caches are read in place, without temporaries.
+  TfLiteIntArrayFree(node->temporaries);
+  node->temporaries = TfLiteIntArrayCreate(0);
+
+  TfLiteTensor* output_tensor;
+  TF_LITE_ENSURE_OK(
+      context, GetOutputSafe(context, node, kOutputTensor, &output_tensor));
+  TF_LITE_ENSURE_EQ(context, output_tensor->type, kTfLiteFloat32);
+  return context->ResizeTensor(context, output_tensor,
+                               TfLiteIntArrayCopy(q_tensor->dims));
+}
+
 TfLiteStatus SDPAPrepare(TfLiteContext* context, TfLiteNode* node) {
   TF_LITE_ENSURE_EQ(context, NumInputs(node), 4);
   TF_LITE_ENSURE_EQ(context, NumOutputs(node), 1);
@@ -86,6 +191,10 @@ TfLiteStatus SDPAPrepare(TfLiteContext* context, TfLiteNode* node) {
   const TfLiteTensor* mask_tensor;
   TF_LITE_ENSURE_OK(
       context, GetInputSafe(context, node, kAttentionMaskTensor, &mask_tensor));
+  if (k_tensor->type == kTfLiteResource) {
+    return PagedSDPAPrepare(context, node, q_tensor, k_tensor, v_tensor,
+                            mask_tensor);
+  }
   TF_LITE_ENSURE_EQ(context, NumDimensions(q_tensor), NumDimensions(k_tensor));
   TF_LITE_ENSURE_EQ(context, NumDimensions(k_tensor), NumDimensions(v_tensor));
   TF_LITE_ENSURE_EQ(context, NumDimensions(v_tensor),
@@ -93,16 +202,7 @@ TfLiteStatus SDPAPrepare(TfLiteContext* context, TfLiteNode* node) {
   TF_LITE_ENSURE_EQ(context, NumDimensions(mask_tensor), 4);
 
   // Get custom op params
-  const uint8_t* buffer =
-      reinterpret_cast<const uint8_t*>(node->custom_initial_data);
-  const size_t length = node->custom_initial_data_size;
-  auto flexbuffer_map = flexbuffers::GetRoot(buffer, length).AsMap();
-  float scale = flexbuffer_map["scale"].AsFloat();
-  op_data->scale = scale > 0.0f ? scale : 0.0f;
-
-  // If scale is not set, use sqrt(q_tensor->dims->data[3])
-  if (op_data->scale == 0.0f)
-    op_data->scale = 1 / sqrt(q_tensor->dims->data[3]);
+  op_data->scale = GetScale(node, q_tensor);
 
   TfLiteIntArrayFree(node->temporaries);
   node->temporaries = TfLiteIntArrayCreate(kNumTempTensors);
@@ -358,7 +458,86 @@ void SDPAFree(TfLiteContext* context, void* buffer) {
   delete static_cast<OpData*>(buffer);
 }
 
+// Attends to the paged caches of the layer directly. The scores of the slots
+// of the cache that have not been written yet only hold the mask, like those
+// of the zeroed slots of a contiguous cache.
+TfLiteStatus PagedSDPAEval(TfLiteContext* context, TfLiteNode* node) {
+  const TfLiteTensor* query_tensor;
+  TF_LITE_ENSURE_OK(context,
+                    GetInputSafe(context, node, kQueryTensor, &query_tensor));
+  const TfLiteTensor* attention_mask_tensor;
+  TF_LITE_ENSURE_OK(context, GetInputSafe(context, node, kAttentionMaskTensor,
+                                          &attention_mask_tensor));
+  TfLiteTensor* output_tensor;
+  TF_LITE_ENSURE_OK(
+      context, GetOutputSafe(context, node, kOutputTensor, &output_tensor));
+  OpData* op_data = reinterpret_cast<OpData*>(node->user_data);
+  const resource::PagedCacheBuffer* key_cache = op_data->paged_key_cache;
+  const resource::PagedCacheBuffer* value_cache = op_data->paged_value_cache;
+  const int layer = op_data->layer_index;
+
+  const float* query_data = GetTensorData<float>(query_tensor);
+  const float* mask_data = GetTensorData<float>(attention_mask_tensor);
+  float* output_data = GetTensorData<float>(output_tensor);
+  const int seq_len = query_tensor->dims->data[1];
+  const int num_heads = query_tensor->dims->data[2];
+  const int head_dim = query_tensor->dims->data[3];
+  const int num_kv_heads = key_cache->num_heads();
+  const int num_heads_per_kv_head = num_heads / num_kv_heads;
+  const int mask_num_heads = attention_mask_tensor->dims->data[1];
+  const int mask_seq_len = attention_mask_tensor->dims->data[2];
+  const int max_num_entries = key_cache->max_num_entries();
+  const int64_t first_position = key_cache->GetFirstPosition(layer);
+  const int num_entries = key_cache->GetNumEntries(layer);
+  TF_LITE_ENSURE_EQ(context, value_cache->GetFirstPosition(layer),
+                    first_position);
+  TF_LITE_ENSURE_EQ(context, value_cache->GetNumEntries(layer), num_entries);
+  float* scores = op_data->scores.data();
+
+  for (int s = 0; s < seq_len; ++s) {
+    for (int h = 0; h < num_heads; ++h) {
+      const float* query = query_data + (s * num_heads + h) * head_dim;
+      const float* mask =
+          mask_data + ((mask_num_heads == 1 ? 0 : h) * mask_seq_len +
+                       (mask_seq_len == 1 ? 0 : s)) *
+                          max_num_entries;
+      float* output = output_data + (s * num_heads + h) * head_dim;
+      const int kv_head = h / num_heads_per_kv_head;
+
+      float max_score = -std::numeric_limits<float>::infinity();
+      for (int j = 0; j < max_num_entries; ++j) {
+        float score = mask[j];
+        if (j < num_entries) {
+          score += op_data->scale * key_cache->Dot(layer, first_position + j,
+                                                   kv_head, query);
+        }
+        scores[j] = score;
+        max_score = std::max(max_score, score);
+      }
+
+      std::fill_n(output, head_dim, 0.0f);
+      // Every slot is masked out.
+      if (max_score == -std::numeric_limits<float>::infinity()) continue;
+      float sum = 0.0f;
+      for (int j = 0; j < max_num_entries; ++j) {
+        scores[j] = std::exp(scores[j] - max_score);
+        sum += scores[j];
+      }
+      const float inverse_sum = 1.0f / sum;
+      for (int j = 0; j < num_entries; ++j) {
+        value_cache->AccumulateScaled(layer, first_position + j, kv_head,
+                                      scores[j] * inverse_sum, output);
+      }
+    }
+  }
+  return kTfLiteOk;
+}
+
 TfLiteStatus SDPAEval(TfLiteContext* context, TfLiteNode* node) {
+  if (reinterpret_cast<const OpData*>(node->user_data)->paged_key_cache) {
+    return PagedSDPAEval(context, node);
+  }
+
   /*
   Simple implementation of Scaled Dot Product Attention.
   Takes query_proj, key_proj, value_proj, mask tensors as inputs, and
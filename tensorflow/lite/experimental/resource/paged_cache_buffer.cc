@@ -0,0 +1,269 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/experimental/resource/paged_cache_buffer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/kernels/internal/compatibility.h"
+#include "tensorflow/lite/types/half.h"
+
+namespace tflite {
+namespace resource {
+namespace {
+
+size_t ElementSize(PagedCacheBuffer::StorageType storage_type) {
+  switch (storage_type) {
+    case PagedCacheBuffer::StorageType::kFloat32:
+      return sizeof(float);
+    case PagedCacheBuffer::StorageType::kFloat16:
+      return sizeof(half);
+    case PagedCacheBuffer::StorageType::kInt8:
+      return sizeof(int8_t);
+  }
+  return 0;
+}
+
+// Quantizes `row` to `out` symmetrically and returns the scale.
+float QuantizeRow(const float* row, int size, int8_t* out) {
+  float max_abs = 0.0f;
+  for (int i = 0; i < size; ++i) {
+    max_abs = std::max(max_abs, std::abs(row[i]));
+  }
+  if (max_abs == 0.0f) {
+    std::memset(out, 0, size);
+    return 0.0f;
+  }
+  const float scale = max_abs / 127.0f;
+  const float inverse_scale = 1.0f / scale;
+  for (int i = 0; i < size; ++i) {
+    const float value = std::round(row[i] * inverse_scale);
+    out[i] = static_cast<int8_t>(std::min(127.0f, std::max(-127.0f, value)));
+  }
+  return scale;
+}
+
+template <typename T>
+float DotRow(const T* row, const float* x, int size) {
+  float sum = 0.0f;
+  for (int i = 0; i < size; ++i) {
+    sum += static_cast<float>(row[i]) * x[i];
+  }
+  return sum;
+}
+
+template <typename T>
+void AccumulateRow(const T* row, float weight, int size, float* out) {
+  for (int i = 0; i < size; ++i) {
+    out[i] += weight * static_cast<float>(row[i]);
+  }
+}
+
+}  // namespace
+
+TfLiteStatus PagedCacheBuffer::Initialize(int num_layers, int max_num_entries,
+                                          int block_size, int num_heads,
+                                          int head_dim,
+                                          StorageType storage_type) {
+  if (num_layers <= 0 || max_num_entries <= 0 || block_size <= 0 ||
+      num_heads <= 0 || head_dim <= 0) {
+    return kTfLiteError;
+  }
+  num_layers_ = num_layers;
+  max_num_entries_ = max_num_entries;
+  block_size_ = std::min(block_size, max_num_entries);
+  num_heads_ = num_heads;
+  head_dim_ = head_dim;
+  storage_type_ = storage_type;
+  block_bytes_ = static_cast<size_t>(block_size_) * num_heads_ * head_dim_ *
+                 ElementSize(storage_type_);
+  if (storage_type_ == StorageType::kInt8) {
+    block_bytes_ += sizeof(float) * block_size_ * num_heads_;
+  }
+  num_allocated_blocks_ = 0;
+
+  const int num_blocks = (max_num_entries_ + block_size_ - 1) / block_size_;
+  layers_.clear();
+  layers_.resize(num_layers_);
+  for (Layer& layer : layers_) {
+    layer.blocks.resize(num_blocks);
+  }
+  is_initialized_ = true;
+  return kTfLiteOk;
+}
+
+size_t PagedCacheBuffer::GetMemoryUsage() {
+  return num_allocated_blocks_ * block_bytes_;
+}
+
+int64_t PagedCacheBuffer::GetFirstPosition(int layer) const {
+  return layers_[layer].first_position;
+}
+
+int64_t PagedCacheBuffer::GetEndPosition(int layer) const {
+  return layers_[layer].end_position;
+}
+
+int PagedCacheBuffer::GetNumEntries(int layer) const {
+  return layers_[layer].end_position - layers_[layer].first_position;
+}
+
+TfLiteStatus PagedCacheBuffer::Write(int layer, int64_t position,
+                                     int num_entries, const float* data) {
+  if (layer < 0 || layer >= num_layers_ || num_entries < 0) {
+    return kTfLiteError;
+  }
+  Layer& cache_layer = layers_[layer];
+  if (position < cache_layer.first_position) return kTfLiteError;
+
+  const int64_t end_position = position + num_entries;
+  const int64_t new_end_position =
+      std::max(cache_layer.end_position, end_position);
+  const int64_t new_first_position = std::max(
+      cache_layer.first_position, new_end_position - max_num_entries_);
+
+  // Zeroes the skipped positions that are still held after the write.
+  for (int64_t p = std::max(cache_layer.end_position, new_first_position);
+       p < std::min(position, new_end_position); ++p) {
+    StoreEntry(layer, p, nullptr);
+  }
+  const int entry_size = num_heads_ * head_dim_;
+  for (int64_t p = std::max(position, new_first_position); p < end_position;
+       ++p) {
+    StoreEntry(layer, p, data + (p - position) * entry_size);
+  }
+  cache_layer.first_position = new_first_position;
+  cache_layer.end_position = new_end_position;
+  return kTfLiteOk;
+}
+
+void PagedCacheBuffer::StoreEntry(int layer, int64_t position,
+                                  const float* entry) {
+  const int64_t slot_index = position % max_num_entries_;
+  Block& block = layers_[layer].blocks[slot_index / block_size_];
+  const int slot = slot_index % block_size_;
+  if (block.data == nullptr) {
+    const size_t data_bytes = static_cast<size_t>(block_size_) * num_heads_ *
+                              head_dim_ * ElementSize(storage_type_);
+    block.data.reset(new uint8_t[data_bytes]);
+    if (storage_type_ == StorageType::kInt8) {
+      block.scales.reset(new float[block_size_ * num_heads_]);
+    }
+    ++num_allocated_blocks_;
+  }
+
+  const int entry_size = num_heads_ * head_dim_;
+  const size_t offset = static_cast<size_t>(slot) * entry_size;
+  if (entry == nullptr) {
+    std::memset(block.data.get() + offset * ElementSize(storage_type_), 0,
+                entry_size * ElementSize(storage_type_));
+    if (storage_type_ == StorageType::kInt8) {
+      std::fill_n(block.scales.get() + slot * num_heads_, num_heads_, 0.0f);
+    }
+    return;
+  }
+  switch (storage_type_) {
+    case StorageType::kFloat32:
+      std::memcpy(reinterpret_cast<float*>(block.data.get()) + offset, entry,
+                  entry_size * sizeof(float));
+      break;
+    case StorageType::kFloat16: {
+      half* out = reinterpret_cast<half*>(block.data.get()) + offset;
+      for (int i = 0; i < entry_size; ++i) {
+        out[i] = half(entry[i]);
+      }
+      break;
+    }
+    case StorageType::kInt8: {
+      int8_t* out = reinterpret_cast<int8_t*>(block.data.get()) + offset;
+      for (int h = 0; h < num_heads_; ++h) {
+        block.scales[slot * num_heads_ + h] = QuantizeRow(
+            entry + h * head_dim_, head_dim_, out + h * head_dim_);
+      }
+      break;
+    }
+  }
+}
+
+const PagedCacheBuffer::Block& PagedCacheBuffer::GetBlock(int layer,
+                                                          int64_t position,
+                                                          int* slot) const {
+  const Layer& cache_layer = layers_[layer];
+  TFLITE_DCHECK(position >= cache_layer.first_position &&
+                position < cache_layer.end_position);
+  const int64_t slot_index = position % max_num_entries_;
+  *slot = slot_index % block_size_;
+  return cache_layer.blocks[slot_index / block_size_];
+}
+
+float PagedCacheBuffer::Dot(int layer, int64_t position, int head,
+                            const float* x) const {
+  int slot;
+  const Block& block = GetBlock(layer, position, &slot);
+  const size_t offset =
+      (static_cast<size_t>(slot) * num_heads_ + head) * head_dim_;
+  switch (storage_type_) {
+    case StorageType::kFloat32:
+      return DotRow(reinterpret_cast<const float*>(block.data.get()) + offset,
+                    x, head_dim_);
+    case StorageType::kFloat16:
+      return DotRow(reinterpret_cast<const half*>(block.data.get()) + offset,
+                    x, head_dim_);
+    case StorageType::kInt8:
+      return block.scales[slot * num_heads_ + head] *
+             DotRow(reinterpret_cast<const int8_t*>(block.data.get()) + offset,
+                    x, head_dim_);
+  }
+  return 0.0f;
+}
+
+void PagedCacheBuffer::AccumulateScaled(int layer, int64_t position, int head,
+                                        float weight, float* out) const {
+  int slot;
+  const Block& block = GetBlock(layer, position, &slot);
+  const size_t offset =
+      (static_cast<size_t>(slot) * num_heads_ + head) * head_dim_;
+  switch (storage_type_) {
+    case StorageType::kFloat32:
+      AccumulateRow(reinterpret_cast<const float*>(block.data.get()) + offset,
+                    weight, head_dim_, out);
+      break;
+    case StorageType::kFloat16:
+      AccumulateRow(reinterpret_cast<const half*>(block.data.get()) + offset,
+                    weight, head_dim_, out);
+      break;
+    case StorageType::kInt8:
+      AccumulateRow(
+          reinterpret_cast<const int8_t*>(block.data.get()) + offset,
+          weight * block.scales[slot * num_heads_ + head], head_dim_, out);
+      break;
+  }
+}
+
+void PagedCacheBuffer::ReadEntry(int layer, int64_t position,
+                                 float* out) const {
+  std::fill_n(out, num_heads_ * head_dim_, 0.0f);
+  for (int h = 0; h < num_heads_; ++h) {
+    AccumulateScaled(layer, position, h, 1.0f, out + h * head_dim_);
+  }
+}
+
+}  // namespace resource
+}  // namespace tflite
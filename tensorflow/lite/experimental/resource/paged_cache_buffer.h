@@ -0,0 +1,135 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_EXPERIMENTAL_RESOURCE_PAGED_CACHE_BUFFER_H_
+#define TENSORFLOW_LITE_EXPERIMENTAL_RESOURCE_PAGED_CACHE_BUFFER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/experimental/resource/resource_base.h"
+
+namespace tflite {
+namespace resource {
+
+/// WARNING: Experimental interface, subject to change.
+// A paged, circular cache of the keys or values of the attention layers of a
+// transformer, for autoregressive decode.
+//
+// Each layer holds the entries, of shape <num heads, head dim>, of the last
+// `max_num_entries` positions written to it. An entry is stored in the slot
+// `position % max_num_entries`, so that appending an entry to a full cache
+// overwrites the oldest one instead of shifting the others. Slots are grouped
+// in blocks of `block_size` entries, which are allocated on the first write
+// to one of their slots: the memory of a layer grows with its context rather
+// than being reserved for `max_num_entries` up front.
+//
+// Entries are stored as float32, float16 or int8. Int8 entries are quantized
+// symmetrically, with a scale per entry and head.
+class PagedCacheBuffer : public ResourceBase {
+ public:
+  enum class StorageType { kFloat32, kFloat16, kInt8 };
+
+  PagedCacheBuffer() = default;
+  PagedCacheBuffer(const PagedCacheBuffer&) = delete;
+  ~PagedCacheBuffer() override = default;
+  PagedCacheBuffer& operator=(const PagedCacheBuffer&) = delete;
+
+  TfLiteStatus Initialize(int num_layers, int max_num_entries, int block_size,
+                          int num_heads, int head_dim,
+                          StorageType storage_type);
+
+  ResourceType GetResourceType() const override {
+    return ResourceType::kPagedCacheBuffer;
+  }
+
+  bool IsInitialized() override { return is_initialized_; }
+
+  // Returns the bytes of the allocated blocks.
+  size_t GetMemoryUsage() override;
+
+  // Writes the `num_entries` entries of `data`, of shape
+  // <num entries, num heads, head dim>, at the positions starting at
+  // `position` of `layer`. Positions between the last written one and
+  // `position` are zeroed. Fails if `position` is before the first position
+  // held by the cache.
+  TfLiteStatus Write(int layer, int64_t position, int num_entries,
+                     const float* data);
+
+  // The cache holds the entries of the positions in
+  // [GetFirstPosition(layer), GetEndPosition(layer)).
+  int64_t GetFirstPosition(int layer) const;
+  int64_t GetEndPosition(int layer) const;
+  int GetNumEntries(int layer) const;
+
+  // Returns the dot product of `x`, of size `head_dim`, and the `head` of the
+  // entry at `position` of `layer`.
+  float Dot(int layer, int64_t position, int head, const float* x) const;
+
+  // Adds `weight` times the `head` of the entry at `position` of `layer` to
+  // `out`, of size `head_dim`.
+  void AccumulateScaled(int layer, int64_t position, int head, float weight,
+                        float* out) const;
+
+  // Copies the dequantized entry at `position` of `layer` to `out`, of size
+  // `num_heads * head_dim`.
+  void ReadEntry(int layer, int64_t position, float* out) const;
+
+  int num_layers() const { return num_layers_; }
+  int max_num_entries() const { return max_num_entries_; }
+  int block_size() const { return block_size_; }
+  int num_heads() const { return num_heads_; }
+  int head_dim() const { return head_dim_; }
+  StorageType storage_type() const { return storage_type_; }
+
+ private:
+  struct Block {
+    // <block size, num heads, head dim> elements of the storage type.
+    std::unique_ptr<uint8_t[]> data;
+    // <block size, num heads> scales, for int8 storage.
+    std::unique_ptr<float[]> scales;
+  };
+
+  struct Layer {
+    std::vector<Block> blocks;
+    int64_t first_position = 0;
+    int64_t end_position = 0;
+  };
+
+  // Returns the block holding `position` of `layer` and the index of the slot
+  // of `position` in that block.
+  const Block& GetBlock(int layer, int64_t position, int* slot) const;
+
+  // Stores `entry`, or zeros if `entry` is null, at `position` of `layer`.
+  void StoreEntry(int layer, int64_t position, const float* entry);
+
+  bool is_initialized_ = false;
+  int num_layers_ = 0;
+  int max_num_entries_ = 0;
+  int block_size_ = 0;
+  int num_heads_ = 0;
+  int head_dim_ = 0;
+  StorageType storage_type_ = StorageType::kFloat32;
+  size_t block_bytes_ = 0;
+  int64_t num_allocated_blocks_ = 0;
+  std::vector<Layer> layers_;
+};
+
+}  // namespace resource
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_EXPERIMENTAL_RESOURCE_PAGED_CACHE_BUFFER_H_
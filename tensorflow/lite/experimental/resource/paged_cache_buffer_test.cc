@@ -0,0 +1,196 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/experimental/resource/paged_cache_buffer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "tensorflow/lite/core/c/common.h"
+
+namespace tflite {
+namespace resource {
+namespace {
+
+constexpr int kNumHeads = 2;
+constexpr int kHeadDim = 3;
+constexpr int kEntrySize = kNumHeads * kHeadDim;
+
+// Returns `num_entries` entries whose elements encode their position.
+std::vector<float> MakeEntries(int64_t position, int num_entries) {
+  std::vector<float> entries;
+  for (int64_t p = position; p < position + num_entries; ++p) {
+    for (int i = 0; i < kEntrySize; ++i) {
+      entries.push_back(p + 0.125f * (i + 1));
+    }
+  }
+  return entries;
+}
+
+void ExpectEntry(const PagedCacheBuffer& cache, int layer, int64_t position,
+                 float tolerance) {
+  std::vector<float> entry(kEntrySize);
+  cache.ReadEntry(layer, position, entry.data());
+  const std::vector<float> expected = MakeEntries(position, 1);
+  for (int i = 0; i < kEntrySize; ++i) {
+    EXPECT_NEAR(entry[i], expected[i], tolerance)
+        << "position " << position << " element " << i;
+  }
+}
+
+TEST(PagedCacheBufferTest, Initialize) {
+  PagedCacheBuffer cache;
+  EXPECT_FALSE(cache.IsInitialized());
+  ASSERT_EQ(cache.Initialize(/*num_layers=*/3, /*max_num_entries=*/10,
+                             /*block_size=*/4, kNumHeads, kHeadDim,
+                             PagedCacheBuffer::StorageType::kFloat32),
+            kTfLiteOk);
+  EXPECT_TRUE(cache.IsInitialized());
+  EXPECT_EQ(cache.GetResourceType(),
+            ResourceBase::ResourceType::kPagedCacheBuffer);
+  // Blocks are allocated on the first write.
+  EXPECT_EQ(cache.GetMemoryUsage(), 0);
+  for (int layer = 0; layer < 3; ++layer) {
+    EXPECT_EQ(cache.GetNumEntries(layer), 0);
+  }
+
+  PagedCacheBuffer invalid;
+  EXPECT_EQ(invalid.Initialize(1, 0, 4, kNumHeads, kHeadDim,
+                               PagedCacheBuffer::StorageType::kFloat32),
+            kTfLiteError);
+}
+
+TEST(PagedCacheBufferTest, AllocatesBlocksOnWrite) {
+  PagedCacheBuffer cache;
+  ASSERT_EQ(cache.Initialize(/*num_layers=*/2, /*max_num_entries=*/16,
+                             /*block_size=*/4, kNumHeads, kHeadDim,
+                             PagedCacheBuffer::StorageType::kFloat32),
+            kTfLiteOk);
+  const size_t block_bytes = 4 * kEntrySize * sizeof(float);
+  std::vector<float> entries = MakeEntries(0, 5);
+  ASSERT_EQ(cache.Write(1, 0, 5, entries.data()), kTfLiteOk);
+  EXPECT_EQ(cache.GetMemoryUsage(), 2 * block_bytes);
+  EXPECT_EQ(cache.GetNumEntries(0), 0);
+  EXPECT_EQ(cache.GetNumEntries(1), 5);
+  for (int64_t p = 0; p < 5; ++p) ExpectEntry(cache, 1, p, 0.0f);
+}
+
+TEST(PagedCacheBufferTest, WrapsAround) {
+  PagedCacheBuffer cache;
+  ASSERT_EQ(cache.Initialize(/*num_layers=*/1, /*max_num_entries=*/8,
+                             /*block_size=*/3, kNumHeads, kHeadDim,
+                             PagedCacheBuffer::StorageType::kFloat32),
+            kTfLiteOk);
+  for (int64_t p = 0; p < 21; ++p) {
+    std::vector<float> entry = MakeEntries(p, 1);
+    ASSERT_EQ(cache.Write(0, p, 1, entry.data()), kTfLiteOk);
+    EXPECT_EQ(cache.GetEndPosition(0), p + 1);
+    EXPECT_EQ(cache.GetFirstPosition(0), std::max<int64_t>(0, p - 7));
+  }
+  EXPECT_EQ(cache.GetNumEntries(0), 8);
+  for (int64_t p = 13; p < 21; ++p) ExpectEntry(cache, 0, p, 0.0f);
+  EXPECT_EQ(cache.GetMemoryUsage(), 3 * 3 * kEntrySize * sizeof(float));
+
+  // Positions before the first held one can not be written.
+  std::vector<float> entry = MakeEntries(12, 1);
+  EXPECT_EQ(cache.Write(0, 12, 1, entry.data()), kTfLiteError);
+  // Held positions can be overwritten.
+  entry = MakeEntries(13, 1);
+  EXPECT_EQ(cache.Write(0, 13, 1, entry.data()), kTfLiteOk);
+  EXPECT_EQ(cache.GetFirstPosition(0), 13);
+  EXPECT_EQ(cache.GetEndPosition(0), 21);
+}
+
+TEST(PagedCacheBufferTest, WritesMoreEntriesThanCapacity) {
+  PagedCacheBuffer cache;
+  ASSERT_EQ(cache.Initialize(/*num_layers=*/1, /*max_num_entries=*/4,
+                             /*block_size=*/2, kNumHeads, kHeadDim,
+                             PagedCacheBuffer::StorageType::kFloat32),
+            kTfLiteOk);
+  std::vector<float> entries = MakeEntries(0, 7);
+  ASSERT_EQ(cache.Write(0, 0, 7, entries.data()), kTfLiteOk);
+  EXPECT_EQ(cache.GetFirstPosition(0), 3);
+  EXPECT_EQ(cache.GetEndPosition(0), 7);
+  for (int64_t p = 3; p < 7; ++p) ExpectEntry(cache, 0, p, 0.0f);
+}
+
+TEST(PagedCacheBufferTest, ZeroesSkippedPositions) {
+  PagedCacheBuffer cache;
+  ASSERT_EQ(cache.Initialize(/*num_layers=*/1, /*max_num_entries=*/8,
+                             /*block_size=*/4, kNumHeads, kHeadDim,
+                             PagedCacheBuffer::StorageType::kFloat32),
+            kTfLiteOk);
+  std::vector<float> entries = MakeEntries(0, 8);
+  ASSERT_EQ(cache.Write(0, 0, 8, entries.data()), kTfLiteOk);
+  std::vector<float> entry = MakeEntries(10, 1);
+  ASSERT_EQ(cache.Write(0, 10, 1, entry.data()), kTfLiteOk);
+  EXPECT_EQ(cache.GetFirstPosition(0), 3);
+  std::vector<float> read(kEntrySize);
+  for (int64_t p = 8; p < 10; ++p) {
+    cache.ReadEntry(0, p, read.data());
+    for (float value : read) EXPECT_EQ(value, 0.0f);
+  }
+  ExpectEntry(cache, 0, 7, 0.0f);
+  ExpectEntry(cache, 0, 10, 0.0f);
+}
+
+TEST(PagedCacheBufferTest, DotAndAccumulate) {
+  PagedCacheBuffer cache;
+  ASSERT_EQ(cache.Initialize(/*num_layers=*/1, /*max_num_entries=*/4,
+                             /*block_size=*/4, kNumHeads, kHeadDim,
+                             PagedCacheBuffer::StorageType::kFloat32),
+            kTfLiteOk);
+  std::vector<float> entry = MakeEntries(1, 1);
+  ASSERT_EQ(cache.Write(0, 1, 1, entry.data()), kTfLiteOk);
+  const float x[kHeadDim] = {1.0f, -1.0f, 2.0f};
+  // Head 1 of position 1 is {1.5, 1.625, 1.75}.
+  EXPECT_FLOAT_EQ(cache.Dot(0, 1, 1, x), 1.5f - 1.625f + 3.5f);
+  float out[kHeadDim] = {1.0f, 1.0f, 1.0f};
+  cache.AccumulateScaled(0, 1, 1, 2.0f, out);
+  EXPECT_FLOAT_EQ(out[0], 4.0f);
+  EXPECT_FLOAT_EQ(out[1], 4.25f);
+  EXPECT_FLOAT_EQ(out[2], 4.5f);
+}
+
+TEST(PagedCacheBufferTest, Float16Storage) {
+  PagedCacheBuffer cache;
+  ASSERT_EQ(cache.Initialize(/*num_layers=*/1, /*max_num_entries=*/8,
+                             /*block_size=*/4, kNumHeads, kHeadDim,
+                             PagedCacheBuffer::StorageType::kFloat16),
+            kTfLiteOk);
+  std::vector<float> entries = MakeEntries(0, 8);
+  ASSERT_EQ(cache.Write(0, 0, 8, entries.data()), kTfLiteOk);
+  EXPECT_EQ(cache.GetMemoryUsage(), 8 * kEntrySize * 2);
+  for (int64_t p = 0; p < 8; ++p) ExpectEntry(cache, 0, p, 1e-2f);
+}
+
+TEST(PagedCacheBufferTest, Int8Storage) {
+  PagedCacheBuffer cache;
+  ASSERT_EQ(cache.Initialize(/*num_layers=*/1, /*max_num_entries=*/8,
+                             /*block_size=*/4, kNumHeads, kHeadDim,
+                             PagedCacheBuffer::StorageType::kInt8),
+            kTfLiteOk);
+  std::vector<float> entries = MakeEntries(0, 8);
+  ASSERT_EQ(cache.Write(0, 0, 8, entries.data()), kTfLiteOk);
+  EXPECT_EQ(cache.GetMemoryUsage(),
+            8 * kEntrySize + 8 * kNumHeads * sizeof(float));
+  // The error is at most half a quantization step, which is at most 8 / 127.
+  for (int64_t p = 0; p < 8; ++p) ExpectEntry(cache, 0, p, 0.04f);
+}
+
+}  // namespace
+}  // namespace resource
+}  // namespace tflite
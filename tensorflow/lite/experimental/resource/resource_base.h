@@ -35,6 +35,7 @@ class ResourceBase {
     kResourceVariable = 1,
     kHashTable = 2,
     kInitializationStatus = 3,
+    kPagedCacheBuffer = 4,
   };
 
   explicit ResourceBase() {}
@@ -2426,5 +2426,116 @@ TEST_F(InterpreterTest, SingleSignature_validate_get_tensor) {
       nullptr);
 }
 
+// Builds `output = (input + constant) * constant`, where `constant` is the read
+// only tensor 1 with buffer identifier 7.
+void BuildAddMulGraph(Interpreter* interpreter, const float* constant) {
+  Subgraph& subgraph = interpreter->primary_subgraph();
+  ASSERT_EQ(subgraph.AddTensors(4), kTfLiteOk);
+  ASSERT_EQ(subgraph.SetInputs({0}), kTfLiteOk);
+  ASSERT_EQ(subgraph.SetOutputs({3}), kTfLiteOk);
+  TfLiteQuantization quant = {kTfLiteNoQuantization, nullptr};
+  for (int i : {0, 2, 3}) {
+    ASSERT_EQ(subgraph.SetTensorParametersReadWrite(i, kTfLiteFloat32, "", {3},
+                                                    quant),
+              kTfLiteOk);
+  }
+  ASSERT_EQ(subgraph.SetTensorParametersReadOnly(
+                1, kTfLiteFloat32, "constant", {3}, quant,
+                reinterpret_cast<const char*>(constant), 3 * sizeof(float),
+                /*allocation=*/nullptr, /*sparsity=*/nullptr,
+                /*buffer_identifier=*/7),
+            kTfLiteOk);
+  auto* add_params =
+      reinterpret_cast<TfLiteAddParams*>(malloc(sizeof(TfLiteAddParams)));
+  add_params->activation = kTfLiteActNone;
+  add_params->pot_scale_int16 = false;
+  ASSERT_EQ(subgraph.AddNodeWithParameters({0, 1}, {2}, {}, nullptr, 0,
+                                           add_params,
+                                           ops::builtin::Register_ADD()),
+            kTfLiteOk);
+  auto* mul_params =
+      reinterpret_cast<TfLiteMulParams*>(malloc(sizeof(TfLiteMulParams)));
+  mul_params->activation = kTfLiteActNone;
+  ASSERT_EQ(subgraph.AddNodeWithParameters({2, 1}, {3}, {}, nullptr, 0,
+                                           mul_params,
+                                           ops::builtin::Register_MUL()),
+            kTfLiteOk);
+}
+
+void ExpectAddMulOutput(Interpreter* interpreter, const float* constant,
+                        float offset) {
+  float* input = interpreter->typed_input_tensor<float>(0);
+  for (int i = 0; i < 3; ++i) input[i] = offset + i;
+  ASSERT_EQ(interpreter->Invoke(), kTfLiteOk);
+  const float* output = interpreter->typed_output_tensor<float>(0);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(output[i], (offset + i + constant[i]) * constant[i]) << i;
+  }
+}
+
+TEST(ExecutionContextTest, SharesConstantTensors) {
+  static const float kConstant[] = {1.0f, 2.0f, 3.0f};
+  Interpreter interpreter;
+  BuildAddMulGraph(&interpreter, kConstant);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+
+  std::unique_ptr<Interpreter> context;
+  ASSERT_EQ(interpreter.CreateExecutionContext(&context), kTfLiteOk);
+  ASSERT_NE(context, nullptr);
+  EXPECT_EQ(context->inputs(), interpreter.inputs());
+  EXPECT_EQ(context->outputs(), interpreter.outputs());
+  EXPECT_EQ(context->execution_plan().size(), 2);
+  EXPECT_EQ(context->primary_subgraph().GetTensorBufferIdentifiers().at(1), 7);
+  ASSERT_EQ(context->AllocateTensors(), kTfLiteOk);
+
+  // The constant tensor is shared, the activations are not.
+  EXPECT_EQ(context->tensor(1)->data.raw, interpreter.tensor(1)->data.raw);
+  EXPECT_EQ(context->tensor(1)->allocation_type, kTfLiteMmapRo);
+  for (int i : {0, 2, 3}) {
+    EXPECT_NE(context->tensor(i)->data.raw, interpreter.tensor(i)->data.raw);
+  }
+  ExpectAddMulOutput(context.get(), kConstant, 10.0f);
+  ExpectAddMulOutput(&interpreter, kConstant, -4.0f);
+  // The context keeps its own outputs.
+  EXPECT_EQ(context->typed_output_tensor<float>(0)[0], 11.0f);
+}
+
+TEST(ExecutionContextTest, ResizesIndependently) {
+  static const float kConstant[] = {1.0f, 2.0f, 3.0f};
+  Interpreter interpreter;
+  BuildAddMulGraph(&interpreter, kConstant);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+
+  std::unique_ptr<Interpreter> context;
+  ASSERT_EQ(interpreter.CreateExecutionContext(&context), kTfLiteOk);
+  ASSERT_EQ(context->ResizeInputTensor(0, {2, 3}), kTfLiteOk);
+  ASSERT_EQ(context->AllocateTensors(), kTfLiteOk);
+  EXPECT_EQ(context->output_tensor(0)->dims->size, 2);
+  EXPECT_EQ(interpreter.output_tensor(0)->dims->size, 1);
+  ExpectAddMulOutput(&interpreter, kConstant, 0.0f);
+}
+
+TEST(ExecutionContextTest, ConcurrentInvoke) {
+  static const float kConstant[] = {0.5f, -1.0f, 2.0f};
+  Interpreter interpreter;
+  BuildAddMulGraph(&interpreter, kConstant);
+
+  constexpr int kNumContexts = 4;
+  std::vector<std::unique_ptr<Interpreter>> contexts(kNumContexts);
+  for (auto& context : contexts) {
+    ASSERT_EQ(interpreter.CreateExecutionContext(&context), kTfLiteOk);
+    ASSERT_EQ(context->AllocateTensors(), kTfLiteOk);
+  }
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumContexts; ++i) {
+    threads.emplace_back([&contexts, i]() {
+      for (int step = 0; step < 100; ++step) {
+        ExpectAddMulOutput(contexts[i].get(), kConstant, i * 100 + step);
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+}
+
 }  // namespace
 }  // namespace tflite
@@ -17,6 +17,7 @@ limitations under the License.
 
 #include <vector>
 
+#include "tensorflow/lite/arena_memory_plan.h"
 #include "tensorflow/lite/core/c/common.h"
 
 namespace tflite {
@@ -69,6 +70,13 @@ class MemoryPlanner {
   // Returns a map of allocation information. It's only used for debugging.
   virtual void GetAllocInfo(size_t *arena_size,
                             size_t *arena_persist_size) const = 0;
+
+  // Exports the placement of the tensors in the non-persistent arena, e.g. to
+  // be stored with the model and adopted by later planners. Planners which
+  // don't support this return kTfLiteError.
+  virtual TfLiteStatus GetArenaMemoryPlan(ArenaMemoryPlan* plan) const {
+    return kTfLiteError;
+  }
 };
 
 }  // namespace tflite
@@ -433,6 +433,54 @@ TfLiteStatus SimpleMemoryArena::Allocate(
   return kTfLiteOk;
 }
 
+bool SimpleMemoryArena::AllocateAt(size_t alignment, size_t offset,
+                                   size_t size, int32_t tensor,
+                                   int32_t first_node, int32_t last_node,
+                                   ArenaAllocWithUsageInterval* new_alloc) {
+  if (new_alloc == nullptr || alignment == 0 ||
+      alignment > underlying_buffer_.GetAlignment() ||
+      offset % alignment != 0) {
+    return false;
+  }
+  size_t end = 0;
+  if (!CheckedAdd(offset, size, &end)) {
+    return false;
+  }
+  if (size != 0) {
+    for (const auto& alloc : active_allocs_) {
+      if (alloc.offset >= end) {
+        // The allocs are sorted by offset, so none of the rest can overlap.
+        break;
+      }
+      if (alloc.last_node < first_node || alloc.first_node > last_node ||
+          alloc.size == 0) {
+        continue;
+      }
+      size_t alloc_end = 0;
+      if (!CheckedAdd(alloc.offset, alloc.size, &alloc_end)) {
+        return false;
+      }
+      if (alloc_end > offset) {
+        return false;
+      }
+    }
+  }
+  new_alloc->tensor = tensor;
+  new_alloc->first_node = first_node;
+  new_alloc->last_node = last_node;
+  new_alloc->size = size;
+  if (size == 0) {
+    new_alloc->offset = 0;
+    return true;
+  }
+  new_alloc->offset = offset;
+  high_water_mark_ = std::max(high_water_mark_, end);
+  auto insertion_it = std::upper_bound(active_allocs_.begin(),
+                                       active_allocs_.end(), *new_alloc);
+  active_allocs_.insert(insertion_it, *new_alloc);
+  return true;
+}
+
 TfLiteStatus SimpleMemoryArena::Commit(bool* arena_reallocated) {
   if (arena_reallocated == nullptr) {
     return kTfLiteError;
@@ -148,6 +148,15 @@ class SimpleMemoryArena {
                         int32_t tensor, int32_t first_node, int32_t last_node,
                         ArenaAllocWithUsageInterval* new_alloc);
 
+  // Schedule memory allocation for a tensor at a given offset, e.g. one
+  // computed ahead of time. Returns false without allocating if the offset is
+  // not aligned, or if the allocation would overlap an allocation whose usage
+  // interval intersects with [first_node, last_node]; callers then fall back
+  // to Allocate.
+  bool AllocateAt(size_t alignment, size_t offset, size_t size, int32_t tensor,
+                  int32_t first_node, int32_t last_node,
+                  ArenaAllocWithUsageInterval* new_alloc);
+
   TfLiteStatus Commit(bool* arena_reallocated);
 
   TfLiteStatus ResolveAlloc(TfLiteContext* context,
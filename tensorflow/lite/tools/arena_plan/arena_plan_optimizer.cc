@@ -0,0 +1,269 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/tools/arena_plan/arena_plan_optimizer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "tensorflow/lite/arena_memory_plan.h"
+
+namespace tflite {
+namespace arena_plan {
+namespace {
+
+constexpr size_t kSizeNotPlaced = std::numeric_limits<size_t>::max();
+
+size_t AlignTo(size_t alignment, size_t offset) {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+bool UsageIntervalsIntersect(const ArenaTensorAllocation& a,
+                             const ArenaTensorAllocation& b) {
+  return a.first_node <= b.last_node && b.first_node <= a.last_node;
+}
+
+// Places the allocations in the order given by `order`, each in the smallest
+// gap between the already placed allocations it conflicts with, exactly like
+// SimpleMemoryArena::Allocate. Returns the arena size, or kSizeNotPlaced as
+// soon as it exceeds `limit`.
+class Placer {
+ public:
+  Placer(const std::vector<ArenaTensorAllocation>& allocations,
+         size_t alignment)
+      : allocations_(allocations),
+        alignment_(alignment),
+        conflicts_(allocations.size()),
+        offsets_(allocations.size()),
+        placed_(allocations.size()) {
+    for (int i = 0; i < allocations.size(); ++i) {
+      for (int j = i + 1; j < allocations.size(); ++j) {
+        if (UsageIntervalsIntersect(allocations[i], allocations[j])) {
+          conflicts_[i].push_back(j);
+          conflicts_[j].push_back(i);
+        }
+      }
+    }
+  }
+
+  const std::vector<std::vector<int>>& conflicts() const { return conflicts_; }
+  const std::vector<size_t>& offsets() const { return offsets_; }
+
+  size_t Place(const std::vector<int>& order, size_t limit) {
+    std::fill(placed_.begin(), placed_.end(), false);
+    size_t arena_size = 0;
+    for (int i : order) {
+      const size_t size = allocations_[i].size;
+      if (size == 0) {
+        offsets_[i] = 0;
+        placed_[i] = true;
+        continue;
+      }
+      neighbours_.clear();
+      for (int j : conflicts_[i]) {
+        if (placed_[j] && allocations_[j].size > 0) {
+          neighbours_.emplace_back(offsets_[j],
+                                   offsets_[j] + allocations_[j].size);
+        }
+      }
+      std::sort(neighbours_.begin(), neighbours_.end());
+      size_t best_offset = kSizeNotPlaced;
+      size_t best_offset_fit = kSizeNotPlaced;
+      size_t current_offset = 0;
+      for (const auto& [offset, end] : neighbours_) {
+        const size_t aligned_current_offset =
+            AlignTo(alignment_, current_offset);
+        if (aligned_current_offset + size <= offset &&
+            offset - aligned_current_offset < best_offset_fit) {
+          best_offset = aligned_current_offset;
+          best_offset_fit = offset - aligned_current_offset;
+        }
+        current_offset = std::max(current_offset, end);
+      }
+      if (best_offset == kSizeNotPlaced) {
+        best_offset = AlignTo(alignment_, current_offset);
+      }
+      offsets_[i] = best_offset;
+      placed_[i] = true;
+      arena_size = std::max(arena_size, best_offset + size);
+      if (arena_size > limit) {
+        return kSizeNotPlaced;
+      }
+    }
+    return arena_size;
+  }
+
+ private:
+  const std::vector<ArenaTensorAllocation>& allocations_;
+  const size_t alignment_;
+  std::vector<std::vector<int>> conflicts_;
+  std::vector<size_t> offsets_;
+  std::vector<bool> placed_;
+  std::vector<std::pair<size_t, size_t>> neighbours_;
+};
+
+// Returns the indices of `allocations` sorted by `key`, largest first, ties
+// broken by the first node using the tensor.
+template <class Key>
+std::vector<int> SortedOrder(
+    const std::vector<ArenaTensorAllocation>& allocations, Key key) {
+  std::vector<int> order(allocations.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+    const auto key_a = key(allocations[a]);
+    const auto key_b = key(allocations[b]);
+    if (key_a != key_b) return key_a > key_b;
+    return allocations[a].first_node < allocations[b].first_node;
+  });
+  return order;
+}
+
+double Lifetime(const ArenaTensorAllocation& allocation) {
+  return static_cast<double>(allocation.last_node) - allocation.first_node + 1;
+}
+
+}  // namespace
+
+size_t GetArenaSizeLowerBound(
+    const std::vector<ArenaTensorAllocation>& allocations, size_t alignment) {
+  // The tensors live at a node are disjoint in the arena. Sorted by offset,
+  // each of them but the last ends before the next aligned offset, so the
+  // arena holds at least their aligned sizes minus the padding of the last.
+  size_t lower_bound = 0;
+  for (const ArenaTensorAllocation& start : allocations) {
+    // The maximum is reached at the first node of some tensor.
+    size_t aligned_size = 0;
+    size_t max_padding = 0;
+    for (const ArenaTensorAllocation& allocation : allocations) {
+      if (allocation.size == 0 || allocation.first_node > start.first_node ||
+          allocation.last_node < start.first_node) {
+        continue;
+      }
+      const size_t size = AlignTo(alignment, allocation.size);
+      aligned_size += size;
+      max_padding = std::max<size_t>(max_padding, size - allocation.size);
+    }
+    if (aligned_size > 0) {
+      lower_bound = std::max(lower_bound, aligned_size - max_padding);
+    }
+  }
+  return lower_bound;
+}
+
+void OptimizeArenaMemoryPlan(const ArenaPlanOptimizerOptions& options,
+                             ArenaMemoryPlan* plan) {
+  const std::vector<ArenaTensorAllocation>& allocations = plan->allocations;
+  if (allocations.empty()) return;
+  const size_t alignment = std::max<size_t>(options.alignment, 1);
+  Placer placer(allocations, alignment);
+
+  // Tensors live through the whole inference go first, as in the
+  // ArenaPlanner, then the largest ones.
+  auto greedy_key = [](const ArenaTensorAllocation& allocation) {
+    const bool whole_inference =
+        allocation.first_node == 0 &&
+        allocation.last_node == std::numeric_limits<int32_t>::max();
+    return std::make_pair(whole_inference, allocation.size);
+  };
+  std::vector<int> best_order = SortedOrder(allocations, greedy_key);
+  size_t best_size = placer.Place(best_order, kSizeNotPlaced);
+  std::vector<size_t> best_offsets = placer.offsets();
+
+  if (options.strategy == ArenaPlanStrategy::kNearOptimal) {
+    const size_t lower_bound = GetArenaSizeLowerBound(allocations, alignment);
+    auto try_order = [&](const std::vector<int>& order) {
+      const size_t size = placer.Place(order, best_size);
+      if (size == kSizeNotPlaced) return false;
+      if (size < best_size) {
+        best_size = size;
+        best_order = order;
+        best_offsets = placer.offsets();
+      }
+      return true;
+    };
+
+    // Orders which work well on different kinds of graphs: large tensors
+    // first, long-lived tensors first, and tensors with the most conflicting
+    // bytes first.
+    std::vector<double> conflict_bytes(allocations.size());
+    for (int i = 0; i < allocations.size(); ++i) {
+      for (int j : placer.conflicts()[i]) {
+        conflict_bytes[i] += allocations[j].size;
+      }
+    }
+    const std::vector<std::vector<int>> seed_orders = {
+        SortedOrder(allocations,
+                    [](const ArenaTensorAllocation& allocation) {
+                      return allocation.size;
+                    }),
+        SortedOrder(allocations,
+                    [](const ArenaTensorAllocation& allocation) {
+                      return allocation.size * Lifetime(allocation);
+                    }),
+        SortedOrder(allocations,
+                    [](const ArenaTensorAllocation& allocation) {
+                      return std::make_pair(Lifetime(allocation),
+                                            allocation.size);
+                    }),
+        SortedOrder(allocations,
+                    [&](const ArenaTensorAllocation& allocation) {
+                      return conflict_bytes[&allocation - allocations.data()] +
+                             allocation.size;
+                    }),
+    };
+    for (const std::vector<int>& order : seed_orders) {
+      if (best_size <= lower_bound) break;
+      try_order(order);
+    }
+
+    // Local search: move a random tensor earlier in the best order, keeping
+    // orders that don't grow the arena so that the search can cross plateaus.
+    std::mt19937_64 rng(options.seed);
+    std::vector<int> current_order = best_order;
+    std::vector<int> order;
+    for (int iteration = 0;
+         iteration < options.max_iterations && best_size > lower_bound &&
+         allocations.size() > 1;
+         ++iteration) {
+      order = current_order;
+      std::uniform_int_distribution<size_t> index(0, order.size() - 1);
+      const size_t from = index(rng);
+      const size_t to = index(rng);
+      if (from == to) continue;
+      if (iteration % 2 == 0) {
+        std::swap(order[from], order[to]);
+      } else {
+        const int moved = order[std::max(from, to)];
+        order.erase(order.begin() + std::max(from, to));
+        order.insert(order.begin() + std::min(from, to), moved);
+      }
+      if (try_order(order)) {
+        current_order = std::move(order);
+      }
+    }
+  }
+
+  for (int i = 0; i < allocations.size(); ++i) {
+    plan->allocations[i].offset = best_offsets[i];
+  }
+}
+
+}  // namespace arena_plan
+}  // namespace tflite
@@ -0,0 +1,64 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_TOOLS_ARENA_PLAN_ARENA_PLAN_OPTIMIZER_H_
+#define TENSORFLOW_LITE_TOOLS_ARENA_PLAN_ARENA_PLAN_OPTIMIZER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "tensorflow/lite/arena_memory_plan.h"
+
+namespace tflite {
+namespace arena_plan {
+
+// How to compute the offsets of the tensors in an arena.
+enum class ArenaPlanStrategy {
+  // Places the tensors from largest to smallest, each in the smallest gap
+  // among the tensors it is live with. This is what the ArenaPlanner does at
+  // runtime.
+  kGreedyBySize,
+  // Tries several placement orders and then searches for better ones by
+  // local moves, until the arena size reaches a lower bound or the iterations
+  // run out. The result is never larger than kGreedyBySize's.
+  kNearOptimal,
+};
+
+struct ArenaPlanOptimizerOptions {
+  ArenaPlanStrategy strategy = ArenaPlanStrategy::kNearOptimal;
+  // Alignment of the offsets. Must match the tensor alignment of the
+  // interpreter that adopts the plan.
+  size_t alignment = 64;
+  // Maximum number of placement orders tried by the local search of
+  // kNearOptimal.
+  int max_iterations = 2000;
+  uint64_t seed = 0;
+};
+
+// Returns a lower bound of the arena size needed by `allocations`: the
+// largest total aligned size of the tensors live at the same node.
+size_t GetArenaSizeLowerBound(
+    const std::vector<ArenaTensorAllocation>& allocations, size_t alignment);
+
+// Recomputes the offsets of `plan->allocations`, keeping their sizes and
+// usage intervals. Tensors whose usage intervals intersect never overlap in
+// the result.
+void OptimizeArenaMemoryPlan(const ArenaPlanOptimizerOptions& options,
+                             ArenaMemoryPlan* plan);
+
+}  // namespace arena_plan
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_TOOLS_ARENA_PLAN_ARENA_PLAN_OPTIMIZER_H_
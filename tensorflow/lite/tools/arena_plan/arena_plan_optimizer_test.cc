@@ -0,0 +1,139 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/tools/arena_plan/arena_plan_optimizer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "tensorflow/lite/arena_memory_plan.h"
+
+namespace tflite {
+namespace arena_plan {
+namespace {
+
+ArenaMemoryPlan MakePlan(
+    const std::vector<ArenaTensorAllocation>& allocations) {
+  ArenaMemoryPlan plan;
+  plan.allocations = allocations;
+  return plan;
+}
+
+ArenaMemoryPlan Optimize(ArenaPlanStrategy strategy, size_t alignment,
+                         ArenaMemoryPlan plan) {
+  ArenaPlanOptimizerOptions options;
+  options.strategy = strategy;
+  options.alignment = alignment;
+  OptimizeArenaMemoryPlan(options, &plan);
+  return plan;
+}
+
+void ExpectValid(const ArenaMemoryPlan& plan, size_t alignment) {
+  const std::vector<ArenaTensorAllocation>& allocations = plan.allocations;
+  for (int i = 0; i < allocations.size(); ++i) {
+    const ArenaTensorAllocation& a = allocations[i];
+    EXPECT_EQ(a.offset % alignment, 0);
+    for (int j = i + 1; j < allocations.size(); ++j) {
+      const ArenaTensorAllocation& b = allocations[j];
+      if (a.size == 0 || b.size == 0 || a.last_node < b.first_node ||
+          b.last_node < a.first_node) {
+        continue;
+      }
+      EXPECT_TRUE(a.offset + a.size <= b.offset ||
+                  b.offset + b.size <= a.offset)
+          << "tensors " << a.tensor << " and " << b.tensor << " overlap";
+    }
+  }
+}
+
+TEST(ArenaPlanOptimizerTest, EmptyPlan) {
+  ArenaMemoryPlan plan;
+  OptimizeArenaMemoryPlan(ArenaPlanOptimizerOptions(), &plan);
+  EXPECT_TRUE(plan.allocations.empty());
+  EXPECT_EQ(GetArenaSizeLowerBound(plan.allocations, 64), 0);
+}
+
+TEST(ArenaPlanOptimizerTest, GreedyBySizeReusesMemory) {
+  // A chain of ops, where each output only lives until the next op.
+  const ArenaMemoryPlan plan = Optimize(ArenaPlanStrategy::kGreedyBySize, 4,
+                                        MakePlan({{0, 0, 16, 0, 1},
+                                                  {1, 0, 8, 1, 2},
+                                                  {2, 0, 16, 2, 3}}));
+  ExpectValid(plan, 4);
+  EXPECT_EQ(plan.allocations[0].offset, plan.allocations[2].offset);
+  EXPECT_EQ(GetArenaSize(plan), 24);
+}
+
+TEST(ArenaPlanOptimizerTest, LowerBoundAccountsForAlignment) {
+  const std::vector<ArenaTensorAllocation> allocations = {
+      {0, 0, 3, 0, 1}, {1, 0, 5, 1, 2}, {2, 0, 1, 2, 2}};
+  // At node 1, 3 and 5 bytes are live: 4 + 5 with 4-byte alignment.
+  EXPECT_EQ(GetArenaSizeLowerBound(allocations, 4), 9);
+  EXPECT_EQ(GetArenaSizeLowerBound(allocations, 1), 8);
+}
+
+TEST(ArenaPlanOptimizerTest, NearOptimalBeatsGreedyBySize) {
+  // Placing the largest tensor first wastes a byte: the tensor of size 2
+  // living in [2, 4] then has to go on top of both its neighbours.
+  const ArenaMemoryPlan plan = MakePlan({{0, 0, 2, 0, 1},
+                                         {1, 0, 2, 1, 2},
+                                         {2, 0, 3, 3, 5},
+                                         {3, 0, 2, 2, 4}});
+  const ArenaMemoryPlan greedy =
+      Optimize(ArenaPlanStrategy::kGreedyBySize, 1, plan);
+  const ArenaMemoryPlan near_optimal =
+      Optimize(ArenaPlanStrategy::kNearOptimal, 1, plan);
+  ExpectValid(greedy, 1);
+  ExpectValid(near_optimal, 1);
+  EXPECT_EQ(GetArenaSize(greedy), 6);
+  EXPECT_EQ(GetArenaSize(near_optimal), 5);
+  EXPECT_EQ(GetArenaSize(near_optimal),
+            GetArenaSizeLowerBound(plan.allocations, 1));
+}
+
+TEST(ArenaPlanOptimizerTest, RandomPlansAreValidAndNeverWorse) {
+  std::mt19937 rng(42);
+  for (int trial = 0; trial < 50; ++trial) {
+    std::vector<ArenaTensorAllocation> allocations;
+    const int num_tensors = 1 + rng() % 40;
+    for (int i = 0; i < num_tensors; ++i) {
+      ArenaTensorAllocation allocation;
+      allocation.tensor = i;
+      allocation.size = rng() % 1000;
+      allocation.first_node = rng() % 20;
+      allocation.last_node = rng() % 8 == 0
+                                 ? std::numeric_limits<int32_t>::max()
+                                 : allocation.first_node + rng() % 5;
+      allocations.push_back(allocation);
+    }
+    const ArenaMemoryPlan plan = MakePlan(allocations);
+    const ArenaMemoryPlan greedy =
+        Optimize(ArenaPlanStrategy::kGreedyBySize, 64, plan);
+    const ArenaMemoryPlan near_optimal =
+        Optimize(ArenaPlanStrategy::kNearOptimal, 64, plan);
+    ExpectValid(greedy, 64);
+    ExpectValid(near_optimal, 64);
+    EXPECT_LE(GetArenaSize(near_optimal), GetArenaSize(greedy));
+    EXPECT_GE(GetArenaSize(near_optimal),
+              GetArenaSizeLowerBound(allocations, 64));
+  }
+}
+
+}  // namespace
+}  // namespace arena_plan
+}  // namespace tflite
@@ -0,0 +1,128 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/tools/arena_plan/arena_plan_util.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "flatbuffers/flatbuffer_builder.h"  // from @flatbuffers
+#include "tensorflow/lite/arena_memory_plan.h"
+#include "tensorflow/lite/core/api/op_resolver.h"
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/subgraph.h"
+#include "tensorflow/lite/interpreter.h"
+#include "tensorflow/lite/interpreter_builder.h"
+#include "tensorflow/lite/model_builder.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+#include "tensorflow/lite/tools/arena_plan/arena_plan_optimizer.h"
+
+namespace tflite {
+namespace arena_plan {
+
+absl::Status ComputeArenaMemoryPlans(
+    const FlatBufferModel& model, const OpResolver& op_resolver,
+    const std::vector<InputShapes>& input_shapes,
+    const ArenaPlanOptimizerOptions& options, ModelArenaMemoryPlans* plans) {
+  if (plans == nullptr) {
+    return absl::InvalidArgumentError("Arguments must not be nullptr");
+  }
+  for (const InputShapes& shapes : input_shapes) {
+    std::unique_ptr<Interpreter> interpreter;
+    if (InterpreterBuilder(model, op_resolver)(&interpreter) != kTfLiteOk) {
+      return absl::InternalError("Failed to build the interpreter");
+    }
+    if (!shapes.empty()) {
+      if (shapes.size() != interpreter->inputs().size()) {
+        return absl::InvalidArgumentError(
+            absl::StrCat("Expected ", interpreter->inputs().size(),
+                         " input shapes, got ", shapes.size()));
+      }
+      for (int i = 0; i < shapes.size(); ++i) {
+        if (interpreter->ResizeInputTensor(interpreter->inputs()[i],
+                                           shapes[i]) != kTfLiteOk) {
+          return absl::InvalidArgumentError(
+              absl::StrCat("Failed to resize input ", i));
+        }
+      }
+    }
+    if (interpreter->AllocateTensors() != kTfLiteOk) {
+      return absl::InternalError("Failed to allocate tensors");
+    }
+    for (int i = 0; i < interpreter->subgraphs_size(); ++i) {
+      ArenaMemoryPlan plan;
+      if (interpreter->subgraph(i)->GetArenaMemoryPlan(&plan) != kTfLiteOk ||
+          plan.allocations.empty()) {
+        // The subgraph was not allocated, e.g. the body of a control flow op
+        // which is only allocated when invoked.
+        continue;
+      }
+      const size_t runtime_size = GetArenaSize(plan);
+      OptimizeArenaMemoryPlan(options, &plan);
+      LOG(INFO) << "Subgraph " << i << ": arena size "
+                << GetArenaSize(plan) << " bytes, planned at runtime "
+                << runtime_size << " bytes, lower bound "
+                << GetArenaSizeLowerBound(plan.allocations, options.alignment)
+                << " bytes.";
+      plans->push_back(std::move(plan));
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status SetArenaMemoryPlans(const Model* model,
+                                 const ModelArenaMemoryPlans& plans,
+                                 std::string* model_data) {
+  if (!model || !model_data) {
+    return absl::InvalidArgumentError("Arguments must not be nullptr");
+  }
+  auto mutable_model = std::make_unique<ModelT>();
+  model->UnPackTo(mutable_model.get(), nullptr);
+  uint32_t buffer_id = mutable_model->buffers.size();
+  for (const auto& metadata : mutable_model->metadata) {
+    if (metadata->name == kArenaMemoryPlanMetadataKey) {
+      buffer_id = metadata->buffer;
+      if (buffer_id >= mutable_model->buffers.size()) {
+        return absl::InternalError("Invalid buffer index in metadata");
+      }
+      break;
+    }
+  }
+  if (buffer_id == mutable_model->buffers.size()) {
+    mutable_model->buffers.push_back(std::make_unique<BufferT>());
+    auto metadata = std::make_unique<MetadataT>();
+    metadata->name = kArenaMemoryPlanMetadataKey;
+    metadata->buffer = buffer_id;
+    mutable_model->metadata.push_back(std::move(metadata));
+  }
+  const std::string serialized = SerializeArenaMemoryPlans(plans);
+  mutable_model->buffers[buffer_id]->data.assign(serialized.begin(),
+                                                 serialized.end());
+  flatbuffers::FlatBufferBuilder builder;
+  flatbuffers::Offset<Model> packed_model =
+      Model::Pack(builder, mutable_model.get());
+  FinishModelBuffer(builder, packed_model);
+  model_data->assign(reinterpret_cast<const char*>(builder.GetBufferPointer()),
+                     builder.GetSize());
+  return absl::OkStatus();
+}
+
+}  // namespace arena_plan
+}  // namespace tflite
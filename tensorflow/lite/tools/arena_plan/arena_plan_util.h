@@ -0,0 +1,53 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_TOOLS_ARENA_PLAN_ARENA_PLAN_UTIL_H_
+#define TENSORFLOW_LITE_TOOLS_ARENA_PLAN_ARENA_PLAN_UTIL_H_
+
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "tensorflow/lite/arena_memory_plan.h"
+#include "tensorflow/lite/core/api/op_resolver.h"
+#include "tensorflow/lite/model_builder.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+#include "tensorflow/lite/tools/arena_plan/arena_plan_optimizer.h"
+
+namespace tflite {
+namespace arena_plan {
+
+// The shapes of the inputs of the primary subgraph, in order. An empty vector
+// stands for the shapes stored in the model.
+using InputShapes = std::vector<std::vector<int>>;
+
+// Builds an interpreter for `model` for each of `input_shapes`, allocates its
+// tensors, and appends the memory plans of all its allocated subgraphs to
+// `plans`, with offsets recomputed according to `options`.
+absl::Status ComputeArenaMemoryPlans(
+    const FlatBufferModel& model, const OpResolver& op_resolver,
+    const std::vector<InputShapes>& input_shapes,
+    const ArenaPlanOptimizerOptions& options, ModelArenaMemoryPlans* plans);
+
+// Results in `model_data` containing a serialized model identical to `model`
+// with `plans` stored in the metadata under `kArenaMemoryPlanMetadataKey`.
+// Plans already stored in `model` are overwritten.
+absl::Status SetArenaMemoryPlans(const Model* model,
+                                 const ModelArenaMemoryPlans& plans,
+                                 std::string* model_data);
+
+}  // namespace arena_plan
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_TOOLS_ARENA_PLAN_ARENA_PLAN_UTIL_H_
@@ -0,0 +1,107 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/tools/arena_plan/arena_plan_util.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "tensorflow/lite/arena_memory_plan.h"
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/kernels/register.h"
+#include "tensorflow/lite/core/subgraph.h"
+#include "tensorflow/lite/interpreter.h"
+#include "tensorflow/lite/interpreter_builder.h"
+#include "tensorflow/lite/model_builder.h"
+#include "tensorflow/lite/tools/arena_plan/arena_plan_optimizer.h"
+
+namespace tflite {
+namespace arena_plan {
+namespace {
+
+constexpr char kModelPath[] = "tensorflow/lite/testdata/multi_add.bin";
+
+std::map<int, ArenaTensorAllocation> ByTensor(const ArenaMemoryPlan& plan) {
+  std::map<int, ArenaTensorAllocation> allocations;
+  for (const ArenaTensorAllocation& allocation : plan.allocations) {
+    allocations[allocation.tensor] = allocation;
+  }
+  return allocations;
+}
+
+TEST(ArenaPlanUtilTest, InterpreterAdoptsStoredPlans) {
+  std::unique_ptr<FlatBufferModel> model =
+      FlatBufferModel::BuildFromFile(kModelPath);
+  ASSERT_NE(model, nullptr);
+  ops::builtin::BuiltinOpResolverWithoutDefaultDelegates op_resolver;
+  const InputShapes batched(4, {2, 8, 8, 3});
+  ModelArenaMemoryPlans plans;
+  ASSERT_TRUE(ComputeArenaMemoryPlans(*model, op_resolver, {{}, batched},
+                                      ArenaPlanOptimizerOptions(), &plans)
+                  .ok());
+  ASSERT_EQ(plans.size(), 2);
+  EXPECT_EQ(plans[0].input_shapes, InputShapes(4, {1, 8, 8, 3}));
+  EXPECT_EQ(plans[1].input_shapes, batched);
+
+  std::string model_data;
+  ASSERT_TRUE(
+      SetArenaMemoryPlans(model->GetModel(), plans, &model_data).ok());
+  std::unique_ptr<FlatBufferModel> planned_model =
+      FlatBufferModel::BuildFromBuffer(model_data.data(), model_data.size());
+  ASSERT_NE(planned_model, nullptr);
+  std::unique_ptr<Interpreter> interpreter;
+  ASSERT_EQ(InterpreterBuilder(*planned_model, op_resolver)(&interpreter),
+            kTfLiteOk);
+
+  for (const ArenaMemoryPlan& expected : plans) {
+    for (int i = 0; i < interpreter->inputs().size(); ++i) {
+      ASSERT_EQ(interpreter->ResizeInputTensor(interpreter->inputs()[i],
+                                               expected.input_shapes[i]),
+                kTfLiteOk);
+    }
+    ASSERT_EQ(interpreter->AllocateTensors(), kTfLiteOk);
+    ArenaMemoryPlan actual;
+    ASSERT_EQ(interpreter->subgraph(0)->GetArenaMemoryPlan(&actual),
+              kTfLiteOk);
+    const std::map<int, ArenaTensorAllocation> expected_allocations =
+        ByTensor(expected);
+    const std::map<int, ArenaTensorAllocation> actual_allocations =
+        ByTensor(actual);
+    ASSERT_EQ(actual_allocations.size(), expected_allocations.size());
+    for (const auto& [tensor, allocation] : expected_allocations) {
+      EXPECT_EQ(actual_allocations.at(tensor).offset, allocation.offset);
+    }
+    Subgraph::SubgraphAllocInfo alloc_info;
+    interpreter->subgraph(0)->GetMemoryAllocInfo(&alloc_info);
+    EXPECT_LE(GetArenaSize(expected), alloc_info.arena_size);
+  }
+}
+
+TEST(ArenaPlanUtilTest, RejectsWrongNumberOfInputShapes) {
+  std::unique_ptr<FlatBufferModel> model =
+      FlatBufferModel::BuildFromFile(kModelPath);
+  ASSERT_NE(model, nullptr);
+  ops::builtin::BuiltinOpResolverWithoutDefaultDelegates op_resolver;
+  ModelArenaMemoryPlans plans;
+  EXPECT_FALSE(ComputeArenaMemoryPlans(*model, op_resolver, {{{1, 8, 8, 3}}},
+                                       ArenaPlanOptimizerOptions(), &plans)
+                   .ok());
+}
+
+}  // namespace
+}  // namespace arena_plan
+}  // namespace tflite
@@ -0,0 +1,161 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+// Binary to compute the arena memory plans of a model ahead of time and store
+// them in its metadata, where the interpreter picks them up.
+//
+// Example:
+//   optimize_arena_plan --input_model=model.tflite \
+//     --output_model=planned.tflite \
+//     --input_shapes="1,224,224,3;4,224,224,3"
+#include <fstream>  // NOLINT
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
+#include "tensorflow/lite/arena_memory_plan.h"
+#include "tensorflow/lite/core/kernels/register.h"
+#include "tensorflow/lite/model_builder.h"
+#include "tensorflow/lite/tools/arena_plan/arena_plan_optimizer.h"
+#include "tensorflow/lite/tools/arena_plan/arena_plan_util.h"
+#include "tensorflow/lite/tools/command_line_flags.h"
+
+namespace tflite {
+namespace arena_plan {
+namespace {
+
+constexpr char kInputModelFlag[] = "input_model";
+constexpr char kOutputModelFlag[] = "output_model";
+constexpr char kInputShapesFlag[] = "input_shapes";
+constexpr char kStrategyFlag[] = "strategy";
+constexpr char kMaxIterationsFlag[] = "max_iterations";
+constexpr char kUseDefaultDelegatesFlag[] = "use_default_delegates";
+
+// Parses shapes like "1,224,224,3:1,10;4,224,224,3:4,10": sets of input
+// shapes are separated by ';', inputs by ':' and dimensions by ','.
+bool ParseInputShapes(const std::string& flag,
+                      std::vector<InputShapes>* input_shapes) {
+  for (absl::string_view bucket :
+       absl::StrSplit(flag, ';', absl::SkipEmpty())) {
+    InputShapes& shapes = input_shapes->emplace_back();
+    for (absl::string_view input : absl::StrSplit(bucket, ':')) {
+      std::vector<int>& shape = shapes.emplace_back();
+      for (absl::string_view dim :
+           absl::StrSplit(input, ',', absl::SkipEmpty())) {
+        if (!absl::SimpleAtoi(dim, &shape.emplace_back())) {
+          return false;
+        }
+      }
+    }
+  }
+  if (input_shapes->empty()) {
+    // Plan for the shapes stored in the model.
+    input_shapes->emplace_back();
+  }
+  return true;
+}
+
+int Main(int argc, char* argv[]) {
+  std::string input_model_path;
+  std::string output_model_path;
+  std::string input_shapes_flag;
+  std::string strategy = "near_optimal";
+  int max_iterations = ArenaPlanOptimizerOptions().max_iterations;
+  bool use_default_delegates = true;
+
+  std::vector<Flag> flag_list = {
+      Flag::CreateFlag(kInputModelFlag, &input_model_path,
+                       "Path to the input TFLite model."),
+      Flag::CreateFlag(kOutputModelFlag, &output_model_path,
+                       "Path to the output TFLite model."),
+      Flag::CreateFlag(kInputShapesFlag, &input_shapes_flag,
+                       "Sets of input shapes to plan for, separated by ';'. "
+                       "The shapes of a set are separated by ':', and their "
+                       "dimensions by ','. Defaults to the model's shapes."),
+      Flag::CreateFlag(kStrategyFlag, &strategy,
+                       "Either 'greedy' or 'near_optimal'."),
+      Flag::CreateFlag(kMaxIterationsFlag, &max_iterations,
+                       "Number of local search iterations of 'near_optimal'."),
+      Flag::CreateFlag(kUseDefaultDelegatesFlag, &use_default_delegates,
+                       "Whether to plan for the graph after applying the "
+                       "default delegates. Must match the interpreter which "
+                       "runs the model."),
+  };
+  if (!Flags::Parse(&argc, const_cast<const char**>(argv), flag_list) ||
+      input_model_path.empty() || output_model_path.empty()) {
+    LOG(ERROR) << Flags::Usage(argv[0], flag_list);
+    return 1;
+  }
+
+  ArenaPlanOptimizerOptions options;
+  options.max_iterations = max_iterations;
+  if (strategy == "greedy") {
+    options.strategy = ArenaPlanStrategy::kGreedyBySize;
+  } else if (strategy == "near_optimal") {
+    options.strategy = ArenaPlanStrategy::kNearOptimal;
+  } else {
+    LOG(ERROR) << "Unknown strategy: " << strategy;
+    return 1;
+  }
+  std::vector<InputShapes> input_shapes;
+  if (!ParseInputShapes(input_shapes_flag, &input_shapes)) {
+    LOG(ERROR) << "Invalid input shapes: " << input_shapes_flag;
+    return 1;
+  }
+
+  std::unique_ptr<FlatBufferModel> model =
+      FlatBufferModel::BuildFromFile(input_model_path.c_str());
+  if (!model) {
+    LOG(ERROR) << "Failed to load " << input_model_path;
+    return 1;
+  }
+  std::unique_ptr<OpResolver> op_resolver;
+  if (use_default_delegates) {
+    op_resolver = std::make_unique<ops::builtin::BuiltinOpResolver>();
+  } else {
+    op_resolver = std::make_unique<
+        ops::builtin::BuiltinOpResolverWithoutDefaultDelegates>();
+  }
+
+  ModelArenaMemoryPlans plans;
+  absl::Status status = ComputeArenaMemoryPlans(*model, *op_resolver,
+                                                input_shapes, options, &plans);
+  std::string output_model;
+  if (status.ok()) {
+    status = SetArenaMemoryPlans(model->GetModel(), plans, &output_model);
+  }
+  if (!status.ok()) {
+    LOG(ERROR) << status;
+    return 1;
+  }
+
+  std::ofstream output_file_stream(output_model_path, std::ios::binary);
+  output_file_stream << output_model;
+  output_file_stream.close();
+  LOG(INFO) << "Wrote " << plans.size() << " arena memory plans to "
+            << output_model_path;
+  return 0;
+}
+
+}  // namespace
+}  // namespace arena_plan
+}  // namespace tflite
+
+int main(int argc, char* argv[]) {
+  return tflite::arena_plan::Main(argc, argv);
+}
@@ -54,6 +54,7 @@ limitations under the License.
 #include "tensorflow/lite/optional_debug_tools.h"
 #include "tensorflow/lite/profiling/model_runtime_info.h"
 #include "tensorflow/lite/profiling/profile_summary_formatter.h"
+#include "tensorflow/lite/profiling/time.h"
 #include "tensorflow/lite/string_util.h"
 #include "tensorflow/lite/tools/benchmark/benchmark_params.h"
 #include "tensorflow/lite/tools/benchmark/benchmark_utils.h"
@@ -1337,10 +1338,27 @@ TfLiteStatus BenchmarkTfLiteModel::Init() {
     }
   }
 
+  const int64_t allocation_start_us = profiling::time::NowMicros();
   if (interpreter_runner_->AllocateTensors() != kTfLiteOk) {
     TFLITE_LOG(ERROR) << "Failed to allocate tensors!";
     return kTfLiteError;
   }
+  const int64_t allocation_end_us = profiling::time::NowMicros();
+  // Report the memory planning cost and the resulting arena sizes, e.g. to
+  // compare models with and without arena memory plans in their metadata.
+  size_t arena_size = 0;
+  size_t arena_persist_size = 0;
+  for (int i = 0; i < interpreter_->subgraphs_size(); ++i) {
+    Subgraph::SubgraphAllocInfo alloc_info;
+    interpreter_->subgraph(i)->GetMemoryAllocInfo(&alloc_info);
+    arena_size += alloc_info.arena_size;
+    arena_persist_size += alloc_info.arena_persist_size;
+  }
+  TFLITE_LOG(INFO) << "Tensor allocation took "
+                   << (allocation_end_us - allocation_start_us) / 1000.0
+                   << " ms, arena: " << arena_size / 1024.0
+                   << " KB, persistent arena: " << arena_persist_size / 1024.0
+                   << " KB.";
 
   AddOwnedListener(
       std::unique_ptr<BenchmarkListener>(new RuyProfileListener()));
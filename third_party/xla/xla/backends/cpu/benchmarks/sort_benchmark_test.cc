@@ -0,0 +1,154 @@
+/* Copyright 2026 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "xla/backends/cpu/benchmarks/hlo_benchmark_runner.h"
+#include "xla/backends/cpu/benchmarks/multi_benchmark_config.h"
+#include "xla/literal_util.h"
+#include "xla/shape_util.h"
+#include "xla/tsl/platform/test_benchmark.h"
+#include "xla/xla_data.pb.h"
+
+namespace xla::cpu {
+
+static void BM_Sort_F32(benchmark::State& state, HloBenchmarkOptions options) {
+  int64_t batch = state.range(0);
+  int64_t length = state.range(1);
+  bool ascending = state.range(2);
+
+  absl::string_view hlo = R"(
+    HloModule sort
+
+    compare {
+      p0 = f32[] parameter(0)
+      p1 = f32[] parameter(1)
+      ROOT compare = pred[] compare(p0, p1), direction=$direction
+    }
+
+    ENTRY test {
+      x = f32[$batch,$length] parameter(0)
+      ROOT sort = f32[$batch,$length] sort(x), dimensions={1}, to_apply=compare
+    }
+  )";
+
+  // Fixed seed to avoid too inconsistent runs
+  std::minstd_rand0 engine(/*seed=*/0xCAFEFEED);
+  auto x = LiteralUtil::CreateRandomLiteral<F32>(
+               ShapeUtil::MakeShape(F32, {batch, length}), &engine, 1.0f, 0.1f)
+               .value();
+
+  CHECK_OK(RunHloBenchmark(state, hlo, {&x},
+                           {{"$batch", absl::StrCat(batch)},
+                            {"$length", absl::StrCat(length)},
+                            {"$direction", ascending ? "LT" : "GT"}},
+                           options));
+}
+
+static void BM_Sort_S32(benchmark::State& state, HloBenchmarkOptions options) {
+  int64_t batch = state.range(0);
+  int64_t length = state.range(1);
+  bool ascending = state.range(2);
+
+  absl::string_view hlo = R"(
+    HloModule sort
+
+    compare {
+      p0 = s32[] parameter(0)
+      p1 = s32[] parameter(1)
+      ROOT compare = pred[] compare(p0, p1), direction=$direction
+    }
+
+    ENTRY test {
+      x = s32[$batch,$length] parameter(0)
+      ROOT sort = s32[$batch,$length] sort(x), dimensions={1}, to_apply=compare
+    }
+  )";
+
+  std::minstd_rand0 engine(/*seed=*/0xCAFEFEED);
+  auto x = LiteralUtil::CreateRandomLiteral<S32>(
+               ShapeUtil::MakeShape(S32, {batch, length}), &engine, 1 << 20,
+               1 << 16)
+               .value();
+
+  CHECK_OK(RunHloBenchmark(state, hlo, {&x},
+                           {{"$batch", absl::StrCat(batch)},
+                            {"$length", absl::StrCat(length)},
+                            {"$direction", ascending ? "LT" : "GT"}},
+                           options));
+}
+
+// Sorts keys together with their indices (argsort).
+static void BM_ArgSort_F32(benchmark::State& state,
+                           HloBenchmarkOptions options) {
+  int64_t batch = state.range(0);
+  int64_t length = state.range(1);
+  bool ascending = state.range(2);
+
+  absl::string_view hlo = R"(
+    HloModule argsort
+
+    compare {
+      p0 = f32[] parameter(0)
+      p1 = f32[] parameter(1)
+      p2 = s32[] parameter(2)
+      p3 = s32[] parameter(3)
+      ROOT compare = pred[] compare(p0, p1), direction=$direction
+    }
+
+    ENTRY test {
+      x = f32[$batch,$length] parameter(0)
+      iota = s32[$batch,$length] iota(), iota_dimension=1
+      ROOT sort = (f32[$batch,$length], s32[$batch,$length]) sort(x, iota),
+        dimensions={1}, to_apply=compare
+    }
+  )";
+
+  std::minstd_rand0 engine(/*seed=*/0xCAFEFEED);
+  auto x = LiteralUtil::CreateRandomLiteral<F32>(
+               ShapeUtil::MakeShape(F32, {batch, length}), &engine, 1.0f, 0.1f)
+               .value();
+
+  CHECK_OK(RunHloBenchmark(state, hlo, {&x},
+                           {{"$batch", absl::StrCat(batch)},
+                            {"$length", absl::StrCat(length)},
+                            {"$direction", ascending ? "LT" : "GT"}},
+                           options));
+}
+
+#define BENCHMARK_SORT(name)                       \
+  XLA_CPU_BENCHMARK(name)                          \
+      ->MeasureProcessCPUTime()                    \
+      ->ArgNames({"batch", "length", "ascending"}) \
+      ->Args({1, 1024, true})                      \
+      ->Args({1, 1024, false})                     \
+      ->Args({1, 65536, true})                     \
+      ->Args({1, 65536, false})                    \
+      ->Args({1, 1048576, true})                   \
+      ->Args({1, 1048576, false})                  \
+      ->Args({64, 1024, true})                     \
+      ->Args({64, 16384, true})                    \
+      ->Args({1024, 128, true})
+
+BENCHMARK_SORT(BM_Sort_F32);
+BENCHMARK_SORT(BM_Sort_S32);
+BENCHMARK_SORT(BM_ArgSort_F32);
+
+}  // namespace xla::cpu
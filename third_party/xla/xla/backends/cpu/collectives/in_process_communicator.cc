@@ -20,7 +20,6 @@ limitations under the License.
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
-#include <limits>
 #include <optional>
 #include <string>
 #include <vector>
@@ -137,24 +136,6 @@ std::vector<Participant> CollectParticipants(
   return ret;
 }
 
-template <typename T>
-T GetInitialValue(ReductionKind reduction_kind) {
-  switch (reduction_kind) {
-    case ReductionKind::SUM:
-      return static_cast<T>(0);
-    case ReductionKind::PRODUCT:
-      return static_cast<T>(1);
-    case ReductionKind::MIN:
-      return std::numeric_limits<T>::has_infinity
-                 ? std::numeric_limits<T>::infinity()
-                 : std::numeric_limits<T>::max();
-    case ReductionKind::MAX:
-      return std::numeric_limits<T>::has_infinity
-                 ? -std::numeric_limits<T>::infinity()
-                 : std::numeric_limits<T>::lowest();
-  }
-}
-
 // We cannot use static_assert(false), because the C++ standard (prior to
 // CWG2518) does not allow the statement discarded by a constexpr if to
 // be ill-formed for every possible specialization.
@@ -162,9 +143,15 @@ T GetInitialValue(ReductionKind reduction_kind) {
 template <ReductionKind>
 constexpr bool always_false_v = false;
 
+// Participants reduce chunks of the data aligned to the cache line size, so
+// that they never write to the same cache line.
+static constexpr size_t kChunkAlignmentBytes = 64;
+
+// Reductions are done in tiles small enough to keep the accumulator in L1.
+static constexpr size_t kReductionTileBytes = 4096;
+
 template <ReductionKind reduction_kind, typename T>
 void ReduceHelper(absl::Span<T> acc, absl::Span<T const* const> inputs) {
-  // TODO(penporn): make sure this gets vectorized.
   if constexpr (reduction_kind == ReductionKind::SUM) {
     for (size_t j = 0; j < inputs.size(); ++j) {
       for (size_t i = 0; i < acc.size(); ++i) {
@@ -194,31 +181,55 @@ void ReduceHelper(absl::Span<T> acc, absl::Span<T const* const> inputs) {
   }
 }
 
+// Reduces `num_elems` elements of all `inputs` and writes the result to all
+// `outputs`. Each tile is reduced into a local accumulator, which can't alias
+// the inputs and stays in L1, and is then copied to all outputs. This way
+// every input and output element is touched exactly once.
+template <ReductionKind reduction_kind, typename T>
+void ReduceTiles(absl::Span<T const* const> inputs,
+                 absl::Span<T* const> outputs, size_t num_elems) {
+  static constexpr size_t kTileSize =
+      std::max<size_t>(1, kReductionTileBytes / sizeof(T));
+  alignas(kChunkAlignmentBytes) T acc[kTileSize];
+
+  absl::InlinedVector<T const*, 8> tile_inputs(inputs.size() - 1);
+  for (size_t offset = 0; offset < num_elems; offset += kTileSize) {
+    size_t tile_size = std::min(kTileSize, num_elems - offset);
+    std::copy_n(inputs[0] + offset, tile_size, acc);
+    for (size_t j = 1; j < inputs.size(); ++j) {
+      tile_inputs[j - 1] = inputs[j] + offset;
+    }
+    ReduceHelper<reduction_kind, T>(absl::MakeSpan(acc, tile_size),
+                                    tile_inputs);
+    for (T* output : outputs) {
+      std::memcpy(output + offset, acc, tile_size * sizeof(T));
+    }
+  }
+}
+
 template <PrimitiveType PT>
-absl::Status ReduceScatter(ReductionKind reduction_kind,
-                           absl::Span<const void* const> inputs, void* output,
-                           int64_t num_elems) {
+absl::Status Reduce(ReductionKind reduction_kind,
+                    absl::Span<const void* const> inputs,
+                    absl::Span<void* const> outputs, int64_t num_elems) {
   using T = primitive_util::NativeTypeOf<PT>;
-  T initial_value = GetInitialValue<T>(reduction_kind);
-
-  absl::Span<T> out_chunk =
-      absl::MakeSpan(reinterpret_cast<T*>(output), num_elems);
-  for (int64_t i = 0; i < num_elems; ++i) {
-    out_chunk[i] = initial_value;
-  }
 
-  absl::Span<T const* const> input_chunks(
+  absl::Span<T const* const> typed_inputs(
       reinterpret_cast<T const* const*>(inputs.data()), inputs.size());
+  absl::Span<T* const> typed_outputs(
+      reinterpret_cast<T* const*>(outputs.data()), outputs.size());
   switch (reduction_kind) {
     case ReductionKind::SUM:
-      ReduceHelper<ReductionKind::SUM, T>(out_chunk, input_chunks);
+      ReduceTiles<ReductionKind::SUM, T>(typed_inputs, typed_outputs,
+                                         num_elems);
       break;
     case ReductionKind::PRODUCT:
-      ReduceHelper<ReductionKind::PRODUCT, T>(out_chunk, input_chunks);
+      ReduceTiles<ReductionKind::PRODUCT, T>(typed_inputs, typed_outputs,
+                                             num_elems);
       break;
     case ReductionKind::MIN:
       if constexpr (!is_complex_v<T>) {
-        ReduceHelper<ReductionKind::MIN, T>(out_chunk, input_chunks);
+        ReduceTiles<ReductionKind::MIN, T>(typed_inputs, typed_outputs,
+                                           num_elems);
       } else {
         return absl::InvalidArgumentError(
             "Min reductions not supported for complex types");
@@ -226,7 +237,8 @@ absl::Status ReduceScatter(ReductionKind reduction_kind,
       break;
     case ReductionKind::MAX:
       if constexpr (!is_complex_v<T>) {
-        ReduceHelper<ReductionKind::MAX, T>(out_chunk, input_chunks);
+        ReduceTiles<ReductionKind::MAX, T>(typed_inputs, typed_outputs,
+                                           num_elems);
       } else {
         return absl::InvalidArgumentError(
             "Max reductions not supported for complex types");
@@ -256,9 +268,16 @@ static absl::Status AllReduceOp(
         primitive_util::LowercasePrimitiveTypeName(primitive_type));
   }
 
-  // Each partiticipant will process a single chunk of the data and then copy
-  // the result to all other participants.
-  size_t chunk_size = tsl::MathUtil::CeilOfRatio(count, participants.size());
+  // Each participant reduces a single chunk of the data (reduce-scatter) and
+  // writes the result to all participants (all-gather). Every input and output
+  // byte is touched exactly once, which in shared memory is what ring and tree
+  // algorithms achieve with multiple steps and extra synchronization.
+  size_t num_participants = participants.size();
+  size_t byte_width = primitive_util::ByteWidth(primitive_type);
+  size_t chunk_alignment =
+      std::max<size_t>(1, kChunkAlignmentBytes / byte_width);
+  size_t chunk_size = RoundUpTo(
+      tsl::MathUtil::CeilOfRatio(count, num_participants), chunk_alignment);
 
   // Compute the count of elements to process for the given participant rank.
   size_t chunk_count = std::min(chunk_size * (rank + 1), count) -
@@ -268,33 +287,27 @@ static absl::Status AllReduceOp(
   // Returns a pointer to the chunk of data for the given participant rank.
   auto chunk_ptr = [&](se::DeviceAddressBase mem) -> void* {
     std::byte* ptr = static_cast<std::byte*>(mem.opaque());
-    return ptr + rank * chunk_size * primitive_util::ByteWidth(primitive_type);
+    return ptr + rank * chunk_size * byte_width;
   };
 
   // Collect reduction inputs from all participants.
-  std::vector<const void*> inputs(participants.size());
+  std::vector<const void*> inputs(num_participants);
   for (auto& participant : participants) {
     inputs[participant.rank] = chunk_ptr(participant.src);
   }
 
-  // Reduce all inputs into the destination buffer at rank 0.
-  void* output = chunk_ptr(participants[0].dest);
+  // Write the result to all participants starting from our own destination
+  // buffer, so that concurrent participants write to different buffers.
+  std::vector<void*> outputs(num_participants);
+  for (size_t i = 0; i < num_participants; ++i) {
+    outputs[i] = chunk_ptr(participants[(rank + i) % num_participants].dest);
+  }
 
-  ABSL_RETURN_IF_ERROR(primitive_util::ArrayTypeSwitch(
+  return primitive_util::ArrayTypeSwitch(
       [&](const auto type_tag) {
-        return ReduceScatter<type_tag>(reduction_kind, inputs, output,
-                                       chunk_count);
+        return Reduce<type_tag>(reduction_kind, inputs, outputs, chunk_count);
       },
-      primitive_type));
-
-  // Copy all-reduced output to all other participants.
-  for (size_t i = 1; i < participants.size(); ++i) {
-    std::memcpy(chunk_ptr(participants[i].dest),
-                chunk_ptr(participants[0].dest),
-                chunk_count * primitive_util::ByteWidth(primitive_type));
-  }
-
-  return absl::OkStatus();
+      primitive_type);
 }
 
 //===----------------------------------------------------------------------===//
@@ -331,13 +344,11 @@ static absl::Status ReduceScatterOp(
   // Reduce all inputs into the destination buffer.
   void* output = participants[rank].dest.opaque();
 
-  ABSL_RETURN_IF_ERROR(primitive_util::ArrayTypeSwitch(
+  return primitive_util::ArrayTypeSwitch(
       [&](const auto type_tag) {
-        return ReduceScatter<type_tag>(reduction_kind, inputs, output, count);
+        return Reduce<type_tag>(reduction_kind, inputs, {output}, count);
       },
-      primitive_type));
-
-  return absl::OkStatus();
+      primitive_type);
 }
 
 //===----------------------------------------------------------------------===//
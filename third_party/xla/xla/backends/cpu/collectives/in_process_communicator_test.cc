@@ -0,0 +1,195 @@
+/* Copyright 2026 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/backends/cpu/collectives/in_process_communicator.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/blocking_counter.h"
+#include "absl/time/time.h"
+#include "xla/backends/cpu/collectives/cpu_collectives.h"
+#include "xla/executable_run_options.h"
+#include "xla/runtime/device_id.h"
+#include "xla/service/collective_ops_utils.h"
+#include "xla/stream_executor/device_address.h"
+#include "xla/tsl/platform/env.h"
+#include "xla/tsl/platform/test.h"
+#include "xla/tsl/platform/test_benchmark.h"
+#include "xla/tsl/platform/threadpool.h"
+#include "xla/xla_data.pb.h"
+
+namespace xla::cpu {
+namespace {
+
+constexpr absl::Duration kTimeout = absl::Seconds(5);
+
+template <typename T>
+se::DeviceAddressBase AsDeviceMemory(std::vector<T>& data) {
+  return se::DeviceAddressBase(data.data(), data.size() * sizeof(T));
+}
+
+CpuCollectives::Executor MakeExecutor(size_t num_participants,
+                                      int64_t op_id) {
+  std::vector<GlobalDeviceId> global_devices;
+  for (size_t i = 0; i < num_participants; ++i) {
+    global_devices.push_back(GlobalDeviceId(i));
+  }
+  RendezvousKey key(RunId(0), global_devices, num_participants,
+                    RendezvousKey::CollectiveOpKind::kCrossReplica, op_id);
+  return CpuCollectives::Executor(key, kTimeout);
+}
+
+// Runs `fn(rank)` for all ranks concurrently and waits for completion.
+template <typename Fn>
+void RunParticipants(tsl::thread::ThreadPool& thread_pool,
+                     size_t num_participants, Fn fn) {
+  absl::BlockingCounter counter(num_participants);
+  for (size_t rank = 0; rank < num_participants; ++rank) {
+    thread_pool.Schedule([&, rank] {
+      fn(rank);
+      counter.DecrementCount();
+    });
+  }
+  counter.Wait();
+}
+
+class InProcessCommunicatorTest : public testing::TestWithParam<size_t> {};
+
+TEST_P(InProcessCommunicatorTest, AllReduce) {
+  size_t num_participants = GetParam();
+  tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "test",
+                                      num_participants);
+
+  // Not a multiple of the number of participants and of the tile size.
+  constexpr size_t kCount = 4099;
+  std::vector<std::vector<float>> src(num_participants);
+  std::vector<std::vector<float>> dest(num_participants);
+  for (size_t rank = 0; rank < num_participants; ++rank) {
+    for (size_t i = 0; i < kCount; ++i) {
+      src[rank].push_back(rank * 10000.0f + i);
+    }
+    dest[rank].resize(kCount);
+  }
+
+  for (ReductionKind kind : {ReductionKind::SUM, ReductionKind::MAX}) {
+    std::vector<absl::Status> statuses(num_participants);
+    RunParticipants(thread_pool, num_participants, [&](size_t rank) {
+      InProcessCommunicator comm(rank, num_participants);
+      statuses[rank] =
+          comm.AllReduce(AsDeviceMemory(src[rank]), AsDeviceMemory(dest[rank]),
+                         F32, kCount, kind,
+                         MakeExecutor(num_participants,
+                                      static_cast<int64_t>(kind)))
+              .Await();
+    });
+
+    for (size_t rank = 0; rank < num_participants; ++rank) {
+      ASSERT_TRUE(statuses[rank].ok()) << statuses[rank];
+      for (size_t i = 0; i < kCount; ++i) {
+        float expected = kind == ReductionKind::SUM
+                             ? num_participants * (num_participants - 1) / 2 *
+                                       10000.0f +
+                                   num_participants * i
+                             : (num_participants - 1) * 10000.0f + i;
+        ASSERT_EQ(dest[rank][i], expected) << "rank=" << rank << " i=" << i;
+      }
+    }
+  }
+}
+
+TEST_P(InProcessCommunicatorTest, ReduceScatter) {
+  size_t num_participants = GetParam();
+  tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "test",
+                                      num_participants);
+
+  constexpr size_t kCount = 1001;
+  std::vector<std::vector<int32_t>> src(num_participants);
+  std::vector<std::vector<int32_t>> dest(num_participants);
+  for (size_t rank = 0; rank < num_participants; ++rank) {
+    for (size_t i = 0; i < kCount * num_participants; ++i) {
+      src[rank].push_back(rank + i);
+    }
+    dest[rank].resize(kCount);
+  }
+
+  std::vector<absl::Status> statuses(num_participants);
+  RunParticipants(thread_pool, num_participants, [&](size_t rank) {
+    InProcessCommunicator comm(rank, num_participants);
+    statuses[rank] =
+        comm.ReduceScatter(AsDeviceMemory(src[rank]),
+                           AsDeviceMemory(dest[rank]), S32, kCount,
+                           ReductionKind::SUM,
+                           MakeExecutor(num_participants, /*op_id=*/0))
+            .Await();
+  });
+
+  for (size_t rank = 0; rank < num_participants; ++rank) {
+    ASSERT_TRUE(statuses[rank].ok()) << statuses[rank];
+    for (size_t i = 0; i < kCount; ++i) {
+      int32_t expected = num_participants * (num_participants - 1) / 2 +
+                         num_participants * (rank * kCount + i);
+      ASSERT_EQ(dest[rank][i], expected) << "rank=" << rank << " i=" << i;
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(InProcessCommunicator, InProcessCommunicatorTest,
+                         testing::Values(1, 2, 3, 8));
+
+//===----------------------------------------------------------------------===//
+// Performance benchmarks below.
+//===----------------------------------------------------------------------===//
+
+static void BM_AllReduce(benchmark::State& state) {
+  size_t num_participants = state.range(0);
+  size_t num_bytes = state.range(1);
+  size_t count = num_bytes / sizeof(float);
+
+  tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "benchmark",
+                                      num_participants);
+
+  std::vector<std::vector<float>> src(num_participants,
+                                      std::vector<float>(count, 1.0f));
+  std::vector<std::vector<float>> dest(num_participants,
+                                       std::vector<float>(count));
+
+  int64_t op_id = 0;
+  for (auto _ : state) {
+    RunParticipants(thread_pool, num_participants, [&](size_t rank) {
+      InProcessCommunicator comm(rank, num_participants);
+      CHECK_OK(comm.AllReduce(AsDeviceMemory(src[rank]),
+                              AsDeviceMemory(dest[rank]), F32, count,
+                              ReductionKind::SUM,
+                              MakeExecutor(num_participants, op_id))
+                   .Await());
+    });
+    ++op_id;
+  }
+
+  state.SetBytesProcessed(state.iterations() * num_participants * num_bytes);
+}
+
+BENCHMARK(BM_AllReduce)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime()
+    ->ArgNames({"num_participants", "num_bytes"})
+    ->ArgsProduct({{2, 4, 8, 16}, {4 << 10, 256 << 10, 4 << 20, 64 << 20}});
+
+}  // namespace
+}  // namespace xla::cpu
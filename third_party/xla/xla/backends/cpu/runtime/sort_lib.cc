@@ -22,11 +22,14 @@ limitations under the License.
 #include <cstring>
 #include <functional>
 #include <iterator>
+#include <limits>
+#include <numeric>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "absl/base/attributes.h"
+#include "absl/base/casts.h"
 #include "absl/base/dynamic_annotations.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
@@ -649,6 +652,112 @@ void SortInplace(const SortDims& sort_dims, absl::Span<std::byte* const> data,
               less_than);
 }
 
+//===----------------------------------------------------------------------===//
+// LSD radix sort for builtin comparators.
+//===----------------------------------------------------------------------===//
+
+// Slices with fewer elements are sorted with `std::sort` (or
+// `std::stable_sort`), which wins over a radix sort for small inputs.
+static constexpr int64_t kMinRadixSortSize = 1024;
+
+// Sorting by key with a radix sort always wins over sorting with a type-erased
+// iterator, except for tiny inputs where histograms dominate.
+static constexpr int64_t kMinSortByKeySize = 64;
+
+// Unsigned integer type with the same size as `T`.
+template <typename T>
+using RadixKey = std::conditional_t<
+    sizeof(T) == 1, uint8_t,
+    std::conditional_t<sizeof(T) == 2, uint16_t,
+                       std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>>;
+
+// Maps `value` to an unsigned key, such that comparing keys as unsigned
+// integers orders values in the sort `direction`. Negative and positive zeros
+// map to the same key, as they compare equal with builtin comparators.
+template <typename T>
+static ABSL_ATTRIBUTE_ALWAYS_INLINE RadixKey<T> ToRadixKey(
+    T value, SortDirection direction) {
+  using Key = RadixKey<T>;
+  static_assert(sizeof(Key) == sizeof(T));
+  static constexpr Key kSignBit = Key{1} << (8 * sizeof(Key) - 1);
+
+  Key key = absl::bit_cast<Key>(value);
+  if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+    key ^= kSignBit;
+  } else if constexpr (!std::is_integral_v<T>) {
+    if ((key & static_cast<Key>(~kSignBit)) == 0) {
+      key = 0;
+    }
+    key = (key & kSignBit) ? static_cast<Key>(~key) : (key | kSignBit);
+  }
+  return direction == SortDirection::kAscending ? key : static_cast<Key>(~key);
+}
+
+// Sorts contiguous `values` of size `n` with a stable LSD radix sort, one byte
+// of the key per pass. If `indices` is not null, it is permuted together with
+// `values`.
+template <typename T>
+static void RadixSort(T* values, uint32_t* indices, int64_t n,
+                      SortDirection direction) {
+  static constexpr size_t kNumPasses = sizeof(T);
+  static constexpr size_t kNumBuckets = 256;
+
+  // Compute histograms of all passes with a single pass over the data.
+  std::array<std::array<int64_t, kNumBuckets>, kNumPasses> histograms = {};
+  for (int64_t i = 0; i < n; ++i) {
+    RadixKey<T> key = ToRadixKey(values[i], direction);
+    for (size_t pass = 0; pass < kNumPasses; ++pass) {
+      ++histograms[pass][(key >> (8 * pass)) & 0xFF];
+    }
+  }
+
+  std::vector<T> values_scratch(n);
+  std::vector<uint32_t> indices_scratch(indices ? n : 0);
+
+  T* src_values = values;
+  T* dst_values = values_scratch.data();
+  uint32_t* src_indices = indices;
+  uint32_t* dst_indices = indices_scratch.data();
+
+  for (size_t pass = 0; pass < kNumPasses; ++pass) {
+    std::array<int64_t, kNumBuckets>& histogram = histograms[pass];
+    size_t shift = 8 * pass;
+
+    // Skip passes over bytes that are the same for all keys.
+    RadixKey<T> first_key = ToRadixKey(src_values[0], direction);
+    if (histogram[(first_key >> shift) & 0xFF] == n) {
+      continue;
+    }
+
+    // Convert counts to offsets of the buckets.
+    int64_t offset = 0;
+    for (int64_t& count : histogram) {
+      int64_t bucket_size = count;
+      count = offset;
+      offset += bucket_size;
+    }
+
+    for (int64_t i = 0; i < n; ++i) {
+      RadixKey<T> key = ToRadixKey(src_values[i], direction);
+      int64_t dst = histogram[(key >> shift) & 0xFF]++;
+      dst_values[dst] = src_values[i];
+      if (indices) {
+        dst_indices[dst] = src_indices[i];
+      }
+    }
+
+    std::swap(src_values, dst_values);
+    std::swap(src_indices, dst_indices);
+  }
+
+  if (src_values != values) {
+    std::copy_n(src_values, n, values);
+    if (indices) {
+      std::copy_n(src_indices, n, indices);
+    }
+  }
+}
+
 template <class Iterator, class T>
 static void Sort1DInplace(Iterator begin, Iterator end, bool is_stable,
                           SortDirection direction) {
@@ -673,7 +782,11 @@ static void Sort1DInplace(const SortDims& sort_dims, int64_t offset, T* data,
   T* begin = data + offset;
   T* end = begin + sort_dims.sort_dim_size;
 
-  if (sort_dims.inner_dim_size == 1) {
+  if (sort_dims.inner_dim_size == 1 &&
+      sort_dims.sort_dim_size >= kMinRadixSortSize) {
+    RadixSort<T>(begin, /*indices=*/nullptr, sort_dims.sort_dim_size,
+                 direction);
+  } else if (sort_dims.inner_dim_size == 1) {
     Sort1DInplace<T*, T>(begin, end, is_stable, direction);
   } else {
     using Iterator = internal::SortIterator<T, T&, T*>;
@@ -708,12 +821,72 @@ void SortInplace(const SortDims& sort_dims, T* data, bool is_stable,
   SortInplace<T>(sort_dims, 0, num_slices, data, is_stable, direction);
 }
 
+bool CanSortByKeyInplace(const SortDims& sort_dims) {
+  return sort_dims.inner_dim_size == 1 &&
+         sort_dims.sort_dim_size >= kMinSortByKeySize &&
+         sort_dims.sort_dim_size <= std::numeric_limits<uint32_t>::max();
+}
+
+template <typename T>
+void SortByKeyInplace(const SortDims& sort_dims, int64_t start_slice,
+                      int64_t end_slice, absl::Span<std::byte* const> data,
+                      absl::Span<const size_t> primitive_sizes,
+                      SortDirection direction) {
+  DCHECK(CanSortByKeyInplace(sort_dims));
+  DCHECK_LE(0, start_slice);
+  DCHECK_LE(start_slice, end_slice);
+  DCHECK_LE(end_slice, sort_dims.outer_dim_size);
+  DCHECK_EQ(primitive_sizes[0], sizeof(T));
+
+  const int64_t n = sort_dims.sort_dim_size;
+  std::vector<uint32_t> indices(n);
+  std::vector<std::byte> scratch(n * kMaxElementSize);
+
+  for (int64_t i = start_slice; i < end_slice; ++i) {
+    int64_t offset = i * n;
+
+    // Sort keys together with their original positions.
+    std::iota(indices.begin(), indices.end(), 0);
+    RadixSort<T>(reinterpret_cast<T*>(data[0]) + offset, indices.data(), n,
+                 direction);
+
+    // Gather the other inputs in sorted order.
+    for (size_t j = 1; j < data.size(); ++j) {
+      size_t primitive_size = primitive_sizes[j];
+      std::byte* values = data[j] + offset * primitive_size;
+      for (int64_t k = 0; k < n; ++k) {
+        Memcpy(&scratch[k * primitive_size],
+               values + indices[k] * primitive_size, primitive_size);
+      }
+      std::memcpy(values, scratch.data(), n * primitive_size);
+    }
+  }
+}
+
+template <typename T>
+void MergeSortedInplace(T* data, int64_t mid, int64_t size, T* scratch,
+                        SortDirection direction) {
+  DCHECK_LE(0, mid);
+  DCHECK_LE(mid, size);
+  // Compare radix keys, to merge in the order of `RadixSort` (e.g. NaNs are
+  // ordered, and negative and positive zeros are equal).
+  std::merge(data, data + mid, data + mid, data + size, scratch,
+             [direction](T a, T b) {
+               return ToRadixKey(a, direction) < ToRadixKey(b, direction);
+             });
+  std::copy_n(scratch, size, data);
+}
+
 // Declare SortInplace for all supported types. Template is instantiated in
 // the .cc file.
 #define DEFINE_SORT_INPLACE(T)                                              \
   template void SortInplace<T>(const SortDims&, int64_t, int64_t, T*, bool, \
                                SortDirection);                              \
-  template void SortInplace<T>(const SortDims&, T*, bool, SortDirection)
+  template void SortInplace<T>(const SortDims&, T*, bool, SortDirection);   \
+  template void SortByKeyInplace<T>(const SortDims&, int64_t, int64_t,      \
+                                    absl::Span<std::byte* const>,           \
+                                    absl::Span<const size_t>, SortDirection); \
+  template void MergeSortedInplace<T>(T*, int64_t, int64_t, T*, SortDirection)
 
 DEFINE_SORT_INPLACE(float);
 DEFINE_SORT_INPLACE(double);
@@ -31,7 +31,8 @@ namespace xla::cpu::internal {
 //
 // We sort `outer_dim_size * inner_dim_size` vectors of length `sort_dim_size`,
 // by iterating over `data` memory and calling `std::sort` (or
-// `std::stable_sort`) on each (strided) slice of the buffer.
+// `std::stable_sort`) on each (strided) slice of the buffer. Large contiguous
+// slices sorted with a builtin comparator use an LSD radix sort instead.
 struct SortDims {
   int64_t outer_dim_size;
   int64_t sort_dim_size;
@@ -62,6 +63,27 @@ void SortInplace(const SortDims& sort_dims, int64_t start_slice,
                  int64_t end_slice, T* data, bool is_stable,
                  SortDirection direction);
 
+// Returns true if slices of `sort_dims` can be sorted with `SortByKeyInplace`.
+bool CanSortByKeyInplace(const SortDims& sort_dims);
+
+// Sorts `data` by the keys of type `T` in `data[0]` using the sort `direction`
+// with builtin comparator functions for slices in [start_slice, end_slice), and
+// permutes the other inputs together with the keys (i.e. argsort). Sorting is
+// always stable. Requires `CanSortByKeyInplace(sort_dims)`.
+template <typename T>
+void SortByKeyInplace(const SortDims& sort_dims, int64_t start_slice,
+                      int64_t end_slice, absl::Span<std::byte* const> data,
+                      absl::Span<const size_t> primitive_sizes,
+                      SortDirection direction);
+
+// Merges sorted `data[0, mid)` and `data[mid, size)` into sorted
+// `data[0, size)` using the sort `direction`, with `scratch` space for `size`
+// elements. Merging is stable, orders values like the radix sort of
+// `SortInplace`, and combines parts of a slice sorted in parallel.
+template <typename T>
+void MergeSortedInplace(T* data, int64_t mid, int64_t size, T* scratch,
+                        SortDirection direction);
+
 // TODO(b/525327509): Remove full-buffer SortInplace overloads in a follow-up
 // after updating AOT code generation in thunk_proto_execution_deserializer.cc.
 void SortInplace(const SortDims& sort_dims, absl::Span<std::byte* const> data,
@@ -77,7 +99,13 @@ void SortInplace(const SortDims& sort_dims, T* data, bool is_stable,
 #define DECLARE_SORT_INPLACE(T)                                              \
   extern template void SortInplace<T>(const SortDims&, int64_t, int64_t, T*, \
                                       bool, SortDirection);                  \
-  extern template void SortInplace<T>(const SortDims&, T*, bool, SortDirection)
+  extern template void SortInplace<T>(const SortDims&, T*, bool,             \
+                                      SortDirection);                        \
+  extern template void SortByKeyInplace<T>(                                  \
+      const SortDims&, int64_t, int64_t, absl::Span<std::byte* const>,       \
+      absl::Span<const size_t>, SortDirection);                              \
+  extern template void MergeSortedInplace<T>(T*, int64_t, int64_t, T*,      \
+                                             SortDirection)
 
 DECLARE_SORT_INPLACE(float);
 DECLARE_SORT_INPLACE(double);
@@ -16,6 +16,7 @@ limitations under the License.
 #include "xla/backends/cpu/runtime/sort_thunk.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
@@ -144,6 +145,55 @@ absl::StatusOr<std::unique_ptr<SortThunk>> SortThunk::Create(
                                         sort_dims, direction));
 }
 
+// 1-D sorts with at least this many elements are sorted with a parallel merge
+// sort on the intra-op thread pool.
+static constexpr int64_t kMinParallelSortSize = 1 << 16;
+
+// Returns true if `internal::SortInplace` and `internal::SortByKeyInplace` can
+// sort keys of `type` with builtin comparators.
+static constexpr bool HasBuiltinComparator(PrimitiveType type) {
+  return (primitive_util::IsFloatingPointType(type) &&
+          primitive_util::BitWidth(type) >= 16) ||
+         (primitive_util::IsIntegralType(type) &&
+          primitive_util::BitWidth(type) >= 8);
+}
+
+// Sorts `data[begin, end)` with a parallel merge sort: both halves are sorted
+// concurrently, and the task that finishes last merges them and calls `done`.
+// Never blocks, so it is safe to run on the intra-op thread pool.
+template <typename T>
+static void ParallelSortInplace(Eigen::ThreadPoolInterface* pool, T* data,
+                                T* scratch, int64_t begin, int64_t end,
+                                int64_t grain_size, bool is_stable,
+                                SortThunk::SortDirection direction,
+                                std::function<void()> done) {
+  int64_t size = end - begin;
+  if (size <= grain_size) {
+    internal::SortInplace<T>(SortThunk::SortDims{1, size, 1}, 0, 1,
+                             data + begin, is_stable, direction);
+    done();
+    return;
+  }
+
+  int64_t mid = begin + size / 2;
+  auto pending = std::make_shared<std::atomic<int32_t>>(2);
+  std::function<void()> merge = [=, done = std::move(done)]() {
+    if (pending->fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      return;
+    }
+    internal::MergeSortedInplace<T>(data + begin, mid - begin, size,
+                                    scratch + begin, direction);
+    done();
+  };
+
+  pool->Schedule([=] {
+    ParallelSortInplace<T>(pool, data, scratch, begin, mid, grain_size,
+                           is_stable, direction, merge);
+  });
+  ParallelSortInplace<T>(pool, data, scratch, mid, end, grain_size, is_stable,
+                         direction, merge);
+}
+
 SortThunk::SortThunk(Info info, absl::Span<const Input> inputs,
                      int64_t dimension, bool is_stable, LessThan less_than,
                      SortDims sort_dims, std::optional<SortDirection> direction)
@@ -232,24 +282,60 @@ tsl::AsyncValueRef<SortThunk::ExecuteEvent> SortThunk::Execute(
   }
 
   PrimitiveType first_element_type = inputs_[0].shape.element_type();
+
+  // With a builtin comparator we sort a single input directly, and multiple
+  // inputs by the keys in the first one (i.e. argsort), without calling into
+  // the jit-compiled comparator.
+  const bool use_builtin_comparator =
+      direction_.has_value() && HasBuiltinComparator(first_element_type) &&
+      (raw_data.size() == 1 || internal::CanSortByKeyInplace(sort_dims_));
+
+  // Large 1-D sorts of a single input are sorted with a parallel merge sort.
+  if (use_builtin_comparator && raw_data.size() == 1 && num_slices == 1 &&
+      sort_dims_.sort_dim_size >= kMinParallelSortSize &&
+      params.intra_op_threadpool != nullptr &&
+      params.intra_op_threadpool->numThreads() > 1) {
+    tsl::CountDownAsyncValueRef<ExecuteEvent> event(1);
+    primitive_util::ArrayTypeSwitch(
+        [&](auto type) {
+          if constexpr (HasBuiltinComparator(type)) {
+            using T = primitive_util::NativeTypeOf<type>;
+            int64_t size = sort_dims_.sort_dim_size;
+            int64_t grain_size = std::max(
+                kMinParallelSortSize / 2,
+                CeilOfRatio<int64_t>(
+                    size, params.intra_op_threadpool->numThreads()));
+            std::shared_ptr<T[]> scratch(new T[size]);
+            ParallelSortInplace<T>(
+                params.intra_op_threadpool->getPool(),
+                reinterpret_cast<T*>(raw_data[0]), scratch.get(), 0, size,
+                grain_size, is_stable_, *direction_,
+                [event, scratch]() mutable { event.CountDown(); });
+          }
+        },
+        first_element_type);
+    return event.AsRef();
+  }
+
   auto sort_slice_range = [raw_data, primitive_sizes, first_element_type,
                            sort_dims = sort_dims_, is_stable = is_stable_,
-                           less_than, direction = direction_](
-                              int64_t start_slice, int64_t end_slice) {
-    if (raw_data.size() == 1 && direction.has_value()) {
+                           less_than, direction = direction_,
+                           use_builtin_comparator](int64_t start_slice,
+                                                   int64_t end_slice) {
+    if (use_builtin_comparator) {
       primitive_util::ArrayTypeSwitch(
           [&](auto type) {
-            if constexpr ((primitive_util::IsFloatingPointType(type) &&
-                           primitive_util::BitWidth(type) >= 16) ||
-                          (primitive_util::IsIntegralType(type) &&
-                           primitive_util::BitWidth(type) >= 8)) {
+            if constexpr (HasBuiltinComparator(type)) {
               using T = primitive_util::NativeTypeOf<type>;
-              internal::SortInplace<T>(sort_dims, start_slice, end_slice,
-                                       reinterpret_cast<T*>(raw_data[0]),
-                                       is_stable, *direction);
-            } else {
-              internal::SortInplace(sort_dims, start_slice, end_slice, raw_data,
-                                    primitive_sizes, is_stable, less_than);
+              if (raw_data.size() == 1) {
+                internal::SortInplace<T>(sort_dims, start_slice, end_slice,
+                                         reinterpret_cast<T*>(raw_data[0]),
+                                         is_stable, *direction);
+              } else {
+                internal::SortByKeyInplace<T>(sort_dims, start_slice,
+                                              end_slice, raw_data,
+                                              primitive_sizes, *direction);
+              }
             }
           },
           first_element_type);
@@ -16,8 +16,10 @@ limitations under the License.
 #include "xla/backends/cpu/runtime/sort_thunk.h"
 
 #include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <functional>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <vector>
@@ -260,6 +262,56 @@ TEST_P(SortThunkTest, Sort1DDynamicNumInputs) {
   EXPECT_EQ(indices, expected_indices);
 }
 
+TEST_P(SortThunkTest, Sort1DByKey) {
+  bool is_stable = GetParam();
+
+  // Sort integer keys with many duplicates together with their indices.
+  std::vector<int32_t> keys_data(1000);
+  std::vector<int32_t> indices_data(1000);
+  for (int32_t i = 0; i < 1000; ++i) {
+    keys_data[i] = (i * 37) % 101;
+    indices_data[i] = i;
+  }
+  auto keys = LiteralUtil::CreateR1<int32_t>(keys_data);
+  auto indices = LiteralUtil::CreateR1<int32_t>(indices_data);
+
+  BufferAllocations allocations = CreateBufferAllocations(keys, indices);
+
+  auto [alloc0, alloc1] = CreateBufferAllocation(keys, indices);
+  auto [slice0, slice1] = CreateBufferAllocationSlice(alloc0, alloc1);
+
+  // The comparator function is not used when inputs are sorted by the keys in
+  // the first input.
+  auto fake_less_than = [](const void** data) { return false; };
+
+  ASSERT_OK_AND_ASSIGN(
+      auto thunk,
+      SortThunk::Create({"sort"},
+                        {{slice0, keys.shape()}, {slice1, indices.shape()}},
+                        /*dimension=*/0, is_stable, fake_less_than,
+                        SortThunk::SortDirection::kDescending));
+
+  Thunk::ExecuteParams params;
+  params.buffer_allocations = &allocations;
+
+  auto execute_event = thunk->Execute(params);
+  tsl::BlockUntilReady(execute_event);
+  ASSERT_FALSE(execute_event.IsError());
+
+  auto sorted_keys = keys.data<int32_t>();
+  auto sorted_indices = indices.data<int32_t>();
+  for (int64_t i = 0; i < sorted_keys.size(); ++i) {
+    EXPECT_EQ(sorted_keys[i], keys_data[sorted_indices[i]]);
+    if (i > 0) {
+      ASSERT_GE(sorted_keys[i - 1], sorted_keys[i]);
+      // Sorting by key is always stable.
+      if (sorted_keys[i - 1] == sorted_keys[i]) {
+        EXPECT_LT(sorted_indices[i - 1], sorted_indices[i]);
+      }
+    }
+  }
+}
+
 TEST_P(SortThunkTest, Sort2D) {
   bool is_stable = GetParam();
 
@@ -389,7 +441,6 @@ class ParallelSortThunkTest : public testing::TestWithParam<bool> {
     VerifySlicesAreSorted<NativeT>(data, shape, dimension);
   }
 
- private:
   void ExecuteSort(Literal& data, int64_t dimension, bool is_stable) {
     BufferAllocations allocations = CreateBufferAllocations(data);
     BufferAllocation alloc = CreateBufferAllocation(0, data);
@@ -411,6 +462,7 @@ class ParallelSortThunkTest : public testing::TestWithParam<bool> {
     ASSERT_FALSE(execute_event.IsError());
   }
 
+ private:
   template <typename NativeT>
   void VerifySlicesAreSorted(const Literal& data, const Shape& shape,
                              int64_t dimension) {
@@ -460,6 +512,48 @@ TEST_P(ParallelSortThunkTest, Sort2DF16) {
   RunTest<F16>(ShapeUtil::MakeShape(F16, {32, 64}), /*dimension=*/1);
 }
 
+TEST_P(ParallelSortThunkTest, Sort1DF32) {
+  RunTest<F32>(ShapeUtil::MakeShape(F32, {1 << 18}), /*dimension=*/0);
+}
+
+TEST_P(ParallelSortThunkTest, Sort1DBF16) {
+  RunTest<BF16>(ShapeUtil::MakeShape(BF16, {100003}), /*dimension=*/0);
+}
+
+TEST_P(ParallelSortThunkTest, Sort1DF32WithNaNsAndZeros) {
+  // Every part sorted in parallel has NaNs, and negative and positive zeros.
+  constexpr int64_t kSize = 1 << 18;
+  std::vector<float> values(kSize);
+  for (int64_t i = 0; i < kSize; ++i) {
+    if (i % 4 == 0) {
+      values[i] = std::numeric_limits<float>::quiet_NaN();
+    } else if (i % 4 == 1) {
+      values[i] = i % 8 == 1 ? -0.0f : 0.0f;
+    } else {
+      values[i] = static_cast<float>(kSize - i);
+    }
+  }
+  Literal data = LiteralUtil::CreateR1<float>(values);
+  ExecuteSort(data, /*dimension=*/0, GetParam());
+
+  // Zeros come first and NaNs last, as in a sequential radix sort.
+  constexpr int64_t kNumNaNs = kSize / 4;
+  constexpr int64_t kNumZeros = kSize / 4;
+  absl::Span<const float> sorted = data.data<float>();
+  EXPECT_TRUE(std::is_sorted(sorted.begin(), sorted.end() - kNumNaNs));
+  EXPECT_TRUE(std::all_of(sorted.end() - kNumNaNs, sorted.end(),
+                          [](float value) { return std::isnan(value); }));
+  EXPECT_EQ(sorted[kNumZeros - 1], 0.0f);
+  EXPECT_GT(sorted[kNumZeros], 0.0f);
+
+  // A stable sort keeps negative and positive zeros in their input order.
+  if (GetParam()) {
+    for (int64_t i = 0; i < kNumZeros; ++i) {
+      EXPECT_EQ(std::signbit(sorted[i]), i % 2 == 0) << "at " << i;
+    }
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(ParallelSortThunk, ParallelSortThunkTest,
                          testing::Bool(), testing::PrintToStringParamName());
 
@@ -531,6 +625,8 @@ BENCHMARK_TEMPLATE(BM_Sort1D, F32)
     ->Args({1000, 1, false, true})
     ->Args({10000, 1, false, true})
     ->Args({100000, 1, false, true})
+    // Sort by the keys in the first input.
+    ->Args({100000, 2, false, true})
     // Sort using LessThan comparator callback.
     ->Args({1000, 1, false, false})
     ->Args({10000, 1, false, false})
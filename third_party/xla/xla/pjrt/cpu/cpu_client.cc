@@ -69,6 +69,7 @@ limitations under the License.
 #include "xla/pjrt/compiled_memory_stats.h"
 #include "xla/pjrt/cpu/abstract_cpu_buffer.h"
 #include "xla/pjrt/cpu/cpu_async_execution_tracker.h"
+#include "xla/pjrt/cpu/cpu_compilation_cache.h"
 #include "xla/pjrt/cpu/cpu_device.h"
 #include "xla/pjrt/cpu/cpu_device_memory.h"
 #include "xla/pjrt/cpu/cpu_event.h"
@@ -364,6 +365,14 @@ absl::StatusOr<std::unique_ptr<PjRtClient>> GetPjRtCpuClient(
     }
   }
 
+  std::unique_ptr<CpuCompilationCache> compilation_cache;
+  if (!options.compilation_cache_dir.empty()) {
+    ABSL_ASSIGN_OR_RETURN(
+        compilation_cache,
+        CpuCompilationCache::Create(std::move(options.compilation_cache_dir),
+                                    options.compilation_cache_max_size_bytes));
+  }
+
   std::vector<std::unique_ptr<PjRtCpuDevice>> devices;
   devices.reserve(topology->cpu_topology().number_of_devices());
   for (const auto& topology_device : topology->cpu_topology().devices()) {
@@ -377,7 +386,8 @@ absl::StatusOr<std::unique_ptr<PjRtClient>> GetPjRtCpuClient(
       options.process_id, std::move(devices), std::move(allocator),
       std::move(options.collectives), num_threads, options.asynchronous,
       std::move(options.customize_hlo_module_config),
-      options.max_transpose_threads, std::move(topology)));
+      options.max_transpose_threads, std::move(topology),
+      std::move(compilation_cache)));
 }
 
 // An upper bound on the number of threads to use for intra-op parallelism. It
@@ -401,7 +411,8 @@ PjRtCpuClient::PjRtCpuClient(
     std::shared_ptr<cpu::CpuCollectives> collectives, size_t num_threads,
     bool asynchronous,
     std::function<void(HloModuleConfig&)> customize_hlo_module_config,
-    int max_transpose_threads, std::unique_ptr<CpuTopologyDescription> topology)
+    int max_transpose_threads, std::unique_ptr<CpuTopologyDescription> topology,
+    std::unique_ptr<CpuCompilationCache> compilation_cache)
     : process_index_(process_index),
       owned_devices_(std::move(devices)),
       computation_placer_(std::make_unique<ComputationPlacer>()),
@@ -412,6 +423,7 @@ PjRtCpuClient::PjRtCpuClient(
       topology_(std::move(topology)),
       asynchronous_(asynchronous),
       customize_hlo_module_config_(std::move(customize_hlo_module_config)),
+      compilation_cache_(std::move(compilation_cache)),
       eigen_intraop_pool_(new tsl::thread::ThreadPool(
           tsl::Env::Default(), GetThreadOptions(), "XLAEigen",
           std::min(num_threads, kMaxIntraOpThreads))),
@@ -597,10 +609,11 @@ PjRtCpuExecutable::GetOutputMemoryKinds() const {
   return out;
 }
 
-absl::StatusOr<std::unique_ptr<PjRtLoadedExecutable>>
-PjRtCpuClient::LoadSerializedExecutableInternal(
+absl::StatusOr<std::pair<std::unique_ptr<PjRtCpuExecutable>,
+                         std::shared_ptr<DeviceAssignment>>>
+PjRtCpuClient::DeserializeExecutableInternal(
     google::protobuf::io::ZeroCopyInputStream* stream,
-    std::optional<CompileOptions> options, const LoadOptions& load_options) {
+    std::optional<CompileOptions> options) {
   ExecutableAndOptionsProto proto;
   if (!proto.ParseFromZeroCopyStream(stream)) {
     return Internal(
@@ -662,14 +675,26 @@ PjRtCpuClient::LoadSerializedExecutableInternal(
                                : nullptr);
   }
 
-  auto cpu_executable = std::make_shared<PjRtCpuExecutable>(
+  auto cpu_executable = std::make_unique<PjRtCpuExecutable>(
       num_replicas, num_partitions,
       compile_options.parameter_is_tupled_arguments, std::move(input_options),
       std::move(executable), std::move(result_buffer_indices), nullptr,
       *topology_);
   ABSL_RETURN_IF_ERROR(cpu_executable->SetUpDonation(
       compile_options.parameter_is_tupled_arguments));
-  return LoadInternal(std::move(cpu_executable), std::move(device_assignment));
+  return std::make_pair(std::move(cpu_executable),
+                        std::move(device_assignment));
+}
+
+absl::StatusOr<std::unique_ptr<PjRtLoadedExecutable>>
+PjRtCpuClient::LoadSerializedExecutableInternal(
+    google::protobuf::io::ZeroCopyInputStream* stream,
+    std::optional<CompileOptions> options, const LoadOptions& load_options) {
+  ABSL_ASSIGN_OR_RETURN(
+      auto executable_and_device_assignment,
+      DeserializeExecutableInternal(stream, std::move(options)));
+  return LoadInternal(std::move(executable_and_device_assignment.first),
+                      std::move(executable_and_device_assignment.second));
 }
 
 absl::StatusOr<std::unique_ptr<PjRtLoadedExecutable>>
@@ -1110,9 +1135,56 @@ PjRtCpuClient::CompileInternal(
   params.collectives_exists = (collectives_ != nullptr);
   params.customize_hlo_module_config = customize_hlo_module_config_;
 
-  return CompileCpuExecutableInternal(computation, argument_layout_pointers,
-                                      *topology_, std::move(options),
-                                      std::move(params));
+  // Executables compiled ahead of time, with a customized module config which
+  // isn't part of the key, or spanning processes, bypass the compilation cache.
+  std::optional<std::string> cache_key;
+  if (compilation_cache_ != nullptr && aot_options == nullptr &&
+      !customize_hlo_module_config_ && collectives_ == nullptr) {
+    absl::StatusOr<std::string> key = CpuCompilationCache::ComputeKey(
+        computation.proto(), argument_layout_pointers, options,
+        topology_->cpu_topology().target_machine_options());
+    if (key.ok()) {
+      cache_key = *std::move(key);
+    } else {
+      VLOG(1) << "Not caching the executable of " << computation.name()
+              << ": " << key.status();
+    }
+  }
+  if (cache_key.has_value()) {
+    if (std::optional<std::string> serialized =
+            compilation_cache_->Lookup(*cache_key)) {
+      google::protobuf::io::ArrayInputStream stream(serialized->data(),
+                                                    serialized->size());
+      auto result = DeserializeExecutableInternal(&stream, options);
+      if (result.ok()) {
+        return result;
+      }
+      LOG(WARNING) << "Failed to load cached executable of "
+                   << computation.name() << ", recompiling: "
+                   << result.status();
+    }
+  }
+
+  ABSL_ASSIGN_OR_RETURN(
+      auto result,
+      CompileCpuExecutableInternal(computation, argument_layout_pointers,
+                                   *topology_, std::move(options),
+                                   std::move(params)));
+  if (cache_key.has_value()) {
+    // The cache is best effort: failing to populate it doesn't fail
+    // compilation.
+    absl::StatusOr<std::string> serialized =
+        result.first->SerializeExecutable();
+    absl::Status status = serialized.status();
+    if (status.ok()) {
+      status = compilation_cache_->Insert(*cache_key, *serialized);
+    }
+    if (!status.ok()) {
+      LOG(WARNING) << "Failed to cache the executable of "
+                   << computation.name() << ": " << status;
+    }
+  }
+  return result;
 }
 
 absl::StatusOr<PjRtRawBufferRef> PjRtCpuClient::ImportForeignMemory(
@@ -49,6 +49,7 @@ limitations under the License.
 #include "xla/pjrt/async_work_runner.h"
 #include "xla/pjrt/common_pjrt_client.h"
 #include "xla/pjrt/compiled_memory_stats.h"
+#include "xla/pjrt/cpu/cpu_compilation_cache.h"
 #include "xla/pjrt/cpu/cpu_device.h"
 #include "xla/pjrt/cpu/cpu_device_memory.h"
 #include "xla/pjrt/cpu/cpu_event.h"
@@ -290,7 +291,8 @@ class PjRtCpuClient final : public CommonPjRtClient {
       bool asynchronous,
       std::function<void(HloModuleConfig&)> customize_hlo_module_config,
       int max_transpose_threads,
-      std::unique_ptr<CpuTopologyDescription> topology);
+      std::unique_ptr<CpuTopologyDescription> topology,
+      std::unique_ptr<CpuCompilationCache> compilation_cache);
 
   absl::StatusOr<std::pair<std::unique_ptr<PjRtCpuExecutable>,
                            std::shared_ptr<DeviceAssignment>>>
@@ -305,6 +307,14 @@ class PjRtCpuClient final : public CommonPjRtClient {
       std::shared_ptr<PjRtCpuExecutable> cpu_executable,
       std::shared_ptr<DeviceAssignment> device_assignment);
 
+  // Deserializes an executable serialized by
+  // `PjRtCpuExecutable::SerializeExecutable`.
+  absl::StatusOr<std::pair<std::unique_ptr<PjRtCpuExecutable>,
+                           std::shared_ptr<DeviceAssignment>>>
+  DeserializeExecutableInternal(
+      google::protobuf::io::ZeroCopyInputStream* stream,
+      std::optional<CompileOptions> options);
+
   absl::StatusOr<std::unique_ptr<PjRtLoadedExecutable>>
   LoadSerializedExecutableInternal(google::protobuf::io::ZeroCopyInputStream* stream,
                                    std::optional<CompileOptions> options,
@@ -364,6 +374,9 @@ class PjRtCpuClient final : public CommonPjRtClient {
   // A callback to customize the HloModuleConfig for each compiled module.
   std::function<void(HloModuleConfig&)> customize_hlo_module_config_;
 
+  // Persistent cache of compiled executables. Null if disabled.
+  std::unique_ptr<CpuCompilationCache> compilation_cache_;
+
   // IMPORTANT: All thread pools must be destroyed first, because thread pool
   // destruction guarantees that all scheduled tasks are completed. Otherwise,
   // we might get use-after-free races when dispatched executables try to access
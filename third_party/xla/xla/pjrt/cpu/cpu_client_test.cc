@@ -1486,6 +1486,57 @@ TEST(PjRtCpuClientTest, DonateWithControlDependencyError) {
                        HasSubstr("control dependency failed")));
 }
 
+TEST(PjRtCpuClientTest, CompilationCacheIsSharedBetweenClients) {
+  static constexpr char kProgram[] = R"(
+    HloModule Add
+    ENTRY main {
+      %c = f32[4] constant({1, 2, 3, 4})
+      ROOT %add = f32[4] add(%c, %c)
+    })";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto hlo_module,
+                          ParseAndReturnUnverifiedModule(kProgram, {}));
+  XlaComputation xla_computation(hlo_module->ToProto());
+
+  tsl::Env* env = tsl::Env::Default();
+  CpuClientOptions options;
+  ASSERT_TRUE(env->LocalTempFilename(&options.compilation_cache_dir));
+  auto compile_and_run = [&]() -> absl::StatusOr<std::shared_ptr<Literal>> {
+    TF_ASSIGN_OR_RETURN(auto client, GetPjRtCpuClient(options));
+    TF_ASSIGN_OR_RETURN(auto executable,
+                        client->CompileAndLoad(xla_computation, {}));
+    TF_ASSIGN_OR_RETURN(
+        auto result,
+        executable->Execute(/*argument_handles=*/{{}}, ExecuteOptions()));
+    return result.at(0).at(0)->ToLiteral().Await();
+  };
+  auto cache_entries = [&]() {
+    std::vector<std::string> entries;
+    CHECK_OK(env->GetChildren(options.compilation_cache_dir, &entries));
+    return entries;
+  };
+  const Literal expected = LiteralUtil::CreateR1<float>({2, 4, 6, 8});
+
+  // The first client populates the cache, the second one loads from it.
+  TF_ASSERT_OK_AND_ASSIGN(auto literal, compile_and_run());
+  EXPECT_TRUE(LiteralTestUtil::Equal(expected, *literal));
+  std::vector<std::string> entries = cache_entries();
+  ASSERT_THAT(entries, ::testing::SizeIs(1));
+  TF_ASSERT_OK_AND_ASSIGN(literal, compile_and_run());
+  EXPECT_TRUE(LiteralTestUtil::Equal(expected, *literal));
+  EXPECT_EQ(cache_entries(), entries);
+
+  // Corrupted entries are replaced by recompiling.
+  std::string entry_path =
+      tsl::io::JoinPath(options.compilation_cache_dir, entries.front());
+  TF_ASSERT_OK(tsl::WriteStringToFile(env, entry_path, "corrupted"));
+  TF_ASSERT_OK_AND_ASSIGN(literal, compile_and_run());
+  EXPECT_TRUE(LiteralTestUtil::Equal(expected, *literal));
+  std::string entry;
+  TF_ASSERT_OK(tsl::ReadFileToString(env, entry_path, &entry));
+  EXPECT_NE(entry, "corrupted");
+}
+
 }  // namespace
 
 //===----------------------------------------------------------------------===//
@@ -1510,4 +1561,55 @@ static void BM_CreateZeroCopyBuffer(benchmark::State& state) {
 
 BENCHMARK(BM_CreateZeroCopyBuffer);
 
+// Compares compiling a module from scratch (with populating the compilation
+// cache) to loading it from the cache, as on the startup of a new process.
+static void BM_CompileWithCompilationCache(benchmark::State& state) {
+  static constexpr char kProgram[] = R"(
+    HloModule Mlp
+    ENTRY main {
+      %x = f32[64,64] parameter(0)
+      %w = f32[64,64] parameter(1)
+      %dot0 = f32[64,64] dot(%x, %w), lhs_contracting_dims={1},
+                                      rhs_contracting_dims={0}
+      %tanh0 = f32[64,64] tanh(%dot0)
+      %dot1 = f32[64,64] dot(%tanh0, %w), lhs_contracting_dims={1},
+                                          rhs_contracting_dims={0}
+      ROOT %tanh1 = f32[64,64] tanh(%dot1)
+    })";
+  const bool warm = state.range(0);
+
+  auto hlo_module = ParseAndReturnUnverifiedModule(kProgram, {});
+  CHECK_OK(hlo_module);
+  XlaComputation xla_computation((*hlo_module)->ToProto());
+
+  tsl::Env* env = tsl::Env::Default();
+  CpuClientOptions options;
+  CHECK(env->LocalTempFilename(&options.compilation_cache_dir));
+  auto client = GetPjRtCpuClient(options);
+  CHECK_OK(client);
+  if (warm) {
+    CHECK_OK((*client)->CompileAndLoad(xla_computation, {}));
+  }
+
+  for (auto _ : state) {
+    if (!warm) {
+      state.PauseTiming();
+      std::vector<std::string> entries;
+      CHECK_OK(env->GetChildren(options.compilation_cache_dir, &entries));
+      for (const std::string& entry : entries) {
+        CHECK_OK(env->DeleteFile(
+            tsl::io::JoinPath(options.compilation_cache_dir, entry)));
+      }
+      state.ResumeTiming();
+    }
+    CHECK_OK((*client)->CompileAndLoad(xla_computation, {}));
+  }
+
+  int64_t undeleted_files, undeleted_dirs;
+  CHECK_OK(env->DeleteRecursively(options.compilation_cache_dir,
+                                  &undeleted_files, &undeleted_dirs));
+}
+
+BENCHMARK(BM_CompileWithCompilationCache)->ArgName("warm")->Arg(0)->Arg(1);
+
 }  // namespace xla
@@ -0,0 +1,246 @@
+/* Copyright 2026 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/pjrt/cpu/cpu_compilation_cache.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/log/log.h"
+#include "absl/memory/memory.h"
+#include "absl/random/random.h"
+#include "absl/status/status.h"
+#include "absl/status/status_macros.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "xla/backends/cpu/target_machine_options.h"
+#include "xla/debug_options_flags.h"
+#include "xla/pjrt/pjrt_executable.h"
+#include "xla/pjrt/proto/compile_options.pb.h"
+#include "xla/service/hlo.pb.h"
+#include "xla/shape.h"
+#include "xla/tsl/lib/strings/proto_serialization.h"
+#include "xla/tsl/platform/env.h"
+#include "xla/tsl/platform/file_statistics.h"
+#include "xla/util.h"
+#include "tsl/platform/fingerprint.h"
+#include "tsl/platform/path.h"
+#include "tsl/platform/protobuf.h"
+
+namespace xla {
+namespace {
+
+// Bump whenever the layout of entries or the key derivation changes.
+constexpr int kCacheFormatVersion = 1;
+
+// Entries are the magic, the fingerprint of the payload, and the payload.
+constexpr absl::string_view kEntryMagic = "XLACPUC1";
+constexpr size_t kEntryHeaderSize = kEntryMagic.size() + 16;
+constexpr absl::string_view kEntrySuffix = ".xla_cpu_executable";
+constexpr absl::string_view kTempFileInfix = ".tmp.";
+
+// Temporary files older than this were left behind by crashed writers.
+constexpr int64_t kStaleTempFileAgeNsec = int64_t{3600} * 1000 * 1000 * 1000;
+
+absl::Status FingerprintProto(const tsl::protobuf::MessageLite& proto,
+                              tsl::Fprint128& fingerprint) {
+  std::string serialized;
+  if (!tsl::SerializeToStringDeterministic(proto, &serialized)) {
+    return Internal("Failed to serialize the compilation cache key");
+  }
+  fingerprint =
+      tsl::FingerprintCat128(fingerprint, tsl::Fingerprint128(serialized));
+  return absl::OkStatus();
+}
+
+std::string EntryHeader(absl::string_view payload) {
+  std::array<char, 16> checksum =
+      tsl::Fprint128ToBytes(tsl::Fingerprint128(payload));
+  return absl::StrCat(kEntryMagic,
+                      absl::string_view(checksum.data(), checksum.size()));
+}
+
+// Writes `content` to `path` through a temporary file, so that concurrent
+// readers see either the previous or the new content.
+absl::Status AtomicallyWriteFile(tsl::Env* env, absl::string_view path,
+                                 absl::string_view header,
+                                 absl::string_view content) {
+  absl::InsecureBitGen gen;
+  std::string tmp_path = absl::StrCat(
+      path, kTempFileInfix,
+      absl::Uniform<uint32_t>(gen, 0, std::numeric_limits<uint32_t>::max()));
+  if (!env->CreateUniqueFileName(&tmp_path, "")) {
+    return Internal("Unable to create a temporary file name for %s", path);
+  }
+  bool has_atomic_move;
+  ABSL_RETURN_IF_ERROR(env->HasAtomicMove(tmp_path, &has_atomic_move));
+  if (!has_atomic_move) {
+    return Unimplemented("Atomic move is not supported for %s", path);
+  }
+
+  std::unique_ptr<tsl::WritableFile> file;
+  ABSL_RETURN_IF_ERROR(env->NewWritableFile(tmp_path, &file));
+  absl::Status status = file->Append(header);
+  if (status.ok()) status = file->Append(content);
+  if (status.ok()) status = file->Close();
+  if (status.ok()) status = env->RenameFile(tmp_path, std::string(path));
+  if (!status.ok()) {
+    env->DeleteFile(tmp_path).IgnoreError();
+  }
+  return status;
+}
+
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<CpuCompilationCache>>
+CpuCompilationCache::Create(std::string directory, int64_t max_size_bytes,
+                            tsl::Env* env) {
+  if (directory.empty()) {
+    return InvalidArgument("The compilation cache directory must not be empty");
+  }
+  if (max_size_bytes <= 0) {
+    return InvalidArgument(
+        "The compilation cache size must be positive, got %d", max_size_bytes);
+  }
+  ABSL_RETURN_IF_ERROR(env->RecursivelyCreateDir(directory));
+  return absl::WrapUnique(
+      new CpuCompilationCache(std::move(directory), max_size_bytes, env));
+}
+
+absl::StatusOr<std::string> CpuCompilationCache::ComputeKey(
+    const HloModuleProto& computation,
+    absl::Span<const Shape* const> argument_layouts,
+    const CompileOptions& options,
+    const cpu::TargetMachineOptions& target_machine_options) {
+  ABSL_ASSIGN_OR_RETURN(CompileOptionsProto options_proto, options.ToProto());
+  // Modules compiled without explicit debug options use the ones from the
+  // flags, which may differ between processes.
+  ExecutableBuildOptionsProto* build_options =
+      options_proto.mutable_executable_build_options();
+  if (!build_options->has_debug_options()) {
+    *build_options->mutable_debug_options() = GetDebugOptionsFromFlags();
+  }
+
+  tsl::Fprint128 fingerprint = tsl::Fingerprint128(
+      absl::StrCat("xla_cpu_compilation_cache_v", kCacheFormatVersion));
+  ABSL_RETURN_IF_ERROR(FingerprintProto(computation, fingerprint));
+  for (const Shape* shape : argument_layouts) {
+    ABSL_RETURN_IF_ERROR(FingerprintProto(shape->ToProto(), fingerprint));
+  }
+  ABSL_RETURN_IF_ERROR(FingerprintProto(options_proto, fingerprint));
+  ABSL_RETURN_IF_ERROR(
+      FingerprintProto(target_machine_options.ToProto(), fingerprint));
+  return absl::StrFormat("%016x%016x", fingerprint.high64, fingerprint.low64);
+}
+
+std::string CpuCompilationCache::EntryPath(absl::string_view key) const {
+  return tsl::io::JoinPath(directory_, absl::StrCat(key, kEntrySuffix));
+}
+
+std::optional<std::string> CpuCompilationCache::Lookup(
+    absl::string_view key) const {
+  std::string path = EntryPath(key);
+  std::string entry;
+  absl::Status status = tsl::ReadFileToString(env_, path, &entry);
+  if (!status.ok()) {
+    if (!absl::IsNotFound(status)) {
+      LOG(WARNING) << "Failed to read compilation cache entry " << path << ": "
+                   << status;
+    }
+    return std::nullopt;
+  }
+  absl::string_view contents(entry);
+  if (contents.size() < kEntryHeaderSize ||
+      EntryHeader(contents.substr(kEntryHeaderSize)) !=
+          contents.substr(0, kEntryHeaderSize)) {
+    LOG(WARNING) << "Deleting corrupted compilation cache entry " << path;
+    env_->DeleteFile(path).IgnoreError();
+    return std::nullopt;
+  }
+  VLOG(1) << "Compilation cache hit: " << path;
+  entry.erase(0, kEntryHeaderSize);
+  return entry;
+}
+
+absl::Status CpuCompilationCache::Insert(
+    absl::string_view key, absl::string_view serialized_executable) {
+  ABSL_RETURN_IF_ERROR(AtomicallyWriteFile(env_, EntryPath(key),
+                                           EntryHeader(serialized_executable),
+                                           serialized_executable));
+  return EvictEntries();
+}
+
+absl::Status CpuCompilationCache::EvictEntries() {
+  std::vector<std::string> children;
+  ABSL_RETURN_IF_ERROR(env_->GetChildren(directory_, &children));
+
+  struct Entry {
+    std::string path;
+    int64_t size;
+    int64_t mtime_nsec;
+  };
+  std::vector<Entry> entries;
+  int64_t total_size = 0;
+  const int64_t now_nsec = static_cast<int64_t>(env_->NowNanos());
+  for (const std::string& child : children) {
+    bool is_entry = absl::EndsWith(child, kEntrySuffix);
+    bool is_temp_file = absl::StrContains(child, kTempFileInfix);
+    if (!is_entry && !is_temp_file) continue;
+
+    std::string path = tsl::io::JoinPath(directory_, child);
+    tsl::FileStatistics stat;
+    // Entries may be concurrently evicted by other processes.
+    if (!env_->Stat(path, &stat).ok() || stat.is_directory) continue;
+    if (is_temp_file) {
+      if (now_nsec - stat.mtime_nsec > kStaleTempFileAgeNsec) {
+        env_->DeleteFile(path).IgnoreError();
+      }
+      continue;
+    }
+    total_size += stat.length;
+    entries.push_back({std::move(path), stat.length, stat.mtime_nsec});
+  }
+  if (total_size <= max_size_bytes_) {
+    return absl::OkStatus();
+  }
+
+  absl::c_sort(entries, [](const Entry& a, const Entry& b) {
+    return a.mtime_nsec < b.mtime_nsec;
+  });
+  for (const Entry& entry : entries) {
+    if (total_size <= max_size_bytes_) break;
+    absl::Status status = env_->DeleteFile(entry.path);
+    if (!status.ok() && !absl::IsNotFound(status)) {
+      return status;
+    }
+    VLOG(1) << "Evicted compilation cache entry " << entry.path;
+    total_size -= entry.size;
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace xla
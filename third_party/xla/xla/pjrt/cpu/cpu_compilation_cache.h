@@ -0,0 +1,97 @@
+/* Copyright 2026 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_PJRT_CPU_CPU_COMPILATION_CACHE_H_
+#define XLA_PJRT_CPU_CPU_COMPILATION_CACHE_H_
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "xla/backends/cpu/target_machine_options.h"
+#include "xla/pjrt/pjrt_executable.h"
+#include "xla/service/hlo.pb.h"
+#include "xla/shape.h"
+#include "xla/tsl/platform/env.h"
+
+namespace xla {
+
+// A persistent cache of serialized XLA:CPU executables, stored as one file per
+// executable in a directory which may be shared by concurrent processes.
+//
+// Entries are content addressed: the key is a fingerprint of everything that
+// affects code generation (see `ComputeKey`), so entries never need to be
+// invalidated. Entries are written to a temporary file and atomically renamed
+// into place, so readers never observe partially written entries, and
+// concurrent writers of the same key simply race to install identical
+// contents. Each entry carries a checksum of its payload; corrupted entries
+// are deleted on lookup and reported as misses.
+//
+// After each insertion the oldest entries are evicted until the total size of
+// the cache is at most `max_size_bytes`.
+class CpuCompilationCache {
+ public:
+  // Creates `directory` if it does not exist yet.
+  static absl::StatusOr<std::unique_ptr<CpuCompilationCache>> Create(
+      std::string directory, int64_t max_size_bytes,
+      tsl::Env* env = tsl::Env::Default());
+
+  // Returns the key of the executable compiled from `computation` with
+  // `argument_layouts` and `options` for a host described by
+  // `target_machine_options`. Returns an error if `options` can't be
+  // serialized, in which case the executable must not be cached.
+  static absl::StatusOr<std::string> ComputeKey(
+      const HloModuleProto& computation,
+      absl::Span<const Shape* const> argument_layouts,
+      const CompileOptions& options,
+      const cpu::TargetMachineOptions& target_machine_options);
+
+  // Returns the serialized executable stored under `key`, if any.
+  std::optional<std::string> Lookup(absl::string_view key) const;
+
+  // Stores `serialized_executable` under `key`, replacing any previous entry,
+  // and evicts old entries if the cache grew too large.
+  absl::Status Insert(absl::string_view key,
+                      absl::string_view serialized_executable);
+
+  const std::string& directory() const { return directory_; }
+
+ private:
+  CpuCompilationCache(std::string directory, int64_t max_size_bytes,
+                      tsl::Env* env)
+      : directory_(std::move(directory)),
+        max_size_bytes_(max_size_bytes),
+        env_(env) {}
+
+  std::string EntryPath(absl::string_view key) const;
+
+  // Deletes the least recently written entries, and temporary files left
+  // behind by crashed writers, until the cache fits in `max_size_bytes_`.
+  absl::Status EvictEntries();
+
+  std::string directory_;
+  int64_t max_size_bytes_;
+  tsl::Env* env_;
+};
+
+}  // namespace xla
+
+#endif  // XLA_PJRT_CPU_CPU_COMPILATION_CACHE_H_
@@ -0,0 +1,170 @@
+/* Copyright 2026 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/pjrt/cpu/cpu_compilation_cache.h"
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status_matchers.h"
+#include "xla/backends/cpu/target_machine_options.h"
+#include "xla/pjrt/pjrt_executable.h"
+#include "xla/service/hlo.pb.h"
+#include "xla/shape.h"
+#include "xla/shape_util.h"
+#include "xla/tsl/lib/core/status_test_util.h"
+#include "xla/tsl/platform/env.h"
+#include "xla/tsl/platform/statusor.h"
+#include "xla/xla.pb.h"
+#include "tsl/platform/path.h"
+
+namespace xla {
+namespace {
+
+using ::testing::Optional;
+using ::testing::SizeIs;
+
+class CpuCompilationCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override { ASSERT_TRUE(env_->LocalTempFilename(&directory_)); }
+
+  std::vector<std::string> Entries() {
+    std::vector<std::string> entries;
+    EXPECT_TRUE(env_->GetChildren(directory_, &entries).ok());
+    return entries;
+  }
+
+  tsl::Env* env_ = tsl::Env::Default();
+  std::string directory_;
+};
+
+TEST_F(CpuCompilationCacheTest, InsertAndLookup) {
+  TF_ASSERT_OK_AND_ASSIGN(auto cache,
+                          CpuCompilationCache::Create(directory_, 1 << 20));
+  EXPECT_EQ(cache->Lookup("a"), std::nullopt);
+
+  TF_ASSERT_OK(cache->Insert("a", "executable a"));
+  TF_ASSERT_OK(cache->Insert("b", ""));
+  EXPECT_THAT(cache->Lookup("a"), Optional(std::string("executable a")));
+  EXPECT_THAT(cache->Lookup("b"), Optional(std::string()));
+
+  // Entries are persistent.
+  TF_ASSERT_OK_AND_ASSIGN(auto other_cache,
+                          CpuCompilationCache::Create(directory_, 1 << 20));
+  EXPECT_THAT(other_cache->Lookup("a"), Optional(std::string("executable a")));
+
+  TF_ASSERT_OK(cache->Insert("a", "executable a2"));
+  EXPECT_THAT(other_cache->Lookup("a"), Optional(std::string("executable a2")));
+  EXPECT_THAT(Entries(), SizeIs(2));
+}
+
+TEST_F(CpuCompilationCacheTest, CorruptedEntriesAreDeleted) {
+  TF_ASSERT_OK_AND_ASSIGN(auto cache,
+                          CpuCompilationCache::Create(directory_, 1 << 20));
+  TF_ASSERT_OK(cache->Insert("a", "executable a"));
+  std::vector<std::string> entries = Entries();
+  ASSERT_THAT(entries, SizeIs(1));
+  std::string path = tsl::io::JoinPath(directory_, entries.front());
+  std::string entry;
+  TF_ASSERT_OK(tsl::ReadFileToString(env_, path, &entry));
+
+  entry.back() ^= 1;
+  TF_ASSERT_OK(tsl::WriteStringToFile(env_, path, entry));
+  EXPECT_EQ(cache->Lookup("a"), std::nullopt);
+  EXPECT_THAT(Entries(), SizeIs(0));
+
+  TF_ASSERT_OK(tsl::WriteStringToFile(env_, path, "short"));
+  EXPECT_EQ(cache->Lookup("a"), std::nullopt);
+  EXPECT_THAT(Entries(), SizeIs(0));
+}
+
+TEST_F(CpuCompilationCacheTest, EvictsOldestEntries) {
+  const std::string executable(1000, 'x');
+  TF_ASSERT_OK_AND_ASSIGN(auto cache,
+                          CpuCompilationCache::Create(directory_, 2500));
+  TF_ASSERT_OK(cache->Insert("a", executable));
+  env_->SleepForMicroseconds(1100000);
+  TF_ASSERT_OK(cache->Insert("b", executable));
+  env_->SleepForMicroseconds(1100000);
+  TF_ASSERT_OK(cache->Insert("c", executable));
+
+  EXPECT_EQ(cache->Lookup("a"), std::nullopt);
+  EXPECT_THAT(cache->Lookup("b"), Optional(executable));
+  EXPECT_THAT(cache->Lookup("c"), Optional(executable));
+}
+
+TEST_F(CpuCompilationCacheTest, RejectsInvalidOptions) {
+  EXPECT_THAT(CpuCompilationCache::Create("", 1 << 20),
+              absl_testing::StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(CpuCompilationCache::Create(directory_, 0),
+              absl_testing::StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(CpuCompilationCacheKeyTest, DependsOnEverythingThatAffectsCodegen) {
+  HloModuleProto computation;
+  computation.set_name("computation");
+  Shape shape = ShapeUtil::MakeShape(F32, {2, 2});
+  std::vector<const Shape*> argument_layouts = {&shape};
+  CompileOptions options;
+  DebugOptions debug_options;
+  cpu::TargetMachineOptions target_machine_options(debug_options);
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::string key,
+      CpuCompilationCache::ComputeKey(computation, argument_layouts, options,
+                                      target_machine_options));
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::string same_key,
+      CpuCompilationCache::ComputeKey(computation, argument_layouts, options,
+                                      target_machine_options));
+  EXPECT_EQ(key, same_key);
+
+  HloModuleProto other_computation = computation;
+  other_computation.set_name("other_computation");
+  EXPECT_THAT(CpuCompilationCache::ComputeKey(other_computation,
+                                              argument_layouts, options,
+                                              target_machine_options),
+              absl_testing::IsOkAndHolds(::testing::Ne(key)));
+
+  Shape other_shape = ShapeUtil::MakeShapeWithDenseLayout(F32, {2, 2}, {0, 1});
+  std::vector<const Shape*> other_argument_layouts = {&other_shape};
+  EXPECT_THAT(CpuCompilationCache::ComputeKey(computation,
+                                              other_argument_layouts, options,
+                                              target_machine_options),
+              absl_testing::IsOkAndHolds(::testing::Ne(key)));
+
+  CompileOptions other_options;
+  other_options.executable_build_options.mutable_debug_options()
+      ->set_xla_cpu_enable_fast_math(true);
+  EXPECT_THAT(CpuCompilationCache::ComputeKey(computation, argument_layouts,
+                                              other_options,
+                                              target_machine_options),
+              absl_testing::IsOkAndHolds(::testing::Ne(key)));
+
+  DebugOptions other_debug_options;
+  other_debug_options.set_xla_cpu_max_isa("SSE4_2");
+  cpu::TargetMachineOptions other_target_machine_options(other_debug_options);
+  EXPECT_THAT(CpuCompilationCache::ComputeKey(computation, argument_layouts,
+                                              options,
+                                              other_target_machine_options),
+              absl_testing::IsOkAndHolds(::testing::Ne(key)));
+}
+
+}  // namespace
+}  // namespace xla
@@ -17,9 +17,11 @@ limitations under the License.
 #define XLA_PJRT_PLUGIN_XLA_CPU_CPU_CLIENT_OPTIONS_H_
 
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <optional>
+#include <string>
 
 #include "absl/status/statusor.h"
 #include "xla/backends/cpu/collectives/cpu_collectives.h"
@@ -70,6 +72,16 @@ struct CpuClientOptions {
   // detected from the host and will try to use cpu_device_count and process_id
   // to build the topology.
   const CpuTopologyDescription* topology = nullptr;
+
+  // Directory of a persistent cache of compiled executables, which may be
+  // shared by concurrent processes running the same version of XLA. Executables
+  // compiled for the same computation, compile options and target machine are
+  // loaded from the cache instead of being recompiled. Disabled if empty.
+  std::string compilation_cache_dir;
+
+  // Maximum total size of the entries in `compilation_cache_dir`. The oldest
+  // entries are evicted first.
+  int64_t compilation_cache_max_size_bytes = int64_t{4} << 30;
 };
 
 }  // namespace xla
@@ -1271,21 +1271,30 @@ absl::StatusOr<ThunkSequence> ThunkEmitter::EmitSliceThunk(
 }
 
 // Parse the sort comparator to determine the sort direction. Comparator is
-// expected to be an HloOpcode::kCompare with two parameters.
+// expected to be an HloOpcode::kCompare of the first two parameters. With more
+// than two parameters the remaining inputs are sorted by the keys in the first
+// one (e.g. argsort of keys and iota indices). Total order float comparisons
+// are left to the comparator, as the builtin sorts treat -0 as equal to +0.
 std::optional<SortThunk::SortDirection> ThunkEmitter::MatchSortDirection(
     const HloComputation* hlo_comparator) const {
   namespace m = match;
   std::optional<SortThunk::SortDirection> direction = std::nullopt;
 
-  // TODO(tsilytskyi): Handle more than two input parameters.
-  if (hlo_comparator->root_instruction()->opcode() == HloOpcode::kCompare &&
-      hlo_comparator->root_instruction()->operand(0)->opcode() ==
-          HloOpcode::kParameter &&
-      hlo_comparator->root_instruction()->operand(1)->opcode() ==
-          HloOpcode::kParameter &&
-      hlo_comparator->num_parameters() == 2) {
-    auto* compare =
-        Cast<HloCompareInstruction>(hlo_comparator->root_instruction());
+  const HloInstruction* root = hlo_comparator->root_instruction();
+  const bool compares_parameters =
+      root->opcode() == HloOpcode::kCompare &&
+      root->operand(0)->opcode() == HloOpcode::kParameter &&
+      root->operand(1)->opcode() == HloOpcode::kParameter;
+  const bool compares_keys =
+      Match(root, m::Compare(m::Parameter(0), m::Parameter(1))) ||
+      Match(root, m::Compare(m::Parameter(1), m::Parameter(0)));
+
+  if ((compares_parameters && hlo_comparator->num_parameters() == 2) ||
+      (compares_keys && hlo_comparator->num_parameters() % 2 == 0)) {
+    auto* compare = Cast<HloCompareInstruction>(root);
+    if (compare->type() == Comparison::Type::kFloatTotalOrder) {
+      return std::nullopt;
+    }
 
     // Take into account the order of the parameters. If they are swapped,
     // the sort direction will be reversed.
@@ -32,6 +32,7 @@ limitations under the License.
 #include "absl/base/casts.h"
 #include "absl/base/optimization.h"
 #include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/numeric/bits.h"
 #include "absl/strings/str_cat.h"
@@ -77,6 +78,133 @@ static std::string AllocationAnnotationSnapshotDebugString(
       });
 }
 
+static int64_t NextThreadCacheKey() {
+  static std::atomic<int64_t> next_key{0};
+  return next_key.fetch_add(1, std::memory_order_relaxed);
+}
+
+// A thread's private cache of chunks for one BFCAllocator. Chunks are kept per
+// size-class Bin in LIFO order, so the most recently freed (and most likely
+// cache-hot) chunk is reused first. Every chunk in the cache is "in use" as
+// far as the Bins are concerned.
+//
+// mu_ is taken uncontended by the owning thread; it is only contended when
+// another thread flushes every cache or the allocator is destroyed.
+class BFCAllocator::ThreadChunkCache {
+ public:
+  // Number of cache operations between sweeps that flush the Bins which saw
+  // no allocation hits since the previous sweep.
+  static constexpr int kFlushInterval = 1024;
+
+  explicit ThreadChunkCache(BFCAllocator* allocator) : allocator_(allocator) {}
+
+  absl::Mutex& mu() ABSL_LOCK_RETURNED(mu_) { return mu_; }
+
+  // Drops every cached chunk without returning it; called when the allocator
+  // is destroyed.
+  void Orphan() ABSL_LOCKS_EXCLUDED(mu_) {
+    absl::MutexLock l(mu_);
+    allocator_ = nullptr;
+    for (std::vector<Entry>& bin : bins_) {
+      bin.clear();
+    }
+  }
+
+  bool orphaned() ABSL_LOCKS_EXCLUDED(mu_) {
+    absl::MutexLock l(mu_);
+    return allocator_ == nullptr;
+  }
+
+  // Returns every cached chunk to the allocator when the owning thread exits.
+  void ReleaseAtThreadExit() ABSL_LOCKS_EXCLUDED(mu_) {
+    absl::MutexLock l(mu_);
+    if (allocator_ == nullptr) {
+      return;
+    }
+    std::vector<void*> ptrs;
+    TakeAll(&ptrs);
+    if (!ptrs.empty()) {
+      allocator_->ReleaseThreadCachedChunks(ptrs);
+    }
+    allocator_ = nullptr;
+  }
+
+  // Pops the most recently cached chunk of 'bin_num' that holds at least
+  // 'rounded_bytes' at 'alignment', storing its size in 'size'.
+  void* Pop(BinNum bin_num, size_t rounded_bytes, size_t alignment,
+            size_t* size) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    std::vector<Entry>& bin = bins_[bin_num];
+    for (auto it = bin.rbegin(); it != bin.rend(); ++it) {
+      if (it->size < rounded_bytes ||
+          (absl::bit_cast<uintptr_t>(it->ptr) & (alignment - 1)) != 0) {
+        continue;
+      }
+      void* ptr = it->ptr;
+      *size = it->size;
+      bin.erase(std::next(it).base());
+      ++hits_[bin_num];
+      return ptr;
+    }
+    return nullptr;
+  }
+
+  // Caches 'ptr' and returns the number of chunks now cached in 'bin_num'.
+  size_t Push(BinNum bin_num, void* ptr, size_t size)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    bins_[bin_num].push_back({ptr, size});
+    return bins_[bin_num].size();
+  }
+
+  // Moves the oldest chunks of 'bin_num' to 'ptrs' until 'keep' remain.
+  void TakeOldest(BinNum bin_num, size_t keep, std::vector<void*>* ptrs)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    std::vector<Entry>& bin = bins_[bin_num];
+    if (bin.size() <= keep) {
+      return;
+    }
+    const size_t num_taken = bin.size() - keep;
+    for (size_t i = 0; i < num_taken; ++i) {
+      ptrs->push_back(bin[i].ptr);
+    }
+    bin.erase(bin.begin(), bin.begin() + num_taken);
+  }
+
+  // Counts one cache operation. Every kFlushInterval operations, moves the
+  // chunks of every Bin that saw no hits since the previous sweep to 'ptrs',
+  // so chunks of size classes the thread stopped using go back to the Bins.
+  void MaybeTakeColdChunks(std::vector<void*>* ptrs)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (++ops_since_sweep_ < kFlushInterval) {
+      return;
+    }
+    ops_since_sweep_ = 0;
+    for (BinNum b = 0; b < kNumBins; ++b) {
+      if (hits_[b] == 0) {
+        TakeOldest(b, /*keep=*/0, ptrs);
+      }
+      hits_[b] = 0;
+    }
+  }
+
+  void TakeAll(std::vector<void*>* ptrs) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    for (BinNum b = 0; b < kNumBins; ++b) {
+      TakeOldest(b, /*keep=*/0, ptrs);
+    }
+  }
+
+ private:
+  struct Entry {
+    void* ptr;
+    size_t size;
+  };
+
+  absl::Mutex mu_;
+  BFCAllocator* allocator_ ABSL_GUARDED_BY(mu_);  // nullptr once orphaned.
+  std::array<std::vector<Entry>, kNumBins> bins_ ABSL_GUARDED_BY(mu_);
+  std::array<int64_t, kNumBins> hits_ ABSL_GUARDED_BY(mu_) = {};
+  int ops_since_sweep_ ABSL_GUARDED_BY(mu_) = 0;
+};
+
 BFCAllocator::BFCAllocator(std::unique_ptr<SubAllocator> sub_allocator,
                            size_t total_memory, const std::string& name,
                            const Options& opts)
@@ -87,10 +215,19 @@ BFCAllocator::BFCAllocator(std::unique_ptr<SubAllocator> sub_allocator,
       sub_allocator_(std::move(sub_allocator)),
       name_(name),
       unused_chunk_handle_head_(kInvalidChunkHandle),
-      next_allocation_id_(1) {
+      next_allocation_id_(1),
+      thread_cache_key_(NextThreadCacheKey()) {
   CHECK(!opts.enable_spatial_partitioning || !opts.allow_growth)  // Crash OK
       << "Spatial partitioning requires a single fixed address range "
          "(allow_growth=false).";
+  CHECK(!opts.enable_spatial_partitioning ||
+        opts.thread_local_cache_capacity == 0)  // Crash OK
+      << "Thread-local chunk caching is not supported with spatial "
+         "partitioning.";
+  if (thread_chunk_caching_enabled()) {
+    cacheable_chunk_shards_ =
+        std::make_unique<CacheableChunkShard[]>(kNumCacheableChunkShards);
+  }
   if (opts.allow_growth) {
     // 2MiB smallest initial allocation, unless total memory available
     // is less.
@@ -140,6 +277,15 @@ BFCAllocator::~BFCAllocator() {
   // Lock the mutex to make sure that all memory effects are safely published
   // and available to a thread running the destructor (i.e., deallocations
   // happened on a different thread right before the destructor).
+  if (thread_chunk_caching_enabled()) {
+    // Threads that outlive the allocator must neither serve its chunks nor
+    // flush them back at thread exit.
+    absl::MutexLock registry_lock(thread_caches_mutex_);
+    for (const std::shared_ptr<ThreadChunkCache>& cache : thread_caches_) {
+      cache->Orphan();
+    }
+  }
+
   absl::MutexLock l(mutex_);
 
   // Return memory back.
@@ -300,8 +446,9 @@ void* BFCAllocator::AllocateRawInternalWithRetry(
     freed_by_count = (*allocation_attr.freed_by_func)();
   }
 
-  void* r = AllocateRawInternal(alignment, num_bytes, false, freed_by_count,
-                                allocation_attr.allocation_end);
+  void* r = AllocateRawInternalOrFlushThreadCaches(
+      alignment, num_bytes, false, freed_by_count,
+      allocation_attr.allocation_end);
   if (ABSL_PREDICT_TRUE(r != nullptr)) {
     return r;
   }
@@ -313,8 +460,8 @@ void* BFCAllocator::AllocateRawInternalWithRetry(
         if (allocation_attr.freed_by_func != nullptr) {
           freed_by_count = (*allocation_attr.freed_by_func)();
         }
-        return AllocateRawInternal(a, nb, v, freed_by_count,
-                                   allocation_attr.allocation_end);
+        return AllocateRawInternalOrFlushThreadCaches(
+            a, nb, v, freed_by_count, allocation_attr.allocation_end);
       },
       kMaxMillisToWait, alignment, num_bytes);
   return r;
@@ -331,6 +478,11 @@ void* BFCAllocator::AllocateRaw(size_t alignment, size_t num_bytes,
   DCHECK(opts_.enable_spatial_partitioning ||
          allocation_attr.allocation_end == AllocationEnd::kLower);
   void* result = [&] {
+    if (ThreadChunkCacheable(RoundedBytes(num_bytes)) && num_bytes > 0) {
+      if (void* ptr = AllocateFromThreadChunkCache(alignment, num_bytes)) {
+        return ptr;
+      }
+    }
     if (!opts_.allow_retry_on_failure || !allocation_attr.retry_on_failure) {
       // If we have globally disabled retry-on-failure and fail to allocate an
       // "important" alloc, we want to print a log, because the program may be
@@ -353,9 +505,9 @@ void* BFCAllocator::AllocateRaw(size_t alignment, size_t num_bytes,
       if (allocation_attr.freed_by_func != nullptr) {
         freed_by_count = (*allocation_attr.freed_by_func)();
       }
-      void* res =
-          AllocateRawInternal(alignment, num_bytes, dump_log_on_failure,
-                              freed_by_count, allocation_attr.allocation_end);
+      void* res = AllocateRawInternalOrFlushThreadCaches(
+          alignment, num_bytes, dump_log_on_failure, freed_by_count,
+          allocation_attr.allocation_end);
       if (res == nullptr) {
         int32_t counter_value = log_counter.load(std::memory_order_relaxed);
         if (counter_value < kMaxFailureLogs) {
@@ -603,6 +755,237 @@ void* BFCAllocator::AllocateRawInternal(size_t alignment, size_t num_bytes,
   return nullptr;
 }
 
+void* BFCAllocator::AllocateRawInternalOrFlushThreadCaches(
+    size_t alignment, size_t num_bytes, bool dump_log_on_failure,
+    uint64_t freed_before, AllocationEnd allocation_end) {
+  if (ABSL_PREDICT_TRUE(!thread_chunk_caching_enabled())) {
+    return AllocateRawInternal(alignment, num_bytes, dump_log_on_failure,
+                               freed_before, allocation_end);
+  }
+  void* ptr = AllocateRawInternal(alignment, num_bytes,
+                                  /*dump_log_on_failure=*/false, freed_before,
+                                  allocation_end);
+  if (ptr != nullptr) {
+    return ptr;
+  }
+  // Chunks parked in thread caches are invisible to the Bins; give them back
+  // before declaring the allocation a failure.
+  FlushAllThreadChunkCaches();
+  return AllocateRawInternal(alignment, num_bytes, dump_log_on_failure,
+                             freed_before, allocation_end);
+}
+
+BFCAllocator::ThreadChunkCache* BFCAllocator::GetThreadChunkCache() {
+  // The calling thread's caches, keyed by thread_cache_key_. Each cache is
+  // co-owned by the allocator's thread_caches_ so that the allocator can flush
+  // or orphan it; when the thread exits, its cached chunks go back to the
+  // Bins.
+  struct ThreadCaches {
+    ~ThreadCaches() {
+      for (auto& [key, cache] : caches) {
+        cache->ReleaseAtThreadExit();
+      }
+    }
+    absl::flat_hash_map<int64_t, std::shared_ptr<ThreadChunkCache>> caches;
+    int64_t last_key = -1;
+    ThreadChunkCache* last_cache = nullptr;
+  };
+  static thread_local ThreadCaches thread_caches;  // NOLINT
+
+  if (ABSL_PREDICT_TRUE(thread_caches.last_key == thread_cache_key_)) {
+    return thread_caches.last_cache;
+  }
+  auto it = thread_caches.caches.find(thread_cache_key_);
+  if (it == thread_caches.caches.end()) {
+    // Forget the caches of allocators that have been destroyed.
+    absl::erase_if(thread_caches.caches, [](const auto& entry) {
+      return entry.second->orphaned();
+    });
+    auto cache = std::make_shared<ThreadChunkCache>(this);
+    {
+      absl::MutexLock l(thread_caches_mutex_);
+      // Forget the caches of threads that have exited.
+      thread_caches_.erase(
+          std::remove_if(thread_caches_.begin(), thread_caches_.end(),
+                         [](const std::shared_ptr<ThreadChunkCache>& c) {
+                           return c.use_count() == 1;
+                         }),
+          thread_caches_.end());
+      thread_caches_.push_back(cache);
+    }
+    it = thread_caches.caches.emplace(thread_cache_key_, std::move(cache))
+             .first;
+  }
+  thread_caches.last_key = thread_cache_key_;
+  thread_caches.last_cache = it->second.get();
+  return thread_caches.last_cache;
+}
+
+void* BFCAllocator::AllocateFromThreadChunkCache(size_t alignment,
+                                                 size_t num_bytes) {
+  DCHECK(absl::has_single_bit(alignment)) << "alignment must be a power of 2";
+  alignment = std::max(alignment, kMinAllocationSize);
+  const size_t rounded_bytes = RoundedBytes(num_bytes);
+  const BinNum bin_num = BinNumForSize(rounded_bytes);
+
+  ThreadChunkCache* cache = GetThreadChunkCache();
+  void* ptr = nullptr;
+  std::vector<void*> cold;
+  {
+    absl::MutexLock l(cache->mu());
+    size_t size = 0;
+    ptr = cache->Pop(bin_num, rounded_bytes, alignment, &size);
+    if (ptr != nullptr) {
+      thread_cached_bytes_.fetch_sub(size, std::memory_order_relaxed);
+      thread_cache_hits_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      // Refill with half the capacity, so the following allocations of this
+      // size class hit the cache even if this thread never frees.
+      const int count = std::max(1, opts_.thread_local_cache_capacity / 2);
+      std::vector<void*> ptrs(count);
+      std::vector<size_t> sizes(count);
+      const int n = AllocateChunksForThreadChunkCache(
+          alignment, rounded_bytes, count, ptrs.data(), sizes.data());
+      if (n > 0) {
+        ptr = ptrs[0];
+        for (int i = 1; i < n; ++i) {
+          cache->Push(bin_num, ptrs[i], sizes[i]);
+          thread_cached_bytes_.fetch_add(sizes[i], std::memory_order_relaxed);
+        }
+      }
+    }
+    cache->MaybeTakeColdChunks(&cold);
+  }
+  if (!cold.empty()) {
+    ReleaseThreadCachedChunks(cold);
+  }
+  return ptr;
+}
+
+int BFCAllocator::AllocateChunksForThreadChunkCache(size_t alignment,
+                                                    size_t rounded_bytes,
+                                                    int count, void** ptrs,
+                                                    size_t* sizes) {
+  absl::MutexLock l(mutex_);
+  const BinNum bin_num = BinNumForSize(rounded_bytes);
+  int n = 0;
+  for (; n < count; ++n) {
+    void* ptr = FindChunkPtr(bin_num, rounded_bytes, rounded_bytes, alignment,
+                             /*freed_before=*/0, AllocationEnd::kLower);
+    if (ptr == nullptr) {
+      break;
+    }
+    ptrs[n] = ptr;
+    sizes[n] = ChunkFromHandle(region_manager_.get_handle(ptr))->size;
+  }
+  if (n > 0) {
+    // Only the first chunk is handed to the client now; the rest are counted
+    // as cache hits when they are handed out.
+    stats_.num_allocs -= n - 1;
+    AddTraceMe("MemoryAllocation", ptrs[0]);
+  }
+  return n;
+}
+
+bool BFCAllocator::DeallocateToThreadChunkCache(void* ptr) {
+  if (timing_counter_ != nullptr) {
+    return false;
+  }
+  const size_t size = CacheableChunkSize(ptr);
+  if (size == 0) {
+    return false;
+  }
+  const BinNum bin_num = BinNumForSize(size);
+  const size_t capacity = opts_.thread_local_cache_capacity;
+
+  ThreadChunkCache* cache = GetThreadChunkCache();
+  std::vector<void*> overflow;
+  {
+    absl::MutexLock l(cache->mu());
+    thread_cached_bytes_.fetch_add(size, std::memory_order_relaxed);
+    if (cache->Push(bin_num, ptr, size) > capacity) {
+      // Return the oldest half in one batch rather than one chunk per free.
+      cache->TakeOldest(bin_num, /*keep=*/capacity / 2, &overflow);
+    }
+    cache->MaybeTakeColdChunks(&overflow);
+  }
+  if (!overflow.empty()) {
+    ReleaseThreadCachedChunks(overflow);
+  }
+  return true;
+}
+
+void BFCAllocator::ReleaseThreadCachedChunks(const std::vector<void*>& ptrs) {
+  {
+    absl::MutexLock l(mutex_);
+    for (void* ptr : ptrs) {
+      ChunkHandle h = region_manager_.get_handle(ptr);
+      CHECK(h != kInvalidChunkHandle);  // Crash OK
+      Chunk* chunk = ChunkFromHandle(h);
+      int64_t req_bytes = chunk->requested_size;
+      int64_t alloc_bytes = chunk->size;
+      thread_cached_bytes_.fetch_sub(alloc_bytes, std::memory_order_relaxed);
+      UntrackCacheableChunk(ptr);
+
+      MarkFree(h);
+      if (ABSL_PREDICT_FALSE(timing_counter_ != nullptr)) {
+        InsertFreeChunk(h);
+        timestamped_chunks_.push_back(h);
+      } else {
+        InsertFreeChunk(TryToCoalesce(h, false));
+      }
+      AddTraceMe("MemoryDeallocation", ptr, req_bytes, alloc_bytes);
+    }
+  }
+  retry_helper_.NotifyDealloc();
+}
+
+bool BFCAllocator::FlushAllThreadChunkCaches() {
+  std::vector<std::shared_ptr<ThreadChunkCache>> caches;
+  {
+    absl::MutexLock l(thread_caches_mutex_);
+    caches = thread_caches_;
+  }
+  std::vector<void*> ptrs;
+  for (const std::shared_ptr<ThreadChunkCache>& cache : caches) {
+    absl::MutexLock l(cache->mu());
+    cache->TakeAll(&ptrs);
+  }
+  if (ptrs.empty()) {
+    return false;
+  }
+  VLOG(1) << "Flushing " << ptrs.size() << " thread-cached chunks of "
+          << Name();
+  ReleaseThreadCachedChunks(ptrs);
+  return true;
+}
+
+BFCAllocator::CacheableChunkShard& BFCAllocator::CacheableChunkShardFor(
+    const void* ptr) {
+  const uintptr_t index =
+      absl::bit_cast<uintptr_t>(ptr) >> kMinAllocationBits;
+  return cacheable_chunk_shards_[index % kNumCacheableChunkShards];
+}
+
+void BFCAllocator::TrackCacheableChunk(const void* ptr, size_t size) {
+  CacheableChunkShard& shard = CacheableChunkShardFor(ptr);
+  absl::MutexLock l(shard.mu);
+  shard.sizes[ptr] = size;
+}
+
+void BFCAllocator::UntrackCacheableChunk(const void* ptr) {
+  CacheableChunkShard& shard = CacheableChunkShardFor(ptr);
+  absl::MutexLock l(shard.mu);
+  shard.sizes.erase(ptr);
+}
+
+size_t BFCAllocator::CacheableChunkSize(const void* ptr) {
+  CacheableChunkShard& shard = CacheableChunkShardFor(ptr);
+  absl::MutexLock l(shard.mu);
+  auto it = shard.sizes.find(ptr);
+  return it == shard.sizes.end() ? 0 : it->second;
+}
+
 size_t BFCAllocator::LargestBinnedFreeChunk() {
   for (int i = kNumBins - 1; i >= 0; i--) {
     if (!BinFromIndex(i)->free_chunks.empty()) {
@@ -882,6 +1265,10 @@ void BFCAllocator::FinishChunkAllocation(Chunk* chunk, size_t num_bytes) {
   stats_.largest_alloc_size =
       std::max<std::size_t>(stats_.largest_alloc_size, chunk->size);
 
+  if (ABSL_PREDICT_FALSE(ThreadChunkCacheable(chunk->size))) {
+    TrackCacheableChunk(chunk->ptr, chunk->size);
+  }
+
 #ifdef TENSORFLOW_MEM_DEBUG
   if (ShouldRecordOpName()) {
     const auto& annotation =
@@ -955,6 +1342,12 @@ void BFCAllocator::DeallocateRaw(void* ptr) {
   VLOG(4) << "[mem-debug] DeallocateRaw," << Name() << ","
           << (ptr ? RequestedSize(ptr) : 0) << "," << ptr << ","
           << tsl::CurrentStackTrace();
+  if (ABSL_PREDICT_FALSE(thread_chunk_caching_enabled()) && ptr != nullptr &&
+      DeallocateToThreadChunkCache(ptr)) {
+    // The chunk stays with this thread, so there is nothing for waiters in
+    // retry_helper_ to pick up.
+    return;
+  }
   DeallocateRawInternal(ptr);
   retry_helper_.NotifyDealloc();
 }
@@ -975,6 +1368,10 @@ void BFCAllocator::DeallocateRawInternal(void* ptr) {
   int64_t req_bytes = chunk->requested_size;
   int64_t alloc_bytes = chunk->size;
 
+  if (ABSL_PREDICT_FALSE(thread_chunk_caching_enabled())) {
+    UntrackCacheableChunk(chunk_ptr);
+  }
+
   MarkFree(h);
 
   // Consider coalescing it.
@@ -1594,12 +1991,16 @@ std::optional<AllocatorStats> BFCAllocator::GetStats() {
   absl::MutexLock l(mutex_);
   AllocatorStats stats = stats_;
   stats.largest_free_block_bytes = static_cast<int64_t>(LargestFreeChunk());
+  // Chunks parked in thread caches are free from the client's point of view.
+  stats.bytes_in_use -= thread_cached_bytes_.load(std::memory_order_relaxed);
+  stats.num_allocs += thread_cache_hits_.load(std::memory_order_relaxed);
   return stats;
 }
 
 bool BFCAllocator::ClearStats() {
   absl::MutexLock l(mutex_);
   stats_.num_allocs = 0;
+  thread_cache_hits_.store(0, std::memory_order_relaxed);
   stats_.peak_bytes_in_use = stats_.bytes_in_use;
   stats_.largest_alloc_size = 0;
   return true;
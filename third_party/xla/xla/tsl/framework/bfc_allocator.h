@@ -30,6 +30,7 @@ limitations under the License.
 #include "absl/base/casts.h"
 #include "absl/base/thread_annotations.h"
 #include "absl/container/btree_set.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
@@ -140,6 +141,30 @@ class BFCAllocator : public Allocator {
     //
     // Requires allow_growth=false (a single fixed address range).
     bool enable_spatial_partitioning = false;
+
+    // If > 0, every thread keeps a private cache of up to this many recently
+    // freed chunks per size-class Bin, in front of the Bins:
+    //
+    //   AllocateRaw   -> thread cache hit? -> done (no mutex_)
+    //                 -> miss: refill a batch from the Bins under one mutex_
+    //   DeallocateRaw -> push into the thread cache (no mutex_)
+    //                 -> overflow / periodic flush: return a batch to the
+    //                    Bins under one mutex_
+    //
+    // Cached chunks stay "in use" as far as the Bins are concerned and are
+    // only coalesced once they are flushed back, so this trades some memory
+    // (bounded by capacity * thread_local_cache_max_chunk_bytes per Bin per
+    // thread) for removing mutex_ from the steady-state alloc/free path of
+    // small allocations. All thread caches are flushed before an allocation
+    // is reported as failed.
+    //
+    // Only chunks of at most thread_local_cache_max_chunk_bytes are cached.
+    // Caching is bypassed while a timing counter is installed, and it is
+    // incompatible with enable_spatial_partitioning. With caching enabled,
+    // RequestedSize() and AllocationId() of a chunk served from a thread cache
+    // describe the allocation that originally carved the chunk.
+    int thread_local_cache_capacity = 0;
+    size_t thread_local_cache_max_chunk_bytes = 64 << 10;
   };
 
   BFCAllocator(std::unique_ptr<SubAllocator> sub_allocator, size_t total_memory,
@@ -186,11 +211,72 @@ class BFCAllocator : public Allocator {
  private:
   struct Bin;
 
+  // Per-thread cache of recently freed chunks (see
+  // Options::thread_local_cache_capacity). Defined in bfc_allocator.cc.
+  class ThreadChunkCache;
+
   void* AllocateRawInternal(size_t alignment, size_t num_bytes,
                             bool dump_log_on_failure,
                             uint64_t freed_before_count,
                             AllocationEnd allocation_end);
 
+  // AllocateRawInternal, but if thread chunk caching is enabled and the
+  // allocation fails, flushes every thread cache and tries once more before
+  // reporting the failure.
+  void* AllocateRawInternalOrFlushThreadCaches(size_t alignment,
+                                               size_t num_bytes,
+                                               bool dump_log_on_failure,
+                                               uint64_t freed_before_count,
+                                               AllocationEnd allocation_end);
+
+  bool thread_chunk_caching_enabled() const {
+    return opts_.thread_local_cache_capacity > 0;
+  }
+
+  // Whether a request or chunk of 'rounded_bytes' may go through the calling
+  // thread's chunk cache.
+  bool ThreadChunkCacheable(size_t rounded_bytes) const {
+    return thread_chunk_caching_enabled() &&
+           rounded_bytes <= opts_.thread_local_cache_max_chunk_bytes &&
+           timing_counter_ == nullptr;
+  }
+
+  // Returns the calling thread's chunk cache for this allocator, creating and
+  // registering it on first use.
+  ThreadChunkCache* GetThreadChunkCache();
+
+  // Serves an allocation from the calling thread's chunk cache, refilling the
+  // cache from the Bins on a miss. Returns nullptr if neither the cache nor
+  // the existing free chunks can satisfy the request.
+  void* AllocateFromThreadChunkCache(size_t alignment, size_t num_bytes);
+
+  // Pushes 'ptr' into the calling thread's chunk cache. Returns false if the
+  // chunk is not cacheable, in which case the caller must free it through the
+  // Bins.
+  bool DeallocateToThreadChunkCache(void* ptr);
+
+  // Carves up to 'count' chunks of 'rounded_bytes' from the Bins under a
+  // single acquisition of mutex_. Returns the number of chunks written to
+  // 'ptrs' and 'sizes'.
+  int AllocateChunksForThreadChunkCache(size_t alignment, size_t rounded_bytes,
+                                        int count, void** ptrs, size_t* sizes);
+
+  // Returns chunks held by a thread cache to the Bins under a single
+  // acquisition of mutex_.
+  void ReleaseThreadCachedChunks(const std::vector<void*>& ptrs);
+
+  // Returns the chunks of every thread cache to the Bins. Returns true if any
+  // chunk was released.
+  bool FlushAllThreadChunkCaches();
+
+  // Side table mapping cacheable in-use chunks to their size, so that
+  // DeallocateRaw can size-class a pointer without taking mutex_.
+  struct CacheableChunkShard;
+  CacheableChunkShard& CacheableChunkShardFor(const void* ptr);
+  void TrackCacheableChunk(const void* ptr, size_t size);
+  void UntrackCacheableChunk(const void* ptr);
+  size_t CacheableChunkSize(const void* ptr);
+
   void* AllocateRawInternalWithRetry(
       size_t alignment, size_t num_bytes,
       const AllocationAttributes& allocation_attr);
@@ -793,6 +879,32 @@ class BFCAllocator : public Allocator {
   // Stats.
   AllocatorStats stats_ ABSL_GUARDED_BY(mutex_);
 
+  // Thread chunk caching state; only used if thread_chunk_caching_enabled().
+  // Lock order: ThreadChunkCache::mu -> mutex_ -> CacheableChunkShard::mu,
+  // and thread_caches_mutex_ -> ThreadChunkCache::mu.
+  //
+  // Unique among all allocators ever created; keys the thread-local caches so
+  // that a new allocator at a recycled address never sees a stale cache.
+  const int64_t thread_cache_key_;
+
+  absl::Mutex thread_caches_mutex_;
+  std::vector<std::shared_ptr<ThreadChunkCache>> thread_caches_
+      ABSL_GUARDED_BY(thread_caches_mutex_);
+
+  struct CacheableChunkShard {
+    absl::Mutex mu;
+    absl::flat_hash_map<const void*, size_t> sizes ABSL_GUARDED_BY(mu);
+  };
+  static constexpr int kNumCacheableChunkShards = 64;
+  std::unique_ptr<CacheableChunkShard[]> cacheable_chunk_shards_;
+
+  // Bytes of chunks currently parked in thread caches. These chunks are in use
+  // as far as stats_ is concerned; GetStats() reports them as free.
+  std::atomic<int64_t> thread_cached_bytes_{0};
+
+  // Allocations served from thread caches without touching stats_.
+  std::atomic<int64_t> thread_cache_hits_{0};
+
 #ifdef TENSORFLOW_MEM_DEBUG
   int64_t action_counter_ ABSL_GUARDED_BY(mutex_);
 #define MEM_DEBUG_SIZE_HISTORY_SIZE 4096
@@ -667,6 +667,149 @@ TEST(BFCAllocatorTest, SpatialUnderContention) {
   EXPECT_EQ(failures.load(std::memory_order_relaxed), 0);
 }
 
+//===----------------------------------------------------------------------===//
+// Thread-local chunk cache tests.
+//===----------------------------------------------------------------------===//
+
+static BFCAllocator::Options ThreadCachedOptions() {
+  BFCAllocator::Options opts;
+  opts.thread_local_cache_capacity = 8;
+  return opts;
+}
+
+TEST(BFCAllocatorTest, ThreadCacheReusesFreedChunk) {
+  BFCAllocator alloc(std::make_unique<FakeSubAllocator>(),
+                     /*total_memory=*/1 << 20, /*name=*/"cached",
+                     ThreadCachedOptions());
+
+  void* ptr = alloc.AllocateRaw(kAlignment, 1024);
+  ASSERT_NE(ptr, nullptr);
+  alloc.DeallocateRaw(ptr);
+
+  // The freed chunk is parked in this thread's cache but reported as free.
+  std::optional<AllocatorStats> stats = alloc.GetStats();
+  ASSERT_TRUE(stats.has_value());
+  EXPECT_EQ(stats->bytes_in_use, 0);
+
+  void* again = alloc.AllocateRaw(kAlignment, 1024);
+  EXPECT_EQ(again, ptr);
+  stats = alloc.GetStats();
+  EXPECT_EQ(stats->num_allocs, 2);
+  EXPECT_EQ(stats->bytes_in_use,
+            static_cast<int64_t>(alloc.AllocatedSize(again)));
+  alloc.DeallocateRaw(again);
+}
+
+TEST(BFCAllocatorTest, ThreadCacheRespectsAlignment) {
+  BFCAllocator alloc(std::make_unique<FakeSubAllocator>(),
+                     /*total_memory=*/1 << 20, /*name=*/"cached",
+                     ThreadCachedOptions());
+
+  for (size_t alignment : {64, 512, 4096}) {
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 16; ++i) {
+      void* ptr = alloc.AllocateRaw(alignment, 700);
+      ASSERT_NE(ptr, nullptr);
+      EXPECT_TRUE(IsAligned(ptr, alignment)) << "alignment=" << alignment;
+      ptrs.push_back(ptr);
+    }
+    for (void* ptr : ptrs) {
+      alloc.DeallocateRaw(ptr);
+    }
+  }
+}
+
+TEST(BFCAllocatorTest, ThreadCacheFlushedBeforeOom) {
+  BFCAllocator::Options opts = ThreadCachedOptions();
+  opts.allow_growth = false;
+  opts.allow_retry_on_failure = false;
+  BFCAllocator alloc(std::make_unique<FakeSubAllocator>(),
+                     /*total_memory=*/64 << 10, /*name=*/"cached", opts);
+
+  // Park chunks covering part of the pool in another (still running)
+  // thread's cache.
+  tsl::thread::ThreadPool threads(tsl::Env::Default(), "cache_owner", 1);
+  absl::BlockingCounter done(1);
+  threads.Schedule([&] {
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 6; ++i) {
+      ptrs.push_back(alloc.AllocateRaw(kAlignment, 4096));
+    }
+    for (void* ptr : ptrs) {
+      alloc.DeallocateRaw(ptr);
+    }
+    done.DecrementCount();
+  });
+  done.Wait();
+
+  // The whole pool is only available once the other thread's cache has been
+  // flushed back to the Bins.
+  void* ptr = alloc.AllocateRaw(kAlignment, 64 << 10);
+  EXPECT_NE(ptr, nullptr);
+  alloc.DeallocateRaw(ptr);
+}
+
+TEST(BFCAllocatorTest, ThreadCacheReturnedAtThreadExit) {
+  BFCAllocator alloc(std::make_unique<FakeSubAllocator>(),
+                     /*total_memory=*/1 << 20, /*name=*/"cached",
+                     ThreadCachedOptions());
+  {
+    tsl::thread::ThreadPool threads(tsl::Env::Default(), "short_lived", 4);
+    for (int t = 0; t < 4; ++t) {
+      threads.Schedule([&] {
+        for (int i = 0; i < 100; ++i) {
+          alloc.DeallocateRaw(alloc.AllocateRaw(kAlignment, 256 << (i % 4)));
+        }
+      });
+    }
+  }
+  std::optional<AllocatorStats> stats = alloc.GetStats();
+  ASSERT_TRUE(stats.has_value());
+  EXPECT_EQ(stats->bytes_in_use, 0);
+  // All chunks coalesced back into the single region.
+  EXPECT_EQ(stats->largest_free_block_bytes, *stats->pool_bytes);
+}
+
+TEST(BFCAllocatorTest, ThreadCacheCrossThreadFrees) {
+  BFCAllocator alloc(std::make_unique<FakeSubAllocator>(),
+                     /*total_memory=*/64 << 20, /*name=*/"cached",
+                     ThreadCachedOptions());
+
+  constexpr int kNumThreads = 8;
+  constexpr int kItersPerThread = 1000;
+  std::vector<std::vector<void*>> handoff(kNumThreads);
+  std::atomic<int> failures{0};
+  {
+    tsl::thread::ThreadPool threads(tsl::Env::Default(), "cross_thread",
+                                    kNumThreads);
+    absl::BlockingCounter allocated(kNumThreads);
+    absl::BlockingCounter freed(kNumThreads);
+    for (int t = 0; t < kNumThreads; ++t) {
+      threads.Schedule([&, t] {
+        for (int i = 0; i < kItersPerThread; ++i) {
+          void* ptr = alloc.AllocateRaw(kAlignment, 64 + 32 * (i % 64));
+          if (ptr == nullptr || !IsAligned(ptr, kAlignment)) {
+            failures.fetch_add(1, std::memory_order_relaxed);
+          }
+          handoff[t].push_back(ptr);
+        }
+        allocated.DecrementCount();
+        allocated.Wait();
+        // Free what the neighboring thread allocated.
+        for (void* ptr : handoff[(t + 1) % kNumThreads]) {
+          alloc.DeallocateRaw(ptr);
+        }
+        freed.DecrementCount();
+      });
+    }
+    freed.Wait();
+  }
+  EXPECT_EQ(failures.load(std::memory_order_relaxed), 0);
+  std::optional<AllocatorStats> stats = alloc.GetStats();
+  ASSERT_TRUE(stats.has_value());
+  EXPECT_EQ(stats->bytes_in_use, 0);
+}
+
 //===----------------------------------------------------------------------===//
 // Performance benchmarks.
 //===----------------------------------------------------------------------===//
@@ -776,5 +919,86 @@ BENCHMARK(BM_AllocAndFreeUnderContention)
     ->Arg(8)
     ->Arg(16);
 
+static void BM_ThreadCachedAllocAndFreeUnderContention(
+    benchmark::State& state) {
+  size_t num_threads = state.range(0);
+  static constexpr int kItersPerThread = 10000;
+
+  BFCAllocator::Options opts;
+  opts.thread_local_cache_capacity = 32;
+  BFCAllocator alloc(std::make_unique<FakeSubAllocator>(),
+                     /*total_memory=*/256 << 20, /*name=*/"bench", opts);
+  tsl::thread::ThreadPool threads(tsl::Env::Default(), "bench", num_threads);
+
+  for (auto _ : state) {
+    absl::BlockingCounter counter(num_threads);
+    for (int t = 0; t < num_threads; ++t) {
+      threads.Schedule([&] {
+        for (int i = 0; i < kItersPerThread; ++i) {
+          void* ptr = alloc.AllocateRaw(kAlignment, kBenchAllocSize);
+          alloc.DeallocateRaw(ptr);
+        }
+        counter.DecrementCount();
+      });
+    }
+    counter.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * num_threads * kItersPerThread);
+}
+
+BENCHMARK(BM_ThreadCachedAllocAndFreeUnderContention)
+    ->MeasureProcessCPUTime()
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->Arg(16);
+
+// Small-tensor-heavy pattern: every thread keeps a window of mixed-size live
+// allocations and frees them in batches. Arguments are the number of threads
+// and whether thread-local chunk caching is enabled.
+static void BM_MixedSizesBatchUnderContention(benchmark::State& state) {
+  size_t num_threads = state.range(0);
+  static constexpr int kBatch = 64;
+  static constexpr int kBatchesPerThread = 200;
+
+  BFCAllocator::Options opts;
+  opts.thread_local_cache_capacity = state.range(1) ? 32 : 0;
+  BFCAllocator alloc(std::make_unique<FakeSubAllocator>(),
+                     /*total_memory=*/256 << 20, /*name=*/"bench", opts);
+  tsl::thread::ThreadPool threads(tsl::Env::Default(), "bench", num_threads);
+
+  for (auto _ : state) {
+    absl::BlockingCounter counter(num_threads);
+    for (int t = 0; t < num_threads; ++t) {
+      threads.Schedule([&] {
+        std::array<void*, kBatch> ptrs;
+        for (int b = 0; b < kBatchesPerThread; ++b) {
+          for (int i = 0; i < kBatch; ++i) {
+            ptrs[i] = alloc.AllocateRaw(kAlignment, 256 << (i % 6));
+          }
+          for (int i = 0; i < kBatch; ++i) {
+            alloc.DeallocateRaw(ptrs[i]);
+          }
+        }
+        counter.DecrementCount();
+      });
+    }
+    counter.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * num_threads * kBatch *
+                          kBatchesPerThread);
+}
+
+BENCHMARK(BM_MixedSizesBatchUnderContention)
+    ->MeasureProcessCPUTime()
+    ->ArgPair(1, 0)
+    ->ArgPair(1, 1)
+    ->ArgPair(4, 0)
+    ->ArgPair(4, 1)
+    ->ArgPair(16, 0)
+    ->ArgPair(16, 1)
+    ->ArgPair(64, 0)
+    ->ArgPair(64, 1);
+
 }  // namespace
 }  // namespace tsl
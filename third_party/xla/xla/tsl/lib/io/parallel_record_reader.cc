@@ -0,0 +1,468 @@
+/* Copyright 2026 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/tsl/lib/io/parallel_record_reader.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "xla/tsl/lib/hash/crc32c.h"
+#include "xla/tsl/lib/io/record_reader.h"
+#include "xla/tsl/platform/env.h"
+#include "xla/tsl/platform/file_system.h"
+#include "xla/tsl/platform/threadpool.h"
+#include "tsl/platform/raw_coding.h"
+#include "tsl/platform/tstring.h"
+
+namespace tsl {
+namespace io {
+namespace {
+
+// Extent pieces smaller than this are copied into the record instead of being
+// referenced, since an external Cord node costs more than the copy.
+constexpr size_t kMinReferencedBytes = 512;
+
+inline const char* GetChecksumErrorSuffix(uint64_t offset) {
+  if (offset == 0) {
+    return " (Is this even a TFRecord file?)";
+  }
+  return "";
+}
+
+uint32_t CordCrc32c(const absl::Cord& cord) {
+  uint32_t crc = 0;
+  for (absl::string_view chunk : cord.Chunks()) {
+    crc = crc32c::Extend(crc, chunk.data(), chunk.size());
+  }
+  return crc;
+}
+
+void CopyCordToArray(const absl::Cord& cord, char* dst) {
+  for (absl::string_view chunk : cord.Chunks()) {
+    std::memcpy(dst, chunk.data(), chunk.size());
+    dst += chunk.size();
+  }
+}
+
+}  // namespace
+
+// A file extent of up to options_.extent_size bytes starting at `start`. An
+// extent shorter than extent_size marks the end of the file.
+struct ParallelRecordReader::Extent {
+  uint64_t start = 0;
+  std::unique_ptr<char[]> scratch;
+  absl::string_view data;
+  absl::Status status;
+  absl::Notification ready;
+};
+
+struct ParallelRecordReader::Record {
+  absl::Cord payload;
+  uint32_t masked_crc = 0;
+  uint64_t offset = 0;
+  uint64_t next_offset = 0;
+};
+
+// Consecutive records handed from the framing thread to the consumer. A batch
+// whose end_status is not OK is the last one; the consumer returns
+// end_status after the batch's records.
+struct ParallelRecordReader::Batch {
+  std::vector<Record> records;
+  absl::Status end_status;
+  bool verified = false;
+  // Index of the first record whose payload checksum does not match.
+  size_t first_corrupted = 0;
+};
+
+// Sequential view over the extents of the file that keeps up to
+// options_.num_extents_in_flight extent reads running ahead of the cursor.
+// Only used by the framing thread.
+class ParallelRecordReader::ExtentCursor {
+ public:
+  ExtentCursor(ParallelRecordReader* reader, uint64_t offset)
+      : reader_(reader),
+        extent_size_(std::max<int64_t>(reader->options_.extent_size, 1)),
+        offset_(offset),
+        next_extent_start_(offset - offset % extent_size_) {
+    ScheduleReads();
+  }
+
+  ~ExtentCursor() {
+    // Outstanding reads reference the extents only through shared_ptrs, but
+    // wait for them anyway so no I/O outlives the cursor.
+    for (const std::shared_ptr<Extent>& extent : in_flight_) {
+      extent->ready.WaitForNotification();
+    }
+  }
+
+  // Appends the next `n` bytes of the file to `out`, advancing the cursor.
+  // `bytes_read` is set to the number of bytes appended; it is less than `n`
+  // only if the file ended (OUT_OF_RANGE) or a read failed.
+  absl::Status Read(size_t n, absl::Cord* out, size_t* bytes_read) {
+    *bytes_read = 0;
+    while (n > 0) {
+      std::shared_ptr<Extent> extent = in_flight_.front();
+      extent->ready.WaitForNotification();
+      if (!extent->status.ok() && !absl::IsOutOfRange(extent->status)) {
+        return extent->status;
+      }
+      const uint64_t pos = offset_ - extent->start;
+      if (pos >= extent->data.size()) {
+        if (extent->data.size() < extent_size_) {
+          return absl::OutOfRangeError("eof");
+        }
+        in_flight_.pop_front();
+        ScheduleReads();
+        continue;
+      }
+      const size_t size = std::min<size_t>(n, extent->data.size() - pos);
+      absl::string_view piece = extent->data.substr(pos, size);
+      if (size < kMinReferencedBytes) {
+        out->Append(piece);
+      } else {
+        out->Append(absl::MakeCordFromExternal(
+            piece, [extent](absl::string_view) {}));
+      }
+      offset_ += size;
+      n -= size;
+      *bytes_read += size;
+    }
+    return absl::OkStatus();
+  }
+
+ private:
+  void ScheduleReads() {
+    const size_t max_in_flight =
+        std::max(reader_->options_.num_extents_in_flight, 1);
+    while (in_flight_.size() < max_in_flight) {
+      auto extent = std::make_shared<Extent>();
+      extent->start = next_extent_start_;
+      next_extent_start_ += extent_size_;
+      in_flight_.push_back(extent);
+      reader_->Schedule(
+          [file = reader_->file_, extent_size = extent_size_, extent] {
+            extent->scratch = std::make_unique<char[]>(extent_size);
+            extent->status =
+                file->Read(extent->start, extent_size, &extent->data,
+                           extent->scratch.get());
+            // Records may outlive the file, so never reference memory owned
+            // by it (e.g. of memory mapped files).
+            if (!extent->data.empty() &&
+                extent->data.data() != extent->scratch.get()) {
+              std::memmove(extent->scratch.get(), extent->data.data(),
+                           extent->data.size());
+              extent->data = absl::string_view(extent->scratch.get(),
+                                               extent->data.size());
+            }
+            extent->ready.Notify();
+          });
+    }
+  }
+
+  ParallelRecordReader* const reader_;
+  const uint64_t extent_size_;
+  uint64_t offset_;
+  uint64_t next_extent_start_;
+  std::deque<std::shared_ptr<Extent>> in_flight_;
+};
+
+ParallelRecordReader::ParallelRecordReader(
+    RandomAccessFile* file, uint64_t start_offset,
+    const ParallelRecordReaderOptions& options, Env* env)
+    : file_(file),
+      options_(options),
+      offset_(start_offset) {
+  if (options_.runner) {
+    runner_ = options_.runner;
+  } else {
+    pool_ = std::make_unique<thread::ThreadPool>(
+        env, "parallel_record_reader", std::max(options.num_threads, 1));
+    runner_ = [pool = pool_.get()](std::function<void()> fn) {
+      pool->Schedule(std::move(fn));
+    };
+  }
+  const bool compressed =
+      options_.record_options.compression_type != RecordReaderOptions::NONE;
+  framer_.reset(env->StartThread(
+      ThreadOptions(), "parallel_record_reader_framer", [this, compressed] {
+        if (compressed) {
+          FrameCompressedRecords();
+        } else {
+          FrameRecords();
+        }
+      }));
+}
+
+ParallelRecordReader::~ParallelRecordReader() {
+  {
+    absl::MutexLock l(mu_);
+    cancelled_ = true;
+    cv_.SignalAll();
+  }
+  framer_.reset();
+  // Waits for the remaining extent reads and checksum verifications, which
+  // touch mu_ and batches_.
+  {
+    absl::MutexLock l(mu_);
+    while (num_pending_tasks_ > 0) {
+      cv_.Wait(&mu_);
+    }
+  }
+  pool_.reset();
+}
+
+void ParallelRecordReader::Schedule(std::function<void()> fn) {
+  {
+    absl::MutexLock l(mu_);
+    ++num_pending_tasks_;
+  }
+  runner_([this, fn = std::move(fn)] {
+    fn();
+    absl::MutexLock l(mu_);
+    --num_pending_tasks_;
+    cv_.SignalAll();
+  });
+}
+
+void ParallelRecordReader::FrameRecords() {
+  ExtentCursor cursor(this, offset_);
+  auto batch = std::make_shared<Batch>();
+  int64_t batch_bytes = 0;
+  uint64_t offset = offset_;
+  absl::Status status;
+  while (true) {
+    // Read and verify the header.
+    absl::Cord header;
+    size_t bytes_read = 0;
+    status = cursor.Read(RecordReader::kHeaderSize, &header, &bytes_read);
+    if (!status.ok()) {
+      if (absl::IsOutOfRange(status) && bytes_read > 0) {
+        status = absl::DataLossError(absl::StrCat(
+            "truncated record at ", offset, GetChecksumErrorSuffix(offset)));
+      } else if (absl::IsOutOfRange(status)) {
+        status = absl::OutOfRangeError(
+            absl::StrCat("eof", GetChecksumErrorSuffix(offset)));
+      }
+      break;
+    }
+    char header_bytes[RecordReader::kHeaderSize];
+    CopyCordToArray(header, header_bytes);
+    const uint32_t masked_header_crc =
+        core::DecodeFixed32(header_bytes + sizeof(uint64_t));
+    if (crc32c::Unmask(masked_header_crc) !=
+        crc32c::Value(header_bytes, sizeof(uint64_t))) {
+      status = absl::DataLossError(absl::StrCat(
+          "corrupted record at ", offset, GetChecksumErrorSuffix(offset)));
+      break;
+    }
+    const uint64_t length = core::DecodeFixed64(header_bytes);
+    if (length >= SIZE_MAX - RecordReader::kFooterSize) {
+      status = absl::DataLossError(absl::StrCat(
+          "record size too large", GetChecksumErrorSuffix(offset)));
+      break;
+    }
+
+    // Read the payload and its footer; the payload checksum is verified later
+    // on the pool.
+    Record record;
+    status = cursor.Read(length + RecordReader::kFooterSize, &record.payload,
+                         &bytes_read);
+    if (!status.ok()) {
+      if (absl::IsOutOfRange(status)) {
+        status = absl::DataLossError(absl::StrCat(
+            "truncated record at ", offset, GetChecksumErrorSuffix(offset)));
+      }
+      break;
+    }
+    char footer_bytes[RecordReader::kFooterSize];
+    CopyCordToArray(record.payload.Subcord(length, RecordReader::kFooterSize),
+                    footer_bytes);
+    record.payload.RemoveSuffix(RecordReader::kFooterSize);
+    record.masked_crc = core::DecodeFixed32(footer_bytes);
+    record.offset = offset;
+    offset += RecordReader::kHeaderSize + length + RecordReader::kFooterSize;
+    record.next_offset = offset;
+    batch->records.push_back(std::move(record));
+
+    batch_bytes += length;
+    if (batch_bytes >= options_.batch_bytes) {
+      if (!PublishBatch(std::move(batch))) {
+        return;
+      }
+      batch = std::make_shared<Batch>();
+      batch_bytes = 0;
+    }
+  }
+  batch->end_status = status;
+  PublishBatch(std::move(batch));
+}
+
+void ParallelRecordReader::FrameCompressedRecords() {
+  // A compressed stream has to be decompressed sequentially, which also
+  // verifies the checksums; this thread only keeps it running ahead.
+  SequentialRecordReader reader(file_, options_.record_options);
+  absl::Status status = reader.SeekOffset(offset_);
+  auto batch = std::make_shared<Batch>();
+  int64_t batch_bytes = 0;
+  while (status.ok()) {
+    Record record;
+    record.offset = reader.TellOffset();
+    tstring payload;
+    status = reader.ReadRecord(&payload);
+    if (!status.ok()) {
+      break;
+    }
+    batch_bytes += payload.size();
+    if (payload.size() < kMinReferencedBytes) {
+      record.payload = absl::Cord(absl::string_view(payload));
+    } else {
+      // The decompressed payload is handed out without another copy.
+      auto owned = std::make_unique<tstring>(std::move(payload));
+      const absl::string_view view(*owned);
+      record.payload = absl::MakeCordFromExternal(
+          view, [owned = std::move(owned)](absl::string_view) {});
+    }
+    record.next_offset = reader.TellOffset();
+    batch->records.push_back(std::move(record));
+    if (batch_bytes >= options_.batch_bytes) {
+      batch->verified = true;
+      batch->first_corrupted = batch->records.size();
+      if (!PublishBatch(std::move(batch))) {
+        return;
+      }
+      batch = std::make_shared<Batch>();
+      batch_bytes = 0;
+    }
+  }
+  batch->end_status = status;
+  batch->verified = true;
+  batch->first_corrupted = batch->records.size();
+  PublishBatch(std::move(batch));
+}
+
+bool ParallelRecordReader::PublishBatch(std::shared_ptr<Batch> batch) {
+  // Bound the framed-but-unconsumed records, which pin their extents.
+  const size_t max_pending_batches =
+      2 * static_cast<size_t>(std::max(options_.num_threads, 1));
+  {
+    absl::MutexLock l(mu_);
+    while (!cancelled_ && batches_.size() >= max_pending_batches) {
+      cv_.Wait(&mu_);
+    }
+    if (cancelled_) {
+      return false;
+    }
+    batches_.push_back(batch);
+    if (batch->verified) {
+      cv_.SignalAll();
+      return true;
+    }
+  }
+  Schedule([this, batch = std::move(batch)] { VerifyBatch(batch); });
+  return true;
+}
+
+void ParallelRecordReader::VerifyBatch(std::shared_ptr<Batch> batch) {
+  size_t first_corrupted = batch->records.size();
+  for (size_t i = 0; i < batch->records.size(); ++i) {
+    const Record& record = batch->records[i];
+    if (crc32c::Unmask(record.masked_crc) != CordCrc32c(record.payload)) {
+      first_corrupted = i;
+      break;
+    }
+  }
+  absl::MutexLock l(mu_);
+  batch->first_corrupted = first_corrupted;
+  batch->verified = true;
+  cv_.SignalAll();
+}
+
+absl::Status ParallelRecordReader::NextRecord(absl::Cord* record,
+                                              uint64_t* next_offset) {
+  absl::MutexLock l(mu_);
+  while (true) {
+    while (batches_.empty() || !batches_.front()->verified) {
+      cv_.Wait(&mu_);
+    }
+    Batch& batch = *batches_.front();
+    if (next_record_in_front_batch_ < batch.first_corrupted) {
+      Record& next = batch.records[next_record_in_front_batch_++];
+      *record = std::move(next.payload);
+      *next_offset = next.next_offset;
+      return absl::OkStatus();
+    }
+    if (batch.first_corrupted < batch.records.size()) {
+      const uint64_t offset = batch.records[batch.first_corrupted].offset;
+      return absl::DataLossError(absl::StrCat("corrupted record at ", offset,
+                                              GetChecksumErrorSuffix(offset)));
+    }
+    if (!batch.end_status.ok()) {
+      return batch.end_status;
+    }
+    batches_.pop_front();
+    next_record_in_front_batch_ = 0;
+    cv_.SignalAll();
+  }
+}
+
+absl::Status ParallelRecordReader::ReadRecord(absl::Cord* record) {
+  uint64_t next_offset = 0;
+  absl::Status s = NextRecord(record, &next_offset);
+  if (s.ok()) {
+    offset_ = next_offset;
+  }
+  return s;
+}
+
+absl::Status ParallelRecordReader::ReadRecord(tstring* record) {
+  absl::Cord cord;
+  absl::Status s = ReadRecord(&cord);
+  if (!s.ok()) {
+    return s;
+  }
+  if (cord.size() > TF_TString_SmallCapacity) {
+    // A record within a single extent is handed out as a view that keeps the
+    // extent alive.
+    auto* owner = new tstring::owner<absl::Cord>(std::move(cord));
+    std::optional<absl::string_view> flat = owner->value().TryFlat();
+    if (flat.has_value()) {
+      record->assign_as_shared_view(*flat, owner);
+      owner->Unref();
+      return absl::OkStatus();
+    }
+    cord = std::move(owner->value());
+    owner->Unref();
+  }
+  record->resize_uninitialized(cord.size());
+  CopyCordToArray(cord, record->mdata());
+  return absl::OkStatus();
+}
+
+}  // namespace io
+}  // namespace tsl
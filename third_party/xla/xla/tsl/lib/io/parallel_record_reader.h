@@ -0,0 +1,156 @@
+/* Copyright 2026 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_TSL_LIB_IO_PARALLEL_RECORD_READER_H_
+#define XLA_TSL_LIB_IO_PARALLEL_RECORD_READER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/synchronization/mutex.h"
+#include "xla/tsl/lib/io/record_reader.h"
+#include "xla/tsl/platform/env.h"
+#include "xla/tsl/platform/threadpool.h"
+#include "tsl/platform/tstring.h"
+
+namespace tsl {
+class RandomAccessFile;
+
+namespace io {
+
+struct ParallelRecordReaderOptions {
+  // Compression and buffering of the underlying records. Uncompressed files
+  // are read in parallel extents; compressed files are decompressed by a
+  // single background reader since the stream cannot be split.
+  RecordReaderOptions record_options;
+
+  // Size of the file extents read ahead. Extents start at multiples of
+  // extent_size, so reads are aligned regardless of the start offset.
+  int64_t extent_size = 8 << 20;
+
+  // Maximum number of extents being read or waiting to be framed.
+  int num_extents_in_flight = 4;
+
+  // Threads used to read extents and to verify record checksums, unless
+  // `runner` is set.
+  int num_threads = 4;
+
+  // If set, runs the extent reads and checksum verifications instead of a
+  // pool owned by the reader, so that readers can share threads, e.g. those
+  // of a tf.data iterator. It must stay usable while the reader is alive.
+  std::function<void(std::function<void()>)> runner;
+
+  // Framed records are handed to the verification workers in batches of
+  // roughly this many payload bytes.
+  int64_t batch_bytes = 1 << 20;
+};
+
+// Reads TFRecord files with a background read-ahead pipeline:
+//
+//   file --(parallel aligned extent reads)--> extents
+//        --(sequential framing, header CRC)--> record batches
+//        --(parallel payload CRC on the pool)--> ReadRecord()
+//
+// Records are returned in file order. Records of uncompressed files are
+// handed out as absl::Cords that reference the read-ahead extents, and the
+// records of compressed files as absl::Cords that own their decompressed
+// bytes. A record read into a tstring is a shared view of that memory, which
+// keeps it alive; only records that span two extents are copied.
+//
+// Errors are reported at the position of the offending record, with the same
+// status codes as RecordReader: OUT_OF_RANGE at the end of the file and
+// DATA_LOSS for truncated or corrupted records. After an error, the reader
+// must not be used anymore.
+//
+// Note: this class is not thread safe; external synchronization required.
+class ParallelRecordReader {
+ public:
+  // Create a reader that will return records starting at "start_offset" of
+  // "*file". "*file" must remain live while this reader is in use.
+  ParallelRecordReader(RandomAccessFile* file, uint64_t start_offset,
+                       const ParallelRecordReaderOptions& options =
+                           ParallelRecordReaderOptions(),
+                       Env* env = Env::Default());
+
+  // Stops the read-ahead and waits for outstanding reads.
+  ~ParallelRecordReader();
+
+  // Read the next record into *record. Returns OK on success, OUT_OF_RANGE for
+  // end of file, or something else for an error.
+  absl::Status ReadRecord(absl::Cord* record);
+  absl::Status ReadRecord(tstring* record);
+
+  // Return the offset of the next record to be returned.
+  uint64_t TellOffset() const { return offset_; }
+
+ private:
+  struct Extent;
+  struct Record;
+  struct Batch;
+  class ExtentCursor;
+
+  // Body of the framing thread: splits the extents into records, verifies the
+  // header checksums and schedules batches for payload verification.
+  void FrameRecords();
+  void FrameCompressedRecords();
+
+  // Appends 'batch' to batches_, blocking while too many batches are pending.
+  // Returns false if the reader is being destroyed.
+  bool PublishBatch(std::shared_ptr<Batch> batch);
+
+  // Verifies the payload checksums of 'batch' on a pool thread.
+  void VerifyBatch(std::shared_ptr<Batch> batch);
+
+  // Runs 'fn' on the runner, keeping track of it until it finishes.
+  void Schedule(std::function<void()> fn);
+
+  // Blocks until the front batch is verified and pops its next record.
+  absl::Status NextRecord(absl::Cord* record, uint64_t* next_offset);
+
+  RandomAccessFile* const file_;
+  const ParallelRecordReaderOptions options_;
+  uint64_t offset_;
+
+  // Null if the options have a runner. Reset in the destructor, after the
+  // framer is joined.
+  std::unique_ptr<thread::ThreadPool> pool_;
+  std::function<void(std::function<void()>)> runner_;
+
+  absl::Mutex mu_;
+  absl::CondVar cv_;
+  bool cancelled_ ABSL_GUARDED_BY(mu_) = false;
+  // Tasks scheduled on runner_ that have not finished yet. The destructor
+  // waits for them, so that none outlives mu_.
+  int64_t num_pending_tasks_ ABSL_GUARDED_BY(mu_) = 0;
+  std::deque<std::shared_ptr<Batch>> batches_ ABSL_GUARDED_BY(mu_);
+  size_t next_record_in_front_batch_ = 0;
+
+  // Declared last so that it is joined before the state above is destroyed.
+  std::unique_ptr<Thread> framer_;
+
+  ParallelRecordReader(const ParallelRecordReader&) = delete;
+  void operator=(const ParallelRecordReader&) = delete;
+};
+
+}  // namespace io
+}  // namespace tsl
+
+#endif  // XLA_TSL_LIB_IO_PARALLEL_RECORD_READER_H_
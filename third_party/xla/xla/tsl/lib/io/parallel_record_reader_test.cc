@@ -0,0 +1,357 @@
+/* Copyright 2026 The OpenXLA Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/tsl/lib/io/parallel_record_reader.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "xla/tsl/lib/core/status_test_util.h"
+#include "xla/tsl/lib/io/compression.h"
+#include "xla/tsl/lib/io/record_reader.h"
+#include "xla/tsl/lib/io/record_writer.h"
+#include "xla/tsl/platform/env.h"
+#include "xla/tsl/platform/errors.h"
+#include "xla/tsl/platform/test.h"
+#include "xla/tsl/platform/test_benchmark.h"
+#include "xla/tsl/platform/threadpool.h"
+#include "tsl/platform/tstring.h"
+
+namespace tsl {
+namespace io {
+namespace {
+
+// Records of varying sizes, some of them larger than the extents used by the
+// tests so that records and headers straddle extent boundaries.
+std::vector<std::string> MakeRecords(int num_records) {
+  std::vector<std::string> records;
+  for (int i = 0; i < num_records; ++i) {
+    const int size = (i * 37) % 1500;
+    records.push_back(std::string(size, static_cast<char>('a' + i % 26)));
+  }
+  return records;
+}
+
+std::string WriteRecords(const std::string& name,
+                         const std::vector<std::string>& records,
+                         const std::string& compression_type = "") {
+  const std::string fname = absl::StrCat(testing::TmpDir(), "/", name);
+  std::unique_ptr<WritableFile> file;
+  TF_CHECK_OK(Env::Default()->NewWritableFile(fname, &file));
+  RecordWriter writer(
+      file.get(),
+      RecordWriterOptions::CreateRecordWriterOptions(compression_type));
+  for (const std::string& record : records) {
+    TF_CHECK_OK(writer.WriteRecord(record));
+  }
+  TF_CHECK_OK(writer.Close());
+  TF_CHECK_OK(file->Close());
+  return fname;
+}
+
+ParallelRecordReaderOptions SmallExtentOptions() {
+  ParallelRecordReaderOptions options;
+  options.extent_size = 1000;
+  options.num_extents_in_flight = 3;
+  options.num_threads = 3;
+  options.batch_bytes = 2000;
+  return options;
+}
+
+TEST(ParallelRecordReaderTest, ReadsRecordsInOrder) {
+  const std::vector<std::string> records = MakeRecords(200);
+  const std::string fname = WriteRecords("parallel_in_order", records);
+  std::unique_ptr<RandomAccessFile> file;
+  TF_ASSERT_OK(Env::Default()->NewRandomAccessFile(fname, &file));
+
+  SequentialRecordReader expected_reader(file.get());
+  ParallelRecordReader reader(file.get(), 0, SmallExtentOptions());
+  for (const std::string& expected : records) {
+    tstring record;
+    TF_ASSERT_OK(reader.ReadRecord(&record));
+    EXPECT_EQ(record, expected);
+    tstring unused;
+    TF_ASSERT_OK(expected_reader.ReadRecord(&unused));
+    EXPECT_EQ(reader.TellOffset(), expected_reader.TellOffset());
+  }
+  tstring record;
+  EXPECT_TRUE(absl::IsOutOfRange(reader.ReadRecord(&record)));
+  EXPECT_TRUE(absl::IsOutOfRange(reader.ReadRecord(&record)));
+}
+
+TEST(ParallelRecordReaderTest, ReadsCords) {
+  const std::vector<std::string> records = MakeRecords(50);
+  const std::string fname = WriteRecords("parallel_cords", records);
+  std::unique_ptr<RandomAccessFile> file;
+  TF_ASSERT_OK(Env::Default()->NewRandomAccessFile(fname, &file));
+
+  auto reader = std::make_unique<ParallelRecordReader>(file.get(), 0,
+                                                       SmallExtentOptions());
+  std::vector<absl::Cord> cords(records.size());
+  for (absl::Cord& cord : cords) {
+    TF_ASSERT_OK(reader->ReadRecord(&cord));
+  }
+  // Records stay valid after the reader and its extents are gone.
+  reader.reset();
+  for (int i = 0; i < records.size(); ++i) {
+    EXPECT_EQ(cords[i], records[i]);
+  }
+}
+
+TEST(ParallelRecordReaderTest, StartsAtOffset) {
+  const std::vector<std::string> records = MakeRecords(100);
+  const std::string fname = WriteRecords("parallel_start_offset", records);
+  std::unique_ptr<RandomAccessFile> file;
+  TF_ASSERT_OK(Env::Default()->NewRandomAccessFile(fname, &file));
+
+  SequentialRecordReader sequential_reader(file.get());
+  TF_ASSERT_OK(sequential_reader.SkipRecords(37, nullptr));
+  ParallelRecordReader reader(file.get(), sequential_reader.TellOffset(),
+                              SmallExtentOptions());
+  for (int i = 37; i < records.size(); ++i) {
+    tstring record;
+    TF_ASSERT_OK(reader.ReadRecord(&record));
+    EXPECT_EQ(record, records[i]);
+  }
+  tstring record;
+  EXPECT_TRUE(absl::IsOutOfRange(reader.ReadRecord(&record)));
+}
+
+TEST(ParallelRecordReaderTest, EmptyFile) {
+  const std::string fname = WriteRecords("parallel_empty", {});
+  std::unique_ptr<RandomAccessFile> file;
+  TF_ASSERT_OK(Env::Default()->NewRandomAccessFile(fname, &file));
+
+  ParallelRecordReader reader(file.get(), 0, SmallExtentOptions());
+  tstring record;
+  EXPECT_TRUE(absl::IsOutOfRange(reader.ReadRecord(&record)));
+}
+
+TEST(ParallelRecordReaderTest, ReportsCorruptedRecord) {
+  const std::vector<std::string> records = MakeRecords(100);
+  const std::string fname = WriteRecords("parallel_corrupted", records);
+  std::string contents;
+  TF_ASSERT_OK(ReadFileToString(Env::Default(), fname, &contents));
+  uint64_t offset = 0;
+  for (int i = 0; i < 60; ++i) {
+    offset += RecordReader::kHeaderSize + records[i].size() +
+              RecordReader::kFooterSize;
+  }
+  ASSERT_FALSE(records[60].empty());
+  contents[offset + RecordReader::kHeaderSize] ^= 0x1;
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), fname, contents));
+
+  std::unique_ptr<RandomAccessFile> file;
+  TF_ASSERT_OK(Env::Default()->NewRandomAccessFile(fname, &file));
+  ParallelRecordReader reader(file.get(), 0, SmallExtentOptions());
+  for (int i = 0; i < 60; ++i) {
+    tstring record;
+    TF_ASSERT_OK(reader.ReadRecord(&record));
+    EXPECT_EQ(record, records[i]);
+  }
+  tstring record;
+  absl::Status s = reader.ReadRecord(&record);
+  EXPECT_TRUE(absl::IsDataLoss(s));
+  EXPECT_TRUE(absl::StrContains(s.message(), absl::StrCat("at ", offset)))
+      << s;
+  EXPECT_EQ(reader.TellOffset(), offset);
+}
+
+TEST(ParallelRecordReaderTest, ReportsTruncatedRecord) {
+  const std::vector<std::string> records = MakeRecords(20);
+  const std::string fname = WriteRecords("parallel_truncated", records);
+  std::string contents;
+  TF_ASSERT_OK(ReadFileToString(Env::Default(), fname, &contents));
+  contents.resize(contents.size() - 3);
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), fname, contents));
+
+  std::unique_ptr<RandomAccessFile> file;
+  TF_ASSERT_OK(Env::Default()->NewRandomAccessFile(fname, &file));
+  ParallelRecordReader reader(file.get(), 0, SmallExtentOptions());
+  for (int i = 0; i + 1 < records.size(); ++i) {
+    tstring record;
+    TF_ASSERT_OK(reader.ReadRecord(&record));
+  }
+  tstring record;
+  EXPECT_TRUE(absl::IsDataLoss(reader.ReadRecord(&record)));
+}
+
+TEST(ParallelRecordReaderTest, ReadsCompressedRecords) {
+  const std::vector<std::string> records = MakeRecords(100);
+  const std::string fname = WriteRecords("parallel_compressed", records,
+                                         compression::kZlib);
+  std::unique_ptr<RandomAccessFile> file;
+  TF_ASSERT_OK(Env::Default()->NewRandomAccessFile(fname, &file));
+
+  ParallelRecordReaderOptions options = SmallExtentOptions();
+  options.record_options =
+      RecordReaderOptions::CreateRecordReaderOptions(compression::kZlib);
+  ParallelRecordReader reader(file.get(), 0, options);
+  for (const std::string& expected : records) {
+    tstring record;
+    TF_ASSERT_OK(reader.ReadRecord(&record));
+    EXPECT_EQ(record, expected);
+  }
+  tstring record;
+  EXPECT_TRUE(absl::IsOutOfRange(reader.ReadRecord(&record)));
+}
+
+class ParallelRecordReaderTstringTest
+    : public ::testing::TestWithParam<const char*> {};
+
+TEST_P(ParallelRecordReaderTstringTest, ReadsViews) {
+  const std::string compression_type = GetParam();
+  const std::vector<std::string> records = MakeRecords(50);
+  const std::string fname = WriteRecords(
+      absl::StrCat("parallel_views_", compression_type), records,
+      compression_type);
+  std::unique_ptr<RandomAccessFile> file;
+  TF_ASSERT_OK(Env::Default()->NewRandomAccessFile(fname, &file));
+
+  // The file fits in one extent, so no record is copied.
+  ParallelRecordReaderOptions options;
+  options.record_options =
+      RecordReaderOptions::CreateRecordReaderOptions(compression_type);
+  auto reader = std::make_unique<ParallelRecordReader>(file.get(), 0, options);
+  std::vector<tstring> views(records.size());
+  for (tstring& view : views) {
+    TF_ASSERT_OK(reader->ReadRecord(&view));
+  }
+  // Views stay valid after the reader and its extents are gone.
+  reader.reset();
+  for (int i = 0; i < records.size(); ++i) {
+    EXPECT_EQ(views[i], records[i]);
+    if (records[i].size() >= 512) {
+      EXPECT_EQ(views[i].type(), tstring::VIEW);
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(Compression, ParallelRecordReaderTstringTest,
+                         ::testing::Values(compression::kNone,
+                                           compression::kZlib));
+
+TEST(ParallelRecordReaderTest, DestroyedBeforeEndOfFile) {
+  const std::vector<std::string> records = MakeRecords(500);
+  const std::string fname = WriteRecords("parallel_destroyed", records);
+  std::unique_ptr<RandomAccessFile> file;
+  TF_ASSERT_OK(Env::Default()->NewRandomAccessFile(fname, &file));
+
+  for (int num_reads : {0, 1, 100}) {
+    ParallelRecordReader reader(file.get(), 0, SmallExtentOptions());
+    for (int i = 0; i < num_reads; ++i) {
+      tstring record;
+      TF_ASSERT_OK(reader.ReadRecord(&record));
+    }
+  }
+}
+
+TEST(ParallelRecordReaderTest, ReadersShareRunner) {
+  const std::vector<std::string> records = MakeRecords(200);
+  const std::string fname = WriteRecords("parallel_shared_runner", records);
+  std::unique_ptr<RandomAccessFile> file;
+  TF_ASSERT_OK(Env::Default()->NewRandomAccessFile(fname, &file));
+
+  thread::ThreadPool pool(Env::Default(), "shared_runner", 2);
+  ParallelRecordReaderOptions options = SmallExtentOptions();
+  options.runner = [&pool](std::function<void()> fn) {
+    pool.Schedule(std::move(fn));
+  };
+  // Interleave two readers of the same file, and destroy a third one before
+  // the end of the file, all on the same two threads.
+  ParallelRecordReader reader1(file.get(), 0, options);
+  ParallelRecordReader reader2(file.get(), 0, options);
+  { ParallelRecordReader reader3(file.get(), 0, options); }
+  for (const std::string& expected : records) {
+    tstring record;
+    TF_ASSERT_OK(reader1.ReadRecord(&record));
+    EXPECT_EQ(record, expected);
+    TF_ASSERT_OK(reader2.ReadRecord(&record));
+    EXPECT_EQ(record, expected);
+  }
+  tstring record;
+  EXPECT_TRUE(absl::IsOutOfRange(reader1.ReadRecord(&record)));
+  EXPECT_TRUE(absl::IsOutOfRange(reader2.ReadRecord(&record)));
+}
+
+std::string WriteBenchmarkFile(int record_size) {
+  const int num_records = (64 << 20) / record_size;
+  const std::string fname = absl::StrCat(
+      testing::TmpDir(), "/parallel_record_reader_benchmark_", record_size);
+  std::unique_ptr<WritableFile> file;
+  TF_CHECK_OK(Env::Default()->NewWritableFile(fname, &file));
+  RecordWriter writer(file.get());
+  const std::string record(record_size, 'x');
+  for (int i = 0; i < num_records; ++i) {
+    TF_CHECK_OK(writer.WriteRecord(record));
+  }
+  TF_CHECK_OK(writer.Close());
+  TF_CHECK_OK(file->Close());
+  return fname;
+}
+
+void BM_SequentialRecordReader(::testing::benchmark::State& state) {
+  const std::string fname = WriteBenchmarkFile(state.range(0));
+  std::unique_ptr<RandomAccessFile> file;
+  TF_CHECK_OK(Env::Default()->NewRandomAccessFile(fname, &file));
+  int64_t bytes = 0;
+  for (auto s : state) {
+    SequentialRecordReader reader(
+        file.get(), RecordReaderOptions::CreateRecordReaderOptions(""));
+    tstring record;
+    while (reader.ReadRecord(&record).ok()) {
+      bytes += record.size();
+    }
+  }
+  state.SetBytesProcessed(bytes);
+}
+
+BENCHMARK(BM_SequentialRecordReader)->Arg(100)->Arg(10 << 10)->Arg(1 << 20);
+
+void BM_ParallelRecordReader(::testing::benchmark::State& state) {
+  const std::string fname = WriteBenchmarkFile(state.range(0));
+  std::unique_ptr<RandomAccessFile> file;
+  TF_CHECK_OK(Env::Default()->NewRandomAccessFile(fname, &file));
+  ParallelRecordReaderOptions options;
+  options.num_threads = state.range(1);
+  int64_t bytes = 0;
+  for (auto s : state) {
+    ParallelRecordReader reader(file.get(), 0, options);
+    absl::Cord record;
+    while (reader.ReadRecord(&record).ok()) {
+      bytes += record.size();
+    }
+  }
+  state.SetBytesProcessed(bytes);
+}
+
+BENCHMARK(BM_ParallelRecordReader)
+    ->ArgPair(100, 4)
+    ->ArgPair(10 << 10, 1)
+    ->ArgPair(10 << 10, 4)
+    ->ArgPair(1 << 20, 4);
+
+}  // namespace
+}  // namespace io
+}  // namespace tsl